@@ -64,8 +64,20 @@ In order to use the library in another project:
 - A minimal example on how to use this library can be found in \ref minimal.c
 - For any other example or question, contact Alexandru Munteanu at m@ioalex.net.
 
+Using the library from several threads:
+- A #splt_state must be used by only one thread at a time; the functions of a state
+  being used return #SPLT_ERROR_LIBRARY_LOCKED, except #mp3splt_stop_split that can
+  be called from another thread.
+- Different states can be used at the same time from different threads, including
+  splitting: #mp3splt_new_state, #mp3splt_find_plugins, #mp3splt_free_state and
+  #mp3splt_free_plugins_cache can be called concurrently.
+- The callbacks of a state are called from the thread using that state.
+- The debug mode (#SPLT_OPT_DEBUG_MODE) is shared by all the states.
+
 For writing a plugin to support other file type:
 - Look at the #splt_plugin_func from the \ref splt_plugin_api.
+- Plugins must not keep mutable global data; everything related to a split belongs
+  in the codec data of the state.
 
 A list of <a href="modules.html">all modules</a> is also available.
  */
@@ -115,6 +127,7 @@ typedef enum {
   SPLT_OK_SPLIT_EOF = 8,
   SPLT_LENGTH_SPLIT_OK = 9,
   SPLT_TRIM_SILENCE_OK = 10,
+  SPLT_LIVE_SPLIT_OK = 11,
 
   SPLT_FREEDB_OK = 100,
   SPLT_FREEDB_FILE_OK = 101,
@@ -122,6 +135,7 @@ typedef enum {
   SPLT_CUE_OK = 103,
   SPLT_FREEDB_MAX_CD_REACHED = 104,
   SPLT_AUDACITY_OK = 105,
+  SPLT_FREEDB_LOCAL_INDEX_OK = 106,
 
   SPLT_DEWRAP_OK = 200,
 
@@ -190,6 +204,9 @@ typedef enum {
   SPLT_FREEDB_ERROR_PROXY_NOT_SUPPORTED = -121,
   SPLT_ERROR_INTERNAL_SHEET = -122,
   SPLT_ERROR_INTERNAL_SHEET_TYPE_NOT_SUPPORTED = -123,
+  SPLT_FREEDB_ERROR_INVALID_LOCAL_INDEX = -124,
+  SPLT_FREEDB_ERROR_TIMEOUT = -125,
+  SPLT_ERROR_OUTPUT_SINK_NOT_SUPPORTED = -126,
 
   SPLT_DEWRAP_ERR_FILE_LENGTH = -200,
   SPLT_DEWRAP_ERR_VERSION_OLD = -201,
@@ -274,6 +291,33 @@ splt_code mp3splt_append_plugins_scan_dir(splt_state *state, const char *directo
  */
 splt_code mp3splt_find_plugins(splt_state *state);
 
+/**
+ * @brief Cleans the data of the last split file, in order to split another file
+ * with the same \p state.
+ *
+ * The filename to split, the splitpoints, the tags, the original tags, the sync errors,
+ * the wrap files and the freedb results are removed.\n
+ * The options, the output format, the callbacks, the path of split and the plugins are kept.
+ *
+ * @param[in] state Main state.
+ * @return Possible error.
+ */
+splt_code mp3splt_reset_state(splt_state *state);
+
+/**
+ * @brief Frees the plugins shared by all the states.
+ *
+ * #mp3splt_find_plugins keeps the plugins found in a process-wide cache and the next
+ * states searching plugins in the same directories use them without scanning the
+ * directories and opening the plugins again.\n
+ * The cache is kept after the last state using it is freed.
+ *
+ * @return #SPLT_ERROR_LIBRARY_LOCKED if some states still use the cache.
+ *
+ * @see #mp3splt_find_plugins
+ */
+splt_code mp3splt_free_plugins_cache();
+
 //@}
 
 /** @addtogroup splt_error_codes_
@@ -716,6 +760,44 @@ typedef enum {
    * Default is #SPLT_FALSE.
    */
   SPLT_OPT_HANDLE_BIT_RESERVOIR,
+  /**
+   * Number of seconds to wait for the freedb server when connecting, sending or
+   * receiving before failing with #SPLT_FREEDB_ERROR_TIMEOUT.
+   * A value of 0 waits indefinitely.
+   *
+   * Int option.
+   *
+   * Default is #SPLT_DEFAULT_FREEDB_TIMEOUT.
+   */
+  SPLT_OPT_FREEDB_TIMEOUT,
+  /**
+   * If #SPLT_TRUE, the #SPLT_OPTION_LIVE_MODE split also starts a new output file
+   * when a silence of at least #SPLT_OPT_PARAM_MIN_LENGTH seconds below
+   * #SPLT_OPT_PARAM_THRESHOLD is detected, once the current output file is at least
+   * #SPLT_OPT_PARAM_MIN_TRACK_LENGTH seconds long.
+   * It currently works only for mp3 files.
+   *
+   * Int option that can take the values #SPLT_TRUE or #SPLT_FALSE.
+   *
+   * Default is #SPLT_FALSE.
+   */
+  SPLT_OPT_LIVE_SPLIT_ON_SILENCE,
+  /**
+   * If #SPLT_TRUE, the splits using splitpoints (such as #SPLT_OPTION_NORMAL_MODE or
+   * #SPLT_OPTION_SILENCE_MODE), #SPLT_OPTION_TIME_MODE and #SPLT_OPTION_LENGTH_MODE read the input file once from the beginning to the end
+   * and write each frame in all the output files containing it, instead of seeking the
+   * input file again for each output file.
+   * It is used only when the plugin supports it - currently for seekable mp3 files
+   * split with #SPLT_OPT_FRAME_MODE and without #SPLT_OPT_AUTO_ADJUST; otherwise, the
+   * files are split one after the other.
+   * The output files and the splitpoints after the split are the same as when
+   * splitting the files one after the other.
+   *
+   * Int option that can take the values #SPLT_TRUE or #SPLT_FALSE.
+   *
+   * Default is #SPLT_FALSE.
+   */
+  SPLT_OPT_SINGLE_READ_PASS,
 } splt_options;
 
 /**
@@ -755,6 +837,20 @@ typedef enum {
    * Split in #SPLT_OPT_LENGTH_SPLIT_FILE_NUMBER pieces of equal time length.
    */
   SPLT_OPTION_LENGTH_MODE,
+  /**
+   * Read an unbounded input as it arrives (stdin or a named pipe) and start a new output
+   * file every #SPLT_OPT_SPLIT_TIME, or on silence with #SPLT_OPT_LIVE_SPLIT_ON_SILENCE.
+   * A value of 0 for #SPLT_OPT_SPLIT_TIME only splits on silence.
+   *
+   * The input is read as not seekable and each output file is written with a '.part'
+   * extension, synchronised on the disk and renamed when complete.
+   *
+   * With #SPLT_OPT_HANDLE_BIT_RESERVOIR, each mp3 output file starts with a LAME frame
+   * and the frames before its first frame needed to decode it; the LAME encoder delay
+   * makes the players skip them, so that the joins are gapless.
+   * The frames are not overlapped when writing to the standard output.
+   */
+  SPLT_OPTION_LIVE_MODE,
 } splt_split_mode_options;
 
 /**
@@ -802,6 +898,11 @@ typedef enum {
  * @brief Default value for the #SPLT_OPT_PARAM_THRESHOLD option
  */
 #define SPLT_DEFAULT_PARAM_THRESHOLD -48.0
+/**
+ * @brief Default value for the #SPLT_OPT_FREEDB_TIMEOUT option
+ */
+#define SPLT_DEFAULT_FREEDB_TIMEOUT 30
+
 /**
  * @brief Default value for the #SPLT_OPT_PARAM_OFFSET option
  */
@@ -1187,6 +1288,97 @@ splt_code mp3splt_set_pretend_to_split_write_function(splt_state *state,
     void (*write_cb)(const void *ptr, size_t size, size_t nmemb, void *cb_data),
     void *cb_data);
 
+/**
+ * @brief Callbacks of an output sink receiving the output files instead of the file system.
+ *
+ * @see #mp3splt_set_output_sink
+ */
+typedef struct {
+  /**
+   * Opens the output file \p filename.
+   * Returns a handle passed to the other callbacks, or NULL on error.
+   */
+  void *(*open)(const char *filename, void *cb_data);
+  /**
+   * Writes \p size bytes from \p ptr at the current position.
+   * Returns the number of bytes written.
+   */
+  size_t (*write)(void *handle, const void *ptr, size_t size, void *cb_data);
+  /**
+   * Moves the current position to \p offset bytes from the beginning of the file, used
+   * to update the headers (mp3 Xing, flac streaminfo) once the file is written.
+   * Returns 0 on success.
+   *
+   * Can be NULL: the output file is then kept in memory and written at once when closed.
+   */
+  int (*seek)(void *handle, off_t offset, void *cb_data);
+  /**
+   * Closes the output file. Returns 0 on success.
+   *
+   * \p complete is #SPLT_FALSE when the split of the file failed or was cancelled.
+   */
+  int (*close)(void *handle, int complete, void *cb_data);
+  /**
+   * User data passed to the callbacks.
+   */
+  void *cb_data;
+} splt_output_sink;
+
+/**
+ * @brief Writes the output files through the callbacks of \p sink instead of the file system.
+ *
+ * Each output file is opened, written and closed with the callbacks, the
+ * filename being the one that would have been created.
+ * The M3U file, the cue and cddb files and the logs are still written on the file system.
+ *
+ * @param[in] state Main state.
+ * @param[in] sink Callbacks copied in the state, or NULL to write on the file system again.
+ * @return Possible error; #SPLT_ERROR_OUTPUT_SINK_NOT_SUPPORTED on platforms without custom
+ * streams.
+ */
+splt_code mp3splt_set_output_sink(splt_state *state, const splt_output_sink *sink);
+
+/**
+ * @brief Built-in output sink keeping each output file in memory.
+ *
+ * @param[in] state Main state.
+ * @param[in] file_done Callback function called with the contents of each output file
+ * when complete; \p bytes are freed when the callback returns. It is not called for the
+ * files whose split failed or was cancelled.
+ * @param[in] cb_data User data sent through \p file_done.
+ * @return Possible error.
+ */
+splt_code mp3splt_set_memory_output_sink(splt_state *state,
+    void (*file_done)(const char *filename, const unsigned char *bytes, size_t size, void *cb_data),
+    void *cb_data);
+
+/**
+ * @brief Built-in output sink writing the output files one after the other in an already
+ * opened file descriptor, like a pipe or a socket.
+ *
+ * Each output file is kept in memory until complete, then written at once after a header:
+ * the length of the filename on 4 bytes and the size of the file on 8 bytes, both in big
+ * endian, followed by the filename without the terminating null byte.
+ * The files whose split failed or was cancelled are not written.
+ * The file descriptor is not closed.
+ *
+ * @param[in] state Main state.
+ * @param[in] fd Opened file descriptor.
+ * @return Possible error.
+ */
+splt_code mp3splt_set_fd_output_sink(splt_state *state, int fd);
+
+/**
+ * @brief Built-in output sink writing each output file with a '.part' extension, then
+ * synchronising it on the disk and renaming it when complete.
+ *
+ * The '.part' file is kept when the split of the file failed or was cancelled.
+ *
+ * @param[in] state Main state.
+ * @return Possible error.
+ */
+splt_code mp3splt_set_temporary_file_output_sink(splt_state *state);
+
 /**
  * @brief Type of messages sent to the client using the callback registered with
  * #mp3splt_set_progress_function.
@@ -1647,6 +1839,39 @@ int mp3splt_put_tags_from_string(splt_state *state, const char *tags, splt_code
  */
 splt_code mp3splt_read_original_tags(splt_state *state);
 
+/**
+ * @brief Returns the original tags read by #mp3splt_read_original_tags.
+ *
+ * The returned tags belong to the \p state and are valid until the next call to
+ * #mp3splt_read_original_tags or #mp3splt_free_state.
+ *
+ * @param[in] state Main state.
+ * @param[out] error Possible error; can be NULL.
+ * @return The original tags of the input file.
+ *
+ * @see #mp3splt_tags_get
+ */
+splt_tags *mp3splt_get_original_tags(splt_state *state, splt_code *error);
+
+/**
+ * @brief Returns the total time in hundreths of seconds of the input file, as
+ * computed by the last call to #mp3splt_read_original_tags or #mp3splt_split.
+ *
+ * @param[in] state Main state.
+ * @return The total time or -1 if \p state is NULL.
+ */
+long mp3splt_get_total_time(splt_state *state);
+
+/**
+ * @brief Returns the name of the plugin handling the input file, as found by
+ * the last call to #mp3splt_read_original_tags or #mp3splt_split.
+ *
+ * @param[in] state Main state.
+ * @return The plugin name, like "mp3 (libmad)", or NULL if no plugin was found.
+ * The result must not be freed.
+ */
+const char *mp3splt_get_plugin_name(splt_state *state);
+
 /**
  * @brief Erase all the tags from the \p state.
  *
@@ -1706,6 +1931,27 @@ splt_code mp3splt_set_default_genre_tag(splt_state *state, const char *default_g
  */
 splt_tags *mp3splt_parse_filename_regex(splt_state *state, splt_code *error);
 
+/**
+ * @brief Parse several filenames using the regex provided by #mp3splt_set_input_filename_regex.
+ *
+ * The regular expression is compiled once for all the filenames. Like
+ * #mp3splt_parse_filename_regex, the directory and the extension of each
+ * filename are not parsed.
+ *
+ * @param[in] state Main state.
+ * @param[in] filenames Filenames to parse.
+ * @param[in] number_of_filenames Number of elements of \p filenames and \p tags.
+ * @param[out] tags Filled with the parsed tags of each filename, or NULL if the
+ * regex did not match that filename; each element must be freed with #mp3splt_free_one_tag.
+ * On errors other than #SPLT_REGEX_NO_MATCH, all the elements are NULL.
+ * @return #SPLT_REGEX_OK or the error.
+ *
+ * @see #mp3splt_parse_filename_regex
+ * @see #mp3splt_free_one_tag
+ */
+splt_code mp3splt_parse_filenames_regex(splt_state *state, const char * const *filenames,
+    int number_of_filenames, splt_tags **tags);
+
 /**
  * @brief Free the memory of one #splt_tags
  *
@@ -1793,6 +2039,21 @@ typedef enum {
  */
 splt_code mp3splt_import(splt_state *state, splt_import_type type, const char *file);
 
+/**
+ * @brief Import the splitpoints and the tags of the chapters or of the cue sheet embedded in
+ * \p file into the \p state.
+ *
+ * Unlike #mp3splt_import with #PLUGIN_INTERNAL_IMPORT, the file to split is left unchanged, the
+ * plugin is not initialized and only the metadata holding the internal sheet is read.
+ *
+ * @param[in] state Main state.
+ * @param[in] file Input file having an internal sheet.
+ * @return Possible error; #SPLT_ERROR_NO_PLUGIN_FOUND if no plugin handles \p file.
+ *
+ * @see #mp3splt_import
+ */
+splt_code mp3splt_import_internal_sheet_plan(splt_state *state, const char *file);
+
 /**
  * @brief Search CDDB file using CDDB CGI protocol (tracktype.org).
  *
@@ -1814,6 +2075,27 @@ splt_code mp3splt_import(splt_state *state, splt_import_type type, const char *f
  */
 #define SPLT_FREEDB_GET_FILE_TYPE_CDDB 4
 
+/**
+ * @brief Search in a local index built by #mp3splt_freedb_build_local_index.
+ *
+ * The search server is the index file and the port is not used.
+ * The searched string is either a disc ID of 8 hexadecimal digits, or words that must all
+ * be found in the "artist / album" title of the discs.
+ *
+ * @see #mp3splt_get_freedb_search
+ */
+#define SPLT_FREEDB_SEARCH_TYPE_LOCAL_INDEX 5
+
+/**
+ * @brief Get CDDB file from the freedb dump of a local index built by
+ * #mp3splt_freedb_build_local_index.
+ *
+ * The server is the index file and the port is not used.
+ *
+ * @see #mp3splt_write_freedb_file_result
+ */
+#define SPLT_FREEDB_GET_FILE_TYPE_LOCAL_INDEX 6
+
 /**
  * @brief Default port.
  *
@@ -1894,6 +2176,19 @@ char *mp3splt_encode_in_base64(splt_state *state, const char *input, int *error)
  */
 void mp3splt_clear_proxy(splt_state *state);
 
+/**
+ * @brief Caches the freedb server responses in the \p cache_directory.
+ *
+ * Responses are always cached in memory for the lifetime of the \p state; with a cache directory,
+ * the same searches and file requests are answered without network access across states and runs.
+ *
+ * @param[in] state Main state.
+ * @param[in] cache_directory Existing directory where the responses are stored, or NULL to disable
+ *            the on-disk cache.
+ * @return Possible error.
+ */
+splt_code mp3splt_freedb_use_cache_directory(splt_state *state, const char *cache_directory);
+
 /**
  * @brief Search on the internet for the \p searched_string and returns the results.
  *
@@ -1901,8 +2196,10 @@ void mp3splt_clear_proxy(splt_state *state);
  * @param[in] searched_string Search string - might be artist or album.
  * @param[out] error Possible error; can be NULL.
  * @param[in] search_type Type of the search.
- *                        Only #SPLT_FREEDB_SEARCH_TYPE_CDDB_CGI is supported for the moment.
- * @param[in] search_server You can use #SPLT_FREEDB2_CGI_SITE as search server.
+ *                        Can be #SPLT_FREEDB_SEARCH_TYPE_CDDB_CGI or
+ *                        #SPLT_FREEDB_SEARCH_TYPE_LOCAL_INDEX.
+ * @param[in] search_server You can use #SPLT_FREEDB2_CGI_SITE as search server, or the
+ *                          local index file with #SPLT_FREEDB_SEARCH_TYPE_LOCAL_INDEX.
  * @param[in] port Port of the \p search_server. Can be #SPLT_FREEDB_CDDB_CGI_PORT.
  * @return The search results.
  *
@@ -1958,9 +2255,11 @@ int mp3splt_freedb_get_number_of_revisions(const splt_freedb_one_result *result)
  * @param[in] disc_id ID of the chosen disc provided by #mp3splt_freedb_get_id.
  * @param[in] output_file Name of the output CDDB file that will be written.
  * @param[in] cddb_get_type Type of the download.
- *            Can be #SPLT_FREEDB_GET_FILE_TYPE_CDDB or #SPLT_FREEDB_GET_FILE_TYPE_CDDB_CGI.
+ *            Can be #SPLT_FREEDB_GET_FILE_TYPE_CDDB, #SPLT_FREEDB_GET_FILE_TYPE_CDDB_CGI or
+ *            #SPLT_FREEDB_GET_FILE_TYPE_LOCAL_INDEX.
  * @param[in] cddb_get_server Name of the server from the file is downloaded.
- *            Can be #SPLT_FREEDB2_CGI_SITE (or freedb.org or freedb.org/~cddb/cddb.cgi).
+ *            Can be #SPLT_FREEDB2_CGI_SITE (or freedb.org or freedb.org/~cddb/cddb.cgi), or
+ *            the local index file with #SPLT_FREEDB_GET_FILE_TYPE_LOCAL_INDEX.
  * @param[in] port Port of the \p cddb_get_server.
  *                 Can be #SPLT_FREEDB_CDDB_CGI_PORT (or 8880) for example.
  * @return Possible error.
@@ -1971,6 +2270,25 @@ splt_code mp3splt_write_freedb_file_result(splt_state *state,
     int disc_id, const char *output_file,
     int cddb_get_type, const char *cddb_get_server, int port);
 
+/**
+ * @brief Indexes a freedb dump for searching it without network access.
+ *
+ * The \p dump_directory has one sub-directory per category (blues, rock, ...), each holding
+ * one CDDB file per disc. The disc IDs and the words of the "artist / album" titles are
+ * indexed in the \p index_file. The CDDB files are read from the \p dump_directory when
+ * getting a search result, so the dump must be kept.
+ *
+ * @param[in] state Main state.
+ * @param[in] dump_directory Directory of the freedb dump.
+ * @param[in] index_file Index file to write.
+ * @return #SPLT_FREEDB_LOCAL_INDEX_OK or a possible error.
+ *
+ * @see #SPLT_FREEDB_SEARCH_TYPE_LOCAL_INDEX
+ * @see #SPLT_FREEDB_GET_FILE_TYPE_LOCAL_INDEX
+ */
+splt_code mp3splt_freedb_build_local_index(splt_state *state,
+    const char *dump_directory, const char *index_file);
+
 //@}
 
 /**
@@ -2156,6 +2474,13 @@ typedef struct {
  */
 typedef struct _splt_original_tags splt_original_tags;
 
+/**
+ * @brief Structure containing the segments of the input file to be split in a single read pass.
+ *
+ * @see #splt_pl_split_segments
+ */
+typedef struct _splt_segment_plan splt_segment_plan;
+
 /**
  * @brief Libmp3splt plugin API.
  *
@@ -2310,6 +2635,36 @@ typedef struct {
    * @param[out] error Fill in possible error.
    */
   void (*splt_pl_import_internal_sheets)(splt_state *state, splt_code *error);
+  /**
+   * @brief Import splitpoints from the internal sheets of \p filename without setting it as
+   * the file to split and without initializing the plugin.
+   *
+   * Only the metadata blocks holding the internal sheets and their tags should be read.
+   *
+   * @param[in] state Main state.
+   * @param[in] filename Input filename.
+   * @param[out] error Fill in possible error.
+   * @return #SPLT_TRUE if the plugin handles \p filename, #SPLT_FALSE otherwise.
+   */
+  int (*splt_pl_import_internal_sheets_plan)(splt_state *state, const char *filename,
+      splt_code *error);
+  /**
+   * @brief Split the input file into the segments of \p plan in a single read pass.
+   *
+   * Used instead of #splt_pl_split when #SPLT_OPT_SINGLE_READ_PASS is enabled.
+   * The input file is read once from the beginning to the end and each frame is written in
+   * all the output files of the segments containing it; segments may overlap.\n
+   * Each output file is opened with \p splt_sgp_open_segment, which sets the tags and
+   * returns the output filename, and closed with \p splt_sgp_close_segment, which takes the
+   * real end of the segment as returned by #splt_pl_split.
+   *
+   * @param[in] state Main state.
+   * @param[in] plan Segments to split, ordered by their begin time.
+   * @param[out] error Fill in possible error.
+   * @return #SPLT_FALSE if the plugin cannot split these segments in a single read pass,
+   * before writing any output file; the segments are then split one by one.
+   */
+  int (*splt_pl_split_segments)(splt_state *state, splt_segment_plan *plan, splt_code *error);
 } splt_plugin_func;
 
 //@}
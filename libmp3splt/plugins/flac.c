@@ -198,70 +198,183 @@ void splt_pl_clear_original_tags(splt_original_tags *original_tags)
   //nothing to do - we never store original tags in the splt_state, only in the splt_flac_state
 }
 
-void splt_pl_import_internal_sheets(splt_state *state, splt_code *error)
+//! Length of the CUESHEET block header, before the tracks
+#define SPLT_FLAC_CUESHEET_HEADER_LENGTH 396
+//! Length of a cue sheet track, before its indexes
+#define SPLT_FLAC_CUESHEET_TRACK_LENGTH 36
+#define SPLT_FLAC_CUESHEET_INDEX_LENGTH 12
+
+static FLAC__uint64 splt_flac_unpack_uint64(const unsigned char *bytes)
 {
-  char *input_filename = splt_t_get_filename_to_split(state);
+  FLAC__uint64 value = 0;
 
-  FLAC__StreamMetadata *cuesheet = NULL;
-  FLAC__bool cuesheet_read_ok = FLAC__metadata_get_cuesheet(input_filename, &cuesheet);
-  if (!cuesheet_read_ok)
+  int i = 0;
+  for (i = 0;i < 8;i++)
+  {
+    value = (value << 8) | bytes[i];
+  }
+
+  return value;
+}
+
+/*! Appends a splitpoint for each track of a CUESHEET block
+
+The last track of the block is the lead-out.
+
+\return The number of tracks
+*/
+static int splt_flac_put_cuesheet_splitpoints(splt_state *state,
+    const unsigned char *cuesheet, FLAC__uint32 length, splt_code *error)
+{
+  if (length < SPLT_FLAC_CUESHEET_HEADER_LENGTH)
   {
     *error = SPLT_ERROR_INTERNAL_SHEET;
-    return;
+    return 0;
   }
 
-  const FLAC__StreamMetadata_CueSheet *cue_sheet = &cuesheet->data.cue_sheet;
-  unsigned track_number;
-  long max_hundreths = 0;
-  for (track_number = 0; track_number < cue_sheet->num_tracks - 1; track_number++)
+  int is_cd = cuesheet[136] >> 7;
+  unsigned num_tracks = cuesheet[395];
+
+  const unsigned char *end = cuesheet + length;
+  const unsigned char *track = cuesheet + SPLT_FLAC_CUESHEET_HEADER_LENGTH;
+
+  if (num_tracks > 1)
   {
-    const FLAC__StreamMetadata_CueSheet_Track *cue_track = cue_sheet->tracks + track_number;
+    int err = splt_sp_reserve_splitpoints(state, num_tracks);
+    if (err < 0) { *error = err; return 0; }
+  }
+
+  unsigned track_number = 0;
+  for (track_number = 0; track_number + 1 < num_tracks; track_number++)
+  {
+    if (track + SPLT_FLAC_CUESHEET_TRACK_LENGTH > end)
+    {
+      *error = SPLT_ERROR_INTERNAL_SHEET;
+      return track_number;
+    }
+
+    FLAC__uint64 track_offset = splt_flac_unpack_uint64(track);
+    unsigned num_indices = track[SPLT_FLAC_CUESHEET_TRACK_LENGTH - 1];
+    const unsigned char *indices = track + SPLT_FLAC_CUESHEET_TRACK_LENGTH;
+
+    if (num_indices == 0 ||
+        indices + num_indices * SPLT_FLAC_CUESHEET_INDEX_LENGTH > end)
+    {
+      *error = SPLT_ERROR_INTERNAL_SHEET;
+      return track_number;
+    }
 
     int start_index = 0;
-    if (cue_track->num_indices > 1) { start_index++; }
+    if (num_indices > 1) { start_index++; }
 
     //TODO: only take INDEX 01 or INDEX 00 if INDEX 01 does not exists
-    const FLAC__StreamMetadata_CueSheet_Index *cue_index = cue_track->indices + start_index;
-    if (cue_sheet->is_cd)
+    FLAC__uint64 index_offset =
+      splt_flac_unpack_uint64(indices + start_index * SPLT_FLAC_CUESHEET_INDEX_LENGTH);
+    if (is_cd)
     {
-      long offset = (long) ((cue_track->offset + cue_index->offset) / (44100 / 75)) * 100;
+      long offset = (long) ((track_offset + index_offset) / (44100 / 75)) * 100;
       long hundreths = offset / 75;
-      if (hundreths > max_hundreths) { max_hundreths = hundreths; }
-      //long mins, secs, hundr;
-      //splt_co_get_mins_secs_hundr(hundreths, &mins, &secs, &hundr);
-      //fprintf(stdout, "%02lu:%02lu:%02lu\n", mins, secs, hundr);
-      //fflush(stdout);
-      splt_sp_append_splitpoint(state, hundreths, NULL, SPLT_SPLITPOINT);
+      int err = splt_sp_append_splitpoint(state, hundreths, NULL, SPLT_SPLITPOINT);
+      if (err < 0) { *error = err; return track_number; }
     }
     else
     {
       *error = SPLT_ERROR_INTERNAL_SHEET_TYPE_NOT_SUPPORTED;
-      goto end;
+      return track_number;
     }
+
+    track = indices + num_indices * SPLT_FLAC_CUESHEET_INDEX_LENGTH;
   }
 
   if (track_number > 0)
   {
-    splt_sp_append_splitpoint(state, LONG_MAX, _("--- last cue splitpoint ---"), SPLT_SPLITPOINT);
+    int err = splt_sp_append_splitpoint(state, LONG_MAX,
+        _("--- last cue splitpoint ---"), SPLT_SPLITPOINT);
+    if (err < 0) { *error = err; }
   }
 
-end:
-  FLAC__metadata_object_delete(cuesheet);
-  if (*error < 0) { return; }
+  return track_number;
+}
 
-  splt_o_lock_messages(state);
-  splt_pl_init(state, error);
-  splt_o_unlock_messages(state);
-  if (*error < 0) { return; }
+/*! Puts the splitpoints and the filenames of the cue sheet of a flac file
+
+Only the CUESHEET and VORBIS_COMMENT blocks are read: the file is not
+prepared for splitting.
+
+\return SPLT_FALSE if \p file_input is not a flac file
+*/
+static int splt_flac_import_cuesheet(splt_state *state, FILE *file_input, splt_code *error)
+{
+  splt_flac_tags *flac_tags = NULL;
+  unsigned char *cuesheet = NULL;
+  FLAC__uint32 cuesheet_length = 0;
+  splt_tags *empty_tags = NULL;
+
+  if (!splt_flac_mu_read_cuesheet_and_tags(file_input, &flac_tags,
+        &cuesheet, &cuesheet_length, error))
+  {
+    return SPLT_FALSE;
+  }
+  if (*error < 0) { goto end; }
+
+  if (cuesheet == NULL)
+  {
+    *error = SPLT_ERROR_INTERNAL_SHEET;
+    goto end;
+  }
+
+  int track_number = splt_flac_put_cuesheet_splitpoints(state, cuesheet, cuesheet_length, error);
+  if (*error < 0) { goto end; }
+
+  const splt_tags *our_tags = NULL;
+  if (flac_tags)
+  {
+    our_tags = flac_tags->original_tags;
+  }
+  else
+  {
+    empty_tags = splt_tu_new_tags(error);
+    if (*error < 0) { goto end; }
+    our_tags = empty_tags;
+  }
 
-  splt_flac_state *flacstate = state->codec;
-  const splt_tags *our_tags = flacstate->flac_tags->original_tags;
   splt_cc_put_filenames_from_tags(state, track_number, error, our_tags, SPLT_FALSE,
       SPLT_FALSE);
 
-  int err = SPLT_OK;
-  splt_pl_end(state, &err);
-  if (err < 0 && *error >= 0) { *error = err; }
+end:
+  splt_flac_t_free(&flac_tags);
+  free(cuesheet);
+  splt_tu_free_one_tags(&empty_tags);
+
+  return SPLT_TRUE;
+}
+
+void splt_pl_import_internal_sheets(splt_state *state, splt_code *error)
+{
+  char *input_filename = splt_t_get_filename_to_split(state);
+  FILE *file_input = splt_flac_open_file_read(state, input_filename, error);
+  if (file_input == NULL) { return; }
+
+  if (!splt_flac_import_cuesheet(state, file_input, error))
+  {
+    splt_e_set_error_data(state, input_filename);
+    *error = SPLT_ERROR_INVALID;
+  }
+
+  fclose(file_input);
+}
+
+int splt_pl_import_internal_sheets_plan(splt_state *state, const char *filename,
+    splt_code *error)
+{
+  FILE *file_input = splt_flac_open_file_read(state, filename, error);
+  if (file_input == NULL) { return SPLT_FALSE; }
+
+  int is_flac = splt_flac_import_cuesheet(state, file_input, error);
+
+  fclose(file_input);
+
+  return is_flac;
 }
 
 static void splt_flac_get_info(splt_state *state, FILE *file_input, const char *input_filename, splt_code *error)
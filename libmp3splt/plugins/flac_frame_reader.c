@@ -863,7 +863,7 @@ static void splt_flac_fr_open_file_and_write_metadata_if_first_time(splt_flac_fr
 
   if (! splt_o_get_int_option(state, SPLT_OPT_PRETEND_TO_SPLIT))
   {
-    fr->out = splt_io_fopen(output_fname, "wb+");
+    fr->out = splt_os_fopen(state, output_fname, "wb+");
     if (fr->out == NULL)
     {
       splt_e_set_strerror_msg_with_data(state, output_fname);
@@ -1130,7 +1130,7 @@ end:
 
   if (fr->out)
   {
-    if (fclose(fr->out) != 0)
+    if (splt_os_fclose(state, fr->out, *error >= 0) != 0)
     {
       splt_e_set_strerror_msg_with_data(state, output_fname);
       *error = SPLT_ERROR_CANNOT_CLOSE_FILE;
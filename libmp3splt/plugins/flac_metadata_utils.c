@@ -50,10 +50,10 @@ static unsigned char *splt_flac_mu_read_metadata(FLAC__uint32 total_block_length
 
 static void splt_flac_mu_skip_metadata(FLAC__uint32 total_block_length, FILE *in, splt_code *error)
 {
-  unsigned char *bytes = splt_flac_mu_read_metadata(total_block_length, in, error);
-  if (*error < 0 || !bytes) { return; }
-
-  free(bytes);
+  if (fseeko(in, (off_t) total_block_length, SEEK_CUR) != 0)
+  {
+    *error = SPLT_ERROR_INVALID;
+  }
 }
 
 static void splt_flac_mu_save_metadata(splt_flac_state *flacstate, 
@@ -176,6 +176,80 @@ invalid_error:
   *error = SPLT_ERROR_INVALID;
 }
 
+/*! Reads only the metadata blocks needed to list the tracks of the cue sheet
+
+The VORBIS_COMMENT and CUESHEET blocks are read and the other ones, like
+the pictures, are skipped with a seek. The reading stops once both blocks
+are found.
+
+\param[out] flac_tags The tags of the file or NULL if it has none
+\param[out] cuesheet The CUESHEET block to be freed or NULL if there is none
+\return SPLT_FALSE if \p in is not a flac file
+*/
+int splt_flac_mu_read_cuesheet_and_tags(FILE *in, splt_flac_tags **flac_tags,
+    unsigned char **cuesheet, FLAC__uint32 *cuesheet_length, splt_code *error)
+{
+  *flac_tags = NULL;
+  *cuesheet = NULL;
+  *cuesheet_length = 0;
+
+  char flac_stream_marker[4] = { '\0' };
+  if (fread(&flac_stream_marker, 1, 4, in) != 4 ||
+      memcmp(flac_stream_marker, "fLaC", 4) != 0)
+  {
+    return SPLT_FALSE;
+  }
+
+  unsigned char is_last_block = 0;
+  while (!is_last_block && (*flac_tags == NULL || *cuesheet == NULL))
+  {
+    unsigned char header[SPLT_FLAC_METADATA_HEADER_LENGTH];
+    if (fread(header, 1, SPLT_FLAC_METADATA_HEADER_LENGTH, in) != SPLT_FLAC_METADATA_HEADER_LENGTH)
+    {
+      *error = SPLT_ERROR_INVALID;
+      break;
+    }
+
+    is_last_block = header[0] >> 7;
+    unsigned char block_type = header[0] & 0x7f;
+    FLAC__uint32 total_block_length = splt_flac_l_unpack_uint32(header + 1, 3);
+
+    if (block_type == SPLT_FLAC_METADATA_VORBIS_COMMENT && *flac_tags == NULL)
+    {
+      unsigned char *comments = splt_flac_mu_read_metadata(total_block_length, in, error);
+      if (comments && *error >= 0)
+      {
+        *flac_tags = splt_flac_t_new(comments, total_block_length, error);
+      }
+      free(comments);
+    }
+    else if (block_type == SPLT_FLAC_METADATA_CUESHEET && *cuesheet == NULL)
+    {
+      *cuesheet = splt_flac_mu_read_metadata(total_block_length, in, error);
+      *cuesheet_length = total_block_length;
+    }
+    else if (block_type == 127)
+    {
+      *error = SPLT_ERROR_INVALID;
+    }
+    else
+    {
+      splt_flac_mu_skip_metadata(total_block_length, in, error);
+    }
+
+    if (*error < 0) { break; }
+  }
+
+  if (*error < 0)
+  {
+    splt_flac_t_free(flac_tags);
+    free(*cuesheet);
+    *cuesheet = NULL;
+  }
+
+  return SPLT_TRUE;
+}
+
 unsigned char *splt_flac_mu_build_metadata_header(unsigned char type, unsigned char is_last,
     unsigned length)
 {
@@ -37,6 +37,8 @@
 #include "flac_metadata.h"
 
 void splt_flac_mu_read(splt_flac_state *flacstate, splt_state *state, FILE *in, splt_code *error);
+int splt_flac_mu_read_cuesheet_and_tags(FILE *in, splt_flac_tags **flac_tags,
+    unsigned char **cuesheet, FLAC__uint32 *cuesheet_length, splt_code *error);
 unsigned char *splt_flac_mu_build_metadata_header(unsigned char type, unsigned char is_last,
     unsigned length);
 
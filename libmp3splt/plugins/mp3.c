@@ -194,7 +194,7 @@ static FILE *splt_mp3_open_file_write(splt_state *state, const char *output_fnam
   }
   else
   {
-    if (!(file_output = splt_io_fopen(output_fname, "wb+")))
+    if (!(file_output = splt_os_fopen(state, output_fname, "wb+")))
     {
       splt_e_set_strerror_msg_with_data(state, output_fname);
       *error = SPLT_ERROR_CANNOT_OPEN_DEST_FILE;
@@ -268,6 +268,22 @@ static void splt_mp3_state_free(splt_state *state)
     mp3state->overlapped_frames_bytes = 0;
     mp3state->overlapped_number_of_frames = 0;
   }
+
+  int i = 0;
+  for (i = 0;i < SPLT_MP3_MAX_BYTE_RESERVOIR_HEADERS;i++)
+  {
+    if (mp3state->br_frames[i])
+    {
+      free(mp3state->br_frames[i]);
+      mp3state->br_frames[i] = NULL;
+    }
+  }
+
+  if (mp3state->read_frame)
+  {
+    free(mp3state->read_frame);
+    mp3state->read_frame = NULL;
+  }
  
   free(mp3state);
   state->codec = NULL;
@@ -482,8 +498,162 @@ end:
   return bytes_and_size;
 }
 
-//!puts a original field on id3 conforming to frame_type
-static int splt_mp3_put_original_libid3_frame(splt_state *state,
+//! ID3v2 frames needed to import the chapters with the tags of the file
+static const char *splt_mp3_chapters_frames[] = {
+  "CHAP", ID3_FRAME_ARTIST, ID3_FRAME_ALBUM, ID3_FRAME_TITLE, ID3_FRAME_YEAR, "TYER",
+  ID3_FRAME_GENRE, ID3_FRAME_COMMENT, ID3_FRAME_TRACK, NULL
+};
+
+static unsigned long splt_mp3_unpack_id3v2_size(const unsigned char *bytes, int syncsafe)
+{
+  if (syncsafe)
+  {
+    return ((unsigned long) (bytes[0] & 0x7f) << 21) | ((bytes[1] & 0x7f) << 14) |
+      ((bytes[2] & 0x7f) << 7) | (bytes[3] & 0x7f);
+  }
+
+  return ((unsigned long) bytes[0] << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3];
+}
+
+static int splt_mp3_id3v2_frame_is_wanted(const unsigned char *frame_header, const char **wanted)
+{
+  int i = 0;
+  for (i = 0;wanted[i] != NULL;i++)
+  {
+    if (memcmp(frame_header, wanted[i], 4) == 0)
+    {
+      return SPLT_TRUE;
+    }
+  }
+
+  return SPLT_FALSE;
+}
+
+/*! Reads only the \p wanted frames of the ID3v2 tag starting \p in
+
+The headers of the other frames are read and their content is skipped
+with fseeko. The wanted frames are gathered in a new tag having the
+version of the original tag, without extended header and without padding.
+
+\return The new tag or NULL if there is no ID3v2 tag or if it must be read
+as a whole by libid3tag (not a 2.3 or 2.4 tag, unsynchronised tag or
+invalid frame header)
+*/
+static id3_byte_t *splt_mp3_read_id3v2_frames(FILE *in, const char **wanted,
+    id3_length_t *length, int *error)
+{
+  unsigned char header[SPLT_MP3_ID3V2_HEADER_SIZE];
+  unsigned char frame_header[SPLT_MP3_ID3V2_HEADER_SIZE];
+  splt_string_builder frames;
+  splt_su_builder_init(&frames);
+
+  *length = 0;
+
+  if (fseeko(in, 0, SEEK_SET) == -1) { return NULL; }
+  if (fread(header, 1, SPLT_MP3_ID3V2_HEADER_SIZE, in) != SPLT_MP3_ID3V2_HEADER_SIZE)
+  {
+    return NULL;
+  }
+
+  if (memcmp(header, "ID3", 3) != 0) { return NULL; }
+
+  int major_version = header[3];
+  if (major_version != 3 && major_version != 4) { return NULL; }
+  if (header[5] & SPLT_MP3_ID3V2_FLAG_UNSYNCHRONISATION) { return NULL; }
+
+  off_t end = SPLT_MP3_ID3V2_HEADER_SIZE + splt_mp3_unpack_id3v2_size(header + 6, SPLT_TRUE);
+  off_t position = SPLT_MP3_ID3V2_HEADER_SIZE;
+
+  if (header[5] & SPLT_MP3_ID3V2_FLAG_EXTENDED_HEADER)
+  {
+    if (fread(frame_header, 1, 4, in) != 4) { return NULL; }
+
+    //the 2.3 extended header size does not include its 4 size bytes
+    if (major_version == 4)
+    {
+      position += splt_mp3_unpack_id3v2_size(frame_header, SPLT_TRUE);
+    }
+    else
+    {
+      position += splt_mp3_unpack_id3v2_size(frame_header, SPLT_FALSE) + 4;
+    }
+
+    if (fseeko(in, position, SEEK_SET) == -1) { return NULL; }
+  }
+
+  int err = splt_su_builder_append(&frames, (const char *) header, SPLT_MP3_ID3V2_HEADER_SIZE);
+  if (err < 0) { goto error; }
+
+  while (position + SPLT_MP3_ID3V2_HEADER_SIZE <= end)
+  {
+    if (fread(frame_header, 1, SPLT_MP3_ID3V2_HEADER_SIZE, in) != SPLT_MP3_ID3V2_HEADER_SIZE)
+    {
+      goto fallback;
+    }
+
+    if (frame_header[0] == '\0')
+    {
+      break;
+    }
+
+    int i = 0;
+    for (i = 0;i < 4;i++)
+    {
+      if (!isupper(frame_header[i]) && !isdigit(frame_header[i]))
+      {
+        goto fallback;
+      }
+    }
+
+    size_t frame_size =
+      splt_mp3_unpack_id3v2_size(frame_header + 4, major_version == 4);
+    if (position + SPLT_MP3_ID3V2_HEADER_SIZE + (off_t) frame_size > end)
+    {
+      goto fallback;
+    }
+
+    if (splt_mp3_id3v2_frame_is_wanted(frame_header, wanted))
+    {
+      err = splt_su_builder_reserve(&frames, SPLT_MP3_ID3V2_HEADER_SIZE + frame_size);
+      if (err < 0) { goto error; }
+
+      memcpy(frames.str + frames.length, frame_header, SPLT_MP3_ID3V2_HEADER_SIZE);
+      if (fread(frames.str + frames.length + SPLT_MP3_ID3V2_HEADER_SIZE, 1,
+            frame_size, in) != frame_size)
+      {
+        goto fallback;
+      }
+      frames.length += SPLT_MP3_ID3V2_HEADER_SIZE + frame_size;
+    }
+    else if (fseeko(in, (off_t) frame_size, SEEK_CUR) == -1)
+    {
+      goto fallback;
+    }
+
+    position += SPLT_MP3_ID3V2_HEADER_SIZE + frame_size;
+  }
+
+  id3_byte_t *bytes = (id3_byte_t *) frames.str;
+  unsigned long tag_size = (unsigned long) (frames.length - SPLT_MP3_ID3V2_HEADER_SIZE);
+  bytes[5] = 0;
+  bytes[6] = (tag_size >> 21) & 0x7f;
+  bytes[7] = (tag_size >> 14) & 0x7f;
+  bytes[8] = (tag_size >> 7) & 0x7f;
+  bytes[9] = tag_size & 0x7f;
+
+  *length = (id3_length_t) frames.length;
+
+  return (id3_byte_t *) splt_su_builder_release(&frames);
+
+error:
+  *error = err;
+fallback:
+  splt_su_builder_free(&frames);
+  return NULL;
+}
+
+//!puts a original field of \p tags on id3 conforming to frame_type
+static int splt_mp3_put_original_libid3_frame(splt_tags *tags,
     const struct id3_tag *id3tag, const char *frame_type, int id_type)
 {
   struct id3_frame *frame = NULL;
@@ -515,27 +685,27 @@ static int splt_mp3_put_original_libid3_frame(splt_state *state,
         switch (id_type)
         {
           case SPLT_MP3_ID3_ALBUM:
-            err = splt_tu_set_original_tags_field(state,SPLT_TAGS_ALBUM, tag_value);
+            err = splt_tu_set_field_on_tags(tags, SPLT_TAGS_ALBUM, tag_value);
             break;
           case SPLT_MP3_ID3_ARTIST:
-            err = splt_tu_set_original_tags_field(state,SPLT_TAGS_ARTIST, tag_value);
+            err = splt_tu_set_field_on_tags(tags, SPLT_TAGS_ARTIST, tag_value);
             break;
           case SPLT_MP3_ID3_TITLE:
             if (strcmp(frame_type,ID3_FRAME_TITLE) == 0)
             {
-              err = splt_tu_set_original_tags_field(state,SPLT_TAGS_TITLE, tag_value);
+              err = splt_tu_set_field_on_tags(tags, SPLT_TAGS_TITLE, tag_value);
             }
             break;
           case SPLT_MP3_ID3_YEAR:
-            err = splt_tu_set_original_tags_field(state,SPLT_TAGS_YEAR, tag_value);
+            err = splt_tu_set_field_on_tags(tags, SPLT_TAGS_YEAR, tag_value);
             break;
           case SPLT_MP3_ID3_TRACK:
             ;
             int track = atoi((char *)tag_value);
-            err = splt_tu_set_original_tags_field(state,SPLT_TAGS_TRACK, &track);
+            err = splt_tu_set_field_on_tags(tags, SPLT_TAGS_TRACK, &track);
             break;
           case SPLT_MP3_ID3_COMMENT:
-            err = splt_tu_set_original_tags_field(state,SPLT_TAGS_COMMENT, tag_value);
+            err = splt_tu_set_field_on_tags(tags, SPLT_TAGS_COMMENT, tag_value);
             break;
           case SPLT_MP3_ID3_GENRE:
             ;
@@ -548,17 +718,17 @@ static int splt_mp3_put_original_libid3_frame(splt_state *state,
             }
             if ((id3v1 > 0) &&
                 (id3v1 < SPLT_ID3V1_NUMBER_OF_GENRES) &&
-                (state->original_tags.tags.genre == NULL))
+                (tags->genre == NULL))
             {
-              err = splt_tu_set_original_tags_field(state, SPLT_TAGS_GENRE, splt_id3v1_genres[id3v1]);
+              err = splt_tu_set_field_on_tags(tags, SPLT_TAGS_GENRE, splt_id3v1_genres[id3v1]);
             }
             else if (strlen(genre) == 0)
             {
-              err = splt_tu_set_original_tags_field(state, SPLT_TAGS_GENRE, SPLT_UNDEFINED_GENRE);
+              err = splt_tu_set_field_on_tags(tags, SPLT_TAGS_GENRE, SPLT_UNDEFINED_GENRE);
             }
             else
             {
-              err = splt_tu_set_original_tags_field(state, SPLT_TAGS_GENRE, genre);
+              err = splt_tu_set_field_on_tags(tags, SPLT_TAGS_GENRE, genre);
             }
             break;
           default:
@@ -577,6 +747,32 @@ static int splt_mp3_put_original_libid3_frame(splt_state *state,
   return err;
 }
 
+//! puts the original fields of \p tags from the frames of \p id3tag
+static int splt_mp3_put_original_libid3_frames(splt_tags *tags, const struct id3_tag *id3tag)
+{
+  int err = splt_mp3_put_original_libid3_frame(tags, id3tag, ID3_FRAME_ARTIST,
+      SPLT_MP3_ID3_ARTIST);
+  if (err < 0) { return err; }
+  err = splt_mp3_put_original_libid3_frame(tags, id3tag, ID3_FRAME_ALBUM,
+      SPLT_MP3_ID3_ALBUM);
+  if (err < 0) { return err; }
+  err = splt_mp3_put_original_libid3_frame(tags, id3tag, ID3_FRAME_TITLE,
+      SPLT_MP3_ID3_TITLE);
+  if (err < 0) { return err; }
+  err = splt_mp3_put_original_libid3_frame(tags, id3tag, ID3_FRAME_YEAR,
+      SPLT_MP3_ID3_YEAR);
+  if (err < 0) { return err; }
+  err = splt_mp3_put_original_libid3_frame(tags, id3tag, ID3_FRAME_GENRE,
+      SPLT_MP3_ID3_GENRE);
+  if (err < 0) { return err; }
+  err = splt_mp3_put_original_libid3_frame(tags, id3tag, ID3_FRAME_COMMENT,
+      SPLT_MP3_ID3_COMMENT);
+  if (err < 0) { return err; }
+
+  return splt_mp3_put_original_libid3_frame(tags, id3tag, ID3_FRAME_TRACK,
+      SPLT_MP3_ID3_TRACK);
+}
+
 //!macro used only in the following function splt_mp3_get_original_tags
 #define MP3_VERIFY_ERROR() \
 if (err != SPLT_OK) \
@@ -608,26 +804,7 @@ static void splt_mp3_get_original_tags(const char *filename,
   err = splt_tu_set_original_tags_field(state, SPLT_TAGS_VERSION,
       &bytes_and_size->version);
   if (err < 0) { *tag_error = err; goto error; };
-  err = splt_mp3_put_original_libid3_frame(state, id3tag, ID3_FRAME_ARTIST,
-      SPLT_MP3_ID3_ARTIST);
-  if (err < 0) { *tag_error = err; goto error; };
-  err = splt_mp3_put_original_libid3_frame(state, id3tag, ID3_FRAME_ALBUM,
-      SPLT_MP3_ID3_ALBUM);
-  if (err < 0) { *tag_error = err; goto error; };
-  err = splt_mp3_put_original_libid3_frame(state, id3tag, ID3_FRAME_TITLE,
-      SPLT_MP3_ID3_TITLE);
-  if (err < 0) { *tag_error = err; goto error; };
-  err = splt_mp3_put_original_libid3_frame(state, id3tag, ID3_FRAME_YEAR,
-      SPLT_MP3_ID3_YEAR);
-  if (err < 0) { *tag_error = err; goto error; };
-  err = splt_mp3_put_original_libid3_frame(state, id3tag, ID3_FRAME_GENRE,
-      SPLT_MP3_ID3_GENRE);
-  if (err < 0) { *tag_error = err; goto error; };
-  err = splt_mp3_put_original_libid3_frame(state, id3tag, ID3_FRAME_COMMENT,
-      SPLT_MP3_ID3_COMMENT);
-  if (err < 0) { *tag_error = err; goto error; };
-  err = splt_mp3_put_original_libid3_frame(state, id3tag, ID3_FRAME_TRACK,
-      SPLT_MP3_ID3_TRACK);
+  err = splt_mp3_put_original_libid3_frames(splt_tu_get_original_tags_tags(state), id3tag);
   if (err < 0) { *tag_error = err; goto error; };
 
   id3_tag_delete(id3tag);
@@ -748,6 +925,235 @@ error:
   return;
 }
 
+//! Frames set for each output file; TLEN is removed because the length changes
+static const char *splt_mp3_per_track_frame_ids[] = {
+  "TLEN", ID3_FRAME_TITLE, ID3_FRAME_ARTIST, ID3_FRAME_ALBUM,
+  ID3_FRAME_YEAR, ID3_FRAME_COMMENT, ID3_FRAME_TRACK, ID3_FRAME_GENRE, NULL
+};
+
+//! Returns the bit of the per track frame \p frame_id, or 0 for an invariant frame
+static int splt_mp3_per_track_frame_bit(const char *frame_id)
+{
+  int i = 0;
+  for (i = 0;splt_mp3_per_track_frame_ids[i] != NULL;i++)
+  {
+    if (strcmp(frame_id, splt_mp3_per_track_frame_ids[i]) == 0)
+    {
+      return 1 << i;
+    }
+  }
+
+  return 0;
+}
+
+static int splt_mp3_is_per_track_frame(const char *frame_id)
+{
+  return splt_mp3_per_track_frame_bit(frame_id) != 0;
+}
+
+//! Returns the bits of the per track frames found before an invariant frame
+static int splt_mp3_per_track_frames_before_invariant_frames(struct id3_tag *id)
+{
+  int per_track_frames_found = 0;
+  int per_track_frames_before_invariant_frames = 0;
+
+  unsigned int i = 0;
+  for (i = 0;i < id->nframes;i++)
+  {
+    int bit = splt_mp3_per_track_frame_bit(id->frames[i]->id);
+    if (bit != 0)
+    {
+      per_track_frames_found |= bit;
+    }
+    else
+    {
+      per_track_frames_before_invariant_frames |= per_track_frames_found;
+    }
+  }
+
+  return per_track_frames_before_invariant_frames;
+}
+
+static void splt_mp3_keep_frames(struct id3_tag *id, int keep_per_track_frames)
+{
+  int i = 0;
+  for (i = (int) id->nframes - 1;i >= 0;i--)
+  {
+    struct id3_frame *frame = id->frames[i];
+    if (splt_mp3_is_per_track_frame(frame->id) != keep_per_track_frames)
+    {
+      id3_tag_detachframe(id, frame);
+      id3_frame_delete(frame);
+    }
+  }
+}
+
+//! Renders an ID3v2 tag without padding, CRC and compression
+static id3_byte_t *splt_mp3_render_id3v2_without_padding(struct id3_tag *id,
+    id3_length_t *length, int *error)
+{
+  id3_tag_options(id, ID3_TAG_OPTION_CRC, 0);
+  id3_tag_options(id, ID3_TAG_OPTION_COMPRESSION, 0);
+  id3_tag_options(id, ID3_TAG_OPTION_ID3V1, 0);
+  id3_tag_setlength(id, 0);
+
+  *length = id3_tag_render(id, NULL);
+  if (*length == 0)
+  {
+    return NULL;
+  }
+
+  id3_byte_t *bytes = malloc(sizeof(id3_byte_t) * *length);
+  if (!bytes)
+  {
+    *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+    *length = 0;
+    return NULL;
+  }
+
+  *length = id3_tag_render(id, bytes);
+
+  return bytes;
+}
+
+//! Frames of tags having only a header can be concatenated
+static int splt_mp3_id3v2_tag_has_only_header(const id3_byte_t *bytes, id3_length_t length)
+{
+  if (length == 0)
+  {
+    return SPLT_TRUE;
+  }
+
+  if (length < SPLT_MP3_ID3V2_HEADER_SIZE)
+  {
+    return SPLT_FALSE;
+  }
+
+  return (bytes[5] & (SPLT_MP3_ID3V2_FLAG_EXTENDED_HEADER | SPLT_MP3_ID3V2_FLAG_FOOTER)) == 0;
+}
+
+/*! Splits the original ID3v2 tag in invariant and per track frames
+
+Unsynchronised tags are not split: a padding byte might be rendered after
+the last frame.
+*/
+static void splt_mp3_prepare_id3v2_template(tag_bytes_and_size *bytes_and_size, int *error)
+{
+  bytes_and_size->id3v2_template_prepared = SPLT_TRUE;
+  bytes_and_size->id3v2_template_usable = SPLT_FALSE;
+  bytes_and_size->per_track_frames_before_invariant_frames = 0;
+
+  struct id3_tag *invariant_frames =
+    id3_tag_parse(bytes_and_size->tag_bytes, bytes_and_size->tag_length);
+  struct id3_tag *per_track_frames =
+    id3_tag_parse(bytes_and_size->tag_bytes, bytes_and_size->tag_length);
+  if (!invariant_frames || !per_track_frames)
+  {
+    goto end;
+  }
+
+  if (id3_tag_options(invariant_frames, 0, 0) & ID3_TAG_OPTION_UNSYNCHRONISATION)
+  {
+    goto end;
+  }
+
+  bytes_and_size->per_track_frames_before_invariant_frames =
+    splt_mp3_per_track_frames_before_invariant_frames(invariant_frames);
+
+  splt_mp3_keep_frames(invariant_frames, SPLT_FALSE);
+  splt_mp3_keep_frames(per_track_frames, SPLT_TRUE);
+  splt_mp3_delete_existing_frames(per_track_frames, "TLEN");
+
+  bytes_and_size->invariant_frames_tag = splt_mp3_render_id3v2_without_padding(invariant_frames,
+      &bytes_and_size->invariant_frames_tag_length, error);
+  if (*error < 0) { goto end; }
+
+  bytes_and_size->per_track_frames_tag = splt_mp3_render_id3v2_without_padding(per_track_frames,
+      &bytes_and_size->per_track_frames_tag_length, error);
+  if (*error < 0) { goto end; }
+
+  bytes_and_size->id3v2_template_usable =
+    splt_mp3_id3v2_tag_has_only_header(bytes_and_size->invariant_frames_tag,
+        bytes_and_size->invariant_frames_tag_length) &&
+    splt_mp3_id3v2_tag_has_only_header(bytes_and_size->per_track_frames_tag,
+        bytes_and_size->per_track_frames_tag_length);
+
+end:
+  if (invariant_frames) { id3_tag_delete(invariant_frames); }
+  if (per_track_frames) { id3_tag_delete(per_track_frames); }
+}
+
+/*! Renders the invariant frames followed by the per track frames of \p id
+
+This is the order of the whole original tag rendered with the frames of the
+output file appended, as long as no kept per track frame comes before an
+invariant frame in the original tag.
+The tag is padded to the size of the original tag, as libid3tag does when
+rendering the parsed original tag.
+*/
+static char *splt_mp3_render_id3v2_from_template(struct id3_tag *id,
+    tag_bytes_and_size *bytes_and_size, unsigned long *number_of_bytes, int *error)
+{
+  id3_length_t per_track_length = 0;
+  id3_byte_t *per_track_tag = splt_mp3_render_id3v2_without_padding(id, &per_track_length, error);
+  if (*error < 0) { return NULL; }
+
+  const id3_byte_t *invariant_tag = bytes_and_size->invariant_frames_tag;
+  id3_length_t invariant_length = bytes_and_size->invariant_frames_tag_length;
+
+  id3_length_t per_track_frames_length =
+    per_track_length > 0 ? per_track_length - SPLT_MP3_ID3V2_HEADER_SIZE : 0;
+  id3_length_t invariant_frames_length =
+    invariant_length > 0 ? invariant_length - SPLT_MP3_ID3V2_HEADER_SIZE : 0;
+
+  const id3_byte_t *header = invariant_length > 0 ? invariant_tag : per_track_tag;
+  if (header == NULL)
+  {
+    *number_of_bytes = 0;
+    return NULL;
+  }
+
+  id3_length_t length =
+    SPLT_MP3_ID3V2_HEADER_SIZE + invariant_frames_length + per_track_frames_length;
+  if (length < bytes_and_size->tag_length)
+  {
+    length = bytes_and_size->tag_length;
+  }
+
+  id3_byte_t *bytes = malloc(sizeof(id3_byte_t) * length);
+  if (!bytes)
+  {
+    *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+    goto end;
+  }
+  memset(bytes, '\0', sizeof(id3_byte_t) * length);
+
+  memcpy(bytes, header, SPLT_MP3_ID3V2_HEADER_SIZE);
+  unsigned long tag_size = (unsigned long) (length - SPLT_MP3_ID3V2_HEADER_SIZE);
+  bytes[6] = (tag_size >> 21) & 0x7f;
+  bytes[7] = (tag_size >> 14) & 0x7f;
+  bytes[8] = (tag_size >> 7) & 0x7f;
+  bytes[9] = tag_size & 0x7f;
+
+  id3_byte_t *ptr = bytes + SPLT_MP3_ID3V2_HEADER_SIZE;
+  if (invariant_frames_length > 0)
+  {
+    memcpy(ptr, invariant_tag + SPLT_MP3_ID3V2_HEADER_SIZE, invariant_frames_length);
+    ptr += invariant_frames_length;
+  }
+  if (per_track_frames_length > 0)
+  {
+    memcpy(ptr, per_track_tag + SPLT_MP3_ID3V2_HEADER_SIZE, per_track_frames_length);
+  }
+
+  *number_of_bytes = (unsigned long) length;
+
+end:
+  if (per_track_tag) { free(per_track_tag); }
+
+  return (char *) bytes;
+}
+
 static char *splt_mp3_build_libid3tag(const char *title, const char *artist,
     const char *album, const char *year, const char *genre, 
     const char *comment, int track, int set_original_tags, 
@@ -755,10 +1161,48 @@ static char *splt_mp3_build_libid3tag(const char *title, const char *artist,
     splt_state *state)
 {
   struct id3_tag *id = NULL;
+  int from_id3v2_template = SPLT_FALSE;
 
   tag_bytes_and_size *bytes_and_size = (tag_bytes_and_size *) splt_tu_get_original_tags_data(state);
 
-  if (set_original_tags && bytes_and_size && bytes_and_size->version != 1)
+  if (set_original_tags && bytes_and_size && bytes_and_size->version != 1 && tags_version != 1)
+  {
+    if (!bytes_and_size->id3v2_template_prepared)
+    {
+      splt_mp3_prepare_id3v2_template(bytes_and_size, error);
+      if (*error < 0) { return NULL; }
+    }
+
+    //the whole tag keeps the frames in their original order and appends the rewritten ones
+    int rewritten_frames = splt_mp3_per_track_frame_bit("TLEN");
+    if (title) { rewritten_frames |= splt_mp3_per_track_frame_bit(ID3_FRAME_TITLE); }
+    if (artist) { rewritten_frames |= splt_mp3_per_track_frame_bit(ID3_FRAME_ARTIST); }
+    if (album) { rewritten_frames |= splt_mp3_per_track_frame_bit(ID3_FRAME_ALBUM); }
+    if (year) { rewritten_frames |= splt_mp3_per_track_frame_bit(ID3_FRAME_YEAR); }
+    if (comment) { rewritten_frames |= splt_mp3_per_track_frame_bit(ID3_FRAME_COMMENT); }
+    if (track != -1 && track != -2)
+    {
+      rewritten_frames |= splt_mp3_per_track_frame_bit(ID3_FRAME_TRACK);
+    }
+    if (genre) { rewritten_frames |= splt_mp3_per_track_frame_bit(ID3_FRAME_GENRE); }
+
+    from_id3v2_template = bytes_and_size->id3v2_template_usable &&
+      (bytes_and_size->per_track_frames_before_invariant_frames & ~rewritten_frames) == 0;
+  }
+
+  if (from_id3v2_template)
+  {
+    if (bytes_and_size->per_track_frames_tag_length > 0)
+    {
+      id = id3_tag_parse(bytes_and_size->per_track_frames_tag,
+          bytes_and_size->per_track_frames_tag_length);
+    }
+    else
+    {
+      id = id3_tag_new();
+    }
+  }
+  else if (set_original_tags && bytes_and_size && bytes_and_size->version != 1)
   {
     id = id3_tag_parse(bytes_and_size->tag_bytes, bytes_and_size->tag_length);
     splt_mp3_delete_existing_frames(id, "TLEN");
@@ -841,6 +1285,17 @@ static char *splt_mp3_build_libid3tag(const char *title, const char *artist,
       id3_field_textencoding, state);
   if (*error < 0) { goto error; }
 
+  if (from_id3v2_template)
+  {
+    bytes = (id3_byte_t *) splt_mp3_render_id3v2_from_template(id, bytes_and_size,
+        number_of_bytes, error);
+    if (*error < 0) { goto error; }
+
+    id3_tag_delete(id);
+
+    return (char *) bytes;
+  }
+
   //get the number of bytes needed for the tags
   bytes_length = id3_tag_render(id, NULL);
 
@@ -1150,7 +1605,12 @@ int splt_mp3_get_output_tags_version(splt_state *state)
       (splt_o_get_int_option(state, SPLT_OPT_TAGS) == SPLT_CURRENT_TAGS))
   {
     char *filename = splt_t_get_filename_to_split(state);
-    if (strcmp(filename, "-") != 0)
+    splt_mp3_state *mp3state = state->codec;
+    if (mp3state && mp3state->input_tags_version >= 0)
+    {
+      output_tags_version = mp3state->input_tags_version;
+    }
+    else if (strcmp(filename, "-") != 0)
     {
       int err = SPLT_OK;
       tag_bytes_and_size *bytes_and_size = splt_mp3_get_id3_tag_bytes(state, filename, &err);
@@ -1165,6 +1625,12 @@ int splt_mp3_get_output_tags_version(splt_state *state)
       {
         output_tags_version = 12;
       }
+
+      //the input file is read once for all the output files
+      if (err >= 0 && mp3state)
+      {
+        mp3state->input_tags_version = output_tags_version;
+      }
     }
   }
 
@@ -1209,6 +1675,7 @@ static splt_mp3_state *splt_mp3_info(FILE *file_input, splt_state *state, int fr
   mp3state->fend = 0;
   mp3state->end_non_zero = 0;
   mp3state->first = 1;
+  mp3state->input_tags_version = -1;
   mp3state->file_input = file_input;
   mp3state->framemode = framemode;
   mp3state->headw = 0;
@@ -1216,11 +1683,23 @@ static splt_mp3_state *splt_mp3_info(FILE *file_input, splt_state *state, int fr
   mp3state->is_guessed_vbr = SPLT_FALSE;
   mp3state->next_br_header_index = 0;
   mp3state->number_of_br_headers_stored = 0;
+  mp3state->frames_in_memory = splt_o_get_int_option(state, SPLT_OPT_INPUT_NOT_SEEKABLE) ||
+    splt_mp3_handle_bit_reservoir(state);
+  mp3state->read_frame = NULL;
+  mp3state->read_frame_allocated_size = 0;
+  int i = 0;
+  for (i = 0;i < SPLT_MP3_MAX_BYTE_RESERVOIR_HEADERS;i++)
+  {
+    mp3state->br_frames[i] = NULL;
+    mp3state->br_frames_allocated_size[i] = 0;
+  }
   mp3state->mp3file.xing = 0;
   mp3state->mp3file.xing_offset = 0;
   mp3state->mp3file.xingbuffer = NULL;
   mp3state->new_xing_lame_frame_size = 0;
   mp3state->new_xing_lame_frame = NULL;
+  mp3state->new_xing_lame_frame_xing_offset = 0;
+  mp3state->new_xing_lame_frame_delay_offset = 0;
   mp3state->overlapped_frames = NULL;
   mp3state->overlapped_frames_bytes = 0;
   mp3state->overlapped_number_of_frames = 0;
@@ -1818,7 +2297,7 @@ function_end:
   {
     if (file_output != stdout)
     {
-      if (fclose(file_output) != 0)
+      if (splt_os_fclose(state, file_output, error >= 0) != 0)
       {
         splt_e_set_strerror_msg_with_data(state, filename);
         return SPLT_ERROR_CANNOT_CLOSE_FILE;
@@ -1898,6 +2377,7 @@ static double splt_mp3_split(const char *output_fname, splt_state *state,
     int output_tags_version = splt_mp3_get_output_tags_version(state);
 
     off_t id3v2_end_offset = 0;
+    short xing_lame_frame_written = SPLT_FALSE;
 #ifndef NO_ID3TAG
     //write id3 tags version 2 at the start of the file
     if (output_tags_version == 2 || output_tags_version == 12)
@@ -1916,6 +2396,31 @@ static double splt_mp3_split(const char *output_fname, splt_state *state,
     {
       splt_d_print_debug(state,"Starting not seekable mp3 frame mode...\n");
 
+      int split_mode = splt_o_get_int_option(state, SPLT_OPT_SPLIT_MODE);
+      int live_split = (split_mode == SPLT_OPTION_LIVE_MODE);
+      //the joins are gapless with a LAME frame rewritten when the file is complete;
+      //the frames would be duplicated by the overlap in a single output stream
+      int live_bit_reservoir = live_split &&
+        splt_o_get_int_option(state, SPLT_OPT_HANDLE_BIT_RESERVOIR) &&
+        (file_output != stdout);
+      short first_frame_of_file = SPLT_TRUE;
+      int lame_delay = 0;
+
+      //with the live split, a new file is started on silence after sound
+      int live_split_on_silence = live_split &&
+        splt_o_get_int_option(state, SPLT_OPT_LIVE_SPLIT_ON_SILENCE);
+      mad_fixed_t silence_threshold = mad_f_tofixed(splt_co_convert_from_db(threshold));
+      long min_silence_c = (long) (min_length * 100);
+      long min_track_c = (long)
+        (splt_o_get_float_option(state, SPLT_OPT_PARAM_MIN_TRACK_LENGTH) * 100);
+      long silence_begin_c = -1;
+      short sound_was_found = SPLT_FALSE;
+      if (live_split_on_silence)
+      {
+        mad_synth_init(&mp3state->synth);
+        mp3state->temp_level = 0.0;
+      }
+
       long begin_c, end_c, time;
       //convert seconds to hundreths
       begin_c = (long) (fbegin_sec * 100);
@@ -1937,7 +2442,8 @@ static double splt_mp3_split(const char *output_fname, splt_state *state,
           writing = 1;
           fbegin = mp3state->frames;
 
-          if (mp3state->mp3file.xing > 0)
+          //the LAME frame of the live split is written with the first frame
+          if (mp3state->mp3file.xing > 0 && !live_bit_reservoir)
           {
             wrote = splt_io_fwrite(state, mp3state->mp3file.xingbuffer,
                 1, mp3state->mp3file.xing, file_output);
@@ -1953,9 +2459,77 @@ static double splt_mp3_split(const char *output_fname, splt_state *state,
         //we do the split
         if (writing)
         {
-          if (mp3state->data_len > 0)
+          //the frames holding the bit reservoir of the first frame are overlapped
+          if (live_bit_reservoir && first_frame_of_file && mp3state->data_len > 0)
           {
-            if ((len = splt_io_fwrite(state, mp3state->data_ptr, 1, mp3state->data_len, file_output))
+            first_frame_of_file = SPLT_FALSE;
+
+            unsigned char *frame = mp3state->data_ptr;
+            unsigned long frame_header = (unsigned long)
+              ((frame[0] << 24) | (frame[1] << 16) | (frame[2] << 8) | frame[3]);
+            splt_mp3_build_live_xing_lame_frame(mp3state, frame_header, state, error);
+            if (*error < 0) { goto bloc_end; }
+
+            void *xing_lame_frame = mp3state->new_xing_lame_frame;
+            int xing_size = mp3state->new_xing_lame_frame_size;
+            if (!xing_lame_frame)
+            {
+              xing_lame_frame = mp3state->mp3file.xingbuffer;
+              xing_size = mp3state->mp3file.xing;
+            }
+            if (splt_io_fwrite(state, xing_lame_frame, 1, xing_size, file_output) < xing_size)
+            {
+              splt_e_set_error_data(state,output_fname);
+              *error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
+              goto bloc_end;
+            }
+            wrote = (off_t) (wrote + xing_size);
+            xing_lame_frame_written = SPLT_TRUE;
+
+            //the first file starts with the delay of the encoder
+            if (fbegin == 0)
+            {
+              lame_delay = mp3state->mp3file.lame_delay;
+            }
+
+            //at least one frame is overlapped, to be decoded with the first frame
+            long number_of_reservoir_frames = splt_mp3_get_number_of_reservoir_frames(mp3state);
+            if (fbegin > 0 && number_of_reservoir_frames < 1)
+            {
+              number_of_reservoir_frames = 1;
+            }
+            if (number_of_reservoir_frames > 0)
+            {
+              mp3state->first_frame_inclusive = (long) mp3state->frames - number_of_reservoir_frames;
+              mp3state->last_frame_inclusive = (long) mp3state->frames - 1;
+              splt_mp3_get_overlapped_frames(mp3state->last_frame_inclusive, SPLT_FALSE,
+                  mp3state, state, error);
+              if (*error < 0) { goto bloc_end; }
+
+              size_t size = mp3state->overlapped_frames_bytes;
+              if (splt_io_fwrite(state, mp3state->overlapped_frames, 1, size, file_output) < size)
+              {
+                splt_e_set_error_data(state,output_fname);
+                *error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
+                goto bloc_end;
+              }
+              wrote = (off_t) (wrote + size);
+              fbegin -= mp3state->overlapped_number_of_frames;
+
+              //the players skip the overlapped frames
+              lame_delay = (int) mp3state->overlapped_number_of_frames *
+                mp3state->mp3file.samples_per_frame;
+
+              free(mp3state->overlapped_frames);
+              mp3state->overlapped_frames = NULL;
+              mp3state->overlapped_frames_bytes = 0;
+              mp3state->overlapped_number_of_frames = 0;
+            }
+          }
+
+          if (mp3state->data_len > 0)
+          {
+            if ((len = splt_io_fwrite(state, mp3state->data_ptr, 1, mp3state->data_len, file_output))
                 < mp3state->data_len)
             {
               splt_e_set_error_data(state,output_fname);
@@ -1970,6 +2544,11 @@ static double splt_mp3_split(const char *output_fname, splt_state *state,
           {
             finished = 1;
           }
+          if (sound_was_found && (silence_begin_c != -1) &&
+              (time - silence_begin_c >= min_silence_c) && (time - begin_c >= min_track_c))
+          {
+            finished = 1;
+          }
           if (eof || finished)
           {
             finished = 1;
@@ -1979,8 +2558,7 @@ static double splt_mp3_split(const char *output_fname, splt_state *state,
         }
 
         //progress bar
-        if (splt_o_get_int_option(state,SPLT_OPT_SPLIT_MODE)
-            == SPLT_OPTION_TIME_MODE)
+        if ((split_mode == SPLT_OPTION_TIME_MODE) || live_split)
         {
           splt_c_update_progress(state,(double)(time-begin_c),
               (double)(end_c-begin_c),1,0,
@@ -1997,6 +2575,24 @@ static double splt_mp3_split(const char *output_fname, splt_state *state,
         switch (splt_mp3_get_valid_frame(state, &mad_err))
         {
           case 1:
+            if (live_bit_reservoir)
+            {
+              splt_mp3_store_frame_in_memory(mp3state, error);
+              if (*error < 0) { goto bloc_end; }
+            }
+            if (live_split_on_silence && writing)
+            {
+              mad_synth_frame(&mp3state->synth, &mp3state->frame);
+              if (splt_mp3_silence(mp3state, MAD_NCHANNELS(&mp3state->frame.header), silence_threshold))
+              {
+                if (silence_begin_c == -1) { silence_begin_c = time; }
+              }
+              else
+              {
+                sound_was_found = SPLT_TRUE;
+                silence_begin_c = -1;
+              }
+            }
             mad_timer_add(&mp3state->timer, mp3state->frame.header.duration);
             mp3state->frames++;
             time = (unsigned long) mad_timer_count(mp3state->timer, MAD_UNITS_CENTISECONDS);
@@ -2017,6 +2613,53 @@ static double splt_mp3_split(const char *output_fname, splt_state *state,
         }
 
       } while (!finished);
+
+      //the next live file starts where this one really ends
+      if (live_split)
+      {
+        sec_end_time = time / 100.0;
+      }
+
+      //the LAME frame is rewritten with the frames and the delay of the complete file
+      if (xing_lame_frame_written)
+      {
+        int lame_padding = 0;
+        if (eof && mp3state->mp3file.lame_padding > 0)
+        {
+          lame_padding = mp3state->mp3file.lame_padding;
+        }
+
+        splt_mp3_update_live_xing_lame_frame(mp3state,
+            (unsigned long) (mp3state->frames - fbegin), (unsigned long) wrote,
+            lame_delay, lame_padding);
+
+        void *xing_lame_frame = mp3state->new_xing_lame_frame;
+        int xing_size = mp3state->new_xing_lame_frame_size;
+        if (!xing_lame_frame)
+        {
+          xing_lame_frame = mp3state->mp3file.xingbuffer;
+          xing_size = mp3state->mp3file.xing;
+        }
+
+        if (fseeko(file_output, id3v2_end_offset, SEEK_SET) == -1)
+        {
+          splt_e_set_strerror_msg_with_data(state, output_fname);
+          *error = SPLT_ERROR_SEEKING_FILE;
+          goto bloc_end;
+        }
+        if (splt_io_fwrite(state, xing_lame_frame, 1, xing_size, file_output) < xing_size)
+        {
+          splt_e_set_error_data(state,output_fname);
+          *error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
+          goto bloc_end;
+        }
+        if (fseeko(file_output, 0, SEEK_END) == -1)
+        {
+          splt_e_set_strerror_msg_with_data(state, output_fname);
+          *error = SPLT_ERROR_SEEKING_FILE;
+          goto bloc_end;
+        }
+      }
     }
     //if we don't have the framemode
     else
@@ -2205,7 +2848,7 @@ static double splt_mp3_split(const char *output_fname, splt_state *state,
     //we write id3 and other stuff
     if (file_output)
     {
-      if (mp3state->mp3file.xing > 0)
+      if (mp3state->mp3file.xing > 0 && !xing_lame_frame_written)
       {
         if (fseeko(file_output, mp3state->mp3file.xing_offset+4+id3v2_end_offset, SEEK_SET)!=-1)
         {
@@ -2245,7 +2888,7 @@ bloc_end:
     {
       if (file_output != stdout)
       {
-        if (fclose(file_output) != 0)
+        if (splt_os_fclose(state, file_output, *error >= 0) != 0)
         {
           splt_e_set_strerror_msg_with_data(state, output_fname);
           *error = SPLT_ERROR_CANNOT_CLOSE_FILE;
@@ -2362,7 +3005,8 @@ bloc_end:
           }
 
           mp3state->h = splt_mp3_makehead(mp3state->headw, mp3state->mp3file, mp3state->h, begin);
-          splt_mp3_read_process_side_info_main_data_begin(mp3state, begin);
+          splt_mp3_read_process_side_info_main_data_begin(mp3state, begin, error);
+          if (*error < 0) { goto bloc_end2; }
           mp3state->frames++;
 
           //if we have adjust mode, then put only 25%
@@ -2383,7 +3027,8 @@ bloc_end:
 
         if (splt_mp3_handle_bit_reservoir(state))
         {
-          splt_mp3_get_overlapped_frames(bit_reservoir_last_frame, mp3state, state, error);
+          splt_mp3_get_overlapped_frames(bit_reservoir_last_frame, SPLT_TRUE, mp3state, state,
+              error);
         }
       }
       else
@@ -2447,7 +3092,8 @@ bloc_end:
         }
 
         mp3state->h = splt_mp3_makehead (mp3state->headw, mp3state->mp3file, mp3state->h, end);
-        splt_mp3_read_process_side_info_main_data_begin(mp3state, end);
+        splt_mp3_read_process_side_info_main_data_begin(mp3state, end, error);
+        if (*error < 0) { goto bloc_end2; }
 
         if (frames_counter > 1)
         {
@@ -2643,6 +3289,747 @@ bloc_end2:
   return sec_end_time;
 }
 
+/****************************/
+/* mp3 single read pass split */
+
+//! Output file of a segment written by the single read pass split
+typedef struct {
+  char *output_fname;
+  FILE *file_output;
+  short opened;
+  //! first and last frames written, inclusive
+  unsigned long first_frame;
+  unsigned long last_frame;
+  unsigned long frames;
+  off_t bytes;
+  off_t id3v2_end_offset;
+  short with_xing;
+  //! ID3v1 tags built when the file is opened, as the tags of the next files may change them
+  char *id3v1_tags;
+  unsigned long id3v1_tags_size;
+  //! samples and frames of the bit reservoir handling, as set by splt_mp3_split
+  long begin_sample;
+  long end_sample;
+  long first_frame_inclusive;
+  long last_frame_inclusive;
+  //! last frame overlapped before the first frame, with the bit reservoir
+  long overlapped_last_frame;
+  unsigned long first_frame_header;
+  int first_bitrate;
+  short is_guessed_vbr;
+  short reservoir_frame;
+} splt_mp3_segment_output;
+
+static void splt_mp3_write_segment_output(splt_state *state, splt_mp3_segment_output *output,
+    const void *bytes, size_t size, int *error)
+{
+  if (splt_io_fwrite(state, bytes, 1, size, output->file_output) < size)
+  {
+    splt_e_set_error_data(state, output->output_fname);
+    *error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
+    return;
+  }
+
+  output->bytes += size;
+}
+
+/*! Returns the header of the frame \p frames_ahead frames after the current frame
+
+The input stays just after the current frame.
+\return 0 if there is no such frame
+*/
+static unsigned long splt_mp3_peek_frame_header(splt_state *state, int frames_ahead, int *error)
+{
+  splt_mp3_state *mp3state = state->codec;
+  FILE *file_input = mp3state->file_input;
+
+  unsigned long headw = mp3state->headw;
+  off_t position = ftello(file_input);
+
+  struct splt_header h = mp3state->h;
+  unsigned long frame_header = 0;
+
+  int i = 0;
+  for (i = 0;i < frames_ahead;i++)
+  {
+    off_t head = splt_mp3_findhead(mp3state, h.ptr + h.framesize);
+    if (head == -1)
+    {
+      frame_header = 0;
+      break;
+    }
+
+    h = splt_mp3_makehead(mp3state->headw, mp3state->mp3file, h, head);
+    frame_header = mp3state->headw;
+  }
+
+  mp3state->headw = headw;
+  if (fseeko(file_input, position, SEEK_SET) == -1)
+  {
+    splt_e_set_strerror_msg_with_data(state, splt_t_get_filename_to_split(state));
+    *error = SPLT_ERROR_SEEKING_FILE;
+  }
+
+  return frame_header;
+}
+
+/*! Writes the LAME frame, the bit reservoir frame and the overlapped frames of a segment
+
+As in splt_mp3_split, the overlapped frames and the bit reservoir are taken
+from the frames kept in memory and the LAME frame is built from the header of
+the third frame of the segment; its delay and padding are set when the file
+is closed.
+*/
+static void splt_mp3_write_bit_reservoir_frames(splt_state *state,
+    splt_mp3_segment_output *output, int *error)
+{
+  splt_mp3_state *mp3state = state->codec;
+
+  mp3state->begin_sample = output->begin_sample;
+  mp3state->first_frame_inclusive = output->first_frame_inclusive;
+
+  splt_mp3_get_overlapped_frames(output->overlapped_last_frame, SPLT_TRUE, mp3state, state, error);
+  if (*error < 0) { return; }
+
+  splt_mp3_extract_reservoir_and_build_reservoir_frame(mp3state, state, error);
+  if (*error < 0) { return; }
+
+  output->first_frame_header = splt_mp3_peek_frame_header(state, 2, error);
+  if (*error < 0) { return; }
+
+  splt_mp3_build_segment_xing_lame_frame(mp3state, output->first_frame_header, SPLT_FALSE,
+      state, error);
+  if (*error < 0) { return; }
+
+  if (mp3state->mp3file.xing > 0)
+  {
+    splt_mp3_write_segment_output(state, output, mp3state->mp3file.xingbuffer,
+        mp3state->mp3file.xing, error);
+  }
+  else
+  {
+    splt_mp3_write_segment_output(state, output, mp3state->new_xing_lame_frame,
+        mp3state->new_xing_lame_frame_size, error);
+  }
+  if (*error < 0) { return; }
+  output->with_xing = SPLT_TRUE;
+
+  struct splt_reservoir *reservoir = &mp3state->reservoir;
+  if (reservoir->reservoir_frame != NULL)
+  {
+    splt_mp3_write_segment_output(state, output, reservoir->reservoir_frame,
+        reservoir->reservoir_frame_size, error);
+    output->reservoir_frame = SPLT_TRUE;
+
+    free(reservoir->reservoir_frame);
+    reservoir->reservoir_frame = NULL;
+    reservoir->reservoir_frame_size = 0;
+    if (*error < 0) { return; }
+  }
+
+  if (mp3state->overlapped_frames != NULL)
+  {
+    splt_mp3_write_segment_output(state, output, mp3state->overlapped_frames,
+        mp3state->overlapped_frames_bytes, error);
+
+    free(mp3state->overlapped_frames);
+    mp3state->overlapped_frames = NULL;
+    mp3state->overlapped_frames_bytes = 0;
+    mp3state->overlapped_number_of_frames = 0;
+  }
+}
+
+//! Writes again the LAME frame of a segment split with the bit reservoir, with its delay and padding
+static int splt_mp3_write_segment_xing_lame_frame(splt_state *state,
+    splt_mp3_segment_output *output)
+{
+  splt_mp3_state *mp3state = state->codec;
+  int error = SPLT_OK;
+
+  mp3state->begin_sample = output->begin_sample;
+  mp3state->end_sample = output->end_sample;
+  mp3state->first_frame_inclusive = output->first_frame_inclusive;
+  mp3state->last_frame_inclusive = output->last_frame_inclusive;
+
+  splt_mp3_build_segment_xing_lame_frame(mp3state, output->first_frame_header,
+      output->is_guessed_vbr, state, &error);
+  if (error < 0) { return error; }
+
+  splt_mp3_update_segment_xing_lame_frame(mp3state, (unsigned long) output->bytes,
+      output->reservoir_frame);
+
+  void *xing_lame_frame = mp3state->new_xing_lame_frame;
+  size_t xing_size = mp3state->new_xing_lame_frame_size;
+  if (mp3state->mp3file.xing > 0)
+  {
+    xing_lame_frame = mp3state->mp3file.xingbuffer;
+    xing_size = mp3state->mp3file.xing;
+  }
+
+  FILE *file_output = output->file_output;
+  if (fseeko(file_output, output->id3v2_end_offset, SEEK_SET) == -1)
+  {
+    splt_e_set_strerror_msg_with_data(state, output->output_fname);
+    return SPLT_ERROR_SEEKING_FILE;
+  }
+
+  if (splt_io_fwrite(state, xing_lame_frame, 1, xing_size, file_output) < xing_size)
+  {
+    splt_e_set_error_data(state, output->output_fname);
+    return SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
+  }
+
+  if (fseeko(file_output, 0, SEEK_END) == -1)
+  {
+    splt_e_set_strerror_msg_with_data(state, output->output_fname);
+    return SPLT_ERROR_SEEKING_FILE;
+  }
+
+  return SPLT_OK;
+}
+
+//! Opens the output file of a segment and writes its tags and Xing frame
+static void splt_mp3_open_segment_output(splt_state *state, splt_segment_plan *plan,
+    int segment, splt_mp3_segment_output *output, int *error)
+{
+  splt_mp3_state *mp3state = state->codec;
+
+  output->output_fname = splt_sgp_open_segment(state, plan, segment, error);
+  if (output->output_fname == NULL) { return; }
+
+  splt_c_put_progress_text(state, SPLT_PROGRESS_CREATE);
+
+  if (!splt_o_get_int_option(state, SPLT_OPT_PRETEND_TO_SPLIT))
+  {
+    output->file_output = splt_mp3_open_file_write(state, output->output_fname, error);
+    if (*error < 0) { return; }
+  }
+  output->opened = SPLT_TRUE;
+
+  int output_tags_version = splt_mp3_get_output_tags_version(state);
+
+#ifndef NO_ID3TAG
+  if (output_tags_version == 2 || output_tags_version == 12)
+  {
+    int err = splt_mp3_write_id3v2_tags(state, output->file_output, output->output_fname,
+        &output->id3v2_end_offset);
+    if (err < 0) { *error = err; return; }
+  }
+#endif
+
+  if (output_tags_version == 1 || output_tags_version == 12)
+  {
+    output->id3v1_tags = splt_mp3_build_tags(splt_t_get_filename_to_split(state), state, error,
+        &output->id3v1_tags_size, 1);
+    if (*error < 0) { return; }
+  }
+
+  if (splt_mp3_handle_bit_reservoir(state))
+  {
+    splt_mp3_write_bit_reservoir_frames(state, output, error);
+    return;
+  }
+
+  //the frames and bytes of the Xing frame are set when the file is closed
+  if (splt_o_get_int_option(state, SPLT_OPT_XING) && mp3state->mp3file.xing > 0)
+  {
+    splt_mp3_write_segment_output(state, output, mp3state->mp3file.xingbuffer,
+        mp3state->mp3file.xing, error);
+    if (*error < 0) { return; }
+    output->with_xing = SPLT_TRUE;
+  }
+
+}
+
+/*! Updates the Xing frame, writes the ID3v1 tags and closes the output file of a segment
+
+The output file is reported to the client only if \p put_split_file is set.
+*/
+static void splt_mp3_close_segment_output(splt_state *state, splt_segment_plan *plan,
+    int segment, splt_mp3_segment_output *output, int put_split_file, int *error)
+{
+  splt_mp3_state *mp3state = state->codec;
+  FILE *file_output = output->file_output;
+
+  if (put_split_file && file_output && output->with_xing)
+  {
+    if (splt_mp3_handle_bit_reservoir(state))
+    {
+      int err = splt_mp3_write_segment_xing_lame_frame(state, output);
+      if (err < 0)
+      {
+        *error = err;
+        put_split_file = SPLT_FALSE;
+      }
+    }
+    else if (fseeko(file_output,
+          mp3state->mp3file.xing_offset + 4 + output->id3v2_end_offset, SEEK_SET) != -1)
+    {
+      unsigned long headw = output->frames;
+      fputc((headw >> 24) & 0xFF, file_output);
+      fputc((headw >> 16) & 0xFF, file_output);
+      fputc((headw >> 8) & 0xFF, file_output);
+      fputc((headw >> 0) & 0xFF, file_output);
+      headw = (unsigned long) output->bytes;
+      fputc((headw >> 24) & 0xFF, file_output);
+      fputc((headw >> 16) & 0xFF, file_output);
+      fputc((headw >> 8) & 0xFF, file_output);
+      fputc((headw >> 0) & 0xFF, file_output);
+
+      if (fseeko(file_output, 0, SEEK_END) == -1)
+      {
+        splt_e_set_strerror_msg_with_data(state, output->output_fname);
+        *error = SPLT_ERROR_SEEKING_FILE;
+        put_split_file = SPLT_FALSE;
+      }
+    }
+    else
+    {
+      splt_e_set_strerror_msg_with_data(state, output->output_fname);
+      *error = SPLT_ERROR_SEEKING_FILE;
+      put_split_file = SPLT_FALSE;
+    }
+  }
+
+  if (put_split_file && output->id3v1_tags && output->id3v1_tags_size > 0)
+  {
+    if (splt_io_fwrite(state, output->id3v1_tags, 1, output->id3v1_tags_size, file_output)
+        < output->id3v1_tags_size)
+    {
+      splt_e_set_error_data(state, output->output_fname);
+      *error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
+      put_split_file = SPLT_FALSE;
+    }
+  }
+
+  if (file_output && file_output != stdout)
+  {
+    if (splt_os_fclose(state, file_output, put_split_file && *error >= 0) != 0)
+    {
+      splt_e_set_strerror_msg_with_data(state, output->output_fname);
+      *error = SPLT_ERROR_CANNOT_CLOSE_FILE;
+      put_split_file = SPLT_FALSE;
+    }
+  }
+  output->file_output = NULL;
+  output->opened = SPLT_FALSE;
+
+  if (put_split_file)
+  {
+    //same end as returned by splt_mp3_split in frame mode
+    splt_sgp_close_segment(state, plan, segment, output->output_fname,
+        splt_sgp_get_end(plan, segment), error);
+  }
+
+  if (output->output_fname)
+  {
+    free(output->output_fname);
+    output->output_fname = NULL;
+  }
+  if (output->id3v1_tags)
+  {
+    free(output->id3v1_tags);
+    output->id3v1_tags = NULL;
+  }
+}
+
+/*! Sets the frames of a segment split with the bit reservoir
+
+The frames are the frames written by splt_mp3_split, computed as with
+splt_mp3_find_begin_frame and splt_mp3_find_end_frame. The first frame is
+after the frames overlapped for the bit reservoir, except when the segment
+starts at the end of the previous one.
+*/
+static void splt_mp3_set_bit_reservoir_segment_frames(splt_state *state,
+    splt_segment_plan *plan, splt_mp3_segment_output *outputs, int segment)
+{
+  splt_mp3_state *mp3state = state->codec;
+  struct splt_mp3 *mp3file = &mp3state->mp3file;
+  splt_mp3_segment_output *output = &outputs[segment];
+  splt_mp3_segment_output *previous_output = segment > 0 ? &outputs[segment - 1] : NULL;
+
+  double begin = splt_sgp_get_begin(plan, segment);
+  double end = splt_sgp_get_split_end(plan, segment);
+
+  output->begin_sample = (long) rint(begin * (double) mp3file->freq);
+  output->first_frame_inclusive = (long)
+    ((output->begin_sample + mp3file->lame_delay - SPLT_MP3_MIN_OVERLAP_SAMPLES_START)
+     / mp3file->samples_per_frame);
+  if (output->first_frame_inclusive < 0) { output->first_frame_inclusive = 0; }
+
+  if (end < 0)
+  {
+    output->end_sample = -1;
+    output->last_frame_inclusive = -1;
+  }
+  else
+  {
+    output->end_sample = (long) rint(end * (double) mp3file->freq);
+    if (output->end_sample < 0) { output->end_sample = 0; }
+    output->last_frame_inclusive = (long)
+      ((output->end_sample + mp3file->lame_delay + SPLT_MP3_MIN_OVERLAP_SAMPLES_END)
+       / mp3file->samples_per_frame);
+  }
+
+  if (splt_sgp_get_end(plan, segment) < 0)
+  {
+    output->last_frame = 0xFFFFFFFF;
+  }
+  else
+  {
+    output->last_frame = (unsigned long) output->last_frame_inclusive + 1;
+  }
+
+  if (previous_output && begin == splt_sgp_get_end(plan, segment - 1))
+  {
+    output->overlapped_last_frame = previous_output->last_frame_inclusive;
+    output->first_frame = previous_output->last_frame + 1;
+  }
+  else
+  {
+    long bit_reservoir_last_frame = (long)
+      ((output->begin_sample + mp3file->lame_delay + SPLT_MP3_MIN_OVERLAP_SAMPLES_END)
+       / mp3file->samples_per_frame);
+    output->overlapped_last_frame = bit_reservoir_last_frame;
+
+    output->first_frame = 1;
+    if (output->first_frame_inclusive > 0)
+    {
+      output->first_frame = (unsigned long) bit_reservoir_last_frame + 2;
+    }
+
+    if (previous_output && output->first_frame <= previous_output->last_frame)
+    {
+      output->first_frame = previous_output->last_frame + 1;
+    }
+  }
+
+  if (output->last_frame < output->first_frame)
+  {
+    output->last_frame = output->first_frame;
+  }
+}
+
+/*! Finds if the file of a segment is VBR, as splt_mp3_split does for its LAME frame
+
+The bitrates of the frames after the third frame of the segment, up to the
+frame after its last frame, are compared to the bitrate of the third frame.
+*/
+static void splt_mp3_check_segment_bitrate(splt_mp3_segment_output *output,
+    unsigned long current_frame, int bitrate)
+{
+  if (current_frame == output->first_frame + 2)
+  {
+    output->first_bitrate = bitrate;
+  }
+  else if (current_frame > output->first_frame + 2 && bitrate != output->first_bitrate)
+  {
+    output->is_guessed_vbr = SPLT_TRUE;
+  }
+}
+
+/*! Splits the segments of \p plan reading the input file once
+
+Each frame is read once from the beginning to the end of the input file and
+written in the output files of all the segments containing it; the output
+files of overlapping segments are opened at the same time.
+With the bit reservoir, the files start with the same LAME, bit reservoir and
+overlapped frames as with splt_mp3_split.
+
+\return SPLT_FALSE if the input file cannot be split in a single read pass
+*/
+static int splt_mp3_split_segments(splt_state *state, splt_segment_plan *plan, int *error)
+{
+  splt_mp3_state *mp3state = state->codec;
+
+  if (splt_o_get_int_option(state, SPLT_OPT_INPUT_NOT_SEEKABLE) ||
+      !mp3state->framemode ||
+      splt_o_get_int_option(state, SPLT_OPT_PARAM_GAP) > 0 ||
+      splt_io_input_is_stdout(state))
+  {
+    return SPLT_FALSE;
+  }
+
+  splt_d_print_debug(state, "Starting mp3 single read pass split...\n");
+
+  int number_of_segments = splt_sgp_get_number_of_segments(plan);
+  splt_mp3_segment_output *outputs = malloc(sizeof(splt_mp3_segment_output) * number_of_segments);
+  if (outputs == NULL)
+  {
+    *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+    return SPLT_TRUE;
+  }
+
+  long overlap_time = splt_o_get_long_option(state, SPLT_OPT_OVERLAP_TIME);
+  float fps = mp3state->mp3file.fps;
+  int handle_bit_reservoir = splt_mp3_handle_bit_reservoir(state);
+
+  int i = 0;
+  for (i = 0;i < number_of_segments;i++)
+  {
+    splt_mp3_segment_output *output = &outputs[i];
+    output->output_fname = NULL;
+    output->file_output = NULL;
+    output->opened = SPLT_FALSE;
+    output->frames = 0;
+    output->bytes = 0;
+    output->id3v2_end_offset = 0;
+    output->with_xing = SPLT_FALSE;
+    output->id3v1_tags = NULL;
+    output->id3v1_tags_size = 0;
+    output->first_frame_header = 0;
+    output->first_bitrate = 0;
+    output->is_guessed_vbr = SPLT_FALSE;
+    output->reservoir_frame = SPLT_FALSE;
+
+    if (handle_bit_reservoir)
+    {
+      splt_mp3_set_bit_reservoir_segment_frames(state, plan, outputs, i);
+      continue;
+    }
+
+    double begin = splt_sgp_get_begin(plan, i);
+    double end = splt_sgp_get_end(plan, i);
+
+    //contiguous segments do not share their boundary frame, as with the saved end point
+    output->first_frame = (unsigned long) (begin * fps);
+    if (i > 0 && overlap_time <= 0 && begin == splt_sgp_get_end(plan, i - 1))
+    {
+      output->first_frame = outputs[i - 1].last_frame + 1;
+    }
+    if (output->first_frame < 1)
+    {
+      output->first_frame = 1;
+    }
+
+    if (end < 0)
+    {
+      output->last_frame = 0xFFFFFFFF;
+    }
+    else
+    {
+      output->last_frame = (unsigned long) ceilf(end * fps);
+      if (output->last_frame < output->first_frame)
+      {
+        output->last_frame = output->first_frame;
+      }
+    }
+  }
+
+  unsigned char *frame = NULL;
+  int frame_allocated_size = 0;
+
+  unsigned long total_frames = (unsigned long) (splt_t_get_total_time(state) / 100.0 * fps);
+
+  FILE *file_input = mp3state->file_input;
+  off_t ptr = mp3state->mp3file.firsthead.ptr;
+  if (fseeko(file_input, ptr, SEEK_SET) == -1)
+  {
+    splt_e_set_strerror_msg_with_data(state, splt_t_get_filename_to_split(state));
+    *error = SPLT_ERROR_SEEKING_FILE;
+    goto end;
+  }
+
+  unsigned long current_frame = 1;
+  int next_segment = 0;
+  int first_open_segment = 0;
+  short eof = SPLT_FALSE;
+
+  while (!eof && (first_open_segment < number_of_segments))
+  {
+    if (splt_t_split_is_canceled(state))
+    {
+      *error = SPLT_SPLIT_CANCELLED;
+      goto end;
+    }
+
+    unsigned char header[4];
+    if (fread(header, 1, 4, file_input) < 4)
+    {
+      break;
+    }
+
+    unsigned long headw = (unsigned long)
+      ((header[0] << 24) | (header[1] << 16) | (header[2] << 8) | header[3]);
+    if (!splt_mp3_c_bitrate(headw))
+    {
+      //leaves the input just after the header found
+      off_t head = splt_mp3_findhead(mp3state, ptr);
+      if (head == -1)
+      {
+        break;
+      }
+
+      if (state->syncerrors >= 0)
+      {
+        state->syncerrors++;
+      }
+      if ((mp3state->syncdetect) && (state->syncerrors > SPLT_MAXSYNC))
+      {
+        splt_mp3_checksync(mp3state);
+      }
+
+      ptr = head;
+      headw = mp3state->headw;
+    }
+
+    mp3state->h = splt_mp3_makehead(headw, mp3state->mp3file, mp3state->h, ptr);
+    int frame_size = mp3state->h.framesize;
+    if (frame_size <= 4)
+    {
+      break;
+    }
+
+    if (frame_size > frame_allocated_size)
+    {
+      unsigned char *new_frame = realloc(frame, frame_size);
+      if (new_frame == NULL)
+      {
+        *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+        goto end;
+      }
+      frame = new_frame;
+      frame_allocated_size = frame_size;
+    }
+
+    frame[0] = (headw >> 24) & 0xFF;
+    frame[1] = (headw >> 16) & 0xFF;
+    frame[2] = (headw >> 8) & 0xFF;
+    frame[3] = headw & 0xFF;
+
+    //the last frame may be truncated
+    size_t read_bytes = fread(frame + 4, 1, frame_size - 4, file_input);
+    if (read_bytes < (size_t) (frame_size - 4))
+    {
+      eof = SPLT_TRUE;
+      frame_size = (int) read_bytes + 4;
+    }
+
+    if (handle_bit_reservoir)
+    {
+      //as in splt_mp3_split, the frame after the last frame of a file is read before closing it
+      mp3state->frames = current_frame;
+      for (i = first_open_segment;i < next_segment;i++)
+      {
+        splt_mp3_segment_output *output = &outputs[i];
+        if (output->opened && output->last_frame < current_frame)
+        {
+          splt_mp3_check_segment_bitrate(output, current_frame, mp3state->h.bitrate);
+          splt_mp3_close_segment_output(state, plan, i, output, SPLT_TRUE, error);
+          if (*error < 0) { goto end; }
+        }
+      }
+
+      //the first frame of the input is not kept in memory by splt_mp3_split
+      if (current_frame > 1)
+      {
+        mp3state->headw = headw;
+        splt_mp3_store_frame_bytes_in_memory(mp3state, frame, frame_size, error);
+        if (*error < 0) { goto end; }
+      }
+    }
+
+    while ((next_segment < number_of_segments) &&
+        (outputs[next_segment].first_frame <= current_frame))
+    {
+      splt_mp3_open_segment_output(state, plan, next_segment, &outputs[next_segment], error);
+      next_segment++;
+      if (*error < 0) { goto end; }
+    }
+
+    for (i = first_open_segment;i < next_segment;i++)
+    {
+      splt_mp3_segment_output *output = &outputs[i];
+      if (!output->opened)
+      {
+        continue;
+      }
+
+      splt_mp3_write_segment_output(state, output, frame, frame_size, error);
+      if (*error < 0) { goto end; }
+      output->frames++;
+
+      if (handle_bit_reservoir)
+      {
+        splt_mp3_check_segment_bitrate(output, current_frame, mp3state->h.bitrate);
+      }
+      else if (output->last_frame <= current_frame)
+      {
+        splt_mp3_close_segment_output(state, plan, i, output, SPLT_TRUE, error);
+        if (*error < 0) { goto end; }
+      }
+    }
+
+    while ((first_open_segment < next_segment) && !outputs[first_open_segment].opened)
+    {
+      first_open_segment++;
+    }
+
+    if (next_segment > 0)
+    {
+      splt_mp3_segment_output *output = &outputs[next_segment - 1];
+      unsigned long last_frame = output->last_frame;
+      if (last_frame == 0xFFFFFFFF)
+      {
+        last_frame = total_frames;
+      }
+
+      splt_c_update_progress(state, (double) (current_frame - output->first_frame),
+          (double) (last_frame - output->first_frame), 1, 0, SPLT_DEFAULT_PROGRESS_RATE);
+    }
+
+    ptr += frame_size;
+    current_frame++;
+  }
+
+  //the remaining segments end at the end of the file
+  if (first_open_segment < number_of_segments)
+  {
+    mp3state->frames = current_frame;
+    for (i = first_open_segment;i < next_segment;i++)
+    {
+      if (outputs[i].opened)
+      {
+        splt_mp3_close_segment_output(state, plan, i, &outputs[i], SPLT_TRUE, error);
+        if (*error < 0) { goto end; }
+      }
+    }
+
+    *error = SPLT_OK_SPLIT_EOF;
+  }
+  else
+  {
+    *error = SPLT_OK_SPLIT;
+  }
+
+end:
+  for (i = 0;i < number_of_segments;i++)
+  {
+    if (outputs[i].opened || outputs[i].output_fname)
+    {
+      //keeps the first error
+      int close_error = SPLT_OK;
+      splt_mp3_close_segment_output(state, plan, i, &outputs[i], SPLT_FALSE, &close_error);
+      if (*error >= 0 && close_error < 0)
+      {
+        *error = close_error;
+      }
+    }
+  }
+  free(outputs);
+
+  if (frame)
+  {
+    free(frame);
+  }
+
+  mp3state->frames = 1;
+  mp3state->first = 1;
+  mp3state->end = 0;
+
+  return SPLT_TRUE;
+}
+
 /****************************/
 /* mp3 syncerror */
 
@@ -2762,7 +4149,8 @@ static void splt_mp3_syncerror_search(splt_state *state, int *error)
 
       mp3state->h = splt_mp3_makehead (mp3state->headw, mp3state->mp3file,
           mp3state->h, offset);
-      splt_mp3_read_process_side_info_main_data_begin(mp3state, offset);
+      splt_mp3_read_process_side_info_main_data_begin(mp3state, offset, error);
+      if (*error < 0) { return; }
 
       if (splt_t_split_is_canceled(state))
       {
@@ -3528,6 +4916,11 @@ double splt_pl_split(splt_state *state, const char *final_fname,
   return splt_mp3_split(final_fname, state, begin_point, end_point, error, save_end_point);
 }
 
+int splt_pl_split_segments(splt_state *state, splt_segment_plan *plan, splt_code *error)
+{
+  return splt_mp3_split_segments(state, plan, error);
+}
+
 //! Plugin API: Output a portion of the file
 int splt_pl_offset_split(splt_state *state, char *output_fname, off_t begin, off_t end)
 {
@@ -3606,21 +4999,11 @@ void splt_pl_clear_original_tags(splt_original_tags *original_tags)
 #endif
 }
 
-void splt_pl_import_internal_sheets(splt_state *state, splt_code *error)
-{
 #ifndef NO_ID3TAG
-  char *input_filename = splt_t_get_filename_to_split(state);
-  splt_mp3_get_original_tags(input_filename, state, error);
-  if (*error < 0) { return; }
-
-  tag_bytes_and_size *bytes_and_size = (tag_bytes_and_size *) splt_tu_get_original_tags_data(state);
-  if (bytes_and_size == NULL) { return; }
-  if (bytes_and_size->tag_bytes == NULL) { return; }
-
-  struct id3_tag *id3tag =
-    id3_tag_parse(bytes_and_size->tag_bytes, bytes_and_size->tag_length);
-  if (!id3tag) { goto end; }
-
+//! Appends the splitpoints of the CHAP frames of \p id3tag and sets their \p tags
+static void splt_mp3_put_chapters(splt_state *state, const splt_tags *tags,
+    struct id3_tag *id3tag, splt_code *error)
+{
   struct id3_frame *frame = NULL;
   int counter = 0;
   int number_of_splitpoints = 0;
@@ -3638,12 +5021,15 @@ void splt_pl_import_internal_sheets(splt_state *state, splt_code *error)
 
     //skip element id
     id3_byte_t *ptr = data;
-    while (*ptr != '\0' && remaining_length > 0)
+    while (remaining_length > 0 && *ptr != '\0')
     {
       ptr++;
       remaining_length--;
     }
 
+    //element id end, start time and end time
+    if (remaining_length < 9) { counter++; continue; }
+
     ptr++;
     unsigned start_time_in_millis = (ptr[0] << 24) | (ptr[1] << 16) | (ptr[2] << 8) | ptr[3];
     ptr++; ptr++; ptr++; ptr++;
@@ -3655,7 +5041,7 @@ void splt_pl_import_internal_sheets(splt_state *state, splt_code *error)
       splt_c_put_warning_message_to_client(state,
           _(" warning: overlapped chapters are not yet supported.\n"));
       *error = SPLT_PLUGIN_ERROR_UNSUPPORTED_FEATURE;
-      goto end;
+      return;
     }
 
     if (start_time_hundr == previous_end_time && index > 0)
@@ -3677,26 +5063,137 @@ void splt_pl_import_internal_sheets(splt_state *state, splt_code *error)
     index += 2;
   }
 
-  splt_tags *original_tags = splt_tu_get_original_tags_tags(state);
   int track_number = number_of_splitpoints - 1;
-  splt_cc_put_filenames_from_tags(state, track_number, error, original_tags, SPLT_FALSE,
-      SPLT_TRUE);
+  splt_cc_put_filenames_from_tags(state, track_number, error, tags, SPLT_FALSE, SPLT_TRUE);
+}
+
+/*! Imports the chapters of \p filename as splitpoints and puts its tags in \p tags
+
+Only the chapters and the tags frames of the ID3v2 tag are read when
+possible; otherwise the whole tag is read.
+*/
+static void splt_mp3_import_chapters(splt_state *state, const char *filename,
+    splt_tags *tags, splt_code *error)
+{
+  id3_byte_t *bytes = NULL;
+  id3_length_t length = 0;
+  int version = 2;
+  struct id3_tag *id3tag = NULL;
+
+  FILE *file = splt_io_fopen(filename, "rb");
+  if (!file)
+  {
+    splt_e_set_strerror_msg_with_data(state, filename);
+    *error = SPLT_ERROR_CANNOT_OPEN_FILE;
+    return;
+  }
+
+  bytes = splt_mp3_read_id3v2_frames(file, splt_mp3_chapters_frames, &length, error);
+  if (bytes && splt_mp3_getid3v1_offset(file) != 0)
+  {
+    version = 12;
+  }
+  fclose(file);
+  if (*error < 0) { goto end; }
+
+  if (bytes == NULL)
+  {
+    tag_bytes_and_size *bytes_and_size = splt_mp3_get_id3_tag_bytes(state, filename, error);
+    if (bytes_and_size == NULL) { goto end; }
+
+    bytes = bytes_and_size->tag_bytes;
+    length = bytes_and_size->tag_length;
+    version = bytes_and_size->version;
+    bytes_and_size->tag_bytes = NULL;
+
+    splt_mp3_free_bytes_and_size(bytes_and_size);
+    free(bytes_and_size);
+
+    if (*error < 0) { goto end; }
+  }
+
+  if (bytes == NULL) { goto end; }
+
+  id3tag = id3_tag_parse(bytes, length);
+  if (!id3tag) { goto end; }
+
+  int err = splt_tu_set_field_on_tags(tags, SPLT_TAGS_VERSION, &version);
+  if (err < 0) { *error = err; goto end; }
+  err = splt_mp3_put_original_libid3_frames(tags, id3tag);
+  if (err < 0) { *error = err; goto end; }
+
+  splt_mp3_put_chapters(state, tags, id3tag, error);
 
 end:
   if (id3tag)
   {
     id3_tag_delete(id3tag);
   }
-  if (bytes_and_size)
+  if (bytes)
   {
-    splt_mp3_free_bytes_and_size(bytes_and_size);
-    free(bytes_and_size);
+    free(bytes);
   }
+}
+#endif
+
+//! Checks the first bytes of \p filename for an ID3v2 tag or a mpeg frame
+static int splt_mp3_file_starts_like_mp3(splt_state *state, const char *filename,
+    splt_code *error)
+{
+  unsigned char bytes[3] = { '\0' };
+
+  FILE *file = splt_io_fopen(filename, "rb");
+  if (!file)
+  {
+    splt_e_set_strerror_msg_with_data(state, filename);
+    *error = SPLT_ERROR_CANNOT_OPEN_FILE;
+    return SPLT_FALSE;
+  }
+
+  size_t bytes_read = fread(bytes, 1, 3, file);
+  fclose(file);
+
+  if (bytes_read == 3 && memcmp(bytes, "ID3", 3) == 0)
+  {
+    return SPLT_TRUE;
+  }
+
+  return bytes_read >= 2 && bytes[0] == 0xFF && (bytes[1] & 0xE0) == 0xE0;
+}
+
+void splt_pl_import_internal_sheets(splt_state *state, splt_code *error)
+{
+#ifndef NO_ID3TAG
+  splt_tu_free_original_tags(state);
+  splt_mp3_import_chapters(state, splt_t_get_filename_to_split(state),
+      splt_tu_get_original_tags_tags(state), error);
 #else
   *error = SPLT_PLUGIN_ERROR_UNSUPPORTED_FEATURE;
 #endif
 }
 
+int splt_pl_import_internal_sheets_plan(splt_state *state, const char *filename,
+    splt_code *error)
+{
+  if (!splt_mp3_file_starts_like_mp3(state, filename, error))
+  {
+    return SPLT_FALSE;
+  }
+
+#ifndef NO_ID3TAG
+  splt_tags *tags = splt_tu_new_tags(error);
+  if (tags == NULL) { return SPLT_TRUE; }
+
+  splt_mp3_import_chapters(state, filename, tags, error);
+
+  splt_tu_free_one_tags(&tags);
+#else
+  *error = SPLT_PLUGIN_ERROR_UNSUPPORTED_FEATURE;
+#endif
+
+  return SPLT_TRUE;
+}
+
 #ifndef NO_ID3TAG
 static void splt_mp3_free_bytes_and_size(tag_bytes_and_size *bytes_and_size)
 {
@@ -3717,9 +5214,26 @@ static void splt_mp3_free_bytes_and_size(tag_bytes_and_size *bytes_and_size)
     bytes_and_size->tag_bytes_v1 = NULL;
   }
 
+  if (bytes_and_size->invariant_frames_tag)
+  {
+    free(bytes_and_size->invariant_frames_tag);
+    bytes_and_size->invariant_frames_tag = NULL;
+  }
+
+  if (bytes_and_size->per_track_frames_tag)
+  {
+    free(bytes_and_size->per_track_frames_tag);
+    bytes_and_size->per_track_frames_tag = NULL;
+  }
+
   bytes_and_size->tag_length = 0;
   bytes_and_size->tag_length_v1 = 0;
   bytes_and_size->version = 0;
+  bytes_and_size->invariant_frames_tag_length = 0;
+  bytes_and_size->per_track_frames_tag_length = 0;
+  bytes_and_size->id3v2_template_prepared = SPLT_FALSE;
+  bytes_and_size->id3v2_template_usable = SPLT_FALSE;
+  bytes_and_size->per_track_frames_before_invariant_frames = 0;
 }
 
 static tag_bytes_and_size *splt_mp3_new_bytes_and_size()
@@ -3732,6 +5246,13 @@ static tag_bytes_and_size *splt_mp3_new_bytes_and_size()
   bytes_and_size->tag_bytes_v1 = NULL;
   bytes_and_size->tag_length_v1 = 0;
   bytes_and_size->version = 0;
+  bytes_and_size->id3v2_template_prepared = SPLT_FALSE;
+  bytes_and_size->id3v2_template_usable = SPLT_FALSE;
+  bytes_and_size->per_track_frames_before_invariant_frames = 0;
+  bytes_and_size->invariant_frames_tag = NULL;
+  bytes_and_size->invariant_frames_tag_length = 0;
+  bytes_and_size->per_track_frames_tag = NULL;
+  bytes_and_size->per_track_frames_tag_length = 0;
 
   return bytes_and_size;
 }
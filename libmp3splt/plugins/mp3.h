@@ -66,7 +66,28 @@ typedef struct {
 
   unsigned int version;
   unsigned int bytes_tags_version;
+
+  /*! The original ID3v2 tag split in two, prepared by the first output file.
+
+  The invariant frames (pictures, private frames, ...) are the same in all the
+  output files and are rendered once; the per track frames are parsed again
+  for each output file and rendered with the new title, track, ...
+  */
+  int id3v2_template_prepared;
+  //! SPLT_FALSE if the original tag must be rendered as a whole for each file
+  int id3v2_template_usable;
+  id3_byte_t *invariant_frames_tag;
+  id3_length_t invariant_frames_tag_length;
+  id3_byte_t *per_track_frames_tag;
+  id3_length_t per_track_frames_tag_length;
+  //! Bits of the per track frames coming before an invariant frame in the original tag
+  int per_track_frames_before_invariant_frames;
 } tag_bytes_and_size;
+
+#define SPLT_MP3_ID3V2_HEADER_SIZE 10
+#define SPLT_MP3_ID3V2_FLAG_UNSYNCHRONISATION 0x80
+#define SPLT_MP3_ID3V2_FLAG_EXTENDED_HEADER 0x40
+#define SPLT_MP3_ID3V2_FLAG_FOOTER 0x10
 #endif
 
 struct splt_header {
@@ -138,6 +159,9 @@ typedef struct {
   int first;
   unsigned long headw;
 
+  //! ID3 version of the input file used when no tags version is known; -1 until read
+  int input_tags_version;
+
   unsigned first_frame_header_for_reservoir;
   int is_guessed_vbr;
 
@@ -148,6 +172,14 @@ typedef struct {
   struct splt_header br_headers[SPLT_MP3_MAX_BYTE_RESERVOIR_HEADERS];
   int next_br_header_index;
   int number_of_br_headers_stored;
+  //! bytes of the frames of br_headers, kept only when #frames_in_memory is set
+  unsigned char *br_frames[SPLT_MP3_MAX_BYTE_RESERVOIR_HEADERS];
+  int br_frames_allocated_size[SPLT_MP3_MAX_BYTE_RESERVOIR_HEADERS];
+  //! SPLT_TRUE when the input is not seekable or when the bit reservoir is handled
+  short frames_in_memory;
+  //! frame being read in #br_frames
+  unsigned char *read_frame;
+  int read_frame_allocated_size;
   struct splt_reservoir reservoir;
   long begin_sample;
   long end_sample;
@@ -160,6 +192,9 @@ typedef struct {
 
   int new_xing_lame_frame_size;
   unsigned char *new_xing_lame_frame;
+  //! offsets of the Xing flags and of the LAME delay in #new_xing_lame_frame
+  int new_xing_lame_frame_xing_offset;
+  int new_xing_lame_frame_delay_offset;
 
   //used internally, libmad structures
   struct mad_stream stream;
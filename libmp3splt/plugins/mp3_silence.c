@@ -36,7 +36,6 @@ static void splt_mp3_scan_silence_and_process(splt_state *state, off_t begin_off
     short process_silence(double time, float level, int silence_was_found, short must_flush,
       splt_scan_silence_data *ssd, int *found, int *error),
     splt_scan_silence_data *ssd, int *error);
-static int splt_mp3_silence(splt_mp3_state *mp3state, int channels, mad_fixed_t threshold);
 
 /*! scan for silence
 
@@ -215,7 +214,7 @@ Used by mp3_scan_silence
 
 Always computes only one frame
 */
-static int splt_mp3_silence(splt_mp3_state *mp3state, int channels, mad_fixed_t threshold)
+int splt_mp3_silence(splt_mp3_state *mp3state, int channels, mad_fixed_t threshold)
 {
   int i, j;
   mad_fixed_t sample;
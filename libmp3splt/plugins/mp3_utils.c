@@ -176,11 +176,55 @@ static void splt_mp3_store_header(splt_mp3_state *mp3state)
   }
 }
 
-void splt_mp3_read_process_side_info_main_data_begin(splt_mp3_state *mp3state, off_t offset)
+//! Reads the rest of the frame whose header has just been read and keeps it in memory
+static void splt_mp3_read_frame_in_memory(splt_mp3_state *mp3state, splt_code *error)
+{
+  int frame_size = mp3state->h.framesize;
+  if (frame_size < 4) { return; }
+
+  if (mp3state->read_frame_allocated_size < frame_size)
+  {
+    unsigned char *frame = realloc(mp3state->read_frame, frame_size);
+    if (frame == NULL)
+    {
+      *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+      return;
+    }
+
+    mp3state->read_frame = frame;
+    mp3state->read_frame_allocated_size = frame_size;
+  }
+
+  unsigned char *frame = mp3state->read_frame;
+  frame[0] = (mp3state->headw >> 24) & 0xFF;
+  frame[1] = (mp3state->headw >> 16) & 0xFF;
+  frame[2] = (mp3state->headw >> 8) & 0xFF;
+  frame[3] = mp3state->headw & 0xFF;
+
+  //the last frame of the file may be truncated
+  size_t read_bytes = fread(frame + 4, 1, frame_size - 4, mp3state->file_input);
+
+  splt_mp3_store_frame_bytes_in_memory(mp3state, frame, (int) read_bytes + 4, error);
+}
+
+/*! Reads the main data begin of the frame whose header has just been read
+
+When #frames_in_memory is set, the rest of the frame is read and kept in
+memory next to its header, so that the overlapped frames and the bit
+reservoir can be taken without seeking back in the input.
+*/
+void splt_mp3_read_process_side_info_main_data_begin(splt_mp3_state *mp3state, off_t offset,
+    splt_code *error)
 {
   //side info is only for layer 3
   if (mp3state->mp3file.layer != 3) { return; }
 
+  if (mp3state->frames_in_memory)
+  {
+    splt_mp3_read_frame_in_memory(mp3state, error);
+    return;
+  }
+
   //skip crc
   if (mp3state->h.has_crc)
   {
@@ -208,6 +252,64 @@ void splt_mp3_read_process_side_info_main_data_begin(splt_mp3_state *mp3state, o
   splt_mp3_store_header(mp3state);
 }
 
+/*! Stores the header and the bytes of the frame just read from a not seekable input
+
+The frame bytes are kept in memory next to the bit reservoir headers, because
+splt_mp3_get_overlapped_frames cannot read them again from the input.
+*/
+void splt_mp3_store_frame_in_memory(splt_mp3_state *mp3state, splt_code *error)
+{
+  splt_mp3_store_frame_bytes_in_memory(mp3state, mp3state->data_ptr, (int) mp3state->data_len,
+      error);
+}
+
+//! Stores the header and the \p frame_size bytes of \p frame next to the bit reservoir headers
+void splt_mp3_store_frame_bytes_in_memory(splt_mp3_state *mp3state,
+    const unsigned char *frame, int frame_size, splt_code *error)
+{
+  //side info is only for layer 3
+  if (mp3state->mp3file.layer != 3) { return; }
+
+  if (frame == NULL || frame_size < 4) { return; }
+
+  unsigned long headword = (unsigned long)
+    ((frame[0] << 24) | (frame[1] << 16) | (frame[2] << 8) | frame[3]);
+  mp3state->h = splt_mp3_makehead(headword, mp3state->mp3file, mp3state->h, mp3state->h.ptr);
+
+  int main_data_begin_offset = mp3state->h.has_crc ? 6 : 4;
+  if (frame_size < main_data_begin_offset + 2) { return; }
+
+  unsigned int main_data_begin = frame[main_data_begin_offset];
+  //main_data_begin has 9 bits in MPEG1 and 8 in MPEG2
+  if (mp3state->mp3file.mpgid == SPLT_MP3_MPEG1_ID)
+  {
+    main_data_begin <<= 8;
+    main_data_begin |= frame[main_data_begin_offset + 1];
+    main_data_begin >>= 7;
+  }
+  mp3state->h.main_data_begin = (int) main_data_begin;
+
+  int index = mp3state->next_br_header_index;
+  if (mp3state->br_frames_allocated_size[index] < frame_size)
+  {
+    unsigned char *frame_copy = realloc(mp3state->br_frames[index], frame_size);
+    if (frame_copy == NULL)
+    {
+      *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+      return;
+    }
+
+    mp3state->br_frames[index] = frame_copy;
+    mp3state->br_frames_allocated_size[index] = frame_size;
+  }
+  memcpy(mp3state->br_frames[index], frame, frame_size);
+
+  //the stored bytes are the frame really read
+  mp3state->h.framesize = frame_size;
+
+  splt_mp3_store_header(mp3state);
+}
+
 static void splt_mp3_update_existing_xing(splt_mp3_state *mp3state, unsigned long frames, 
     unsigned long bytes)
 {
@@ -477,6 +579,18 @@ static unsigned char *splt_mp3_create_new_xing_lame_frame(splt_mp3_state *mp3sta
   return frame;
 }
 
+static void splt_mp3_write_delay_and_padding(char *delay_padding_ptr, int delay, int padding)
+{
+  if (delay > SPLT_MP3_LAME_MAX_DELAY) { delay = SPLT_MP3_LAME_MAX_DELAY; }
+  if (padding > SPLT_MP3_LAME_MAX_PADDING) { padding = SPLT_MP3_LAME_MAX_PADDING; }
+  if (delay < 0) { delay = 0; }
+  if (padding < 0) { padding = 0; }
+
+  *delay_padding_ptr = (char) (delay >> 4);
+  *(delay_padding_ptr + 1) = (char) (delay & 0xF) << 4 | (padding >> 8);
+  *(delay_padding_ptr + 2) = (char) padding;
+}
+
 static void splt_mp3_update_delay_and_padding_on_lame_frame(splt_mp3_state *mp3state,
     char *delay_padding_ptr, short reservoir_frame, unsigned long *frames)
 {
@@ -515,14 +629,7 @@ static void splt_mp3_update_delay_and_padding_on_lame_frame(splt_mp3_state *mp3s
     *frames = *frames + 1;
   }
 
-  if (delay > SPLT_MP3_LAME_MAX_DELAY) { delay = SPLT_MP3_LAME_MAX_DELAY; }
-  if (padding > SPLT_MP3_LAME_MAX_PADDING) { padding = SPLT_MP3_LAME_MAX_PADDING; }
-  if (delay < 0) { delay = 0; }
-  if (padding < 0) { padding = 0; }
-
-  *delay_padding_ptr = (char) (delay >> 4);
-  *(delay_padding_ptr + 1) = (char) (delay & 0xF) << 4 | (padding >> 8);
-  *(delay_padding_ptr + 2) = (char) padding;
+  splt_mp3_write_delay_and_padding(delay_padding_ptr, delay, padding);
 }
 
 void splt_mp3_build_xing_lame_frame(splt_mp3_state *mp3state, off_t begin, off_t end, 
@@ -607,6 +714,141 @@ void splt_mp3_build_xing_lame_frame(splt_mp3_state *mp3state, off_t begin, off_t
   //TODO2: update lame crc16
 }
 
+/*! Prepares the LAME frame written at the beginning of a live split file
+
+The Xing frame of the input is used when it has a LAME header; otherwise a new
+LAME frame is created from the header of the first frame of the file.
+The frames, bytes, delay and padding are set with
+splt_mp3_update_live_xing_lame_frame once the file is complete.
+*/
+void splt_mp3_build_live_xing_lame_frame(splt_mp3_state *mp3state,
+    unsigned long frame_header, splt_state *state, splt_code *error)
+{
+  if (mp3state->mp3file.xing > 0 && splt_mp3_xing_frame_has_lame(mp3state))
+  {
+    return;
+  }
+
+  mp3state->first_frame_header_for_reservoir = (unsigned) frame_header;
+
+  int xing_offset = 0;
+  int end_xing_offset = 0;
+  int frame_size = 0;
+  unsigned char *frame = splt_mp3_create_new_xing_lame_frame(mp3state, state, &frame_size,
+      &xing_offset, &end_xing_offset, error);
+  if (*error < 0) { return; }
+
+  if (mp3state->new_xing_lame_frame)
+  {
+    free(mp3state->new_xing_lame_frame);
+  }
+
+  mp3state->new_xing_lame_frame_size = frame_size;
+  mp3state->new_xing_lame_frame = frame;
+  mp3state->new_xing_lame_frame_xing_offset = xing_offset;
+  mp3state->new_xing_lame_frame_delay_offset = end_xing_offset + SPLT_MP3_LAME_DELAY_OFFSET;
+}
+
+/*! Sets the frames, bytes, delay and padding of the live split LAME frame
+
+\param frames Number of frames after the LAME frame
+\param bytes Size of the file, with the LAME frame
+\param delay Samples skipped by the players at the beginning of the file
+\param padding Samples skipped by the players at the end of the file
+*/
+void splt_mp3_update_live_xing_lame_frame(splt_mp3_state *mp3state,
+    unsigned long frames, unsigned long bytes, int delay, int padding)
+{
+  if (mp3state->new_xing_lame_frame == NULL)
+  {
+    char *delay_padding_ptr = &mp3state->mp3file.xingbuffer[splt_mp3_get_delay_offset(mp3state)];
+    splt_mp3_write_delay_and_padding(delay_padding_ptr, delay, padding);
+    splt_mp3_update_existing_xing(mp3state, frames, bytes);
+    return;
+  }
+
+  unsigned char *frame = mp3state->new_xing_lame_frame;
+  int xing_offset = mp3state->new_xing_lame_frame_xing_offset;
+
+  frame[xing_offset + 4] = (frames >> 24) & 0xFF;
+  frame[xing_offset + 5] = (frames >> 16) & 0xFF;
+  frame[xing_offset + 6] = (frames >> 8) & 0xFF;
+  frame[xing_offset + 7] = frames & 0xFF;
+
+  frame[xing_offset + 8] = (bytes >> 24) & 0xFF;
+  frame[xing_offset + 9] = (bytes >> 16) & 0xFF;
+  frame[xing_offset + 10] = (bytes >> 8) & 0xFF;
+  frame[xing_offset + 11] = bytes & 0xFF;
+
+  char *delay_padding_ptr = (char *) &frame[mp3state->new_xing_lame_frame_delay_offset];
+  splt_mp3_write_delay_and_padding(delay_padding_ptr, delay, padding);
+}
+
+/*! Prepares the LAME frame of a file split in a single read pass with the bit reservoir
+
+As with splt_mp3_build_xing_lame_frame, the Xing frame of the input is used
+when it has a LAME header and a new LAME frame is created from \p frame_header
+when the input has no Xing frame.
+*/
+void splt_mp3_build_segment_xing_lame_frame(splt_mp3_state *mp3state,
+    unsigned long frame_header, short is_guessed_vbr, splt_state *state, splt_code *error)
+{
+  if (mp3state->mp3file.xing > 0)
+  {
+    if (!splt_mp3_xing_frame_has_lame(mp3state))
+    {
+      *error = SPLT_ERROR_FAILED_BITRESERVOIR;
+      splt_e_set_error_data(state, "input files with Xing frame without LAME not yet supported");
+    }
+
+    return;
+  }
+
+  mp3state->is_guessed_vbr = is_guessed_vbr;
+  splt_mp3_build_live_xing_lame_frame(mp3state, frame_header, state, error);
+}
+
+/*! Sets the frames, bytes, delay and padding of the LAME frame of a file split in a single read pass
+
+The delay and padding are computed as with splt_mp3_build_xing_lame_frame, from
+the #begin_sample, #end_sample, #first_frame_inclusive, #last_frame_inclusive and
+#frames of the file.
+
+\param bytes Size of the file, with the LAME frame
+\param reservoir_frame If a bit reservoir frame is written before the first frame
+*/
+void splt_mp3_update_segment_xing_lame_frame(splt_mp3_state *mp3state,
+    unsigned long bytes, short reservoir_frame)
+{
+  unsigned long frames = 0;
+
+  if (mp3state->new_xing_lame_frame == NULL)
+  {
+    char *delay_padding_ptr = &mp3state->mp3file.xingbuffer[splt_mp3_get_delay_offset(mp3state)];
+    splt_mp3_update_delay_and_padding_on_lame_frame(mp3state, delay_padding_ptr, reservoir_frame,
+        &frames);
+    splt_mp3_update_existing_xing(mp3state, frames, bytes);
+    return;
+  }
+
+  unsigned char *frame = mp3state->new_xing_lame_frame;
+  char *delay_padding_ptr = (char *) &frame[mp3state->new_xing_lame_frame_delay_offset];
+  splt_mp3_update_delay_and_padding_on_lame_frame(mp3state, delay_padding_ptr, reservoir_frame,
+      &frames);
+
+  int xing_offset = mp3state->new_xing_lame_frame_xing_offset;
+
+  frame[xing_offset + 4] = (frames >> 24) & 0xFF;
+  frame[xing_offset + 5] = (frames >> 16) & 0xFF;
+  frame[xing_offset + 6] = (frames >> 8) & 0xFF;
+  frame[xing_offset + 7] = frames & 0xFF;
+
+  frame[xing_offset + 8] = (bytes >> 24) & 0xFF;
+  frame[xing_offset + 9] = (bytes >> 16) & 0xFF;
+  frame[xing_offset + 10] = (bytes >> 8) & 0xFF;
+  frame[xing_offset + 11] = bytes & 0xFF;
+}
+
 static int splt_mp3_current_br_header_index(splt_mp3_state *mp3state)
 {
   int current_header_index = mp3state->next_br_header_index - 1;
@@ -638,12 +880,53 @@ static void splt_mp3_back_br_header_index(splt_mp3_state *mp3state)
   }
 }
 
-void splt_mp3_get_overlapped_frames(long last_frame, splt_mp3_state *mp3state,
-    splt_state *state, splt_code *error)
+/*! Number of frames before the current one holding the main data it points to
+
+Used when the input is not seekable, to know how many frames to be overlapped
+at the beginning of the next file.
+*/
+long splt_mp3_get_number_of_reservoir_frames(splt_mp3_state *mp3state)
+{
+  if (mp3state->mp3file.layer != 3) { return 0; }
+
+  int back_pointer = mp3state->h.main_data_begin;
+  int number_of_headers_stored = mp3state->number_of_br_headers_stored - 1;
+  int header_index = splt_mp3_current_br_header_index(mp3state);
+
+  long number_of_frames = 0;
+  while ((back_pointer > 0) && (number_of_headers_stored > 0))
+  {
+    header_index = splt_mp3_previous_br_header_index(mp3state, header_index);
+    number_of_headers_stored--;
+
+    back_pointer -= mp3state->br_headers[header_index].frame_data_space;
+    number_of_frames++;
+  }
+
+  return number_of_frames;
+}
+
+/*! Copies the frames from #first_frame_inclusive to \p last_frame in #overlapped_frames
+
+The frames are taken from the frames kept in memory when they were read.
+If \p rewind_br_headers is set, the current bit reservoir header becomes the
+header of the first overlapped frame.
+*/
+void splt_mp3_get_overlapped_frames(long last_frame, short rewind_br_headers,
+    splt_mp3_state *mp3state, splt_state *state, splt_code *error)
 {
   if (last_frame <= 0) { return; }
 
   long number_of_frames_to_be_overlapped = last_frame - mp3state->first_frame_inclusive + 1;
+  if (number_of_frames_to_be_overlapped > mp3state->number_of_br_headers_stored - 1)
+  {
+    number_of_frames_to_be_overlapped = mp3state->number_of_br_headers_stored - 1;
+  }
+  if (number_of_frames_to_be_overlapped <= 0)
+  {
+    mp3state->overlapped_frames_bytes = 0;
+    return;
+  }
 
   /*fprintf(stdout, "frames to be overlapped = %ld\n", number_of_frames_to_be_overlapped);
   fflush(stdout);*/
@@ -652,23 +935,28 @@ void splt_mp3_get_overlapped_frames(long last_frame, splt_mp3_state *mp3state,
   mp3state->overlapped_frames_bytes = 0;
 
   int index = 0;
-  off_t frame_offsets[SPLT_MP3_MAX_BYTE_RESERVOIR_HEADERS] = { 0 };
   int frame_sizes[SPLT_MP3_MAX_BYTE_RESERVOIR_HEADERS] = { 0 };
+  int header_indexes[SPLT_MP3_MAX_BYTE_RESERVOIR_HEADERS] = { 0 };
 
   int i = 0;
   for (;i < number_of_frames_to_be_overlapped; i++)
   {
     current_header_index = splt_mp3_previous_br_header_index(mp3state, current_header_index);
 
+    if (mp3state->br_frames[current_header_index] == NULL)
+    {
+      splt_e_set_error_data(state, "Bit reservoir frame not kept in memory !");
+      *error = SPLT_ERROR_INVALID_CODE;
+      return;
+    }
+
     mp3state->overlapped_frames_bytes += mp3state->br_headers[current_header_index].framesize;
-    frame_offsets[index] = mp3state->br_headers[current_header_index].ptr;
     frame_sizes[index] = mp3state->br_headers[current_header_index].framesize;
+    header_indexes[index] = current_header_index;
     index++;
     mp3state->overlapped_number_of_frames++;
   }
 
-  off_t previous_position = ftello(mp3state->file_input);
-
   if (mp3state->overlapped_frames) {
     free(mp3state->overlapped_frames);
   }
@@ -682,37 +970,14 @@ void splt_mp3_get_overlapped_frames(long last_frame, splt_mp3_state *mp3state,
   long current_index_in_frames = 0;
   for (i = index - 1;i >= 0; i--)
   {
-    off_t frame_offset = frame_offsets[i];
+    memcpy(mp3state->overlapped_frames + current_index_in_frames,
+        mp3state->br_frames[header_indexes[i]], frame_sizes[i]);
+    current_index_in_frames += frame_sizes[i];
 
-    if (fseeko(mp3state->file_input, frame_offset, SEEK_SET) == -1)
+    if (rewind_br_headers)
     {
-      splt_e_set_strerror_msg_with_data(state, splt_t_get_filename_to_split(state));
-      *error = SPLT_ERROR_SEEKING_FILE;
-      return;
-    }
-
-    int frame_size = frame_sizes[i];
-    unsigned char *frame = splt_io_fread(mp3state->file_input, frame_size);
-    if (!frame)
-    {
-      splt_e_clean_strerror_msg(state);
-      splt_e_set_error_data(state, splt_t_get_filename_to_split(state));
-      *error = SPLT_ERROR_WHILE_READING_FILE;
-      return;
+      splt_mp3_back_br_header_index(mp3state);
     }
-
-    memcpy(mp3state->overlapped_frames + current_index_in_frames, frame, frame_size);
-    current_index_in_frames += frame_size;
-    free(frame);
-
-    splt_mp3_back_br_header_index(mp3state);
-  }
-
-  if (fseeko(mp3state->file_input, previous_position, SEEK_SET) == -1)
-  {
-    splt_e_set_strerror_msg_with_data(state, splt_t_get_filename_to_split(state));
-    *error = SPLT_ERROR_SEEKING_FILE;
-    return;
   }
 
   /*fprintf(stdout, "overlapped frames bytes follows:\n");
@@ -755,7 +1020,7 @@ unsigned long splt_mp3_find_begin_frame(double fbegin_sec, splt_mp3_state *mp3st
   mp3state->first_frame_inclusive = first_frame_inclusive;
 
   long last_frame = mp3state->last_frame_inclusive;
-  splt_mp3_get_overlapped_frames(last_frame, mp3state, state, error);
+  splt_mp3_get_overlapped_frames(last_frame, SPLT_TRUE, mp3state, state, error);
   if (*error < 0) { return 0; }
 
   return (unsigned long) first_frame_inclusive;
@@ -811,20 +1076,13 @@ static void splt_mp3_extract_reservoir_main_data_bytes(splt_mp3_state *mp3state,
     return;
   }
 
-  off_t previous_position = ftello(mp3state->file_input);
-
-  unsigned char **data_from_frames = malloc(sizeof(unsigned char *) * SPLT_MP3_MAX_BYTE_RESERVOIR_HEADERS);
-  int *bytes_to_copy = malloc(sizeof(int *) * SPLT_MP3_MAX_BYTE_RESERVOIR_HEADERS);
-  if (data_from_frames == NULL || bytes_to_copy == NULL)
-  {
-    *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
-    return;
-  }
+  const unsigned char *data_from_frames[SPLT_MP3_MAX_BYTE_RESERVOIR_HEADERS];
+  int bytes_to_copy[SPLT_MP3_MAX_BYTE_RESERVOIR_HEADERS] = { 0 };
 
   int is_first_file = splt_t_get_current_split_file_number(state) == 1;
 
   int number_of_frames = 0;
-  while (back_pointer > 0)
+  while ((back_pointer > 0) && (number_of_frames < SPLT_MP3_MAX_BYTE_RESERVOIR_HEADERS))
   {
     current_header_index = splt_mp3_previous_br_header_index(mp3state, current_header_index);
     number_of_headers_stored--;
@@ -835,9 +1093,12 @@ static void splt_mp3_extract_reservoir_main_data_bytes(splt_mp3_state *mp3state,
     {
       splt_e_set_error_data(state, "Bit reservoir number of headers stored is negative !");
       *error = SPLT_ERROR_INVALID_CODE;
-      goto end;
+      return;
     }
 
+    //the frames before the beginning of the file are not stored
+    if (mp3state->br_frames[current_header_index] == NULL) { break; }
+
     h = &mp3state->br_headers[current_header_index];
 
     if (h->frame_data_space == 0) { continue; }
@@ -848,45 +1109,28 @@ static void splt_mp3_extract_reservoir_main_data_bytes(splt_mp3_state *mp3state,
       number_of_bytes_to_copy = back_pointer;
     }
 
-    off_t frame_main_data_offset = h->ptr + h->sideinfo_size + 4;
+    int frame_main_data_offset = h->sideinfo_size + 4;
     if (number_of_bytes_to_copy < h->frame_data_space)
     {
       frame_main_data_offset += h->frame_data_space - number_of_bytes_to_copy;
     }
 
-    /*fprintf(stdout, "Copying %d bytes into reservoir\n", number_of_bytes_to_copy);
-    fflush(stdout);*/
-
-    if (fseeko(mp3state->file_input, frame_main_data_offset, SEEK_SET) == -1)
-    {
-      splt_e_set_strerror_msg_with_data(state, splt_t_get_filename_to_split(state));
-      *error = SPLT_ERROR_SEEKING_FILE;
-      goto end;
-    }
-
-    unsigned char *data_from_frame = splt_io_fread(mp3state->file_input, number_of_bytes_to_copy);
-    if (data_from_frame)
-    {
-      /*unsigned int it = 0;
-      for (;it < number_of_bytes_to_copy;it++)
-      {
-        fprintf(stdout, "%02x ", data_from_frame[it]);
-      }
-      fprintf(stdout, "\n");
-      fflush(stdout);*/
-
-      data_from_frames[number_of_frames] = data_from_frame;
-      bytes_to_copy[number_of_frames] = number_of_bytes_to_copy;
-      number_of_frames++;
-    }
-    else
+    //the last frame of the file may be truncated
+    if (frame_main_data_offset + (int) number_of_bytes_to_copy > h->framesize)
     {
-      splt_e_clean_strerror_msg(state);
       splt_e_set_error_data(state, splt_t_get_filename_to_split(state));
       *error = SPLT_ERROR_WHILE_READING_FILE;
-      goto end;
+      return;
     }
 
+    /*fprintf(stdout, "Copying %d bytes into reservoir\n", number_of_bytes_to_copy);
+    fflush(stdout);*/
+
+    data_from_frames[number_of_frames] =
+      mp3state->br_frames[current_header_index] + frame_main_data_offset;
+    bytes_to_copy[number_of_frames] = number_of_bytes_to_copy;
+    number_of_frames++;
+
     back_pointer -= number_of_bytes_to_copy;
   }
 
@@ -896,12 +1140,9 @@ static void splt_mp3_extract_reservoir_main_data_bytes(splt_mp3_state *mp3state,
   number_of_frames--;
   for (;number_of_frames >= 0; number_of_frames--)
   {
-    unsigned char *data_from_frame = data_from_frames[number_of_frames];
-    int number_of_bytes_to_copy = bytes_to_copy[number_of_frames];
-
-    memcpy(res->reservoir + res->reservoir_end, data_from_frame, number_of_bytes_to_copy);
-    res->reservoir_end += number_of_bytes_to_copy;
-    free(data_from_frame);
+    memcpy(res->reservoir + res->reservoir_end, data_from_frames[number_of_frames],
+        bytes_to_copy[number_of_frames]);
+    res->reservoir_end += bytes_to_copy[number_of_frames];
   }
 
   /*unsigned int index = 0;
@@ -912,19 +1153,6 @@ static void splt_mp3_extract_reservoir_main_data_bytes(splt_mp3_state *mp3state,
   }
   fprintf(stdout, "_\n");
   fflush(stdout);*/
-
-  if (res->reservoir_end > 0)
-  {
-    if (fseeko(mp3state->file_input, previous_position, SEEK_SET) == -1)
-    {
-      splt_e_set_strerror_msg_with_data(state, splt_t_get_filename_to_split(state));
-      *error = SPLT_ERROR_SEEKING_FILE;
-    }
-  }
-
-end:
-  free(bytes_to_copy);
-  free(data_from_frames);
 }
 
 static void splt_mp3_build_reservoir_frame(splt_mp3_state *mp3state, splt_state *state, splt_code *error)
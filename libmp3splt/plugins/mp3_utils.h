@@ -39,7 +39,11 @@ off_t splt_mp3_findvalidhead(splt_mp3_state *mp3state, off_t start);
 int splt_mp3_get_frame(splt_mp3_state *mp3state);
 int splt_mp3_get_valid_frame(splt_state *state, int *error);
 
-void splt_mp3_read_process_side_info_main_data_begin(splt_mp3_state *mp3state, off_t offset);
+void splt_mp3_read_process_side_info_main_data_begin(splt_mp3_state *mp3state, off_t offset,
+    splt_code *error);
+void splt_mp3_store_frame_in_memory(splt_mp3_state *mp3state, splt_code *error);
+void splt_mp3_store_frame_bytes_in_memory(splt_mp3_state *mp3state,
+    const unsigned char *frame, int frame_size, splt_code *error);
 void splt_mp3_extract_reservoir_and_build_reservoir_frame(splt_mp3_state *mp3state,
     splt_state *state, splt_code *error);
 void splt_mp3_build_xing_lame_frame(splt_mp3_state *mp3state, off_t begin, off_t end, 
@@ -48,13 +52,22 @@ void splt_mp3_build_xing_lame_frame(splt_mp3_state *mp3state, off_t begin, off_t
 int splt_mp3_get_mpeg_as_int(int mpgid);
 int splt_mp3_get_samples_per_frame(struct splt_mp3 *mp3file);
 void splt_mp3_parse_xing_lame(splt_mp3_state *mp3state);
+void splt_mp3_build_live_xing_lame_frame(splt_mp3_state *mp3state,
+    unsigned long frame_header, splt_state *state, splt_code *error);
+void splt_mp3_update_live_xing_lame_frame(splt_mp3_state *mp3state,
+    unsigned long frames, unsigned long bytes, int delay, int padding);
+void splt_mp3_build_segment_xing_lame_frame(splt_mp3_state *mp3state,
+    unsigned long frame_header, short is_guessed_vbr, splt_state *state, splt_code *error);
+void splt_mp3_update_segment_xing_lame_frame(splt_mp3_state *mp3state,
+    unsigned long bytes, short reservoir_frame);
 
 unsigned long splt_mp3_find_begin_frame(double fbegin_sec, splt_mp3_state *mp3state,
     splt_state *state, splt_code *error);
 unsigned long splt_mp3_find_end_frame(double fend_sec, splt_mp3_state *mp3state, 
     splt_state *state);
 
-void splt_mp3_get_overlapped_frames(long last_frame, splt_mp3_state *mp3state,
-    splt_state *state, splt_code *error);
+long splt_mp3_get_number_of_reservoir_frames(splt_mp3_state *mp3state);
+void splt_mp3_get_overlapped_frames(long last_frame, short rewind_br_headers,
+    splt_mp3_state *mp3state, splt_state *state, splt_code *error);
 int splt_mp3_handle_bit_reservoir(splt_state *state);
 
@@ -560,11 +560,28 @@ splt_ogg_state *splt_ogg_info(FILE *in, splt_state *state, int *error)
   vorbis_synthesis_init(oggstate->vd, oggstate->vi);
   vorbis_block_init(oggstate->vd, oggstate->vb);
 
-  srand(time(NULL));
+  //each state has its own generator: rand() state is shared by all threads
+  oggstate->random_serial_seed = (unsigned int) time(NULL) ^ (unsigned int) (size_t) oggstate;
+  if (oggstate->random_serial_seed == 0)
+  {
+    oggstate->random_serial_seed = 1;
+  }
 
   return oggstate;
 }
 
+//xorshift generator for the serial numbers of the output streams
+static int splt_ogg_new_random_serial(splt_ogg_state *oggstate)
+{
+  unsigned int x = oggstate->random_serial_seed;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  oggstate->random_serial_seed = x;
+
+  return (int) (x & 0x7fffffff);
+}
+
 /****************************/
 /* ogg split */
 
@@ -1312,7 +1329,7 @@ double splt_ogg_split(const char *output_fname, splt_state *state,
     }
     else
     {
-      if (!(oggstate->out = splt_io_fopen(output_fname, "wb")))
+      if (!(oggstate->out = splt_os_fopen(state, output_fname, "wb")))
       {
         splt_e_set_strerror_msg_with_data(state, output_fname);
         *error = SPLT_ERROR_CANNOT_OPEN_DEST_FILE;
@@ -1321,7 +1338,7 @@ double splt_ogg_split(const char *output_fname, splt_state *state,
     }
   }
 
-  ogg_stream_init(&stream_out, rand());
+  ogg_stream_init(&stream_out, splt_ogg_new_random_serial(oggstate));
 
   splt_ogg_set_tags_in_headers(oggstate, error);
   if (*error < 0)
@@ -1347,7 +1364,7 @@ end:
   {
     if (oggstate->out != stdout)
     {
-      if (fclose(oggstate->out) != 0)
+      if (splt_os_fclose(state, oggstate->out, *error >= 0) != 0)
       {
         splt_e_set_strerror_msg_with_data(state, output_fname);
         *error = SPLT_ERROR_CANNOT_CLOSE_FILE;
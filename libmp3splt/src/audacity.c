@@ -173,7 +173,7 @@ static char *splt_audacity_set_end(splt_audacity *sa, char *str)
 }
 
 static splt_audacity *splt_audacity_process_line(splt_state *state, char *line,
-    splt_audacity *previous_aud, int *append_begin_point, int *error)
+    splt_audacity *previous_aud, int *append_begin_point, char **error_position, int *error)
 {
   splt_audacity *aud = splt_audacity_new();
   if (!aud)
@@ -185,6 +185,7 @@ static splt_audacity *splt_audacity_process_line(splt_state *state, char *line,
   char *ptr = line;
 
   errno = 0;
+  *error_position = ptr;
   ptr = splt_audacity_set_begin(aud, ptr);
   if (ptr == NULL || *ptr == '\0') {
     *error = SPLT_INVALID_AUDACITY_FILE;
@@ -193,6 +194,7 @@ static splt_audacity *splt_audacity_process_line(splt_state *state, char *line,
   ptr++;
 
   errno = 0;
+  *error_position = ptr;
   ptr = splt_audacity_set_end(aud, ptr);
   if (ptr == NULL || *ptr == '\0')
   {
@@ -236,41 +238,40 @@ int splt_audacity_put_splitpoints(const char *file, splt_state *state, int *erro
   splt_c_put_info_message_to_client(state, 
       _(" reading informations from audacity labels file '%s' ...\n"), file);
 
-	FILE *file_input = NULL;
-
-	if (!(file_input = splt_io_fopen(file, "r")))
+  splt_io_lines lines;
+  int err = splt_io_lines_read_file(&lines, file);
+  if (err < 0)
   {
     splt_e_set_strerror_msg_with_data(state, file);
-    *error = SPLT_ERROR_CANNOT_OPEN_FILE;
+    *error = err;
     return tracks;
   }
 
-	if (fseek(file_input, 0, SEEK_SET) != 0)
-  {
-    splt_e_set_strerror_msg_with_data(state, file);
-    *error = SPLT_ERROR_SEEKING_FILE;
-    goto end;
-  }
-
   int append_begin_point = SPLT_TRUE;
-  int err = SPLT_OK;
 
   splt_audacity *aud = NULL;
 
   tracks = 0;
-  while ((line = splt_io_readline(file_input, error)) != NULL)
+  while ((line = splt_io_lines_next(&lines)) != NULL)
   {
-    if (*error < 0) { goto end; }
-
     if (splt_su_is_empty_line(line))
     {
-      free(line);
-      line = NULL;
       continue;
     }
 
-    aud = splt_audacity_process_line(state, line, previous_aud, &append_begin_point, &err);
-    if (err < 0) { goto end; }
+    char *error_position = NULL;
+    aud = splt_audacity_process_line(state, line, previous_aud, &append_begin_point,
+        &error_position, &err);
+    if (err < 0)
+    {
+      if (err == SPLT_INVALID_AUDACITY_FILE)
+      {
+        splt_e_set_error_data_at_position(state, file, lines.line_number,
+            (int) (error_position - line) + 1);
+      }
+      *error = err;
+      goto end;
+    }
 
     if (previous_aud)
     {
@@ -278,9 +279,6 @@ int splt_audacity_put_splitpoints(const char *file, splt_state *state, int *erro
     }
     previous_aud = aud;
 
-    free(line);
-    line = NULL;
-
     tracks++;
 	}
 
@@ -291,23 +289,12 @@ int splt_audacity_put_splitpoints(const char *file, splt_state *state, int *erro
   }
 
 end:
-  if (line)
-  {
-    free(line);
-    line = NULL;
-  }
-
   if (previous_aud)
   {
     splt_audacity_free(&previous_aud);
   }
 
-  if (fclose(file_input) != 0)
-  {
-    splt_e_set_strerror_msg_with_data(state, file);
-    *error = SPLT_ERROR_CANNOT_CLOSE_FILE;
-  }
-  file_input = NULL;
+  splt_io_lines_free(&lines);
 
 	return tracks;
 }
@@ -37,15 +37,16 @@
 
 #include "cddb.h"
 
-static void splt_cddb_process_line(char **l, cddb_utils *cdu, splt_state *state);
+static void splt_cddb_process_line(char *line, cddb_utils *cdu, splt_state *state);
+static int splt_cddb_count_tracks(const char *contents);
 static void splt_cddb_process_disc_length_line(const char *line_content, cddb_utils *cdu, splt_state *state);
 static void splt_cddb_convert_points(cddb_utils *cdu, splt_state *state);
 static void splt_cddb_process_offset_line(const char *line_content, cddb_utils *cdu, splt_state *state);
 static cddb_utils *splt_cddb_cdu_new(splt_state *state, int *error);
 static void splt_cddb_cdu_free(cddb_utils **cdu);
-static void splt_cddb_process_year_line(const char *line_content,
+static void splt_cddb_process_year_line(const char *year,
     cddb_utils *cdu, splt_state *state);
-static void splt_cddb_process_genre_line(char *line_content, cddb_utils *cdu, splt_state *state);
+static void splt_cddb_process_genre_line(char *genre, cddb_utils *cdu, splt_state *state);
 static void splt_cddb_process_dtitle_line(const char *line_content, cddb_utils *cdu, splt_state *state);
 static void splt_cddb_process_ttitle_line(const char *line_content, cddb_utils *cdu, splt_state *state);
 static void splt_cddb_process_id3g_line(const char *line_content, cddb_utils *cdu, splt_state *state);
@@ -67,39 +68,42 @@ int splt_cddb_put_splitpoints(const char *file, splt_state *state, int *error)
   *error = SPLT_CDDB_OK;
 
   int err = SPLT_OK;
-  FILE *file_input = NULL;
   char *line = NULL;
   int tracks = 0;
 
-  cddb_utils *cdu = splt_cddb_cdu_new(state, &err);
-  if (err < 0) { *error = err; return tracks; }
-  cdu->file = file;
-
-  if (!(file_input = splt_io_fopen(file, "r")))
+  splt_io_lines lines;
+  err = splt_io_lines_read_file(&lines, file);
+  if (err < 0)
   {
-    splt_cddb_cdu_free(&cdu);
     splt_e_set_strerror_msg_with_data(state, file);
-    *error = SPLT_ERROR_CANNOT_OPEN_FILE;
+    *error = err;
     return tracks;
   }
 
-  splt_tags *all_tags = splt_tu_new_tags(error);
+  splt_tags *all_tags = NULL;
+
+  cddb_utils *cdu = splt_cddb_cdu_new(state, &err);
+  if (err < 0) { *error = err; goto function_end; }
+  cdu->file = file;
+
+  all_tags = splt_tu_new_tags(error);
+  if (*error < 0) { goto function_end; }
 
-  if (fseek(file_input, 0, SEEK_SET) != 0)
+  int expected_tracks = splt_cddb_count_tracks(lines.buffer);
+  if (expected_tracks > 0)
   {
-    splt_e_set_strerror_msg_with_data(state, file);
-    *error = SPLT_ERROR_SEEKING_FILE;
-    goto function_end;
+    err = splt_tu_reserve_tags(state, expected_tracks);
+    if (err >= 0) { err = splt_sp_reserve_splitpoints(state, expected_tracks + 1); }
+    if (err < 0) { *error = err; goto function_end; }
   }
 
   err = splt_tu_set_tags_field(state, 0, SPLT_TAGS_GENRE, SPLT_UNDEFINED_GENRE);
   if (err < 0) { *error = err; goto function_end; }
  
-  while ((line = splt_io_readline(file_input, error)) != NULL)
+  while ((line = splt_io_lines_next(&lines)) != NULL)
   {
-    if (*error < 0) { goto function_end; }
-
-    splt_cddb_process_line(&line, cdu, state);
+    cdu->line_number = lines.line_number;
+    splt_cddb_process_line(line, cdu, state);
     tracks = cdu->tracks;
     if (cdu->error < 0) { *error = cdu->error; goto function_end; }
   }
@@ -114,19 +118,7 @@ int splt_cddb_put_splitpoints(const char *file, splt_state *state, int *error)
 function_end:
   splt_tu_free_one_tags(&all_tags);
   splt_cddb_cdu_free(&cdu);
-
-  if (line)
-  {
-    free(line);
-    line = NULL;
-  }
-
-  if (fclose(file_input) != 0)
-  {
-    splt_e_set_strerror_msg_with_data(state, file);
-    *error = SPLT_ERROR_CANNOT_CLOSE_FILE;
-  }
-  file_input = NULL;
+  splt_io_lines_free(&lines);
 
   if (*error >= 0)
   {
@@ -136,51 +128,100 @@ function_end:
   return tracks;
 }
 
-static void splt_cddb_process_line(char **l, cddb_utils *cdu, splt_state *state)
+//! Sets the error data to the cddb file and the position of \p ptr in the current line
+static void splt_cddb_set_error_position(splt_state *state, cddb_utils *cdu, const char *ptr)
+{
+  splt_e_set_error_data_at_position(state, cdu->file, cdu->line_number,
+      (int) (ptr - cdu->line) + 1);
+}
+
+static int splt_cddb_key_is(const char *key, size_t length, const char *expected_key)
 {
-  if (!l || !*l) { return; }
+  return length == strlen(expected_key) && strncmp(key, expected_key, length) == 0;
+}
 
-  char *line = *l;
+/*! Analyze a line from a cddb file
 
-  splt_su_line_to_unix(line);
-  splt_su_str_cut_last_char(line);
+Lines are either comments beginning with '#', holding the frame offsets and
+the disc length, or KEY=value lines selected by their key.
+*/
+static void splt_cddb_process_line(char *line, cddb_utils *cdu, splt_state *state)
+{
+  cdu->line = line;
 
   char *line_content = NULL;
-  if ((line_content = strstr(line, "Track frame offset")) != NULL)
+  char *equal_ptr = NULL;
+
+  if (*line == '#')
   {
-    cdu->read_offsets = SPLT_TRUE;
+    if (strstr(line, "Track frame offset") != NULL)
+    {
+      cdu->read_offsets = SPLT_TRUE;
+    }
+    else if ((line_content = strstr(line, "Disc length")) != NULL)
+    {
+      splt_cddb_process_disc_length_line(line_content, cdu, state);
+    }
+    else if (cdu->read_offsets)
+    {
+      splt_cddb_process_offset_line(line, cdu, state);
+    }
+
+    return;
   }
-  else if ((line_content = strstr(line, "Disc length")) != NULL)
+
+  if ((equal_ptr = strchr(line, '=')) == NULL)
   {
-    splt_cddb_process_disc_length_line(line_content, cdu, state);
+    if (cdu->read_offsets)
+    {
+      splt_cddb_process_offset_line(line, cdu, state);
+    }
+
+    return;
   }
-  else if (cdu->read_offsets)
+
+  size_t key_length = equal_ptr - line;
+  while (key_length > 0 && isspace((unsigned char) line[key_length - 1]))
   {
-    splt_cddb_process_offset_line(line, cdu, state);
+    key_length--;
   }
-  else if ((line_content = strstr(line, "YEAR")) != NULL)
+
+  if (splt_cddb_key_is(line, key_length, "DYEAR"))
   {
-    splt_cddb_process_year_line(line_content, cdu, state);
+    splt_cddb_process_year_line(equal_ptr + 1, cdu, state);
   }
-  else if ((line_content = strstr(line, "GENRE")) != NULL)
+  else if (splt_cddb_key_is(line, key_length, "DGENRE"))
   {
-    splt_cddb_process_genre_line(line_content, cdu, state);
+    splt_cddb_process_genre_line(equal_ptr + 1, cdu, state);
   }
-  else if ((line_content = strstr(line, "DTITLE")) != NULL)
+  else if (splt_cddb_key_is(line, key_length, "DTITLE"))
   {
-    splt_cddb_process_dtitle_line(line_content, cdu, state);
+    splt_cddb_process_dtitle_line(line, cdu, state);
   }
-  else if ((line_content = strstr(line, "TTITLE")) != NULL)
+  else if (key_length > 6 && strncmp(line, "TTITLE", 6) == 0 && isdigit((unsigned char) line[6]))
   {
-    splt_cddb_process_ttitle_line(line_content, cdu, state);
+    splt_cddb_process_ttitle_line(line, cdu, state);
   }
-  else if ((line_content = strstr(line, "ID3G")) != NULL)
+  else if (splt_cddb_key_is(line, key_length, "EXTD") &&
+      (line_content = strstr(equal_ptr, "ID3G")) != NULL)
   {
     splt_cddb_process_id3g_line(line_content, cdu, state);
   }
+}
+
+//! Counts the track titles of a cddb file to reserve tags and splitpoints ahead
+static int splt_cddb_count_tracks(const char *contents)
+{
+  int tracks = 0;
+
+  const char *ttitle = contents;
+  while ((ttitle = strstr(ttitle, "TTITLE")) != NULL)
+  {
+    tracks++;
+    ttitle += 6;
+  }
 
-  free(*l);
-  *l = NULL;
+  return tracks;
 }
 
 static void splt_cddb_process_id3g_line(const char *line_content, cddb_utils *cdu, splt_state *state)
@@ -204,14 +245,14 @@ static void splt_cddb_process_ttitle_line(const char *line_content, cddb_utils *
   char *equal_ptr = NULL;
   if ((equal_ptr = strchr(line_content, '=')) == NULL) 
   {
-    splt_e_set_error_data(state, cdu->file);
+    splt_cddb_set_error_position(state, cdu, line_content);
     cdu->error = SPLT_INVALID_CDDB_FILE;
     return;
   }
 
   if (equal_ptr == line_content)
   {
-    splt_e_set_error_data(state, cdu->file);
+    splt_cddb_set_error_position(state, cdu, line_content);
     cdu->error = SPLT_INVALID_CDDB_FILE;
     return;
   }
@@ -249,7 +290,7 @@ static void splt_cddb_process_dtitle_line(const char *line_content, cddb_utils *
   char *equal_ptr = NULL;
   if ((equal_ptr = strchr(line_content, '=')) == NULL) 
   {
-    splt_e_set_error_data(state, cdu->file);
+    splt_cddb_set_error_position(state, cdu, line_content);
     cdu->error = SPLT_INVALID_CDDB_FILE;
     return;
   }
@@ -278,9 +319,8 @@ static void splt_cddb_process_dtitle_line(const char *line_content, cddb_utils *
   }
 }
 
-static void splt_cddb_process_genre_line(char *line_content, cddb_utils *cdu, splt_state *state)
+static void splt_cddb_process_genre_line(char *genre, cddb_utils *cdu, splt_state *state)
 {
-  char *genre = line_content + 6;
   splt_su_cut_spaces_from_end(genre);
 
   if (*genre == '\0')
@@ -292,10 +332,10 @@ static void splt_cddb_process_genre_line(char *line_content, cddb_utils *cdu, sp
   if (err < 0) { cdu->error = err; }
 }
 
-static void splt_cddb_process_year_line(const char *line_content,
+static void splt_cddb_process_year_line(const char *year,
     cddb_utils *cdu, splt_state *state)
 {
-  int err = splt_tu_set_tags_field(state, 0, SPLT_TAGS_YEAR, line_content+5);
+  int err = splt_tu_set_tags_field(state, 0, SPLT_TAGS_YEAR, year);
   if (err < 0) { cdu->error = err; }
 }
 
@@ -368,6 +408,8 @@ static cddb_utils *splt_cddb_cdu_new(splt_state *state, int *error)
   cdu->tracks = 0;
   cdu->file = NULL;
   cdu->field_counter = 0;
+  cdu->line_number = 0;
+  cdu->line = NULL;
 
   return cdu;
 }
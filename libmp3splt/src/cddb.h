@@ -37,6 +37,10 @@ typedef struct {
   int tracks;
   const char *file;
   int field_counter;
+  //! Number of the line being processed, starting at 1
+  int line_number;
+  //! Line being processed, to compute the column of errors
+  const char *line;
 } cddb_utils;
 
 int splt_cddb_put_splitpoints (const char *file, splt_state *state, int *error);
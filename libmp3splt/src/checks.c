@@ -199,8 +199,18 @@ void splt_check_set_correct_options(splt_state *state)
 
   int split_mode = splt_o_get_int_option(state,SPLT_OPT_SPLIT_MODE);
 
+  //the live split reads the input as it arrives
+  if (split_mode == SPLT_OPTION_LIVE_MODE)
+  {
+    splt_o_set_int_option(state, SPLT_OPT_AUTO_ADJUST, SPLT_FALSE);
+    splt_o_set_int_option(state, SPLT_OPT_INPUT_NOT_SEEKABLE, SPLT_TRUE);
+    splt_o_set_int_option(state, SPLT_OPT_FRAME_MODE, SPLT_TRUE);
+  }
+
   if ((split_mode == SPLT_OPTION_SILENCE_MODE)
       || (split_mode == SPLT_OPTION_TRIM_SILENCE_MODE)
+      || ((split_mode == SPLT_OPTION_LIVE_MODE) &&
+        splt_o_get_int_option(state, SPLT_OPT_LIVE_SPLIT_ON_SILENCE))
       || splt_o_get_int_option(state,SPLT_OPT_AUTO_ADJUST))
   {
     splt_o_set_int_option(state, SPLT_OPT_FRAME_MODE, SPLT_OPT_FRAME_MODE);
@@ -38,12 +38,16 @@ All that is needed in order to be able to read and write cue files.
 
 static void splt_cue_cu_free(cue_utils **cu);
 
+//! Sets the error data to the cue file and the position of \p ptr in the current line
+static void splt_cue_set_error_position(splt_state *state, cue_utils *cu, const char *ptr)
+{
+  splt_e_set_error_data_at_position(state, cu->file, cu->line_number,
+      (int) (ptr - cu->line) + 1);
+}
+
 //! Process the rest of a cue line that begins with the word TRACK
 static void splt_cue_process_track_line(char *line_content, cue_utils *cu, splt_state *state)
 {
-  //skip the word TRACK
-  line_content += 5;
-
   if (cu->tracks == -1) 
   {
     cu->tracks = 0;
@@ -51,7 +55,7 @@ static void splt_cue_process_track_line(char *line_content, cue_utils *cu, splt_
 
   if (!cu->time_for_track) 
   {
-    splt_e_set_error_data(state, cu->file);
+    splt_cue_set_error_position(state, cu, line_content);
     cu->error = SPLT_INVALID_CUE_FILE;
   }
 
@@ -231,24 +235,22 @@ static void splt_cue_process_performer_line(char *line_content, cue_utils *cu, s
   }
 }
 
-//! Process the rest of a cue line that begins with the word INDEX
-static void splt_cue_process_index_line(int index_length, char *line_content, cue_utils *cu, splt_state *state)
+//! Process the time of a cue line beginning with INDEX 01
+static void splt_cue_process_index_line(char *time, cue_utils *cu, splt_state *state)
 {
   int err = SPLT_OK;
 
-  line_content += index_length;
-
   if (cu->tracks <= 0)
   {
     return;
   }
 
-  char *trimmed_line = splt_su_trim_spaces(line_content);
+  char *trimmed_line = splt_su_trim_spaces(time);
 
   long hundr_seconds = splt_co_convert_cue_line_to_hundreths(trimmed_line);
   if (hundr_seconds == -1)
   {
-    splt_e_set_error_data(state, cu->file);
+    splt_cue_set_error_position(state, cu, trimmed_line);
     cu->error = SPLT_INVALID_CUE_FILE;
     return;
   }
@@ -395,57 +397,98 @@ static void splt_cue_process_file_line(char *line_content, cue_utils *cu, splt_s
   if (err < 0) { cu->error = err; return; }
 }
 
-/*! Analyze a line from a cue file
+//! Returns the length of the word beginning at \p ptr
+static size_t splt_cue_word_length(const char *ptr)
+{
+  const char *end = ptr;
+  while (*end != '\0' && *end != ' ' && *end != '\t')
+  {
+    end++;
+  }
 
- */
-static void splt_cue_process_line(char **l, cue_utils *cu, splt_state *state)
+  return end - ptr;
+}
+
+static const char *splt_cue_skip_blanks(const char *ptr)
 {
-  if (!l || !*l) { return; }
+  while (*ptr == ' ' || *ptr == '\t')
+  {
+    ptr++;
+  }
 
-  char *line = *l;
+  return ptr;
+}
 
-  splt_su_line_to_unix(line);
-  splt_su_str_cut_last_char(line);
+static int splt_cue_word_is(const char *word, size_t length, const char *keyword)
+{
+  return length == strlen(keyword) && strncmp(word, keyword, length) == 0;
+}
+
+/*! Analyze a line from a cue file
+
+The first word of the line selects the command; the line is parsed in place
+in the buffer of the cue file.
+ */
+static void splt_cue_process_line(char *line, cue_utils *cu, splt_state *state)
+{
+  cu->line = line;
 
   splt_t_clean_one_split_data(state, cu->tracks);
 
-  char *line_content = NULL;
-  if (((line_content = strstr(line, "TRACK")) != NULL)
-      && (strstr(line, "AUDIO") != NULL))
+  char *command = (char *) splt_cue_skip_blanks(line);
+  size_t length = splt_cue_word_length(command);
+
+  if (splt_cue_word_is(command, length, "TRACK"))
   {
-    splt_cue_process_track_line(line_content, cu, state);
+    if (strstr(command + length, "AUDIO") != NULL)
+    {
+      splt_cue_process_track_line(command, cu, state);
+    }
   }
-  else if ((line_content = strstr(line, "REM")) != NULL)
+  else if (splt_cue_word_is(command, length, "REM"))
   {
-    splt_cue_process_rem_line(line_content, cu, state);
+    splt_cue_process_rem_line(command, cu, state);
   }
-  else if ((line_content = strstr(line, "TITLE")) != NULL)
+  else if (splt_cue_word_is(command, length, "TITLE"))
   {
-    splt_cue_process_title_line(line_content, cu, state);
+    splt_cue_process_title_line(command, cu, state);
   }
-  else if ((line_content = strstr(line, "PERFORMER")) != NULL)
+  else if (splt_cue_word_is(command, length, "PERFORMER"))
   {
-    splt_cue_process_performer_line(line_content, cu, state);
+    splt_cue_process_performer_line(command, cu, state);
   }
-  else if ((line_content = strstr(line, "INDEX 01")) != NULL)
+  else if (splt_cue_word_is(command, length, "INDEX"))
   {
-    splt_cue_process_index_line(9, line_content, cu, state);
+    //also support strange CUE files having INDEX 1
+    char *index_number = (char *) splt_cue_skip_blanks(command + length);
+    size_t index_number_length = splt_cue_word_length(index_number);
+    if (index_number_length <= 2 && isdigit((unsigned char) index_number[0]) &&
+        atoi(index_number) == 1)
+    {
+      splt_cue_process_index_line(index_number + index_number_length, cu, state);
+    }
   }
-  //also support strange CUE files having INDEX 1
-  else if ((line_content = strstr(line, "INDEX 1 ")) != NULL)
+  else if (splt_cue_word_is(command, length, "FILE"))
   {
-    splt_cue_process_index_line(8, line_content, cu, state);
+    splt_cue_process_file_line(command, cu, state);
   }
-  else if ((line_content = strstr(line, "FILE")) != NULL)
+}
+
+//! Counts the TRACK commands of a cue file to reserve tags and splitpoints ahead
+static int splt_cue_count_tracks(const char *contents)
+{
+  int tracks = 0;
+
+  const char *track = contents;
+  while ((track = strstr(track, "TRACK")) != NULL)
   {
-    splt_cue_process_file_line(line_content, cu, state);
+    tracks++;
+    track += 5;
   }
 
-  free(*l);
-  *l = NULL;
+  return tracks;
 }
 
-
 /* Malloc memory for and initialize a cue_utils structure
 
 \param error Contains the libmp3splt error number if any error
@@ -468,6 +511,8 @@ static cue_utils *splt_cue_cu_new(int *error)
   cu->error = SPLT_OK;
   cu->current_track_type = SPLT_SPLITPOINT;
   cu->current_name = NULL;
+  cu->line_number = 0;
+  cu->line = NULL;
 
   int err = SPLT_OK;
   cu->all_tags = splt_tu_new_tags(&err);
@@ -522,34 +567,34 @@ int splt_cue_put_splitpoints(const char *file, splt_state *state, int *error)
   *error = SPLT_CUE_OK;
 
   int err = SPLT_OK;
-  FILE *file_input = NULL;
   char *line = NULL;
   int tracks = -1;
 
-  cue_utils *cu = splt_cue_cu_new(&err);
-  
-  if (err < 0) { *error = err; return tracks; }
-  cu->file = file;
-
-  if (!(file_input = splt_io_fopen(file, "r")))
+  splt_io_lines lines;
+  err = splt_io_lines_read_file(&lines, file);
+  if (err < 0)
   {
     splt_e_set_strerror_msg_with_data(state, file);
-    *error = SPLT_ERROR_CANNOT_OPEN_FILE;
+    *error = err;
     return tracks;
   }
 
-  if (fseek(file_input, 0, SEEK_SET) != 0)
+  cue_utils *cu = splt_cue_cu_new(&err);
+  if (err < 0) { *error = err; goto function_end; }
+  cu->file = file;
+
+  int expected_tracks = splt_cue_count_tracks(lines.buffer);
+  if (expected_tracks > 0)
   {
-    splt_e_set_strerror_msg_with_data(state, file);
-    *error = SPLT_ERROR_SEEKING_FILE;
-    goto function_end;
+    err = splt_tu_reserve_tags(state, expected_tracks);
+    if (err >= 0) { err = splt_sp_reserve_splitpoints(state, expected_tracks + 1); }
+    if (err < 0) { *error = err; goto function_end; }
   }
 
-  while ((line = splt_io_readline(file_input, error)) != NULL)
+  while ((line = splt_io_lines_next(&lines)) != NULL)
   {
-    if (*error < 0) { goto function_end; }
-
-    splt_cue_process_line(&line, cu, state);
+    cu->line_number = lines.line_number;
+    splt_cue_process_line(line, cu, state);
     tracks = cu->tracks;
     if (cu->error < 0) { *error = cu->error; goto function_end; }
   }
@@ -573,19 +618,7 @@ int splt_cue_put_splitpoints(const char *file, splt_state *state, int *error)
 
 function_end:
   splt_cue_cu_free(&cu);
-
-  if (line)
-  {
-    free(line);
-    line = NULL;
-  }
-
-  if (fclose(file_input) != 0)
-  {
-    splt_e_set_strerror_msg_with_data(state, file);
-    *error = SPLT_ERROR_CANNOT_CLOSE_FILE;
-  }
-  file_input = NULL;
+  splt_io_lines_free(&lines);
 
   if (*error >= 0)
   {
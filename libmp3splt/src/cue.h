@@ -52,6 +52,11 @@ typedef struct {
   int current_track_type;
   char *current_name;
 
+  //! Number of the line being processed, starting at 1
+  int line_number;
+  //! Line being processed, to compute the column of errors
+  const char *line;
+
   splt_tags *all_tags;
 } cue_utils;
 
@@ -95,6 +95,37 @@ void splt_e_set_error_data_from_splitpoint(splt_state *state, long splitpoint)
   splt_e_set_error_data(state, str_value);
 }
 
+//! Sets the error data to 'file:line:column'
+void splt_e_set_error_data_at_position(splt_state *state, const char *file,
+    int line, int column)
+{
+  if (file == NULL)
+  {
+    splt_e_set_error_data(state, file);
+    return;
+  }
+
+  char position[64] = { '\0' };
+  snprintf(position, 64, ":%d:%d", line, column);
+
+  char *error_data = NULL;
+  int err = splt_su_append_str(&error_data, file, position, NULL);
+  if (err < 0)
+  {
+    splt_e_set_error_data(state, file);
+  }
+  else
+  {
+    splt_e_set_error_data(state, error_data);
+  }
+
+  if (error_data)
+  {
+    free(error_data);
+    error_data = NULL;
+  }
+}
+
 void splt_e_set_error_data_from_splitpoints(splt_state *state, long splitpoint1,
     long splitpoint2)
 {
@@ -113,15 +144,22 @@ void splt_e_clean_strerror_msg(splt_state *state)
   splt_e_set_strerr_msg(state, NULL);
 }
 
+//strerror and hstrerror may use a static buffer shared by all threads
 void splt_e_set_strerror_msg(splt_state *state)
 {
-  splt_e_set_strerr_msg(state, strerror(errno));
+  int current_errno = errno;
+  splt_lk_lock(SPLT_LOCK_LIBC);
+  splt_e_set_strerr_msg(state, strerror(current_errno));
+  splt_lk_unlock(SPLT_LOCK_LIBC);
 }
 
 void splt_e_set_strherror_msg(splt_state *state)
 {
 #ifndef __WIN32__
-  splt_e_set_strerr_msg(state, hstrerror(h_errno));
+  int current_h_errno = h_errno;
+  splt_lk_lock(SPLT_LOCK_LIBC);
+  splt_e_set_strerr_msg(state, hstrerror(current_h_errno));
+  splt_lk_unlock(SPLT_LOCK_LIBC);
 #else
   splt_e_set_strerr_msg(state, _("Network error"));
 #endif
@@ -195,6 +233,8 @@ char *splt_e_strerror(splt_state *state, splt_code error_code)
       return splt_su_get_formatted_message(state, _(" freedb file downloaded"));
     case SPLT_FREEDB_OK:
       return splt_su_get_formatted_message(state, _(" freedb search processed"));
+    case SPLT_FREEDB_LOCAL_INDEX_OK:
+      return splt_su_get_formatted_message(state, _(" freedb local index built"));
       //
     case SPLT_FREEDB_ERROR_INITIALISE_SOCKET:
       return splt_su_get_formatted_message(state,
@@ -262,6 +302,15 @@ char *splt_e_strerror(splt_state *state, splt_code error_code)
     case SPLT_ERROR_INTERNAL_SHEET_TYPE_NOT_SUPPORTED:
       return splt_su_get_formatted_message(state,
           _(" internal sheet error: internal sheet type not supported"));
+    case SPLT_FREEDB_ERROR_INVALID_LOCAL_INDEX:
+      return splt_su_get_formatted_message(state,
+          _(" freedb error: invalid local index '%s'"), state->err.error_data);
+    case SPLT_FREEDB_ERROR_TIMEOUT:
+      return splt_su_get_formatted_message(state,
+          _(" freedb error: timeout while waiting for host '%s'"), state->err.error_data);
+    case SPLT_ERROR_OUTPUT_SINK_NOT_SUPPORTED:
+      return splt_su_get_formatted_message(state,
+          _(" error: output sinks are not supported on this platform"));
 
       //
     case SPLT_DEWRAP_OK:
@@ -295,6 +344,8 @@ char *splt_e_strerror(splt_state *state, splt_code error_code)
       return splt_su_get_formatted_message(state, _(" silence split ok"));
     case SPLT_TRIM_SILENCE_OK:
       return splt_su_get_formatted_message(state, _(" trim using silence split ok"));
+    case SPLT_LIVE_SPLIT_OK:
+      return splt_su_get_formatted_message(state, _(" live split ok"));
     case SPLT_SPLITPOINT_BIGGER_THAN_LENGTH:
       return splt_su_get_formatted_message(state,
           _(" file split, splitpoints bigger than length"));
@@ -37,6 +37,8 @@ void splt_e_free_errors(splt_state *state);
 void splt_e_set_error_data(splt_state *state, const char *error_data);
 void splt_e_set_error_data_from_splitpoints(splt_state *state, long point1, long point2);
 void splt_e_set_error_data_from_splitpoint(splt_state *state, long splitpoint);
+void splt_e_set_error_data_at_position(splt_state *state, const char *file,
+    int line, int column);
 
 void splt_e_set_strerror_msg(splt_state *state);
 void splt_e_set_strherror_msg(splt_state *state);
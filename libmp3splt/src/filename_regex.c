@@ -45,6 +45,114 @@ static int splt_fr_get_int_pattern(pcre *re, const char *filename,
     int *ovector, int rc, char *key);
 static void splt_fr_set_char_field_on_tags_and_convert(splt_tags *tags,
     int tags_field, char *pattern, int format, int replace_underscores, int *error);
+static splt_tags *splt_fr_parse_path(splt_state *state, const char *path,
+    const char *regex, const char *default_comment, const char *default_genre, int *error);
+
+//! Regular expression compiled for the input filenames, kept on the state
+struct _splt_fr_regex {
+  char *regex;
+  pcre *re;
+  pcre_extra *extra;
+};
+
+void splt_fr_free_compiled_regex(splt_state *state)
+{
+  struct _splt_fr_regex *compiled = state->compiled_fname_regex;
+  if (!compiled)
+  {
+    return;
+  }
+
+  if (compiled->extra)
+  {
+#ifdef PCRE_STUDY_JIT_COMPILE
+    pcre_free_study(compiled->extra);
+#else
+    pcre_free(compiled->extra);
+#endif
+    compiled->extra = NULL;
+  }
+
+  if (compiled->re)
+  {
+    pcre_free(compiled->re);
+    compiled->re = NULL;
+  }
+
+  if (compiled->regex)
+  {
+    free(compiled->regex);
+    compiled->regex = NULL;
+  }
+
+  free(compiled);
+  state->compiled_fname_regex = NULL;
+}
+
+/*! \brief Returns the compiled \c regex, compiling and studying it only if it changed
+
+The compiled regex is cached on the state and keyed by the regex string, so
+that parsing many filenames with the same regex compiles it once.
+*/
+static struct _splt_fr_regex *splt_fr_get_compiled_regex(splt_state *state,
+    const char *regex, int *error)
+{
+  struct _splt_fr_regex *compiled = state->compiled_fname_regex;
+  if (compiled && strcmp(compiled->regex, regex) == 0)
+  {
+    return compiled;
+  }
+
+  splt_fr_free_compiled_regex(state);
+
+  const char *errorbits;
+  int erroroffset;
+
+  pcre *re = pcre_compile(regex, PCRE_CASELESS | PCRE_UTF8, &errorbits, &erroroffset, NULL);
+  if (!re)
+  {
+    *error = SPLT_INVALID_REGEX;
+    char *message = splt_su_get_formatted_message(state, "@%u: %s",
+        erroroffset, errorbits);
+    splt_e_set_error_data(state, message);
+    return NULL;
+  }
+
+  compiled = malloc(sizeof(struct _splt_fr_regex));
+  if (!compiled)
+  {
+    pcre_free(re);
+    *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+    return NULL;
+  }
+  compiled->re = re;
+  compiled->extra = NULL;
+  compiled->regex = NULL;
+
+  int err = splt_su_copy(regex, &compiled->regex);
+  if (err < 0)
+  {
+    pcre_free(re);
+    free(compiled);
+    *error = err;
+    return NULL;
+  }
+
+  //studying is only an optimisation: the regex is still used if it fails
+  int study_options = 0;
+#ifdef PCRE_STUDY_JIT_COMPILE
+  study_options = PCRE_STUDY_JIT_COMPILE;
+#endif
+  compiled->extra = pcre_study(re, study_options, &errorbits);
+  if (errorbits)
+  {
+    splt_d_print_debug(state, "regex study failed = _%s_\n", errorbits);
+  }
+
+  state->compiled_fname_regex = compiled;
+
+  return compiled;
+}
 
 /*!
 
@@ -58,7 +166,15 @@ splt_tags *splt_fr_parse_from_state(splt_state *state, int *error)
   char *default_comment = splt_t_get_default_comment_tag(state);
   char *default_genre = splt_t_get_default_genre_tag(state);
 
-  char *filename = splt_su_get_fname_without_path_and_extension(filename_to_split, error);
+  return splt_fr_parse_path(state, filename_to_split, regex,
+      default_comment, default_genre, error);
+}
+
+//! Parses the filename of \c path, without its directory and its extension
+static splt_tags *splt_fr_parse_path(splt_state *state, const char *path,
+    const char *regex, const char *default_comment, const char *default_genre, int *error)
+{
+  char *filename = splt_su_get_fname_without_path_and_extension(path, error);
   if (*error < 0)
   {
     return NULL;
@@ -75,12 +191,56 @@ splt_tags *splt_fr_parse_from_state(splt_state *state, int *error)
   return tags;
 }
 
+/*! \brief Parses the tags of several input files with the regex of the state
+
+\c tags[i] is set to the tags of \c filenames[i], or to NULL if the
+regular expression does not match that file. On other errors, all the
+tags are freed and set to NULL.
+
+\return #SPLT_REGEX_OK or the error
+*/
+int splt_fr_parse_filenames(splt_state *state, const char * const *filenames,
+    int number_of_filenames, splt_tags **tags)
+{
+  char *regex = splt_t_get_input_filename_regex(state);
+  char *default_comment = splt_t_get_default_comment_tag(state);
+  char *default_genre = splt_t_get_default_genre_tag(state);
+
+  int i = 0;
+  for (i = 0; i < number_of_filenames; i++)
+  {
+    tags[i] = NULL;
+  }
+
+  for (i = 0; i < number_of_filenames; i++)
+  {
+    int error = SPLT_OK;
+    tags[i] = splt_fr_parse_path(state, filenames[i], regex,
+        default_comment, default_genre, &error);
+
+    if (error == SPLT_REGEX_NO_MATCH)
+    {
+      continue;
+    }
+
+    if (error < 0)
+    {
+      int j = 0;
+      for (j = 0; j <= i; j++)
+      {
+        splt_tu_free_one_tags(&tags[j]);
+      }
+
+      return error;
+    }
+  }
+
+  return SPLT_REGEX_OK;
+}
+
 splt_tags *splt_fr_parse(splt_state *state, const char *filename, const char *regex,
     const char *default_comment, const char *default_genre, int *error)
 {
-  const char *errorbits;
-  int erroroffset;
-
   splt_d_print_debug(state, "filename for regex = _%s_\n", filename);
   splt_d_print_debug(state, "regex = _%s_\n", regex);
 
@@ -91,31 +251,26 @@ splt_tags *splt_fr_parse(splt_state *state, const char *filename, const char *re
     return NULL;
   }
 
-  pcre *re = pcre_compile(regex, PCRE_CASELESS | PCRE_UTF8, &errorbits, &erroroffset, NULL);
-  if (!re)
+  struct _splt_fr_regex *compiled = splt_fr_get_compiled_regex(state, regex, error);
+  if (!compiled)
   {
-    *error = SPLT_INVALID_REGEX;
-    char *message = splt_su_get_formatted_message(state, "@%u: %s",
-        erroroffset, errorbits);
-    splt_e_set_error_data(state, message);
     return NULL;
   }
+  pcre *re = compiled->re;
 
   int ovector[90] = {0,};
   const size_t ovsize = sizeof(ovector)/sizeof(*ovector);
 
-  int rc = pcre_exec(re, NULL, filename, strlen(filename), 0, 0, ovector, ovsize);
+  int rc = pcre_exec(re, compiled->extra, filename, strlen(filename), 0, 0, ovector, ovsize);
   if (rc == PCRE_ERROR_NOMATCH)
   {
     *error = SPLT_REGEX_NO_MATCH;
-    pcre_free(re);
     return NULL;
   }
 
   splt_tags *tags = splt_tu_new_tags(error);
   if (*error < 0)
   {
-    pcre_free(re);
     return NULL;
   }
   splt_tu_reset_tags(tags);
@@ -204,14 +359,11 @@ splt_tags *splt_fr_parse(splt_state *state, const char *filename, const char *re
     splt_tu_set_field_on_tags(tags, SPLT_TAGS_GENRE, default_genre);
   }
 
-  pcre_free(re);
-
   *error = SPLT_REGEX_OK;
 
   return tags;
 
 error:
-  pcre_free(re);
   splt_tu_free_one_tags(&tags); 
   return NULL;
 }
@@ -36,6 +36,9 @@
 splt_tags *splt_fr_parse_from_state(splt_state *state, int *error);
 splt_tags *splt_fr_parse(splt_state *state, const char *filename, const char *regex,
     const char *default_comment, const char *default_genre, int *error);
+int splt_fr_parse_filenames(splt_state *state, const char * const *filenames,
+    int number_of_filenames, splt_tags **tags);
+void splt_fr_free_compiled_regex(splt_state *state);
 
 #define SPLT_FILENAME_REGEX_H
 
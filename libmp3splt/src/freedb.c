@@ -51,7 +51,17 @@ that is meant to be used directly are all in mp3splt.c.
 #define DONT_SKIP_LINES 0
 #define SKIP_ONE_LINE 1
 
-char *get_cgi_path_and_cut_server(int type, const char *search_server)
+static int splt_freedb_http_request(splt_state *state, const char *server, int port,
+    const char *message, int number_of_lines_to_skip, splt_freedb_cache_recorder *recorder);
+static splt_socket_handler *splt_freedb_connect(splt_state *state, const char *server,
+    int port, int *error);
+static int splt_freedb_cddb_read(splt_state *state, const char *server, int port,
+    const char *message, splt_freedb_cache_recorder *recorder);
+static char *splt_freedb_get_cache_key(const char *server, int port, const char *message,
+    int *error);
+
+//! Returns the cgi path of the search server and cuts it from the server copy
+char *get_cgi_path_and_cut_server(int type, const char *search_server, char *server)
 {
   char *cgi_path = NULL;
 
@@ -61,10 +71,11 @@ char *get_cgi_path_and_cut_server(int type, const char *search_server)
     return cgi_path;
   }
 
-  if (type == SPLT_FREEDB_SEARCH_TYPE_CDDB_CGI ||
-      type == SPLT_FREEDB_GET_FILE_TYPE_CDDB_CGI)
+  if (server != NULL &&
+      (type == SPLT_FREEDB_SEARCH_TYPE_CDDB_CGI ||
+       type == SPLT_FREEDB_GET_FILE_TYPE_CDDB_CGI))
   {
-    char *path = strchr(search_server, '/');
+    char *path = strchr(server, '/');
     if (path)
     {
       splt_su_copy(path, &cgi_path);
@@ -148,9 +159,10 @@ end:
 \param search_string The string that is to be searched for
 \param error The error code this action returns in
 \param search_type the type of the search. Can be set to
-SPLT_FREEDB_SEARCH_TYPE_CDDB_CGI
+SPLT_FREEDB_SEARCH_TYPE_CDDB_CGI or SPLT_FREEDB_SEARCH_TYPE_LOCAL_INDEX
 \param search_server The URL of the search server or NULL to select
-the default which currently means freedb2.org
+the default which currently means freedb2.org; the index file for
+SPLT_FREEDB_SEARCH_TYPE_LOCAL_INDEX
 \param port The port on the server. -1 means default (Which should be
 80). 
 */
@@ -158,37 +170,49 @@ int splt_freedb_process_search(splt_state *state, char *search,
     int search_type, const char search_server[256],
     int port_number)
 {
+  if (search_type == SPLT_FREEDB_SEARCH_TYPE_LOCAL_INDEX)
+  {
+    return splt_fi_search(state, search, search_server);
+  }
+
   int error = SPLT_FREEDB_OK;
   int err = SPLT_OK;
   char *message = NULL;
+  char *key = NULL;
 
-  splt_socket_handler *sh = splt_sm_socket_handler_new(&error);
-  if (error < 0) { return error; }
-
-  char *cgi_path = get_cgi_path_and_cut_server(search_type, search_server);
   char *server = splt_freedb_get_server(search_server);
+  char *cgi_path = get_cgi_path_and_cut_server(search_type, search_server, server);
   int port = splt_freedb_get_port(port_number);
 
-  splt_sm_connect(sh, server, port, state);
-  if (sh->error < 0) { error = sh->error; goto end; }
+  splt_fu_freedb_free_search(state);
+  err = splt_fu_freedb_init_search(state);
+  if (err < 0) { error = err; goto end; }
 
   if (search_type == SPLT_FREEDB_SEARCH_TYPE_CDDB_CGI)
   {
     splt_su_replace_all_char(search, ' ', '+');
     err = splt_su_append_str(&message, 
         "GET ", cgi_path, "?cmd=cddb+album+", search, SPLT_FREEDB_HELLO_PROTO, NULL);
-    if (err < 0) { error = err; goto disconnect; }
+    if (err < 0) { error = err; goto end; }
 
-    splt_sm_send_http_message(sh, message, state);
-    if (sh->error < 0) { error = sh->error; goto disconnect; }
+    key = splt_freedb_get_cache_key(server, port, message, &err);
+    if (err < 0) { error = err; goto end; }
 
-    splt_fu_freedb_free_search(state);
-    err = splt_fu_freedb_init_search(state);
-    if (err < 0) { error = err; goto disconnect; }
+    if (!splt_fc_replay(state, key, splt_freedb_search_result_processor, state))
+    {
+      splt_freedb_cache_recorder recorder;
+      splt_fc_recorder_init(&recorder, splt_freedb_search_result_processor, state);
+
+      err = splt_freedb_http_request(state, server, port, message, SKIP_ONE_LINE, &recorder);
+      if (err >= 0 && splt_fu_freedb_get_found_cds(state) > 0)
+      {
+        splt_fc_store(state, key, &recorder);
+      }
 
-    splt_sm_receive_and_process_without_headers(sh, state, 
-        splt_freedb_search_result_processor, state, SKIP_ONE_LINE);
-    if (sh->error < 0) { error = sh->error; goto disconnect; }
+      splt_fc_recorder_free(&recorder);
+
+      if (err < 0) { error = err; goto end; }
+    }
   }
   else if (search_type == SPLT_FREEDB_SEARCH_TYPE_CDDB)
   {
@@ -210,13 +234,7 @@ int splt_freedb_process_search(splt_state *state, char *search,
     error = SPLT_FREEDB_MAX_CD_REACHED;
   }
 
-disconnect:
-  splt_sm_close(sh, state); 
-  if (sh->error < 0) { error = sh->error; goto end; }
-
 end:
-  splt_sm_socket_handler_free(&sh);
-
   if (cgi_path)
   {
     free(cgi_path);
@@ -232,6 +250,11 @@ end:
     free(message);
     message = NULL;
   }
+  if (key)
+  {
+    free(key);
+    key = NULL;
+  }
 
   return error;
 }
@@ -289,7 +312,8 @@ static int splt_freedb_process_get_file(const char *line,
     return SPLT_FALSE;
   }
 
-  int err = splt_su_append_str(&get_file->file, line, "\n", NULL);
+  int err = splt_su_builder_append_str(&get_file->file, line);
+  if (err >= 0) { err = splt_su_builder_append(&get_file->file, "\n", 1); }
   if (err < 0)
   {
     get_file->err = err;
@@ -320,81 +344,84 @@ uses
 char *splt_freedb_get_file(splt_state *state, int disc_id, int *error,
     int get_type, const char cddb_get_server[256], int port_number)
 {
+  if (get_type == SPLT_FREEDB_GET_FILE_TYPE_LOCAL_INDEX)
+  {
+    return splt_fi_get_file(state, disc_id, error, cddb_get_server);
+  }
+
   int err = SPLT_FREEDB_FILE_OK;
   *error = err;
   char *message = NULL;
-
-  splt_socket_handler *sh = splt_sm_socket_handler_new(&err);
-  if (err < 0) { *error = err; return NULL; }
+  char *key = NULL;
 
   splt_get_file *get_file = malloc(sizeof(splt_get_file));
   if (!get_file) { *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY; return NULL; }
 
   get_file->err = SPLT_FREEDB_FILE_OK;
-  get_file->file = NULL;
+  splt_su_builder_init(&get_file->file);
   get_file->stop_on_dot = SPLT_FALSE;
 
-  char *cgi_path = get_cgi_path_and_cut_server(get_type, cddb_get_server);
   char *server = splt_freedb_get_server(cddb_get_server);
+  char *cgi_path = get_cgi_path_and_cut_server(get_type, cddb_get_server, server);
   int port = splt_freedb_get_port(port_number);
 
   const char *cd_category = splt_fu_freedb_get_disc_category(state, disc_id);
   const char *cd_id = splt_fu_freedb_get_disc_id(state, disc_id);
 
-  splt_sm_connect(sh, server, port, state);
-  if (sh->error < 0) { *error = sh->error; goto end; }
-
   if (get_type == SPLT_FREEDB_GET_FILE_TYPE_CDDB_CGI)
   {
     message = splt_su_get_formatted_message(state, 
         SPLT_FREEDB_CDDB_CGI_GET_FILE, cgi_path, cd_category, cd_id, NULL);
-
-    splt_sm_send_http_message(sh, message, state);
-    if (sh->error < 0) { *error = sh->error; goto disconnect; }
-
-    splt_sm_receive_and_process_without_headers(sh, state,
-        splt_freedb_process_get_file, get_file, DONT_SKIP_LINES);
-    if (get_file->err < 0) { *error = get_file->err; goto disconnect; }
-    if (sh->error < 0) { *error = sh->error; goto disconnect; }
   }
   else if (get_type == SPLT_FREEDB_GET_FILE_TYPE_CDDB)
   {
     if (splt_pr_has_proxy(state))
     {
       *error = SPLT_FREEDB_ERROR_PROXY_NOT_SUPPORTED;
-      goto disconnect;
+      goto end;
     }
 
     get_file->stop_on_dot = SPLT_TRUE;
 
-    splt_sm_send_http_message(sh, SPLT_FREEDB_HELLO, state);
-    if (sh->error < 0) { *error = sh->error; goto disconnect; }
-
-    splt_sm_receive_and_process(sh, state, splt_freedb_process_hello_response, &err);
-    if (err < 0) { *error = err; goto disconnect; }
-    if (sh->error < 0) { *error = sh->error; goto disconnect; }
-
     message = splt_su_get_formatted_message(state, SPLT_FREEDB_GET_FILE,
         cd_category, cd_id, NULL);
+  }
+  else
+  {
+    goto end;
+  }
+
+  if (message == NULL) { *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY; goto end; }
+
+  key = splt_freedb_get_cache_key(server, port, message, &err);
+  if (err < 0) { *error = err; goto end; }
 
-    splt_sm_send_http_message(sh, message, state);
-    if (sh->error < 0) { *error = sh->error; goto disconnect; }
+  if (!splt_fc_replay(state, key, splt_freedb_process_get_file, get_file))
+  {
+    splt_freedb_cache_recorder recorder;
+    splt_fc_recorder_init(&recorder, splt_freedb_process_get_file, get_file);
 
-    splt_sm_receive_and_process(sh, state, splt_freedb_process_get_file, get_file);
-    if (get_file->err < 0) { *error = get_file->err; goto disconnect; }
-    if (sh->error < 0) { *error = sh->error; goto disconnect; }
+    if (get_type == SPLT_FREEDB_GET_FILE_TYPE_CDDB_CGI)
+    {
+      err = splt_freedb_http_request(state, server, port, message, DONT_SKIP_LINES, &recorder);
+    }
+    else
+    {
+      err = splt_freedb_cddb_read(state, server, port, message, &recorder);
+    }
 
-    splt_sm_send_http_message(sh, "quit", state);
-    if (sh->error < 0) { *error = sh->error; goto disconnect; }
+    if (err >= 0 && get_file->err >= 0)
+    {
+      splt_fc_store(state, key, &recorder);
+    }
+
+    splt_fc_recorder_free(&recorder);
   }
 
-disconnect:
-  splt_sm_close(sh, state); 
-  if (sh->error < 0) { *error = sh->error; goto end; }
+  if (get_file->err < 0) { *error = get_file->err; }
+  else if (err < 0) { *error = err; }
 
 end:
-  splt_sm_socket_handler_free(&sh);
-
   if (cgi_path)
   {
     free(cgi_path);
@@ -410,10 +437,15 @@ end:
     free(message);
     message = NULL;
   }
+  if (key)
+  {
+    free(key);
+    key = NULL;
+  }
 
   if (get_file)
   {
-    char *file = get_file->file;
+    char *file = splt_su_builder_release(&get_file->file);
 
     free(get_file);
     get_file = NULL;
@@ -424,3 +456,136 @@ end:
   return NULL;
 }
 
+/*! Sends a http request to the server and processes its response
+
+The connection kept alive by the previous request to the same server is
+reused; this connection is kept in its turn if the server allows it.
+*/
+static int splt_freedb_http_request(splt_state *state, const char *server, int port,
+    const char *message, int number_of_lines_to_skip, splt_freedb_cache_recorder *recorder)
+{
+  int error = SPLT_OK;
+  splt_socket_handler *sh = splt_freedb_connect(state, server, port, &error);
+  if (error < 0) { return error; }
+
+  splt_sm_send_http_message(sh, message, state);
+  if (sh->error >= 0)
+  {
+    splt_sm_receive_and_process_without_headers(sh, state,
+        splt_fc_recorder_functor, recorder, number_of_lines_to_skip);
+  }
+
+  if (sh->error >= 0 && sh->keep_alive)
+  {
+    state->fdb.connection = sh;
+    return SPLT_OK;
+  }
+
+  error = sh->error;
+
+  splt_sm_close(sh, state);
+  if (sh->error < 0) { error = sh->error; }
+
+  splt_sm_socket_handler_free(&sh);
+
+  return error;
+}
+
+//! Returns the kept-alive connection to the server or a new connection
+static splt_socket_handler *splt_freedb_connect(splt_state *state, const char *server,
+    int port, int *error)
+{
+  splt_socket_handler *sh = state->fdb.connection;
+  state->fdb.connection = NULL;
+
+  if (sh != NULL)
+  {
+    if (splt_sm_can_be_reused(sh, server, port, state))
+    {
+      splt_d_print_debug(state, "\nReusing the connection to %s:%d\n", server, port);
+      return sh;
+    }
+
+    splt_sm_close(sh, state);
+    splt_sm_socket_handler_free(&sh);
+  }
+
+  sh = splt_sm_socket_handler_new(error);
+  if (*error < 0) { return NULL; }
+
+  splt_sm_connect(sh, server, port, state);
+  if (sh->error < 0)
+  {
+    *error = sh->error;
+    splt_sm_socket_handler_free(&sh);
+    return NULL;
+  }
+
+  return sh;
+}
+
+void splt_freedb_close_connection(splt_state *state)
+{
+  splt_socket_handler *sh = state->fdb.connection;
+  if (sh == NULL)
+  {
+    return;
+  }
+
+  splt_sm_close(sh, state);
+  splt_sm_socket_handler_free(&sh);
+  state->fdb.connection = NULL;
+}
+
+//! Reads a file with the cddb protocol, on its own connection
+static int splt_freedb_cddb_read(splt_state *state, const char *server, int port,
+    const char *message, splt_freedb_cache_recorder *recorder)
+{
+  int error = SPLT_OK;
+  int err = SPLT_OK;
+
+  splt_socket_handler *sh = splt_sm_socket_handler_new(&error);
+  if (error < 0) { return error; }
+
+  splt_sm_connect(sh, server, port, state);
+  if (sh->error < 0) { error = sh->error; goto end; }
+
+  splt_sm_send_http_message(sh, SPLT_FREEDB_HELLO, state);
+  if (sh->error < 0) { error = sh->error; goto disconnect; }
+
+  splt_sm_receive_and_process(sh, state, splt_freedb_process_hello_response, &err);
+  if (err < 0) { error = err; goto disconnect; }
+  if (sh->error < 0) { error = sh->error; goto disconnect; }
+
+  splt_sm_send_http_message(sh, message, state);
+  if (sh->error < 0) { error = sh->error; goto disconnect; }
+
+  splt_sm_receive_and_process(sh, state, splt_fc_recorder_functor, recorder);
+  if (sh->error < 0) { error = sh->error; goto disconnect; }
+
+  splt_sm_send_http_message(sh, "quit", state);
+  if (sh->error < 0) { error = sh->error; goto disconnect; }
+
+disconnect:
+  splt_sm_close(sh, state); 
+  if (sh->error < 0) { error = sh->error; goto end; }
+
+end:
+  splt_sm_socket_handler_free(&sh);
+
+  return error;
+}
+
+//! The server, the port and the request identify a cached response
+static char *splt_freedb_get_cache_key(const char *server, int port, const char *message,
+    int *error)
+{
+  char port_as_string[16];
+  snprintf(port_as_string, sizeof(port_as_string), "%d", port);
+
+  char *key = NULL;
+  int err = splt_su_append_str(&key, server, ":", port_as_string, " ", message, NULL);
+  if (err < 0) { *error = err; }
+
+  return key;
+}
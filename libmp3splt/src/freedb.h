@@ -33,7 +33,7 @@
 
 typedef struct {
   int err;
-  char *file;
+  splt_string_builder file;
   int stop_on_dot;
 } splt_get_file;
 
@@ -42,6 +42,7 @@ int splt_freedb_process_search(splt_state *state, char *search,
     int port);
 char *splt_freedb_get_file(splt_state *state, int i, int *error,
     int get_type, const char *cddb_get_server, int port);
+void splt_freedb_close_connection(splt_state *state);
 
 //global freedb, ports and buffersize
 #define SPLT_FREEDB_BUFFERSIZE 8192
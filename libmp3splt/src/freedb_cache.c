@@ -0,0 +1,427 @@
+/**********************************************************
+ *
+ * libmp3splt -- library based on mp3splt,
+ *               for mp3/ogg splitting without decoding
+ *
+ * Copyright (c) 2002-2005 M. Trotta - <mtrotta@users.sourceforge.net>
+ * Copyright (c) 2005-2014 Alexandru Munteanu - m@ioalex.net
+ *
+ * http://mp3splt.sourceforge.net
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ *********************************************************/
+
+/*! \file
+
+Cache of the freedb server responses
+
+The lines of a response are recorded while the response is processed and
+kept in memory, keyed by the server, the port and the request. With a
+cache directory, each response is also written in its own file named
+after a hash of the key; the first line of the file is the key itself.
+*/
+
+#include <string.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "splt.h"
+
+struct _splt_freedb_cache {
+  char *keys[SPLT_FREEDB_CACHE_MAX_ENTRIES];
+  char *responses[SPLT_FREEDB_CACHE_MAX_ENTRIES];
+  int number_of_entries;
+  //! entry replaced by the next response when the cache is full
+  int oldest_entry;
+};
+
+static const char *splt_fc_get_from_memory(splt_state *state, const char *key);
+static int splt_fc_put_in_memory(splt_state *state, const char *key, const char *response);
+static char *splt_fc_get_from_disk(splt_state *state, const char *key);
+static void splt_fc_put_on_disk(splt_state *state, const char *key, const char *response);
+static char *splt_fc_get_filename(splt_state *state, const char *key);
+static char *splt_fc_get_temporary_filename(const char *filename);
+static int splt_fc_replay_response(const char *response,
+    int (*functor)(const char *line, int line_number, void *user_data),
+    void *user_data);
+
+/*! Processes the cached response of the request, if any
+
+\param key The server, the port and the request
+\return #SPLT_TRUE if the response was found and given to the functor
+*/
+int splt_fc_replay(splt_state *state, const char *key,
+    int (*functor)(const char *line, int line_number, void *user_data),
+    void *user_data)
+{
+  const char *response = splt_fc_get_from_memory(state, key);
+  if (response != NULL)
+  {
+    splt_d_print_debug(state, "\nFreedb response of _%s_ found in memory\n", key);
+    return splt_fc_replay_response(response, functor, user_data);
+  }
+
+  char *response_from_disk = splt_fc_get_from_disk(state, key);
+  if (response_from_disk == NULL)
+  {
+    return SPLT_FALSE;
+  }
+
+  splt_d_print_debug(state, "\nFreedb response of _%s_ found on disk\n", key);
+
+  splt_fc_put_in_memory(state, key, response_from_disk);
+  int replayed = splt_fc_replay_response(response_from_disk, functor, user_data);
+
+  free(response_from_disk);
+
+  return replayed;
+}
+
+static int splt_fc_replay_response(const char *response,
+    int (*functor)(const char *line, int line_number, void *user_data),
+    void *user_data)
+{
+  //lines are cut in place
+  char *lines = NULL;
+  if (splt_su_copy(response, &lines) < 0)
+  {
+    return SPLT_FALSE;
+  }
+
+  int line_number = 1;
+  char *line = lines;
+  char *line_end = NULL;
+  while ((line_end = strchr(line, '\n')) != NULL)
+  {
+    *line_end = '\0';
+    if (!functor(line, line_number, user_data))
+    {
+      break;
+    }
+
+    line_number++;
+    line = line_end + 1;
+  }
+
+  free(lines);
+
+  return SPLT_TRUE;
+}
+
+void splt_fc_recorder_init(splt_freedb_cache_recorder *recorder,
+    int (*functor)(const char *line, int line_number, void *user_data),
+    void *user_data)
+{
+  recorder->functor = functor;
+  recorder->user_data = user_data;
+  splt_su_builder_init(&recorder->response);
+  recorder->error = SPLT_OK;
+}
+
+//! Records the line before giving it to the decorated functor
+int splt_fc_recorder_functor(const char *line, int line_number, void *user_data)
+{
+  splt_freedb_cache_recorder *recorder = (splt_freedb_cache_recorder *) user_data;
+
+  if (recorder->error >= 0)
+  {
+    int err = splt_su_builder_append_str(&recorder->response, line);
+    if (err >= 0) { err = splt_su_builder_append(&recorder->response, "\n", 1); }
+    if (err < 0) { recorder->error = err; }
+  }
+
+  return recorder->functor(line, line_number, recorder->user_data);
+}
+
+void splt_fc_recorder_free(splt_freedb_cache_recorder *recorder)
+{
+  splt_su_builder_free(&recorder->response);
+}
+
+/*! Caches the recorded response of the request
+
+Caching is an optimisation: failures only skip it.
+*/
+int splt_fc_store(splt_state *state, const char *key, splt_freedb_cache_recorder *recorder)
+{
+  if (recorder->error < 0)
+  {
+    return recorder->error;
+  }
+
+  const char *response = recorder->response.str ? recorder->response.str : "";
+
+  int err = splt_fc_put_in_memory(state, key, response);
+  splt_fc_put_on_disk(state, key, response);
+
+  return err;
+}
+
+int splt_fc_set_directory(splt_state *state, const char *cache_directory)
+{
+  if (state->fdb.cache_directory)
+  {
+    free(state->fdb.cache_directory);
+    state->fdb.cache_directory = NULL;
+  }
+
+  if (cache_directory == NULL || cache_directory[0] == '\0')
+  {
+    return SPLT_OK;
+  }
+
+  return splt_su_copy(cache_directory, &state->fdb.cache_directory);
+}
+
+void splt_fc_free(splt_state *state)
+{
+  splt_freedb_cache *cache = state->fdb.cache;
+  if (cache)
+  {
+    int i = 0;
+    for (i = 0;i < cache->number_of_entries;i++)
+    {
+      free(cache->keys[i]);
+      free(cache->responses[i]);
+    }
+
+    free(cache);
+    state->fdb.cache = NULL;
+  }
+
+  splt_fc_set_directory(state, NULL);
+}
+
+static const char *splt_fc_get_from_memory(splt_state *state, const char *key)
+{
+  splt_freedb_cache *cache = state->fdb.cache;
+  if (cache == NULL)
+  {
+    return NULL;
+  }
+
+  int i = 0;
+  for (i = 0;i < cache->number_of_entries;i++)
+  {
+    if (strcmp(cache->keys[i], key) == 0)
+    {
+      return cache->responses[i];
+    }
+  }
+
+  return NULL;
+}
+
+static int splt_fc_put_in_memory(splt_state *state, const char *key, const char *response)
+{
+  if (splt_fc_get_from_memory(state, key) != NULL)
+  {
+    return SPLT_OK;
+  }
+
+  if (state->fdb.cache == NULL)
+  {
+    state->fdb.cache = malloc(sizeof(splt_freedb_cache));
+    if (state->fdb.cache == NULL)
+    {
+      return SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+    }
+    state->fdb.cache->number_of_entries = 0;
+    state->fdb.cache->oldest_entry = 0;
+  }
+
+  splt_freedb_cache *cache = state->fdb.cache;
+
+  char *key_copy = NULL;
+  char *response_copy = NULL;
+  int err = splt_su_copy(key, &key_copy);
+  if (err >= 0) { err = splt_su_copy(response, &response_copy); }
+  if (err < 0)
+  {
+    if (key_copy) { free(key_copy); }
+    return err;
+  }
+
+  int entry = cache->number_of_entries;
+  if (entry == SPLT_FREEDB_CACHE_MAX_ENTRIES)
+  {
+    entry = cache->oldest_entry;
+    cache->oldest_entry = (cache->oldest_entry + 1) % SPLT_FREEDB_CACHE_MAX_ENTRIES;
+
+    free(cache->keys[entry]);
+    free(cache->responses[entry]);
+  }
+  else
+  {
+    cache->number_of_entries++;
+  }
+
+  cache->keys[entry] = key_copy;
+  cache->responses[entry] = response_copy;
+
+  return SPLT_OK;
+}
+
+static char *splt_fc_get_from_disk(splt_state *state, const char *key)
+{
+  char *filename = splt_fc_get_filename(state, key);
+  if (filename == NULL)
+  {
+    return NULL;
+  }
+
+  char *response = NULL;
+
+  splt_io_lines lines;
+  if (splt_io_lines_read_file(&lines, filename) < 0)
+  {
+    goto end;
+  }
+
+  //files of other keys having the same hash are ignored
+  const char *cached_key = splt_io_lines_next(&lines);
+  if (cached_key != NULL && strcmp(cached_key, key) == 0)
+  {
+    splt_su_copy(lines.next_line ? lines.next_line : "", &response);
+  }
+
+  splt_io_lines_free(&lines);
+
+end:
+  free(filename);
+
+  return response;
+}
+
+static void splt_fc_put_on_disk(splt_state *state, const char *key, const char *response)
+{
+  //the key is the first line of the file
+  if (strchr(key, '\n') != NULL || strchr(key, '\r') != NULL)
+  {
+    return;
+  }
+
+  char *filename = splt_fc_get_filename(state, key);
+  if (filename == NULL)
+  {
+    return;
+  }
+
+  //written aside and renamed so that readers never get a partial response
+  char *temporary_filename = splt_fc_get_temporary_filename(filename);
+  if (temporary_filename == NULL)
+  {
+    goto end;
+  }
+
+  FILE *file = splt_io_fopen(temporary_filename, "wb");
+  if (file == NULL)
+  {
+    splt_d_print_debug(state, "\nCannot write the freedb cache file _%s_\n", temporary_filename);
+    goto end;
+  }
+
+  int write_failed = fputs(key, file) == EOF || fputc('\n', file) == EOF ||
+    fputs(response, file) == EOF;
+  if (fclose(file) != 0 || write_failed)
+  {
+    remove(temporary_filename);
+    goto end;
+  }
+
+  if (rename(temporary_filename, filename) != 0)
+  {
+#ifdef __WIN32__
+    //rename does not replace existing files on windows
+    remove(filename);
+    if (rename(temporary_filename, filename) != 0)
+    {
+      remove(temporary_filename);
+    }
+#else
+    remove(temporary_filename);
+#endif
+  }
+
+end:
+  if (temporary_filename)
+  {
+    free(temporary_filename);
+  }
+  free(filename);
+}
+
+/*! Returns a temporary file name next to \p filename
+
+The name holds the process id and a number taken once in the process, so that
+the states and the processes sharing a cache directory never write the same
+temporary file.
+*/
+static char *splt_fc_get_temporary_filename(const char *filename)
+{
+  static unsigned long number_of_temporary_files = 0;
+
+  splt_lk_lock(SPLT_LOCK_FREEDB_CACHE);
+  unsigned long temporary_file_number = number_of_temporary_files++;
+  splt_lk_unlock(SPLT_LOCK_FREEDB_CACHE);
+
+  char suffix[64];
+  snprintf(suffix, sizeof(suffix), ".%ld.%lu.tmp", (long) getpid(), temporary_file_number);
+
+  char *temporary_filename = NULL;
+  if (splt_su_append_str(&temporary_filename, filename, suffix, NULL) < 0)
+  {
+    return NULL;
+  }
+
+  return temporary_filename;
+}
+
+//! Returns the cache file of the key, or NULL without cache directory
+static char *splt_fc_get_filename(splt_state *state, const char *key)
+{
+  if (state->fdb.cache_directory == NULL)
+  {
+    return NULL;
+  }
+
+  //64 bits FNV-1a hash of the key
+  unsigned long long key_hash = 0xcbf29ce484222325ULL;
+  const unsigned char *byte = NULL;
+  for (byte = (const unsigned char *) key;*byte != '\0';byte++)
+  {
+    key_hash ^= *byte;
+    key_hash *= 0x100000001b3ULL;
+  }
+
+  char hash[17];
+  snprintf(hash, sizeof(hash), "%08lx%08lx",
+      (unsigned long) (key_hash >> 32), (unsigned long) (key_hash & 0xffffffffUL));
+
+  char dirchar[2] = { SPLT_DIRCHAR, '\0' };
+  char *filename = NULL;
+  int err = splt_su_append_str(&filename, state->fdb.cache_directory, dirchar,
+      "freedb_", hash, ".cache", NULL);
+  if (err < 0) { return NULL; }
+
+  return filename;
+}
+
@@ -0,0 +1,65 @@
+/**********************************************************
+ *
+ * libmp3splt -- library based on mp3splt,
+ *               for mp3/ogg splitting without decoding
+ *
+ * Copyright (c) 2002-2005 M. Trotta - <mtrotta@users.sourceforge.net>
+ * Copyright (c) 2005-2014 Alexandru Munteanu - m@ioalex.net
+ *
+ * http://mp3splt.sourceforge.net
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ *********************************************************/
+
+#ifndef SPLT_FREEDB_CACHE_H
+
+//! responses kept in memory; the oldest one is replaced when full
+#define SPLT_FREEDB_CACHE_MAX_ENTRIES 64
+
+typedef struct _splt_freedb_cache splt_freedb_cache;
+
+//! Decorates the processor of a server response to record its lines
+typedef struct {
+  int (*functor)(const char *line, int line_number, void *user_data);
+  void *user_data;
+  splt_string_builder response;
+  int error;
+} splt_freedb_cache_recorder;
+
+int splt_fc_replay(splt_state *state, const char *key,
+    int (*functor)(const char *line, int line_number, void *user_data),
+    void *user_data);
+
+void splt_fc_recorder_init(splt_freedb_cache_recorder *recorder,
+    int (*functor)(const char *line, int line_number, void *user_data),
+    void *user_data);
+int splt_fc_recorder_functor(const char *line, int line_number, void *user_data);
+void splt_fc_recorder_free(splt_freedb_cache_recorder *recorder);
+
+int splt_fc_store(splt_state *state, const char *key, splt_freedb_cache_recorder *recorder);
+
+int splt_fc_set_directory(splt_state *state, const char *cache_directory);
+void splt_fc_free(splt_state *state);
+
+#define SPLT_FREEDB_CACHE_H
+
+#endif
+
@@ -0,0 +1,1215 @@
+/**********************************************************
+ *
+ * libmp3splt -- library based on mp3splt,
+ *               for mp3/ogg splitting without decoding
+ *
+ * Copyright (c) 2002-2005 M. Trotta - <mtrotta@users.sourceforge.net>
+ * Copyright (c) 2005-2014 Alexandru Munteanu - m@ioalex.net
+ *
+ * http://mp3splt.sourceforge.net
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ *********************************************************/
+
+/*! \file
+
+Local freedb database: index of a freedb dump and searches in this index
+
+A freedb dump directory has one sub-directory per category, holding one
+xmcd file per disc. mp3splt_freedb_build_local_index() indexes the disc
+ids and the words of the "artist / album" titles of these files. The
+index file is read at once by the first search and kept in the state
+while the index file does not change.
+
+Index file layout, all numbers being 32 bits little endian:
+ - header: #SPLT_FREEDB_INDEX_MAGIC, number of discs, of disc ids, of
+   terms, of postings and length of the strings
+ - discs: first disc id and offsets in the strings of the category, of
+   the file name and of the title
+ - disc ids: disc id and disc, sorted by disc id
+ - terms: offset in the strings of the term, first posting and number of
+   postings, sorted by term
+ - postings: discs having the term, in increasing order
+ - strings: NUL terminated strings; the first one is the dump directory
+*/
+
+#include <string.h>
+#include <ctype.h>
+#include <stdarg.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <dirent.h>
+
+#include "splt.h"
+
+struct _splt_freedb_index {
+  char *filename;
+  off_t size;
+  time_t modification_time;
+
+  unsigned char *bytes;
+  unsigned long number_of_discs;
+  unsigned long number_of_discids;
+  unsigned long number_of_terms;
+  unsigned long number_of_postings;
+  unsigned long strings_length;
+
+  const unsigned char *discs;
+  const unsigned char *discids;
+  const unsigned char *terms;
+  const unsigned char *postings;
+  const char *strings;
+};
+
+//! Data gathered while indexing a freedb dump
+typedef struct {
+  splt_state *state;
+  const char *category;
+  unsigned long category_offset;
+
+  splt_string_builder strings;
+  //! discs records of the index
+  splt_string_builder discs;
+  unsigned long number_of_discs;
+  //! disc ids records of the index
+  splt_string_builder discids;
+  unsigned long number_of_discids;
+
+  //! words found, as consecutive NUL terminated strings
+  splt_string_builder terms;
+  //! offset in terms of each word, 4 bytes each
+  splt_string_builder term_offsets;
+  unsigned long number_of_terms;
+  //! open addressing table of the word numbers + 1
+  unsigned long *terms_table;
+  unsigned long terms_table_size;
+
+  //! word number and disc of each word of each title
+  splt_string_builder postings;
+  unsigned long number_of_postings;
+} splt_fi_builder;
+
+typedef struct {
+  const char *term;
+  unsigned long number;
+} splt_fi_sorted_term;
+
+static void splt_fi_pack(unsigned char *bytes, unsigned long value)
+{
+  bytes[0] = value & 0xff;
+  bytes[1] = (value >> 8) & 0xff;
+  bytes[2] = (value >> 16) & 0xff;
+  bytes[3] = (value >> 24) & 0xff;
+}
+
+static unsigned long splt_fi_unpack(const unsigned char *bytes)
+{
+  return (unsigned long) bytes[0] | ((unsigned long) bytes[1] << 8) |
+    ((unsigned long) bytes[2] << 16) | ((unsigned long) bytes[3] << 24);
+}
+
+static int splt_fi_append_numbers(splt_string_builder *sb, int count, ...)
+{
+  unsigned char bytes[4];
+  int err = SPLT_OK;
+
+  va_list ap;
+  va_start(ap, count);
+
+  int i = 0;
+  for (i = 0;i < count;i++)
+  {
+    splt_fi_pack(bytes, va_arg(ap, unsigned long));
+    err = splt_su_builder_append(sb, (const char *) bytes, 4);
+    if (err < 0) { break; }
+  }
+
+  va_end(ap);
+
+  return err;
+}
+
+static int splt_fi_append_string(splt_string_builder *sb, const char *str,
+    unsigned long *offset)
+{
+  *offset = (unsigned long) sb->length;
+  return splt_su_builder_append(sb, str, strlen(str) + 1);
+}
+
+static int splt_fi_is_term_character(unsigned char c)
+{
+  return c >= 0x80 || isalnum(c);
+}
+
+/*! Copies the next word of \p str in \p term, in lower case
+
+Words are made of ASCII letters and digits and of the bytes of UTF-8
+characters.
+
+\return The end of the word in \p str or NULL if no word remains
+*/
+static const char *splt_fi_next_term(const char *str, char *term)
+{
+  const unsigned char *ptr = (const unsigned char *) str;
+  while (*ptr != '\0' && !splt_fi_is_term_character(*ptr))
+  {
+    ptr++;
+  }
+
+  if (*ptr == '\0')
+  {
+    return NULL;
+  }
+
+  int length = 0;
+  while (splt_fi_is_term_character(*ptr))
+  {
+    if (length < SPLT_FREEDB_INDEX_MAX_TERM_LENGTH)
+    {
+      term[length++] = tolower(*ptr);
+    }
+    ptr++;
+  }
+  term[length] = '\0';
+
+  return (const char *) ptr;
+}
+
+static unsigned long splt_fi_hash(const char *str)
+{
+  unsigned long hash = 2166136261UL;
+  const unsigned char *ptr = (const unsigned char *) str;
+  while (*ptr != '\0')
+  {
+    hash = ((hash ^ *ptr) * 16777619UL) & 0xffffffffUL;
+    ptr++;
+  }
+
+  return hash;
+}
+
+static const char *splt_fi_builder_term(splt_fi_builder *builder, unsigned long number)
+{
+  const unsigned char *offset = (const unsigned char *) builder->term_offsets.str + number * 4;
+  return builder->terms.str + splt_fi_unpack(offset);
+}
+
+static int splt_fi_grow_terms_table(splt_fi_builder *builder)
+{
+  unsigned long new_size = builder->terms_table_size ? builder->terms_table_size * 2 : 4096;
+  unsigned long *new_table = calloc(new_size, sizeof(unsigned long));
+  if (new_table == NULL)
+  {
+    return SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+  }
+
+  unsigned long i = 0;
+  for (i = 0;i < builder->number_of_terms;i++)
+  {
+    unsigned long position = splt_fi_hash(splt_fi_builder_term(builder, i)) & (new_size - 1);
+    while (new_table[position] != 0)
+    {
+      position = (position + 1) & (new_size - 1);
+    }
+    new_table[position] = i + 1;
+  }
+
+  free(builder->terms_table);
+  builder->terms_table = new_table;
+  builder->terms_table_size = new_size;
+
+  return SPLT_OK;
+}
+
+//! Finds or adds \p term and returns its number
+static long splt_fi_builder_term_number(splt_fi_builder *builder, const char *term)
+{
+  int err = SPLT_OK;
+
+  //the table is kept at most half full
+  if ((builder->number_of_terms + 1) * 2 > builder->terms_table_size)
+  {
+    err = splt_fi_grow_terms_table(builder);
+    if (err < 0) { return err; }
+  }
+
+  unsigned long mask = builder->terms_table_size - 1;
+  unsigned long position = splt_fi_hash(term) & mask;
+  while (builder->terms_table[position] != 0)
+  {
+    unsigned long number = builder->terms_table[position] - 1;
+    if (strcmp(splt_fi_builder_term(builder, number), term) == 0)
+    {
+      return (long) number;
+    }
+    position = (position + 1) & mask;
+  }
+
+  unsigned long offset = 0;
+  err = splt_fi_append_string(&builder->terms, term, &offset);
+  if (err < 0) { return err; }
+  err = splt_fi_append_numbers(&builder->term_offsets, 1, offset);
+  if (err < 0) { return err; }
+
+  builder->terms_table[position] = builder->number_of_terms + 1;
+  return (long) builder->number_of_terms++;
+}
+
+static int splt_fi_builder_add_terms(splt_fi_builder *builder, const char *title,
+    unsigned long disc)
+{
+  char term[SPLT_FREEDB_INDEX_MAX_TERM_LENGTH + 1];
+
+  const char *ptr = title;
+  while ((ptr = splt_fi_next_term(ptr, term)) != NULL)
+  {
+    //single characters are too frequent to be useful
+    if (term[1] == '\0') { continue; }
+
+    long number = splt_fi_builder_term_number(builder, term);
+    if (number < 0) { return (int) number; }
+
+    int err = splt_fi_append_numbers(&builder->postings, 2, (unsigned long) number, disc);
+    if (err < 0) { return err; }
+    builder->number_of_postings++;
+  }
+
+  return SPLT_OK;
+}
+
+static int splt_fi_is_discid(const char *str, size_t length)
+{
+  if (length != SPLT_DISCIDLEN)
+  {
+    return SPLT_FALSE;
+  }
+
+  size_t i = 0;
+  for (i = 0;i < length;i++)
+  {
+    if (!isxdigit((unsigned char) str[i]))
+    {
+      return SPLT_FALSE;
+    }
+  }
+
+  return SPLT_TRUE;
+}
+
+//! Appends the disc ids of the comma separated \p discids to the disc ids of \p disc
+static int splt_fi_builder_add_discids(splt_fi_builder *builder, const char *discids,
+    unsigned long disc, unsigned long *first_discid, int *number_of_discids)
+{
+  const char *ptr = discids;
+  while (*ptr != '\0')
+  {
+    ptr = splt_su_skip_spaces(ptr);
+    size_t length = strcspn(ptr, ", \t");
+
+    if (splt_fi_is_discid(ptr, length))
+    {
+      unsigned long discid = strtoul(ptr, NULL, 16);
+      if (*number_of_discids == 0)
+      {
+        *first_discid = discid;
+      }
+      (*number_of_discids)++;
+
+      int err = splt_fi_append_numbers(&builder->discids, 2, discid, disc);
+      if (err < 0) { return err; }
+      builder->number_of_discids++;
+    }
+
+    ptr += length;
+    while (*ptr == ',' || *ptr == ' ' || *ptr == '\t') { ptr++; }
+  }
+
+  return SPLT_OK;
+}
+
+//! Indexes the xmcd file \p fname of the current category
+static int splt_fi_builder_add_file(splt_fi_builder *builder, const char *path,
+    const char *fname)
+{
+  splt_io_lines lines;
+  splt_string_builder title;
+  splt_su_builder_init(&title);
+
+  int err = splt_io_lines_read_file(&lines, path);
+  if (err < 0)
+  {
+    splt_e_set_strerror_msg_with_data(builder->state, path);
+    return err;
+  }
+
+  unsigned long disc = builder->number_of_discs;
+  unsigned long first_discid = 0;
+  int number_of_discids = 0;
+
+  char *line = NULL;
+  while ((line = splt_io_lines_next(&lines)) != NULL)
+  {
+    if (strncmp(line, "DISCID=", 7) == 0)
+    {
+      err = splt_fi_builder_add_discids(builder, line + 7, disc, &first_discid,
+          &number_of_discids);
+    }
+    else if (strncmp(line, "DTITLE=", 7) == 0)
+    {
+      //long titles continue on the next DTITLE lines
+      err = splt_su_builder_append_str(&title, line + 7);
+    }
+    else if (strncmp(line, "TTITLE", 6) == 0)
+    {
+      break;
+    }
+
+    if (err < 0) { goto end; }
+  }
+
+  //the file name is the disc id when the DISCID line is missing
+  if (number_of_discids == 0)
+  {
+    err = splt_fi_builder_add_discids(builder, fname, disc, &first_discid, &number_of_discids);
+    if (err < 0) { goto end; }
+    if (number_of_discids == 0) { goto end; }
+  }
+
+  unsigned long fname_offset = 0;
+  err = splt_fi_append_string(&builder->strings, fname, &fname_offset);
+  if (err < 0) { goto end; }
+
+  unsigned long title_offset = 0;
+  err = splt_fi_append_string(&builder->strings, title.str ? title.str : "", &title_offset);
+  if (err < 0) { goto end; }
+
+  err = splt_fi_append_numbers(&builder->discs, 4, first_discid, builder->category_offset,
+      fname_offset, title_offset);
+  if (err < 0) { goto end; }
+  builder->number_of_discs++;
+
+  if (title.str)
+  {
+    err = splt_fi_builder_add_terms(builder, title.str, disc);
+  }
+
+end:
+  splt_su_builder_free(&title);
+  splt_io_lines_free(&lines);
+
+  return err;
+}
+
+typedef int (*splt_fi_entry_processor)(splt_fi_builder *builder, const char *path,
+    const char *fname);
+
+//! Calls \p processor for the entries of \p directory, in alphabetical order
+static int splt_fi_scan_directory(splt_fi_builder *builder, const char *directory,
+    splt_fi_entry_processor processor)
+{
+  int err = SPLT_OK;
+
+#ifdef __WIN32__
+  struct _wdirent **files = NULL;
+  int number_of_files = wscandir(directory, &files, NULL, walphasort);
+#else
+  struct dirent **files = NULL;
+  int number_of_files = scandir(directory, &files, NULL, alphasort);
+#endif
+
+  if (number_of_files < 0 || files == NULL)
+  {
+    splt_e_set_strerror_msg_with_data(builder->state, directory);
+    return SPLT_ERROR_CANNOT_OPEN_FILE;
+  }
+
+  int i = 0;
+  for (i = 0;i < number_of_files;i++)
+  {
+#ifdef __WIN32__
+    char *fname = splt_w32_utf16_to_utf8(files[i]->d_name);
+#else
+    char *fname = files[i]->d_name;
+#endif
+
+    if (err >= 0 && fname != NULL && fname[0] != '.')
+    {
+      char *path = NULL;
+      char dirchar[2] = { SPLT_DIRCHAR, '\0' };
+      err = splt_su_append_str(&path, directory, dirchar, fname, NULL);
+      if (err >= 0)
+      {
+        err = processor(builder, path, fname);
+      }
+
+      if (path)
+      {
+        free(path);
+        path = NULL;
+      }
+    }
+
+#ifdef __WIN32__
+    if (fname)
+    {
+      free(fname);
+    }
+#endif
+    free(files[i]);
+    files[i] = NULL;
+  }
+
+  free(files);
+
+  return err;
+}
+
+static int splt_fi_builder_add_category_file(splt_fi_builder *builder, const char *path,
+    const char *fname)
+{
+  if (!splt_io_check_if_file(NULL, path))
+  {
+    return SPLT_OK;
+  }
+
+  return splt_fi_builder_add_file(builder, path, fname);
+}
+
+static int splt_fi_builder_add_category(splt_fi_builder *builder, const char *path,
+    const char *fname)
+{
+  if (!splt_io_check_if_directory(path))
+  {
+    return SPLT_OK;
+  }
+
+  builder->category = fname;
+  int err = splt_fi_append_string(&builder->strings, fname, &builder->category_offset);
+  if (err < 0) { return err; }
+
+  return splt_fi_scan_directory(builder, path, splt_fi_builder_add_category_file);
+}
+
+static int splt_fi_compare_terms(const void *first, const void *second)
+{
+  return strcmp(((const splt_fi_sorted_term *) first)->term,
+      ((const splt_fi_sorted_term *) second)->term);
+}
+
+//! Compares two pairs of numbers of 4 bytes
+static int splt_fi_compare_pairs(const void *first, const void *second)
+{
+  const unsigned char *first_pair = (const unsigned char *) first;
+  const unsigned char *second_pair = (const unsigned char *) second;
+
+  int i = 0;
+  for (i = 0;i < 2;i++)
+  {
+    unsigned long first_number = splt_fi_unpack(first_pair + i * 4);
+    unsigned long second_number = splt_fi_unpack(second_pair + i * 4);
+    if (first_number != second_number)
+    {
+      return first_number < second_number ? -1 : 1;
+    }
+  }
+
+  return 0;
+}
+
+/*! Sorts the terms and their postings, and appends the terms to the strings
+
+\param terms Is filled with the terms records of the index
+\param postings Is filled with the postings of the index
+*/
+static int splt_fi_builder_sort_terms(splt_fi_builder *builder, splt_string_builder *terms,
+    splt_string_builder *postings, unsigned long *number_of_postings)
+{
+  int err = SPLT_OK;
+  unsigned long *ranks = NULL;
+  *number_of_postings = 0;
+
+  if (builder->number_of_terms == 0)
+  {
+    return SPLT_OK;
+  }
+
+  splt_fi_sorted_term *sorted_terms =
+    malloc(sizeof(splt_fi_sorted_term) * builder->number_of_terms);
+  ranks = malloc(sizeof(unsigned long) * builder->number_of_terms);
+  if (sorted_terms == NULL || ranks == NULL)
+  {
+    err = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+    goto end;
+  }
+
+  unsigned long i = 0;
+  for (i = 0;i < builder->number_of_terms;i++)
+  {
+    sorted_terms[i].term = splt_fi_builder_term(builder, i);
+    sorted_terms[i].number = i;
+  }
+  qsort(sorted_terms, builder->number_of_terms, sizeof(splt_fi_sorted_term),
+      splt_fi_compare_terms);
+
+  for (i = 0;i < builder->number_of_terms;i++)
+  {
+    ranks[sorted_terms[i].number] = i;
+  }
+
+  //postings of the same term become consecutive, sorted by disc
+  unsigned char *pairs = (unsigned char *) builder->postings.str;
+  for (i = 0;i < builder->number_of_postings;i++)
+  {
+    splt_fi_pack(pairs + i * 8, ranks[splt_fi_unpack(pairs + i * 8)]);
+  }
+  qsort(pairs, builder->number_of_postings, 8, splt_fi_compare_pairs);
+
+  unsigned long posting = 0;
+  for (i = 0;i < builder->number_of_terms;i++)
+  {
+    unsigned long first_posting = *number_of_postings;
+    unsigned long previous_disc = ULONG_MAX;
+
+    while (posting < builder->number_of_postings && splt_fi_unpack(pairs + posting * 8) == i)
+    {
+      unsigned long disc = splt_fi_unpack(pairs + posting * 8 + 4);
+      if (disc != previous_disc)
+      {
+        err = splt_fi_append_numbers(postings, 1, disc);
+        if (err < 0) { goto end; }
+        (*number_of_postings)++;
+        previous_disc = disc;
+      }
+      posting++;
+    }
+
+    unsigned long term_offset = 0;
+    err = splt_fi_append_string(&builder->strings, sorted_terms[i].term, &term_offset);
+    if (err < 0) { goto end; }
+
+    err = splt_fi_append_numbers(terms, 3, term_offset, first_posting,
+        *number_of_postings - first_posting);
+    if (err < 0) { goto end; }
+  }
+
+end:
+  if (sorted_terms)
+  {
+    free(sorted_terms);
+  }
+  if (ranks)
+  {
+    free(ranks);
+  }
+
+  return err;
+}
+
+static int splt_fi_builder_write(splt_fi_builder *builder, const char *index_file)
+{
+  splt_string_builder header;
+  splt_string_builder terms;
+  splt_string_builder postings;
+  splt_su_builder_init(&header);
+  splt_su_builder_init(&terms);
+  splt_su_builder_init(&postings);
+
+  unsigned long number_of_postings = 0;
+  int err = splt_fi_builder_sort_terms(builder, &terms, &postings, &number_of_postings);
+  if (err < 0) { goto end; }
+
+  if (builder->number_of_discids > 0)
+  {
+    qsort(builder->discids.str, builder->number_of_discids, SPLT_FREEDB_INDEX_DISCID_LENGTH,
+        splt_fi_compare_pairs);
+  }
+
+  err = splt_su_builder_append(&header, SPLT_FREEDB_INDEX_MAGIC,
+      SPLT_FREEDB_INDEX_MAGIC_LENGTH);
+  if (err < 0) { goto end; }
+  err = splt_fi_append_numbers(&header, 5, builder->number_of_discs,
+      builder->number_of_discids, builder->number_of_terms, number_of_postings,
+      (unsigned long) builder->strings.length);
+  if (err < 0) { goto end; }
+
+  FILE *output = splt_io_fopen(index_file, "wb");
+  if (output == NULL)
+  {
+    splt_e_set_strerror_msg_with_data(builder->state, index_file);
+    err = SPLT_ERROR_CANNOT_OPEN_DEST_FILE;
+    goto end;
+  }
+
+  splt_string_builder *sections[] = { &header, &builder->discs, &builder->discids,
+    &terms, &postings, &builder->strings };
+  int i = 0;
+  for (i = 0;i < 6;i++)
+  {
+    if (sections[i]->length > 0 &&
+        fwrite(sections[i]->str, 1, sections[i]->length, output) != sections[i]->length)
+    {
+      splt_e_set_strerror_msg_with_data(builder->state, index_file);
+      err = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
+      break;
+    }
+  }
+
+  if (fclose(output) != 0 && err >= 0)
+  {
+    splt_e_set_strerror_msg_with_data(builder->state, index_file);
+    err = SPLT_ERROR_CANNOT_CLOSE_FILE;
+  }
+
+end:
+  splt_su_builder_free(&header);
+  splt_su_builder_free(&terms);
+  splt_su_builder_free(&postings);
+
+  return err;
+}
+
+/*! Indexes the freedb dump in \p dump_directory into \p index_file
+
+\return #SPLT_FREEDB_LOCAL_INDEX_OK or a negative error
+*/
+int splt_fi_build_index(splt_state *state, const char *dump_directory,
+    const char *index_file)
+{
+  splt_fi_builder builder;
+  memset(&builder, 0, sizeof(builder));
+  builder.state = state;
+  splt_su_builder_init(&builder.strings);
+  splt_su_builder_init(&builder.discs);
+  splt_su_builder_init(&builder.discids);
+  splt_su_builder_init(&builder.terms);
+  splt_su_builder_init(&builder.term_offsets);
+  splt_su_builder_init(&builder.postings);
+
+  unsigned long dump_directory_offset = 0;
+  int err = splt_fi_append_string(&builder.strings, dump_directory, &dump_directory_offset);
+  if (err < 0) { goto end; }
+
+  err = splt_fi_scan_directory(&builder, dump_directory, splt_fi_builder_add_category);
+  if (err < 0) { goto end; }
+
+  err = splt_fi_builder_write(&builder, index_file);
+  if (err < 0) { goto end; }
+
+  err = SPLT_FREEDB_LOCAL_INDEX_OK;
+
+end:
+  splt_su_builder_free(&builder.strings);
+  splt_su_builder_free(&builder.discs);
+  splt_su_builder_free(&builder.discids);
+  splt_su_builder_free(&builder.terms);
+  splt_su_builder_free(&builder.term_offsets);
+  splt_su_builder_free(&builder.postings);
+  if (builder.terms_table)
+  {
+    free(builder.terms_table);
+  }
+
+  return err;
+}
+
+static void splt_fi_free_one_index(splt_freedb_index **index)
+{
+  if (!index || !*index)
+  {
+    return;
+  }
+
+  if ((*index)->filename)
+  {
+    free((*index)->filename);
+  }
+  if ((*index)->bytes)
+  {
+    free((*index)->bytes);
+  }
+
+  free(*index);
+  *index = NULL;
+}
+
+void splt_fi_free_index(splt_state *state)
+{
+  splt_fi_free_one_index(&state->fdb.local_index);
+}
+
+//! Sets the sections of \p index if its header and length are valid
+static int splt_fi_check_index(splt_freedb_index *index)
+{
+  const unsigned char *bytes = index->bytes;
+  if ((size_t) index->size < SPLT_FREEDB_INDEX_HEADER_LENGTH ||
+      memcmp(bytes, SPLT_FREEDB_INDEX_MAGIC, SPLT_FREEDB_INDEX_MAGIC_LENGTH) != 0)
+  {
+    return SPLT_FALSE;
+  }
+
+  const unsigned char *numbers = bytes + SPLT_FREEDB_INDEX_MAGIC_LENGTH;
+  index->number_of_discs = splt_fi_unpack(numbers);
+  index->number_of_discids = splt_fi_unpack(numbers + 4);
+  index->number_of_terms = splt_fi_unpack(numbers + 8);
+  index->number_of_postings = splt_fi_unpack(numbers + 12);
+  index->strings_length = splt_fi_unpack(numbers + 16);
+
+  //computed in 64 bits not to overflow with invalid numbers
+  unsigned long long length = SPLT_FREEDB_INDEX_HEADER_LENGTH +
+    (unsigned long long) index->number_of_discs * SPLT_FREEDB_INDEX_DISC_LENGTH +
+    (unsigned long long) index->number_of_discids * SPLT_FREEDB_INDEX_DISCID_LENGTH +
+    (unsigned long long) index->number_of_terms * SPLT_FREEDB_INDEX_TERM_LENGTH +
+    (unsigned long long) index->number_of_postings * SPLT_FREEDB_INDEX_POSTING_LENGTH +
+    index->strings_length;
+  if (length != (unsigned long long) index->size || index->strings_length == 0)
+  {
+    return SPLT_FALSE;
+  }
+
+  index->discs = bytes + SPLT_FREEDB_INDEX_HEADER_LENGTH;
+  index->discids = index->discs + index->number_of_discs * SPLT_FREEDB_INDEX_DISC_LENGTH;
+  index->terms = index->discids + index->number_of_discids * SPLT_FREEDB_INDEX_DISCID_LENGTH;
+  index->postings = index->terms + index->number_of_terms * SPLT_FREEDB_INDEX_TERM_LENGTH;
+  index->strings = (const char *)
+    (index->postings + index->number_of_postings * SPLT_FREEDB_INDEX_POSTING_LENGTH);
+
+  return index->strings[index->strings_length - 1] == '\0';
+}
+
+/*! Returns the index of \p index_file, reading it if not yet read or if it changed
+
+The returned index belongs to the state.
+*/
+static splt_freedb_index *splt_fi_get_index(splt_state *state, const char *index_file,
+    int *error)
+{
+  splt_freedb_index *index = NULL;
+  struct stat index_stat;
+
+  if (index_file == NULL)
+  {
+    index_file = "";
+  }
+
+  FILE *file = splt_io_fopen(index_file, "rb");
+  if (file == NULL || fstat(fileno(file), &index_stat) != 0)
+  {
+    splt_e_set_strerror_msg_with_data(state, index_file);
+    *error = SPLT_ERROR_CANNOT_OPEN_FILE;
+    goto end;
+  }
+
+  index = state->fdb.local_index;
+  if (index != NULL && strcmp(index->filename, index_file) == 0 &&
+      index->size == index_stat.st_size &&
+      index->modification_time == index_stat.st_mtime)
+  {
+    goto end;
+  }
+
+  splt_fi_free_index(state);
+
+  index = malloc(sizeof(splt_freedb_index));
+  if (index == NULL)
+  {
+    *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+    goto end;
+  }
+  memset(index, 0, sizeof(splt_freedb_index));
+  index->size = index_stat.st_size;
+  index->modification_time = index_stat.st_mtime;
+
+  int err = splt_su_copy(index_file, &index->filename);
+  if (err < 0) { *error = err; goto error; }
+
+  if (index->size > 0)
+  {
+    index->bytes = splt_io_fread(file, (size_t) index->size);
+    if (index->bytes == NULL)
+    {
+      splt_e_set_strerror_msg_with_data(state, index_file);
+      *error = SPLT_ERROR_WHILE_READING_FILE;
+      goto error;
+    }
+  }
+
+  if (!splt_fi_check_index(index))
+  {
+    splt_e_set_error_data(state, index_file);
+    *error = SPLT_FREEDB_ERROR_INVALID_LOCAL_INDEX;
+    goto error;
+  }
+
+  state->fdb.local_index = index;
+  goto end;
+
+error:
+  splt_fi_free_one_index(&index);
+end:
+  if (file)
+  {
+    fclose(file);
+  }
+
+  return index;
+}
+
+static const char *splt_fi_get_string(const splt_freedb_index *index, unsigned long offset)
+{
+  if (offset >= index->strings_length)
+  {
+    return "";
+  }
+
+  return index->strings + offset;
+}
+
+static const unsigned char *splt_fi_get_disc(const splt_freedb_index *index,
+    unsigned long disc)
+{
+  if (disc >= index->number_of_discs)
+  {
+    return NULL;
+  }
+
+  return index->discs + disc * SPLT_FREEDB_INDEX_DISC_LENGTH;
+}
+
+//! Appends the \p disc having \p discid to the search results
+static int splt_fi_append_result(splt_state *state, const splt_freedb_index *index,
+    unsigned long disc, unsigned long discid)
+{
+  const unsigned char *disc_record = splt_fi_get_disc(index, disc);
+  if (disc_record == NULL)
+  {
+    return SPLT_OK;
+  }
+
+  char discid_string[SPLT_DISCIDLEN + 1];
+  snprintf(discid_string, sizeof(discid_string), "%08lx", discid);
+
+  const char *category = splt_fi_get_string(index, splt_fi_unpack(disc_record + 4));
+  splt_fu_freedb_set_disc(state, splt_fu_freedb_get_found_cds(state),
+      discid_string, category, strlen(category) + 1);
+
+  int err = splt_fu_freedb_append_result(state,
+      splt_fi_get_string(index, splt_fi_unpack(disc_record + 12)), 0);
+  if (err < 0) { return err; }
+
+  splt_fu_freedb_found_cds_next(state);
+
+  return SPLT_OK;
+}
+
+//! Returns the first disc id record having \p discid or the number of disc ids if none
+static unsigned long splt_fi_find_discid(const splt_freedb_index *index, unsigned long discid)
+{
+  unsigned long begin = 0;
+  unsigned long end = index->number_of_discids;
+  while (begin < end)
+  {
+    unsigned long middle = begin + (end - begin) / 2;
+    if (splt_fi_unpack(index->discids + middle * SPLT_FREEDB_INDEX_DISCID_LENGTH) < discid)
+    {
+      begin = middle + 1;
+    }
+    else
+    {
+      end = middle;
+    }
+  }
+
+  return begin;
+}
+
+static int splt_fi_search_discid(splt_state *state, const splt_freedb_index *index,
+    unsigned long discid)
+{
+  unsigned long i = 0;
+  for (i = splt_fi_find_discid(index, discid);i < index->number_of_discids;i++)
+  {
+    const unsigned char *record = index->discids + i * SPLT_FREEDB_INDEX_DISCID_LENGTH;
+    if (splt_fi_unpack(record) != discid ||
+        splt_fu_freedb_get_found_cds(state) >= SPLT_MAXCD)
+    {
+      break;
+    }
+
+    int err = splt_fi_append_result(state, index, splt_fi_unpack(record + 4), discid);
+    if (err < 0) { return err; }
+  }
+
+  return SPLT_OK;
+}
+
+//! Finds the postings of \p term; returns SPLT_FALSE if \p term is not in the index
+static int splt_fi_find_term(const splt_freedb_index *index, const char *term,
+    unsigned long *first_posting, unsigned long *number_of_postings)
+{
+  unsigned long begin = 0;
+  unsigned long end = index->number_of_terms;
+  while (begin < end)
+  {
+    unsigned long middle = begin + (end - begin) / 2;
+    const unsigned char *record = index->terms + middle * SPLT_FREEDB_INDEX_TERM_LENGTH;
+
+    int comparison = strcmp(splt_fi_get_string(index, splt_fi_unpack(record)), term);
+    if (comparison == 0)
+    {
+      *first_posting = splt_fi_unpack(record + 4);
+      *number_of_postings = splt_fi_unpack(record + 8);
+      return *first_posting <= index->number_of_postings &&
+        *number_of_postings <= index->number_of_postings - *first_posting;
+    }
+
+    if (comparison < 0)
+    {
+      begin = middle + 1;
+    }
+    else
+    {
+      end = middle;
+    }
+  }
+
+  return SPLT_FALSE;
+}
+
+static int splt_fi_postings_contain(const splt_freedb_index *index, unsigned long first_posting,
+    unsigned long number_of_postings, unsigned long disc)
+{
+  unsigned long begin = first_posting;
+  unsigned long end = first_posting + number_of_postings;
+  while (begin < end)
+  {
+    unsigned long middle = begin + (end - begin) / 2;
+    unsigned long middle_disc =
+      splt_fi_unpack(index->postings + middle * SPLT_FREEDB_INDEX_POSTING_LENGTH);
+    if (middle_disc == disc)
+    {
+      return SPLT_TRUE;
+    }
+
+    if (middle_disc < disc)
+    {
+      begin = middle + 1;
+    }
+    else
+    {
+      end = middle;
+    }
+  }
+
+  return SPLT_FALSE;
+}
+
+//! Searches the discs having all the words of \p search in their title
+static int splt_fi_search_terms(splt_state *state, const splt_freedb_index *index,
+    const char *search)
+{
+  char term[SPLT_FREEDB_INDEX_MAX_TERM_LENGTH + 1];
+  unsigned long first_postings[SPLT_FREEDB_INDEX_MAX_SEARCH_TERMS];
+  unsigned long numbers_of_postings[SPLT_FREEDB_INDEX_MAX_SEARCH_TERMS];
+  int number_of_terms = 0;
+
+  const char *ptr = search;
+  while ((ptr = splt_fi_next_term(ptr, term)) != NULL &&
+      number_of_terms < SPLT_FREEDB_INDEX_MAX_SEARCH_TERMS)
+  {
+    if (term[1] == '\0') { continue; }
+
+    if (!splt_fi_find_term(index, term, &first_postings[number_of_terms],
+          &numbers_of_postings[number_of_terms]))
+    {
+      return SPLT_OK;
+    }
+
+    //the shortest postings are walked, the other ones are searched
+    if (numbers_of_postings[number_of_terms] < numbers_of_postings[0])
+    {
+      unsigned long first_posting = first_postings[0];
+      unsigned long number_of_postings = numbers_of_postings[0];
+      first_postings[0] = first_postings[number_of_terms];
+      numbers_of_postings[0] = numbers_of_postings[number_of_terms];
+      first_postings[number_of_terms] = first_posting;
+      numbers_of_postings[number_of_terms] = number_of_postings;
+    }
+
+    number_of_terms++;
+  }
+
+  if (number_of_terms == 0)
+  {
+    return SPLT_OK;
+  }
+
+  unsigned long i = 0;
+  for (i = 0;i < numbers_of_postings[0];i++)
+  {
+    if (splt_fu_freedb_get_found_cds(state) >= SPLT_MAXCD)
+    {
+      break;
+    }
+
+    unsigned long disc =
+      splt_fi_unpack(index->postings + (first_postings[0] + i) * SPLT_FREEDB_INDEX_POSTING_LENGTH);
+
+    int has_all_terms = SPLT_TRUE;
+    int j = 0;
+    for (j = 1;j < number_of_terms && has_all_terms;j++)
+    {
+      has_all_terms =
+        splt_fi_postings_contain(index, first_postings[j], numbers_of_postings[j], disc);
+    }
+
+    if (has_all_terms)
+    {
+      const unsigned char *disc_record = splt_fi_get_disc(index, disc);
+      if (disc_record == NULL) { continue; }
+
+      int err = splt_fi_append_result(state, index, disc, splt_fi_unpack(disc_record));
+      if (err < 0) { return err; }
+    }
+  }
+
+  return SPLT_OK;
+}
+
+/*! Searches \p search in the local index \p index_file
+
+\p search is a disc id of 8 hexadecimal digits or words that must all be
+found in the "artist / album" titles.
+*/
+int splt_fi_search(splt_state *state, const char *search, const char *index_file)
+{
+  int error = SPLT_FREEDB_OK;
+
+  splt_freedb_index *index = splt_fi_get_index(state, index_file, &error);
+  if (error < 0) { return error; }
+
+  splt_fu_freedb_free_search(state);
+  int err = splt_fu_freedb_init_search(state);
+  if (err < 0) { return err; }
+
+  const char *discid = splt_su_skip_spaces(search);
+  size_t discid_length = strlen(discid);
+  while (discid_length > 0 && isspace((unsigned char) discid[discid_length - 1]))
+  {
+    discid_length--;
+  }
+
+  if (splt_fi_is_discid(discid, discid_length))
+  {
+    err = splt_fi_search_discid(state, index, strtoul(discid, NULL, 16));
+  }
+  else
+  {
+    err = splt_fi_search_terms(state, index, search);
+  }
+  if (err < 0) { return err; }
+
+  int found_cds = splt_fu_freedb_get_found_cds(state);
+  if (found_cds == 0)
+  {
+    error = SPLT_FREEDB_NO_CD_FOUND;
+  }
+  else if (found_cds == SPLT_MAXCD)
+  {
+    error = SPLT_FREEDB_MAX_CD_REACHED;
+  }
+
+  return error;
+}
+
+/*! Returns the xmcd file of the \p disc_id search result from the freedb dump
+
+\param error Is set to #SPLT_FREEDB_FILE_OK or to a negative error
+*/
+char *splt_fi_get_file(splt_state *state, int disc_id, int *error,
+    const char *index_file)
+{
+  *error = SPLT_FREEDB_FILE_OK;
+
+  splt_freedb_index *index = splt_fi_get_index(state, index_file, error);
+  if (*error < 0) { return NULL; }
+
+  if (state->fdb.cdstate == NULL ||
+      disc_id < 0 || disc_id >= splt_fu_freedb_get_found_cds(state))
+  {
+    *error = SPLT_FREEDB_NO_SUCH_CD_IN_DATABASE;
+    return NULL;
+  }
+
+  const char *category = splt_fu_freedb_get_disc_category(state, disc_id);
+  unsigned long discid = strtoul(splt_fu_freedb_get_disc_id(state, disc_id), NULL, 16);
+
+  const unsigned char *disc_record = NULL;
+  unsigned long i = 0;
+  for (i = splt_fi_find_discid(index, discid);i < index->number_of_discids;i++)
+  {
+    const unsigned char *record = index->discids + i * SPLT_FREEDB_INDEX_DISCID_LENGTH;
+    if (splt_fi_unpack(record) != discid) { break; }
+
+    const unsigned char *found_disc = splt_fi_get_disc(index, splt_fi_unpack(record + 4));
+    if (found_disc != NULL &&
+        strcmp(splt_fi_get_string(index, splt_fi_unpack(found_disc + 4)), category) == 0)
+    {
+      disc_record = found_disc;
+      break;
+    }
+  }
+
+  if (disc_record == NULL)
+  {
+    *error = SPLT_FREEDB_NO_SUCH_CD_IN_DATABASE;
+    return NULL;
+  }
+
+  char *path = NULL;
+  char dirchar[2] = { SPLT_DIRCHAR, '\0' };
+  int err = splt_su_append_str(&path, splt_fi_get_string(index, 0), dirchar, category,
+      dirchar, splt_fi_get_string(index, splt_fi_unpack(disc_record + 8)), NULL);
+  if (err < 0) { *error = err; return NULL; }
+
+  splt_io_lines lines;
+  err = splt_io_lines_read_file(&lines, path);
+  if (err < 0)
+  {
+    splt_e_set_strerror_msg_with_data(state, path);
+    *error = err;
+  }
+  free(path);
+
+  if (*error < 0) { return NULL; }
+
+  //the whole file is returned; its lines are not needed
+  char *file = lines.buffer;
+  lines.buffer = NULL;
+  splt_io_lines_free(&lines);
+
+  if (file == NULL)
+  {
+    splt_su_copy("", &file);
+  }
+
+  return file;
+}
+
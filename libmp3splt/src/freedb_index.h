@@ -0,0 +1,61 @@
+/**********************************************************
+ *
+ * libmp3splt -- library based on mp3splt,
+ *               for mp3/ogg splitting without decoding
+ *
+ * Copyright (c) 2002-2005 M. Trotta - <mtrotta@users.sourceforge.net>
+ * Copyright (c) 2005-2014 Alexandru Munteanu - m@ioalex.net
+ *
+ * http://mp3splt.sourceforge.net
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ *********************************************************/
+
+#ifndef SPLT_FREEDB_INDEX_H
+
+#define SPLT_FREEDB_INDEX_MAGIC "SPLTFDB1"
+#define SPLT_FREEDB_INDEX_MAGIC_LENGTH 8
+#define SPLT_FREEDB_INDEX_HEADER_LENGTH (SPLT_FREEDB_INDEX_MAGIC_LENGTH + 5 * 4)
+#define SPLT_FREEDB_INDEX_DISC_LENGTH 16
+#define SPLT_FREEDB_INDEX_DISCID_LENGTH 8
+#define SPLT_FREEDB_INDEX_TERM_LENGTH 12
+#define SPLT_FREEDB_INDEX_POSTING_LENGTH 4
+
+//! longer words are truncated in the index and in the searches
+#define SPLT_FREEDB_INDEX_MAX_TERM_LENGTH 64
+//! maximum number of words of a search
+#define SPLT_FREEDB_INDEX_MAX_SEARCH_TERMS 16
+
+typedef struct _splt_freedb_index splt_freedb_index;
+
+int splt_fi_build_index(splt_state *state, const char *dump_directory,
+    const char *index_file);
+
+int splt_fi_search(splt_state *state, const char *search, const char *index_file);
+char *splt_fi_get_file(splt_state *state, int disc_id, int *error,
+    const char *index_file);
+
+void splt_fi_free_index(splt_state *state);
+
+#define SPLT_FREEDB_INDEX_H
+
+#endif
+
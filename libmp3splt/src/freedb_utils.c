@@ -52,16 +52,19 @@ void splt_fu_set_default_values(splt_state *state)
   splt_freedb *fdb = &state->fdb;
   fdb->search_results = NULL;
   fdb->cdstate = NULL;
+  fdb->local_index = NULL;
+  fdb->connection = NULL;
+  fdb->cache = NULL;
+  fdb->cache_directory = NULL;
 }
 
 void splt_fu_freedb_free_search(splt_state *state)
 {
   splt_fu_free_freedb_search(state);
-  splt_cd_state *cdstate = state->fdb.cdstate;
-  if (cdstate != NULL)
-  { 
-    free(cdstate);
-    cdstate = NULL;
+  if (state->fdb.cdstate != NULL)
+  {
+    free(state->fdb.cdstate);
+    state->fdb.cdstate = NULL;
   }
 }
 
@@ -36,6 +36,7 @@ This file contains all I/O functions this library uses.
 
 #ifdef __WIN32__
 #include <shlwapi.h>
+#include <io.h>
 #endif
 
 #include "splt.h"
@@ -563,6 +564,67 @@ int splt_io_mkdir(splt_state *state, const char *path)
 #endif
 }
 
+/*! Writes the contents of a closed file on the disk and renames it
+
+Used to publish a complete output file under its final name, so that an
+interrupted split never leaves a truncated file with the final name.
+
+\param temporary_filename The closed file to be renamed
+\param filename The final name, replaced if it already exists
+\return SPLT_OK or SPLT_ERROR_CANNOT_CLOSE_FILE
+*/
+int splt_io_sync_and_rename(splt_state *state, const char *temporary_filename,
+    const char *filename)
+{
+  if (splt_o_get_int_option(state, SPLT_OPT_PRETEND_TO_SPLIT))
+  {
+    return SPLT_OK;
+  }
+
+  FILE *file = splt_io_fopen(temporary_filename, "rb+");
+  if (file == NULL)
+  {
+    splt_e_set_strerror_msg_with_data(state, temporary_filename);
+    return SPLT_ERROR_CANNOT_CLOSE_FILE;
+  }
+
+#ifdef __WIN32__
+  int sync_failed = _commit(_fileno(file)) != 0;
+#else
+  int sync_failed = fsync(fileno(file)) != 0;
+#endif
+  if (sync_failed)
+  {
+    splt_e_set_strerror_msg_with_data(state, temporary_filename);
+    fclose(file);
+    return SPLT_ERROR_CANNOT_CLOSE_FILE;
+  }
+
+  if (fclose(file) != 0)
+  {
+    splt_e_set_strerror_msg_with_data(state, temporary_filename);
+    return SPLT_ERROR_CANNOT_CLOSE_FILE;
+  }
+
+  if (rename(temporary_filename, filename) != 0)
+  {
+#ifdef __WIN32__
+    //rename does not replace existing files on windows
+    remove(filename);
+    if (rename(temporary_filename, filename) != 0)
+    {
+      splt_e_set_strerror_msg_with_data(state, filename);
+      return SPLT_ERROR_CANNOT_CLOSE_FILE;
+    }
+#else
+    splt_e_set_strerror_msg_with_data(state, filename);
+    return SPLT_ERROR_CANNOT_CLOSE_FILE;
+#endif
+  }
+
+  return SPLT_OK;
+}
+
 int splt_io_stat(const char *path, mode_t *st_mode, off_t *st_size)
 {
 #ifdef __WIN32__
@@ -737,6 +799,16 @@ size_t splt_io_fwrite(splt_state *state, const void *ptr, size_t size, size_t nm
   }
 }
 
+//! Characters read at least by each fgets of splt_io_readline
+#define SPLT_IO_READLINE_CHUNK 128
+
+/*! Reads a line, including its ending newline
+
+fgets reads directly at the end of the line being built, which grows
+geometrically for long lines.
+
+\return The line to be freed, or NULL at the end of the file
+*/
 char *splt_io_readline(FILE *stream, int *error)
 {
   if (feof(stream))
@@ -744,37 +816,187 @@ char *splt_io_readline(FILE *stream, int *error)
     return NULL;
   }
 
-  int err = SPLT_OK;
-  int bufsize = 1024;
-  char *buffer = malloc(sizeof(char) * bufsize);
-  buffer[0] = '\0';
+  splt_string_builder line;
+  splt_su_builder_init(&line);
 
-  char *line = NULL;
-  while (fgets(buffer, bufsize, stream) != NULL)
+  while (1)
   {
-    err = splt_su_append_str(&line, buffer, NULL);
-    if (err < 0) { *error = err; break; }
+    int err = splt_su_builder_reserve(&line, SPLT_IO_READLINE_CHUNK - 1);
+    if (err < 0)
+    {
+      *error = err;
+      splt_su_builder_free(&line);
+      return NULL;
+    }
 
-    if (line != NULL && line[strlen(line)-1] == '\n')
+    char *chunk = line.str + line.length;
+    size_t available = line.size - line.length;
+    if (available > INT_MAX) { available = INT_MAX; }
+
+    if (fgets(chunk, (int) available, stream) == NULL)
     {
-      free(buffer);
-      return line;
+      line.str[line.length] = '\0';
+      break;
     }
 
-    buffer[0] = '\0';  
+    size_t chunk_length = strlen(chunk);
+    line.length += chunk_length;
+
+    if (chunk_length > 0 && chunk[chunk_length - 1] == '\n')
+    {
+      break;
+    }
   }
 
-  free(buffer);
+  return splt_su_builder_release(&line);
+}
+
+//! Bytes read at least by each fread of splt_io_lines_read_file
+#define SPLT_IO_LINES_CHUNK 4096
+
+/*! Reads a whole text file in memory
+
+The file is read with one fread when its size is known; splt_io_lines_next
+then returns its lines without copying them.
 
-  if (*error < 0)
+\return SPLT_OK, SPLT_ERROR_CANNOT_OPEN_FILE,
+ SPLT_ERROR_WHILE_READING_FILE or SPLT_ERROR_CANNOT_ALLOCATE_MEMORY
+*/
+int splt_io_lines_read_file(splt_io_lines *lines, const char *filename)
+{
+  lines->buffer = NULL;
+  lines->size = 0;
+  lines->next_line = NULL;
+  lines->line_number = 0;
+
+  FILE *file = splt_io_fopen(filename, "rb");
+  if (file == NULL)
+  {
+    return SPLT_ERROR_CANNOT_OPEN_FILE;
+  }
+
+  int error = SPLT_OK;
+
+  splt_string_builder contents;
+  splt_su_builder_init(&contents);
+
+  size_t expected_size = SPLT_IO_LINES_CHUNK;
+  struct stat file_stat;
+  if (fstat(fileno(file), &file_stat) == 0 && S_ISREG(file_stat.st_mode) &&
+      file_stat.st_size > 0)
+  {
+    //one more byte to find the end of the file without growing the buffer
+    expected_size = (size_t) file_stat.st_size + 1;
+  }
+
+  while (1)
+  {
+    error = splt_su_builder_reserve(&contents, expected_size);
+    if (error < 0) { goto end; }
+
+    size_t available = contents.size - contents.length - 1;
+    size_t bytes_read = fread(contents.str + contents.length, 1, available, file);
+    contents.length += bytes_read;
+    contents.str[contents.length] = '\0';
+
+    if (bytes_read < available)
+    {
+      if (ferror(file))
+      {
+        error = SPLT_ERROR_WHILE_READING_FILE;
+        goto end;
+      }
+
+      break;
+    }
+
+    expected_size = SPLT_IO_LINES_CHUNK;
+  }
+
+  lines->size = contents.length;
+  lines->buffer = contents.str;
+  splt_su_builder_init(&contents);
+
+  lines->next_line = lines->buffer;
+
+  //skip the utf-8 byte order mark
+  if (lines->size >= 3 && memcmp(lines->buffer, "\xEF\xBB\xBF", 3) == 0)
+  {
+    lines->next_line += 3;
+  }
+
+end:
+  splt_su_builder_free(&contents);
+
+  if (fclose(file) != 0 && error == SPLT_OK)
+  {
+    error = SPLT_ERROR_WHILE_READING_FILE;
+  }
+
+  if (error < 0)
+  {
+    splt_io_lines_free(lines);
+  }
+
+  return error;
+}
+
+/*! Returns the next line without its ending newline
+
+The line is cut in place in the buffer of \p lines and stays valid until
+splt_io_lines_free. Windows line endings are removed as well.
+
+\return The line or NULL after the last line
+*/
+char *splt_io_lines_next(splt_io_lines *lines)
+{
+  char *line = lines->next_line;
+  if (line == NULL)
   {
-    free(line);
     return NULL;
   }
 
+  char *end_of_buffer = lines->buffer + lines->size;
+  if (line >= end_of_buffer)
+  {
+    lines->next_line = NULL;
+    return NULL;
+  }
+
+  char *end_of_line = memchr(line, '\n', end_of_buffer - line);
+  if (end_of_line == NULL)
+  {
+    end_of_line = end_of_buffer;
+    lines->next_line = NULL;
+  }
+  else
+  {
+    lines->next_line = end_of_line + 1;
+  }
+
+  if (end_of_line > line && *(end_of_line - 1) == '\r')
+  {
+    end_of_line--;
+  }
+  *end_of_line = '\0';
+
+  lines->line_number++;
+
   return line;
 }
 
+void splt_io_lines_free(splt_io_lines *lines)
+{
+  if (lines->buffer)
+  {
+    free(lines->buffer);
+    lines->buffer = NULL;
+  }
+
+  lines->size = 0;
+  lines->next_line = NULL;
+}
+
 unsigned char *splt_io_fread(FILE *file, size_t size)
 {
   unsigned char *bytes = malloc(sizeof(unsigned char) * size);
@@ -53,6 +53,8 @@ int splt_io_create_directories(splt_state *state, const char *dir);
 int splt_io_stat(const char *path, mode_t *st_mode, off_t *st_size);
 FILE *splt_io_fopen(const char *filename, const char *mode);
 int splt_io_mkdir(splt_state *state, const char *path);
+int splt_io_sync_and_rename(splt_state *state, const char *temporary_filename,
+    const char *filename);
 unsigned char *splt_io_fread(FILE *file, size_t size);
 size_t splt_io_fwrite(splt_state *state, const void *ptr,
     size_t size, size_t nmemb, FILE *stream);
@@ -62,6 +64,21 @@ void splt_io_find_filenames(splt_state *state, const char *directory,
 
 char *splt_io_readline(FILE *stream, int *error);
 
+//! Lines of a text file read in memory at once
+typedef struct {
+  //! Contents of the file, lines are cut in place
+  char *buffer;
+  size_t size;
+  //! Beginning of the next line in #buffer
+  char *next_line;
+  //! Number of the last line returned by splt_io_lines_next, starting at 1
+  int line_number;
+} splt_io_lines;
+
+int splt_io_lines_read_file(splt_io_lines *lines, const char *filename);
+char *splt_io_lines_next(splt_io_lines *lines);
+void splt_io_lines_free(splt_io_lines *lines);
+
 #define MP3SPLT_IO_H
 
 #endif
@@ -0,0 +1,141 @@
+/**********************************************************
+ *
+ * libmp3splt -- library based on mp3splt,
+ *               for mp3/ogg splitting without decoding
+ *
+ * Copyright (c) 2002-2005 M. Trotta - <mtrotta@users.sourceforge.net>
+ * Copyright (c) 2005-2014 Alexandru Munteanu - m@ioalex.net
+ *
+ * http://mp3splt.sourceforge.net
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ *********************************************************/
+
+/*! \file
+
+Process-wide initialisation and locks
+
+Concurrency audit of the library - what is shared between the states:
+ - libltdl (lt_dlinit, lt_dlopen, lt_dlsym, lt_dlerror, lt_dlclose) keeps
+   global data: lt_dlinit is called once and all the other calls are
+   made with #SPLT_LOCK_PLUGINS held, as is the plugins registry
+ - gettext domain binding: done once by #splt_lk_init_library_once
+ - strerror and hstrerror may return static buffers: they are copied
+   with #SPLT_LOCK_LIBC held
+ - the temporary files of the freedb cache are numbered with
+   #SPLT_LOCK_FREEDB_CACHE held, as the cache directory may be shared
+ - the Ogg stream serial numbers were taken from rand(): each Ogg state
+   now has its own generator
+ - libmad, libvorbis, libFLAC and libid3tag only work on the objects
+   created by the plugins for one state and use no mutable global data
+ - the debug mode (#SPLT_OPT_DEBUG_MODE) is process-wide
+ - everything else lives in the #splt_state
+*/
+
+#ifndef __WIN32__
+#include <pthread.h>
+#endif
+
+#include "splt.h"
+
+static int splt_lk_init_library_error = SPLT_OK;
+
+static void splt_lk_init_library()
+{
+  if (lt_dlinit() != 0)
+  {
+    splt_lk_init_library_error = SPLT_ERROR_CANNOT_INIT_LIBLTDL;
+    return;
+  }
+
+#ifdef ENABLE_NLS
+ #ifndef __WIN32__
+  bindtextdomain(MP3SPLT_LIB_GETTEXT_DOMAIN, LOCALEDIR);
+  bind_textdomain_codeset(MP3SPLT_LIB_GETTEXT_DOMAIN, nl_langinfo(CODESET));
+ #else
+  bind_textdomain_codeset(MP3SPLT_LIB_GETTEXT_DOMAIN, "UTF-8");
+ #endif
+#endif
+}
+
+#ifdef __WIN32__
+
+static volatile LONG splt_lk_init_state = 0;
+static volatile LONG splt_lk_locks[SPLT_NUMBER_OF_LOCKS] = { 0 };
+
+//! Initialises libltdl and gettext only once for all the states
+int splt_lk_init_library_once()
+{
+  if (InterlockedCompareExchange(&splt_lk_init_state, 1, 0) == 0)
+  {
+    splt_lk_init_library();
+    InterlockedExchange(&splt_lk_init_state, 2);
+  }
+
+  while (splt_lk_init_state != 2)
+  {
+    Sleep(0);
+  }
+
+  return splt_lk_init_library_error;
+}
+
+void splt_lk_lock(splt_lock lock)
+{
+  while (InterlockedCompareExchange(&splt_lk_locks[lock], 1, 0) != 0)
+  {
+    Sleep(0);
+  }
+}
+
+void splt_lk_unlock(splt_lock lock)
+{
+  InterlockedExchange(&splt_lk_locks[lock], 0);
+}
+
+#else
+
+static pthread_once_t splt_lk_init_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t splt_lk_locks[SPLT_NUMBER_OF_LOCKS] = {
+  PTHREAD_MUTEX_INITIALIZER,
+  PTHREAD_MUTEX_INITIALIZER,
+  PTHREAD_MUTEX_INITIALIZER,
+};
+
+//! Initialises libltdl and gettext only once for all the states
+int splt_lk_init_library_once()
+{
+  pthread_once(&splt_lk_init_once, splt_lk_init_library);
+  return splt_lk_init_library_error;
+}
+
+void splt_lk_lock(splt_lock lock)
+{
+  pthread_mutex_lock(&splt_lk_locks[lock]);
+}
+
+void splt_lk_unlock(splt_lock lock)
+{
+  pthread_mutex_unlock(&splt_lk_locks[lock]);
+}
+
+#endif
+
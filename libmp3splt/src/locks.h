@@ -0,0 +1,53 @@
+/**********************************************************
+ *
+ * libmp3splt -- library based on mp3splt,
+ *               for mp3/ogg splitting without decoding
+ *
+ * Copyright (c) 2002-2005 M. Trotta - <mtrotta@users.sourceforge.net>
+ * Copyright (c) 2005-2014 Alexandru Munteanu - m@ioalex.net
+ *
+ * http://mp3splt.sourceforge.net
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ *********************************************************/
+
+#ifndef SPLT_LOCKS_H
+
+//! the process-wide locks of the library
+typedef enum {
+  //!plugins registry and all the libltdl calls
+  SPLT_LOCK_PLUGINS,
+  //!C library functions returning static buffers (strerror, hstrerror)
+  SPLT_LOCK_LIBC,
+  //!number of the temporary files of the freedb cache
+  SPLT_LOCK_FREEDB_CACHE,
+  SPLT_NUMBER_OF_LOCKS,
+} splt_lock;
+
+int splt_lk_init_library_once();
+
+void splt_lk_lock(splt_lock lock);
+void splt_lk_unlock(splt_lock lock);
+
+#define SPLT_LOCKS_H
+
+#endif
+
@@ -119,22 +119,13 @@ splt_state *mp3splt_new_state(splt_code *error)
   int *err = &erro;
   if (error != NULL) { err = error; }
 
-  if (lt_dlinit() != 0)
+  int init_error = splt_lk_init_library_once();
+  if (init_error < 0)
   {
-    *err = SPLT_ERROR_CANNOT_INIT_LIBLTDL;
+    *err = init_error;
   }
   else
   {
-
-#ifdef ENABLE_NLS
- #ifndef __WIN32__
-    bindtextdomain(MP3SPLT_LIB_GETTEXT_DOMAIN, LOCALEDIR);
-    bind_textdomain_codeset(MP3SPLT_LIB_GETTEXT_DOMAIN, nl_langinfo(CODESET));
- #else
-    bind_textdomain_codeset(MP3SPLT_LIB_GETTEXT_DOMAIN, "UTF-8");
- #endif
-#endif
-
     state = splt_t_new_state(state, err);
   }
 
@@ -179,6 +170,39 @@ splt_code mp3splt_free_state(splt_state *state)
   return SPLT_OK;
 }
 
+/*! cleans the state after a split, for splitting another file
+
+The options, output format, callbacks and plugins are kept, so that a
+state can be reused for many files without being created again.
+*/
+splt_code mp3splt_reset_state(splt_state *state)
+{
+  if (state == NULL)
+  {
+    return SPLT_ERROR_STATE_NULL;
+  }
+
+  if (splt_o_library_locked(state))
+  {
+    return SPLT_ERROR_LIBRARY_LOCKED;
+  }
+
+  splt_o_lock_library(state);
+  splt_t_reset_state(state);
+  splt_o_unlock_library(state);
+
+  return SPLT_OK;
+}
+
+/*! frees the plugins shared by the states
+
+\return SPLT_ERROR_LIBRARY_LOCKED if some states still use the plugins
+*/
+splt_code mp3splt_free_plugins_cache()
+{
+  return splt_p_free_registry();
+}
+
 //! Set the output path
 splt_code mp3splt_set_path_of_split(splt_state *state, const char *path)
 {
@@ -921,6 +945,42 @@ end:
   return error;
 }
 
+splt_tags *mp3splt_get_original_tags(splt_state *state, splt_code *error)
+{
+  int erro = SPLT_OK;
+  int *err = &erro;
+  if (error != NULL) { err = error; }
+
+  if (state == NULL)
+  {
+    *err = SPLT_ERROR_STATE_NULL;
+    return NULL;
+  }
+
+  return &state->original_tags.tags;
+}
+
+long mp3splt_get_total_time(splt_state *state)
+{
+  if (state == NULL)
+  {
+    return -1;
+  }
+
+  return splt_t_get_total_time(state);
+}
+
+const char *mp3splt_get_plugin_name(splt_state *state)
+{
+  if (state == NULL)
+  {
+    return NULL;
+  }
+
+  int error = SPLT_OK;
+  return splt_p_get_name(state, &error);
+}
+
 //!puts tags from a string
 int mp3splt_put_tags_from_string(splt_state *state, const char *tags, splt_code *error)
 {
@@ -1298,6 +1358,9 @@ splt_code mp3splt_split(splt_state *state)
         case SPLT_OPTION_LENGTH_MODE:
           splt_s_equal_length_split(state, &error);
           break;
+        case SPLT_OPTION_LIVE_MODE:
+          splt_s_live_split(state, &error);
+          break;
         case SPLT_OPTION_ERROR_MODE:
           splt_s_error_split(state, &error);
           break;
@@ -1428,6 +1491,34 @@ end:
   return err;
 }
 
+splt_code mp3splt_import_internal_sheet_plan(splt_state *state, const char *file)
+{
+  if (state == NULL)
+  {
+    return SPLT_ERROR_STATE_NULL;
+  }
+
+  if (file == NULL)
+  {
+    return SPLT_ERROR_INVALID;
+  }
+
+  if (splt_o_library_locked(state))
+  {
+    return SPLT_ERROR_LIBRARY_LOCKED;
+  }
+
+  splt_o_lock_library(state);
+  int err = SPLT_OK;
+
+  splt_t_free_splitpoints_tags(state);
+  splt_p_import_internal_sheets_plan(state, file, &err);
+
+  splt_o_unlock_library(state);
+
+  return err;
+}
+
 /************************************/
 /*    Freedb functions              */
 
@@ -1463,6 +1554,58 @@ void mp3splt_clear_proxy(splt_state *state)
   splt_pr_free(state);
 }
 
+splt_code mp3splt_set_output_sink(splt_state *state, const splt_output_sink *sink)
+{
+  if (state == NULL)
+  {
+    return SPLT_ERROR_STATE_NULL;
+  }
+
+  return splt_os_set_sink(state, sink);
+}
+
+splt_code mp3splt_set_memory_output_sink(splt_state *state,
+    void (*file_done)(const char *filename, const unsigned char *bytes, size_t size, void *cb_data),
+    void *cb_data)
+{
+  if (state == NULL)
+  {
+    return SPLT_ERROR_STATE_NULL;
+  }
+
+  return splt_os_set_memory_sink(state, file_done, cb_data);
+}
+
+splt_code mp3splt_set_fd_output_sink(splt_state *state, int fd)
+{
+  if (state == NULL)
+  {
+    return SPLT_ERROR_STATE_NULL;
+  }
+
+  return splt_os_set_fd_sink(state, fd);
+}
+
+splt_code mp3splt_set_temporary_file_output_sink(splt_state *state)
+{
+  if (state == NULL)
+  {
+    return SPLT_ERROR_STATE_NULL;
+  }
+
+  return splt_os_set_temporary_file_sink(state);
+}
+
+splt_code mp3splt_freedb_use_cache_directory(splt_state *state, const char *cache_directory)
+{
+  if (state == NULL)
+  {
+    return SPLT_ERROR_STATE_NULL;
+  }
+
+  return splt_fc_set_directory(state, cache_directory);
+}
+
 /*!Do a freedb search
 
 After dong the search continue by calling
@@ -1642,6 +1785,40 @@ splt_code mp3splt_write_freedb_file_result(splt_state *state, int disc_id,
   return *err;
 }
 
+/*! Indexes a freedb dump for SPLT_FREEDB_SEARCH_TYPE_LOCAL_INDEX searches
+
+\param state The central structure this library keeps all its data in
+\param dump_directory The directory of the freedb dump, having one
+sub-directory per category
+\param index_file The index file to write
+*/
+splt_code mp3splt_freedb_build_local_index(splt_state *state,
+    const char *dump_directory, const char *index_file)
+{
+  if (state == NULL)
+  {
+    return SPLT_ERROR_STATE_NULL;
+  }
+
+  if (dump_directory == NULL || index_file == NULL)
+  {
+    return SPLT_ERROR_INVALID;
+  }
+
+  if (splt_o_library_locked(state))
+  {
+    return SPLT_ERROR_LIBRARY_LOCKED;
+  }
+
+  splt_o_lock_library(state);
+
+  int err = splt_fi_build_index(state, dump_directory, index_file);
+
+  splt_o_unlock_library(state);
+
+  return err;
+}
+
 /*! Export our split points to a cue file
 */
 splt_code mp3splt_export(splt_state *state, splt_export_type type,
@@ -2059,3 +2236,37 @@ splt_tags *mp3splt_parse_filename_regex(splt_state *state, splt_code *error)
   return tags;
 }
 
+splt_code mp3splt_parse_filenames_regex(splt_state *state, const char * const *filenames,
+    int number_of_filenames, splt_tags **tags)
+{
+  if (state == NULL)
+  {
+    return SPLT_ERROR_STATE_NULL;
+  }
+
+  if (splt_o_library_locked(state))
+  {
+    return SPLT_ERROR_LIBRARY_LOCKED;
+  }
+
+  splt_o_lock_library(state);
+
+#ifndef NO_PCRE
+  int error = splt_fr_parse_filenames(state, filenames, number_of_filenames, tags);
+#else
+  int i = 0;
+  for (i = 0; i < number_of_filenames; i++)
+  {
+    tags[i] = NULL;
+  }
+
+  splt_c_put_warning_message_to_client(state,
+      _(" warning: cannot set tags from filename regular expression - compiled without pcre support\n"));
+  int error = SPLT_REGEX_UNAVAILABLE;
+#endif
+
+  splt_o_unlock_library(state);
+
+  return error;
+}
+
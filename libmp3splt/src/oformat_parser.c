@@ -39,27 +39,9 @@ Automatic generation of filenams for split files from tags.
 
 #include "splt.h"
 
-static void splt_of_trim_on_separator_characters(char *filename);
+static void splt_of_trim_on_separator_characters(splt_string_builder *filename);
 static const char *splt_of_goto_last_non_separator_character(const char *format);
-
-static char *duplicate_and_clean(splt_state *state, const char *str, int *error)
-{
-  char *dup = strdup(str);
-  if (!dup)
-  {
-    *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
-    return NULL;
-  }
-
-  splt_su_clean_string(state, dup, error);
-  if (error < 0)
-  {
-    free(dup);
-    return NULL;
-  }
-
-  return dup;
-}
+static void splt_of_compile_outformat(splt_state *state);
 
 /*! \brief Is a placeholder char valid in a filename format string?
 
@@ -103,7 +85,7 @@ static short splt_of_output_variable_is_valid(char v, int *amb)
   return SPLT_TRUE;
 }
 
-int splt_of_parse_outformat(char *s, splt_state *state)
+static int splt_of_parse_outformat_fields(char *s, splt_state *state)
 {
   char *ptrs = NULL, *ptre = NULL;
   int i=0, amb = SPLT_OUTPUT_FORMAT_AMBIGUOUS, len=0;
@@ -212,60 +194,139 @@ int splt_of_parse_outformat(char *s, splt_state *state)
   return amb;
 }
 
-static const char *splt_u_get_format_ptr(const char *format, char *temp,
-    int *number_of_digits_to_output)
+/*! \brief Parses the output format and compiles its fields
+
+The fields are compiled even if the format is ambiguous or incorrect, because
+the incorrect format warning can be ignored.
+ */
+int splt_of_parse_outformat(char *s, splt_state *state)
 {
-  int format_length = strlen(format);
-  const char *format_ptr = format;
+  int result = splt_of_parse_outformat_fields(s, state);
+  splt_of_compile_outformat(state);
+  return result;
+}
 
-  if ((format_length > 2) && isdigit(format[2]))
+//! Does the variable take the digit written right after it as its width ?
+static int splt_of_variable_takes_digits(char v)
+{
+  switch (v)
   {
-    if (number_of_digits_to_output)
-    {
-      sscanf(&format[2], "%d", number_of_digits_to_output);
-    }
+    case 's':
+    case 'S':
+    case 'm':
+    case 'M':
+    case 'h':
+    case 'H':
+    case 'l':
+    case 'L':
+    case 'u':
+    case 'U':
+    case 'n':
+    case 'N':
+      return SPLT_TRUE;
+    default:
+      return SPLT_FALSE;
+  }
+}
+
+/*! \brief Compiles the parsed format fields once for all the generated filenames
+
+The variable, the requested digits and the texts of each field are resolved
+here, so that splt_of_put_output_format_filename only has to fill the values.
+ */
+static void splt_of_compile_outformat(splt_state *state)
+{
+  splt_oformat *oformat = &state->oformat;
 
-    temp[2] = format[2];
-    format_ptr = format + 1;
+  oformat->number_of_fields = 0;
+  oformat->is_default_output = SPLT_FALSE;
+  if (oformat->format_string != NULL &&
+      strcmp(oformat->format_string, SPLT_DEFAULT_OUTPUT) == 0)
+  {
+    oformat->is_default_output = SPLT_TRUE;
   }
-  else
+
+  int i = 0;
+  for (i = 0; i < SPLT_OUTNUM; i++)
   {
-    if (number_of_digits_to_output)
+    const char *format = oformat->format[i];
+    size_t format_length = strnlen(format, SPLT_MAXOLEN);
+    if (format_length == 0)
     {
-      *number_of_digits_to_output = -1;
+      break;
     }
-  }
 
-  return format_ptr;
+    splt_oformat_field *field = &oformat->fields[oformat->number_of_fields++];
+    field->digits = -1;
+    field->number_after_variable = -1;
+    field->zero_value_text = NULL;
+    field->zero_value_text_length = 0;
+
+    //if we have some % in the format (@ has been converted to %)
+    if (format[0] != '%')
+    {
+      field->variable = '\0';
+      field->text = format;
+      field->text_length = format_length;
+      continue;
+    }
+
+    field->variable = format[1];
+    if (format_length < 2)
+    {
+      field->text = format + format_length;
+      field->text_length = 0;
+      continue;
+    }
+
+    const char *text = format + 2;
+    if ((format_length > 2) && isdigit(format[2]))
+    {
+      field->digits = format[2] - '0';
+      sscanf(&format[2], "%d", &field->number_after_variable);
+
+      if (splt_of_variable_takes_digits(field->variable))
+      {
+        text++;
+      }
+    }
+
+    field->text = text;
+    field->text_length = format_length - (text - format);
+
+    if (field->number_after_variable == 0)
+    {
+      field->zero_value_text = splt_of_goto_last_non_separator_character(format + 3);
+      field->zero_value_text_length = strlen(field->zero_value_text);
+    }
+  }
 }
 
-static int splt_u_get_requested_num_of_digits(splt_state *state, const char *format,
-    int *requested_num_of_digits, int is_alpha)
+//! Appends a tag value with the characters illegal in filenames replaced
+static int splt_of_append_cleaned(splt_state *state, splt_string_builder *filename,
+    const char *str)
 {
-  int format_length = strlen(format);
-  int number_of_digits = 0;
-  if (is_alpha)
-  {
-    number_of_digits = state->oformat.output_alpha_format_digits;
-  }
-  else
-  {
-    number_of_digits = splt_of_get_oformat_number_of_digits_as_int(state);
-  }
-  int max_number_of_digits = number_of_digits;
-  *requested_num_of_digits = number_of_digits;
+  size_t start = filename->length;
+  int error = splt_su_builder_append_str(filename, str);
+  if (error < 0) { return error; }
 
-  if ((format_length > 2) && isdigit(format[2]))
-  {
-    *requested_num_of_digits = format[2] - '0';
-  }
+  splt_su_clean_string(state, filename->str + start, &error);
+  filename->length = start + strlen(filename->str + start);
 
-  if (*requested_num_of_digits > number_of_digits)
+  return error;
+}
+
+static int splt_of_append_number(splt_string_builder *filename,
+    int number_of_digits, long value)
+{
+  char number[32] = { '\0' };
+  int number_length = snprintf(number, sizeof(number), "%0*ld", number_of_digits, value);
+  if (number_length < 0)
   {
-    max_number_of_digits = *requested_num_of_digits;
+    return SPLT_OK;
   }
 
-  return max_number_of_digits;
+  return splt_su_builder_append(filename, number, (size_t) number_length);
 }
 
 /*! Encode track number as 'A', 'B', ... 'Z', 'AA, 'AB', ...
@@ -281,20 +342,28 @@ static int splt_u_get_requested_num_of_digits(splt_state *state, const char *for
  *   the track number as simple base-26: 'AAA', 'AAB', ... 'AAZ', 'ABA',
  *   'ABB', ...
  */
-static void splt_u_alpha_track(splt_state *state, int nfield,
-    char *fm, int fm_length, int number_of_digits, int tracknumber)
+static int splt_u_alpha_track(splt_state *state, const splt_oformat_field *field,
+    splt_string_builder *filename, int number_of_digits, int tracknumber)
 {
-  char *format = state->oformat.format[nfield];
-  int lowercase = (toupper(format[1]) == 'L');
+  int lowercase = (toupper(field->variable) == 'L');
   char a = lowercase ? 'a' : 'A';
   int zerobased = tracknumber - 1;
   int i = 1, min_digits = state->oformat.output_alpha_format_digits;
 
-  if (number_of_digits > 1)
+  int padding = (number_of_digits > 1);
+  if (!padding || number_of_digits < min_digits)
+  {
+    number_of_digits = min_digits;
+  }
+
+  int error = splt_su_builder_reserve(filename, number_of_digits);
+  if (error < 0) { return error; }
+
+  char *fm = filename->str + filename->length;
+
+  if (padding)
   {
     /* Padding required => simple base-26 encoding */
-    if (number_of_digits < min_digits)
-      number_of_digits = min_digits;
     for (i = 1; i <= number_of_digits; ++ i, zerobased /= 26)
     {
       int digit = (zerobased % 26);
@@ -304,7 +373,6 @@ static void splt_u_alpha_track(splt_state *state, int nfield,
   else
   {
     /* No padding: First letter base-26, others base-27 */
-    number_of_digits = min_digits;
 
     /* Start with the first, base-26 'digit' */
     fm[number_of_digits - 1] = a + (zerobased % 26);
@@ -318,13 +386,10 @@ static void splt_u_alpha_track(splt_state *state, int nfield,
     }
   }
 
-  int offset = 0;
-  if ((strlen(format) > 2) && isdigit(format[2]))
-  {
-    offset = 1;
-  }
-  snprintf(fm + number_of_digits, fm_length - number_of_digits,
-      "%s", format + 2 + offset);
+  filename->length += number_of_digits;
+  filename->str[filename->length] = '\0';
+
+  return SPLT_OK;
 }
 
 char splt_of_get_number_of_digits_from_total_time(splt_state *state)
@@ -346,10 +411,45 @@ char splt_of_get_number_of_digits_from_total_time(splt_state *state)
   return number_of_digits;
 }
 
+static const char *splt_of_get_tags_field_for_variable(splt_state *state,
+    int tags_index, char variable)
+{
+  if (!splt_tu_tags_exists(state, tags_index))
+  {
+    return NULL;
+  }
+
+  switch (variable)
+  {
+    case 'A':
+      {
+        const char *artist_or_performer =
+          splt_tu_get_tags_field(state, tags_index, SPLT_TAGS_PERFORMER);
+        if (artist_or_performer == NULL || artist_or_performer[0] == '\0')
+        {
+          artist_or_performer = splt_tu_get_tags_field(state, tags_index, SPLT_TAGS_ARTIST);
+        }
+        return artist_or_performer;
+      }
+    case 'a':
+      return splt_tu_get_tags_field(state, tags_index, SPLT_TAGS_ARTIST);
+    case 'b':
+      return splt_tu_get_tags_field(state, tags_index, SPLT_TAGS_ALBUM);
+    case 'g':
+      return splt_tu_get_tags_field(state, tags_index, SPLT_TAGS_GENRE);
+    case 't':
+      return splt_tu_get_tags_field(state, tags_index, SPLT_TAGS_TITLE);
+    case 'p':
+      return splt_tu_get_tags_field(state, tags_index, SPLT_TAGS_PERFORMER);
+  }
+
+  return NULL;
+}
+
 /*! \brief Automagically set the filename for a split point
 
-  The filename is generated from the tags and the output format
-  string.
+  The filename is generated from the tags and the fields compiled from the
+  output format string, in one pass into a buffer kept in the state.
 
   \param state The central structure libmp3splt keeps all its data in
   \param current_splt The number of the split point to determine the
@@ -365,19 +465,8 @@ int splt_of_put_output_format_filename(splt_state *state, int current_split)
     return error;
   }
 
-  char *temp = NULL;
-  char *fm = NULL;
+  splt_oformat *oformat = &state->oformat;
   int i = 0;
-  char *output_filename = NULL;
-  int output_filename_size = 0;
-
-  const char *title = NULL;
-  const char *artist = NULL;
-  const char *album = NULL;
-  const char *genre = NULL;
-  const char *performer = NULL;
-  const char *artist_or_performer = NULL;
-  char *original_filename = NULL;
 
   int split_file_number = splt_t_get_current_split_file_number(state);
   int tags_index = split_file_number - 1;
@@ -403,8 +492,6 @@ int splt_of_put_output_format_filename(splt_state *state, int current_split)
     splt_co_get_mins_secs_hundr(next_point_value, &next_mins, &next_secs, &next_hundr);
   }
 
-  int fm_length = 0;
-
   //if we get the tags from the first file
   int remaining_tags_like_x = splt_o_get_int_option(state,SPLT_OPT_ALL_REMAINING_TAGS_LIKE_X);
   int real_tags_number = 0;
@@ -419,445 +506,133 @@ int splt_of_put_output_format_filename(splt_state *state, int current_split)
     tags_index = remaining_tags_like_x;
   }
 
-  const char *output_format = splt_of_get_oformat(state);
   short write_eof = SPLT_FALSE;
-  if ((next_point_value == LONG_MAX) &&
-      (strcmp(output_format, SPLT_DEFAULT_OUTPUT) == 0))
+  if ((next_point_value == LONG_MAX) && oformat->is_default_output)
   {
     write_eof = SPLT_TRUE;
   }
 
-  splt_d_print_debug(state,"The output format is _%s_\n", output_format);
+  splt_d_print_debug(state,"The output format is _%s_\n", splt_of_get_oformat(state));
 
-  long mMsShH_value = -1;
+  //if not time split, or normal split, or silence split or error,
+  //we put the track number from the tags
+  int split_mode = splt_o_get_int_option(state,SPLT_OPT_SPLIT_MODE);
+  int track_from_tags =
+    ((split_mode != SPLT_OPTION_TIME_MODE) &&
+     (split_mode != SPLT_OPTION_NORMAL_MODE) &&
+     (split_mode != SPLT_OPTION_SILENCE_MODE) &&
+     (split_mode != SPLT_OPTION_TRIM_SILENCE_MODE) &&
+     (split_mode != SPLT_OPTION_ERROR_MODE) &&
+     (split_mode != SPLT_OPTION_LENGTH_MODE) &&
+     (split_mode != SPLT_OPTION_LIVE_MODE));
+
+  char minutes_number_of_digits = '\0';
   short eof_written = SPLT_FALSE;
 
-  for (i = 0; i < SPLT_OUTNUM; i++)
+  splt_string_builder *filename = &oformat->filename;
+  int reserve_error = splt_su_builder_reserve(filename, 0);
+  if (reserve_error < 0) { return reserve_error; }
+  splt_su_builder_truncate(filename, 0);
+
+  for (i = 0; i < oformat->number_of_fields; i++)
   {
-    if (strlen(state->oformat.format[i]) == 0)
-    {
-      break;
-    }
+    const splt_oformat_field *field = &oformat->fields[i];
+    char variable = field->variable;
 
-    //if we have some % in the format (@ has been converted to %)
-    if (state->oformat.format[i][0] == '%')
+    long mMsShH_value = -1;
+    int time_number_of_digits = 2;
+    int field_error = SPLT_OK;
+    switch (variable)
     {
-      //we allocate memory for the temp variable
-      if (temp)
-      {
-        free(temp);
-        temp = NULL;
-      }
-
-      int temp_len = strlen(state->oformat.format[i])+10;
-      if ((temp = malloc(temp_len * sizeof(char))) == NULL)
-      {
-        error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
-        goto end;
-      }
-      memset(temp, 0x0, temp_len);
-
-      temp[0] = '%';
-      temp[1] = 's';
-      char char_variable = state->oformat.format[i][1];
-      switch (char_variable)
-      {
-        case 's':
-          mMsShH_value = secs;
-          goto put_value;
-        case 'S':
-          mMsShH_value = next_secs;
-          goto put_value;
-        case 'm':
-          mMsShH_value = mins;
-          goto put_value;
-        case 'M':
-          mMsShH_value = next_mins;
-          goto put_value;
-        case 'h':
-          mMsShH_value = hundr;
-          goto put_value;
-        case 'H':
-          mMsShH_value = next_hundr;
+      case '\0':
+        field_error = splt_su_builder_append(filename, field->text, field->text_length);
+        break;
+      case 's':
+        mMsShH_value = secs;
+        goto put_value;
+      case 'S':
+        mMsShH_value = next_secs;
+        goto put_value;
+      case 'm':
+        mMsShH_value = mins;
+        goto put_value;
+      case 'M':
+        mMsShH_value = next_mins;
+        goto put_value;
+      case 'h':
+        mMsShH_value = hundr;
+        goto put_value;
+      case 'H':
+        mMsShH_value = next_hundr;
 put_value:
-          if (!eof_written)
-          {
-            if (write_eof &&
-                (char_variable == 'S' ||
-                 char_variable == 'M' ||
-                 char_variable == 'H'))
-            {
-              write_eof = SPLT_FALSE;
-              eof_written = SPLT_TRUE;
-
-              fm_length = 4;
-              if ((fm = malloc(fm_length * sizeof(char))) == NULL)
-              {
-                error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
-                goto end;
-              }
-              snprintf(fm, fm_length, "EOF");
-            }
-            else if (mMsShH_value != -1)
-            {
-              temp[1] = '0';
-              char number_of_digits = '2';
-              if (char_variable == 'M' || char_variable == 'm')
-              {
-                number_of_digits = splt_of_get_number_of_digits_from_total_time(state);
-              }
-              temp[2] = number_of_digits;
-              temp[3] = 'l';
-              temp[4] = 'd';
-
-              const char *format = NULL;
-              int offset = 5;
-
-              int number_of_digits_to_output = 0;
-              const char *new_format = 
-                splt_u_get_format_ptr(state->oformat.format[i], temp, &number_of_digits_to_output);
-
-              if (number_of_digits_to_output == 0 && mMsShH_value == 0)
-              {
-                const char *start_format = state->oformat.format[i] + 3;
-                format = splt_of_goto_last_non_separator_character(start_format);
-                offset = 0;
-
-                splt_of_trim_on_separator_characters(output_filename);
-              }
-              else
-              {
-                format = new_format + 2;
-              }
-
-              int requested_num_of_digits = 0;
-              int max_number_of_digits = splt_u_get_requested_num_of_digits(state,
-                  state->oformat.format[i], &requested_num_of_digits, SPLT_FALSE);
-
-              snprintf(temp + offset, temp_len, "%s", format);
-
-              fm_length = strlen(temp) + 1 + max_number_of_digits;
-              if ((fm = malloc(fm_length * sizeof(char))) == NULL)
-              {
-                error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
-                goto end;
-              }
-
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wformat-nonliteral"
-              snprintf(fm, fm_length, temp, mMsShH_value);
-#pragma GCC diagnostic pop
-            }
-          }
-          break;
-        case 'A':
-          if (splt_tu_tags_exists(state, tags_index))
-          {
-            artist_or_performer = splt_tu_get_tags_field(state,tags_index, SPLT_TAGS_PERFORMER);
-            if (artist_or_performer == NULL || artist_or_performer[0] == '\0')
-            {
-              artist_or_performer = splt_tu_get_tags_field(state, tags_index, SPLT_TAGS_ARTIST);
-            }
-          }
-          else
-          {
-            artist_or_performer = NULL;
-          }
-
-          //
-          if (artist_or_performer != NULL)
-          {
-            snprintf(temp+2,temp_len, "%s", state->oformat.format[i]+2);
-
-            int artist_length = 0;
-            artist_length = strlen(artist_or_performer);
-            fm_length = strlen(temp) + artist_length + 1;
-          }
-          else
-          {
-            snprintf(temp,temp_len, "%s", state->oformat.format[i]+2);
-            fm_length = strlen(temp) + 1;
-          }
-
-          if ((fm = malloc(fm_length * sizeof(char))) == NULL)
-          {
-            error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
-            goto end;
-          }
-
-          //
-          if (artist_or_performer != NULL)
-          {
-            char *dup = duplicate_and_clean(state, artist_or_performer, &error);
-            if (!dup) { goto end; }
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wformat-nonliteral"
-            snprintf(fm, fm_length, temp, dup);
-#pragma GCC diagnostic pop
-            free(dup);
-          }
-          else
-          {
-            snprintf(fm, fm_length, "%s", temp);
-          }
-
-          break;
-        case 'a':
-          if (splt_tu_tags_exists(state, tags_index))
-          {
-            artist = splt_tu_get_tags_field(state, tags_index, SPLT_TAGS_ARTIST);
-          }
-          else
-          {
-            artist = NULL;
-          }
-
-          //
-          if (artist != NULL)
-          {
-            snprintf(temp+2,temp_len, "%s", state->oformat.format[i]+2);
-
-            int artist_length = 0;
-            artist_length = strlen(artist);
-            fm_length = strlen(temp) + artist_length + 1;
-          }
-          else
-          {
-            snprintf(temp,temp_len, "%s", state->oformat.format[i]+2);
-            fm_length = strlen(temp) + 1;
-          }
-
-          if ((fm = malloc(fm_length * sizeof(char))) == NULL)
-          {
-            error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
-            goto end;
-          }
-
-          //
-          if (artist != NULL)
-          {
-            char *dup = duplicate_and_clean(state, artist, &error);
-            if (!dup) { goto end; }
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wformat-nonliteral"
-            snprintf(fm, fm_length, temp, dup);
-#pragma GCC diagnostic pop
-            free(dup);
-          }
-          else
-          {
-            snprintf(fm, fm_length, "%s", temp);
-          }
+        if (eof_written)
+        {
           break;
-        case 'b':
-          if (splt_tu_tags_exists(state,tags_index))
-          {
-            album = splt_tu_get_tags_field(state, tags_index, SPLT_TAGS_ALBUM);
-          }
-          else
-          {
-            album = NULL;
-          }
+        }
 
-          //
-          if (album != NULL)
-          {
-            int album_length = 0;
-            album_length = strlen(album);
-            snprintf(temp+2, temp_len, "%s", state->oformat.format[i]+2);
-
-            fm_length = strlen(temp) + album_length + 1;
-          }
-          else
-          {
-            snprintf(temp,temp_len, "%s", state->oformat.format[i]+2);
-            fm_length = strlen(temp) + 1;
-          }
-
-          if ((fm = malloc(fm_length * sizeof(char))) == NULL)
-          {
-            error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
-            goto end;
-          }
-
-          //
-          if (album != NULL)
-          {
-            char *dup = duplicate_and_clean(state, album, &error);
-            if (!dup) { goto end; }
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wformat-nonliteral"
-            snprintf(fm, fm_length, temp, dup);
-#pragma GCC diagnostic pop
-            free(dup);
-          }
-          else
-          {
-            snprintf(fm, fm_length, "%s", temp);
-          }
+        if (write_eof && (variable == 'S' || variable == 'M' || variable == 'H'))
+        {
+          write_eof = SPLT_FALSE;
+          eof_written = SPLT_TRUE;
+          field_error = splt_su_builder_append(filename, "EOF", 3);
           break;
-        case 'g':
-          if (splt_tu_tags_exists(state,tags_index))
-          {
-            genre = splt_tu_get_tags_field(state, tags_index, SPLT_TAGS_GENRE);
-          }
-          else
-          {
-            genre = NULL;
-          }
+        }
 
-          //
-          if (genre != NULL)
-          {
-            int genre_length = 0;
-            genre_length = strlen(genre);
-            snprintf(temp+2, temp_len, "%s", state->oformat.format[i]+2);
-
-            fm_length = strlen(temp) + genre_length + 1;
-          }
-          else
-          {
-            snprintf(temp,temp_len, "%s", state->oformat.format[i]+2);
-            fm_length = strlen(temp) + 1;
-          }
-
-          if ((fm = malloc(fm_length * sizeof(char))) == NULL)
-          {
-            error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
-            goto end;
-          }
-
-          //
-          if (genre != NULL)
-          {
-            char *dup = duplicate_and_clean(state, genre, &error);
-            if (!dup) { goto end; }
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wformat-nonliteral"
-            snprintf(fm, fm_length, temp, dup);
-#pragma GCC diagnostic pop
-            free(dup);
-          }
-          else
-          {
-            snprintf(fm, fm_length, "%s", temp);
-          }
+        if (mMsShH_value == -1)
+        {
           break;
-        case 't':
-          if (splt_tu_tags_exists(state,tags_index))
-          {
-            title = splt_tu_get_tags_field(state, tags_index, SPLT_TAGS_TITLE);
-          }
-          else
-          {
-            title = NULL;
-          }
-
-          //
-          if (title != NULL)
-          {
-            int title_length = 0;
-            title_length = strlen(title);
-            snprintf(temp+2, temp_len, "%s", state->oformat.format[i]+2);
-
-            fm_length = strlen(temp) + title_length + 1;
-          }
-          else
-          {
-            snprintf(temp,temp_len, "%s", state->oformat.format[i]+2);
-            fm_length = strlen(temp) + 1;
-          }
+        }
 
-          if ((fm = malloc(fm_length * sizeof(char))) == NULL)
-          {
-            error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
-            goto end;
-          }
-
-          //
-          if (title != NULL)
-          {
-            char *dup = duplicate_and_clean(state, title, &error);
-            if (!dup) { goto end; }
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wformat-nonliteral"
-            snprintf(fm, fm_length, temp, dup);
-#pragma GCC diagnostic pop
-            free(dup);
-          }
-          else
-          {
-            snprintf(fm, fm_length, "%s", temp);
-          }
+        if (field->number_after_variable == 0 && mMsShH_value == 0)
+        {
+          splt_of_trim_on_separator_characters(filename);
+          field_error = splt_su_builder_append(filename,
+              field->zero_value_text, field->zero_value_text_length);
           break;
-        case 'p':
-          if (splt_tu_tags_exists(state,tags_index))
-          {
-            performer = splt_tu_get_tags_field(state, tags_index, SPLT_TAGS_PERFORMER);
-          }
-          else
-          {
-            performer = NULL;
-          }
-
-          //
-          if (performer != NULL)
-          {
-            int performer_length = 0;
-            performer_length = strlen(performer);
-            snprintf(temp+2, temp_len, "%s", state->oformat.format[i]+2);
-
-            fm_length = strlen(temp) + performer_length + 1;
-          }
-          else
-          {
-            snprintf(temp,temp_len, "%s", state->oformat.format[i]+2);
-            fm_length = strlen(temp) + 1;
-          }
-
-          if ((fm = malloc(fm_length * sizeof(char))) == NULL)
-          {
-            error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
-            goto end;
-          }
-
-          if (performer != NULL)
-          {
-            char *dup = duplicate_and_clean(state, performer, &error);
-            if (!dup) { goto end; }
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wformat-nonliteral"
-            snprintf(fm, fm_length, temp, dup);
-#pragma GCC diagnostic pop
-            free(dup);
-          }
-          else
-          {
-            snprintf(fm, fm_length, "%s", temp);
-          }
-          break;
-        case 'l':
-        case 'L':
-        case 'u':
-        case 'U':
-        case 'n':
-        case 'N':
-          temp[1] = '0';
-          temp[2] = splt_of_get_oformat_number_of_digits_as_char(state);
-          temp[3] = 'd';
-
+        }
+
+        if (field->digits != -1)
+        {
+          time_number_of_digits = field->digits;
+        }
+        else if (variable == 'M' || variable == 'm')
+        {
+          if (minutes_number_of_digits == '\0')
+          {
+            minutes_number_of_digits = splt_of_get_number_of_digits_from_total_time(state);
+          }
+          time_number_of_digits = minutes_number_of_digits - '0';
+        }
+
+        field_error = splt_of_append_number(filename, time_number_of_digits, mMsShH_value);
+        if (field_error < 0) { break; }
+        field_error = splt_su_builder_append(filename, field->text, field->text_length);
+        break;
+      case 'A':
+      case 'a':
+      case 'b':
+      case 'g':
+      case 't':
+      case 'p':
+        {
+          const char *value = splt_of_get_tags_field_for_variable(state, tags_index, variable);
+          if (value != NULL)
+          {
+            field_error = splt_of_append_cleaned(state, filename, value);
+            if (field_error < 0) { break; }
+          }
+          field_error = splt_su_builder_append(filename, field->text, field->text_length);
+        }
+        break;
+      case 'l':
+      case 'L':
+      case 'u':
+      case 'U':
+      case 'n':
+      case 'N':
+        {
           int tracknumber = split_file_number;
-
-          //if not time split, or normal split, or silence split or error,
-          //we put the track number from the tags
-          int split_mode = splt_o_get_int_option(state,SPLT_OPT_SPLIT_MODE);
-          if ((isupper(state->oformat.format[i][1])) ||
-              ((split_mode != SPLT_OPTION_TIME_MODE) &&
-               (split_mode != SPLT_OPTION_NORMAL_MODE) &&
-               (split_mode != SPLT_OPTION_SILENCE_MODE) &&
-               (split_mode != SPLT_OPTION_TRIM_SILENCE_MODE) &&
-               (split_mode != SPLT_OPTION_ERROR_MODE) &&
-               (split_mode != SPLT_OPTION_LENGTH_MODE)))
+          if (isupper(variable) || track_from_tags)
           {
             if (splt_tu_tags_exists(state, tags_index))
             {
@@ -869,173 +644,85 @@ put_value:
             }
           }
 
-          int requested_num_of_digits = 0;
-          int max_num_of_digits = splt_u_get_requested_num_of_digits(state,
-              state->oformat.format[i], &requested_num_of_digits, SPLT_FALSE);
-
-          int alpha_requested_num_of_digits = 0;
-          int alpha_max_num_of_digits = splt_u_get_requested_num_of_digits(state,
-              state->oformat.format[i], &alpha_requested_num_of_digits, SPLT_TRUE);
-
-          int is_numeric = toupper(state->oformat.format[i][1]) == 'N';
-          if (is_numeric)
-          {
-            const char *format =
-              splt_u_get_format_ptr(state->oformat.format[i], temp, NULL);
-
-            snprintf(temp + 4, temp_len, "%s", format + 2);
-            fm_length = strlen(temp) + 1 + max_num_of_digits;
-          }
-          else
-          {
-            fm_length = strlen(state->oformat.format[i]) + 1 + alpha_max_num_of_digits;
-          }
-
-          if ((fm = malloc(fm_length * sizeof(char))) == NULL)
-          {
-            error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
-            goto end;
-          }
-          memset(fm, '\0', fm_length);
-
           if (tracknumber == -2)
           {
-#if 0
-            /* this is just a complicated no-op, fm is already nulled */
-            temp[1] = 's';
-            temp[2] = '%';
-            temp[3] = 's';
-            snprintf(fm, fm_length, temp, "", "");
-#endif
+            break;
           }
-          else
+
+          if (toupper(variable) == 'N')
           {
-            if (is_numeric)
-            {
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wformat-nonliteral"
-              snprintf(fm, fm_length, temp, tracknumber);
-#pragma GCC diagnostic pop
-            }
-            else
+            int number_of_digits = splt_of_get_oformat_number_of_digits_as_int(state);
+            if (field->digits != -1)
             {
-              splt_u_alpha_track(state, i, fm, fm_length,
-                  alpha_requested_num_of_digits, tracknumber);
+              number_of_digits = field->digits;
             }
+            field_error = splt_of_append_number(filename, number_of_digits, tracknumber);
           }
-          break;
-        case 'f':
-          if (splt_t_get_filename_to_split(state) != NULL)
+          else
           {
-            original_filename = strdup(splt_su_get_fname_without_path(splt_t_get_filename_to_split(state)));
-            if (original_filename)
-            {
-              snprintf(temp+2,temp_len, "%s", state->oformat.format[i]+2);
-
-              splt_su_cut_extension(original_filename);
-
-              int filename_length = strlen(original_filename);
-
-              fm_length = strlen(temp) + filename_length;
-              if ((fm = malloc(fm_length * sizeof(char))) == NULL)
-              {
-                error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
-                goto end;
-              }
-
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wformat-nonliteral"
-              snprintf(fm, fm_length, temp, original_filename);
-#pragma GCC diagnostic pop
-              free(original_filename);
-              original_filename = NULL;
-            }
-            else
+            int number_of_digits = oformat->output_alpha_format_digits;
+            if (field->digits != -1)
             {
-              error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
-              goto end;
+              number_of_digits = field->digits;
             }
+            field_error = splt_u_alpha_track(state, field, filename, number_of_digits, tracknumber);
           }
-          break;
-        case 'd':
-          {
-            char *last_dir = splt_su_get_last_dir_of_fname(splt_t_get_filename_to_split(state), &error);
-            if (error < 0) { goto end; }
 
-            if (last_dir)
-            {
-              snprintf(temp+2, temp_len, "%s", state->oformat.format[i]+2);
-
-              int last_dir_length = strlen(last_dir);
+          if (field_error < 0) { break; }
+          field_error = splt_su_builder_append(filename, field->text, field->text_length);
+        }
+        break;
+      case 'f':
+        {
+          const char *filename_to_split = splt_t_get_filename_to_split(state);
+          if (filename_to_split == NULL)
+          {
+            break;
+          }
 
-              fm_length = strlen(temp) + last_dir_length;
-              if ((fm = malloc(fm_length * sizeof(char))) == NULL)
-              {
-                error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
-                goto end;
-              }
+          size_t start = filename->length;
+          field_error = splt_su_builder_append_str(filename,
+              splt_su_get_fname_without_path(filename_to_split));
+          if (field_error < 0) { break; }
 
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wformat-nonliteral"
-              snprintf(fm, fm_length, temp, last_dir);
-#pragma GCC diagnostic pop
-              free(last_dir);
-              last_dir = NULL;
-            }
+          char *extension = strrchr(filename->str + start, '.');
+          if (extension)
+          {
+            splt_su_builder_truncate(filename, extension - filename->str);
           }
-          break;
-      }
-    }
-    else
-    {
-      fm_length = SPLT_MAXOLEN;
-      if ((fm = malloc(fm_length * sizeof(char))) == NULL)
-      {
-        error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
-        goto end;
-      }
 
-      strncpy(fm, state->oformat.format[i], SPLT_MAXOLEN);
-    }
+          field_error = splt_su_builder_append(filename, field->text, field->text_length);
+        }
+        break;
+      case 'd':
+        {
+          char *last_dir =
+            splt_su_get_last_dir_of_fname(splt_t_get_filename_to_split(state), &field_error);
+          if (field_error < 0) { break; }
 
-    int fm_size = 7;
-    if (fm != NULL)
-    {
-      fm_size = strlen(fm);
-    }
+          if (last_dir)
+          {
+            field_error = splt_su_builder_append(filename, last_dir, strlen(last_dir));
+            free(last_dir);
+            last_dir = NULL;
+            if (field_error < 0) { break; }
 
-    //allocate memory for the output filename
-    if (!output_filename)
-    {
-      if ((output_filename = malloc((1+fm_size)*sizeof(char))) == NULL)
-      {
-        error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
-        goto end;
-      }
-      output_filename_size = fm_size;
-      output_filename[0] = '\0';
-    }
-    else
-    {
-      output_filename_size += fm_size+1;
-      if ((output_filename = realloc(output_filename, output_filename_size * sizeof(char))) == NULL)
-      {
-        error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
-        goto end;
-      }
+            field_error = splt_su_builder_append(filename, field->text, field->text_length);
+          }
+        }
+        break;
     }
 
-    if (fm != NULL)
+    if (field_error < 0)
     {
-      strcat(output_filename, fm);
+      return field_error;
     }
+  }
 
-    //we free fm
-    if (fm)
-    {
-      free(fm);
-      fm = NULL;
-    }
+  const char *output_filename = NULL;
+  if (oformat->number_of_fields > 0)
+  {
+    output_filename = filename->str;
   }
 
   splt_d_print_debug(state,"The new output filename is _%s_\n", output_filename);
@@ -1043,54 +730,25 @@ put_value:
   int name_error = splt_sp_set_splitpoint_name(state, cur_splt, output_filename);
   if (name_error != SPLT_OK) { error = name_error; }
 
-end:
-  if (output_filename)
-  {
-    free(output_filename);
-    output_filename = NULL;
-  }
-  if (fm)
-  {
-    free(fm);
-    fm = NULL;
-  }
-  if (temp)
-  {
-    free(temp);
-    temp = NULL;
-  }
-
   return error;
 }
 
-static void splt_of_trim_on_separator_characters(char *filename)
+static void splt_of_trim_on_separator_characters(splt_string_builder *filename)
 {
-  if (!filename)
+  size_t length = filename->length;
+  while (length > 0)
   {
-    return;
-  }
-
-  int last_index = strlen(filename)-1;
-  if (last_index < 0)
-  {
-    return;
-  }
-
-  while (last_index >= 0)
-  {
-    char last_char = filename[last_index];
-    if (last_char == ':' || last_char == '_' ||
-        last_char == '-' || last_char == '.')
+    char last_char = filename->str[length - 1];
+    if (last_char != ':' && last_char != '_' &&
+        last_char != '-' && last_char != '.')
     {
-      filename[last_index] = '\0';
-    }
-    else
-    {
-      return;
+      break;
     }
 
-    last_index--;
+    length--;
   }
+
+  splt_su_builder_truncate(filename, length);
 }
 
 static const char *splt_of_goto_last_non_separator_character(const char *format)
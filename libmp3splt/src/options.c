@@ -79,6 +79,9 @@ void splt_o_set_options_default_values(splt_state *state)
   state->options.stop_if_no_auto_adjust_found = SPLT_FALSE;
   state->options.decode_and_write_flac_md5sum = SPLT_FALSE;
   state->options.handle_bit_reservoir = SPLT_FALSE;
+  state->options.freedb_timeout = SPLT_DEFAULT_FREEDB_TIMEOUT;
+  state->options.live_split_on_silence = SPLT_FALSE;
+  state->options.single_read_pass = SPLT_FALSE;
   state->options.id3v2_encoding = SPLT_ID3V2_UTF16;
   state->options.input_tags_encoding = SPLT_ID3V2_UTF8;
   state->options.time_minimum_length = 0;
@@ -157,6 +160,15 @@ void splt_o_set_option(splt_state *state, int option_name, const void *data)
     case SPLT_OPT_HANDLE_BIT_RESERVOIR:
       state->options.handle_bit_reservoir = *((int *)data);
       break;
+    case SPLT_OPT_FREEDB_TIMEOUT:
+      state->options.freedb_timeout = *((int *)data);
+      break;
+    case SPLT_OPT_LIVE_SPLIT_ON_SILENCE:
+      state->options.live_split_on_silence = *((int *)data);
+      break;
+    case SPLT_OPT_SINGLE_READ_PASS:
+      state->options.single_read_pass = *((int *)data);
+      break;
     case SPLT_OPT_ID3V2_ENCODING:
       state->options.id3v2_encoding = *((int *) data);
       break;
@@ -295,6 +307,12 @@ static void *splt_o_get_option(splt_state *state, int option_name)
       return &state->options.decode_and_write_flac_md5sum;
     case SPLT_OPT_HANDLE_BIT_RESERVOIR:
       return &state->options.handle_bit_reservoir;
+    case SPLT_OPT_FREEDB_TIMEOUT:
+      return &state->options.freedb_timeout;
+    case SPLT_OPT_LIVE_SPLIT_ON_SILENCE:
+      return &state->options.live_split_on_silence;
+    case SPLT_OPT_SINGLE_READ_PASS:
+      return &state->options.single_read_pass;
     case SPLT_OPT_ID3V2_ENCODING:
       return &state->options.id3v2_encoding;
     case SPLT_OPT_INPUT_TAGS_ENCODING:
@@ -43,6 +43,9 @@ int splt_of_set_default_values(splt_state *state)
   int err = SPLT_OK;
 
   state->oformat.format_string = NULL;
+  state->oformat.number_of_fields = 0;
+  state->oformat.is_default_output = SPLT_FALSE;
+  splt_su_builder_init(&state->oformat.filename);
   splt_of_set_oformat(state, SPLT_DEFAULT_CDDB_CUE_OUTPUT, &err, SPLT_TRUE);
 
   return err;
@@ -57,6 +60,9 @@ void splt_of_free_oformat(splt_state *state)
     free(oformat->format_string);
     oformat->format_string = NULL;
   }
+
+  splt_su_builder_free(&oformat->filename);
+  oformat->number_of_fields = 0;
 }
 
 void splt_of_set_oformat_digits_tracks(splt_state *state, int tracks)
@@ -0,0 +1,688 @@
+/**********************************************************
+ *
+ * libmp3splt -- library based on mp3splt,
+ *               for mp3/ogg splitting without decoding
+ *
+ * Copyright (c) 2002-2005 M. Trotta - <mtrotta@users.sourceforge.net>
+ * Copyright (c) 2005-2014 Alexandru Munteanu - m@ioalex.net
+ *
+ * http://mp3splt.sourceforge.net
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ *********************************************************/
+
+/*! \file
+
+Output sinks receiving the output files instead of the file system
+
+The plugins write their output files with the stdio functions, seeking back
+to update the mp3 Xing or the flac streaminfo headers. When a sink is set,
+the FILE returned by splt_os_fopen is a custom stream forwarding the writes
+and the seeks to the sink callbacks. When the sink cannot seek, the whole
+file is kept in memory and written at once when closed.
+
+The plugins close their output files with splt_os_fclose, telling the sink
+if the split of the file failed or was cancelled.
+*/
+
+#define _GNU_SOURCE
+
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "splt.h"
+
+#if defined(__GLIBC__)
+#define SPLT_OS_FOPENCOOKIE
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__NetBSD__) || \
+  defined(__OpenBSD__) || defined(__DragonFly__)
+#define SPLT_OS_FUNOPEN
+#endif
+
+//! Minimum size allocated for the bytes of an output file kept in memory
+#define SPLT_OS_BUFFER_MIN_SIZE 65536
+
+//! Bytes of an output file kept in memory
+typedef struct {
+  unsigned char *bytes;
+  size_t size;
+  size_t allocated_size;
+  size_t position;
+} splt_os_buffer;
+
+//! Output file written through a sink
+typedef struct {
+  splt_state *state;
+  splt_output_sink sink;
+  void *handle;
+  //! SPLT_TRUE when the sink cannot seek and the file is kept in #buffer until closed
+  int staged;
+  splt_os_buffer buffer;
+  //! position and size of a file written directly to the sink
+  off_t position;
+  off_t size;
+} splt_os_output;
+
+static void splt_os_buffer_init(splt_os_buffer *buffer)
+{
+  buffer->bytes = NULL;
+  buffer->size = 0;
+  buffer->allocated_size = 0;
+  buffer->position = 0;
+}
+
+//! Writes at the current position; a gap after the end is filled with zeros
+static int splt_os_buffer_write(splt_os_buffer *buffer, const void *ptr, size_t size)
+{
+  size_t end = buffer->position + size;
+  if (end > buffer->allocated_size)
+  {
+    size_t allocated_size = buffer->allocated_size * 2;
+    if (allocated_size < end) { allocated_size = end; }
+    if (allocated_size < SPLT_OS_BUFFER_MIN_SIZE) { allocated_size = SPLT_OS_BUFFER_MIN_SIZE; }
+
+    unsigned char *bytes = realloc(buffer->bytes, allocated_size);
+    if (bytes == NULL)
+    {
+      return SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+    }
+
+    buffer->bytes = bytes;
+    buffer->allocated_size = allocated_size;
+  }
+
+  if (buffer->position > buffer->size)
+  {
+    memset(buffer->bytes + buffer->size, 0, buffer->position - buffer->size);
+  }
+
+  memcpy(buffer->bytes + buffer->position, ptr, size);
+  buffer->position = end;
+  if (end > buffer->size)
+  {
+    buffer->size = end;
+  }
+
+  return SPLT_OK;
+}
+
+static size_t splt_os_buffer_read(splt_os_buffer *buffer, void *ptr, size_t size)
+{
+  if (buffer->position >= buffer->size)
+  {
+    return 0;
+  }
+
+  size_t available = buffer->size - buffer->position;
+  if (size > available) { size = available; }
+
+  memcpy(ptr, buffer->bytes + buffer->position, size);
+  buffer->position += size;
+
+  return size;
+}
+
+static void splt_os_buffer_free(splt_os_buffer *buffer)
+{
+  if (buffer->bytes)
+  {
+    free(buffer->bytes);
+  }
+  splt_os_buffer_init(buffer);
+}
+
+static long splt_os_write(splt_os_output *output, const char *ptr, size_t size)
+{
+  if (output->staged)
+  {
+    if (splt_os_buffer_write(&output->buffer, ptr, size) < 0)
+    {
+      errno = ENOMEM;
+      return -1;
+    }
+
+    return (long) size;
+  }
+
+  size_t written = output->sink.write(output->handle, ptr, size, output->sink.cb_data);
+  output->position += (off_t) written;
+  if (output->position > output->size)
+  {
+    output->size = output->position;
+  }
+
+  if (written == 0 && size > 0)
+  {
+    errno = EIO;
+    return -1;
+  }
+
+  return (long) written;
+}
+
+//! Only the files kept in memory can be read back
+static long splt_os_read(splt_os_output *output, char *ptr, size_t size)
+{
+  if (!output->staged)
+  {
+    return 0;
+  }
+
+  return (long) splt_os_buffer_read(&output->buffer, ptr, size);
+}
+
+static int splt_os_seek(splt_os_output *output, off_t *offset, int whence)
+{
+  off_t position = *offset;
+  if (whence == SEEK_CUR)
+  {
+    position += output->staged ? (off_t) output->buffer.position : output->position;
+  }
+  else if (whence == SEEK_END)
+  {
+    position += output->staged ? (off_t) output->buffer.size : output->size;
+  }
+
+  if (position < 0)
+  {
+    errno = EINVAL;
+    return -1;
+  }
+
+  if (output->staged)
+  {
+    output->buffer.position = (size_t) position;
+  }
+  else
+  {
+    if ((position != output->position) &&
+        (output->sink.seek(output->handle, position, output->sink.cb_data) != 0))
+    {
+      errno = ESPIPE;
+      return -1;
+    }
+    output->position = position;
+  }
+
+  *offset = position;
+
+  return 0;
+}
+
+//! An incomplete file kept in memory is not written to the sink
+static int splt_os_close(splt_os_output *output)
+{
+  int failed = SPLT_FALSE;
+  int complete = output->state->split.output_file_complete;
+
+  if (complete && output->staged && output->buffer.size > 0)
+  {
+    size_t written = output->sink.write(output->handle, output->buffer.bytes,
+        output->buffer.size, output->sink.cb_data);
+    failed = written < output->buffer.size;
+  }
+
+  if (output->sink.close(output->handle, complete, output->sink.cb_data) != 0)
+  {
+    failed = SPLT_TRUE;
+  }
+
+  splt_os_buffer_free(&output->buffer);
+  free(output);
+
+  if (failed)
+  {
+    errno = EIO;
+    return EOF;
+  }
+
+  return 0;
+}
+
+#ifdef SPLT_OS_FOPENCOOKIE
+static ssize_t splt_os_cookie_read(void *cookie, char *buf, size_t size)
+{
+  return (ssize_t) splt_os_read(cookie, buf, size);
+}
+
+static ssize_t splt_os_cookie_write(void *cookie, const char *buf, size_t size)
+{
+  return (ssize_t) splt_os_write(cookie, buf, size);
+}
+
+static int splt_os_cookie_seek(void *cookie, off64_t *offset, int whence)
+{
+  off_t position = (off_t) *offset;
+  int result = splt_os_seek(cookie, &position, whence);
+  *offset = (off64_t) position;
+  return result;
+}
+
+static int splt_os_cookie_close(void *cookie)
+{
+  return splt_os_close(cookie);
+}
+#endif
+
+#ifdef SPLT_OS_FUNOPEN
+static int splt_os_funopen_read(void *cookie, char *buf, int size)
+{
+  return (int) splt_os_read(cookie, buf, (size_t) size);
+}
+
+static int splt_os_funopen_write(void *cookie, const char *buf, int size)
+{
+  return (int) splt_os_write(cookie, buf, (size_t) size);
+}
+
+static fpos_t splt_os_funopen_seek(void *cookie, fpos_t offset, int whence)
+{
+  off_t position = (off_t) offset;
+  if (splt_os_seek(cookie, &position, whence) != 0)
+  {
+    return -1;
+  }
+  return (fpos_t) position;
+}
+
+static int splt_os_funopen_close(void *cookie)
+{
+  return splt_os_close(cookie);
+}
+#endif
+
+/*! Opens an output file
+
+\param[in] mode Mode of the file when no sink is set; a file written through
+the sink can always be written and read
+\return The output file, written through the sink when one is set, or NULL
+with errno set on error
+*/
+FILE *splt_os_fopen(splt_state *state, const char *filename, const char *mode)
+{
+#if defined(SPLT_OS_FOPENCOOKIE) || defined(SPLT_OS_FUNOPEN)
+  if (state->split.use_output_sink)
+  {
+    splt_os_output *output = malloc(sizeof(splt_os_output));
+    if (output == NULL)
+    {
+      errno = ENOMEM;
+      return NULL;
+    }
+
+    output->state = state;
+    output->sink = state->split.output_sink;
+    output->staged = (output->sink.seek == NULL);
+    splt_os_buffer_init(&output->buffer);
+    output->position = 0;
+    output->size = 0;
+
+    errno = 0;
+    output->handle = output->sink.open(filename, output->sink.cb_data);
+    if (output->handle == NULL)
+    {
+      free(output);
+      if (errno == 0) { errno = EIO; }
+      return NULL;
+    }
+
+#ifdef SPLT_OS_FOPENCOOKIE
+    cookie_io_functions_t functions = {
+      splt_os_cookie_read, splt_os_cookie_write, splt_os_cookie_seek, splt_os_cookie_close
+    };
+    FILE *file = fopencookie(output, "wb+", functions);
+#else
+    FILE *file = funopen(output, splt_os_funopen_read, splt_os_funopen_write,
+        splt_os_funopen_seek, splt_os_funopen_close);
+#endif
+    if (file == NULL)
+    {
+      output->sink.close(output->handle, SPLT_FALSE, output->sink.cb_data);
+      free(output);
+    }
+
+    return file;
+  }
+#endif
+
+  return splt_io_fopen(filename, mode);
+}
+
+/*! Closes an output file opened with splt_os_fopen
+
+\param[in] complete SPLT_FALSE when the split of the file failed or was
+cancelled: the temporary file sink then keeps the '.part' file, and the
+memory and file descriptor sinks drop the file
+\return 0 on success, or EOF with errno set as fclose
+*/
+int splt_os_fclose(splt_state *state, FILE *file, int complete)
+{
+  state->split.output_file_complete = complete;
+  int result = fclose(file);
+  state->split.output_file_complete = SPLT_TRUE;
+
+  return result;
+}
+
+int splt_os_set_sink(splt_state *state, const splt_output_sink *sink)
+{
+  if (sink == NULL)
+  {
+    state->split.use_output_sink = SPLT_FALSE;
+    return SPLT_OK;
+  }
+
+#if defined(SPLT_OS_FOPENCOOKIE) || defined(SPLT_OS_FUNOPEN)
+  if (sink->open == NULL || sink->write == NULL || sink->close == NULL)
+  {
+    return SPLT_ERROR_INVALID;
+  }
+
+  state->split.output_sink = *sink;
+  state->split.use_output_sink = SPLT_TRUE;
+
+  return SPLT_OK;
+#else
+  return SPLT_ERROR_OUTPUT_SINK_NOT_SUPPORTED;
+#endif
+}
+
+/****************************/
+/* built-in memory sink */
+
+typedef struct {
+  char *filename;
+  splt_os_buffer buffer;
+} splt_os_memory_file;
+
+static void splt_os_memory_file_free(splt_os_memory_file *memory_file)
+{
+  splt_os_buffer_free(&memory_file->buffer);
+  free(memory_file->filename);
+  free(memory_file);
+}
+
+static void *splt_os_memory_open(const char *filename, void *cb_data)
+{
+  splt_os_memory_file *memory_file = malloc(sizeof(splt_os_memory_file));
+  if (memory_file == NULL)
+  {
+    return NULL;
+  }
+
+  memory_file->filename = NULL;
+  if (splt_su_copy(filename, &memory_file->filename) < 0)
+  {
+    free(memory_file);
+    return NULL;
+  }
+  splt_os_buffer_init(&memory_file->buffer);
+
+  return memory_file;
+}
+
+static size_t splt_os_memory_write(void *handle, const void *ptr, size_t size, void *cb_data)
+{
+  splt_os_memory_file *memory_file = handle;
+  if (splt_os_buffer_write(&memory_file->buffer, ptr, size) < 0)
+  {
+    return 0;
+  }
+
+  return size;
+}
+
+static int splt_os_memory_seek(void *handle, off_t offset, void *cb_data)
+{
+  splt_os_memory_file *memory_file = handle;
+  memory_file->buffer.position = (size_t) offset;
+  return 0;
+}
+
+static int splt_os_memory_close(void *handle, int complete, void *cb_data)
+{
+  splt_state *state = cb_data;
+  splt_os_memory_file *memory_file = handle;
+
+  if (complete && state->split.memory_sink_file_done)
+  {
+    state->split.memory_sink_file_done(memory_file->filename, memory_file->buffer.bytes,
+        memory_file->buffer.size, state->split.memory_sink_cb_data);
+  }
+
+  splt_os_memory_file_free(memory_file);
+
+  return 0;
+}
+
+int splt_os_set_memory_sink(splt_state *state,
+    void (*file_done)(const char *filename, const unsigned char *bytes, size_t size, void *cb_data),
+    void *cb_data)
+{
+  splt_output_sink sink = {
+    splt_os_memory_open, splt_os_memory_write, splt_os_memory_seek, splt_os_memory_close, state
+  };
+
+  int error = splt_os_set_sink(state, &sink);
+  if (error < 0) { return error; }
+
+  state->split.memory_sink_file_done = file_done;
+  state->split.memory_sink_cb_data = cb_data;
+
+  return SPLT_OK;
+}
+
+/****************************/
+/* built-in file descriptor sink */
+
+//! Size of the header written before each file: filename length and file size
+#define SPLT_OS_FD_HEADER_SIZE 12
+
+static int splt_os_fd_write_all(int fd, const void *ptr, size_t size)
+{
+  const char *bytes = ptr;
+
+  size_t written = 0;
+  while (written < size)
+  {
+    ssize_t result = write(fd, bytes + written, size - written);
+    if (result < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if (result <= 0)
+    {
+      return -1;
+    }
+
+    written += (size_t) result;
+  }
+
+  return 0;
+}
+
+/*! Writes a complete file after its header
+
+The header has the length of the filename on 4 bytes and the size of the
+file on 8 bytes, both in big endian, and is followed by the filename.
+*/
+static int splt_os_fd_write_file(int fd, splt_os_memory_file *memory_file)
+{
+  unsigned long filename_length = (unsigned long) strlen(memory_file->filename);
+  unsigned long long size = (unsigned long long) memory_file->buffer.size;
+
+  unsigned char header[SPLT_OS_FD_HEADER_SIZE];
+  int i = 0;
+  for (i = 0;i < 4;i++)
+  {
+    header[i] = (unsigned char) ((filename_length >> (8 * (3 - i))) & 0xFF);
+  }
+  for (i = 0;i < 8;i++)
+  {
+    header[4 + i] = (unsigned char) ((size >> (8 * (7 - i))) & 0xFF);
+  }
+
+  if ((splt_os_fd_write_all(fd, header, SPLT_OS_FD_HEADER_SIZE) != 0) ||
+      (splt_os_fd_write_all(fd, memory_file->filename, filename_length) != 0) ||
+      (splt_os_fd_write_all(fd, memory_file->buffer.bytes, memory_file->buffer.size) != 0))
+  {
+    return -1;
+  }
+
+  return 0;
+}
+
+/*! The file descriptor belongs to the client and stays opened
+
+The file is kept in memory until closed, to write its size before it; an
+incomplete file is not written.
+*/
+static int splt_os_fd_close(void *handle, int complete, void *cb_data)
+{
+  splt_state *state = cb_data;
+  splt_os_memory_file *memory_file = handle;
+
+  int result = 0;
+  if (complete)
+  {
+    result = splt_os_fd_write_file(state->split.fd_sink, memory_file);
+  }
+
+  splt_os_memory_file_free(memory_file);
+
+  return result;
+}
+
+int splt_os_set_fd_sink(splt_state *state, int fd)
+{
+  if (fd < 0)
+  {
+    return SPLT_ERROR_INVALID;
+  }
+
+  splt_output_sink sink = {
+    splt_os_memory_open, splt_os_memory_write, splt_os_memory_seek, splt_os_fd_close, state
+  };
+
+  int error = splt_os_set_sink(state, &sink);
+  if (error < 0) { return error; }
+
+  state->split.fd_sink = fd;
+
+  return SPLT_OK;
+}
+
+/****************************/
+/* built-in temporary file sink */
+
+typedef struct {
+  FILE *file;
+  char *filename;
+  char *temporary_filename;
+} splt_os_temporary_file;
+
+static void splt_os_temporary_file_free(splt_os_temporary_file *temporary_file)
+{
+  if (temporary_file->filename)
+  {
+    free(temporary_file->filename);
+  }
+  if (temporary_file->temporary_filename)
+  {
+    free(temporary_file->temporary_filename);
+  }
+  free(temporary_file);
+}
+
+static void *splt_os_temporary_file_open(const char *filename, void *cb_data)
+{
+  splt_os_temporary_file *temporary_file = malloc(sizeof(splt_os_temporary_file));
+  if (temporary_file == NULL)
+  {
+    return NULL;
+  }
+
+  temporary_file->file = NULL;
+  temporary_file->filename = NULL;
+  temporary_file->temporary_filename = NULL;
+
+  if ((splt_su_copy(filename, &temporary_file->filename) < 0) ||
+      (splt_su_copy(filename, &temporary_file->temporary_filename) < 0) ||
+      (splt_su_append(&temporary_file->temporary_filename, ".part", strlen(".part"), NULL) < 0))
+  {
+    splt_os_temporary_file_free(temporary_file);
+    return NULL;
+  }
+
+  temporary_file->file = splt_io_fopen(temporary_file->temporary_filename, "wb+");
+  if (temporary_file->file == NULL)
+  {
+    splt_os_temporary_file_free(temporary_file);
+    return NULL;
+  }
+
+  return temporary_file;
+}
+
+static size_t splt_os_temporary_file_write(void *handle, const void *ptr, size_t size,
+    void *cb_data)
+{
+  splt_os_temporary_file *temporary_file = handle;
+  return fwrite(ptr, 1, size, temporary_file->file);
+}
+
+static int splt_os_temporary_file_seek(void *handle, off_t offset, void *cb_data)
+{
+  splt_os_temporary_file *temporary_file = handle;
+  return fseeko(temporary_file->file, offset, SEEK_SET);
+}
+
+//! An incomplete file is kept with its temporary name
+static int splt_os_temporary_file_close(void *handle, int complete, void *cb_data)
+{
+  splt_state *state = cb_data;
+  splt_os_temporary_file *temporary_file = handle;
+
+  int result = fclose(temporary_file->file);
+  if (result == 0 && complete &&
+      splt_io_sync_and_rename(state, temporary_file->temporary_filename,
+        temporary_file->filename) < 0)
+  {
+    result = -1;
+  }
+
+  splt_os_temporary_file_free(temporary_file);
+
+  return result;
+}
+
+int splt_os_set_temporary_file_sink(splt_state *state)
+{
+  splt_output_sink sink = {
+    splt_os_temporary_file_open, splt_os_temporary_file_write,
+    splt_os_temporary_file_seek, splt_os_temporary_file_close, state
+  };
+
+  return splt_os_set_sink(state, &sink);
+}
+
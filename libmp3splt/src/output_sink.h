@@ -0,0 +1,47 @@
+/**********************************************************
+ *
+ * libmp3splt -- library based on mp3splt,
+ *               for mp3/ogg splitting without decoding
+ *
+ * Copyright (c) 2002-2005 M. Trotta - <mtrotta@users.sourceforge.net>
+ * Copyright (c) 2005-2014 Alexandru Munteanu - m@ioalex.net
+ *
+ * http://mp3splt.sourceforge.net
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ *********************************************************/
+
+#ifndef SPLT_OUTPUT_SINK_H
+
+int splt_os_set_sink(splt_state *state, const splt_output_sink *sink);
+int splt_os_set_memory_sink(splt_state *state,
+    void (*file_done)(const char *filename, const unsigned char *bytes, size_t size, void *cb_data),
+    void *cb_data);
+int splt_os_set_fd_sink(splt_state *state, int fd);
+int splt_os_set_temporary_file_sink(splt_state *state);
+
+FILE *splt_os_fopen(splt_state *state, const char *filename, const char *mode);
+int splt_os_fclose(splt_state *state, FILE *file, int complete);
+
+#define SPLT_OUTPUT_SINK_H
+
+#endif
+
@@ -42,11 +42,36 @@ Loading and unloading of plug-ins
 
 #ifdef __WIN32__
 #include <direct.h>
+#else
+#include <unistd.h>
 #endif
 
 #include "splt.h"
 #include "plugins.h"
 
+/*! Process-wide plugins registry
+
+The plugins data found by the first state is kept here and is shared
+by all the next states scanning the same directories: they don't need
+to scan the directories, lt_dlopen the plugins and resolve the
+symbols again.\n
+The registry is reference counted by the states using it; the data is
+kept after the last state is freed, until #mp3splt_free_plugins_cache
+is called.\n
+The registry and all the libltdl calls are protected by #SPLT_LOCK_PLUGINS.
+*/
+typedef struct {
+  //!scan directories and working directory the plugins were found with
+  char *key;
+  //!number of states currently using the registry data
+  int references;
+  int number_of_plugins_found;
+  splt_plugin_data *data;
+} splt_plugins_registry;
+
+static splt_plugins_registry splt_p_registry = { NULL, 0, 0, NULL };
+
+
 int splt_p_append_plugin_scan_dir(splt_state *state, const char *dir)
 {
   if (dir == NULL)
@@ -583,10 +608,166 @@ static int splt_p_open_get_valid_plugins(splt_state *state)
   return error;
 }
 
+//the registry key: the working directory followed by all the scan
+//directories, because './' is one of the default scan directories
+static char *splt_p_build_registry_key(splt_state *state, int *error)
+{
+  splt_plugins *pl = state->plug;
+
+  char *key = NULL;
+  char current_directory[2048] = { '\0' };
+  if (getcwd(current_directory, sizeof(current_directory)) == NULL)
+  {
+    current_directory[0] = '\0';
+  }
+
+  int err = splt_su_copy(current_directory, &key);
+  if (err < 0) { *error = err; return NULL; }
+
+  int i = 0;
+  for (i = 0;i < pl->number_of_dirs_to_scan;i++)
+  {
+    if (pl->plugins_scan_dirs[i] == NULL)
+    {
+      continue;
+    }
+
+    err = splt_su_append_str(&key, "\n", pl->plugins_scan_dirs[i], NULL);
+    if (err < 0)
+    {
+      *error = err;
+      free(key);
+      return NULL;
+    }
+  }
+
+  return key;
+}
+
+static void splt_p_free_registry_data()
+{
+  int i = 0;
+  for (i = 0;i < splt_p_registry.number_of_plugins_found;i++)
+  {
+    splt_p_free_plugin_data(&splt_p_registry.data[i]);
+  }
+
+  if (splt_p_registry.data)
+  {
+    free(splt_p_registry.data);
+    splt_p_registry.data = NULL;
+  }
+  splt_p_registry.number_of_plugins_found = 0;
+
+  if (splt_p_registry.key)
+  {
+    free(splt_p_registry.key);
+    splt_p_registry.key = NULL;
+  }
+}
+
+//uses the registry data if it was found with the same key
+//-must be called with SPLT_LOCK_PLUGINS held
+static int splt_p_use_registry(splt_state *state, const char *key)
+{
+  if (splt_p_registry.key == NULL || strcmp(splt_p_registry.key, key) != 0)
+  {
+    return SPLT_FALSE;
+  }
+
+  splt_plugins *pl = state->plug;
+  pl->data = splt_p_registry.data;
+  pl->number_of_plugins_found = splt_p_registry.number_of_plugins_found;
+  pl->uses_registry = SPLT_TRUE;
+  splt_p_registry.references++;
+
+  return SPLT_TRUE;
+}
+
+//gives the plugins data of the state to the registry if nobody uses the
+//registry; the state becomes a user of the registry
+//-must be called with SPLT_LOCK_PLUGINS held
+static void splt_p_publish_to_registry(splt_state *state, char *key)
+{
+  if (splt_p_registry.references > 0)
+  {
+    free(key);
+    return;
+  }
+
+  splt_p_free_registry_data();
+
+  splt_plugins *pl = state->plug;
+  splt_p_registry.key = key;
+  splt_p_registry.data = pl->data;
+  splt_p_registry.number_of_plugins_found = pl->number_of_plugins_found;
+  splt_p_registry.references = 1;
+  pl->uses_registry = SPLT_TRUE;
+}
+
+static int splt_p_find_open_plugins(splt_state *state);
+
 //main plugin function which finds the plugins and gets out the plugin data
 //-returns possible error
 //-for the moment should only be called once
 int splt_p_find_get_plugins_data(splt_state *state)
+{
+  int error = SPLT_OK;
+
+  if (state->plug->uses_registry)
+  {
+    return SPLT_OK;
+  }
+
+  char *key = splt_p_build_registry_key(state, &error);
+  if (error < 0) { return error; }
+
+  splt_lk_lock(SPLT_LOCK_PLUGINS);
+
+  if (splt_p_use_registry(state, key))
+  {
+    splt_lk_unlock(SPLT_LOCK_PLUGINS);
+
+    splt_d_print_debug(state,"\nUsing the %d plugins from the plugins registry\n",
+        state->plug->number_of_plugins_found);
+    free(key);
+    return SPLT_OK;
+  }
+
+  error = splt_p_find_open_plugins(state);
+  if (error < 0)
+  {
+    free(key);
+  }
+  else
+  {
+    splt_p_publish_to_registry(state, key);
+  }
+
+  splt_lk_unlock(SPLT_LOCK_PLUGINS);
+
+  return error;
+}
+
+int splt_p_free_registry()
+{
+  int error = SPLT_OK;
+
+  splt_lk_lock(SPLT_LOCK_PLUGINS);
+  if (splt_p_registry.references > 0)
+  {
+    error = SPLT_ERROR_LIBRARY_LOCKED;
+  }
+  else
+  {
+    splt_p_free_registry_data();
+  }
+  splt_lk_unlock(SPLT_LOCK_PLUGINS);
+
+  return error;
+}
+
+static int splt_p_find_open_plugins(splt_state *state)
 {
   int return_value = SPLT_OK;
 
@@ -621,6 +802,10 @@ int splt_p_find_get_plugins_data(splt_state *state)
         lt_dlsym(pl->data[i].plugin_handle, "splt_pl_search_syncerrors");
       pl->data[i].func->splt_pl_import_internal_sheets =
         lt_dlsym(pl->data[i].plugin_handle, "splt_pl_import_internal_sheets");
+      pl->data[i].func->splt_pl_import_internal_sheets_plan =
+        lt_dlsym(pl->data[i].plugin_handle, "splt_pl_import_internal_sheets_plan");
+      pl->data[i].func->splt_pl_split_segments =
+        lt_dlsym(pl->data[i].plugin_handle, "splt_pl_split_segments");
       pl->data[i].func->splt_pl_dewrap =
         lt_dlsym(pl->data[i].plugin_handle, "splt_pl_dewrap");
       pl->data[i].func->splt_pl_offset_split =
@@ -819,6 +1004,34 @@ void splt_p_import_internal_sheets(splt_state *state, splt_code *error)
   pl->data[current_plugin].func->splt_pl_import_internal_sheets(state, error);
 }
 
+//! Import the internal sheets of \p filename with the first plugin handling it
+void splt_p_import_internal_sheets_plan(splt_state *state, const char *filename,
+    splt_code *error)
+{
+  splt_plugins *pl = state->plug;
+
+  int i = 0;
+  for (i = 0;i < pl->number_of_plugins_found;i++)
+  {
+    if (pl->data[i].func->splt_pl_import_internal_sheets_plan == NULL)
+    {
+      continue;
+    }
+
+    if (pl->data[i].func->splt_pl_import_internal_sheets_plan(state, filename, error))
+    {
+      return;
+    }
+
+    if (*error < 0)
+    {
+      return;
+    }
+  }
+
+  *error = SPLT_ERROR_NO_PLUGIN_FOUND;
+}
+
 double splt_p_split(splt_state *state, const char *final_fname, double begin_point,
     double end_point, int *error, int save_end_point)
 {
@@ -856,6 +1069,27 @@ double splt_p_split(splt_state *state, const char *final_fname, double begin_poi
   return end_point;
 }
 
+/*! Split the segments of \p plan in a single read pass of the input file
+
+\return SPLT_FALSE if the current plugin cannot split them in a single read pass
+*/
+int splt_p_split_segments(splt_state *state, splt_segment_plan *plan, int *error)
+{
+  splt_plugins *pl = state->plug;
+  int current_plugin = splt_p_get_current_plugin(state);
+  if ((current_plugin < 0) || (current_plugin >= pl->number_of_plugins_found))
+  {
+    return SPLT_FALSE;
+  }
+
+  if (pl->data[current_plugin].func->splt_pl_split_segments == NULL)
+  {
+    return SPLT_FALSE;
+  }
+
+  return pl->data[current_plugin].func->splt_pl_split_segments(state, plan, error);
+}
+
 void splt_p_init(splt_state *state, int *error)
 {
   splt_plugins *pl = state->plug;
@@ -1054,6 +1288,7 @@ int splt_p_set_default_values(splt_state *state)
   state->plug->number_of_plugins_found = 0;
   state->plug->data = NULL;
   state->plug->number_of_dirs_to_scan = 0;
+  state->plug->uses_registry = SPLT_FALSE;
 
   return splt_p_set_default_plugins_scan_dirs(state);
 }
@@ -1077,7 +1312,16 @@ void splt_p_free_plugins(splt_state *state)
     pl->plugins_scan_dirs = NULL;
     pl->number_of_dirs_to_scan = 0;
   }
-  if (pl->data)
+  splt_lk_lock(SPLT_LOCK_PLUGINS);
+  if (pl->uses_registry)
+  {
+    splt_p_registry.references--;
+
+    pl->data = NULL;
+    pl->number_of_plugins_found = 0;
+    pl->uses_registry = SPLT_FALSE;
+  }
+  else if (pl->data)
   {
     for (i = 0;i < pl->number_of_plugins_found;i++)
     {
@@ -1087,6 +1331,7 @@ void splt_p_free_plugins(splt_state *state)
     pl->data = NULL;
     pl->number_of_plugins_found = 0;
   }
+  splt_lk_unlock(SPLT_LOCK_PLUGINS);
 }
 
 void splt_p_set_current_plugin(splt_state *state, int current_plugin)
@@ -39,8 +39,11 @@ int splt_p_check_plugin_is_for_file(splt_state *state, int *error);
 void splt_p_search_syncerrors(splt_state *state, int *error);
 void splt_p_dewrap(splt_state *state, int listonly, const char *dir, int *error);
 void splt_p_import_internal_sheets(splt_state *state, splt_code *error);
+void splt_p_import_internal_sheets_plan(splt_state *state, const char *filename,
+    splt_code *error);
 double splt_p_split(splt_state *state, const char *final_fname, double begin_point,
     double end_point, int *error, int save_end_point);
+int splt_p_split_segments(splt_state *state, splt_segment_plan *plan, int *error);
 int splt_p_simple_split(splt_state *state, const char *output_fname, off_t begin,
     off_t end);
 int splt_p_scan_silence(splt_state *state, int *error);
@@ -49,6 +52,7 @@ void splt_p_set_original_tags(splt_state *state, int *error);
 void splt_p_clear_original_tags(splt_state *state, int *error);
 
 int splt_p_find_get_plugins_data(splt_state *state);
+int splt_p_free_registry();
 int splt_p_append_plugin_scan_dir(splt_state *state, const char *dir);
 
 void splt_p_init(splt_state *state, int *error);
@@ -0,0 +1,277 @@
+/**********************************************************
+ *
+ * libmp3splt -- library based on mp3splt,
+ *               for mp3/ogg splitting without decoding
+ *
+ * Copyright (c) 2002-2005 M. Trotta - <mtrotta@users.sourceforge.net>
+ * Copyright (c) 2005-2014 Alexandru Munteanu - m@ioalex.net
+ *
+ * http://mp3splt.sourceforge.net
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ *********************************************************/
+
+/*! \file
+
+Segments of the input file split in a single read pass
+
+The times of all the segments are known before the plugin starts reading the
+input file. The tags and the output filename of a segment are set only when
+the plugin opens its output file, in the same order as when the segments
+are split one after the other.
+*/
+
+#include <limits.h>
+
+#include "splt.h"
+
+//! A segment between two splitpoints, in hundreths of seconds
+typedef struct {
+  int splitpoint_index;
+  //! index given to splt_u_finish_tags_and_put_output_format_filename
+  int tags_index;
+  long begin;
+  //! LONG_MAX for the end of the file
+  long end;
+  //! SPLT_TRUE if the segment is written until the end of the file whatever its end
+  int until_end_of_file;
+  //! end reported when the segment is closed, as the end point returned by splt_p_split
+  long real_end;
+  int real_end_is_set;
+} splt_segment;
+
+struct _splt_segment_plan {
+  splt_segment *segments;
+  int number_of_segments;
+  int allocated_segments;
+  /*! SPLT_TRUE if the splitpoints are appended when the segments are opened and
+    keep their values, as for the time split; the splitpoints of the client are
+    set back once the output filename is known */
+  int owns_splitpoints;
+};
+
+splt_segment_plan *splt_sgp_new(int owns_splitpoints, splt_code *error)
+{
+  splt_segment_plan *plan = malloc(sizeof(splt_segment_plan));
+  if (plan == NULL)
+  {
+    *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+    return NULL;
+  }
+
+  plan->segments = NULL;
+  plan->number_of_segments = 0;
+  plan->allocated_segments = 0;
+  plan->owns_splitpoints = owns_splitpoints;
+
+  return plan;
+}
+
+void splt_sgp_free(splt_segment_plan **plan)
+{
+  if (!plan || !*plan)
+  {
+    return;
+  }
+
+  if ((*plan)->segments)
+  {
+    free((*plan)->segments);
+  }
+
+  free(*plan);
+  *plan = NULL;
+}
+
+int splt_sgp_append_segment(splt_segment_plan *plan, int splitpoint_index, int tags_index,
+    long begin, long end, int until_end_of_file)
+{
+  if (plan->number_of_segments >= plan->allocated_segments)
+  {
+    int allocated_segments = plan->allocated_segments == 0 ? 64 : plan->allocated_segments * 2;
+    splt_segment *segments = realloc(plan->segments, sizeof(splt_segment) * allocated_segments);
+    if (segments == NULL)
+    {
+      return SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+    }
+
+    plan->segments = segments;
+    plan->allocated_segments = allocated_segments;
+  }
+
+  splt_segment *segment = &plan->segments[plan->number_of_segments];
+  segment->splitpoint_index = splitpoint_index;
+  segment->tags_index = tags_index;
+  segment->begin = begin;
+  segment->end = end;
+  segment->until_end_of_file = until_end_of_file || (end == LONG_MAX);
+  segment->real_end = end;
+  segment->real_end_is_set = SPLT_FALSE;
+
+  plan->number_of_segments++;
+
+  return SPLT_OK;
+}
+
+int splt_sgp_get_number_of_segments(const splt_segment_plan *plan)
+{
+  return plan->number_of_segments;
+}
+
+static double splt_sgp_hundreths_to_seconds(long hundreths)
+{
+  double seconds = hundreths / 100;
+  seconds += ((hundreths % 100) / 100.);
+  return seconds;
+}
+
+//! Begin of the segment in seconds
+double splt_sgp_get_begin(const splt_segment_plan *plan, int index)
+{
+  return splt_sgp_hundreths_to_seconds(plan->segments[index].begin);
+}
+
+//! End of the segment in seconds, or -1 for the end of the file
+double splt_sgp_get_end(const splt_segment_plan *plan, int index)
+{
+  if (plan->segments[index].until_end_of_file)
+  {
+    return -1;
+  }
+
+  return splt_sgp_hundreths_to_seconds(plan->segments[index].end);
+}
+
+/*! End of the segment in seconds as given to splt_pl_split, or -1 for the end of the file
+
+Unlike splt_sgp_get_end, the last segment of a time split has the end of its
+last split time, even if it is written until the end of the file.
+*/
+double splt_sgp_get_split_end(const splt_segment_plan *plan, int index)
+{
+  if (plan->segments[index].end == LONG_MAX)
+  {
+    return -1;
+  }
+
+  return splt_sgp_hundreths_to_seconds(plan->segments[index].end);
+}
+
+/*! Sets the tags of the segment and returns its output filename
+
+\return The output filename, to be freed by the caller, or NULL on error
+*/
+char *splt_sgp_open_segment(splt_state *state, splt_segment_plan *plan, int index,
+    splt_code *error)
+{
+  splt_segment *segment = &plan->segments[index];
+  int begin_index = segment->splitpoint_index;
+  int end_index = segment->splitpoint_index + 1;
+
+  if (plan->owns_splitpoints)
+  {
+    while (!splt_sp_splitpoint_exists(state, end_index))
+    {
+      int err = splt_sp_append_splitpoint(state, 0, "", SPLT_SPLITPOINT);
+      if (err < 0) { *error = err; return NULL; }
+    }
+  }
+
+  int get_error = SPLT_OK;
+  long saved_begin = splt_sp_get_splitpoint_value(state, begin_index, &get_error);
+  long saved_end = splt_sp_get_splitpoint_value(state, end_index, &get_error);
+  if (get_error < 0) { *error = get_error; return NULL; }
+
+  splt_t_set_current_split(state, begin_index);
+  splt_tu_auto_increment_tracknumber(state);
+
+  splt_sp_set_splitpoint_value(state, begin_index, segment->begin);
+  splt_sp_set_splitpoint_value(state, end_index, segment->end);
+
+  char *output_fname = NULL;
+
+  int err = splt_u_finish_tags_and_put_output_format_filename(state, segment->tags_index);
+  if (err < 0) { *error = err; goto end; }
+
+  output_fname = splt_su_get_fname_with_path_and_extension(state, &err);
+  if (err < 0) { *error = err; goto end; }
+
+  splt_io_create_output_dirs_if_necessary(state, output_fname, &err);
+  if (err < 0)
+  {
+    *error = err;
+    free(output_fname);
+    output_fname = NULL;
+  }
+
+end:
+  if (!plan->owns_splitpoints)
+  {
+    splt_sp_set_splitpoint_value(state, begin_index, saved_begin);
+    splt_sp_set_splitpoint_value(state, end_index, saved_end);
+  }
+
+  return output_fname;
+}
+
+/*! Reports the output file of the segment once written
+
+\param end The real end of the segment in seconds, or -1 when written until the end of
+the file; the end splitpoint of the segment is then kept
+*/
+void splt_sgp_close_segment(splt_state *state, splt_segment_plan *plan, int index,
+    const char *output_fname, double end, splt_code *error)
+{
+  splt_segment *segment = &plan->segments[index];
+  if (end != -1.0)
+  {
+    segment->real_end = splt_co_time_to_long_ceil(end);
+  }
+  segment->real_end_is_set = SPLT_TRUE;
+
+  splt_c_update_progress(state, 1.0, 1.0, 1, 1, 1);
+
+  int err = splt_c_put_split_file(state, output_fname);
+  if (err < 0) { *error = err; }
+}
+
+/*! Sets the end splitpoints to the real ends of the closed segments
+
+As when splitting one segment after the other, the end splitpoints are kept
+when splitting with overlap.
+*/
+void splt_sgp_save_real_end_points(splt_state *state, const splt_segment_plan *plan)
+{
+  if (splt_o_get_long_option(state, SPLT_OPT_OVERLAP_TIME) > 0)
+  {
+    return;
+  }
+
+  int i = 0;
+  for (i = 0;i < plan->number_of_segments;i++)
+  {
+    const splt_segment *segment = &plan->segments[i];
+    if (segment->real_end_is_set)
+    {
+      splt_sp_set_splitpoint_value(state, segment->splitpoint_index + 1, segment->real_end);
+    }
+  }
+}
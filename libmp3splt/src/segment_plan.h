@@ -0,0 +1,53 @@
+/**********************************************************
+ *
+ * libmp3splt -- library based on mp3splt,
+ *               for mp3/ogg splitting without decoding
+ *
+ * Copyright (c) 2002-2005 M. Trotta - <mtrotta@users.sourceforge.net>
+ * Copyright (c) 2005-2014 Alexandru Munteanu - m@ioalex.net
+ *
+ * http://mp3splt.sourceforge.net
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ *********************************************************/
+
+#ifndef SPLT_SEGMENT_PLAN_H
+
+splt_segment_plan *splt_sgp_new(int owns_splitpoints, splt_code *error);
+void splt_sgp_free(splt_segment_plan **plan);
+
+int splt_sgp_append_segment(splt_segment_plan *plan, int splitpoint_index, int tags_index,
+    long begin, long end, int until_end_of_file);
+int splt_sgp_get_number_of_segments(const splt_segment_plan *plan);
+double splt_sgp_get_begin(const splt_segment_plan *plan, int index);
+double splt_sgp_get_end(const splt_segment_plan *plan, int index);
+double splt_sgp_get_split_end(const splt_segment_plan *plan, int index);
+
+char *splt_sgp_open_segment(splt_state *state, splt_segment_plan *plan, int index,
+    splt_code *error);
+void splt_sgp_close_segment(splt_state *state, splt_segment_plan *plan, int index,
+    const char *output_fname, double end, splt_code *error);
+void splt_sgp_save_real_end_points(splt_state *state, const splt_segment_plan *plan);
+
+#define SPLT_SEGMENT_PLAN_H
+
+#endif
+
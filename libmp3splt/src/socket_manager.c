@@ -34,6 +34,8 @@ Manages a socket connection
 */
 
 #include <unistd.h>
+#include <errno.h>
+#include <ctype.h>
 
 #ifdef __WIN32__
 #define _WIN32_WINNT 0x0501
@@ -42,6 +44,8 @@ Manages a socket connection
 #include <winsock2.h>
 #else
 #include <netdb.h>
+#include <fcntl.h>
+#include <poll.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #endif
@@ -62,6 +66,13 @@ Manages a socket connection
 #define SPLT_BUFFER_SIZE 1024
 #define SPLT_MAXIMUM_NUMBER_OF_LINES_READ 1000
 
+//a peer closing the connection must not raise SIGPIPE
+#ifdef MSG_NOSIGNAL
+#define SPLT_SM_SEND_FLAGS MSG_NOSIGNAL
+#else
+#define SPLT_SM_SEND_FLAGS 0
+#endif
+
 static void splt_sm_handle_response_and_free(char **first_line, splt_socket_handler *sh,
     splt_state *state);
 
@@ -70,21 +81,31 @@ static char *get_message_decorated_with_http(splt_socket_handler *sh, const char
 static char *get_message_with_proxy(splt_socket_handler *sh, const char *message, splt_state *state);
 static char *get_message_without_proxy(splt_socket_handler *sh, const char *message);
 static int message_starts_with_get(const char *message);
+static int splt_sm_connect_to_address(splt_socket_handler *sh, struct addrinfo *address,
+    splt_state *state, int *timed_out);
+static int splt_sm_wait(splt_socket_handler *sh, int for_writing, int timeout);
+static int splt_sm_wait_or_set_error(splt_socket_handler *sh, int for_writing,
+    int error_if_failed, splt_state *state);
+static int splt_sm_would_block();
+static void splt_sm_get_real_host(const char **hostname, int *port, splt_state *state);
+static int splt_sm_starts_with_ignoring_case(const char *str, const char *prefix);
 
 void splt_sm_connect(splt_socket_handler *sh, const char *hostname, int port, splt_state *state)
 {
   const char *real_hostname = hostname;
   int real_port = port;
-  if (splt_pr_has_proxy(state))
-  {
-    real_hostname = splt_pr_get_proxy_address(state);
-    real_port = splt_pr_get_proxy_port(state);
-  }
+  splt_sm_get_real_host(&real_hostname, &real_port, state);
 
   splt_d_print_debug(state, "\nConnecting on host %s:%d\n", real_hostname, real_port);
 
   int err = splt_su_copy(hostname, &sh->hostname);
   if (err < 0) { sh->error = err; return; }
+  err = splt_su_copy(real_hostname, &sh->address);
+  if (err < 0) { sh->error = err; return; }
+  sh->port = real_port;
+
+  int timeout = splt_o_get_int_option(state, SPLT_OPT_FREEDB_TIMEOUT);
+  sh->timeout = timeout > 0 ? timeout * 1000 : -1;
 
 #ifdef __WIN32__
   WSADATA winsock;
@@ -115,47 +136,238 @@ void splt_sm_connect(splt_socket_handler *sh, const char *hostname, int port, sp
     return;
   }
 
+  int timed_out = SPLT_FALSE;
+
   struct addrinfo *result_p;
   for (result_p = result; result_p != NULL; result_p = result_p->ai_next)
   {
-    sh->fd = socket(result_p->ai_family, result_p->ai_socktype, result_p->ai_protocol);
-    if (sh->fd == -1)
-    {
-      splt_e_set_strerror_msg(state);
-      continue;
-    }
-
-    if (connect(sh->fd, result_p->ai_addr, result_p->ai_addrlen) != -1)
+    if (splt_sm_connect_to_address(sh, result_p, state, &timed_out))
     {
       break;
     }
-
-    splt_e_set_strerror_msg(state);
-    close(sh->fd);
   }
 
   if (result_p == NULL) {
     splt_e_set_error_data(state, real_hostname);
-    sh->error = SPLT_FREEDB_ERROR_CANNOT_CONNECT;
+    sh->error = timed_out ? SPLT_FREEDB_ERROR_TIMEOUT : SPLT_FREEDB_ERROR_CANNOT_CONNECT;
     freeaddrinfo(result);
     return;
   }
 
   freeaddrinfo(result);
 
+  sh->non_blocking = SPLT_TRUE;
+
   splt_d_print_debug(state, " ... connected.\n");
 }
 
+//! Connects the non-blocking socket to the address, waiting at most the timeout
+static int splt_sm_connect_to_address(splt_socket_handler *sh, struct addrinfo *address,
+    splt_state *state, int *timed_out)
+{
+  sh->fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+  if (sh->fd == -1)
+  {
+    splt_e_set_strerror_msg(state);
+    return SPLT_FALSE;
+  }
+
+#ifdef __WIN32__
+  u_long non_blocking = 1;
+  int non_blocking_failed = ioctlsocket(sh->fd, FIONBIO, &non_blocking) != 0;
+#else
+  int flags = fcntl(sh->fd, F_GETFL, 0);
+  int non_blocking_failed = flags == -1 || fcntl(sh->fd, F_SETFL, flags | O_NONBLOCK) == -1;
+#endif
+  if (non_blocking_failed)
+  {
+    goto error;
+  }
+
+  if (connect(sh->fd, address->ai_addr, address->ai_addrlen) != -1)
+  {
+    return SPLT_TRUE;
+  }
+
+  if (!splt_sm_would_block())
+  {
+    goto error;
+  }
+
+  int ready = splt_sm_wait(sh, SPLT_TRUE, sh->timeout);
+  if (ready == 0)
+  {
+    splt_e_set_strerr_msg(state, strerror(ETIMEDOUT));
+    *timed_out = SPLT_TRUE;
+    closesocket(sh->fd);
+    return SPLT_FALSE;
+  }
+  if (ready < 0)
+  {
+    goto error;
+  }
+
+  int socket_error = 0;
+  socklen_t socket_error_length = sizeof(socket_error);
+  if (getsockopt(sh->fd, SOL_SOCKET, SO_ERROR, (char *) &socket_error, &socket_error_length) == -1)
+  {
+    goto error;
+  }
+
+  if (socket_error == 0)
+  {
+    return SPLT_TRUE;
+  }
+
+  splt_e_set_strerr_msg(state, strerror(socket_error));
+  closesocket(sh->fd);
+  return SPLT_FALSE;
+
+error:
+  splt_e_set_strerror_msg(state);
+  closesocket(sh->fd);
+  return SPLT_FALSE;
+}
+
+/*! Returns true if the connection of a previous request can send the next one
+
+The connection must be to the same host, its last http response must have
+allowed keep-alive and the server must not have closed it meanwhile.
+*/
+int splt_sm_can_be_reused(splt_socket_handler *sh, const char *hostname, int port,
+    splt_state *state)
+{
+  if (sh->error < 0 || !sh->keep_alive || !sh->non_blocking)
+  {
+    return SPLT_FALSE;
+  }
+
+  const char *real_hostname = hostname;
+  int real_port = port;
+  splt_sm_get_real_host(&real_hostname, &real_port, state);
+
+  if (sh->hostname == NULL || strcmp(sh->hostname, hostname) != 0 ||
+      sh->address == NULL || strcmp(sh->address, real_hostname) != 0 ||
+      sh->port != real_port)
+  {
+    return SPLT_FALSE;
+  }
+
+  //an idle connection closed by the server is readable: its end of file is pending
+  return splt_sm_wait(sh, SPLT_FALSE, 0) == 0;
+}
+
+static void splt_sm_get_real_host(const char **hostname, int *port, splt_state *state)
+{
+  if (splt_pr_has_proxy(state))
+  {
+    *hostname = splt_pr_get_proxy_address(state);
+    *port = splt_pr_get_proxy_port(state);
+  }
+}
+
+/*! Waits until the socket can be read or written
+
+\param timeout Milliseconds to wait, -1 to wait indefinitely
+\return 1 when the socket is ready, 0 on timeout and -1 on error
+*/
+static int splt_sm_wait(splt_socket_handler *sh, int for_writing, int timeout)
+{
+#ifdef __WIN32__
+  fd_set fds;
+  FD_ZERO(&fds);
+  FD_SET(sh->fd, &fds);
+  //failed connections are reported as exceptions
+  fd_set exception_fds;
+  FD_ZERO(&exception_fds);
+  FD_SET(sh->fd, &exception_fds);
+
+  struct timeval tv;
+  tv.tv_sec = timeout / 1000;
+  tv.tv_usec = (timeout % 1000) * 1000;
+
+  return select(0, for_writing ? NULL : &fds, for_writing ? &fds : NULL,
+      for_writing ? &exception_fds : NULL, timeout < 0 ? NULL : &tv);
+#else
+  struct pollfd pfd;
+  pfd.fd = sh->fd;
+  pfd.events = for_writing ? POLLOUT : POLLIN;
+  pfd.revents = 0;
+
+  int ready = 0;
+  do {
+    ready = poll(&pfd, 1, timeout);
+  } while (ready == -1 && errno == EINTR);
+
+  return ready;
+#endif
+}
+
+static int splt_sm_wait_or_set_error(splt_socket_handler *sh, int for_writing,
+    int error_if_failed, splt_state *state)
+{
+  int ready = splt_sm_wait(sh, for_writing, sh->timeout);
+  if (ready > 0)
+  {
+    return SPLT_TRUE;
+  }
+
+  if (ready == 0)
+  {
+    sh->error = SPLT_FREEDB_ERROR_TIMEOUT;
+  }
+  else
+  {
+    splt_e_set_strerror_msg(state);
+    sh->error = error_if_failed;
+  }
+  splt_e_set_error_data(state, sh->hostname);
+  sh->keep_alive = SPLT_FALSE;
+
+  return SPLT_FALSE;
+}
+
+static int splt_sm_would_block()
+{
+#ifdef __WIN32__
+  return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+  return errno == EINPROGRESS || errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif
+}
+
 void splt_sm_send(splt_socket_handler *sh, const char *message, 
     splt_state *state)
 {
   splt_d_print_debug(state, "\nSending message _%s_\n", message);
 
-  if (send(sh->fd, message, strlen(message), 0) == -1)
+  const char *remaining = message;
+  size_t remaining_length = strlen(message);
+  while (remaining_length > 0)
   {
-    splt_e_set_strerror_msg(state);
-    splt_e_set_error_data(state, sh->hostname);
-    sh->error = SPLT_FREEDB_ERROR_CANNOT_SEND_MESSAGE;
+    if (sh->non_blocking &&
+        !splt_sm_wait_or_set_error(sh, SPLT_TRUE, SPLT_FREEDB_ERROR_CANNOT_SEND_MESSAGE, state))
+    {
+      return;
+    }
+
+    ssize_t sent_bytes = send(sh->fd, remaining, remaining_length, SPLT_SM_SEND_FLAGS);
+    if (sent_bytes == -1)
+    {
+      if (sh->non_blocking && splt_sm_would_block())
+      {
+        continue;
+      }
+
+      splt_e_set_strerror_msg(state);
+      splt_e_set_error_data(state, sh->hostname);
+      sh->error = SPLT_FREEDB_ERROR_CANNOT_SEND_MESSAGE;
+      sh->keep_alive = SPLT_FALSE;
+      return;
+    }
+
+    remaining += sent_bytes;
+    remaining_length -= sent_bytes;
   }
 
   splt_d_print_debug(state, " ... message sent.\n");
@@ -212,6 +424,7 @@ static char *get_message_with_proxy(splt_socket_handler *sh, const char *message
   int err = splt_su_append_str(&message_with_proxy, 
       "GET http://", sh->hostname, message + 4, " HTTP/1.0\r\n",
       "UserAgent: ", SPLT_PACKAGE_NAME, "/", SPLT_PACKAGE_VERSION, "\r\n",
+      "Connection: keep-alive\r\n",
       "Host: ", sh->hostname, NULL);
   if (err < 0) { sh->error = err; return NULL; }
 
@@ -241,9 +454,16 @@ static char *get_message_with_proxy(splt_socket_handler *sh, const char *message
 
 static char *get_message_without_proxy(splt_socket_handler *sh, const char *message)
 {
+  //the cddb protocol takes one command per line: only http requests get more headers
+  const char *keep_alive = "";
+  if (message_starts_with_get(message))
+  {
+    keep_alive = "Connection: keep-alive\r\n";
+  }
+
   char *message_with_http = NULL;
   int err = splt_su_append_str(&message_with_http, 
-      message, " HTTP/1.0\r\nHost: ", sh->hostname, "\r\n\r\n", NULL);
+      message, " HTTP/1.0\r\n", keep_alive, "Host: ", sh->hostname, "\r\n\r\n", NULL);
   if (err < 0) { sh->error = err; return NULL; }
 
   return message_with_http;
@@ -253,8 +473,27 @@ int splt_sm_process_without_headers_functor(const char *received_line,
     int line_number, void *user_data)
 {
   splt_sm_functor_decorator *sm_fd = (splt_sm_functor_decorator *) user_data;
- 
-  if (!sm_fd->processing_headers)
+
+  if (sm_fd->processing_headers)
+  {
+    if (splt_sm_starts_with_ignoring_case(received_line, "content-length:"))
+    {
+      sm_fd->content_length = atol(splt_su_skip_spaces(received_line + 15));
+    }
+    else if (splt_sm_starts_with_ignoring_case(received_line, "connection:"))
+    {
+      sm_fd->keep_alive = splt_sm_starts_with_ignoring_case(
+          splt_su_skip_spaces(received_line + 11), "keep-alive");
+    }
+    else if (strlen(received_line) == 0 && sm_fd->sh != NULL &&
+        sm_fd->keep_alive && sm_fd->content_length >= 0)
+    {
+      //the body length is known: the connection can be reused after it
+      sm_fd->sh->keep_alive = SPLT_TRUE;
+      sm_fd->sh->body_bytes_left = sm_fd->content_length;
+    }
+  }
+  else
   {
     int real_line_number = 
       sm_fd->line_number_after_headers - sm_fd->num_lines_to_skip;
@@ -293,6 +532,9 @@ char *splt_sm_receive_and_process_without_headers_with_recv(splt_socket_handler
 
   sm_fd->functor = process_functor;
   sm_fd->user_data = user_data;
+  sm_fd->sh = sh;
+  sm_fd->content_length = -1;
+  sm_fd->keep_alive = SPLT_FALSE;
   sm_fd->processing_headers = SPLT_TRUE;
   sm_fd->num_lines_to_skip = number_of_lines_to_skip_after_headers;
   sm_fd->line_number_after_headers = 1;
@@ -341,6 +583,33 @@ void splt_sm_receive_and_process(splt_socket_handler *sh, splt_state *state,
   splt_sm_handle_response_and_free(&first_line, sh, state);
 }
 
+//! Processes in place the line ending at line_end, without its ending \r\n
+static int splt_sm_process_line(char *line, char *line_end, int *line_number,
+    char **first_line, splt_socket_handler *sh, splt_state *state,
+    int (*process_functor)(const char *received_line, int line_number, void *user_data),
+    void *user_data)
+{
+  *line_end = '\0';
+  if (line_end > line && *(line_end - 1) == '\r')
+  {
+    *(line_end - 1) = '\0';
+  }
+
+  splt_d_print_debug(state, "Received line _%s_\n", line);
+
+  if (*line_number == 1)
+  {
+    int err = splt_su_copy(line, first_line);
+    if (err < 0) { sh->error = err; return SPLT_FALSE; }
+  }
+
+  int we_continue = process_functor(line, *line_number, user_data);
+
+  (*line_number)++;
+
+  return we_continue;
+}
+
 char *splt_sm_receive_and_process_with_recv(splt_socket_handler *sh, splt_state *state,
     ssize_t (*recv_func)(int fd, void *buf, size_t len, int flags),
     int (*process_functor)(const char *received_line, int line_number, void *user_data),
@@ -351,12 +620,10 @@ char *splt_sm_receive_and_process_with_recv(splt_socket_handler *sh, splt_state
   int err = SPLT_OK;
   char *first_line = NULL;
 
-  char *lines = NULL;
-
-  char *remaining_line = NULL;
-  int remaining_line_size = 0;
-
-  char buffer[SPLT_BUFFER_SIZE] = { '\0' };
+  //received bytes not yet processed: recv appends to it and the
+  //processed lines are removed from its beginning
+  splt_string_builder lines;
+  splt_su_builder_init(&lines);
 
   int number_of_lines_read = 0;
 
@@ -365,8 +632,21 @@ char *splt_sm_receive_and_process_with_recv(splt_socket_handler *sh, splt_state
 
   int line_number = 1;
 
+  //only a http response with a known body length keeps the connection
+  sh->keep_alive = SPLT_FALSE;
+  sh->body_bytes_left = -1;
+
   while (number_of_lines_read < SPLT_MAXIMUM_NUMBER_OF_LINES_READ) {
-    memset(buffer, '\0', SPLT_BUFFER_SIZE);
+    err = splt_su_builder_reserve(&lines, SPLT_BUFFER_SIZE);
+    if (err < 0) { sh->error = err; goto end; }
+
+    if (sh->non_blocking &&
+        !splt_sm_wait_or_set_error(sh, SPLT_FALSE, SPLT_FREEDB_ERROR_CANNOT_RECV_MESSAGE, state))
+    {
+      goto end;
+    }
+
+    char *buffer = lines.str + lines.length;
 #ifdef __WIN32__
     int received_bytes = recv(sh->fd, buffer, SPLT_BUFFER_SIZE, 0);
 #else
@@ -374,86 +654,73 @@ char *splt_sm_receive_and_process_with_recv(splt_socket_handler *sh, splt_state
 #endif
     if (received_bytes == -1)
     {
+      if (sh->non_blocking && splt_sm_would_block())
+      {
+        continue;
+      }
+
       splt_e_set_strerror_msg(state);
       splt_e_set_error_data(state, sh->hostname);
       sh->error = SPLT_FREEDB_ERROR_CANNOT_RECV_MESSAGE;
+      sh->keep_alive = SPLT_FALSE;
       goto end;
     }
 
     if (received_bytes == 0)
     {
+      sh->keep_alive = SPLT_FALSE;
       break;
     }
 
-    err = splt_su_set(&lines, remaining_line, remaining_line_size, NULL);
-    if (err < 0) { sh->error = err; goto end; }
-
-    err = splt_su_append(&lines, buffer, received_bytes, NULL);
-    if (err < 0) { sh->error = err; goto end; }
-
-    remaining_line_size += received_bytes;
+    //the received text ends at the first nul character, if any
+    lines.length += strnlen(buffer, received_bytes);
+    lines.str[lines.length] = '\0';
 
-    if (!lines)
-    {
-      continue;
-    }
-
-    line_begin = lines;
-    line_end = NULL;
+    line_begin = lines.str;
+    char *lines_end = lines.str + lines.length;
 
-    while ((line_end = strchr(line_begin, '\n')) != NULL)
+    while ((line_end = memchr(line_begin, '\n', lines_end - line_begin)) != NULL)
     {
-      int line_size = (line_end - line_begin) + 1;
+      int in_body = sh->body_bytes_left > 0;
+      long line_size = line_end + 1 - line_begin;
 
-      char *line = NULL;
-      err = splt_su_set(&line, line_begin, line_size, "\0", 1, NULL);
-      if (err < 0) { sh->error = err; goto end; }
+      int we_continue = splt_sm_process_line(line_begin, line_end, &line_number, &first_line,
+          sh, state, process_functor, user_data);
+      if (sh->error < 0) { goto end; }
 
-      splt_su_line_to_unix(line);
-      splt_su_str_cut_last_char(line);
-
-      splt_d_print_debug(state, "Received line _%s_\n", line);
-
-      if (line_number == 1)
+      if (in_body)
       {
-        err = splt_su_copy(line, &first_line);
-        if (err < 0) { sh->error = err; goto end; }
+        sh->body_bytes_left = sh->body_bytes_left > line_size ? sh->body_bytes_left - line_size : 0;
       }
 
-      int we_continue = process_functor(line, line_number, user_data);
-
-      line_number++;
-
-      if (line)
+      if (sh->body_bytes_left == 0)
       {
-        free(line);
-        line = NULL;
+        goto end;
       }
 
       if (!we_continue)
       {
+        sh->keep_alive = SPLT_FALSE;
         goto end;
       }
 
-      remaining_line_size -= line_size;
       line_begin = line_end + 1;
     }
 
-    err = splt_su_set(&remaining_line, line_begin, remaining_line_size, NULL);
-    if (err < 0) { sh->error = err; goto end; }
+    //the body of a kept-alive response may not end with a new line
+    if (sh->body_bytes_left > 0 && lines_end - line_begin >= sh->body_bytes_left)
+    {
+      splt_sm_process_line(line_begin, line_begin + sh->body_bytes_left, &line_number,
+          &first_line, sh, state, process_functor, user_data);
+      sh->body_bytes_left = 0;
+      goto end;
+    }
+
+    splt_su_builder_remove_beginning(&lines, line_begin - lines.str);
   }
 
 end:
-  if (lines)
-  {
-    free(lines);
-    lines = NULL;
-  }
-  if (remaining_line)
-  {
-    free(remaining_line);
-    remaining_line = NULL;
-  }
+  splt_su_builder_free(&lines);
 
   return first_line;
 }
@@ -483,6 +750,11 @@ splt_socket_handler *splt_sm_socket_handler_new(int *error)
 
   sh->error = SPLT_OK;
   sh->hostname = NULL;
+  sh->address = NULL;
+  sh->timeout = -1;
+  sh->non_blocking = SPLT_FALSE;
+  sh->keep_alive = SPLT_FALSE;
+  sh->body_bytes_left = -1;
 
   return sh;
 }
@@ -500,6 +772,12 @@ void splt_sm_socket_handler_free(splt_socket_handler **sh)
     (*sh)->hostname = NULL;
   }
 
+  if ((*sh)->address)
+  {
+    free((*sh)->address);
+    (*sh)->address = NULL;
+  }
+
   free(*sh);
   *sh = NULL;
 }
@@ -524,3 +802,16 @@ static void splt_sm_handle_response_and_free(char **first_line, splt_socket_hand
   *first_line = NULL;
 }
 
+static int splt_sm_starts_with_ignoring_case(const char *str, const char *prefix)
+{
+  for (;*prefix != '\0';str++, prefix++)
+  {
+    if (tolower((unsigned char) *str) != *prefix)
+    {
+      return SPLT_FALSE;
+    }
+  }
+
+  return SPLT_TRUE;
+}
+
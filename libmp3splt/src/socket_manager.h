@@ -38,7 +38,7 @@
  #endif
 #endif
 
-typedef struct {
+typedef struct _splt_socket_handler {
   int error;
 #ifdef __WIN32__
   SOCKET fd;
@@ -46,11 +46,25 @@ typedef struct {
   int fd;
 #endif
   char *hostname;
+  //! host and port really connected to: the proxy when using one
+  char *address;
+  int port;
+  //! milliseconds to wait for the socket, -1 waits indefinitely
+  int timeout;
+  //! true when the socket is connected and in non-blocking mode
+  int non_blocking;
+  //! true when the last http response allows reusing the connection
+  int keep_alive;
+  //! bytes of the http response body not yet processed, -1 when unknown
+  long body_bytes_left;
 } splt_socket_handler;
 
 typedef struct {
   int (*functor)(const char *received_line, int line_number, void *user_data);
   void *user_data;
+  splt_socket_handler *sh;
+  long content_length;
+  int keep_alive;
   int processing_headers;
   int num_lines_to_skip;
   int line_number_after_headers;
@@ -62,6 +76,8 @@ void splt_sm_socket_handler_free(splt_socket_handler **sh);
 
 void splt_sm_connect(splt_socket_handler *sh, const char *hostname, int port,
     splt_state *state);
+int splt_sm_can_be_reused(splt_socket_handler *sh, const char *hostname, int port,
+    splt_state *state);
 void splt_sm_send_http_message(splt_socket_handler *sh, const char *message,
     splt_state *state);
 
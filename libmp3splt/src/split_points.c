@@ -62,16 +62,15 @@ int splt_sp_get_real_splitpoints_number(splt_state *state)
   return state->split.points->real_splitnumber;
 }
 
-int splt_sp_append_splitpoint(splt_state *state, long split_value,
-    const char *name, int type)
-{
-  int error = SPLT_OK;
+/*! Makes room for \p number_of_splitpoints splitpoints
 
+Importers knowing the number of tracks call it to avoid growing the
+splitpoints while appending.
+*/
+int splt_sp_reserve_splitpoints(splt_state *state, int number_of_splitpoints)
+{
   splt_struct *split = &state->split;
 
-  splt_d_print_debug(state,"Appending splitpoint _%s_ with value _%ld_\n",
-      name, split_value);
-
   if (!split->points)
   {
     split->points = malloc(sizeof(splt_points));
@@ -81,22 +80,47 @@ int splt_sp_append_splitpoint(splt_state *state, long split_value,
     }
 
     split->points->real_splitnumber = 0;
+    split->points->allocated_splitnumber = 0;
     split->points->iterator_counter = 0;
+    split->points->points = NULL;
+  }
 
-    if ((split->points->points = malloc(sizeof(splt_point))) == NULL)
-    {
-      free(split->points);
-      split->points = NULL;
-      return SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
-    }
+  if (number_of_splitpoints <= split->points->allocated_splitnumber)
+  {
+    return SPLT_OK;
   }
-  else
+
+  splt_point *new_points =
+    realloc(split->points->points, number_of_splitpoints * sizeof(splt_point));
+  if (new_points == NULL)
   {
-    if ((split->points->points =
-          realloc(split->points->points, (split->points->real_splitnumber + 1) * sizeof(splt_point))) == NULL)
-    {
-      return SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
-    }
+    return SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+  }
+
+  split->points->points = new_points;
+  split->points->allocated_splitnumber = number_of_splitpoints;
+
+  return SPLT_OK;
+}
+
+int splt_sp_append_splitpoint(splt_state *state, long split_value,
+    const char *name, int type)
+{
+  int error = SPLT_OK;
+
+  splt_struct *split = &state->split;
+
+  splt_d_print_debug(state,"Appending splitpoint _%s_ with value _%ld_\n",
+      name, split_value);
+
+  if (!split->points ||
+      split->points->real_splitnumber >= split->points->allocated_splitnumber)
+  {
+    int new_allocated = split->points ? split->points->allocated_splitnumber * 2 : 0;
+    if (new_allocated < 8) { new_allocated = 8; }
+
+    error = splt_sp_reserve_splitpoints(state, new_allocated);
+    if (error < 0) { return error; }
   }
 
   split->points->real_splitnumber++;
@@ -152,7 +176,8 @@ splt_points *splt_sp_get_splitpoints(splt_state *state)
   return state->split.points;
 }
 
-void splt_sp_free_splitpoints(splt_state *state)
+//! Removes all the splitpoints but keeps the allocated memory for the next ones
+void splt_sp_clear_splitpoints(splt_state *state)
 {
   splt_struct *split = &state->split;
 
@@ -168,6 +193,21 @@ void splt_sp_free_splitpoints(splt_state *state)
       }
     }
 
+    split->points->real_splitnumber = 0;
+    split->points->iterator_counter = 0;
+  }
+
+  split->splitnumber = 0;
+}
+
+void splt_sp_free_splitpoints(splt_state *state)
+{
+  splt_struct *split = &state->split;
+
+  if (split->points)
+  {
+    splt_sp_clear_splitpoints(state);
+
     free(split->points->points);
     split->points->points = NULL;
 
@@ -34,9 +34,11 @@
 int splt_sp_splitpoint_exists(splt_state *state, int index);
 int splt_sp_get_real_splitpoints_number(splt_state *state);
 
+int splt_sp_reserve_splitpoints(splt_state *state, int number_of_splitpoints);
 int splt_sp_append_splitpoint(splt_state *state, long split_value,
     const char *name, int type);
 splt_points *splt_sp_get_splitpoints(splt_state *state);
+void splt_sp_clear_splitpoints(splt_state *state);
 void splt_sp_free_splitpoints(splt_state *state);
 void splt_sp_free_one_splitpoint(splt_point *point);
 
@@ -144,6 +144,61 @@ static long splt_s_split(splt_state *state, int first_splitpoint,
   return new_end_point;
 }
 
+/*! Splits the file with multiple points in a single read pass of the input file
+
+\return SPLT_FALSE if the file must be split one segment after the other
+*/
+static int splt_s_multiple_split_in_one_read_pass(splt_state *state, int *error)
+{
+  if (!splt_o_get_int_option(state, SPLT_OPT_SINGLE_READ_PASS))
+  {
+    return SPLT_FALSE;
+  }
+
+  int err = SPLT_OK;
+  splt_segment_plan *plan = splt_sgp_new(SPLT_FALSE, &err);
+  if (err < 0) { *error = err; return SPLT_TRUE; }
+
+  int split_in_one_read_pass = SPLT_FALSE;
+
+  int i = 0;
+  int number_of_splitpoints = splt_t_get_splitnumber(state);
+  for (i = 0;i < number_of_splitpoints - 1;i++)
+  {
+    int get_error = SPLT_OK;
+    if (splt_sp_get_splitpoint_type(state, i, &get_error) == SPLT_SKIPPOINT)
+    {
+      continue;
+    }
+
+    long begin = splt_sp_get_splitpoint_value(state, i, &get_error);
+    long saved_end = splt_sp_get_splitpoint_value(state, i + 1, &get_error);
+    long end = splt_sp_overlap_time(state, i + 1);
+    splt_sp_set_splitpoint_value(state, i + 1, saved_end);
+    if (get_error < 0) { *error = get_error; split_in_one_read_pass = SPLT_TRUE; goto end; }
+
+    //the error of equal splitpoints is set by the split one segment after the other
+    if (begin == saved_end) { goto end; }
+
+    err = splt_sgp_append_segment(plan, i, i, begin, end, SPLT_FALSE);
+    if (err < 0) { *error = err; split_in_one_read_pass = SPLT_TRUE; goto end; }
+  }
+
+  if (splt_sgp_get_number_of_segments(plan) > 0)
+  {
+    split_in_one_read_pass = splt_p_split_segments(state, plan, error);
+    if (split_in_one_read_pass)
+    {
+      splt_sgp_save_real_end_points(state, plan);
+    }
+  }
+
+end:
+  splt_sgp_free(&plan);
+
+  return split_in_one_read_pass;
+}
+
 //!splits the file with multiple points
 void splt_s_multiple_split(splt_state *state, int *error)
 {
@@ -159,6 +214,11 @@ void splt_s_multiple_split(splt_state *state, int *error)
 
   splt_u_print_overlap_time(state);
 
+  if (splt_s_multiple_split_in_one_read_pass(state, error))
+  {
+    return;
+  }
+
   int get_error = SPLT_OK;
 
   splt_array *new_end_points = splt_array_new();
@@ -399,6 +459,76 @@ static double splt_s_get_real_end_time_splitpoint(splt_state *state,
   return overlapped_end;
 }
 
+/*! Splits by time in a single read pass of the input file
+
+The splitpoints are set as when splitting one segment after the other.
+
+\return SPLT_FALSE if the file must be split one segment after the other
+*/
+static int splt_s_split_by_time_in_one_read_pass(splt_state *state, int *error,
+    double split_time_length, int number_of_files, long total_time)
+{
+  if (!splt_o_get_int_option(state, SPLT_OPT_SINGLE_READ_PASS) ||
+      (total_time <= 0) || (split_time_length <= 0))
+  {
+    return SPLT_FALSE;
+  }
+
+  int err = SPLT_OK;
+  splt_segment_plan *plan = splt_sgp_new(SPLT_TRUE, &err);
+  if (err < 0) { *error = err; return SPLT_TRUE; }
+
+  long overlap_time = splt_o_get_long_option(state, SPLT_OPT_OVERLAP_TIME);
+  long minimum_length = splt_o_get_long_option(state, SPLT_OPT_TIME_MINIMUM_THEORETICAL_LENGTH);
+
+  int split_in_one_read_pass = SPLT_TRUE;
+
+  double begin = 0.f;
+  double end = split_time_length;
+  int current_split = 0;
+  int last_segment = SPLT_FALSE;
+
+  //same end splitpoints as splt_s_get_real_end_time_splitpoint
+  while (!last_segment)
+  {
+    long begin_splitpoint = splt_co_time_to_long_ceil(begin);
+    long end_splitpoint = splt_co_time_to_long_ceil(end);
+    if (overlap_time > 0)
+    {
+      end_splitpoint += overlap_time;
+      if (end_splitpoint > total_time) { end_splitpoint = total_time; }
+    }
+
+    //the end of the file, as the -1 end of splt_s_get_real_end_time_splitpoint
+    long remaining_time = total_time - end_splitpoint;
+    if (remaining_time > 0 && remaining_time < minimum_length)
+    {
+      end_splitpoint = LONG_MAX;
+    }
+
+    last_segment = (end_splitpoint >= total_time) || (current_split + 1 == number_of_files);
+
+    err = splt_sgp_append_segment(plan, current_split, -1,
+        begin_splitpoint, end_splitpoint, last_segment);
+    if (err < 0) { *error = err; goto end; }
+
+    begin = end;
+    end += split_time_length;
+    current_split++;
+  }
+
+  split_in_one_read_pass = splt_p_split_segments(state, plan, error);
+  if (split_in_one_read_pass)
+  {
+    splt_sgp_save_real_end_points(state, plan);
+  }
+
+end:
+  splt_sgp_free(&plan);
+
+  return split_in_one_read_pass;
+}
+
 static void splt_s_split_by_time(splt_state *state, int *error,
     double split_time_length, int number_of_files)
 {
@@ -433,7 +563,8 @@ static void splt_s_split_by_time(splt_state *state, int *error,
 
     //we append a splitpoint
     err = splt_sp_append_splitpoint(state, 0, "", SPLT_SPLITPOINT);
-    if (err >= 0)
+    if ((err >= 0) && !splt_s_split_by_time_in_one_read_pass(state, error,
+          split_time_length, number_of_files, total_time))
     { 
       int save_end_point = SPLT_TRUE;
       if (splt_o_get_long_option(state, SPLT_OPT_OVERLAP_TIME) > 0)
@@ -549,7 +680,7 @@ static void splt_s_split_by_time(splt_state *state, int *error,
 
       splt_array_free(&new_end_points);
     }
-    else
+    else if (err < 0)
     {
       *error = err;
     }
@@ -637,6 +768,142 @@ void splt_s_equal_length_split(splt_state *state, int *error)
   }
 }
 
+/*! function used with the SPLT_OPTION_LIVE_MODE split mode
+
+reads an unbounded input as it arrives and creates a new file every
+SPLT_OPT_SPLIT_TIME hundreths of seconds, or when the plugin detects a silence
+with SPLT_OPT_LIVE_SPLIT_ON_SILENCE; only the two splitpoints of the current
+file are kept, so that the memory does not grow with the number of files
+*/
+void splt_s_live_split(splt_state *state, int *error)
+{
+  splt_c_put_info_message_to_client(state, _(" info: starting live split\n"));
+
+  long split_time_length = splt_o_get_long_option(state, SPLT_OPT_SPLIT_TIME);
+  int split_on_silence = splt_o_get_int_option(state, SPLT_OPT_LIVE_SPLIT_ON_SILENCE);
+  if ((split_time_length < 0) || (split_time_length == 0 && !split_on_silence))
+  {
+    *error = SPLT_ERROR_TIME_SPLIT_VALUE_INVALID;
+    return;
+  }
+
+  int err = SPLT_OK;
+  char *final_fname = NULL;
+  char *part_fname = NULL;
+
+  splt_sp_clear_splitpoints(state);
+  err = splt_sp_append_splitpoint(state, 0, "", SPLT_SPLITPOINT);
+  if (err < 0) { *error = err; return; }
+  err = splt_sp_append_splitpoint(state, 0, "", SPLT_SPLITPOINT);
+  if (err < 0) { *error = err; return; }
+
+  splt_t_set_splitnumber(state, 2);
+  splt_of_set_oformat_digits(state);
+
+  int output_filenames = splt_o_get_int_option(state, SPLT_OPT_OUTPUT_FILENAMES);
+  if (output_filenames == SPLT_OUTPUT_DEFAULT)
+  {
+    splt_of_set_oformat(state, SPLT_DEFAULT_OUTPUT, &err, SPLT_TRUE);
+    if (err < 0) { *error = err; return; }
+  }
+
+  //an output sink receives the files itself
+  int write_part_file =
+    !splt_io_input_is_stdout(state) && !state->split.use_output_sink;
+
+  double begin = 0.f;
+  int file_number = 1;
+
+  do {
+    if (splt_t_split_is_canceled(state))
+    {
+      *error = SPLT_SPLIT_CANCELLED;
+      break;
+    }
+
+    double end = -1.0;
+    long end_splitpoint = LONG_MAX;
+    if (split_time_length > 0)
+    {
+      end = begin + split_time_length / 100.0;
+      end_splitpoint = splt_co_time_to_long_ceil(end);
+    }
+
+    splt_t_set_current_split(state, 0);
+    splt_t_set_current_split_file_number(state, file_number);
+    splt_sp_set_splitpoint_value(state, 0, splt_co_time_to_long_ceil(begin));
+    splt_sp_set_splitpoint_value(state, 1, end_splitpoint);
+
+    splt_tu_auto_increment_tracknumber(state);
+
+    err = splt_tu_set_tags_in_tags(state, -1);
+    if (err < 0) { *error = err; break; }
+    err = splt_of_put_output_format_filename(state, 0);
+    if (err < 0) { *error = err; break; }
+
+    final_fname = splt_su_get_fname_with_path_and_extension(state, &err);
+    if (err < 0) { *error = err; break; }
+
+    //the file is written with a temporary name and renamed when complete
+    const char *output_fname = final_fname;
+    if (write_part_file)
+    {
+      err = splt_su_copy(final_fname, &part_fname);
+      if (err < 0) { *error = err; break; }
+      err = splt_su_append(&part_fname, ".part", strlen(".part"), NULL);
+      if (err < 0) { *error = err; break; }
+      output_fname = part_fname;
+    }
+
+    double new_sec_end_point = splt_p_split(state, output_fname, begin, end, error, SPLT_FALSE);
+
+    //an incomplete file is kept with its temporary name
+    if (*error >= 0 && write_part_file)
+    {
+      err = splt_io_sync_and_rename(state, part_fname, final_fname);
+      if (err < 0) { *error = err; break; }
+    }
+
+    if (*error >= 0)
+    {
+      err = splt_c_put_split_file(state, final_fname);
+      if (err < 0) { *error = err; break; }
+    }
+
+    if (new_sec_end_point > begin)
+    {
+      begin = new_sec_end_point;
+    }
+    else if (end > begin)
+    {
+      begin = end;
+    }
+    file_number++;
+
+    free(final_fname);
+    final_fname = NULL;
+    if (part_fname)
+    {
+      free(part_fname);
+      part_fname = NULL;
+    }
+  } while (*error == SPLT_OK_SPLIT);
+
+  if (final_fname)
+  {
+    free(final_fname);
+  }
+  if (part_fname)
+  {
+    free(part_fname);
+  }
+
+  if ((*error == SPLT_OK_SPLIT) || (*error == SPLT_OK_SPLIT_EOF))
+  {
+    *error = SPLT_LIVE_SPLIT_OK;
+  }
+}
+
 int splt_s_set_trim_silence_splitpoints(splt_state *state, int *error)
 {
   splt_d_print_debug(state, "Search and set trim silence splitpoints...\n");
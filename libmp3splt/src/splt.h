@@ -41,6 +41,9 @@
 
 #include "mp3splt.h"
 
+//splt_string_builder is used by the structures below
+#include "string_utils.h"
+
 struct _splt_freedb_one_result {
   /**
    * @brief Name of the album for this result
@@ -105,6 +108,13 @@ typedef struct {
   //we stock the state of the CD
   //(for the freedb search)
   splt_cd_state *cdstate;
+  //! local index of the last #SPLT_FREEDB_SEARCH_TYPE_LOCAL_INDEX search
+  struct _splt_freedb_index *local_index;
+  //! kept-alive connection of the last http request, reused by the next one
+  struct _splt_socket_handler *connection;
+  //! responses of the previous requests, also on disk with a cache directory
+  struct _splt_freedb_cache *cache;
+  char *cache_directory;
 } splt_freedb;
 
 typedef char _splt_one_wrap;
@@ -192,12 +202,30 @@ struct _splt_original_tags {
 struct _splt_tags_group {
   splt_tags *tags;
   int real_tagsnumber;
+  //!number of tags we have memory for in #tags
+  int allocated_tagsnumber;
   int iterator_counter;
 };
 
 #define SPLT_MAXOLEN 255
 #define SPLT_OUTNUM  20
 
+//one field of the output format, compiled when the format is set
+typedef struct {
+  //the variable after the @ or '\0' for the leading text
+  char variable;
+  //number of digits requested right after the variable or -1
+  int digits;
+  //whole number written after the variable or -1
+  int number_after_variable;
+  //text written after the value of the variable
+  const char *text;
+  size_t text_length;
+  //text written instead when a time value is 0 and @x0 was requested
+  const char *zero_value_text;
+  size_t zero_value_text_length;
+} splt_oformat_field;
+
 //structure defining the output format
 typedef struct {
   //format as @n_@t.. as a string
@@ -207,6 +235,13 @@ typedef struct {
   int output_alpha_format_digits;
   //format for the cddb cue output
   char format[SPLT_OUTNUM+1][SPLT_MAXOLEN];
+  //fields compiled from 'format'
+  splt_oformat_field fields[SPLT_OUTNUM];
+  int number_of_fields;
+  //if the format is SPLT_DEFAULT_OUTPUT, the last file ends with EOF
+  int is_default_output;
+  //buffer reused for each generated filename
+  splt_string_builder filename;
 } splt_oformat;
 
 struct _splt_point {
@@ -228,6 +263,8 @@ struct _splt_point {
 struct _splt_points {
   splt_point *points;
   int real_splitnumber;
+  //!number of splitpoints we have memory for in #points
+  int allocated_splitnumber;
   int iterator_counter;
 };
 
@@ -294,6 +331,17 @@ typedef struct {
   void (*write_cb)(const void *ptr, size_t size, size_t nmemb, void *cb_data);
   void *write_cb_data;
 
+  //! receives the output files instead of the file system when use_output_sink is set
+  splt_output_sink output_sink;
+  int use_output_sink;
+  //! parameters of the built-in output sinks, which get the state as cb_data
+  void (*memory_sink_file_done)(const char *filename, const unsigned char *bytes,
+      size_t size, void *cb_data);
+  void *memory_sink_cb_data;
+  int fd_sink;
+  //! SPLT_FALSE while an incomplete output file is closed with splt_os_fclose
+  int output_file_complete;
+
   //!All infos for the progress bar
   splt_progress *p_bar;
   //!callback for sending the silence level to the client
@@ -320,6 +368,7 @@ typedef struct {
      - SPLT_OPTION_TRIM_SILENCE_MODE
      - SPLT_OPTION_ERROR_MODE
      - SPLT_OPTION_TIME_MODE
+     - SPLT_OPTION_LIVE_MODE
   */
   splt_split_mode_options split_mode;
 
@@ -491,6 +540,10 @@ typedef struct {
   int stop_if_no_auto_adjust_found;
   int decode_and_write_flac_md5sum;
   int handle_bit_reservoir;
+  //! seconds to wait for the freedb server, 0 for no timeout
+  int freedb_timeout;
+  int live_split_on_silence;
+  int single_read_pass;
   int id3v2_encoding;
   int input_tags_encoding;
   long time_minimum_length;
@@ -535,6 +588,8 @@ typedef struct {
   int number_of_plugins_found;
   //!data structure about all the plugins
   splt_plugin_data *data;
+  //!SPLT_TRUE if #data is shared with the process-wide plugins registry
+  int uses_registry;
 } splt_plugins;
 
 //!structure containing error strings for error messages
@@ -572,6 +627,8 @@ struct _splt_state {
 
   char *default_comment_tag;
   char *default_genre_tag;
+  //!input_fname_regex compiled once, while the regex does not change
+  struct _splt_fr_regex *compiled_fname_regex;
 
   //!tags of the original file to split
   splt_original_tags original_tags;
@@ -629,6 +686,10 @@ struct _splt_state {
 #include "cue.h"
 #include "cddb.h"
 #include "freedb.h"
+#include "freedb_index.h"
+#include "freedb_cache.h"
+#include "output_sink.h"
+#include "segment_plan.h"
 #include "audacity.h"
 #include "splt_array.h"
 #include "string_utils.h"
@@ -650,6 +711,7 @@ struct _splt_state {
 #include "filename_regex.h"
 #include "win32.h"
 #include "proxy.h"
+#include "locks.h"
 
 #ifdef HAVE_CONFIG_H
 #include "config.h"
@@ -700,6 +762,7 @@ void splt_s_normal_split(splt_state *state, int *error);
 
 void splt_s_time_split(splt_state *state, int *error);
 void splt_s_equal_length_split(splt_state *state, int *error);
+void splt_s_live_split(splt_state *state, int *error);
 
 /************************************/
 /* splt silence detection and split */
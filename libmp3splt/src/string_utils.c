@@ -135,30 +135,25 @@ static int splt_su_append_one(char **str, const char *to_append, size_t to_appen
     return SPLT_OK;
   }
 
-  size_t new_size = 0;
+  to_append_size = strnlen(to_append, to_append_size);
 
-  if (*str == NULL)
+  size_t length = 0;
+  if (*str != NULL)
   {
-    new_size = to_append_size + 1;
-    *str = malloc(new_size);
-    if (*str == NULL)
-    {
-      return SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
-    }
-
-    *str[0] = '\0';
+    length = strlen(*str);
   }
-  else
+
+  char *new_str = realloc(*str, length + to_append_size + 1);
+  if (new_str == NULL)
   {
-    new_size = to_append_size + strlen(*str) + 1;
-    *str = realloc(*str, new_size);
-    if (*str == NULL)
-    {
-      return SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
-    }
+    free(*str);
+    *str = NULL;
+    return SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
   }
 
-  strncat(*str, to_append, to_append_size);
+  memcpy(new_str + length, to_append, to_append_size);
+  new_str[length + to_append_size] = '\0';
+  *str = new_str;
 
   return SPLT_OK;
 }
@@ -183,6 +178,131 @@ int splt_su_append(char **str, const char *to_append, ...)
   return err;
 }
 
+#define SPLT_STRING_BUILDER_MINIMUM_SIZE 64
+
+void splt_su_builder_init(splt_string_builder *sb)
+{
+  sb->str = NULL;
+  sb->length = 0;
+  sb->size = 0;
+}
+
+/*! \brief Makes room for \c more characters and the ending nul character
+
+The memory grows geometrically, so that appending many times costs a
+linear time in the final length.
+*/
+int splt_su_builder_reserve(splt_string_builder *sb, size_t more)
+{
+  size_t needed = sb->length + more + 1;
+  if (needed <= sb->size)
+  {
+    return SPLT_OK;
+  }
+
+  size_t new_size = sb->size;
+  if (new_size < SPLT_STRING_BUILDER_MINIMUM_SIZE)
+  {
+    new_size = SPLT_STRING_BUILDER_MINIMUM_SIZE;
+  }
+  while (new_size < needed)
+  {
+    new_size *= 2;
+  }
+
+  char *new_str = realloc(sb->str, new_size);
+  if (new_str == NULL)
+  {
+    return SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+  }
+
+  new_str[sb->length] = '\0';
+  sb->str = new_str;
+  sb->size = new_size;
+
+  return SPLT_OK;
+}
+
+int splt_su_builder_append(splt_string_builder *sb, const char *str, size_t length)
+{
+  int err = splt_su_builder_reserve(sb, length);
+  if (err < 0) { return err; }
+
+  memcpy(sb->str + sb->length, str, length);
+  sb->length += length;
+  sb->str[sb->length] = '\0';
+
+  return SPLT_OK;
+}
+
+int splt_su_builder_append_str(splt_string_builder *sb, const char *str)
+{
+  if (str == NULL)
+  {
+    return SPLT_OK;
+  }
+
+  return splt_su_builder_append(sb, str, strlen(str));
+}
+
+//! Keeps only the first \c length characters
+void splt_su_builder_truncate(splt_string_builder *sb, size_t length)
+{
+  if (length >= sb->length)
+  {
+    return;
+  }
+
+  sb->length = length;
+  sb->str[length] = '\0';
+}
+
+//! Removes the first \c length characters, keeping the allocated memory
+void splt_su_builder_remove_beginning(splt_string_builder *sb, size_t length)
+{
+  if (length == 0)
+  {
+    return;
+  }
+
+  if (length >= sb->length)
+  {
+    splt_su_builder_truncate(sb, 0);
+    return;
+  }
+
+  memmove(sb->str, sb->str + length, sb->length - length + 1);
+  sb->length -= length;
+}
+
+/*! \brief Returns the built string, to be freed by the caller
+
+Returns NULL if nothing was appended. The builder can be reused after.
+*/
+char *splt_su_builder_release(splt_string_builder *sb)
+{
+  char *str = sb->str;
+  if (str != NULL && sb->length == 0)
+  {
+    free(str);
+    str = NULL;
+  }
+
+  splt_su_builder_init(sb);
+
+  return str;
+}
+
+void splt_su_builder_free(splt_string_builder *sb)
+{
+  if (sb->str)
+  {
+    free(sb->str);
+  }
+
+  splt_su_builder_init(sb);
+}
+
 int splt_su_set(char **str, const char *to_append, ...)
 {
   if (!str)
@@ -280,43 +400,31 @@ static int splt_su_is_illegal_char(char c, int ignore_dirchar)
 
 static void splt_su_clean_string_(splt_state *state, char *s, int *error, int ignore_dirchar)
 {
-  int i = 0, j=0;
-  char *copy = NULL;
-  if (s)
+  if (!s)
+  {
+    return;
+  }
+
+  //illegal characters are replaced one for one, so no copy is needed
+  int i = 0;
+  for (i = 0; s[i] != '\0'; i++)
   {
-    copy = strdup(s);
-    if (copy)
+    if (splt_su_is_illegal_char(s[i], ignore_dirchar))
     {
-      for (i=0; i<=strlen(copy); i++)
-      {
-        if (! splt_su_is_illegal_char(copy[i], ignore_dirchar))
-        {
-          s[j++] = copy[i];
-        }
-        else
-        {
-          s[j++] = '_';
-        }
-      }
-      free(copy);
-      copy = NULL;
+      s[i] = '_';
+    }
+  }
 
-      // Trim string. I will never stop to be surprised about cddb strings dirtiness! ;-)
-      for (i=strlen(s)-1; i >= 0; i--) 
-      {
-        if (s[i]==' ')
-        {
-          s[i] = '\0';
-        }
-        else 
-        {
-          break;
-        }
-      }
+  // Trim string. I will never stop to be surprised about cddb strings dirtiness! ;-)
+  for (i--; i >= 0; i--)
+  {
+    if (s[i]==' ')
+    {
+      s[i] = '\0';
     }
-    else
+    else 
     {
-      *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+      break;
     }
   }
 }
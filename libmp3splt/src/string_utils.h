@@ -33,6 +33,15 @@
 
 #include <stdarg.h>
 
+//!growable string keeping its length, for appending without reallocating each time
+typedef struct {
+  //!NULL until something is appended
+  char *str;
+  size_t length;
+  //!allocated bytes of str
+  size_t size;
+} splt_string_builder;
+
 void splt_su_replace_all_char(char *str, char to_replace, char replacement);
 char *splt_su_replace_all(const char *str, char *to_replace, char *replacement, int *error);
 int splt_su_set(char **str, const char *to_append, ...);
@@ -41,6 +50,15 @@ int splt_su_append_str(char **str, const char *to_append, ...);
 void splt_su_free_replace(char **str, char *replacement);
 int splt_su_copy(const char *src, char **dest);
 
+void splt_su_builder_init(splt_string_builder *sb);
+int splt_su_builder_reserve(splt_string_builder *sb, size_t more);
+int splt_su_builder_append(splt_string_builder *sb, const char *str, size_t length);
+int splt_su_builder_append_str(splt_string_builder *sb, const char *str);
+void splt_su_builder_truncate(splt_string_builder *sb, size_t length);
+void splt_su_builder_remove_beginning(splt_string_builder *sb, size_t length);
+char *splt_su_builder_release(splt_string_builder *sb);
+void splt_su_builder_free(splt_string_builder *sb);
+
 void splt_su_clean_string(splt_state *state, char *s, int *error);
 void splt_su_cut_spaces_from_end(char *c);
 char *splt_su_cut_spaces(char *c);
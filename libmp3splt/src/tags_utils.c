@@ -389,64 +389,84 @@ static void splt_tu_set_empty_tags(splt_state *state, int index)
   splt_tu_reset_tags(&state->split.tags_group->tags[index]);
 }
 
-int splt_tu_new_tags_if_necessary(splt_state *state, int index)
-{
-  int error = SPLT_OK;
+/*! Makes room for \p number_of_tags tags in the tags group
 
+Importers knowing the number of tracks call it to avoid growing the tags
+group while appending.
+*/
+int splt_tu_reserve_tags(splt_state *state, int number_of_tags)
+{
   if (!state->split.tags_group)
   {
-    if (index != 0)
+    state->split.tags_group = malloc(sizeof(splt_tags_group));
+    if (state->split.tags_group == NULL)
     {
-      splt_e_error(SPLT_IERROR_INT,__func__, index, NULL);
+      return SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
     }
-    else
-    {
-      state->split.tags_group = malloc(sizeof(splt_tags_group));
-      if (state->split.tags_group == NULL)
-      {
-        return SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
-      }
 
-      state->split.tags_group->real_tagsnumber = 0;
-      state->split.tags_group->iterator_counter = 0;
+    state->split.tags_group->tags = NULL;
+    state->split.tags_group->real_tagsnumber = 0;
+    state->split.tags_group->allocated_tagsnumber = 0;
+    state->split.tags_group->iterator_counter = 0;
+  }
 
-      state->split.tags_group->tags = splt_tu_new_tags(&error);
-      if (error < 0)
-      {
-        free(state->split.tags_group); 
-        state->split.tags_group = NULL;
-        return error;
-      }
+  splt_tags_group *tags_group = state->split.tags_group;
+  if (number_of_tags <= tags_group->allocated_tagsnumber)
+  {
+    return SPLT_OK;
+  }
 
-      splt_tu_set_empty_tags(state, index);
-      state->split.tags_group->real_tagsnumber++;
-    }
+  splt_tags *new_tags = realloc(tags_group->tags, sizeof(splt_tags) * number_of_tags);
+  if (new_tags == NULL)
+  {
+    return SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
   }
-  else
+
+  tags_group->tags = new_tags;
+  tags_group->allocated_tagsnumber = number_of_tags;
+
+  return SPLT_OK;
+}
+
+int splt_tu_new_tags_if_necessary(splt_state *state, int index)
+{
+  int error = SPLT_OK;
+
+  int real_tags_number = 0;
+  if (state->split.tags_group)
   {
-    if ((index > state->split.tags_group->real_tagsnumber) || (index < 0))
-    {
-      splt_e_error(SPLT_IERROR_INT,__func__, index, NULL);
-    }
-    else
-    {
-      if (index == state->split.tags_group->real_tagsnumber)
-      {
-        if ((state->split.tags_group->tags = 
-              realloc(state->split.tags_group->tags, sizeof(splt_tags) * (index+1))) == NULL)
-        {
-          error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
-          return error;
-        }
-        else
-        {
-          splt_tu_set_empty_tags(state,index);
-          state->split.tags_group->real_tagsnumber++;
-        }
-      }
-    }
+    real_tags_number = state->split.tags_group->real_tagsnumber;
+  }
+
+  if ((index > real_tags_number) || (index < 0))
+  {
+    splt_e_error(SPLT_IERROR_INT,__func__, index, NULL);
+    return error;
   }
 
+  if (index < real_tags_number)
+  {
+    return error;
+  }
+
+  int allocated_tags_number = 0;
+  if (state->split.tags_group)
+  {
+    allocated_tags_number = state->split.tags_group->allocated_tagsnumber;
+  }
+
+  if (index >= allocated_tags_number)
+  {
+    int new_allocated = allocated_tags_number * 2;
+    if (new_allocated < 8) { new_allocated = 8; }
+
+    error = splt_tu_reserve_tags(state, new_allocated);
+    if (error < 0) { return error; }
+  }
+
+  splt_tu_set_empty_tags(state, index);
+  state->split.tags_group->real_tagsnumber++;
+
   return error;
 }
 
@@ -42,6 +42,7 @@ void splt_tu_free_one_tags(splt_tags **tags);
 void splt_tu_free_one_tags_content(splt_tags *tags);
 int splt_tu_has_one_tag_set(splt_tags *tags);
 void splt_tu_copy_tags(splt_tags *from, splt_tags *to, int *error);
+int splt_tu_reserve_tags(splt_state *state, int number_of_tags);
 int splt_tu_new_tags_if_necessary(splt_state *state, int index);
 int splt_tu_tags_exists(splt_state *state, int index);
 int splt_tu_set_tags_field(splt_state *state, int index,
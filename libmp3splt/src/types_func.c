@@ -50,6 +50,7 @@ static void splt_t_set_default_state_values(splt_state *state, int *error)
   state->input_fname_regex = NULL;
   state->default_comment_tag = NULL;
   state->default_genre_tag = NULL;
+  state->compiled_fname_regex = NULL;
   state->silence_log_fname = NULL;
   state->silence_full_log_fname = NULL;
   state->full_log_file_descriptor = NULL;
@@ -63,6 +64,11 @@ static void splt_t_set_default_state_values(splt_state *state, int *error)
   state->split.file_split_cb_data = NULL;
   state->split.write_cb = NULL;
   state->split.write_cb_data = NULL;
+  state->split.use_output_sink = SPLT_FALSE;
+  state->split.memory_sink_file_done = NULL;
+  state->split.memory_sink_cb_data = NULL;
+  state->split.fd_sink = -1;
+  state->split.output_file_complete = SPLT_TRUE;
   state->split.p_bar->progress_text_max_char = 40;
   snprintf(state->split.p_bar->filename_shorted,512, "%s","");
   state->split.p_bar->percent_progress = 0;
@@ -217,8 +223,14 @@ void splt_t_free_state(splt_state *state)
     splt_w_wrap_free(state);
     splt_se_serrors_free(state);
     splt_fu_freedb_free_search(state);
+    splt_fi_free_index(state);
+    splt_freedb_close_connection(state);
+    splt_fc_free(state);
     splt_t_free_splitpoints_tags(state);
     splt_o_iopts_free(state);
+#ifndef NO_PCRE
+    splt_fr_free_compiled_regex(state);
+#endif
     splt_p_free_plugins(state);
     if (state->split.p_bar)
     {
@@ -231,6 +243,51 @@ void splt_t_free_state(splt_state *state)
   }
 }
 
+/*! Cleans the data of the last split file, for splitting another file
+
+Keeps the options, the output format, the callbacks, the plugins and
+the memory allocated for the splitpoints.
+*/
+void splt_t_reset_state(splt_state *state)
+{
+  splt_tu_free_original_tags(state);
+  splt_original_tags *original_tags = &state->original_tags;
+  splt_tu_reset_tags(&original_tags->tags);
+  original_tags->all_original_tags = NULL;
+  original_tags->last_plugin_used = -100;
+
+  if (state->fname_to_split)
+  {
+    free(state->fname_to_split);
+    state->fname_to_split = NULL;
+  }
+
+  splt_sp_clear_splitpoints(state);
+  splt_tu_free_tags(state);
+  splt_w_wrap_free(state);
+  splt_se_serrors_free(state);
+  state->syncerrors = 0;
+  splt_fu_freedb_free_search(state);
+  splt_siu_ssplit_free(&state->silence_list);
+  splt_e_free_errors(state);
+
+  state->split.total_time = 0;
+  state->split.splitnumber = 0;
+  state->split.current_split = 0;
+  state->split.current_split_file_number = 1;
+
+  snprintf(state->split.p_bar->filename_shorted,512, "%s","");
+  state->split.p_bar->percent_progress = 0;
+  state->split.p_bar->current_split = 0;
+  state->split.p_bar->max_splits = 0;
+  state->split.p_bar->progress_type = SPLT_PROGRESS_PREPARE;
+  state->split.p_bar->silence_found_tracks = 0;
+  state->split.p_bar->silence_db_level = 0;
+
+  state->cancel_split = SPLT_FALSE;
+  splt_p_set_current_plugin(state, -1);
+}
+
 void splt_t_set_total_time(splt_state *state, long value)
 {
   splt_d_print_debug(state,"Setting total time to _%ld_\n", value);
@@ -393,7 +450,7 @@ char * splt_t_get_filename_to_split(splt_state *state)
   return state->fname_to_split;
 }
 
-static void splt_t_set_current_split_file_number(splt_state *state, int index)
+void splt_t_set_current_split_file_number(splt_state *state, int index)
 {
   state->split.current_split_file_number = index;
 }
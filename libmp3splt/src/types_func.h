@@ -33,6 +33,7 @@
 
 splt_state *splt_t_new_state(splt_state *state, int *error);
 void splt_t_free_state(splt_state *state);
+void splt_t_reset_state(splt_state *state);
 
 void splt_t_set_total_time(splt_state *state, long value);
 long splt_t_get_total_time(splt_state *state);
@@ -84,6 +85,7 @@ void splt_t_clean_split_data(splt_state *state,int tracks);
 int splt_t_split_is_canceled(splt_state *state);
 void splt_t_set_stop_split(splt_state *state, int bool_value);
 
+void splt_t_set_current_split_file_number(splt_state *state, int index);
 void splt_t_set_current_split_file_number_next(splt_state *state);
 
 #define SPLT_TYPES_FUNC_H
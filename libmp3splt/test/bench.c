@@ -0,0 +1,603 @@
+/*
+ * Throughput benchmarks for the libmp3splt hot paths, run on the corpus
+ * generated by splt_bench_corpus.
+ *
+ * Each benchmark runs in its own child process and prints one JSON object
+ * per line on the standard output:
+ *
+ *   {"benchmark":"time","type":"scenario","file":"cbr.mp3","status":0,
+ *    "bytes":4787160,"frames":11484,"runs":3,"seconds":0.052,
+ *    "mb_per_s":87.8,"frames_per_s":220846.2,"peak_rss_kb":3120}
+ *
+ * 'seconds' is the best of 'runs' runs and 'peak_rss_kb' is the peak
+ * resident set size of the child process. Micro benchmarks call the plugin
+ * functions directly (splt_mp3_findhead, the flac bit reader, the silence
+ * processors); scenarios split the corpus files through the public API.
+ *
+ * usage: splt_bench [-p plugins_dir] [-o output_dir] [-r runs] corpus_dir [benchmark]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include <ltdl.h>
+
+#include "splt.h"
+#include "silence_processors.h"
+
+#define MAX_CORPUS_FILES 32
+#define SILENCE_PROCESSOR_CALLS 2000000
+#define SILENCE_PROCESSOR_TIME_STEP 0.026122
+#define FLAC_BIT_READER_FLUSH_READS 1024
+
+typedef struct {
+  char name[256];
+  char format[32];
+  char path[4096];
+  long frames;
+  double seconds;
+  off_t bytes;
+} corpus_file;
+
+typedef struct {
+  const char *plugins_dir;
+  const char *output_dir;
+  int runs;
+  corpus_file files[MAX_CORPUS_FILES];
+  int number_of_files;
+} bench_context;
+
+typedef struct {
+  int status;
+  long frames;
+} bench_result;
+
+typedef bench_result (*bench_function)(bench_context *ctx, corpus_file *file);
+
+typedef struct {
+  const char *name;
+  const char *type;
+  //space separated list of corpus formats, NULL when not using the corpus
+  const char *formats;
+  bench_function function;
+} benchmark;
+
+static double now()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static long peak_rss_kb()
+{
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == -1)
+  {
+    return -1;
+  }
+  return usage.ru_maxrss;
+}
+
+static int format_matches(const char *formats, const char *format)
+{
+  size_t length = strlen(format);
+  const char *ptr = formats;
+  while ((ptr = strstr(ptr, format)) != NULL)
+  {
+    if ((ptr == formats || ptr[-1] == ' ') && (ptr[length] == ' ' || ptr[length] == '\0'))
+    {
+      return 1;
+    }
+    ptr += length;
+  }
+  return 0;
+}
+
+static int read_manifest(bench_context *ctx, const char *corpus_dir)
+{
+  char fname[4096];
+  snprintf(fname, sizeof(fname), "%s/corpus.txt", corpus_dir);
+
+  FILE *manifest = fopen(fname, "r");
+  if (manifest == NULL)
+  {
+    fprintf(stderr, "cannot open '%s': %s\n", fname, strerror(errno));
+    return -1;
+  }
+
+  corpus_file *file = &ctx->files[0];
+  while (ctx->number_of_files < MAX_CORPUS_FILES &&
+      fscanf(manifest, "%255s %31s %ld %lf", file->name, file->format,
+        &file->frames, &file->seconds) == 4)
+  {
+    snprintf(file->path, sizeof(file->path), "%s/%s", corpus_dir, file->name);
+
+    struct stat st;
+    if (stat(file->path, &st) == -1)
+    {
+      fprintf(stderr, "cannot stat '%s': %s\n", file->path, strerror(errno));
+      fclose(manifest);
+      return -1;
+    }
+    file->bytes = st.st_size;
+
+    ctx->number_of_files++;
+    file = &ctx->files[ctx->number_of_files];
+  }
+
+  fclose(manifest);
+  return 0;
+}
+
+static void remove_output_files(const char *directory)
+{
+  DIR *dir = opendir(directory);
+  if (dir == NULL) { return; }
+
+  struct dirent *entry = NULL;
+  while ((entry = readdir(dir)) != NULL)
+  {
+    if (entry->d_name[0] == '.') { continue; }
+
+    char fname[4096];
+    snprintf(fname, sizeof(fname), "%s/%s", directory, entry->d_name);
+    unlink(fname);
+  }
+
+  closedir(dir);
+}
+
+static lt_dlhandle open_plugin(bench_context *ctx, const char *name)
+{
+  char fname[4096];
+  snprintf(fname, sizeof(fname), "%s/libsplt_%s", ctx->plugins_dir, name);
+
+  lt_dlinit();
+  lt_dlhandle plugin = lt_dlopenext(fname);
+  if (plugin == NULL)
+  {
+    fprintf(stderr, "%s: %s\n", fname, lt_dlerror());
+  }
+
+  return plugin;
+}
+
+static splt_state *new_state(bench_context *ctx, const char *input, int *error)
+{
+  splt_state *state = mp3splt_new_state(error);
+  if (*error < 0) { return NULL; }
+
+  mp3splt_append_plugins_scan_dir(state, ctx->plugins_dir);
+  *error = mp3splt_find_plugins(state);
+  if (*error < 0)
+  {
+    mp3splt_free_state(state);
+    return NULL;
+  }
+
+  if (input)
+  {
+    mp3splt_set_filename_to_split(state, input);
+  }
+
+  return state;
+}
+
+/* micro benchmarks */
+
+static bench_result bench_mp3_findhead(bench_context *ctx, corpus_file *file)
+{
+  bench_result result = { SPLT_OK, 0 };
+
+  lt_dlhandle plugin = open_plugin(ctx, "mp3");
+  if (plugin == NULL) { result.status = SPLT_ERROR_NO_PLUGIN_FOUND; return result; }
+
+  void (*init)(splt_state *, int *) = lt_dlsym(plugin, "splt_pl_init");
+  void (*end)(splt_state *, int *) = lt_dlsym(plugin, "splt_pl_end");
+  off_t (*findhead)(void *, off_t) = lt_dlsym(plugin, "splt_mp3_findhead");
+  if (!init || !end || !findhead) { result.status = SPLT_ERROR_PLUGIN_ERROR; goto close_plugin; }
+
+  int error = SPLT_OK;
+  splt_state *state = new_state(ctx, file->path, &error);
+  if (state == NULL) { result.status = error; goto close_plugin; }
+
+  init(state, &error);
+  if (error >= 0)
+  {
+    off_t offset = findhead(state->codec, 0);
+    while (offset != -1)
+    {
+      result.frames++;
+      offset = findhead(state->codec, offset + 1);
+    }
+
+    end(state, &error);
+  }
+
+  result.status = error;
+  mp3splt_free_state(state);
+
+close_plugin:
+  lt_dlclose(plugin);
+  return result;
+}
+
+static bench_result bench_flac_bit_reader(bench_context *ctx, corpus_file *file)
+{
+  bench_result result = { SPLT_OK, 0 };
+
+  lt_dlhandle plugin = open_plugin(ctx, "flac");
+  if (plugin == NULL) { result.status = SPLT_ERROR_NO_PLUGIN_FOUND; return result; }
+
+  void *(*fr_new)(FILE *, const char *) = lt_dlsym(plugin, "splt_flac_fr_new");
+  void (*fr_free)(void *) = lt_dlsym(plugin, "splt_flac_fr_free");
+  unsigned char (*read_bit)(void *, int *) = lt_dlsym(plugin, "splt_flac_u_read_bit");
+  unsigned char (*read_bits)(void *, unsigned char, int *) =
+    lt_dlsym(plugin, "splt_flac_u_read_bits");
+  unsigned (*read_unsigned)(void *, int *) = lt_dlsym(plugin, "splt_flac_u_read_unsigned");
+  void (*process_frame)(void *, unsigned, splt_state *, int *, void *, void *) =
+    lt_dlsym(plugin, "splt_flac_u_process_frame");
+  if (!fr_new || !fr_free || !read_bit || !read_bits || !read_unsigned || !process_frame)
+  {
+    result.status = SPLT_ERROR_PLUGIN_ERROR;
+    goto close_plugin;
+  }
+
+  FILE *in = fopen(file->path, "rb");
+  if (in == NULL) { result.status = SPLT_ERROR_CANNOT_OPEN_FILE; goto close_plugin; }
+
+  void *fr = fr_new(in, file->path);
+  if (fr == NULL) { fclose(in); result.status = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY; goto close_plugin; }
+
+  int error = SPLT_OK;
+  long reads = 0;
+  while (error == SPLT_OK)
+  {
+    read_bits(fr, 4, &error);
+    read_bit(fr, &error);
+    read_bits(fr, 3, &error);
+    read_unsigned(fr, &error);
+
+    //drop the bytes accumulated for the output frame
+    if (++reads % FLAC_BIT_READER_FLUSH_READS == 0)
+    {
+      process_frame(fr, 0, NULL, &error, NULL, NULL);
+    }
+  }
+
+  result.status = (error == SPLT_OK_SPLIT_EOF) ? SPLT_OK : error;
+  result.frames = file->frames;
+
+  fr_free(fr);
+  fclose(in);
+
+close_plugin:
+  lt_dlclose(plugin);
+  return result;
+}
+
+static bench_result bench_silence_processor(bench_context *ctx, const char *processor_name)
+{
+  bench_result result = { SPLT_OK, 0 };
+
+  lt_dlhandle plugin = open_plugin(ctx, "mp3");
+  if (plugin == NULL) { plugin = open_plugin(ctx, "flac"); }
+  if (plugin == NULL) { plugin = open_plugin(ctx, "ogg"); }
+  if (plugin == NULL) { result.status = SPLT_ERROR_NO_PLUGIN_FOUND; return result; }
+
+  splt_scan_silence_data *(*data_new)(splt_state *, short, float, int, short) =
+    lt_dlsym(plugin, "splt_scan_silence_data_new");
+  void (*data_free)(splt_scan_silence_data **) = lt_dlsym(plugin, "splt_free_scan_silence_data");
+  short (*processor)(double, float, int, short, splt_scan_silence_data *, int *, int *) =
+    lt_dlsym(plugin, processor_name);
+  if (!data_new || !data_free || !processor) { result.status = SPLT_ERROR_PLUGIN_ERROR; goto close_plugin; }
+
+  int error = SPLT_OK;
+  splt_state *state = new_state(ctx, NULL, &error);
+  if (state == NULL) { result.status = error; goto close_plugin; }
+
+  splt_scan_silence_data *ssd = data_new(state, SPLT_TRUE, 0, SPLT_DEFAULT_PARAM_SHOTS, SPLT_TRUE);
+  if (ssd == NULL) { result.status = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY; goto free_state; }
+
+  int found = 0;
+  long i = 0;
+  for (i = 0;i < SILENCE_PROCESSOR_CALLS && error >= 0;i++)
+  {
+    double time = i * SILENCE_PROCESSOR_TIME_STEP;
+    //20 seconds of sound followed by 3 seconds of silence
+    int silence = ((long) time % 23) >= 20;
+    float level = silence ? -90.0 : -10.0;
+    processor(time, level, silence, SPLT_FALSE, ssd, &found, &error);
+  }
+  processor(-1, 0, SPLT_FALSE, SPLT_TRUE, ssd, &found, &error);
+
+  result.status = error;
+  result.frames = i;
+
+  data_free(&ssd);
+free_state:
+  mp3splt_free_state(state);
+close_plugin:
+  lt_dlclose(plugin);
+  return result;
+}
+
+static bench_result bench_scan_silence_processor(bench_context *ctx, corpus_file *file)
+{
+  return bench_silence_processor(ctx, "splt_scan_silence_processor");
+}
+
+static bench_result bench_trim_silence_processor(bench_context *ctx, corpus_file *file)
+{
+  return bench_silence_processor(ctx, "splt_trim_silence_processor");
+}
+
+/* scenarios */
+
+static splt_state *new_split_state(bench_context *ctx, corpus_file *file, int split_mode,
+    int *error)
+{
+  splt_state *state = new_state(ctx, file->path, error);
+  if (state == NULL) { return NULL; }
+
+  mp3splt_set_path_of_split(state, ctx->output_dir);
+  mp3splt_set_int_option(state, SPLT_OPT_SPLIT_MODE, split_mode);
+  mp3splt_set_int_option(state, SPLT_OPT_OUTPUT_FILENAMES, SPLT_OUTPUT_FORMAT);
+  mp3splt_set_oformat(state, "@f_@n");
+
+  return state;
+}
+
+static void append_splitpoints(splt_state *state, double seconds, double step)
+{
+  double time = 0;
+  for (time = 0;time < seconds;time += step)
+  {
+    splt_point *point = mp3splt_point_new((long) (time * 100), NULL);
+    mp3splt_append_splitpoint(state, point);
+  }
+
+  mp3splt_append_splitpoint(state, mp3splt_point_new(LONG_MAX, NULL));
+}
+
+static bench_result run_split(splt_state *state, corpus_file *file)
+{
+  bench_result result = { SPLT_OK, file->frames };
+
+  result.status = mp3splt_split(state);
+  mp3splt_free_state(state);
+
+  return result;
+}
+
+static bench_result run_normal_split(bench_context *ctx, corpus_file *file, double step,
+    int frame_mode, int auto_adjust)
+{
+  int error = SPLT_OK;
+  splt_state *state = new_split_state(ctx, file, SPLT_OPTION_NORMAL_MODE, &error);
+  if (state == NULL) { bench_result result = { error, 0 }; return result; }
+
+  mp3splt_set_int_option(state, SPLT_OPT_FRAME_MODE, frame_mode);
+  mp3splt_set_int_option(state, SPLT_OPT_AUTO_ADJUST, auto_adjust);
+  append_splitpoints(state, file->seconds, step);
+
+  return run_split(state, file);
+}
+
+static bench_result bench_mp3_simple_split(bench_context *ctx, corpus_file *file)
+{
+  //one split of the whole file without frame mode is a single simple split
+  return run_normal_split(ctx, file, file->seconds + 1, SPLT_FALSE, SPLT_FALSE);
+}
+
+static bench_result bench_normal(bench_context *ctx, corpus_file *file)
+{
+  return run_normal_split(ctx, file, 30, SPLT_FALSE, SPLT_FALSE);
+}
+
+static bench_result bench_normal_frame_mode(bench_context *ctx, corpus_file *file)
+{
+  return run_normal_split(ctx, file, 30, SPLT_TRUE, SPLT_FALSE);
+}
+
+static bench_result bench_auto_adjust(bench_context *ctx, corpus_file *file)
+{
+  return run_normal_split(ctx, file, 30, SPLT_FALSE, SPLT_TRUE);
+}
+
+static bench_result run_mode_split(bench_context *ctx, corpus_file *file, int split_mode)
+{
+  int error = SPLT_OK;
+  splt_state *state = new_split_state(ctx, file, split_mode, &error);
+  if (state == NULL) { bench_result result = { error, 0 }; return result; }
+
+  if (split_mode == SPLT_OPTION_TIME_MODE)
+  {
+    mp3splt_set_float_option(state, SPLT_OPT_SPLIT_TIME, 60);
+  }
+
+  return run_split(state, file);
+}
+
+static bench_result bench_time(bench_context *ctx, corpus_file *file)
+{
+  return run_mode_split(ctx, file, SPLT_OPTION_TIME_MODE);
+}
+
+static bench_result bench_silence(bench_context *ctx, corpus_file *file)
+{
+  return run_mode_split(ctx, file, SPLT_OPTION_SILENCE_MODE);
+}
+
+static bench_result bench_trim(bench_context *ctx, corpus_file *file)
+{
+  return run_mode_split(ctx, file, SPLT_OPTION_TRIM_SILENCE_MODE);
+}
+
+static bench_result bench_wrap(bench_context *ctx, corpus_file *file)
+{
+  return run_mode_split(ctx, file, SPLT_OPTION_WRAP_MODE);
+}
+
+static bench_result bench_sync_errors(bench_context *ctx, corpus_file *file)
+{
+  return run_mode_split(ctx, file, SPLT_OPTION_ERROR_MODE);
+}
+
+static const benchmark benchmarks[] =
+{
+  { "mp3_findhead", "micro", "mp3", bench_mp3_findhead },
+  { "mp3_simple_split", "micro", "mp3", bench_mp3_simple_split },
+  { "flac_bit_reader", "micro", "flac", bench_flac_bit_reader },
+  { "scan_silence_processor", "micro", NULL, bench_scan_silence_processor },
+  { "trim_silence_processor", "micro", NULL, bench_trim_silence_processor },
+  { "normal", "scenario", "mp3 flac ogg", bench_normal },
+  { "normal_frame_mode", "scenario", "mp3", bench_normal_frame_mode },
+  { "time", "scenario", "mp3 flac ogg", bench_time },
+  { "silence", "scenario", "mp3 flac ogg", bench_silence },
+  { "trim", "scenario", "mp3 flac ogg", bench_trim },
+  { "auto_adjust", "scenario", "mp3 flac ogg", bench_auto_adjust },
+  { "wrap", "scenario", "mp3wrap", bench_wrap },
+  { "sync_errors", "scenario", "mp3", bench_sync_errors },
+};
+
+static void run_benchmark(bench_context *ctx, const benchmark *bench, corpus_file *file)
+{
+  bench_result result = { SPLT_OK, 0 };
+  double best = -1;
+
+  int run = 0;
+  for (run = 0;run < ctx->runs;run++)
+  {
+    double start = now();
+    result = bench->function(ctx, file);
+    double seconds = now() - start;
+
+    remove_output_files(ctx->output_dir);
+
+    if (result.status < 0) { break; }
+    if (best < 0 || seconds < best) { best = seconds; }
+  }
+
+  off_t bytes = file ? file->bytes : 0;
+  double mb_per_s = (best > 0 && bytes > 0) ? bytes / best / (1024.0 * 1024.0) : 0;
+  double frames_per_s = (best > 0) ? result.frames / best : 0;
+
+  printf("{\"benchmark\":\"%s\",\"type\":\"%s\",\"file\":\"%s\",\"status\":%d,"
+      "\"bytes\":%lld,\"frames\":%ld,\"runs\":%d,\"seconds\":%.6f,"
+      "\"mb_per_s\":%.3f,\"frames_per_s\":%.1f,\"peak_rss_kb\":%ld}\n",
+      bench->name, bench->type, file ? file->name : "", result.status,
+      (long long) bytes, result.frames, run, best < 0 ? 0 : best,
+      mb_per_s, frames_per_s, peak_rss_kb());
+  fflush(stdout);
+}
+
+//! Runs the benchmark in a child so that the peak RSS is its own
+static int run_benchmark_in_child(bench_context *ctx, const benchmark *bench, corpus_file *file)
+{
+  fflush(stdout);
+
+  pid_t pid = fork();
+  if (pid == -1)
+  {
+    fprintf(stderr, "fork: %s\n", strerror(errno));
+    return -1;
+  }
+
+  if (pid == 0)
+  {
+    run_benchmark(ctx, bench, file);
+    exit(0);
+  }
+
+  int status = 0;
+  if (waitpid(pid, &status, 0) == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+  {
+    printf("{\"benchmark\":\"%s\",\"type\":\"%s\",\"file\":\"%s\",\"status\":\"crashed\"}\n",
+        bench->name, bench->type, file ? file->name : "");
+    return -1;
+  }
+
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  bench_context ctx;
+  memset(&ctx, 0, sizeof(ctx));
+  ctx.plugins_dir = "../plugins/.libs";
+  ctx.output_dir = "bench_output";
+  ctx.runs = 3;
+
+  const char *corpus_dir = NULL;
+  const char *only = NULL;
+
+  int i = 1;
+  for (i = 1;i < argc;i++)
+  {
+    if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) { ctx.plugins_dir = argv[++i]; }
+    else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) { ctx.output_dir = argv[++i]; }
+    else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) { ctx.runs = atoi(argv[++i]); }
+    else if (corpus_dir == NULL) { corpus_dir = argv[i]; }
+    else { only = argv[i]; }
+  }
+
+  if (corpus_dir == NULL || ctx.runs <= 0)
+  {
+    fprintf(stderr, "usage: %s [-p plugins_dir] [-o output_dir] [-r runs] "
+        "corpus_dir [benchmark]\n", argv[0]);
+    return 1;
+  }
+
+  if (read_manifest(&ctx, corpus_dir) < 0)
+  {
+    return 1;
+  }
+
+  if (mkdir(ctx.output_dir, 0755) == -1 && errno != EEXIST)
+  {
+    fprintf(stderr, "cannot create '%s': %s\n", ctx.output_dir, strerror(errno));
+    return 1;
+  }
+
+  int failures = 0;
+  size_t b = 0;
+  for (b = 0;b < sizeof(benchmarks) / sizeof(benchmark);b++)
+  {
+    const benchmark *bench = &benchmarks[b];
+    if (only && strcmp(only, bench->name) != 0) { continue; }
+
+    if (bench->formats == NULL)
+    {
+      failures += run_benchmark_in_child(&ctx, bench, NULL) < 0;
+      continue;
+    }
+
+    int f = 0;
+    for (f = 0;f < ctx.number_of_files;f++)
+    {
+      corpus_file *file = &ctx.files[f];
+      if (!format_matches(bench->formats, file->format)) { continue; }
+      //sync errors split only makes sense on the file having errors
+      if (bench->function == bench_sync_errors && strstr(file->name, "sync") == NULL) { continue; }
+
+      failures += run_benchmark_in_child(&ctx, bench, file) < 0;
+    }
+  }
+
+  rmdir(ctx.output_dir);
+
+  return failures ? 1 : 0;
+}
+
@@ -0,0 +1,802 @@
+/*
+ * Generates the synthetic corpus used by splt_bench:
+ *
+ *   cbr.mp3          mpeg 1 layer 3 128 kbps mono, sound and silence
+ *   vbr.mp3          same, with the bitrate changing at every frame
+ *   sync_errors.mp3  cbr with garbage inserted between frames
+ *   wrap.mp3         cbr parts wrapped with a mp3wrap index
+ *   flac_8.flac, flac_16.flac, flac_24.flac
+ *                    stereo 44100 Hz with verbatim subframes
+ *   chained.ogg      several chained silent vorbis streams
+ *
+ * The audio is produced by hand so that no encoder is needed: mp3 frames
+ * carry random huffman data (table 1 accepts any bit sequence) for sound
+ * and empty granules for silence, flac frames are verbatim and vorbis
+ * packets have all their floors unused.
+ *
+ * A manifest 'corpus.txt' lists each file with its format, number of
+ * frames (or packets) and duration in seconds.
+ *
+ * usage: splt_bench_corpus [-m minutes] output_directory
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#define SAMPLE_RATE 44100
+#define SOUND_SECONDS 20
+#define SILENCE_SECONDS 3
+
+#define MP3_SAMPLES_PER_FRAME 1152
+#define MP3_SIDE_INFO_SIZE 17
+#define MP3_CBR_BITRATE_INDEX 9
+#define MP3_SOUND_GLOBAL_GAIN 185
+#define MP3_SYNC_ERROR_EVERY_FRAMES 97
+#define MP3_WRAPPED_FILES 8
+
+#define FLAC_BLOCKSIZE 4096
+#define FLAC_CHANNELS 2
+
+#define OGG_CHAINED_STREAMS 4
+#define OGG_PACKETS_PER_PAGE 200
+#define VORBIS_SHORT_BLOCK_SAMPLES 128
+
+static const int mp3_bitrates[] =
+{ 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320 };
+
+static unsigned long random_state = 0x2545F491UL;
+
+static unsigned long next_random()
+{
+  random_state ^= (random_state << 13) & 0xffffffffUL;
+  random_state ^= random_state >> 17;
+  random_state ^= (random_state << 5) & 0xffffffffUL;
+  random_state &= 0xffffffffUL;
+  return random_state;
+}
+
+static int is_sound(double seconds)
+{
+  long position = (long) seconds % (SOUND_SECONDS + SILENCE_SECONDS);
+  return position < SOUND_SECONDS;
+}
+
+typedef struct {
+  unsigned char *buffer;
+  size_t bit_position;
+} bit_writer;
+
+//! Writes the 'bits' least significant bits of value, most significant first
+static void put_bits_msb(bit_writer *bw, unsigned long value, int bits)
+{
+  int i = 0;
+  for (i = bits - 1;i >= 0;i--)
+  {
+    if ((value >> i) & 1)
+    {
+      bw->buffer[bw->bit_position / 8] |= (unsigned char) (0x80 >> (bw->bit_position % 8));
+    }
+    bw->bit_position++;
+  }
+}
+
+//! Writes the 'bits' least significant bits of value, least significant first
+static void put_bits_lsb(bit_writer *bw, unsigned long value, int bits)
+{
+  int i = 0;
+  for (i = 0;i < bits;i++)
+  {
+    if ((value >> i) & 1)
+    {
+      bw->buffer[bw->bit_position / 8] |= (unsigned char) (1 << (bw->bit_position % 8));
+    }
+    bw->bit_position++;
+  }
+}
+
+static FILE *open_output(const char *directory, const char *name)
+{
+  char fname[4096];
+  snprintf(fname, sizeof(fname), "%s/%s", directory, name);
+
+  FILE *file = fopen(fname, "wb");
+  if (file == NULL)
+  {
+    fprintf(stderr, "cannot open '%s': %s\n", fname, strerror(errno));
+  }
+
+  return file;
+}
+
+/* mp3 */
+
+static int mp3_frame_size(int bitrate_index)
+{
+  return 144000 * mp3_bitrates[bitrate_index] / SAMPLE_RATE;
+}
+
+static int write_mp3_frame(FILE *out, int bitrate_index, int sound)
+{
+  unsigned char frame[1441];
+  int frame_size = mp3_frame_size(bitrate_index);
+  memset(frame, 0, frame_size);
+
+  //mpeg 1, layer 3, no crc, 44100 Hz, no padding, mono, original
+  frame[0] = 0xFF;
+  frame[1] = 0xFB;
+  frame[2] = (unsigned char) (bitrate_index << 4);
+  frame[3] = 0xC4;
+
+  //silence: main_data_begin 0 and empty granules, everything is 0
+  if (sound)
+  {
+    int main_data_bits = (frame_size - 4 - MP3_SIDE_INFO_SIZE) * 8;
+    int part2_3_length = main_data_bits / 2;
+    if (part2_3_length > 4095) { part2_3_length = 4095; }
+
+    bit_writer bw = { frame + 4, 0 };
+    put_bits_msb(&bw, 0, 9);
+    put_bits_msb(&bw, 0, 5);
+    put_bits_msb(&bw, 0, 4);
+
+    int granule = 0;
+    for (granule = 0;granule < 2;granule++)
+    {
+      put_bits_msb(&bw, part2_3_length, 12);
+      put_bits_msb(&bw, 100, 9);
+      put_bits_msb(&bw, MP3_SOUND_GLOBAL_GAIN, 8);
+      put_bits_msb(&bw, 0, 4);
+      put_bits_msb(&bw, 0, 1);
+      put_bits_msb(&bw, 1, 5);
+      put_bits_msb(&bw, 1, 5);
+      put_bits_msb(&bw, 1, 5);
+      put_bits_msb(&bw, 7, 4);
+      put_bits_msb(&bw, 7, 3);
+      put_bits_msb(&bw, 0, 1);
+      put_bits_msb(&bw, 0, 1);
+      put_bits_msb(&bw, 1, 1);
+    }
+
+    int i = 0;
+    for (i = 4 + MP3_SIDE_INFO_SIZE;i < frame_size;i++)
+    {
+      frame[i] = (unsigned char) next_random();
+    }
+  }
+
+  if (fwrite(frame, frame_size, 1, out) != 1)
+  {
+    return -1;
+  }
+
+  return frame_size;
+}
+
+static int choose_bitrate_index(int vbr)
+{
+  if (!vbr)
+  {
+    return MP3_CBR_BITRATE_INDEX;
+  }
+
+  return 5 + (int) (next_random() % 10);
+}
+
+//! Writes frames to out and returns the number of bytes written or -1
+static long write_mp3_frames(FILE *out, long first_frame, long frames,
+    int vbr, int sync_errors)
+{
+  long bytes = 0;
+  long i = 0;
+  for (i = first_frame;i < first_frame + frames;i++)
+  {
+    double seconds = (double) i * MP3_SAMPLES_PER_FRAME / SAMPLE_RATE;
+    int written = write_mp3_frame(out, choose_bitrate_index(vbr), is_sound(seconds));
+    if (written < 0) { return -1; }
+    bytes += written;
+
+    if (sync_errors && (i % MP3_SYNC_ERROR_EVERY_FRAMES) == MP3_SYNC_ERROR_EVERY_FRAMES - 1)
+    {
+      int garbage = 50 + (int) (next_random() % 250);
+      int j = 0;
+      for (j = 0;j < garbage;j++)
+      {
+        fputc((int) (next_random() & 0x7f), out);
+      }
+      bytes += garbage;
+    }
+  }
+
+  return bytes;
+}
+
+static long generate_mp3(const char *directory, const char *name, long frames,
+    int vbr, int sync_errors)
+{
+  FILE *out = open_output(directory, name);
+  if (out == NULL) { return -1; }
+
+  long bytes = write_mp3_frames(out, 0, frames, vbr, sync_errors);
+
+  if (fclose(out) != 0) { return -1; }
+  return bytes;
+}
+
+static void put_word(FILE *out, unsigned long word)
+{
+  fputc((int) ((word >> 24) & 0xff), out);
+  fputc((int) ((word >> 16) & 0xff), out);
+  fputc((int) ((word >> 8) & 0xff), out);
+  fputc((int) (word & 0xff), out);
+}
+
+/*! mp3wrap index: "WRAP", version, index version 0 (no crc), number of
+  files, begin offset and then a file name with its end offset for each
+  wrapped file; offsets are relative to "WRAP"
+*/
+static long generate_wrap(const char *directory, const char *name, long frames)
+{
+  FILE *out = open_output(directory, name);
+  if (out == NULL) { return -1; }
+
+  char names[MP3_WRAPPED_FILES][32];
+  long index_size = 4 + 4 + 4;
+  int i = 0;
+  for (i = 0;i < MP3_WRAPPED_FILES;i++)
+  {
+    snprintf(names[i], sizeof(names[i]), "wrapped_%02d.mp3", i + 1);
+    index_size += strlen(names[i]) + 1 + 4;
+  }
+
+  long frames_per_file = frames / MP3_WRAPPED_FILES;
+  long bytes_per_file = frames_per_file * mp3_frame_size(MP3_CBR_BITRATE_INDEX);
+
+  fwrite("WRAP", 4, 1, out);
+  fputc('3', out);
+  fputc('9', out);
+  fputc(0, out);
+  fputc(MP3_WRAPPED_FILES, out);
+  put_word(out, index_size);
+  for (i = 0;i < MP3_WRAPPED_FILES;i++)
+  {
+    fwrite(names[i], strlen(names[i]) + 1, 1, out);
+    put_word(out, index_size + (i + 1) * bytes_per_file);
+  }
+
+  long bytes = index_size;
+  for (i = 0;i < MP3_WRAPPED_FILES;i++)
+  {
+    long written = write_mp3_frames(out, i * frames_per_file, frames_per_file, 0, 0);
+    if (written < 0) { fclose(out); return -1; }
+    bytes += written;
+  }
+
+  if (fclose(out) != 0) { return -1; }
+  return bytes;
+}
+
+/* flac */
+
+static unsigned char crc8(const unsigned char *data, size_t length)
+{
+  unsigned char crc = 0;
+  size_t i = 0;
+  for (i = 0;i < length;i++)
+  {
+    crc ^= data[i];
+    int j = 0;
+    for (j = 0;j < 8;j++)
+    {
+      crc = (crc & 0x80) ? (unsigned char) ((crc << 1) ^ 0x07) : (unsigned char) (crc << 1);
+    }
+  }
+  return crc;
+}
+
+static unsigned crc16(const unsigned char *data, size_t length)
+{
+  unsigned crc = 0;
+  size_t i = 0;
+  for (i = 0;i < length;i++)
+  {
+    crc ^= ((unsigned) data[i]) << 8;
+    int j = 0;
+    for (j = 0;j < 8;j++)
+    {
+      crc = (crc & 0x8000) ? ((crc << 1) ^ 0x8005) : (crc << 1);
+      crc &= 0xffff;
+    }
+  }
+  return crc;
+}
+
+static int put_utf8_number(unsigned char *buffer, unsigned long number)
+{
+  if (number < 0x80)
+  {
+    buffer[0] = (unsigned char) number;
+    return 1;
+  }
+  if (number < 0x800)
+  {
+    buffer[0] = (unsigned char) (0xC0 | (number >> 6));
+    buffer[1] = (unsigned char) (0x80 | (number & 0x3F));
+    return 2;
+  }
+  if (number < 0x10000)
+  {
+    buffer[0] = (unsigned char) (0xE0 | (number >> 12));
+    buffer[1] = (unsigned char) (0x80 | ((number >> 6) & 0x3F));
+    buffer[2] = (unsigned char) (0x80 | (number & 0x3F));
+    return 3;
+  }
+
+  buffer[0] = (unsigned char) (0xF0 | (number >> 18));
+  buffer[1] = (unsigned char) (0x80 | ((number >> 12) & 0x3F));
+  buffer[2] = (unsigned char) (0x80 | ((number >> 6) & 0x3F));
+  buffer[3] = (unsigned char) (0x80 | (number & 0x3F));
+  return 4;
+}
+
+static void write_flac_streaminfo(FILE *out, int bits_per_sample, unsigned long total_samples,
+    int frame_size)
+{
+  unsigned char streaminfo[4 + 34];
+  memset(streaminfo, 0, sizeof(streaminfo));
+
+  //last metadata block, type STREAMINFO, length 34
+  streaminfo[0] = 0x80;
+  streaminfo[3] = 34;
+
+  bit_writer bw = { streaminfo + 4, 0 };
+  put_bits_msb(&bw, FLAC_BLOCKSIZE, 16);
+  put_bits_msb(&bw, FLAC_BLOCKSIZE, 16);
+  put_bits_msb(&bw, frame_size, 24);
+  put_bits_msb(&bw, frame_size, 24);
+  put_bits_msb(&bw, SAMPLE_RATE, 20);
+  put_bits_msb(&bw, FLAC_CHANNELS - 1, 3);
+  put_bits_msb(&bw, bits_per_sample - 1, 5);
+  put_bits_msb(&bw, 0, 4);
+  put_bits_msb(&bw, total_samples, 32);
+  //md5 left to 0: unknown
+
+  fwrite("fLaC", 4, 1, out);
+  fwrite(streaminfo, sizeof(streaminfo), 1, out);
+}
+
+static long generate_flac(const char *directory, const char *name, long frames,
+    int bits_per_sample)
+{
+  FILE *out = open_output(directory, name);
+  if (out == NULL) { return -1; }
+
+  int bytes_per_sample = bits_per_sample / 8;
+  size_t max_frame_size = 16 + FLAC_CHANNELS * (1 + FLAC_BLOCKSIZE * bytes_per_sample) + 2;
+  unsigned char *frame = malloc(max_frame_size);
+  if (frame == NULL) { fclose(out); return -1; }
+
+  int sample_size_code = 1;
+  if (bits_per_sample == 16) { sample_size_code = 4; }
+  else if (bits_per_sample == 24) { sample_size_code = 6; }
+
+  write_flac_streaminfo(out, bits_per_sample, (unsigned long) frames * FLAC_BLOCKSIZE, 0);
+  long bytes = 4 + 4 + 34;
+
+  //sound amplitude at about -12 dB
+  long amplitude = (1L << (bits_per_sample - 1)) / 4;
+
+  long i = 0;
+  for (i = 0;i < frames;i++)
+  {
+    size_t length = 0;
+    frame[length++] = 0xFF;
+    frame[length++] = 0xF8;
+    //blocksize 4096, 44100 Hz
+    frame[length++] = 0xC9;
+    //2 independent channels, sample size
+    frame[length++] = (unsigned char) (((FLAC_CHANNELS - 1) << 4) | (sample_size_code << 1));
+    length += put_utf8_number(frame + length, (unsigned long) i);
+    frame[length] = crc8(frame, length);
+    length++;
+
+    int sound = is_sound((double) i * FLAC_BLOCKSIZE / SAMPLE_RATE);
+
+    int channel = 0;
+    for (channel = 0;channel < FLAC_CHANNELS;channel++)
+    {
+      //verbatim subframe, no wasted bits
+      frame[length++] = 0x02;
+
+      int s = 0;
+      for (s = 0;s < FLAC_BLOCKSIZE;s++)
+      {
+        long sample = 0;
+        if (sound)
+        {
+          sample = (long) (next_random() % (unsigned long) (2 * amplitude)) - amplitude;
+        }
+
+        int b = 0;
+        for (b = bytes_per_sample - 1;b >= 0;b--)
+        {
+          frame[length++] = (unsigned char) ((((unsigned long) sample) >> (b * 8)) & 0xff);
+        }
+      }
+    }
+
+    unsigned crc = crc16(frame, length);
+    frame[length++] = (unsigned char) (crc >> 8);
+    frame[length++] = (unsigned char) (crc & 0xff);
+
+    if (fwrite(frame, length, 1, out) != 1)
+    {
+      free(frame);
+      fclose(out);
+      return -1;
+    }
+    bytes += length;
+  }
+
+  free(frame);
+  if (fclose(out) != 0) { return -1; }
+  return bytes;
+}
+
+/* ogg vorbis */
+
+static unsigned long ogg_crc_table[256];
+
+static void init_ogg_crc_table()
+{
+  unsigned long i = 0;
+  for (i = 0;i < 256;i++)
+  {
+    unsigned long r = i << 24;
+    int j = 0;
+    for (j = 0;j < 8;j++)
+    {
+      r = (r & 0x80000000UL) ? ((r << 1) ^ 0x04c11db7UL) : (r << 1);
+      r &= 0xffffffffUL;
+    }
+    ogg_crc_table[i] = r;
+  }
+}
+
+static void put_le(unsigned char *buffer, unsigned long long value, int bytes)
+{
+  int i = 0;
+  for (i = 0;i < bytes;i++)
+  {
+    buffer[i] = (unsigned char) ((value >> (i * 8)) & 0xff);
+  }
+}
+
+typedef struct {
+  FILE *out;
+  unsigned long serial;
+  unsigned long page_number;
+  long bytes;
+} ogg_writer;
+
+static int write_ogg_page(ogg_writer *ow, unsigned char **packets, size_t *lengths,
+    int number_of_packets, int header_type, unsigned long long granule_position)
+{
+  unsigned char page[27 + 255 + 255 * 255];
+  int segments = 0;
+  size_t body_length = 0;
+
+  int i = 0;
+  for (i = 0;i < number_of_packets;i++)
+  {
+    size_t remaining = lengths[i];
+    while (remaining >= 255)
+    {
+      page[27 + segments++] = 255;
+      remaining -= 255;
+    }
+    page[27 + segments++] = (unsigned char) remaining;
+    body_length += lengths[i];
+  }
+
+  memcpy(page, "OggS", 4);
+  page[4] = 0;
+  page[5] = (unsigned char) header_type;
+  put_le(page + 6, granule_position, 8);
+  put_le(page + 14, ow->serial, 4);
+  put_le(page + 18, ow->page_number++, 4);
+  put_le(page + 22, 0, 4);
+  page[26] = (unsigned char) segments;
+
+  size_t length = 27 + segments;
+  for (i = 0;i < number_of_packets;i++)
+  {
+    memcpy(page + length, packets[i], lengths[i]);
+    length += lengths[i];
+  }
+
+  unsigned long crc = 0;
+  size_t j = 0;
+  for (j = 0;j < length;j++)
+  {
+    crc = ((crc << 8) & 0xffffffffUL) ^ ogg_crc_table[((crc >> 24) & 0xff) ^ page[j]];
+  }
+  put_le(page + 22, crc, 4);
+
+  if (fwrite(page, length, 1, ow->out) != 1) { return -1; }
+  ow->bytes += length;
+
+  return 0;
+}
+
+static size_t vorbis_identification_header(unsigned char *packet)
+{
+  memset(packet, 0, 30);
+  packet[0] = 0x01;
+  memcpy(packet + 1, "vorbis", 6);
+  put_le(packet + 11, FLAC_CHANNELS, 1);
+  put_le(packet + 12, SAMPLE_RATE, 4);
+  //blocksizes 256 and 2048
+  packet[28] = 0xB8;
+  packet[29] = 0x01;
+  return 30;
+}
+
+static size_t vorbis_comment_header(unsigned char *packet, int stream_number)
+{
+  const char *vendor = "libmp3splt benchmark corpus";
+  char title[64];
+  snprintf(title, sizeof(title), "TITLE=Chained stream %d", stream_number + 1);
+
+  size_t length = 0;
+  packet[length++] = 0x03;
+  memcpy(packet + length, "vorbis", 6);
+  length += 6;
+  put_le(packet + length, strlen(vendor), 4);
+  length += 4;
+  memcpy(packet + length, vendor, strlen(vendor));
+  length += strlen(vendor);
+  put_le(packet + length, 1, 4);
+  length += 4;
+  put_le(packet + length, strlen(title), 4);
+  length += 4;
+  memcpy(packet + length, title, strlen(title));
+  length += strlen(title);
+  packet[length++] = 0x01;
+
+  return length;
+}
+
+/*! Setup header with one codebook, one floor 1 without partitions, one
+  residue, one mapping and one mode using the short block
+*/
+static size_t vorbis_setup_header(unsigned char *packet)
+{
+  memset(packet, 0, 64);
+  packet[0] = 0x05;
+  memcpy(packet + 1, "vorbis", 6);
+
+  bit_writer bw = { packet + 7, 0 };
+
+  //codebook: 1 dimension, 2 entries of length 1, no lookup
+  put_bits_lsb(&bw, 0, 8);
+  put_bits_lsb(&bw, 0x564342, 24);
+  put_bits_lsb(&bw, 1, 16);
+  put_bits_lsb(&bw, 2, 24);
+  put_bits_lsb(&bw, 0, 1);
+  put_bits_lsb(&bw, 0, 1);
+  put_bits_lsb(&bw, 0, 5);
+  put_bits_lsb(&bw, 0, 5);
+  put_bits_lsb(&bw, 0, 4);
+
+  //time domain transforms
+  put_bits_lsb(&bw, 0, 6);
+  put_bits_lsb(&bw, 0, 16);
+
+  //floor 1: no partition, multiplier 2, 7 range bits
+  put_bits_lsb(&bw, 0, 6);
+  put_bits_lsb(&bw, 1, 16);
+  put_bits_lsb(&bw, 0, 5);
+  put_bits_lsb(&bw, 1, 2);
+  put_bits_lsb(&bw, 7, 4);
+
+  //residue 0: empty range, one classification using codebook 0
+  put_bits_lsb(&bw, 0, 6);
+  put_bits_lsb(&bw, 0, 16);
+  put_bits_lsb(&bw, 0, 24);
+  put_bits_lsb(&bw, 0, 24);
+  put_bits_lsb(&bw, 0, 24);
+  put_bits_lsb(&bw, 0, 6);
+  put_bits_lsb(&bw, 0, 8);
+  put_bits_lsb(&bw, 0, 3);
+  put_bits_lsb(&bw, 0, 1);
+
+  //mapping 0: one submap, no coupling
+  put_bits_lsb(&bw, 0, 6);
+  put_bits_lsb(&bw, 0, 16);
+  put_bits_lsb(&bw, 0, 1);
+  put_bits_lsb(&bw, 0, 1);
+  put_bits_lsb(&bw, 0, 2);
+  put_bits_lsb(&bw, 0, 8);
+  put_bits_lsb(&bw, 0, 8);
+  put_bits_lsb(&bw, 0, 8);
+
+  //mode: short block, mapping 0
+  put_bits_lsb(&bw, 0, 6);
+  put_bits_lsb(&bw, 0, 1);
+  put_bits_lsb(&bw, 0, 16);
+  put_bits_lsb(&bw, 0, 16);
+  put_bits_lsb(&bw, 0, 8);
+
+  //framing
+  put_bits_lsb(&bw, 1, 1);
+
+  return 7 + (bw.bit_position + 7) / 8;
+}
+
+static long generate_chained_ogg(const char *directory, const char *name, long packets,
+    long *total_packets)
+{
+  FILE *out = open_output(directory, name);
+  if (out == NULL) { return -1; }
+
+  init_ogg_crc_table();
+
+  unsigned char identification[30];
+  unsigned char comment[256];
+  unsigned char setup[64];
+  unsigned char audio_packet = 0x00;
+
+  unsigned char *page_packets[OGG_PACKETS_PER_PAGE];
+  size_t page_lengths[OGG_PACKETS_PER_PAGE];
+
+  ogg_writer ow = { out, 0, 0, 0 };
+  long packets_per_stream = packets / OGG_CHAINED_STREAMS;
+  *total_packets = 0;
+
+  int stream = 0;
+  for (stream = 0;stream < OGG_CHAINED_STREAMS;stream++)
+  {
+    ow.serial = next_random();
+    ow.page_number = 0;
+
+    page_packets[0] = identification;
+    page_lengths[0] = vorbis_identification_header(identification);
+    if (write_ogg_page(&ow, page_packets, page_lengths, 1, 0x02, 0) < 0) { goto error; }
+
+    page_packets[0] = comment;
+    page_lengths[0] = vorbis_comment_header(comment, stream);
+    page_packets[1] = setup;
+    page_lengths[1] = vorbis_setup_header(setup);
+    if (write_ogg_page(&ow, page_packets, page_lengths, 2, 0x00, 0) < 0) { goto error; }
+
+    int i = 0;
+    for (i = 0;i < OGG_PACKETS_PER_PAGE;i++)
+    {
+      page_packets[i] = &audio_packet;
+      page_lengths[i] = 1;
+    }
+
+    long written = 0;
+    while (written < packets_per_stream)
+    {
+      int number_of_packets = OGG_PACKETS_PER_PAGE;
+      if (packets_per_stream - written < number_of_packets)
+      {
+        number_of_packets = (int) (packets_per_stream - written);
+      }
+      written += number_of_packets;
+
+      //the first packet of a stream does not return samples
+      unsigned long long granule_position =
+        (unsigned long long) (written - 1) * VORBIS_SHORT_BLOCK_SAMPLES;
+      int header_type = (written == packets_per_stream) ? 0x04 : 0x00;
+
+      if (write_ogg_page(&ow, page_packets, page_lengths, number_of_packets,
+            header_type, granule_position) < 0)
+      {
+        goto error;
+      }
+    }
+
+    *total_packets += written;
+  }
+
+  if (fclose(out) != 0) { return -1; }
+  return ow.bytes;
+
+error:
+  fclose(out);
+  return -1;
+}
+
+static int append_to_manifest(FILE *manifest, const char *name, const char *format,
+    long bytes, long frames, double seconds)
+{
+  if (bytes < 0)
+  {
+    fprintf(stderr, "failed to generate '%s'\n", name);
+    return -1;
+  }
+
+  fprintf(manifest, "%s %s %ld %.3f\n", name, format, frames, seconds);
+  fprintf(stderr, "  %-18s %10ld bytes %8ld frames %8.1f s\n", name, bytes, frames, seconds);
+
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  double minutes = 5;
+  const char *directory = NULL;
+
+  int i = 1;
+  for (i = 1;i < argc;i++)
+  {
+    if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+    {
+      minutes = atof(argv[++i]);
+    }
+    else
+    {
+      directory = argv[i];
+    }
+  }
+
+  if (directory == NULL || minutes <= 0)
+  {
+    fprintf(stderr, "usage: %s [-m minutes] output_directory\n", argv[0]);
+    return 1;
+  }
+
+  if (mkdir(directory, 0755) == -1 && errno != EEXIST)
+  {
+    fprintf(stderr, "cannot create '%s': %s\n", directory, strerror(errno));
+    return 1;
+  }
+
+  FILE *manifest = open_output(directory, "corpus.txt");
+  if (manifest == NULL) { return 1; }
+
+  double seconds = minutes * 60;
+  long mp3_frames = (long) (seconds * SAMPLE_RATE / MP3_SAMPLES_PER_FRAME);
+  long flac_frames = (long) (seconds * SAMPLE_RATE / FLAC_BLOCKSIZE);
+  long ogg_packets = (long) (seconds * SAMPLE_RATE / VORBIS_SHORT_BLOCK_SAMPLES);
+  double mp3_seconds = (double) mp3_frames * MP3_SAMPLES_PER_FRAME / SAMPLE_RATE;
+  double flac_seconds = (double) flac_frames * FLAC_BLOCKSIZE / SAMPLE_RATE;
+
+  fprintf(stderr, "generating %.1f minutes corpus in '%s'\n", minutes, directory);
+
+  int error = 0;
+  error |= append_to_manifest(manifest, "cbr.mp3", "mp3",
+      generate_mp3(directory, "cbr.mp3", mp3_frames, 0, 0), mp3_frames, mp3_seconds);
+  error |= append_to_manifest(manifest, "vbr.mp3", "mp3",
+      generate_mp3(directory, "vbr.mp3", mp3_frames, 1, 0), mp3_frames, mp3_seconds);
+  error |= append_to_manifest(manifest, "sync_errors.mp3", "mp3",
+      generate_mp3(directory, "sync_errors.mp3", mp3_frames, 0, 1), mp3_frames, mp3_seconds);
+
+  long wrapped_frames = (mp3_frames / MP3_WRAPPED_FILES) * MP3_WRAPPED_FILES;
+  error |= append_to_manifest(manifest, "wrap.mp3", "mp3wrap",
+      generate_wrap(directory, "wrap.mp3", wrapped_frames), wrapped_frames,
+      (double) wrapped_frames * MP3_SAMPLES_PER_FRAME / SAMPLE_RATE);
+
+  error |= append_to_manifest(manifest, "flac_8.flac", "flac",
+      generate_flac(directory, "flac_8.flac", flac_frames, 8), flac_frames, flac_seconds);
+  error |= append_to_manifest(manifest, "flac_16.flac", "flac",
+      generate_flac(directory, "flac_16.flac", flac_frames, 16), flac_frames, flac_seconds);
+  error |= append_to_manifest(manifest, "flac_24.flac", "flac",
+      generate_flac(directory, "flac_24.flac", flac_frames, 24), flac_frames, flac_seconds);
+
+  long total_packets = 0;
+  long ogg_bytes = generate_chained_ogg(directory, "chained.ogg", ogg_packets, &total_packets);
+  error |= append_to_manifest(manifest, "chained.ogg", "ogg", ogg_bytes, total_packets,
+      (double) (total_packets - OGG_CHAINED_STREAMS) * VORBIS_SHORT_BLOCK_SAMPLES / SAMPLE_RATE);
+
+  fclose(manifest);
+
+  return error ? 1 : 0;
+}
+
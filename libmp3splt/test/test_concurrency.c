@@ -0,0 +1,402 @@
+#include <cutter.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "libmp3splt/mp3splt.h"
+
+#define NUMBER_OF_THREADS 8
+#define ITERATIONS_PER_THREAD 25
+#define NUMBER_OF_CUE_TRACKS 40
+
+//mpeg 1 layer 3, 128 kbps, 44100 Hz, mono: silent frames of 417 bytes
+#define MP3_FRAME_SIZE 417
+#define MP3_NUMBER_OF_FRAMES 2000
+
+typedef struct {
+  int thread_number;
+  int with_mp3_plugin;
+  char directory[512];
+  int error;
+  int failed_iteration;
+  int number_of_splitpoints;
+  splt_state *state;
+} thread_data;
+
+static char test_directory[512] = { '\0' };
+
+static int write_cue_file(const char *cue_fname, int tracks)
+{
+  FILE *cue = fopen(cue_fname, "w");
+  if (cue == NULL) { return -1; }
+
+  fprintf(cue, "PERFORMER \"Artist\"\nTITLE \"Album\"\nFILE \"input.mp3\" MP3\n");
+
+  int i = 0;
+  for (i = 0;i < tracks;i++)
+  {
+    fprintf(cue, "  TRACK %02d AUDIO\n    TITLE \"Track %d\"\n    INDEX 01 %02d:%02d:00\n",
+        i + 1, i + 1, i / 60, i % 60);
+  }
+
+  fclose(cue);
+  return 0;
+}
+
+static int write_silent_mp3_file(const char *mp3_fname)
+{
+  FILE *mp3 = fopen(mp3_fname, "wb");
+  if (mp3 == NULL) { return -1; }
+
+  unsigned char frame[MP3_FRAME_SIZE];
+  memset(frame, 0, MP3_FRAME_SIZE);
+  frame[0] = 0xFF;
+  frame[1] = 0xFB;
+  frame[2] = 0x90;
+  frame[3] = 0xC4;
+
+  int i = 0;
+  for (i = 0;i < MP3_NUMBER_OF_FRAMES;i++)
+  {
+    fwrite(frame, MP3_FRAME_SIZE, 1, mp3);
+  }
+
+  fclose(mp3);
+  return 0;
+}
+
+static splt_state *new_state_with_plugins(int *error)
+{
+  splt_state *state = mp3splt_new_state(error);
+  if (*error < 0) { return NULL; }
+
+  mp3splt_append_plugins_scan_dir(state, "../plugins/.libs");
+  mp3splt_append_plugins_scan_dir(state, "plugins/.libs");
+
+  *error = mp3splt_find_plugins(state);
+  return state;
+}
+
+static int split_mp3_in_thread(splt_state *state, thread_data *data)
+{
+  char *input = NULL;
+  char output_dir[1024];
+  snprintf(output_dir, sizeof(output_dir), "%s/out", data->directory);
+
+  input = malloc(strlen(test_directory) + 16);
+  sprintf(input, "%s/input.mp3", test_directory);
+
+  mp3splt_set_filename_to_split(state, input);
+  mp3splt_set_path_of_split(state, output_dir);
+  mp3splt_set_int_option(state, SPLT_OPT_SPLIT_MODE, SPLT_OPTION_TIME_MODE);
+  mp3splt_set_long_option(state, SPLT_OPT_SPLIT_TIME, 500 + 100 * data->thread_number);
+  mp3splt_set_int_option(state, SPLT_OPT_TAGS, SPLT_NO_TAGS);
+  mp3splt_set_int_option(state, SPLT_OPT_OUTPUT_FILENAMES, SPLT_OUTPUT_FORMAT);
+  mp3splt_set_oformat(state, "@f_@n");
+
+  int error = mp3splt_split(state);
+
+  free(input);
+
+  if (error == SPLT_TIME_SPLIT_OK || error == SPLT_OK_SPLIT_EOF)
+  {
+    return SPLT_OK;
+  }
+
+  return error;
+}
+
+static void *split_in_thread(void *user_data)
+{
+  thread_data *data = (thread_data *) user_data;
+
+  char cue_fname[1024];
+  snprintf(cue_fname, sizeof(cue_fname), "%s/tracks.cue", data->directory);
+
+  int i = 0;
+  for (i = 0;i < ITERATIONS_PER_THREAD;i++)
+  {
+    int error = SPLT_OK;
+    splt_state *state = new_state_with_plugins(&error);
+    if (error < 0) { goto failure; }
+
+    int tracks = NUMBER_OF_CUE_TRACKS + data->thread_number;
+    if (write_cue_file(cue_fname, tracks) < 0)
+    {
+      error = SPLT_ERROR_CANNOT_OPEN_DEST_FILE;
+      goto failure;
+    }
+
+    error = mp3splt_import(state, CUE_IMPORT, cue_fname);
+    if (error != SPLT_CUE_OK) { goto failure; }
+
+    splt_points *points = mp3splt_get_splitpoints(state, &error);
+    data->number_of_splitpoints = 0;
+    mp3splt_points_init_iterator(points);
+    while (mp3splt_points_next(points)) { data->number_of_splitpoints++; }
+
+    //error messages are built from strerror in the library
+    error = mp3splt_import(state, CUE_IMPORT, "/inexistent/directory/file.cue");
+    char *message = mp3splt_get_strerror(state, error);
+    free(message);
+
+    if (data->with_mp3_plugin)
+    {
+      mp3splt_reset_state(state);
+
+      error = split_mp3_in_thread(state, data);
+      if (error < 0) { goto failure; }
+    }
+
+    mp3splt_free_state(state);
+    continue;
+
+failure:
+    data->error = error;
+    data->failed_iteration = i;
+    if (state) { mp3splt_free_state(state); }
+    return NULL;
+  }
+
+  return NULL;
+}
+
+static void *probe_in_thread(void *user_data)
+{
+  thread_data *data = (thread_data *) user_data;
+
+  char fname[1024];
+  snprintf(fname, sizeof(fname), "%s/input.mp3", test_directory);
+
+  int i = 0;
+  for (i = 0;i < ITERATIONS_PER_THREAD;i++)
+  {
+    int error = SPLT_OK;
+    splt_state *state = new_state_with_plugins(&error);
+    if (error < 0) { goto failure; }
+
+    mp3splt_set_filename_to_split(state, fname);
+    error = mp3splt_read_original_tags(state);
+    if (error < 0) { goto failure; }
+
+    if (mp3splt_get_total_time(state) <= 0 || mp3splt_get_plugin_name(state) == NULL ||
+        mp3splt_get_original_tags(state, &error) == NULL)
+    {
+      error = SPLT_ERROR_INVALID;
+      goto failure;
+    }
+
+    mp3splt_free_state(state);
+    continue;
+
+failure:
+    data->error = error;
+    data->failed_iteration = i;
+    if (state) { mp3splt_free_state(state); }
+    return NULL;
+  }
+
+  return NULL;
+}
+
+//keeps the state using the plugins of data->directory, for the main thread
+static void *find_plugins_in_thread(void *user_data)
+{
+  thread_data *data = (thread_data *) user_data;
+
+  char fname[1024];
+  snprintf(fname, sizeof(fname), "%s/input.mp3", test_directory);
+
+  int error = SPLT_OK;
+  data->state = mp3splt_new_state(&error);
+  if (error < 0) { data->error = error; return NULL; }
+
+  mp3splt_append_plugins_scan_dir(data->state, data->directory);
+  error = mp3splt_find_plugins(data->state);
+  if (error < 0) { data->error = error; return NULL; }
+
+  mp3splt_set_filename_to_split(data->state, fname);
+  error = mp3splt_read_original_tags(data->state);
+  if (error < 0) { data->error = error; }
+
+  return NULL;
+}
+
+static int copy_file(const char *source_fname, const char *destination_fname)
+{
+  FILE *source = fopen(source_fname, "rb");
+  if (source == NULL) { return -1; }
+
+  FILE *destination = fopen(destination_fname, "wb");
+  if (destination == NULL) { fclose(source); return -1; }
+
+  char buffer[4096];
+  size_t bytes = 0;
+  while ((bytes = fread(buffer, 1, sizeof(buffer), source)) > 0)
+  {
+    fwrite(buffer, 1, bytes, destination);
+  }
+
+  fclose(source);
+  return fclose(destination);
+}
+
+static int mp3_plugin_is_available()
+{
+  int error = SPLT_OK;
+  splt_state *state = new_state_with_plugins(&error);
+
+  char fname[1024];
+  snprintf(fname, sizeof(fname), "%s/input.mp3", test_directory);
+  mp3splt_set_filename_to_split(state, fname);
+
+  int available = (mp3splt_read_original_tags(state) >= 0);
+
+  mp3splt_free_state(state);
+  return available;
+}
+
+void cut_setup()
+{
+  char *tmp = getenv("TMPDIR");
+  snprintf(test_directory, sizeof(test_directory), "%s/libmp3splt_concurrency_XXXXXX",
+      tmp ? tmp : "/tmp");
+  cut_assert_not_null(mkdtemp(test_directory));
+
+  char fname[1024];
+  snprintf(fname, sizeof(fname), "%s/input.mp3", test_directory);
+  cut_assert_equal_int(0, write_silent_mp3_file(fname));
+}
+
+void cut_teardown()
+{
+  char command[1024];
+  snprintf(command, sizeof(command), "rm -rf '%s'", test_directory);
+  system(command);
+
+  mp3splt_free_plugins_cache();
+}
+
+void test_many_states_import_and_split_on_parallel_threads()
+{
+  int with_mp3_plugin = mp3_plugin_is_available();
+
+  pthread_t threads[NUMBER_OF_THREADS];
+  thread_data data[NUMBER_OF_THREADS];
+
+  int i = 0;
+  for (i = 0;i < NUMBER_OF_THREADS;i++)
+  {
+    memset(&data[i], 0, sizeof(thread_data));
+    data[i].thread_number = i;
+    data[i].with_mp3_plugin = with_mp3_plugin;
+    data[i].error = SPLT_OK;
+    snprintf(data[i].directory, sizeof(data[i].directory), "%s/thread_%d", test_directory, i);
+    cut_assert_equal_int(0, mkdir(data[i].directory, 0755));
+
+    cut_assert_equal_int(0, pthread_create(&threads[i], NULL, split_in_thread, &data[i]));
+  }
+
+  for (i = 0;i < NUMBER_OF_THREADS;i++)
+  {
+    pthread_join(threads[i], NULL);
+  }
+
+  for (i = 0;i < NUMBER_OF_THREADS;i++)
+  {
+    cut_assert_equal_int(SPLT_OK, data[i].error,
+        cut_message("thread %d failed at iteration %d", i, data[i].failed_iteration));
+    cut_assert_equal_int(NUMBER_OF_CUE_TRACKS + i, data[i].number_of_splitpoints);
+  }
+
+  if (!with_mp3_plugin)
+  {
+    cut_omit("mp3 plugin not found: parallel splits not tested");
+  }
+}
+
+void test_plugins_are_found_once_for_states_created_on_parallel_threads()
+{
+  if (!mp3_plugin_is_available())
+  {
+    cut_omit("mp3 plugin not found: plugins registry not tested");
+  }
+  cut_assert_equal_int(SPLT_OK, mp3splt_free_plugins_cache());
+
+  char plugins_dir[1024];
+  snprintf(plugins_dir, sizeof(plugins_dir), "%s/plugins", test_directory);
+  cut_assert_equal_int(0, mkdir(plugins_dir, 0755));
+
+  char plugin_fname[1024];
+  snprintf(plugin_fname, sizeof(plugin_fname), "%s/libsplt_mp3.so.0", plugins_dir);
+  cut_assert_true(copy_file("../plugins/.libs/libsplt_mp3.so.0", plugin_fname) == 0 ||
+      copy_file("plugins/.libs/libsplt_mp3.so.0", plugin_fname) == 0);
+
+  pthread_t threads[NUMBER_OF_THREADS];
+  thread_data data[NUMBER_OF_THREADS + 1];
+
+  int i = 0;
+  for (i = 0;i < NUMBER_OF_THREADS;i++)
+  {
+    memset(&data[i], 0, sizeof(thread_data));
+    data[i].error = SPLT_OK;
+    snprintf(data[i].directory, sizeof(data[i].directory), "%s", plugins_dir);
+    cut_assert_equal_int(0, pthread_create(&threads[i], NULL, find_plugins_in_thread, &data[i]));
+  }
+
+  for (i = 0;i < NUMBER_OF_THREADS;i++)
+  {
+    pthread_join(threads[i], NULL);
+    cut_assert_equal_int(SPLT_OK, data[i].error);
+  }
+
+  //the plugins directory is not scanned again while the plugins are in use
+  cut_assert_equal_int(0, unlink(plugin_fname));
+
+  memset(&data[NUMBER_OF_THREADS], 0, sizeof(thread_data));
+  snprintf(data[NUMBER_OF_THREADS].directory, sizeof(data[NUMBER_OF_THREADS].directory), "%s",
+      plugins_dir);
+  find_plugins_in_thread(&data[NUMBER_OF_THREADS]);
+  cut_assert_equal_int(SPLT_OK, data[NUMBER_OF_THREADS].error);
+
+  cut_assert_equal_int(SPLT_ERROR_LIBRARY_LOCKED, mp3splt_free_plugins_cache());
+
+  for (i = 0;i <= NUMBER_OF_THREADS;i++)
+  {
+    mp3splt_free_state(data[i].state);
+  }
+
+  cut_assert_equal_int(SPLT_OK, mp3splt_free_plugins_cache());
+}
+
+void test_probe_input_files_on_parallel_threads()
+{
+  if (!mp3_plugin_is_available())
+  {
+    cut_omit("mp3 plugin not found: probing not tested");
+  }
+
+  pthread_t threads[NUMBER_OF_THREADS];
+  thread_data data[NUMBER_OF_THREADS];
+
+  int i = 0;
+  for (i = 0;i < NUMBER_OF_THREADS;i++)
+  {
+    memset(&data[i], 0, sizeof(thread_data));
+    data[i].thread_number = i;
+    data[i].error = SPLT_OK;
+    cut_assert_equal_int(0, pthread_create(&threads[i], NULL, probe_in_thread, &data[i]));
+  }
+
+  for (i = 0;i < NUMBER_OF_THREADS;i++)
+  {
+    pthread_join(threads[i], NULL);
+    cut_assert_equal_int(SPLT_OK, data[i].error,
+        cut_message("thread %d failed at iteration %d", i, data[i].failed_iteration));
+  }
+}
+
@@ -372,6 +372,67 @@ void test_with_replace_underscores()
   free(genre);
 }
 
+void test_parse_several_filenames_with_the_same_regex()
+{
+  mp3splt_set_input_filename_regex(state, "(?<artist>.*?) - (?<tracknum>.*?) - (?<title>.*)");
+
+  const char *filenames[] = {
+    "/music/one artist - 1 - first title.mp3",
+    "no match.mp3",
+    "other_dir/other artist - 2 - second title.ogg"
+  };
+  splt_tags *all_tags[3];
+
+  error = mp3splt_parse_filenames_regex(state, filenames, 3, all_tags);
+  cut_assert_equal_int(SPLT_REGEX_OK, error);
+
+  cut_assert_not_null(all_tags[0]);
+  cut_assert_null(all_tags[1]);
+  cut_assert_not_null(all_tags[2]);
+
+  char *artist = mp3splt_tags_get(all_tags[0], SPLT_TAGS_ARTIST);
+  cut_assert_equal_string("one artist", artist);
+  free(artist);
+  char *title = mp3splt_tags_get(all_tags[2], SPLT_TAGS_TITLE);
+  cut_assert_equal_string("second title", title);
+  free(title);
+  char *track = mp3splt_tags_get(all_tags[2], SPLT_TAGS_TRACK);
+  cut_assert_equal_string("2", track);
+  free(track);
+
+  mp3splt_free_one_tag(all_tags[0]);
+  mp3splt_free_one_tag(all_tags[2]);
+}
+
+void test_parse_several_filenames_with_invalid_regex()
+{
+  mp3splt_set_input_filename_regex(state, "(?ohh my test");
+
+  const char *filenames[] = { "one", "two" };
+  splt_tags *all_tags[2];
+
+  error = mp3splt_parse_filenames_regex(state, filenames, 2, all_tags);
+  cut_assert_equal_int(SPLT_INVALID_REGEX, error);
+  cut_assert_null(all_tags[0]);
+  cut_assert_null(all_tags[1]);
+}
+
+void test_changing_the_regex_recompiles_it()
+{
+  tags = splt_fr_parse(state, "first - second", "(?<artist>.*?) - (?<title>.*)",
+      NO_DEFAULT_COMMENT, NO_DEFAULT_GENRE, &error);
+  cut_assert_equal_int(SPLT_REGEX_OK, error);
+  splt_tu_free_one_tags(&tags);
+
+  tags = splt_fr_parse(state, "first - second", "(?<title>.*?) - (?<artist>.*)",
+      NO_DEFAULT_COMMENT, NO_DEFAULT_GENRE, &error);
+  cut_assert_equal_int(SPLT_REGEX_OK, error);
+
+  char *artist = mp3splt_tags_get(tags, SPLT_TAGS_ARTIST);
+  cut_assert_equal_string("second", artist);
+  free(artist);
+}
+
 static void set_tags_format_options(splt_state *state, int format)
 {
   splt_o_set_int_option(state, SPLT_OPT_ARTIST_TAG_FORMAT, format);
@@ -0,0 +1,286 @@
+#include <cutter.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "libmp3splt/mp3splt.h"
+
+static splt_state *state = NULL;
+static char test_directory[512] = { '\0' };
+
+//local stand-in of the freedb cgi server
+static int server_fd = -1;
+static int server_port = 0;
+static pthread_t server_thread;
+static int server_answers = SPLT_TRUE;
+static int server_keeps_alive = SPLT_TRUE;
+static int number_of_connections = 0;
+static int number_of_requests = 0;
+
+static const char *search_response =
+"211 Found inexact matches, list follows (until terminating `.')\r\n"
+"rock 0a0b0c0d The Artist / The First Album\r\n"
+"jazz 1a2b3c4d Other Artist / Night Sessions\r\n"
+".\r\n";
+
+static const char *read_response =
+"210 rock 0a0b0c0d CD database entry follows (until terminating `.')\r\n"
+"# xmcd\r\n"
+"DTITLE=The Artist / The First Album\r\n"
+".";
+
+static void send_response(int connection, const char *body)
+{
+  char response[2048];
+  if (server_keeps_alive)
+  {
+    snprintf(response, sizeof(response),
+        "HTTP/1.0 200 OK\r\nContent-Type: text/plain\r\n"
+        "Content-Length: %d\r\nConnection: Keep-Alive\r\n\r\n%s", (int) strlen(body), body);
+  }
+  else
+  {
+    snprintf(response, sizeof(response),
+        "HTTP/1.0 200 OK\r\nContent-Type: text/plain\r\n\r\n%s", body);
+  }
+
+  send(connection, response, strlen(response), 0);
+}
+
+static void serve_connection(int connection)
+{
+  char request[4096];
+  size_t length = 0;
+
+  while (1)
+  {
+    ssize_t received_bytes = recv(connection, request + length, sizeof(request) - length - 1, 0);
+    if (received_bytes <= 0)
+    {
+      return;
+    }
+
+    length += received_bytes;
+    request[length] = '\0';
+
+    char *request_end = strstr(request, "\r\n\r\n");
+    if (request_end == NULL)
+    {
+      continue;
+    }
+
+    number_of_requests++;
+
+    if (server_answers)
+    {
+      send_response(connection,
+          strstr(request, "cmd=cddb+read+") != NULL ? read_response : search_response);
+      if (!server_keeps_alive)
+      {
+        return;
+      }
+    }
+
+    size_t request_length = request_end + 4 - request;
+    memmove(request, request_end + 4, length - request_length + 1);
+    length -= request_length;
+  }
+}
+
+static void *serve(void *data)
+{
+  int connection = -1;
+  while ((connection = accept(server_fd, NULL, NULL)) != -1)
+  {
+    number_of_connections++;
+    serve_connection(connection);
+    close(connection);
+  }
+
+  return NULL;
+}
+
+static void start_server()
+{
+  server_fd = socket(AF_INET, SOCK_STREAM, 0);
+  cut_assert_not_equal_int(-1, server_fd);
+
+  struct sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = 0;
+  cut_assert_equal_int(0, bind(server_fd, (struct sockaddr *) &address, sizeof(address)));
+  cut_assert_equal_int(0, listen(server_fd, 4));
+
+  socklen_t address_length = sizeof(address);
+  getsockname(server_fd, (struct sockaddr *) &address, &address_length);
+  server_port = ntohs(address.sin_port);
+
+  cut_assert_equal_int(0, pthread_create(&server_thread, NULL, serve, NULL));
+}
+
+static void stop_server()
+{
+  shutdown(server_fd, SHUT_RDWR);
+  pthread_join(server_thread, NULL);
+  close(server_fd);
+  server_fd = -1;
+}
+
+static int search(splt_state *state, const char *searched_string)
+{
+  int error = SPLT_OK;
+  char search_server[256] = "127.0.0.1/~cddb/cddb.cgi";
+  mp3splt_get_freedb_search(state, searched_string, &error,
+      SPLT_FREEDB_SEARCH_TYPE_CDDB_CGI, search_server, server_port);
+  cut_assert_equal_string("127.0.0.1/~cddb/cddb.cgi", search_server);
+  return error;
+}
+
+static int write_file_result(splt_state *state, const char *fname)
+{
+  return mp3splt_write_freedb_file_result(state, 0, fname,
+      SPLT_FREEDB_GET_FILE_TYPE_CDDB_CGI, "127.0.0.1/~cddb/cddb.cgi", server_port);
+}
+
+static char *read_file(const char *fname)
+{
+  FILE *file = fopen(fname, "r");
+  cut_assert_not_null(file);
+
+  static char contents[1024];
+  size_t length = fread(contents, 1, sizeof(contents) - 1, file);
+  contents[length] = '\0';
+  fclose(file);
+
+  return contents;
+}
+
+void cut_setup()
+{
+  char *tmp = getenv("TMPDIR");
+  snprintf(test_directory, sizeof(test_directory), "%s/libmp3splt_freedb_connection_XXXXXX",
+      tmp ? tmp : "/tmp");
+  cut_assert_not_null(mkdtemp(test_directory));
+
+  server_answers = SPLT_TRUE;
+  server_keeps_alive = SPLT_TRUE;
+  number_of_connections = 0;
+  number_of_requests = 0;
+  start_server();
+
+  state = mp3splt_new_state(NULL);
+}
+
+void cut_teardown()
+{
+  //closes the kept-alive connection before the server stops
+  mp3splt_free_state(state);
+  stop_server();
+
+  char command[1024];
+  snprintf(command, sizeof(command), "rm -rf '%s'", test_directory);
+  system(command);
+}
+
+void test_search_and_get_reuse_the_connection()
+{
+  cut_assert_equal_int(SPLT_FREEDB_OK, search(state, "first album"));
+
+  char cddb_fname[1024];
+  snprintf(cddb_fname, sizeof(cddb_fname), "%s/result.cddb", test_directory);
+  cut_assert_equal_int(SPLT_FREEDB_FILE_OK, write_file_result(state, cddb_fname));
+  cut_assert_equal_string("# xmcd\nDTITLE=The Artist / The First Album\n.\n", read_file(cddb_fname));
+
+  cut_assert_equal_int(1, number_of_connections);
+  cut_assert_equal_int(2, number_of_requests);
+}
+
+void test_connection_closed_by_the_server()
+{
+  server_keeps_alive = SPLT_FALSE;
+
+  cut_assert_equal_int(SPLT_FREEDB_OK, search(state, "first album"));
+
+  char cddb_fname[1024];
+  snprintf(cddb_fname, sizeof(cddb_fname), "%s/result.cddb", test_directory);
+  cut_assert_equal_int(SPLT_FREEDB_FILE_OK, write_file_result(state, cddb_fname));
+
+  cut_assert_equal_int(2, number_of_connections);
+  cut_assert_equal_int(2, number_of_requests);
+}
+
+void test_responses_are_cached_in_memory_and_on_disk()
+{
+  cut_assert_equal_int(SPLT_OK, mp3splt_freedb_use_cache_directory(state, test_directory));
+
+  cut_assert_equal_int(SPLT_FREEDB_OK, search(state, "first album"));
+  cut_assert_equal_int(SPLT_FREEDB_OK, search(state, "first album"));
+  cut_assert_equal_int(1, number_of_requests);
+
+  splt_state *other_state = mp3splt_new_state(NULL);
+  mp3splt_freedb_use_cache_directory(other_state, test_directory);
+
+  cut_assert_equal_int(SPLT_FREEDB_OK, search(other_state, "first album"));
+  cut_assert_equal_int(1, number_of_requests);
+
+  splt_freedb_results *results = mp3splt_get_freedb_search(other_state, "first album", NULL,
+      SPLT_FREEDB_SEARCH_TYPE_CDDB_CGI, "127.0.0.1/~cddb/cddb.cgi", server_port);
+  mp3splt_freedb_init_iterator(results);
+  cut_assert_equal_string("The Artist / The First Album",
+      mp3splt_freedb_get_name(mp3splt_freedb_next(results)));
+
+  mp3splt_free_state(other_state);
+
+  cut_assert_equal_int(SPLT_FREEDB_OK, search(state, "other search"));
+  cut_assert_equal_int(2, number_of_requests);
+}
+
+void test_cache_files_are_renamed_from_their_temporary_files()
+{
+  cut_assert_equal_int(SPLT_OK, mp3splt_freedb_use_cache_directory(state, test_directory));
+
+  cut_assert_equal_int(SPLT_FREEDB_OK, search(state, "first album"));
+  cut_assert_equal_int(SPLT_FREEDB_OK, search(state, "other search"));
+
+  DIR *dir = opendir(test_directory);
+  cut_assert_not_null(dir);
+
+  int number_of_files = 0;
+  int number_of_temporary_files = 0;
+  struct dirent *entry = NULL;
+  while ((entry = readdir(dir)) != NULL)
+  {
+    if (entry->d_name[0] == '.') { continue; }
+
+    number_of_files++;
+    if (strstr(entry->d_name, ".tmp") != NULL)
+    {
+      number_of_temporary_files++;
+    }
+  }
+  closedir(dir);
+
+  cut_assert_equal_int(2, number_of_files);
+  cut_assert_equal_int(0, number_of_temporary_files);
+}
+
+void test_timeout_of_a_server_not_answering()
+{
+  server_answers = SPLT_FALSE;
+  mp3splt_set_int_option(state, SPLT_OPT_FREEDB_TIMEOUT, 1);
+
+  time_t begin = time(NULL);
+  cut_assert_equal_int(SPLT_FREEDB_ERROR_TIMEOUT, search(state, "first album"));
+  cut_assert_operator_int(time(NULL) - begin, <, 5);
+}
+
@@ -0,0 +1,172 @@
+#include <cutter.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "libmp3splt/mp3splt.h"
+
+static splt_state *state = NULL;
+static char test_directory[512] = { '\0' };
+static char index_fname[1024] = { '\0' };
+static splt_freedb_results *results = NULL;
+
+static const char *rock_disc =
+"# xmcd\n"
+"#\n"
+"DISCID=0a0b0c0d,1a2b3c4d\n"
+"DTITLE=The Artist / The First Album\n"
+"DYEAR=1999\n"
+"TTITLE0=First\n"
+"TTITLE1=Second\n";
+
+static const char *jazz_disc =
+"# xmcd\n"
+"DISCID=0a0b0c0d\n"
+"DTITLE=Other Artist / Night Sessions, Vol. 2 (Live At The Club) - The Complete \n"
+"DTITLE=Recordings\n"
+"TTITLE0=Intro\n";
+
+static void write_dump_file(const char *category, const char *name, const char *contents)
+{
+  char fname[1024];
+  snprintf(fname, sizeof(fname), "%s/dump/%s", test_directory, category);
+  mkdir(fname, 0755);
+
+  snprintf(fname, sizeof(fname), "%s/dump/%s/%s", test_directory, category, name);
+  FILE *file = fopen(fname, "w");
+  cut_assert_not_null(file);
+  fputs(contents, file);
+  fclose(file);
+}
+
+static int search(const char *searched_string)
+{
+  int error = SPLT_OK;
+  results = mp3splt_get_freedb_search(state, searched_string, &error,
+      SPLT_FREEDB_SEARCH_TYPE_LOCAL_INDEX, index_fname, -1);
+  return error;
+}
+
+static int get_number_of_results()
+{
+  mp3splt_freedb_init_iterator(results);
+
+  int number_of_results = 0;
+  while (mp3splt_freedb_next(results)) { number_of_results++; }
+
+  return number_of_results;
+}
+
+static const splt_freedb_one_result *get_result(int index)
+{
+  mp3splt_freedb_init_iterator(results);
+
+  const splt_freedb_one_result *result = NULL;
+  int i = 0;
+  for (i = 0;i <= index;i++)
+  {
+    result = mp3splt_freedb_next(results);
+  }
+
+  return result;
+}
+
+static char *read_file(const char *fname)
+{
+  FILE *file = fopen(fname, "r");
+  cut_assert_not_null(file);
+
+  static char contents[1024];
+  size_t length = fread(contents, 1, sizeof(contents) - 1, file);
+  contents[length] = '\0';
+  fclose(file);
+
+  return contents;
+}
+
+void cut_setup()
+{
+  char *tmp = getenv("TMPDIR");
+  snprintf(test_directory, sizeof(test_directory), "%s/libmp3splt_freedb_XXXXXX",
+      tmp ? tmp : "/tmp");
+  cut_assert_not_null(mkdtemp(test_directory));
+
+  char dump[1024];
+  snprintf(dump, sizeof(dump), "%s/dump", test_directory);
+  cut_assert_equal_int(0, mkdir(dump, 0755));
+
+  write_dump_file("rock", "0a0b0c0d", rock_disc);
+  write_dump_file("jazz", "0a0b0c0d", jazz_disc);
+  write_dump_file("jazz", "ffffffff", "# xmcd\nDTITLE=Without Disc Id Line\n");
+
+  snprintf(index_fname, sizeof(index_fname), "%s/freedb.index", test_directory);
+
+  state = mp3splt_new_state(NULL);
+  cut_assert_equal_int(SPLT_FREEDB_LOCAL_INDEX_OK,
+      mp3splt_freedb_build_local_index(state, dump, index_fname));
+}
+
+void cut_teardown()
+{
+  mp3splt_free_state(state);
+
+  char command[1024];
+  snprintf(command, sizeof(command), "rm -rf '%s'", test_directory);
+  system(command);
+}
+
+void test_search_words_of_the_titles()
+{
+  cut_assert_equal_int(SPLT_FREEDB_OK, search("artist"));
+  cut_assert_equal_int(2, get_number_of_results());
+
+  cut_assert_equal_int(SPLT_FREEDB_OK, search("  SESSIONS recordings"));
+  cut_assert_equal_int(1, get_number_of_results());
+  cut_assert_equal_string(
+      "Other Artist / Night Sessions, Vol. 2 (Live At The Club) - The Complete Recordings",
+      mp3splt_freedb_get_name(get_result(0)));
+
+  cut_assert_equal_int(SPLT_FREEDB_NO_CD_FOUND, search("artist unknown"));
+  cut_assert_equal_int(0, get_number_of_results());
+}
+
+void test_search_disc_ids()
+{
+  cut_assert_equal_int(SPLT_FREEDB_OK, search("0A0B0C0D"));
+  cut_assert_equal_int(2, get_number_of_results());
+
+  cut_assert_equal_int(SPLT_FREEDB_OK, search("1a2b3c4d"));
+  cut_assert_equal_int(1, get_number_of_results());
+  cut_assert_equal_string("The Artist / The First Album", mp3splt_freedb_get_name(get_result(0)));
+
+  cut_assert_equal_int(SPLT_FREEDB_OK, search("ffffffff"));
+  cut_assert_equal_string("Without Disc Id Line", mp3splt_freedb_get_name(get_result(0)));
+}
+
+void test_write_file_result_from_the_dump()
+{
+  cut_assert_equal_int(SPLT_FREEDB_OK, search("first album"));
+
+  char cddb_fname[1024];
+  snprintf(cddb_fname, sizeof(cddb_fname), "%s/result.cddb", test_directory);
+  cut_assert_equal_int(SPLT_FREEDB_FILE_OK,
+      mp3splt_write_freedb_file_result(state, mp3splt_freedb_get_id(get_result(0)),
+        cddb_fname, SPLT_FREEDB_GET_FILE_TYPE_LOCAL_INDEX, index_fname, -1));
+  cut_assert_equal_string(rock_disc, read_file(cddb_fname));
+}
+
+void test_invalid_index()
+{
+  FILE *file = fopen(index_fname, "w");
+  fputs("not an index", file);
+  fclose(file);
+
+  cut_assert_equal_int(SPLT_FREEDB_ERROR_INVALID_LOCAL_INDEX, search("artist"));
+
+  snprintf(index_fname, sizeof(index_fname), "%s/inexistent.index", test_directory);
+  cut_assert_equal_int(SPLT_ERROR_CANNOT_OPEN_FILE, search("artist"));
+}
+
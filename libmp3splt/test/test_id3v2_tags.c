@@ -0,0 +1,288 @@
+#include <cutter.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "libmp3splt/mp3splt.h"
+
+//mpeg 1 layer 3, 128 kbps, 44100 Hz, mono: frames of 417 bytes
+#define MP3_FRAME_SIZE 417
+#define MP3_NUMBER_OF_FRAMES 200
+#define ID3V2_HEADER_SIZE 10
+#define ID3V2_PADDING 300
+#define MAXIMUM_TAG_SIZE 4096
+#define NUMBER_OF_FILES 3
+
+static char test_directory[512] = { '\0' };
+static char input_fname[1024] = { '\0' };
+static char output_dir[1024] = { '\0' };
+
+static const char *titles[NUMBER_OF_FILES] = { "First", "Second", "Third" };
+
+static const unsigned char apic_data[] = {
+  0x00, 'i', 'm', 'a', 'g', 'e', '/', 'p', 'n', 'g', 0x00, 0x03, 'c', 'o', 'v', 'e', 'r', 0x00,
+  0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A, 0x00, 0x00, 0x00, 0x0D, 'I', 'H', 'D', 'R',
+  0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0x08, 0x02, 0x00, 0x00, 0x00, 0x90, 0x77, 0x53
+};
+
+static const unsigned char priv_data[] = {
+  'o', 'w', 'n', 'e', 'r', 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08
+};
+
+static void put_syncsafe_integer(unsigned char *bytes, unsigned long value)
+{
+  bytes[0] = (value >> 21) & 0x7f;
+  bytes[1] = (value >> 14) & 0x7f;
+  bytes[2] = (value >> 7) & 0x7f;
+  bytes[3] = value & 0x7f;
+}
+
+static unsigned long get_syncsafe_integer(const unsigned char *bytes)
+{
+  return ((unsigned long) bytes[0] << 21) | ((unsigned long) bytes[1] << 14) |
+    ((unsigned long) bytes[2] << 7) | (unsigned long) bytes[3];
+}
+
+//! Appends an ID3v2.4 frame to \p tag and returns the new size of the tag
+static size_t append_frame(unsigned char *tag, size_t size, const char *frame_id,
+    const unsigned char *data, size_t data_size)
+{
+  memcpy(tag + size, frame_id, 4);
+  put_syncsafe_integer(tag + size + 4, data_size);
+  tag[size + 8] = 0;
+  tag[size + 9] = 0;
+  memcpy(tag + size + ID3V2_HEADER_SIZE, data, data_size);
+
+  return size + ID3V2_HEADER_SIZE + data_size;
+}
+
+static size_t append_text_frame(unsigned char *tag, size_t size, const char *frame_id,
+    const char *text)
+{
+  unsigned char data[256];
+  data[0] = 0x00;
+  memcpy(data + 1, text, strlen(text));
+
+  return append_frame(tag, size, frame_id, data, strlen(text) + 1);
+}
+
+/*! Writes an ID3v2.4 tag followed by silent frames
+
+The per track frames are mixed with a picture and a private frame that must be
+copied unchanged in all the output files.
+*/
+static size_t write_mp3_file_with_id3v2_tag(const char *mp3_fname)
+{
+  unsigned char tag[MAXIMUM_TAG_SIZE];
+  memset(tag, 0, MAXIMUM_TAG_SIZE);
+
+  size_t size = ID3V2_HEADER_SIZE;
+  size = append_frame(tag, size, "APIC", apic_data, sizeof(apic_data));
+  size = append_text_frame(tag, size, "TIT2", "Original title");
+  size = append_text_frame(tag, size, "TRCK", "7");
+  size = append_text_frame(tag, size, "TLEN", "5224");
+  size = append_frame(tag, size, "PRIV", priv_data, sizeof(priv_data));
+  size += ID3V2_PADDING;
+
+  memcpy(tag, "ID3", 3);
+  tag[3] = 4;
+  put_syncsafe_integer(tag + 6, size - ID3V2_HEADER_SIZE);
+
+  FILE *mp3 = fopen(mp3_fname, "wb");
+  cut_assert_not_null(mp3);
+  fwrite(tag, size, 1, mp3);
+
+  unsigned char frame[MP3_FRAME_SIZE];
+  memset(frame, 0, MP3_FRAME_SIZE);
+  frame[0] = 0xFF;
+  frame[1] = 0xFB;
+  frame[2] = 0x90;
+  frame[3] = 0xC4;
+
+  int i = 0;
+  for (i = 0;i < MP3_NUMBER_OF_FRAMES;i++)
+  {
+    fwrite(frame, MP3_FRAME_SIZE, 1, mp3);
+  }
+
+  fclose(mp3);
+
+  return size;
+}
+
+//! Splits the input file in 3 files with a title and a track number for each one
+static int split()
+{
+  int error = SPLT_OK;
+  splt_state *state = mp3splt_new_state(&error);
+  cut_assert_equal_int(SPLT_OK, error);
+
+  mp3splt_append_plugins_scan_dir(state, "../plugins/.libs");
+  mp3splt_append_plugins_scan_dir(state, "plugins/.libs");
+  mp3splt_find_plugins(state);
+
+  mp3splt_set_filename_to_split(state, input_fname);
+  mp3splt_set_path_of_split(state, output_dir);
+  mp3splt_set_int_option(state, SPLT_OPT_FRAME_MODE, SPLT_TRUE);
+  mp3splt_set_int_option(state, SPLT_OPT_TAGS, SPLT_CURRENT_TAGS);
+  mp3splt_set_int_option(state, SPLT_OPT_ID3V2_ENCODING, SPLT_ID3V2_LATIN1);
+  mp3splt_set_int_option(state, SPLT_OPT_OUTPUT_FILENAMES, SPLT_OUTPUT_FORMAT);
+  mp3splt_set_oformat(state, "@f_@n");
+
+  mp3splt_append_splitpoint(state, mp3splt_point_new(0, NULL));
+  mp3splt_append_splitpoint(state, mp3splt_point_new(100, NULL));
+  mp3splt_append_splitpoint(state, mp3splt_point_new(300, NULL));
+  mp3splt_append_splitpoint(state, mp3splt_point_new(LONG_MAX, NULL));
+
+  if (mp3splt_read_original_tags(state) < 0)
+  {
+    mp3splt_free_state(state);
+    return SPLT_ERROR_NO_PLUGIN_FOUND;
+  }
+
+  mp3splt_put_tags_from_string(state,
+      "[@o,@t=First,@n=1][@o,@t=Second,@n=2][@o,@t=Third,@n=3]", &error);
+  cut_assert_equal_int(SPLT_OK, error);
+
+  error = mp3splt_split(state);
+
+  mp3splt_free_state(state);
+
+  return error;
+}
+
+//! Returns the data of the \p frame_id frame of the ID3v2.4 \p tag and its size
+static const unsigned char *find_frame(const unsigned char *tag, size_t tag_size,
+    const char *frame_id, size_t *data_size)
+{
+  size_t offset = ID3V2_HEADER_SIZE;
+  while (offset + ID3V2_HEADER_SIZE <= tag_size && tag[offset] != '\0')
+  {
+    size_t size = get_syncsafe_integer(tag + offset + 4);
+    if (memcmp(tag + offset, frame_id, 4) == 0)
+    {
+      *data_size = size;
+      return tag + offset + ID3V2_HEADER_SIZE;
+    }
+
+    offset += ID3V2_HEADER_SIZE + size;
+  }
+
+  return NULL;
+}
+
+static void assert_text_frame(const unsigned char *tag, size_t tag_size,
+    const char *frame_id, const char *text)
+{
+  size_t data_size = 0;
+  const unsigned char *data = find_frame(tag, tag_size, frame_id, &data_size);
+  cut_assert_not_null(data);
+  if (data == NULL) { return; }
+
+  //latin1, with or without the string terminator
+  cut_assert_equal_int(0x00, data[0]);
+  cut_assert_true(data_size == strlen(text) + 1 || data_size == strlen(text) + 2);
+  cut_assert_equal_memory(text, strlen(text), data + 1, strlen(text));
+}
+
+static void assert_output_tag(const char *fname, size_t input_tag_size, int *tracks_found)
+{
+  FILE *file = fopen(fname, "rb");
+  cut_assert_not_null(file);
+
+  unsigned char tag[MAXIMUM_TAG_SIZE];
+  size_t read_size = fread(tag, 1, MAXIMUM_TAG_SIZE, file);
+  fclose(file);
+
+  if (read_size < ID3V2_HEADER_SIZE || memcmp(tag, "ID3", 3) != 0)
+  {
+    cut_omit("mp3 plugin built without libid3tag: ID3v2 tags not tested");
+  }
+
+  //same padded size as the original tag rendered as a whole
+  size_t tag_size = ID3V2_HEADER_SIZE + get_syncsafe_integer(tag + 6);
+  cut_assert_equal_int(input_tag_size, tag_size);
+  cut_assert_true(tag_size <= read_size);
+
+  size_t data_size = 0;
+  const unsigned char *data = find_frame(tag, tag_size, "TRCK", &data_size);
+  cut_assert_not_null(data);
+  if (data == NULL) { return; }
+
+  int track = data[1] - '0';
+  cut_assert_true(track >= 1 && track <= NUMBER_OF_FILES);
+  tracks_found[track - 1]++;
+
+  assert_text_frame(tag, tag_size, "TIT2", titles[track - 1]);
+  cut_assert_null(find_frame(tag, tag_size, "TLEN", &data_size));
+
+  data = find_frame(tag, tag_size, "APIC", &data_size);
+  cut_assert_not_null(data);
+  cut_assert_equal_memory(apic_data, sizeof(apic_data), data, data_size);
+
+  data = find_frame(tag, tag_size, "PRIV", &data_size);
+  cut_assert_not_null(data);
+  cut_assert_equal_memory(priv_data, sizeof(priv_data), data, data_size);
+}
+
+void cut_setup()
+{
+  char *tmp = getenv("TMPDIR");
+  snprintf(test_directory, sizeof(test_directory), "%s/libmp3splt_id3v2_tags_XXXXXX",
+      tmp ? tmp : "/tmp");
+  cut_assert_not_null(mkdtemp(test_directory));
+
+  snprintf(input_fname, sizeof(input_fname), "%s/input.mp3", test_directory);
+  snprintf(output_dir, sizeof(output_dir), "%s/output", test_directory);
+  cut_assert_equal_int(0, mkdir(output_dir, 0755));
+}
+
+void cut_teardown()
+{
+  char command[1024];
+  snprintf(command, sizeof(command), "rm -rf '%s'", test_directory);
+  system(command);
+}
+
+void test_split_keeps_the_original_frames_and_sets_the_per_track_frames()
+{
+  size_t input_tag_size = write_mp3_file_with_id3v2_tag(input_fname);
+
+  int error = split();
+  if (error == SPLT_ERROR_NO_PLUGIN_FOUND)
+  {
+    cut_omit("mp3 plugin not found: ID3v2 tags not tested");
+  }
+  cut_assert_true(error >= 0);
+
+  DIR *dir = opendir(output_dir);
+  cut_assert_not_null(dir);
+
+  int tracks_found[NUMBER_OF_FILES] = { 0 };
+  int files = 0;
+  struct dirent *entry = NULL;
+  while ((entry = readdir(dir)) != NULL)
+  {
+    if (entry->d_name[0] == '.') { continue; }
+
+    char fname[2048];
+    snprintf(fname, sizeof(fname), "%s/%s", output_dir, entry->d_name);
+    assert_output_tag(fname, input_tag_size, tracks_found);
+
+    files++;
+  }
+
+  closedir(dir);
+
+  cut_assert_equal_int(NUMBER_OF_FILES, files);
+  int i = 0;
+  for (i = 0;i < NUMBER_OF_FILES;i++)
+  {
+    cut_assert_equal_int(1, tracks_found[i]);
+  }
+}
+
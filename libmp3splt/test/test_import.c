@@ -0,0 +1,536 @@
+#include <cutter.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <limits.h>
+
+#include "libmp3splt/mp3splt.h"
+
+static splt_state *state = NULL;
+static char test_directory[512] = { '\0' };
+static char fname[1024] = { '\0' };
+
+static void write_file(const char *name, const char *contents)
+{
+  snprintf(fname, sizeof(fname), "%s/%s", test_directory, name);
+
+  FILE *file = fopen(fname, "wb");
+  cut_assert_not_null(file);
+  fputs(contents, file);
+  fclose(file);
+}
+
+static const splt_point *get_splitpoint(int index)
+{
+  int error = SPLT_OK;
+  splt_points *points = mp3splt_get_splitpoints(state, &error);
+  mp3splt_points_init_iterator(points);
+
+  const splt_point *point = NULL;
+  int i = 0;
+  for (i = 0;i <= index;i++)
+  {
+    point = mp3splt_points_next(points);
+  }
+
+  return point;
+}
+
+static int get_number_of_splitpoints()
+{
+  int error = SPLT_OK;
+  splt_points *points = mp3splt_get_splitpoints(state, &error);
+  mp3splt_points_init_iterator(points);
+
+  int number_of_splitpoints = 0;
+  while (mp3splt_points_next(points)) { number_of_splitpoints++; }
+
+  return number_of_splitpoints;
+}
+
+static int get_splitpoint_type(int index)
+{
+  return mp3splt_point_get_type(get_splitpoint(index));
+}
+
+static char *get_tags_field(int index, splt_tag_key key)
+{
+  int error = SPLT_OK;
+  splt_tags_group *tags_group = mp3splt_get_tags_group(state, &error);
+  mp3splt_tags_group_init_iterator(tags_group);
+
+  splt_tags *tags = NULL;
+  int i = 0;
+  for (i = 0;i <= index;i++)
+  {
+    tags = mp3splt_tags_group_next(tags_group);
+  }
+
+  return cut_take_string(mp3splt_tags_get(tags, key));
+}
+
+static const char *get_error_message(int error)
+{
+  return cut_take_string(mp3splt_get_strerror(state, error));
+}
+
+//! Bytes of a generated audio file
+typedef struct {
+  unsigned char bytes[8192];
+  size_t size;
+} fixture;
+
+static void put_bytes(fixture *file, const void *bytes, size_t size)
+{
+  memcpy(file->bytes + file->size, bytes, size);
+  file->size += size;
+}
+
+static void put_zeros(fixture *file, size_t size)
+{
+  memset(file->bytes + file->size, 0, size);
+  file->size += size;
+}
+
+static void put_uint32(unsigned char *bytes, unsigned long value, int syncsafe)
+{
+  int bits = syncsafe ? 7 : 8;
+  int i = 0;
+  for (i = 0;i < 4;i++)
+  {
+    bytes[i] = (value >> (bits * (3 - i))) & (syncsafe ? 0x7f : 0xff);
+  }
+}
+
+static void put_uint32_little_endian(fixture *file, unsigned long value)
+{
+  int i = 0;
+  for (i = 0;i < 4;i++)
+  {
+    file->bytes[file->size++] = (value >> (8 * i)) & 0xff;
+  }
+}
+
+static void put_uint64(fixture *file, unsigned long long value)
+{
+  int i = 0;
+  for (i = 0;i < 8;i++)
+  {
+    file->bytes[file->size++] = (value >> (8 * (7 - i))) & 0xff;
+  }
+}
+
+static void write_fixture(const char *name, const fixture *file)
+{
+  snprintf(fname, sizeof(fname), "%s/%s", test_directory, name);
+
+  FILE *output = fopen(fname, "wb");
+  cut_assert_not_null(output);
+  fwrite(file->bytes, file->size, 1, output);
+  fclose(output);
+}
+
+static void find_plugins()
+{
+  mp3splt_append_plugins_scan_dir(state, "../plugins/.libs");
+  mp3splt_append_plugins_scan_dir(state, "plugins/.libs");
+  mp3splt_find_plugins(state);
+}
+
+//! ID3v2.3 frame sizes are plain integers while ID3v2.4 ones are syncsafe
+static void put_id3v2_frame(fixture *tag, int version, const char *frame_id,
+    const unsigned char *data, size_t size)
+{
+  unsigned char frame_header[10] = { '\0' };
+  memcpy(frame_header, frame_id, 4);
+  put_uint32(frame_header + 4, size, version == 4);
+  put_bytes(tag, frame_header, sizeof(frame_header));
+  put_bytes(tag, data, size);
+}
+
+static void put_id3v2_text_frame(fixture *tag, int version, const char *frame_id,
+    const char *text)
+{
+  unsigned char data[256] = { '\0' };
+  memcpy(data + 1, text, strlen(text));
+  put_id3v2_frame(tag, version, frame_id, data, strlen(text) + 1);
+}
+
+//! A CHAP frame having less than the 16 bytes of its times and offsets is truncated
+static void put_id3v2_chapter(fixture *tag, int version, const char *element_id,
+    unsigned long start_millis, unsigned long end_millis, size_t times_and_offsets_size)
+{
+  unsigned char data[64] = { '\0' };
+  size_t size = strlen(element_id) + 1;
+  memcpy(data, element_id, size);
+  put_uint32(data + size, start_millis, SPLT_FALSE);
+  put_uint32(data + size + 4, end_millis, SPLT_FALSE);
+
+  put_id3v2_frame(tag, version, "CHAP", data, size + times_and_offsets_size);
+}
+
+/*! Writes a mp3 file with an ID3v2 tag having 3 chapters and a picture
+
+The picture is larger than 127 bytes to tell a syncsafe size from a plain one.
+*/
+static void write_mp3_with_chapters(const char *name, int version, unsigned char flags,
+    int truncated_chapter)
+{
+  fixture file;
+  file.size = 0;
+
+  unsigned char header[10] = { 'I', 'D', '3', version, 0, flags, 0, 0, 0, 0 };
+  put_bytes(&file, header, sizeof(header));
+
+  if (flags & 0x40)
+  {
+    unsigned char extended_header[10] = { '\0' };
+    if (version == 4)
+    {
+      //syncsafe size including the size bytes, one byte of flags
+      put_uint32(extended_header, 6, SPLT_TRUE);
+      extended_header[4] = 1;
+      put_bytes(&file, extended_header, 6);
+    }
+    else
+    {
+      //size without the size bytes, flags and padding size
+      put_uint32(extended_header, 6, SPLT_FALSE);
+      put_bytes(&file, extended_header, 10);
+    }
+  }
+
+  put_id3v2_text_frame(&file, version, "TPE1", "The Artist");
+  put_id3v2_text_frame(&file, version, "TALB", "The Album");
+
+  unsigned char picture[300] = { 0, 'i', 'm', 'a', 'g', 'e', '/', 'p', 'n', 'g', 0, 3, 0 };
+  int i = 0;
+  for (i = 13;i < (int) sizeof(picture);i++)
+  {
+    picture[i] = i & 0x7f;
+  }
+  put_id3v2_frame(&file, version, "APIC", picture, sizeof(picture));
+
+  put_id3v2_chapter(&file, version, "ch0", 0, 10000, 16);
+  put_id3v2_chapter(&file, version, "ch1", 10000, 25000, truncated_chapter ? 4 : 16);
+  put_id3v2_chapter(&file, version, "ch2", 25000, 40000, 16);
+
+  put_zeros(&file, 100);
+  put_uint32(file.bytes + 6, file.size - 10, SPLT_TRUE);
+
+  //mpeg 1 layer 3, 128 kbps, 44100 Hz
+  unsigned char frame[417] = { 0xFF, 0xFB, 0x90, 0xC4 };
+  for (i = 0;i < 4;i++)
+  {
+    put_bytes(&file, frame, sizeof(frame));
+  }
+
+  write_fixture(name, &file);
+}
+
+static void import_internal_sheet(int expected_error)
+{
+  find_plugins();
+
+  int error = mp3splt_import_internal_sheet_plan(state, fname);
+  if (error == SPLT_ERROR_NO_PLUGIN_FOUND)
+  {
+    cut_omit("plugin not found: internal sheet import not tested");
+  }
+  if (error == SPLT_PLUGIN_ERROR_UNSUPPORTED_FEATURE)
+  {
+    cut_omit("mp3 plugin built without libid3tag: chapters import not tested");
+  }
+
+  cut_assert_equal_int(expected_error, error);
+}
+
+static void assert_chapters(int truncated_chapter)
+{
+  cut_assert_equal_int(4, get_number_of_splitpoints());
+  cut_assert_equal_int(0, mp3splt_point_get_value(get_splitpoint(0)));
+  cut_assert_equal_int(1000, mp3splt_point_get_value(get_splitpoint(1)));
+  cut_assert_equal_int(2500, mp3splt_point_get_value(get_splitpoint(2)));
+  cut_assert_equal_int(4000, mp3splt_point_get_value(get_splitpoint(3)));
+
+  //the truncated chapter is skipped, leaving a gap between the other ones
+  cut_assert_equal_int(SPLT_SPLITPOINT, get_splitpoint_type(0));
+  cut_assert_equal_int(truncated_chapter ? SPLT_SKIPPOINT : SPLT_SPLITPOINT,
+      get_splitpoint_type(1));
+  cut_assert_equal_int(SPLT_SPLITPOINT, get_splitpoint_type(2));
+  cut_assert_equal_int(SPLT_SKIPPOINT, get_splitpoint_type(3));
+
+  cut_assert_equal_string("The Artist", get_tags_field(0, SPLT_TAGS_ARTIST));
+  cut_assert_equal_string("The Album", get_tags_field(2, SPLT_TAGS_ALBUM));
+}
+
+static void put_flac_metadata_block_header(fixture *file, unsigned char type,
+    int is_last, unsigned long length)
+{
+  unsigned char header[4] = { type | (is_last << 7),
+    (length >> 16) & 0xff, (length >> 8) & 0xff, length & 0xff };
+  put_bytes(file, header, sizeof(header));
+}
+
+static void put_flac_cuesheet_track(fixture *file, unsigned long long offset,
+    unsigned char number, unsigned char number_of_indexes)
+{
+  put_uint64(file, offset);
+  put_bytes(file, &number, 1);
+  put_zeros(file, 12 + 1 + 13);
+  put_bytes(file, &number_of_indexes, 1);
+}
+
+static void put_flac_cuesheet_index(fixture *file, unsigned long long offset,
+    unsigned char number)
+{
+  put_uint64(file, offset);
+  put_bytes(file, &number, 1);
+  put_zeros(file, 3);
+}
+
+/*! Writes a flac file with a picture, tags and a CD cue sheet of 3 tracks
+
+The second track has a pregap; its splitpoint is at its INDEX 01.
+A truncated cue sheet ends before the index of the second track.
+*/
+static void write_flac_with_cuesheet(const char *name, int truncated_cuesheet)
+{
+  fixture file;
+  file.size = 0;
+  put_bytes(&file, "fLaC", 4);
+
+  put_flac_metadata_block_header(&file, 0, SPLT_FALSE, 34);
+  put_zeros(&file, 34);
+
+  put_flac_metadata_block_header(&file, 6, SPLT_FALSE, 200);
+  put_zeros(&file, 200);
+
+  const char *comments[] = { "ARTIST=The Artist", "ALBUM=The Album" };
+  put_flac_metadata_block_header(&file, 4, SPLT_FALSE,
+      4 + 4 + 4 + 4 + strlen(comments[0]) + 4 + strlen(comments[1]));
+  put_uint32_little_endian(&file, 4);
+  put_bytes(&file, "test", 4);
+  put_uint32_little_endian(&file, 2);
+  int i = 0;
+  for (i = 0;i < 2;i++)
+  {
+    put_uint32_little_endian(&file, strlen(comments[i]));
+    put_bytes(&file, comments[i], strlen(comments[i]));
+  }
+
+  unsigned long cuesheet_length = truncated_cuesheet ?
+    396 + 36 + 12 + 36 : 396 + (36 + 12) + (36 + 2 * 12) + (36 + 12) + 36;
+  put_flac_metadata_block_header(&file, 5, SPLT_TRUE, cuesheet_length);
+
+  //media catalog number, lead-in, CD flag at offset 136, tracks at offset 395
+  put_zeros(&file, 128);
+  put_uint64(&file, 88200);
+  unsigned char is_cd = 0x80;
+  put_bytes(&file, &is_cd, 1);
+  put_zeros(&file, 258);
+  unsigned char number_of_tracks = 4;
+  put_bytes(&file, &number_of_tracks, 1);
+
+  put_flac_cuesheet_track(&file, 0, 1, 1);
+  put_flac_cuesheet_index(&file, 0, 1);
+
+  put_flac_cuesheet_track(&file, 44100 * 60, 2, 2);
+  if (!truncated_cuesheet)
+  {
+    put_flac_cuesheet_index(&file, 0, 0);
+    put_flac_cuesheet_index(&file, 44100 * 2, 1);
+
+    put_flac_cuesheet_track(&file, 44100 * 150, 3, 1);
+    put_flac_cuesheet_index(&file, 0, 1);
+
+    //lead-out
+    put_flac_cuesheet_track(&file, 44100 * 200, 170, 0);
+  }
+
+  write_fixture(name, &file);
+}
+
+void cut_setup()
+{
+  char *tmp = getenv("TMPDIR");
+  snprintf(test_directory, sizeof(test_directory), "%s/libmp3splt_import_XXXXXX",
+      tmp ? tmp : "/tmp");
+  cut_assert_not_null(mkdtemp(test_directory));
+
+  state = mp3splt_new_state(NULL);
+}
+
+void cut_teardown()
+{
+  mp3splt_free_state(state);
+
+  char command[1024];
+  snprintf(command, sizeof(command), "rm -rf '%s'", test_directory);
+  system(command);
+}
+
+void test_cue_import()
+{
+  write_file("album.cue",
+      "REM GENRE Rock\r\n"
+      "PERFORMER \"The Artist\"\r\n"
+      "TITLE \"The Album\"\r\n"
+      "FILE \"album.mp3\" MP3\r\n"
+      "  TRACK 01 AUDIO\r\n"
+      "    TITLE \"First TRACK AUDIO\"\r\n"
+      "    INDEX 01 00:00:00\r\n"
+      "  TRACK 02 AUDIO\r\n"
+      "    TITLE \"Second\"\r\n"
+      "    PERFORMER \"REM\"\r\n"
+      "    INDEX 00 02:58:00\r\n"
+      "    INDEX 1 03:00:00\r\n"
+      "  TRACK 03 AUDIO\r\n"
+      "\tTITLE \"Third\"\r\n"
+      "\tINDEX 01 05:30:74");
+
+  cut_assert_equal_int(SPLT_CUE_OK, mp3splt_import(state, CUE_IMPORT, fname));
+
+  cut_assert_equal_int(3, get_number_of_splitpoints());
+  cut_assert_equal_int(0, mp3splt_point_get_value(get_splitpoint(0)));
+  cut_assert_equal_int(18000, mp3splt_point_get_value(get_splitpoint(1)));
+  cut_assert_equal_int(33099, mp3splt_point_get_value(get_splitpoint(2)));
+
+  cut_assert_equal_string("First TRACK AUDIO", get_tags_field(0, SPLT_TAGS_TITLE));
+  cut_assert_equal_string("REM", get_tags_field(1, SPLT_TAGS_PERFORMER));
+  cut_assert_equal_string("Third", get_tags_field(2, SPLT_TAGS_TITLE));
+}
+
+void test_cue_errors_have_the_line_and_column()
+{
+  write_file("invalid.cue",
+      "FILE \"album.mp3\" MP3\n"
+      "  TRACK 01 AUDIO\n"
+      "    INDEX 01 00:00:00\n"
+      "  TRACK 02 AUDIO\n"
+      "    INDEX 01 03:xx:00\n");
+
+  int error = mp3splt_import(state, CUE_IMPORT, fname);
+  cut_assert_equal_int(SPLT_INVALID_CUE_FILE, error);
+
+  char expected_message[2048];
+  snprintf(expected_message, sizeof(expected_message),
+      " cue error: invalid cue file '%s:5:14'", fname);
+  cut_assert_equal_string(expected_message, get_error_message(error));
+}
+
+void test_cddb_import()
+{
+  write_file("album.cddb",
+      "# Track frame offsets:\n"
+      "#       150\n"
+      "#       15150\n"
+      "#\n"
+      "# Disc length: 600 seconds\n"
+      "DTITLE=The Artist / The Album\n"
+      "DYEAR=1999\n"
+      "DGENRE=Rock\n"
+      "TTITLE0=First\n"
+      "TTITLE1=Guest / Happy new YEAR\n"
+      "EXTD= YEAR: 1999 ID3G: 17\n");
+
+  cut_assert_equal_int(SPLT_CDDB_OK, mp3splt_import(state, CDDB_IMPORT, fname));
+
+  cut_assert_equal_int(3, get_number_of_splitpoints());
+  cut_assert_equal_int(0, mp3splt_point_get_value(get_splitpoint(0)));
+  cut_assert_equal_int(20000, mp3splt_point_get_value(get_splitpoint(1)));
+
+  cut_assert_equal_string("1999", get_tags_field(0, SPLT_TAGS_YEAR));
+  cut_assert_equal_string("The Album", get_tags_field(0, SPLT_TAGS_ALBUM));
+  cut_assert_equal_string("Happy new YEAR", get_tags_field(1, SPLT_TAGS_TITLE));
+  cut_assert_equal_string("Guest", get_tags_field(1, SPLT_TAGS_PERFORMER));
+}
+
+void test_audacity_errors_have_the_line_and_column()
+{
+  write_file("labels.txt",
+      "0.000000\t10.500000\tfirst\n"
+      "\n"
+      "10.500000\tbad\n");
+
+  int error = mp3splt_import(state, AUDACITY_LABELS_IMPORT, fname);
+  cut_assert_equal_int(SPLT_INVALID_AUDACITY_FILE, error);
+
+  char expected_message[2048];
+  snprintf(expected_message, sizeof(expected_message),
+      " audacity error: invalid audacity labels file '%s:3:11'", fname);
+  cut_assert_equal_string(expected_message, get_error_message(error));
+}
+
+void test_import_inexistent_file()
+{
+  snprintf(fname, sizeof(fname), "%s/inexistent.cue", test_directory);
+  cut_assert_equal_int(SPLT_ERROR_CANNOT_OPEN_FILE, mp3splt_import(state, CUE_IMPORT, fname));
+}
+
+void test_internal_sheet_plan_without_plugin_for_the_file()
+{
+  write_file("album.txt", "not an audio file");
+
+  cut_assert_equal_int(SPLT_ERROR_NO_PLUGIN_FOUND,
+      mp3splt_import_internal_sheet_plan(state, fname));
+  cut_assert_equal_int(SPLT_ERROR_INVALID, mp3splt_import_internal_sheet_plan(state, NULL));
+}
+
+void test_chapters_import_of_a_id3v2_4_tag()
+{
+  write_mp3_with_chapters("chapters.mp3", 4, 0, SPLT_FALSE);
+  import_internal_sheet(SPLT_OK);
+  assert_chapters(SPLT_FALSE);
+}
+
+void test_chapters_import_of_a_id3v2_3_tag_with_extended_header()
+{
+  write_mp3_with_chapters("chapters.mp3", 3, 0x40, SPLT_FALSE);
+  import_internal_sheet(SPLT_OK);
+  assert_chapters(SPLT_FALSE);
+}
+
+void test_chapters_import_of_a_id3v2_4_tag_with_extended_header()
+{
+  write_mp3_with_chapters("chapters.mp3", 4, 0x40, SPLT_FALSE);
+  import_internal_sheet(SPLT_OK);
+  assert_chapters(SPLT_FALSE);
+}
+
+void test_chapters_import_of_an_unsynchronised_tag_reads_the_whole_tag()
+{
+  write_mp3_with_chapters("chapters.mp3", 3, 0x80, SPLT_FALSE);
+  import_internal_sheet(SPLT_OK);
+  assert_chapters(SPLT_FALSE);
+}
+
+void test_chapters_import_skips_a_truncated_chapter()
+{
+  write_mp3_with_chapters("chapters.mp3", 4, 0, SPLT_TRUE);
+  import_internal_sheet(SPLT_OK);
+  assert_chapters(SPLT_TRUE);
+}
+
+void test_cuesheet_import_of_a_flac_file()
+{
+  write_flac_with_cuesheet("cuesheet.flac", SPLT_FALSE);
+  import_internal_sheet(SPLT_OK);
+
+  cut_assert_equal_int(4, get_number_of_splitpoints());
+  cut_assert_equal_int(0, mp3splt_point_get_value(get_splitpoint(0)));
+  cut_assert_equal_int(6200, mp3splt_point_get_value(get_splitpoint(1)));
+  cut_assert_equal_int(15000, mp3splt_point_get_value(get_splitpoint(2)));
+  cut_assert_equal_int(LONG_MAX, mp3splt_point_get_value(get_splitpoint(3)));
+
+  cut_assert_equal_string("The Artist", get_tags_field(0, SPLT_TAGS_ARTIST));
+  cut_assert_equal_string("The Album", get_tags_field(2, SPLT_TAGS_ALBUM));
+}
+
+void test_cuesheet_import_of_a_truncated_cuesheet()
+{
+  write_flac_with_cuesheet("cuesheet.flac", SPLT_TRUE);
+  import_internal_sheet(SPLT_ERROR_INTERNAL_SHEET);
+}
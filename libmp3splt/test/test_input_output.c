@@ -0,0 +1,548 @@
+#include <cutter.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <sys/stat.h>
+
+#include "libmp3splt/mp3splt.h"
+#include "splt.h"
+
+//mpeg 1 layer 3, 128 kbps, 44100 Hz, mono: frames of 417 bytes, 38.28 frames per second
+#define MP3_FRAME_SIZE 417
+
+static splt_state *state = NULL;
+static char test_directory[512] = { '\0' };
+static char part_fname[1024] = { '\0' };
+static char final_fname[1024] = { '\0' };
+
+static char memory_fname[1024] = { '\0' };
+static char memory_bytes[1024] = { '\0' };
+static size_t memory_size = 0;
+
+static void memory_file_done(const char *filename, const unsigned char *bytes, size_t size,
+    void *cb_data)
+{
+  snprintf(memory_fname, sizeof(memory_fname), "%s", filename);
+  memcpy(memory_bytes, bytes, size);
+  memory_bytes[size] = '\0';
+  memory_size = size;
+  (*(int *) cb_data)++;
+}
+
+//writes a header updated at the end, as the Xing or the streaminfo headers
+static void write_output_file_with_result(const char *fname, int complete)
+{
+  FILE *file = splt_os_fopen(state, fname, "wb+");
+  cut_assert_not_null(file);
+
+  cut_assert_equal_int(1, fwrite("....", 4, 1, file));
+  cut_assert_equal_int(1, fwrite(" frames", 7, 1, file));
+  cut_assert_equal_int(0, fseeko(file, 0, SEEK_SET));
+  cut_assert_equal_int(1, fwrite("HEAD", 4, 1, file));
+  cut_assert_equal_int(0, splt_os_fclose(state, file, complete));
+}
+
+static void write_output_file(const char *fname)
+{
+  write_output_file_with_result(fname, SPLT_TRUE);
+}
+
+//checks a file written by the file descriptor sink after its header
+static const char *assert_fd_sink_file(const char *bytes, const char *fname,
+    const char *contents)
+{
+  const unsigned char *header = (const unsigned char *) bytes;
+  unsigned long fname_length =
+    (header[0] << 24) | (header[1] << 16) | (header[2] << 8) | header[3];
+  cut_assert_equal_int(strlen(fname), fname_length);
+
+  unsigned long long size = 0;
+  int i = 0;
+  for (i = 4;i < 12;i++)
+  {
+    size = (size << 8) | header[i];
+  }
+  cut_assert_equal_int(strlen(contents), size);
+
+  bytes += 12;
+  cut_assert_equal_memory(fname, fname_length, bytes, fname_length);
+  bytes += fname_length;
+  cut_assert_equal_memory(contents, size, bytes, size);
+
+  return bytes + size;
+}
+
+static void write_file(const char *fname, const char *contents)
+{
+  FILE *file = fopen(fname, "w");
+  cut_assert_not_null(file);
+  fputs(contents, file);
+  fclose(file);
+}
+
+static char *read_file(const char *fname)
+{
+  FILE *file = fopen(fname, "r");
+  cut_assert_not_null(file);
+
+  static char contents[1024];
+  size_t length = fread(contents, 1, sizeof(contents) - 1, file);
+  contents[length] = '\0';
+  fclose(file);
+
+  return contents;
+}
+
+/*! Writes frames of silence, or frames with sound with a global gain of 200
+and two non zero spectral values coded in the side info of each granule */
+static void write_mp3_frames(FILE *mp3, int number_of_frames, int with_sound)
+{
+  unsigned char frame[MP3_FRAME_SIZE];
+  memset(frame, 0, MP3_FRAME_SIZE);
+  frame[0] = 0xFF;
+  frame[1] = 0xFB;
+  frame[2] = 0x90;
+  frame[3] = 0xC4;
+
+  if (with_sound)
+  {
+    //part2_3_length = 5, big_values = 1, global_gain = 200, table_select[0] = 1
+    static const unsigned char granule_side_info[8] =
+      { 0x00, 0x50, 0x0E, 0x40, 0x02, 0x00, 0x00, 0x00 };
+
+    //the 59 bits of each granule follow the 18 first bits of the side info
+    int bit = 18;
+    int granule = 0;
+    for (granule = 0;granule < 2;granule++)
+    {
+      int i = 0;
+      for (i = 0;i < 59;i++, bit++)
+      {
+        if (granule_side_info[i / 8] & (0x80 >> (i % 8)))
+        {
+          frame[4 + bit / 8] |= 0x80 >> (bit % 8);
+        }
+      }
+    }
+  }
+
+  int i = 0;
+  for (i = 0;i < number_of_frames;i++)
+  {
+    fwrite(frame, MP3_FRAME_SIZE, 1, mp3);
+  }
+}
+
+//! Number of the live split files ending with the suffix
+static int number_of_live_files(const char *suffix)
+{
+  DIR *dir = opendir(test_directory);
+  if (dir == NULL) { return 0; }
+
+  int files = 0;
+  struct dirent *entry = NULL;
+  while ((entry = readdir(dir)) != NULL)
+  {
+    size_t length = strlen(entry->d_name);
+    if (strncmp(entry->d_name, "live_", strlen("live_")) == 0 &&
+        length >= strlen(suffix) &&
+        strcmp(entry->d_name + length - strlen(suffix), suffix) == 0)
+    {
+      files++;
+    }
+  }
+
+  closedir(dir);
+  return files;
+}
+
+static int number_of_splitpoints()
+{
+  int error = SPLT_OK;
+  splt_points *points = mp3splt_get_splitpoints(state, &error);
+
+  int number_of_points = 0;
+  mp3splt_points_init_iterator(points);
+  while (mp3splt_points_next(points)) { number_of_points++; }
+
+  return number_of_points;
+}
+
+static int live_file_exists(int file_number)
+{
+  char fname[1024];
+  snprintf(fname, sizeof(fname), "%s/live_%d.mp3", test_directory, file_number);
+  return access(fname, F_OK) == 0;
+}
+
+static int mp3_plugin_is_available(const char *input)
+{
+  int error = SPLT_OK;
+  splt_state *probe_state = mp3splt_new_state(&error);
+  mp3splt_append_plugins_scan_dir(probe_state, "../plugins/.libs");
+  mp3splt_append_plugins_scan_dir(probe_state, "plugins/.libs");
+  mp3splt_find_plugins(probe_state);
+  mp3splt_set_filename_to_split(probe_state, input);
+
+  int available = (mp3splt_read_original_tags(probe_state) >= 0);
+
+  mp3splt_free_state(probe_state);
+  return available;
+}
+
+/*! Splits in live mode the input file fed to the standard input through a pipe
+
+A child process writes the input to the pipe and the library reads the pipe as
+an unbounded stream, without seeking.
+*/
+static int live_split_from_pipe(const char *input)
+{
+  int pipe_fds[2];
+  cut_assert_equal_int(0, pipe(pipe_fds));
+
+  pid_t pid = fork();
+  cut_assert_not_equal_int(-1, pid);
+  if (pid == 0)
+  {
+    close(pipe_fds[0]);
+
+    FILE *input_file = fopen(input, "rb");
+    if (input_file == NULL) { _exit(1); }
+
+    char buffer[4096];
+    size_t length = 0;
+    while ((length = fread(buffer, 1, sizeof(buffer), input_file)) > 0)
+    {
+      if (write(pipe_fds[1], buffer, length) != (ssize_t) length) { _exit(1); }
+    }
+
+    fclose(input_file);
+    close(pipe_fds[1]);
+    _exit(0);
+  }
+
+  close(pipe_fds[1]);
+
+  int saved_stdin = dup(STDIN_FILENO);
+  dup2(pipe_fds[0], STDIN_FILENO);
+  close(pipe_fds[0]);
+
+  mp3splt_append_plugins_scan_dir(state, "../plugins/.libs");
+  mp3splt_append_plugins_scan_dir(state, "plugins/.libs");
+  mp3splt_find_plugins(state);
+
+  mp3splt_set_filename_to_split(state, "-");
+  mp3splt_set_path_of_split(state, test_directory);
+  mp3splt_set_int_option(state, SPLT_OPT_SPLIT_MODE, SPLT_OPTION_LIVE_MODE);
+  mp3splt_set_int_option(state, SPLT_OPT_TAGS, SPLT_NO_TAGS);
+  mp3splt_set_int_option(state, SPLT_OPT_OUTPUT_FILENAMES, SPLT_OUTPUT_FORMAT);
+  mp3splt_set_oformat(state, "live_@n");
+
+  int error = mp3splt_split(state);
+
+  dup2(saved_stdin, STDIN_FILENO);
+  close(saved_stdin);
+  clearerr(stdin);
+
+  int status = 0;
+  waitpid(pid, &status, 0);
+
+  return error;
+}
+
+void cut_setup()
+{
+  char *tmp = getenv("TMPDIR");
+  snprintf(test_directory, sizeof(test_directory), "%s/libmp3splt_input_output_XXXXXX",
+      tmp ? tmp : "/tmp");
+  cut_assert_not_null(mkdtemp(test_directory));
+
+  snprintf(part_fname, sizeof(part_fname), "%s/segment.mp3.part", test_directory);
+  snprintf(final_fname, sizeof(final_fname), "%s/segment.mp3", test_directory);
+
+  memory_fname[0] = '\0';
+  memory_bytes[0] = '\0';
+  memory_size = 0;
+
+  state = mp3splt_new_state(NULL);
+}
+
+void cut_teardown()
+{
+  mp3splt_free_state(state);
+
+  char command[1024];
+  snprintf(command, sizeof(command), "rm -rf '%s'", test_directory);
+  system(command);
+}
+
+void test_sync_and_rename()
+{
+  write_file(part_fname, "complete segment");
+
+  cut_assert_equal_int(SPLT_OK, splt_io_sync_and_rename(state, part_fname, final_fname));
+  cut_assert_equal_string("complete segment", read_file(final_fname));
+  cut_assert_equal_int(-1, access(part_fname, F_OK));
+}
+
+void test_sync_and_rename_replaces_the_final_file()
+{
+  write_file(final_fname, "previous segment");
+  write_file(part_fname, "new segment");
+
+  cut_assert_equal_int(SPLT_OK, splt_io_sync_and_rename(state, part_fname, final_fname));
+  cut_assert_equal_string("new segment", read_file(final_fname));
+}
+
+void test_sync_and_rename_without_the_temporary_file()
+{
+  cut_assert_equal_int(SPLT_ERROR_CANNOT_CLOSE_FILE,
+      splt_io_sync_and_rename(state, part_fname, final_fname));
+  cut_assert_equal_int(-1, access(final_fname, F_OK));
+}
+
+void test_sync_and_rename_keeps_the_final_name_when_the_rename_fails()
+{
+  cut_assert_equal_int(0, mkdir(final_fname, 0755));
+  write_file(part_fname, "new segment");
+
+  cut_assert_equal_int(SPLT_ERROR_CANNOT_CLOSE_FILE,
+      splt_io_sync_and_rename(state, part_fname, final_fname));
+  cut_assert_equal_int(0, access(final_fname, F_OK));
+  cut_assert_equal_string("new segment", read_file(part_fname));
+}
+
+void test_sync_and_rename_when_pretending_to_split()
+{
+  mp3splt_set_int_option(state, SPLT_OPT_PRETEND_TO_SPLIT, SPLT_TRUE);
+
+  cut_assert_equal_int(SPLT_OK, splt_io_sync_and_rename(state, part_fname, final_fname));
+  cut_assert_equal_int(-1, access(final_fname, F_OK));
+}
+
+void test_output_file_without_sink()
+{
+  write_output_file(final_fname);
+  cut_assert_equal_string("HEAD frames", read_file(final_fname));
+}
+
+void test_memory_output_sink()
+{
+  int files_done = 0;
+  cut_assert_equal_int(SPLT_OK,
+      mp3splt_set_memory_output_sink(state, memory_file_done, &files_done));
+
+  write_output_file(final_fname);
+
+  cut_assert_equal_int(1, files_done);
+  cut_assert_equal_string(final_fname, memory_fname);
+  cut_assert_equal_int(11, memory_size);
+  cut_assert_equal_string("HEAD frames", memory_bytes);
+  cut_assert_equal_int(-1, access(final_fname, F_OK));
+}
+
+void test_fd_output_sink()
+{
+  int fds[2];
+  cut_assert_equal_int(0, pipe(fds));
+
+  cut_assert_equal_int(SPLT_OK, mp3splt_set_fd_output_sink(state, fds[1]));
+  write_output_file(final_fname);
+  write_output_file(part_fname);
+  close(fds[1]);
+
+  char bytes[4096];
+  ssize_t length = read(fds[0], bytes, sizeof(bytes));
+  close(fds[0]);
+
+  size_t expected_length = 2 * (12 + 11) + strlen(final_fname) + strlen(part_fname);
+  cut_assert_equal_int(expected_length, length);
+
+  const char *next_file = assert_fd_sink_file(bytes, final_fname, "HEAD frames");
+  assert_fd_sink_file(next_file, part_fname, "HEAD frames");
+  cut_assert_equal_int(-1, access(final_fname, F_OK));
+}
+
+void test_fd_output_sink_skips_the_incomplete_files()
+{
+  int fds[2];
+  cut_assert_equal_int(0, pipe(fds));
+
+  cut_assert_equal_int(SPLT_OK, mp3splt_set_fd_output_sink(state, fds[1]));
+  write_output_file_with_result(part_fname, SPLT_FALSE);
+  write_output_file(final_fname);
+  close(fds[1]);
+
+  char bytes[4096];
+  ssize_t length = read(fds[0], bytes, sizeof(bytes));
+  close(fds[0]);
+
+  cut_assert_equal_int(12 + strlen(final_fname) + 11, length);
+  assert_fd_sink_file(bytes, final_fname, "HEAD frames");
+}
+
+void test_memory_output_sink_skips_the_incomplete_files()
+{
+  int files_done = 0;
+  cut_assert_equal_int(SPLT_OK,
+      mp3splt_set_memory_output_sink(state, memory_file_done, &files_done));
+
+  write_output_file_with_result(final_fname, SPLT_FALSE);
+
+  cut_assert_equal_int(0, files_done);
+}
+
+void test_temporary_file_output_sink()
+{
+  cut_assert_equal_int(SPLT_OK, mp3splt_set_temporary_file_output_sink(state));
+
+  write_output_file(final_fname);
+
+  cut_assert_equal_string("HEAD frames", read_file(final_fname));
+  cut_assert_equal_int(-1, access(part_fname, F_OK));
+}
+
+void test_temporary_file_output_sink_keeps_the_incomplete_files()
+{
+  cut_assert_equal_int(SPLT_OK, mp3splt_set_temporary_file_output_sink(state));
+
+  write_output_file_with_result(final_fname, SPLT_FALSE);
+
+  cut_assert_equal_string("HEAD frames", read_file(part_fname));
+  cut_assert_equal_int(-1, access(final_fname, F_OK));
+}
+
+static void stop_split_in_the_middle(const splt_progress *p_bar, void *cb_data)
+{
+  if (mp3splt_progress_get_percent_progress(p_bar) > 0.3)
+  {
+    mp3splt_stop_split(state);
+  }
+}
+
+void test_temporary_file_output_sink_keeps_the_part_file_of_a_cancelled_split()
+{
+  char input[1024];
+  snprintf(input, sizeof(input), "%s/input.mp3", test_directory);
+  FILE *mp3 = fopen(input, "wb");
+  cut_assert_not_null(mp3);
+  write_mp3_frames(mp3, 2000, SPLT_FALSE);
+  fclose(mp3);
+
+  if (!mp3_plugin_is_available(input))
+  {
+    cut_omit("mp3 plugin not found: cancelled split not tested");
+  }
+
+  mp3splt_append_plugins_scan_dir(state, "../plugins/.libs");
+  mp3splt_append_plugins_scan_dir(state, "plugins/.libs");
+  mp3splt_find_plugins(state);
+
+  mp3splt_set_filename_to_split(state, input);
+  mp3splt_set_path_of_split(state, test_directory);
+  mp3splt_set_int_option(state, SPLT_OPT_TAGS, SPLT_NO_TAGS);
+  mp3splt_set_int_option(state, SPLT_OPT_FRAME_MODE, SPLT_TRUE);
+  mp3splt_set_int_option(state, SPLT_OPT_SINGLE_READ_PASS, SPLT_TRUE);
+  mp3splt_set_int_option(state, SPLT_OPT_OUTPUT_FILENAMES, SPLT_OUTPUT_CUSTOM);
+  mp3splt_set_progress_function(state, stop_split_in_the_middle, NULL);
+  cut_assert_equal_int(SPLT_OK, mp3splt_set_temporary_file_output_sink(state));
+
+  splt_point *point = mp3splt_point_new(0, NULL);
+  mp3splt_point_set_name(point, "segment");
+  mp3splt_append_splitpoint(state, point);
+  mp3splt_append_splitpoint(state, mp3splt_point_new(5000, NULL));
+
+  cut_assert_equal_int(SPLT_SPLIT_CANCELLED, mp3splt_split(state));
+
+  cut_assert_equal_int(0, access(part_fname, F_OK));
+  cut_assert_equal_int(-1, access(final_fname, F_OK));
+}
+
+void test_output_sink_without_callbacks()
+{
+  splt_output_sink sink;
+  memset(&sink, 0, sizeof(sink));
+
+  cut_assert_equal_int(SPLT_ERROR_INVALID, mp3splt_set_output_sink(state, &sink));
+  cut_assert_equal_int(SPLT_ERROR_INVALID, mp3splt_set_fd_output_sink(state, -1));
+
+  cut_assert_equal_int(SPLT_OK, mp3splt_set_temporary_file_output_sink(state));
+  cut_assert_equal_int(SPLT_OK, mp3splt_set_output_sink(state, NULL));
+
+  write_output_file(final_fname);
+  cut_assert_equal_string("HEAD frames", read_file(final_fname));
+}
+
+void test_live_split_of_a_pipe_on_time()
+{
+  char input[1024];
+  snprintf(input, sizeof(input), "%s/input.mp3", test_directory);
+  FILE *mp3 = fopen(input, "wb");
+  cut_assert_not_null(mp3);
+  //52.24 seconds
+  write_mp3_frames(mp3, 2000, SPLT_FALSE);
+  fclose(mp3);
+
+  if (!mp3_plugin_is_available(input))
+  {
+    cut_omit("mp3 plugin not found: live split not tested");
+  }
+
+  mp3splt_set_long_option(state, SPLT_OPT_SPLIT_TIME, 1000);
+  mp3splt_set_int_option(state, SPLT_OPT_HANDLE_BIT_RESERVOIR, SPLT_TRUE);
+
+  cut_assert_equal_int(SPLT_LIVE_SPLIT_OK, live_split_from_pipe(input));
+
+  int i = 0;
+  for (i = 1;i <= 6;i++)
+  {
+    cut_assert_true(live_file_exists(i));
+  }
+  cut_assert_false(live_file_exists(7));
+
+  cut_assert_equal_int(6, number_of_live_files(".mp3"));
+  cut_assert_equal_int(0, number_of_live_files(".part"));
+  cut_assert_equal_int(2, number_of_splitpoints());
+}
+
+void test_live_split_of_a_pipe_on_silence()
+{
+  char input[1024];
+  snprintf(input, sizeof(input), "%s/input.mp3", test_directory);
+  FILE *mp3 = fopen(input, "wb");
+  cut_assert_not_null(mp3);
+  //three tracks of 5 seconds separated by 2.6 seconds of silence
+  write_mp3_frames(mp3, 200, SPLT_TRUE);
+  write_mp3_frames(mp3, 100, SPLT_FALSE);
+  write_mp3_frames(mp3, 200, SPLT_TRUE);
+  write_mp3_frames(mp3, 100, SPLT_FALSE);
+  write_mp3_frames(mp3, 200, SPLT_TRUE);
+  fclose(mp3);
+
+  if (!mp3_plugin_is_available(input))
+  {
+    cut_omit("mp3 plugin not found: live split on silence not tested");
+  }
+
+  mp3splt_set_long_option(state, SPLT_OPT_SPLIT_TIME, 0);
+  mp3splt_set_int_option(state, SPLT_OPT_LIVE_SPLIT_ON_SILENCE, SPLT_TRUE);
+  mp3splt_set_float_option(state, SPLT_OPT_PARAM_THRESHOLD, -48.0);
+  mp3splt_set_float_option(state, SPLT_OPT_PARAM_MIN_LENGTH, 1.0);
+  mp3splt_set_float_option(state, SPLT_OPT_PARAM_MIN_TRACK_LENGTH, 0.0);
+
+  cut_assert_equal_int(SPLT_LIVE_SPLIT_OK, live_split_from_pipe(input));
+
+  cut_assert_true(live_file_exists(1));
+  cut_assert_true(live_file_exists(2));
+  cut_assert_true(live_file_exists(3));
+  cut_assert_false(live_file_exists(4));
+
+  cut_assert_equal_int(3, number_of_live_files(".mp3"));
+  cut_assert_equal_int(0, number_of_live_files(".part"));
+  cut_assert_equal_int(2, number_of_splitpoints());
+}
@@ -0,0 +1,128 @@
+#include <cutter.h>
+
+#include <limits.h>
+
+#include "libmp3splt/mp3splt.h"
+#include "splt.h"
+
+static splt_state *state = NULL;
+static int error = SPLT_OK;
+
+static void append_splitpoints(long *values, int number_of_values)
+{
+  int i = 0;
+  for (i = 0;i < number_of_values;i++)
+  {
+    cut_assert_equal_int(SPLT_OK,
+        splt_sp_append_splitpoint(state, values[i], NULL, SPLT_SPLITPOINT));
+  }
+}
+
+static const char *output_filename(int current_split)
+{
+  splt_t_set_current_split(state, current_split);
+  cut_assert_equal_int(SPLT_OK, splt_of_put_output_format_filename(state, -1));
+
+  return splt_sp_get_splitpoint_name(state, current_split, &error);
+}
+
+static void set_oformat(const char *format, int tracks)
+{
+  splt_of_set_oformat(state, format, &error, SPLT_TRUE);
+  splt_of_set_oformat_digits_tracks(state, tracks);
+}
+
+void cut_setup()
+{
+  state = mp3splt_new_state(NULL);
+  error = SPLT_OK;
+
+  mp3splt_set_int_option(state, SPLT_OPT_OUTPUT_FILENAMES, SPLT_OUTPUT_FORMAT);
+  mp3splt_set_filename_to_split(state, "/music/album/song.v1.mp3");
+}
+
+void cut_teardown()
+{
+  mp3splt_free_state(state);
+}
+
+void test_compiled_fields()
+{
+  splt_of_set_oformat(state, "track @n2 - @t_@m0m", &error, SPLT_TRUE);
+
+  cut_assert_equal_int(4, state->oformat.number_of_fields);
+  cut_assert_equal_int('\0', state->oformat.fields[0].variable);
+  cut_assert_equal_string("track ", state->oformat.fields[0].text);
+  cut_assert_equal_int('n', state->oformat.fields[1].variable);
+  cut_assert_equal_int(2, state->oformat.fields[1].digits);
+  cut_assert_equal_string(" - ", state->oformat.fields[1].text);
+  cut_assert_equal_int('t', state->oformat.fields[2].variable);
+  cut_assert_equal_string("_", state->oformat.fields[2].text);
+  cut_assert_equal_int(0, state->oformat.fields[3].number_after_variable);
+  cut_assert_equal_string("m", state->oformat.fields[3].text);
+  cut_assert_equal_string("", state->oformat.fields[3].zero_value_text);
+}
+
+void test_tags_and_track_numbers()
+{
+  long values[] = { 0, 6000, 12000 };
+  append_splitpoints(values, 3);
+
+  splt_tu_set_tags_field(state, 0, SPLT_TAGS_ARTIST, "Art*ist");
+  splt_tu_set_tags_field(state, 0, SPLT_TAGS_TITLE, "Ti:tle  ");
+  splt_tu_set_tags_field(state, 1, SPLT_TAGS_ARTIST, "Other");
+
+  set_oformat("@n3_@a - @t @f", 2);
+
+  cut_assert_equal_string("001_Art_ist - Ti_tle song.v1", output_filename(0));
+  cut_assert_equal_string("002_Other -  song.v1", output_filename(1));
+}
+
+void test_alphabetical_track_numbers()
+{
+  long values[] = { 0, 6000, 12000 };
+  append_splitpoints(values, 3);
+
+  set_oformat("@l-@U3", 2);
+
+  cut_assert_equal_string("a-AAA", output_filename(0));
+  cut_assert_equal_string("b-AAB", output_filename(1));
+}
+
+void test_zero_time_values_are_removed()
+{
+  long values[] = { 6000, 12345, 24000 };
+  append_splitpoints(values, 3);
+
+  set_oformat("@m0m_@s0s_@h0h", 2);
+
+  cut_assert_equal_string("1m", output_filename(0));
+  cut_assert_equal_string("2m_3s_45h", output_filename(1));
+}
+
+void test_default_output_ends_with_eof()
+{
+  long values[] = { 0, 6000, LONG_MAX };
+  append_splitpoints(values, 3);
+
+  set_oformat(SPLT_DEFAULT_OUTPUT, 2);
+
+  cut_assert_equal_string("song.v1_00m_00s__01m_00s", output_filename(0));
+  cut_assert_equal_string("song.v1_01m_00s__EOF", output_filename(1));
+}
+
+void test_filename_buffer_is_reused()
+{
+  long values[] = { 0, 6000, 12000 };
+  append_splitpoints(values, 3);
+
+  set_oformat("@f_@n", 2);
+
+  output_filename(0);
+  const char *buffer = state->oformat.filename.str;
+  cut_assert_not_null(buffer);
+
+  cut_assert_equal_string("song.v1_2", output_filename(1));
+  cut_assert_equal_pointer(buffer, state->oformat.filename.str);
+}
+
@@ -0,0 +1,254 @@
+#include <cutter.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "libmp3splt/mp3splt.h"
+
+//mpeg 1 layer 3, 128 kbps, 44100 Hz, mono: silent frames of 417 bytes
+#define MP3_FRAME_SIZE 417
+#define MP3_NUMBER_OF_FRAMES 2000
+
+static splt_state *state = NULL;
+static char test_directory[512] = { '\0' };
+
+static void write_cue_file(const char *cue_fname, int tracks)
+{
+  FILE *cue = fopen(cue_fname, "w");
+  cut_assert_not_null(cue);
+
+  fprintf(cue, "PERFORMER \"Artist\"\nTITLE \"Album\"\nFILE \"input.mp3\" MP3\n");
+
+  int i = 0;
+  for (i = 0;i < tracks;i++)
+  {
+    fprintf(cue, "  TRACK %02d AUDIO\n    TITLE \"Track %d\"\n    INDEX 01 %02d:%02d:00\n",
+        i + 1, i + 1, (i * 5) / 60, (i * 5) % 60);
+  }
+
+  fclose(cue);
+}
+
+static void write_silent_mp3_file(const char *mp3_fname)
+{
+  FILE *mp3 = fopen(mp3_fname, "wb");
+  cut_assert_not_null(mp3);
+
+  unsigned char frame[MP3_FRAME_SIZE];
+  memset(frame, 0, MP3_FRAME_SIZE);
+  frame[0] = 0xFF;
+  frame[1] = 0xFB;
+  frame[2] = 0x90;
+  frame[3] = 0xC4;
+
+  int i = 0;
+  for (i = 0;i < MP3_NUMBER_OF_FRAMES;i++)
+  {
+    fwrite(frame, MP3_FRAME_SIZE, 1, mp3);
+  }
+
+  fclose(mp3);
+}
+
+static int number_of_splitpoints(splt_state *state)
+{
+  int error = SPLT_OK;
+  splt_points *points = mp3splt_get_splitpoints(state, &error);
+
+  int number_of_points = 0;
+  mp3splt_points_init_iterator(points);
+  while (mp3splt_points_next(points)) { number_of_points++; }
+
+  return number_of_points;
+}
+
+static int number_of_files(const char *directory)
+{
+  DIR *dir = opendir(directory);
+  if (dir == NULL) { return 0; }
+
+  int files = 0;
+  struct dirent *entry = NULL;
+  while ((entry = readdir(dir)) != NULL)
+  {
+    if (entry->d_name[0] != '.') { files++; }
+  }
+
+  closedir(dir);
+  return files;
+}
+
+//! Builds a local freedb index of one disc and searches it, without network access
+static int search_local_freedb_index(splt_state *state)
+{
+  char fname[1024];
+  snprintf(fname, sizeof(fname), "%s/dump", test_directory);
+  mkdir(fname, 0755);
+  snprintf(fname, sizeof(fname), "%s/dump/rock", test_directory);
+  mkdir(fname, 0755);
+
+  snprintf(fname, sizeof(fname), "%s/dump/rock/0a0b0c0d", test_directory);
+  FILE *disc = fopen(fname, "w");
+  cut_assert_not_null(disc);
+  fputs("# xmcd\nDISCID=0a0b0c0d\nDTITLE=The Artist / The First Album\nTTITLE0=First\n", disc);
+  fclose(disc);
+
+  char dump[1024];
+  snprintf(dump, sizeof(dump), "%s/dump", test_directory);
+  char index_fname[1024];
+  snprintf(index_fname, sizeof(index_fname), "%s/freedb.index", test_directory);
+  cut_assert_equal_int(SPLT_FREEDB_LOCAL_INDEX_OK,
+      mp3splt_freedb_build_local_index(state, dump, index_fname));
+
+  int error = SPLT_OK;
+  mp3splt_get_freedb_search(state, "first album", &error,
+      SPLT_FREEDB_SEARCH_TYPE_LOCAL_INDEX, index_fname, -1);
+  return error;
+}
+
+static int split_by_time(splt_state *state, const char *output_dir)
+{
+  char input[1024];
+  snprintf(input, sizeof(input), "%s/input.mp3", test_directory);
+
+  mp3splt_set_filename_to_split(state, input);
+  mp3splt_set_path_of_split(state, output_dir);
+  mp3splt_set_int_option(state, SPLT_OPT_SPLIT_MODE, SPLT_OPTION_TIME_MODE);
+  mp3splt_set_long_option(state, SPLT_OPT_SPLIT_TIME, 1000);
+  mp3splt_set_int_option(state, SPLT_OPT_TAGS, SPLT_NO_TAGS);
+  mp3splt_set_int_option(state, SPLT_OPT_OUTPUT_FILENAMES, SPLT_OUTPUT_FORMAT);
+  mp3splt_set_oformat(state, "@f_@n");
+
+  return mp3splt_split(state);
+}
+
+void cut_setup()
+{
+  char *tmp = getenv("TMPDIR");
+  snprintf(test_directory, sizeof(test_directory), "%s/libmp3splt_reset_state_XXXXXX",
+      tmp ? tmp : "/tmp");
+  cut_assert_not_null(mkdtemp(test_directory));
+
+  char fname[1024];
+  snprintf(fname, sizeof(fname), "%s/input.mp3", test_directory);
+  write_silent_mp3_file(fname);
+
+  int error = SPLT_OK;
+  state = mp3splt_new_state(&error);
+  cut_assert_equal_int(SPLT_OK, error);
+
+  mp3splt_append_plugins_scan_dir(state, "../plugins/.libs");
+  mp3splt_append_plugins_scan_dir(state, "plugins/.libs");
+  mp3splt_find_plugins(state);
+}
+
+void cut_teardown()
+{
+  mp3splt_free_state(state);
+  state = NULL;
+
+  char command[1024];
+  snprintf(command, sizeof(command), "rm -rf '%s'", test_directory);
+  system(command);
+}
+
+void test_reset_clears_the_file_data_and_keeps_the_options()
+{
+  char cue_fname[1024];
+  snprintf(cue_fname, sizeof(cue_fname), "%s/tracks.cue", test_directory);
+  write_cue_file(cue_fname, 6);
+
+  mp3splt_set_filename_to_split(state, "input.mp3");
+  mp3splt_set_int_option(state, SPLT_OPT_TAGS, SPLT_NO_TAGS);
+  mp3splt_set_long_option(state, SPLT_OPT_OVERLAP_TIME, 300);
+  cut_assert_equal_int(SPLT_CUE_OK, mp3splt_import(state, CUE_IMPORT, cue_fname));
+  cut_assert_equal_int(6, number_of_splitpoints(state));
+
+  cut_assert_equal_int(SPLT_OK, mp3splt_reset_state(state));
+
+  cut_assert_null(mp3splt_get_filename_to_split(state));
+  cut_assert_equal_int(0, number_of_splitpoints(state));
+
+  int error = SPLT_OK;
+  cut_assert_equal_int(SPLT_NO_TAGS, mp3splt_get_int_option(state, SPLT_OPT_TAGS, &error));
+  cut_assert_equal_int(300, mp3splt_get_long_option(state, SPLT_OPT_OVERLAP_TIME, &error));
+}
+
+void test_reset_state_imports_again()
+{
+  char cue_fname[1024];
+  snprintf(cue_fname, sizeof(cue_fname), "%s/tracks.cue", test_directory);
+
+  write_cue_file(cue_fname, 40);
+  cut_assert_equal_int(SPLT_CUE_OK, mp3splt_import(state, CUE_IMPORT, cue_fname));
+  cut_assert_equal_int(40, number_of_splitpoints(state));
+
+  cut_assert_equal_int(SPLT_OK, mp3splt_reset_state(state));
+
+  write_cue_file(cue_fname, 3);
+  cut_assert_equal_int(SPLT_CUE_OK, mp3splt_import(state, CUE_IMPORT, cue_fname));
+  cut_assert_equal_int(3, number_of_splitpoints(state));
+}
+
+void test_reset_and_free_state_after_a_freedb_search()
+{
+  cut_assert_equal_int(SPLT_FREEDB_OK, search_local_freedb_index(state));
+
+  //the search results are freed by the reset and not freed again with the state
+  cut_assert_equal_int(SPLT_OK, mp3splt_reset_state(state));
+  cut_assert_equal_int(SPLT_OK, mp3splt_reset_state(state));
+
+  cut_assert_equal_int(SPLT_FREEDB_OK, search_local_freedb_index(state));
+  cut_assert_equal_int(SPLT_OK, mp3splt_reset_state(state));
+}
+
+void test_reset_state_splits_again_with_the_same_plugins()
+{
+  char first_output_dir[1024];
+  snprintf(first_output_dir, sizeof(first_output_dir), "%s/first", test_directory);
+  char second_output_dir[1024];
+  snprintf(second_output_dir, sizeof(second_output_dir), "%s/second", test_directory);
+  cut_assert_equal_int(0, mkdir(first_output_dir, 0755));
+  cut_assert_equal_int(0, mkdir(second_output_dir, 0755));
+
+  int error = split_by_time(state, first_output_dir);
+  if (error == SPLT_ERROR_NO_PLUGIN_FOUND_FOR_FILE || error == SPLT_ERROR_NO_PLUGIN_FOUND)
+  {
+    cut_omit("mp3 plugin not found: split after reset not tested");
+  }
+  cut_assert_equal_int(SPLT_TIME_SPLIT_OK, error);
+
+  char *plugin_name = strdup(mp3splt_get_plugin_name(state));
+
+  cut_assert_equal_int(SPLT_OK, mp3splt_reset_state(state));
+  cut_assert_equal_int(SPLT_TIME_SPLIT_OK, split_by_time(state, second_output_dir));
+
+  cut_assert_equal_string(plugin_name, mp3splt_get_plugin_name(state));
+  free(plugin_name);
+
+  cut_assert_equal_int(6, number_of_files(first_output_dir));
+  cut_assert_equal_int(6, number_of_files(second_output_dir));
+}
+
+void test_states_share_the_plugins_until_the_last_one_is_freed()
+{
+  int error = SPLT_OK;
+  splt_state *other_state = mp3splt_new_state(&error);
+  mp3splt_append_plugins_scan_dir(other_state, "../plugins/.libs");
+  mp3splt_append_plugins_scan_dir(other_state, "plugins/.libs");
+  mp3splt_find_plugins(other_state);
+
+  cut_assert_equal_int(SPLT_OK, mp3splt_reset_state(state));
+  cut_assert_equal_int(SPLT_ERROR_LIBRARY_LOCKED, mp3splt_free_plugins_cache());
+
+  mp3splt_free_state(other_state);
+  cut_assert_equal_int(SPLT_ERROR_LIBRARY_LOCKED, mp3splt_free_plugins_cache());
+
+  mp3splt_free_state(state);
+  state = NULL;
+  cut_assert_equal_int(SPLT_OK, mp3splt_free_plugins_cache());
+}
+
@@ -0,0 +1,297 @@
+#include <cutter.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "libmp3splt/mp3splt.h"
+
+//mpeg 1 layer 3, 128 kbps, 44100 Hz, mono: frames of 417 bytes
+#define MP3_FRAME_SIZE 417
+#define MP3_NUMBER_OF_FRAMES 2000
+#define MP3_MAIN_DATA_BEGIN 100
+#define MAXIMUM_NUMBER_OF_SPLITPOINTS 64
+
+static char test_directory[512] = { '\0' };
+static char input_fname[1024] = { '\0' };
+
+//! Splitpoints after the split, to compare the split in a single read pass with the other
+typedef struct {
+  long values[MAXIMUM_NUMBER_OF_SPLITPOINTS];
+  int number_of_splitpoints;
+} split_result;
+
+/*! Writes silent frames holding their frame number in their main data, to tell them apart
+
+The main data of each frame but the first begins in the previous frame, to
+have a bit reservoir frame at the beginning of the files.
+*/
+static void write_numbered_mp3_file(const char *mp3_fname)
+{
+  FILE *mp3 = fopen(mp3_fname, "wb");
+  cut_assert_not_null(mp3);
+
+  unsigned char frame[MP3_FRAME_SIZE];
+  memset(frame, 0, MP3_FRAME_SIZE);
+  frame[0] = 0xFF;
+  frame[1] = 0xFB;
+  frame[2] = 0x90;
+  frame[3] = 0xC4;
+
+  int i = 0;
+  for (i = 0;i < MP3_NUMBER_OF_FRAMES;i++)
+  {
+    if (i > 0)
+    {
+      //main data begin of 9 bits
+      frame[4] = (MP3_MAIN_DATA_BEGIN >> 1) & 0xFF;
+      frame[5] = (MP3_MAIN_DATA_BEGIN & 0x1) << 7;
+    }
+    frame[MP3_FRAME_SIZE - 2] = (i >> 8) & 0xFF;
+    frame[MP3_FRAME_SIZE - 1] = i & 0xFF;
+    fwrite(frame, MP3_FRAME_SIZE, 1, mp3);
+  }
+
+  fclose(mp3);
+}
+
+static void set_splitpoints(splt_state *state)
+{
+  mp3splt_append_splitpoint(state, mp3splt_point_new(0, NULL));
+  mp3splt_append_splitpoint(state, mp3splt_point_new(1234, NULL));
+
+  splt_point *skippoint = mp3splt_point_new(2501, NULL);
+  mp3splt_point_set_type(skippoint, SPLT_SKIPPOINT);
+  mp3splt_append_splitpoint(state, skippoint);
+
+  mp3splt_append_splitpoint(state, mp3splt_point_new(3777, NULL));
+  mp3splt_append_splitpoint(state, mp3splt_point_new(4210, NULL));
+  mp3splt_append_splitpoint(state, mp3splt_point_new(LONG_MAX, NULL));
+}
+
+static void set_time_split(splt_state *state)
+{
+  mp3splt_set_int_option(state, SPLT_OPT_SPLIT_MODE, SPLT_OPTION_TIME_MODE);
+  mp3splt_set_long_option(state, SPLT_OPT_SPLIT_TIME, 730);
+}
+
+static void set_time_split_with_minimum_length(splt_state *state)
+{
+  set_time_split(state);
+  mp3splt_set_long_option(state, SPLT_OPT_TIME_MINIMUM_THEORETICAL_LENGTH, 200);
+}
+
+static void set_splitpoints_with_overlap(splt_state *state)
+{
+  set_splitpoints(state);
+  mp3splt_set_long_option(state, SPLT_OPT_OVERLAP_TIME, 300);
+}
+
+static void set_splitpoints_with_bit_reservoir(splt_state *state)
+{
+  set_splitpoints(state);
+  mp3splt_set_int_option(state, SPLT_OPT_HANDLE_BIT_RESERVOIR, SPLT_TRUE);
+}
+
+static void set_time_split_with_bit_reservoir(splt_state *state)
+{
+  set_time_split(state);
+  mp3splt_set_int_option(state, SPLT_OPT_HANDLE_BIT_RESERVOIR, SPLT_TRUE);
+}
+
+/*! Splits the input file in the output directory
+
+\return The error of the split, SPLT_ERROR_NO_PLUGIN_FOUND when the mp3 plugin is not found
+*/
+static int split(const char *directory_name, int single_read_pass,
+    void (*set_split)(splt_state *state), split_result *result)
+{
+  char output_dir[1024];
+  snprintf(output_dir, sizeof(output_dir), "%s/%s", test_directory, directory_name);
+  cut_assert_equal_int(0, mkdir(output_dir, 0755));
+
+  int error = SPLT_OK;
+  splt_state *state = mp3splt_new_state(&error);
+  cut_assert_equal_int(SPLT_OK, error);
+
+  mp3splt_append_plugins_scan_dir(state, "../plugins/.libs");
+  mp3splt_append_plugins_scan_dir(state, "plugins/.libs");
+  mp3splt_find_plugins(state);
+
+  mp3splt_set_filename_to_split(state, input_fname);
+  mp3splt_set_path_of_split(state, output_dir);
+  mp3splt_set_int_option(state, SPLT_OPT_FRAME_MODE, SPLT_TRUE);
+  mp3splt_set_int_option(state, SPLT_OPT_TAGS, SPLT_NO_TAGS);
+  mp3splt_set_int_option(state, SPLT_OPT_OUTPUT_FILENAMES, SPLT_OUTPUT_FORMAT);
+  mp3splt_set_oformat(state, "@f_@n");
+  mp3splt_set_int_option(state, SPLT_OPT_SINGLE_READ_PASS, single_read_pass);
+  set_split(state);
+
+  if (mp3splt_read_original_tags(state) < 0)
+  {
+    mp3splt_free_state(state);
+    return SPLT_ERROR_NO_PLUGIN_FOUND;
+  }
+
+  error = mp3splt_split(state);
+
+  result->number_of_splitpoints = 0;
+  splt_points *points = mp3splt_get_splitpoints(state, NULL);
+  mp3splt_points_init_iterator(points);
+  const splt_point *point = NULL;
+  while ((point = mp3splt_points_next(points)) &&
+      (result->number_of_splitpoints < MAXIMUM_NUMBER_OF_SPLITPOINTS))
+  {
+    result->values[result->number_of_splitpoints++] = mp3splt_point_get_value(point);
+  }
+
+  mp3splt_free_state(state);
+
+  return error;
+}
+
+static char *read_file(const char *fname, long *size)
+{
+  FILE *file = fopen(fname, "rb");
+  if (file == NULL) { return NULL; }
+
+  fseek(file, 0, SEEK_END);
+  *size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+
+  char *bytes = malloc(*size + 1);
+  if (fread(bytes, 1, *size, file) != (size_t) *size)
+  {
+    *size = -1;
+  }
+
+  fclose(file);
+  return bytes;
+}
+
+//! Compares byte by byte the files of the two directories and returns their number
+static int assert_same_files(const char *first_directory_name,
+    const char *second_directory_name)
+{
+  char first_dir[1024];
+  snprintf(first_dir, sizeof(first_dir), "%s/%s", test_directory, first_directory_name);
+
+  DIR *dir = opendir(first_dir);
+  cut_assert_not_null(dir);
+
+  int files = 0;
+  struct dirent *entry = NULL;
+  while ((entry = readdir(dir)) != NULL)
+  {
+    if (entry->d_name[0] == '.') { continue; }
+
+    char first_fname[2048];
+    snprintf(first_fname, sizeof(first_fname), "%s/%s", first_dir, entry->d_name);
+    char second_fname[2048];
+    snprintf(second_fname, sizeof(second_fname), "%s/%s/%s",
+        test_directory, second_directory_name, entry->d_name);
+
+    long first_size = 0;
+    char *first_bytes = read_file(first_fname, &first_size);
+    long second_size = 0;
+    char *second_bytes = read_file(second_fname, &second_size);
+
+    cut_assert_not_null(second_bytes);
+    if (second_bytes != NULL)
+    {
+      cut_assert_equal_int(first_size, second_size);
+      if (first_size == second_size)
+      {
+        cut_assert_equal_memory(first_bytes, first_size, second_bytes, second_size);
+      }
+      free(second_bytes);
+    }
+    free(first_bytes);
+
+    files++;
+  }
+
+  closedir(dir);
+  return files;
+}
+
+static void assert_same_split(void (*set_split)(splt_state *state), int expected_files)
+{
+  split_result result;
+  int error = split("files_one_after_the_other", SPLT_FALSE, set_split, &result);
+  if (error == SPLT_ERROR_NO_PLUGIN_FOUND)
+  {
+    cut_omit("mp3 plugin not found: single read pass split not tested");
+  }
+  cut_assert_true(error >= 0);
+
+  split_result single_read_pass_result;
+  int single_read_pass_error =
+    split("single_read_pass", SPLT_TRUE, set_split, &single_read_pass_result);
+  cut_assert_equal_int(error, single_read_pass_error);
+
+  cut_assert_equal_int(expected_files,
+      assert_same_files("files_one_after_the_other", "single_read_pass"));
+  cut_assert_equal_int(expected_files,
+      assert_same_files("single_read_pass", "files_one_after_the_other"));
+
+  cut_assert_equal_int(result.number_of_splitpoints,
+      single_read_pass_result.number_of_splitpoints);
+  int i = 0;
+  for (i = 0;i < result.number_of_splitpoints;i++)
+  {
+    cut_assert_equal_int(result.values[i], single_read_pass_result.values[i]);
+  }
+}
+
+void cut_setup()
+{
+  char *tmp = getenv("TMPDIR");
+  snprintf(test_directory, sizeof(test_directory), "%s/libmp3splt_single_read_pass_XXXXXX",
+      tmp ? tmp : "/tmp");
+  cut_assert_not_null(mkdtemp(test_directory));
+
+  snprintf(input_fname, sizeof(input_fname), "%s/input.mp3", test_directory);
+  write_numbered_mp3_file(input_fname);
+}
+
+void cut_teardown()
+{
+  char command[1024];
+  snprintf(command, sizeof(command), "rm -rf '%s'", test_directory);
+  system(command);
+}
+
+void test_time_split_in_a_single_read_pass()
+{
+  assert_same_split(set_time_split, 8);
+}
+
+void test_time_split_with_minimum_length_in_a_single_read_pass()
+{
+  assert_same_split(set_time_split_with_minimum_length, 7);
+}
+
+void test_splitpoints_split_in_a_single_read_pass()
+{
+  assert_same_split(set_splitpoints, 4);
+}
+
+void test_splitpoints_split_with_overlap_in_a_single_read_pass()
+{
+  assert_same_split(set_splitpoints_with_overlap, 4);
+}
+
+void test_splitpoints_split_with_bit_reservoir_in_a_single_read_pass()
+{
+  assert_same_split(set_splitpoints_with_bit_reservoir, 4);
+}
+
+void test_time_split_with_bit_reservoir_in_a_single_read_pass()
+{
+  assert_same_split(set_time_split_with_bit_reservoir, 8);
+}
+
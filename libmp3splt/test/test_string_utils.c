@@ -42,6 +42,52 @@ void test_su_append()
   free(dest);
 }
 
+void test_su_builder_append()
+{
+  splt_string_builder sb;
+  splt_su_builder_init(&sb);
+
+  cut_assert_null(splt_su_builder_release(&sb));
+
+  int i = 0;
+  for (i = 0;i < 1000;i++)
+  {
+    cut_assert_equal_int(SPLT_OK, splt_su_builder_append(&sb, "0123456789", 5));
+  }
+  cut_assert_equal_int(SPLT_OK, splt_su_builder_append_str(&sb, "end"));
+
+  cut_assert_equal_int(5003, sb.length);
+  cut_assert_equal_int(5003, strlen(sb.str));
+  cut_assert_true(sb.size > sb.length);
+  cut_assert_equal_string("01234end", sb.str + 4995);
+
+  char *str = splt_su_builder_release(&sb);
+  cut_assert_null(sb.str);
+  cut_assert_equal_int(0, sb.length);
+  free(str);
+}
+
+void test_su_builder_truncate_and_remove_beginning()
+{
+  splt_string_builder sb;
+  splt_su_builder_init(&sb);
+
+  splt_su_builder_append_str(&sb, "first line\nsecond");
+
+  splt_su_builder_remove_beginning(&sb, strlen("first line\n"));
+  cut_assert_equal_string("second", sb.str);
+  cut_assert_equal_int(6, sb.length);
+
+  splt_su_builder_truncate(&sb, 3);
+  cut_assert_equal_string("sec", sb.str);
+
+  splt_su_builder_remove_beginning(&sb, 10);
+  cut_assert_equal_string("", sb.str);
+  cut_assert_null(splt_su_builder_release(&sb));
+
+  splt_su_builder_free(&sb);
+}
+
 void test_su_set()
 {
   char *first = NULL;
@@ -63,6 +63,13 @@
 #include "radio_helper.h"
 #include "drawing_helper.h"
 #include "douglas_peucker.h"
+#include "wave_pyramid.h"
+#include "wave_queue.h"
+#include "wave_cache.h"
+#include "splitpoints_model.h"
+#include "preview_buffer.h"
+#include "split_jobs.h"
+#include "batch_probe.h"
 #include "drag_and_drop.h"
 #include "mutex.h"
 
@@ -0,0 +1,264 @@
+/**********************************************************
+ *
+ * mp3splt-gtk -- utility based on mp3splt,
+ *                for mp3/ogg splitting without decoding
+ *
+ * Copyright: (C) 2005-2014 Alexandru Munteanu
+ * Contact: m@ioalex.net
+ *
+ * http://mp3splt.sourceforge.net/
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ *********************************************************/
+
+/*!********************************************************
+ * \file 
+ * Background probing of the files of the batch list
+ *
+ * The files added to the batch list are read by a pool of worker
+ * threads, each owning its library state. The length, type, size and
+ * original tags of the files are pushed into a queue which is emptied
+ * in the main loop, a few hundred rows at a time.
+ **********************************************************/
+
+#include "batch_probe.h"
+
+static void free_worker_state(gpointer state)
+{
+  mp3splt_free_state((splt_state *) state);
+}
+
+//! Library state of the current worker thread, freed when the worker exits
+static GPrivate worker_state = G_PRIVATE_INIT(free_worker_state);
+
+static splt_state *get_worker_state()
+{
+  splt_state *state = g_private_get(&worker_state);
+  if (state != NULL)
+  {
+    return state;
+  }
+
+  gint err = SPLT_OK;
+  state = mp3splt_new_state(&err);
+  if (err < 0)
+  {
+    if (state) { mp3splt_free_state(state); }
+    return NULL;
+  }
+
+  //no message function: probing is silent
+  mp3splt_set_int_option(state, SPLT_OPT_DEBUG_MODE, SPLT_FALSE);
+  mp3splt_find_plugins(state);
+
+  g_private_set(&worker_state, state);
+
+  return state;
+}
+
+void batch_probe_result_free(batch_probe_result **result)
+{
+  if (!result || !*result)
+  {
+    return;
+  }
+
+  g_free((*result)->filename);
+  g_free((*result)->type);
+  g_free((*result)->tags);
+  g_free(*result);
+  *result = NULL;
+}
+
+static void append_tag(GString *description, splt_tags *tags, splt_tag_key key)
+{
+  char *value = mp3splt_tags_get(tags, key);
+  if (value == NULL)
+  {
+    return;
+  }
+
+  if (value[0] != '\0' && g_utf8_validate(value, -1, NULL))
+  {
+    if (description->len > 0)
+    {
+      g_string_append(description, " - ");
+    }
+    g_string_append(description, value);
+  }
+
+  free(value);
+}
+
+//! Returns "artist - album - title" from the original tags, or NULL if none
+static gchar *get_tags_description(splt_state *state)
+{
+  splt_tags *tags = mp3splt_get_original_tags(state, NULL);
+  if (tags == NULL)
+  {
+    return NULL;
+  }
+
+  GString *description = g_string_new("");
+  append_tag(description, tags, SPLT_TAGS_ARTIST);
+  append_tag(description, tags, SPLT_TAGS_ALBUM);
+  append_tag(description, tags, SPLT_TAGS_TITLE);
+
+  if (description->len == 0)
+  {
+    g_string_free(description, TRUE);
+    return NULL;
+  }
+
+  return g_string_free(description, FALSE);
+}
+
+static void read_file_informations(batch_probe_result *result)
+{
+  struct stat buffer;
+  if (g_stat(result->filename, &buffer) == 0)
+  {
+    result->size = (gint64) buffer.st_size;
+  }
+
+  splt_state *state = get_worker_state();
+  if (state == NULL)
+  {
+    return;
+  }
+
+  mp3splt_set_filename_to_split(state, result->filename);
+  if (mp3splt_read_original_tags(state) < 0)
+  {
+    return;
+  }
+
+  result->total_time = mp3splt_get_total_time(state);
+  result->type = g_strdup(mp3splt_get_plugin_name(state));
+  result->tags = get_tags_description(state);
+}
+
+static gboolean batch_probe_results_idle(ui_state *ui)
+{
+  g_atomic_int_set(&ui->batch_probe_idle_scheduled, FALSE);
+
+  if (ui->batch_probe_results == NULL)
+  {
+    return FALSE;
+  }
+
+  gint i = 0;
+  for (i = 0;i < BATCH_PROBE_RESULTS_PER_IDLE;i++)
+  {
+    batch_probe_result *result = g_async_queue_try_pop(ui->batch_probe_results);
+    if (result == NULL)
+    {
+      return FALSE;
+    }
+
+    multiple_files_set_probe_result(result, ui);
+    batch_probe_result_free(&result);
+  }
+
+  if (g_async_queue_length(ui->batch_probe_results) > 0 &&
+      g_atomic_int_compare_and_exchange(&ui->batch_probe_idle_scheduled, FALSE, TRUE))
+  {
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+static void probe_file(gchar *filename, ui_state *ui)
+{
+  if (g_atomic_int_get(&ui->batch_probe_cancelled))
+  {
+    g_free(filename);
+    return;
+  }
+
+  batch_probe_result *result = g_malloc0(sizeof(batch_probe_result));
+  result->filename = filename;
+  result->total_time = -1;
+  result->size = -1;
+
+  read_file_informations(result);
+
+  g_async_queue_push(ui->batch_probe_results, result);
+
+  if (g_atomic_int_compare_and_exchange(&ui->batch_probe_idle_scheduled, FALSE, TRUE))
+  {
+    add_idle(G_PRIORITY_DEFAULT_IDLE, (GSourceFunc)batch_probe_results_idle, ui, NULL);
+  }
+}
+
+/*! Reads the informations of the \p filenames in the background
+
+The filenames are freed by the workers; the array is freed.
+*/
+void batch_probe_files(GPtrArray *filenames, ui_state *ui)
+{
+  if (ui->batch_probe_pool == NULL)
+  {
+    g_atomic_int_set(&ui->batch_probe_cancelled, FALSE);
+    g_atomic_int_set(&ui->batch_probe_idle_scheduled, FALSE);
+    ui->batch_probe_results = g_async_queue_new();
+    ui->batch_probe_pool =
+      g_thread_pool_new((GFunc)probe_file, ui, BATCH_PROBE_MAX_THREADS, FALSE, NULL);
+  }
+
+  gint i = 0;
+  for (i = 0;i < filenames->len;i++)
+  {
+    gchar *filename = g_ptr_array_index(filenames, i);
+    if (ui->batch_probe_pool == NULL)
+    {
+      g_free(filename);
+      continue;
+    }
+
+    g_thread_pool_push(ui->batch_probe_pool, filename, NULL);
+  }
+
+  g_ptr_array_free(filenames, TRUE);
+}
+
+//! Skips the remaining probes and waits for the running ones
+void batch_probe_stop(ui_state *ui)
+{
+  if (ui->batch_probe_pool == NULL)
+  {
+    return;
+  }
+
+  g_atomic_int_set(&ui->batch_probe_cancelled, TRUE);
+  g_thread_pool_free(ui->batch_probe_pool, FALSE, TRUE);
+  ui->batch_probe_pool = NULL;
+
+  batch_probe_result *result = NULL;
+  while ((result = g_async_queue_try_pop(ui->batch_probe_results)) != NULL)
+  {
+    batch_probe_result_free(&result);
+  }
+  g_async_queue_unref(ui->batch_probe_results);
+  ui->batch_probe_results = NULL;
+}
+
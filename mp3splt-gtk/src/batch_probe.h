@@ -0,0 +1,48 @@
+/**********************************************************
+ *
+ * mp3splt-gtk -- utility based on mp3splt,
+ *                for mp3/ogg splitting without decoding
+ *
+ * Copyright: (C) 2005-2014 Alexandru Munteanu
+ * Contact: m@ioalex.net
+ *
+ * http://mp3splt.sourceforge.net/
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ *********************************************************/
+
+#ifndef BATCH_PROBE_H
+
+#define BATCH_PROBE_H
+
+#include "all_includes.h"
+
+#define BATCH_PROBE_MAX_THREADS 4
+//! Maximum number of probed files shown in the batch list by one idle call
+#define BATCH_PROBE_RESULTS_PER_IDLE 200
+
+void batch_probe_files(GPtrArray *filenames, ui_state *ui);
+void batch_probe_stop(ui_state *ui);
+
+void batch_probe_result_free(batch_probe_result **result);
+
+#endif
+
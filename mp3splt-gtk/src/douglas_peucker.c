@@ -39,231 +39,160 @@
 #include "douglas_peucker.h"
 #include "utilities.h"
 
-static GArray *splt_copy_as_new_array(GArray *array);
-static GArray *splt_merge_arrays_with_bounds(GArray *first, gint first_end_bound, 
-    GArray *second, gint second_end_bound);
-static GArray *splt_recursive_douglas_peucker(GArray *douglas_points, 
-    void (*callback)(ui_state *ui), ui_state *ui, gdouble threshold_to_discard_point);
-static GArray *splt_split_as_new_array(GArray *array, gint start_index, gint end_index);
-static GArray *build_input_douglas_points(GArray *gdk_points);
-static GArray *build_presence_array(GArray *output_douglas_points, guint length);
-static GArray *splt_douglas_peucker_for_one_threshold(GArray *input_douglas_points, 
-    void (*callback)(ui_state *ui), ui_state *ui, gdouble threshold_to_discard_point);
-
-//returns an array of arrays of ints
-//for each threshold, an [arrays of int] set to 1 if the point has been chosen, 0 otherwise
-GPtrArray *splt_douglas_peucker(GArray *gdk_points, void (*callback)(ui_state *ui), ui_state *ui,
-    gdouble threshold_to_discard_points, ...)
+typedef struct {
+  gint first_index;
+  gint last_index;
+  guint8 presence_mask;
+} douglas_segment;
+
+static guint8 threshold_mask_for_distance(gdouble distance, gdouble *thresholds,
+    gint number_of_thresholds);
+
+/*! Simplifies the wave for all the thresholds at once
+
+The segments are split at the same points whatever the threshold is: a point
+is kept for a threshold if its distance and the distances of all the points
+splitting the segments containing it are greater or equal than the threshold.
+Each point thus stores in one byte the set of thresholds it survives, computed
+from an explicit stack of segments over the input array.
+
+\return one byte per point; bit N is set if the point is kept with the Nth threshold
+*/
+GByteArray *splt_douglas_peucker(GArray *gdk_points, gdouble threshold_to_discard_points, ...)
 {
-  GArray *input_douglas_points = build_input_douglas_points(gdk_points);
-  guint length = input_douglas_points->len;
-
-  GPtrArray *presence_points_by_threshold = g_ptr_array_new();
+  gdouble thresholds[SPLT_DOUGLAS_PEUCKER_MAXIMUM_THRESHOLDS];
+  gint number_of_thresholds = 0;
 
   va_list ap;
   va_start(ap, threshold_to_discard_points);
-  while (threshold_to_discard_points > 0)
+  while (threshold_to_discard_points > 0 &&
+      number_of_thresholds < SPLT_DOUGLAS_PEUCKER_MAXIMUM_THRESHOLDS)
   {
-    GArray *output_douglas_points =
-      splt_douglas_peucker_for_one_threshold(input_douglas_points, callback, ui,
-          threshold_to_discard_points);
-
-    GArray *presence_array = build_presence_array(output_douglas_points, length);
-    g_array_free(output_douglas_points, TRUE);
-
-    g_ptr_array_add(presence_points_by_threshold, (gpointer) presence_array);
+    thresholds[number_of_thresholds] = threshold_to_discard_points;
+    number_of_thresholds++;
 
     threshold_to_discard_points = va_arg(ap, gdouble);
   }
   va_end(ap);
 
-  g_array_free(input_douglas_points, TRUE);
-
-  return presence_points_by_threshold;
-}
-
-void splt_douglas_peucker_free(GPtrArray *douglas_peucker_ptr_array)
-{
-  if (douglas_peucker_ptr_array == NULL)
-  {
-    return;
-  }
+  guint length = gdk_points->len;
+  guint8 all_thresholds_mask = (guint8) ((1 << number_of_thresholds) - 1);
 
-  gint i = 0;
-  for (i = 0;i < douglas_peucker_ptr_array->len; i++)
+  GByteArray *presence = g_byte_array_sized_new(length);
+  g_byte_array_set_size(presence, length);
+  if (length == 0)
   {
-    g_array_free(g_ptr_array_index(douglas_peucker_ptr_array, i), TRUE);
+    return presence;
   }
 
-  g_ptr_array_free(douglas_peucker_ptr_array, TRUE);
-}
-
-static GArray *splt_douglas_peucker_for_one_threshold(GArray *input_douglas_points, 
-    void (*callback)(ui_state *ui), ui_state *ui, gdouble threshold_to_discard_point)
-{
-  GArray *output_douglas_points =
-    splt_recursive_douglas_peucker(splt_copy_as_new_array(input_douglas_points), callback, ui,
-        threshold_to_discard_point);
-
-  return output_douglas_points;
-}
-
-static gint douglas_points_sort(gconstpointer first, gconstpointer second)
-{
-  const douglas_point *first_douglas_point = (douglas_point *)first;
-  const douglas_point *second_douglas_point = (douglas_point *)second;
-
-  return first_douglas_point->index - second_douglas_point->index;
-}
-
-static GArray *build_presence_array(GArray *output_douglas_points, guint length)
-{
-  g_array_sort(output_douglas_points, douglas_points_sort);
+  memset(presence->data, 0, length);
+  presence->data[0] = all_thresholds_mask;
+  presence->data[length - 1] = all_thresholds_mask;
 
-  GArray *presence_array = g_array_new(TRUE, TRUE, sizeof(gint));
+  GArray *segments = g_array_new(FALSE, FALSE, sizeof(douglas_segment));
 
-  gint current_point_index = -1;
-  gint output_douglas_points_index = 0;
+  douglas_segment whole_wave = { 0, length - 1, all_thresholds_mask };
+  g_array_append_val(segments, whole_wave);
 
-  if (output_douglas_points->len > 0)
+  while (segments->len > 0)
   {
-    douglas_point current_point =
-      g_array_index(output_douglas_points, douglas_point, output_douglas_points_index);
-    current_point_index = current_point.index;
-  }
+    douglas_segment segment = g_array_index(segments, douglas_segment, segments->len - 1);
+    g_array_set_size(segments, segments->len - 1);
 
-  gint false_value = 0;
-  gint true_value = 1;
-
-  gint i = 0;
-  for (i = 0;i < length; i++)
-  {
-    if (current_point_index == i)
+    if (segment.last_index - segment.first_index < 2)
     {
-      output_douglas_points_index++;
-      douglas_point point =
-        g_array_index(output_douglas_points, douglas_point, output_douglas_points_index);
-      current_point_index = point.index;
-      g_array_append_val(presence_array, true_value);
       continue;
     }
 
-    g_array_append_val(presence_array, false_value);
-  }
+    distance_and_index max_distance_point =
+      splt_find_point_with_maximum_distance(gdk_points, segment.first_index, segment.last_index);
 
-  return presence_array;
-}
-
-static GArray *build_input_douglas_points(GArray *gdk_points)
-{
-  GArray *input_douglas_points = g_array_new(TRUE, TRUE, sizeof(douglas_point));
+    //points on a straight line are all kept
+    if (double_equals(max_distance_point.distance, 0))
+    {
+      memset(presence->data + segment.first_index + 1, segment.presence_mask,
+          segment.last_index - segment.first_index - 1);
+      continue;
+    }
 
-  gint i = 0;
-  for (i = 0; i < gdk_points->len; i++)
-  {
-    GdkPoint point = g_array_index(gdk_points, GdkPoint, i);
+    guint8 presence_mask = segment.presence_mask &
+      threshold_mask_for_distance(max_distance_point.distance, thresholds, number_of_thresholds);
+    if (presence_mask == 0)
+    {
+      continue;
+    }
 
-    douglas_point douglas;
-    douglas.point = point;
-    douglas.index = i;
+    presence->data[max_distance_point.index] = presence_mask;
 
-    g_array_append_val(input_douglas_points, douglas);
+    douglas_segment first_half = { segment.first_index, max_distance_point.index, presence_mask };
+    douglas_segment second_half = { max_distance_point.index, segment.last_index, presence_mask };
+    g_array_append_val(segments, second_half);
+    g_array_append_val(segments, first_half);
   }
 
-  return input_douglas_points;
+  g_array_free(segments, TRUE);
+
+  return presence;
 }
 
-static GArray *splt_recursive_douglas_peucker(GArray *douglas_points, void (*callback)(ui_state *ui), 
-    ui_state *ui, gdouble threshold_to_discard_point)
+void splt_douglas_peucker_free(GByteArray *douglas_peucker_presence)
 {
-  GArray *new_points = NULL;
-
-  if (douglas_points->len <= 2)
+  if (douglas_peucker_presence == NULL)
   {
-    new_points = splt_copy_as_new_array(douglas_points);
-    g_array_free(douglas_points, TRUE);
-    return new_points;
-  }
-
-  if (callback != NULL)
-  {
-    callback(ui);
+    return;
   }
 
-  douglas_point first_point = g_array_index(douglas_points, douglas_point, 0);
-  douglas_point last_point = g_array_index(douglas_points, douglas_point, douglas_points->len - 1);
-
-  distance_and_index *max_distance_point =
-    splt_find_point_with_maximum_distance(douglas_points, first_point.point, last_point.point);
-
-  if (max_distance_point == NULL || double_equals(max_distance_point->distance, 0))
-  {
-    new_points = splt_copy_as_new_array(douglas_points);
-    g_array_free(douglas_points, TRUE);
+  g_byte_array_free(douglas_peucker_presence, TRUE);
+}
 
-    if (max_distance_point != NULL) { g_free(max_distance_point); }
+gboolean splt_douglas_peucker_point_is_present(GByteArray *douglas_peucker_presence,
+    gint index, gint threshold_index)
+{
+  return (douglas_peucker_presence->data[index] & (1 << threshold_index)) != 0;
+}
 
-    return new_points;
-  }
+static guint8 threshold_mask_for_distance(gdouble distance, gdouble *thresholds,
+    gint number_of_thresholds)
+{
+  guint8 mask = 0;
 
-  if (max_distance_point->distance >= threshold_to_discard_point)
-  {
-    GArray *first_half_points = 
-      splt_split_as_new_array(douglas_points, 0, max_distance_point->index);
-    GArray *first_half_filtered_points = 
-      splt_recursive_douglas_peucker(first_half_points, callback, ui, threshold_to_discard_point);
-
-    GArray *second_half_points =
-      splt_split_as_new_array(douglas_points, max_distance_point->index, douglas_points->len - 1);
-    GArray *second_half_filtered_points = 
-      splt_recursive_douglas_peucker(second_half_points, callback, ui, threshold_to_discard_point);
-
-    new_points = 
-      splt_merge_arrays_with_bounds(first_half_filtered_points, first_half_filtered_points->len - 2,
-          second_half_filtered_points, second_half_filtered_points->len - 1);
-
-    g_array_free(first_half_filtered_points, TRUE);
-    g_array_free(second_half_filtered_points, TRUE);
-  }
-  else
+  gint i = 0;
+  for (i = 0;i < number_of_thresholds;i++)
   {
-    new_points = g_array_new(TRUE, TRUE, sizeof(douglas_point));
-    g_array_append_val(new_points, first_point);
-    g_array_append_val(new_points, last_point);
+    if (distance >= thresholds[i])
+    {
+      mask |= (1 << i);
+    }
   }
 
-  g_free(max_distance_point);
-  g_array_free(douglas_points, TRUE);
-
-  return new_points;
+  return mask;
 }
 
-distance_and_index *splt_find_point_with_maximum_distance(GArray *douglas_points,
-    GdkPoint first_point, GdkPoint last_point)
+//!returns the point between first_index and last_index furthest from their segment
+distance_and_index splt_find_point_with_maximum_distance(GArray *gdk_points,
+    gint first_index, gint last_index)
 {
-  distance_and_index *max_distance_point = malloc(sizeof(*max_distance_point));
-  if (max_distance_point == NULL)
-  {
-    return NULL;
-  }
+  distance_and_index max_distance_point;
+  max_distance_point.index = first_index;
+  max_distance_point.distance = 0;
 
-  max_distance_point->index = 0;
-  max_distance_point->distance = 0;
+  GdkPoint first_point = g_array_index(gdk_points, GdkPoint, first_index);
+  GdkPoint last_point = g_array_index(gdk_points, GdkPoint, last_index);
 
   gint i = 0;
-  for (i = 1; i < douglas_points->len - 1; i++)
+  for (i = first_index + 1; i < last_index; i++)
   {
-    douglas_point point = g_array_index(douglas_points, douglas_point, i);
+    GdkPoint point = g_array_index(gdk_points, GdkPoint, i);
 
     gdouble perpendicular_distance =
-      splt_find_perpendicular_distance(point.point, first_point, last_point);
-    if (perpendicular_distance <= max_distance_point->distance)
+      splt_find_perpendicular_distance(point, first_point, last_point);
+    if (perpendicular_distance <= max_distance_point.distance)
     {
       continue;
     }
 
-    max_distance_point->index = i;
-    max_distance_point->distance = perpendicular_distance;
+    max_distance_point.index = i;
+    max_distance_point.distance = perpendicular_distance;
   }
 
   return max_distance_point;
@@ -291,41 +220,3 @@ gdouble splt_find_perpendicular_distance(GdkPoint point,
 
   return perpendicular_distance;
 }
-
-static void splt_append_array_with_bounds(GArray *source, GArray *target,
-    gint start_index, gint end_index)
-{
-  gint i = 0;
-  for (i = start_index;i <= end_index;i++)
-  {
-    douglas_point point = g_array_index(source, douglas_point, i);
-    g_array_append_val(target, point);
-  }
-}
-
-static GArray *splt_split_as_new_array(GArray *array, gint start_index, gint end_index)
-{
-  GArray *new_array = g_array_new(TRUE, TRUE, g_array_get_element_size(array));
-  splt_append_array_with_bounds(array, new_array, start_index, end_index); 
-  return new_array;
-}
-
-static void splt_append_array(GArray *source, GArray *target)
-{
-  splt_append_array_with_bounds(source, target, 0, source->len - 1);
-}
-
-static GArray *splt_copy_as_new_array(GArray *array) {
-  GArray *new_array = g_array_new(TRUE, TRUE, g_array_get_element_size(array));
-  splt_append_array(array, new_array);
-  return new_array;
-}
-
-static GArray *splt_merge_arrays_with_bounds(GArray *first, gint first_end_bound, 
-    GArray *second, gint second_end_bound)
-{
-  GArray *new_array = splt_split_as_new_array(first, 0, first_end_bound);
-  splt_append_array_with_bounds(second, new_array, 0, second_end_bound);
-  return new_array;
-}
-
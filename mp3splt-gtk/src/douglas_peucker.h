@@ -39,21 +39,20 @@ typedef struct {
   gint index;
 } distance_and_index;
 
-typedef struct {
-  GdkPoint point;
-  gint index;
-} douglas_point;
+//!the presence of a point for each threshold is stored in one byte
+#define SPLT_DOUGLAS_PEUCKER_MAXIMUM_THRESHOLDS 8
 
-GPtrArray *splt_douglas_peucker(GArray *gdk_points, void (*callback)(ui_state *ui),
-    ui_state *ui, gdouble threshold_to_discard_points, ...);
-void splt_douglas_peucker_free(GPtrArray *douglas_peucker_ptr_array);
+GByteArray *splt_douglas_peucker(GArray *gdk_points, gdouble threshold_to_discard_points, ...);
+void splt_douglas_peucker_free(GByteArray *douglas_peucker_presence);
+gboolean splt_douglas_peucker_point_is_present(GByteArray *douglas_peucker_presence,
+    gint index, gint threshold_index);
 
 //for unit tests
 gdouble splt_find_distance(GdkPoint first, GdkPoint second);
 gdouble splt_find_perpendicular_distance(GdkPoint point,
     GdkPoint segment_begin_point, GdkPoint segment_end_point);
-distance_and_index *splt_find_point_with_maximum_distance(GArray *douglas_points,
-    GdkPoint first_point, GdkPoint last_point);
+distance_and_index splt_find_point_with_maximum_distance(GArray *gdk_points,
+    gint first_index, gint last_index);
 
 #endif
 
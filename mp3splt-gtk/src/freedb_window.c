@@ -302,6 +302,12 @@ static void update_tags_from_mp3splt_state(gint number_of_rows, ui_state *ui)
 
   GtkTreeModel *model = gtk_tree_view_get_model(ui->gui->tree_view);
 
+  GtkTreeIter iter;
+  if (!gtk_tree_model_get_iter_first(model, &iter))
+  {
+    return;
+  }
+
   splt_tags *tags = NULL;
   gint current_row = 0;
   while ((tags = mp3splt_tags_group_next(tags_group)))
@@ -311,11 +317,6 @@ static void update_tags_from_mp3splt_state(gint number_of_rows, ui_state *ui)
       break;
     }
 
-    GtkTreePath *path = gtk_tree_path_new_from_indices(current_row, -1);
-    GtkTreeIter iter;
-    gtk_tree_model_get_iter(model, &iter, path);
-    gtk_tree_path_free(path);
-
     char *utf8_str;
     char *year_str = mp3splt_tags_get(tags, SPLT_TAGS_YEAR);
     if (year_str != NULL)
@@ -384,6 +385,11 @@ static void update_tags_from_mp3splt_state(gint number_of_rows, ui_state *ui)
     }
 
     current_row++;
+
+    if (!gtk_tree_model_iter_next(model, &iter))
+    {
+      break;
+    }
   }
 }
 
@@ -401,6 +407,7 @@ void update_splitpoints_from_mp3splt_state(ui_state *ui)
   if (points == NULL) { return; }
 
   ui->status->lock_cue_export = SPLT_TRUE;
+  begin_splitpoints_batch_update(ui);
 
   remove_all_rows(ui->gui->remove_all_button, ui);
 
@@ -451,6 +458,8 @@ void update_splitpoints_from_mp3splt_state(ui_state *ui)
     number_of_rows++;
   }
 
+  end_splitpoints_batch_update(ui);
+
   update_tags_from_mp3splt_state(number_of_rows, ui);
 
   g_snprintf(ui->status->current_description, 255, "%s", _("description here"));
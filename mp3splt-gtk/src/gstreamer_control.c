@@ -162,6 +162,16 @@ static gboolean bus_call(GstBus *bus, GstMessage *msg, gpointer data)
  
       break;
     }
+    case GST_MESSAGE_STATE_CHANGED:
+      //the player timer polls slowly while nothing is playing
+      if (GST_MESSAGE_SRC(msg) == GST_OBJECT(ui->pi->play))
+      {
+        wake_up_player_timer(ui);
+      }
+      break;
+    case GST_MESSAGE_EOS:
+      wake_up_player_timer(ui);
+      break;
     default:
       break;
   }
@@ -316,6 +326,111 @@ gchar *gstreamer_get_title_song(ui_state *ui)
   }
 }
 
+/*! Pushes the next bytes of the split preview into the appsrc
+
+Called from the streaming thread of the appsrc, which waits here until the
+splitting thread has produced the bytes.
+*/
+static void feed_preview_source(GstElement *source, guint length, preview_buffer *buffer)
+{
+  if (length == 0 || length == (guint) -1)
+  {
+    length = PREVIEW_SOURCE_BLOCK_SIZE;
+  }
+
+  GstFlowReturn flow_return;
+
+  GstBuffer *gst_buffer = gst_buffer_new_allocate(NULL, length, NULL);
+  GstMapInfo map;
+  gst_buffer_map(gst_buffer, &map, GST_MAP_WRITE);
+  gsize read = splt_preview_buffer_read(buffer, map.data, map.size);
+  gst_buffer_unmap(gst_buffer, &map);
+
+  if (read == 0)
+  {
+    gst_buffer_unref(gst_buffer);
+    g_signal_emit_by_name(source, "end-of-stream", &flow_return);
+    return;
+  }
+
+  gst_buffer_set_size(gst_buffer, read);
+  g_signal_emit_by_name(source, "push-buffer", gst_buffer, &flow_return);
+  gst_buffer_unref(gst_buffer);
+}
+
+//! Connects the appsrc created by playbin for the appsrc:// uri to the preview
+static void setup_preview_source(GstElement *play, GstElement *source, ui_state *ui)
+{
+  preview_buffer *buffer = ui->pi->preview;
+  if (buffer == NULL ||
+      g_object_class_find_property(G_OBJECT_GET_CLASS(source), "stream-type") == NULL)
+  {
+    return;
+  }
+
+  //0 is GST_APP_STREAM_TYPE_STREAM: the preview cannot be seeked
+  g_object_set(source, "stream-type", 0, "format", GST_FORMAT_BYTES, NULL);
+
+  g_signal_connect_data(source, "need-data", G_CALLBACK(feed_preview_source),
+      splt_preview_buffer_ref(buffer), (GClosureNotify) splt_preview_buffer_unref, 0);
+}
+
+/*! Stops playing the split preview and goes back to the input file
+
+The splitting thread writing the preview is woken up and stops.
+*/
+static void drop_preview(ui_state *ui)
+{
+  player_infos *pi = ui->pi;
+  if (pi->preview == NULL)
+  {
+    return;
+  }
+
+  splt_preview_buffer_cancel(pi->preview);
+  splt_preview_buffer_unref(pi->preview);
+  pi->preview = NULL;
+
+  gst_element_set_state(pi->play, GST_STATE_NULL);
+
+  const gchar *fname = get_input_filename(ui->gui);
+  if (fname != NULL)
+  {
+    gchar *uri = g_filename_to_uri(fname, NULL, NULL);
+    g_object_set(G_OBJECT(pi->play), "uri", uri, NULL);
+    if (uri) { g_free(uri); }
+  }
+}
+
+/*! Plays the split preview while it is being split in memory
+
+\param buffer The bytes of the preview, written by the splitting thread
+\param start_time Start of the preview in the input file, in hundreths of
+seconds; the elapsed time is given relative to the input file while the
+preview is playing
+*/
+void gstreamer_play_preview(preview_buffer *buffer, gint start_time, ui_state *ui)
+{
+  player_infos *pi = ui->pi;
+  if (!pi->play)
+  {
+    splt_preview_buffer_cancel(buffer);
+    return;
+  }
+
+  gint total_time = pi->preview ? pi->total_time_before_preview : gstreamer_get_total_time(ui);
+  drop_preview(ui);
+
+  gst_element_set_state(pi->play, GST_STATE_NULL);
+
+  pi->preview = splt_preview_buffer_ref(buffer);
+  pi->preview_start_time = start_time;
+  pi->total_time_before_preview = total_time;
+
+  g_object_set(G_OBJECT(pi->play), "uri", "appsrc://", NULL);
+  gst_element_set_state(pi->play, GST_STATE_PLAYING);
+}
+
 //!returns elapsed time
 gint gstreamer_get_time_elapsed(ui_state *ui)
 {
@@ -334,6 +449,11 @@ gint gstreamer_get_time_elapsed(ui_state *ui)
 
   gst_query_unref(query);
 
+  if (ui->pi->preview)
+  {
+    return (gint) (time / GST_MSECOND) + ui->pi->preview_start_time * 10;
+  }
+
   return (gint) (time / GST_MSECOND);
 }
 
@@ -362,6 +482,8 @@ void gstreamer_start(ui_state *ui)
   gst_bus_add_watch(ui->pi->bus, bus_call, ui);
   gst_object_unref(ui->pi->bus);
 
+  g_signal_connect(ui->pi->play, "source-setup", G_CALLBACK(setup_preview_source), ui);
+
   //add the current filename
   const gchar *fname =  get_input_filename(ui->gui);
   GList *song_list = g_list_append(NULL, strdup(fname));
@@ -397,6 +519,7 @@ void gstreamer_add_files(GList *list, ui_state *ui)
 
   GstState state;
   gst_element_get_state(ui->pi->play, &state, NULL, GST_CLOCK_TIME_NONE);
+  drop_preview(ui);
   gst_element_set_state(ui->pi->play, GST_STATE_NULL);
 
   gint i = 0;
@@ -513,6 +636,7 @@ void gstreamer_stop(ui_state *ui)
     return;
   }
 
+  drop_preview(ui);
   gst_element_set_state(ui->pi->play, GST_STATE_NULL);
 }
 
@@ -560,6 +684,14 @@ void gstreamer_jump(gint position, ui_state *ui)
     return;
   }
 
+  //the preview is a stream: seek in the input file instead
+  if (ui->pi->preview)
+  {
+    drop_preview(ui);
+    gst_element_set_state(ui->pi->play, GST_STATE_PLAYING);
+    gst_element_get_state(ui->pi->play, NULL, NULL, GST_CLOCK_TIME_NONE);
+  }
+
   gst_element_seek(ui->pi->play,
       1.0, GST_FORMAT_TIME, GST_SEEK_FLAG_FLUSH,
       GST_SEEK_TYPE_SET, position * GST_MSECOND, 0, 0);
@@ -573,6 +705,11 @@ gint gstreamer_get_total_time(ui_state *ui)
     return 0;
   }
 
+  if (ui->pi->preview)
+  {
+    return ui->pi->total_time_before_preview;
+  }
+
   GstQuery *query = gst_query_new_duration(GST_FORMAT_TIME);
   gint time = 0;
 
@@ -611,6 +748,7 @@ void gstreamer_quit(ui_state *ui)
 {
   if (ui->pi->play)
   {
+    drop_preview(ui);
     gst_element_set_state(ui->pi->play, GST_STATE_NULL);
   }
 
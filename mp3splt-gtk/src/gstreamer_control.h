@@ -43,6 +43,8 @@
 
 #include "all_includes.h"
 
+#define PREVIEW_SOURCE_BLOCK_SIZE 4096
+
 void gstreamer_get_song_infos(gchar *total_infos, ui_state *ui);
 gchar *gstreamer_get_filename(ui_state *ui);
 gint gstreamer_get_playlist_number(ui_state *ui);
@@ -66,6 +68,7 @@ void gstreamer_jump(gint position, ui_state *ui);
 gint gstreamer_get_total_time(ui_state *ui);
 gint gstreamer_is_playing(ui_state *ui);
 void gstreamer_quit(ui_state *ui);
+void gstreamer_play_preview(preview_buffer *buffer, gint start_time, ui_state *ui);
 
 #endif
 
@@ -177,6 +177,10 @@ static gboolean import_files_to_batch(ui_with_fnames *ui_wf)
   ui_state *ui = ui_wf->ui;
   char **splt_filenames = ui_wf->filenames;
 
+  GPtrArray *added_filenames =
+    multiple_files_add_filenames(splt_filenames, ui_wf->num_of_filenames, ui);
+  batch_probe_files(added_filenames, ui);
+
   gint i = 0;
   for (i = 0;i < ui_wf->num_of_filenames;i++)
   {
@@ -185,8 +189,6 @@ static gboolean import_files_to_batch(ui_with_fnames *ui_wf)
       continue;
     }
 
-    multiple_files_add_filename(splt_filenames[i], ui);
-
     free(splt_filenames[i]);
     splt_filenames[i] = NULL;
   }
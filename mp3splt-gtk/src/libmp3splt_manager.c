@@ -37,14 +37,8 @@ static void lmanager_put_message_from_library(const char *message, splt_message_
 void lmanager_init_and_find_plugins(ui_state *ui)
 {
   mp3splt_set_progress_function(ui->mp3splt_state, lmanager_change_window_progress_bar, ui);
-  mp3splt_set_split_filename_function(ui->mp3splt_state, lmanager_put_split_filename, ui);
-  mp3splt_set_message_function(ui->mp3splt_state, lmanager_put_message_from_library, ui);
 
-  mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_DEBUG_MODE, SPLT_FALSE);
-  mp3splt_set_int_option(ui->mp3splt_state,
-      SPLT_OPT_SET_FILE_FROM_CUE_IF_FILE_TAG_FOUND, SPLT_TRUE);
-
-  gint error = mp3splt_find_plugins(ui->mp3splt_state);
+  gint error = lmanager_init_state(ui->mp3splt_state, ui);
   if (error < 0)
   {
     char *error_from_library = mp3splt_get_strerror(ui->mp3splt_state, error);
@@ -53,8 +47,25 @@ void lmanager_init_and_find_plugins(ui_state *ui)
   }
 }
 
+/*! Sets the callbacks and options shared by all the library states and finds the plugins
+
+Used for the main state and for the states of the batch split workers.
+*/
+gint lmanager_init_state(splt_state *state, ui_state *ui)
+{
+  mp3splt_set_split_filename_function(state, lmanager_put_split_filename, ui);
+  mp3splt_set_message_function(state, lmanager_put_message_from_library, ui);
+
+  mp3splt_set_int_option(state, SPLT_OPT_DEBUG_MODE, SPLT_FALSE);
+  mp3splt_set_int_option(state, SPLT_OPT_SET_FILE_FROM_CUE_IF_FILE_TAG_FOUND, SPLT_TRUE);
+
+  return mp3splt_find_plugins(state);
+}
+
 void lmanager_stop_split(ui_state *ui)
 {
+  split_jobs_cancel_all(ui);
+
   gint err = mp3splt_stop_split(ui->mp3splt_state);
   print_status_bar_confirmation(err, ui);
 }
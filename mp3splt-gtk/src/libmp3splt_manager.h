@@ -36,6 +36,7 @@
 #include "all_includes.h"
 
 void lmanager_init_and_find_plugins(ui_state *ui);
+gint lmanager_init_state(splt_state *state, ui_state *ui);
 void lmanager_put_split_filename(const char *filename, void *data);
 void lmanager_stop_split(ui_state *ui);
 
@@ -60,6 +60,16 @@ void split_action(ui_state *ui)
   gtk_widget_set_sensitive(ui->gui->cancel_button, TRUE);
   remove_all_split_rows(ui);
 
+  remove_all_split_job_rows(ui);
+  if (get_split_file_mode(ui) == FILE_MODE_MULTIPLE)
+  {
+    gint i = 0;
+    for (i = 0;i < ui->files_to_split->len;i++)
+    {
+      add_split_job_row(g_ptr_array_index(ui->files_to_split, i), ui);
+    }
+  }
+
   ui_for_split *ui_fs = build_ui_for_split(ui);
   ui_fs->pat = get_splitpoints_and_tags_for_mp3splt_state(ui);
 
@@ -138,14 +148,6 @@ static gboolean split_collected_files_end(ui_with_err *ui_err)
   return FALSE;
 }
 
-static gint get_stop_split_safe(ui_state *ui)
-{
-  lock_mutex(&ui->variables_mutex);
-  gint stop_split = ui->status->stop_split;
-  unlock_mutex(&ui->variables_mutex);
-  return stop_split;
-}
-
 //! Split the file
 static gpointer split_collected_files(ui_for_split *ui_fs)
 {
@@ -153,121 +155,29 @@ static gpointer split_collected_files(ui_for_split *ui_fs)
 
   set_process_in_progress_and_wait_safe(TRUE, ui);
 
-  put_options_from_preferences(ui_fs);
-
-  mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_OUTPUT_FILENAMES, SPLT_OUTPUT_DEFAULT);
-  if (!ui_fs->is_checked_output_radio_box)
-  {
-    mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_OUTPUT_FILENAMES, SPLT_OUTPUT_FORMAT);
-  }
-
-  mp3splt_set_path_of_split(ui->mp3splt_state, ui_fs->output_directory);
-
-  gint err = mp3splt_erase_all_splitpoints(ui->mp3splt_state);
-  err = mp3splt_erase_all_tags(ui->mp3splt_state);
-
-  gint split_mode = mp3splt_get_int_option(ui->mp3splt_state, SPLT_OPT_SPLIT_MODE, &err);
-  print_status_bar_confirmation_in_idle(err, ui);
-
-  err = mp3splt_set_oformat(ui->mp3splt_state, ui_fs->output_format);
-
-  if (mp3splt_get_int_option(ui->mp3splt_state, SPLT_OPT_SPLIT_MODE, &err) == SPLT_OPTION_NORMAL_MODE &&
-      ui_fs->split_file_mode == FILE_MODE_SINGLE)
-  {
-    mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_OUTPUT_FILENAMES, SPLT_OUTPUT_CUSTOM);
-  }
-
-  if (split_mode == SPLT_OPTION_NORMAL_MODE)
-  {
-    gint i = 0;
-    for (i = 0;i < ui_fs->pat->splitpoints->len; i++)
-    {
-      splt_point *point = g_ptr_array_index(ui_fs->pat->splitpoints, i);
-      mp3splt_append_splitpoint(ui->mp3splt_state, point);
-      splt_tags *tags = g_ptr_array_index(ui_fs->pat->tags, i);
-      mp3splt_append_tags(ui->mp3splt_state, tags);
-    }
-
-    err = mp3splt_remove_tags_of_skippoints(ui->mp3splt_state);
-    print_status_bar_confirmation_in_idle(err, ui);
-  }
-
-  gint output_filenames = mp3splt_get_int_option(ui->mp3splt_state, SPLT_OPT_OUTPUT_FILENAMES, &err);
-
-  gint selected_split_mode = ui_fs->selected_split_mode;
-  gboolean is_single_file_mode = FALSE;
-  if (ui_fs->split_file_mode == FILE_MODE_SINGLE)
-  {
-    is_single_file_mode = TRUE;
-  }
-
   //files_to_split will not have a read/write issue because the 'splitting' boolean, which does not
   //allow us to modify it while we read it here - no mutex needed
   GPtrArray *files_to_split = ui->files_to_split;
-  gint length = files_to_split->len;
-  gint i = 0;
-  for (i = 0;i < length;i++)
-  {
-    gchar *filename = g_ptr_array_index(files_to_split, i);
-
-    print_processing_file(filename, ui);
-
-    mp3splt_set_filename_to_split(ui->mp3splt_state, filename);
 
-    gint err = SPLT_OK;
-
-    if (!is_single_file_mode)
-    {
-      if (selected_split_mode == SELECTED_SPLIT_INTERNAL_SHEET)
-      {
-        err = mp3splt_import(ui->mp3splt_state, PLUGIN_INTERNAL_IMPORT, filename);
-        print_status_bar_confirmation_in_idle(err, ui);
-        if (err < 0) { continue; }
-      }
-      else if ((selected_split_mode == SELECTED_SPLIT_CUE_FILE) ||
-          (selected_split_mode == SELECTED_SPLIT_CDDB_FILE))
-      {
-        gchar *cue_or_cddb = g_strdup(filename);
-        gchar *last_ext = g_strrstr(cue_or_cddb, ".");
-        *last_ext = '\0';
-
-        GString *cue_or_cddb_file = g_string_new(cue_or_cddb);
-        g_free(cue_or_cddb);
-
-        if (selected_split_mode == SELECTED_SPLIT_CUE_FILE)
-        {
-          g_string_append(cue_or_cddb_file, ".cue");
-          err = mp3splt_import(ui->mp3splt_state, CUE_IMPORT, cue_or_cddb_file->str);
-        }
-        else
-        {
-          g_string_append(cue_or_cddb_file, ".cddb");
-          err = mp3splt_import(ui->mp3splt_state, CDDB_IMPORT, cue_or_cddb_file->str);
-        }
-
-        print_status_bar_confirmation_in_idle(err, ui);
-        g_string_free(cue_or_cddb_file, SPLT_TRUE);
-        if (err < 0) { continue; }
-      }
-    }
-
-    err = mp3splt_split(ui->mp3splt_state);
-    print_status_bar_confirmation_in_idle(err, ui);
+  gint err = SPLT_OK;
+  if (ui_fs->split_file_mode == FILE_MODE_SINGLE)
+  {
+    split_jobs_prepare_state(ui_fs, ui->mp3splt_state, ui_fs->pat);
 
-    err = mp3splt_erase_all_tags(ui->mp3splt_state);
-    print_status_bar_confirmation_in_idle(err, ui);
+    gint output_filenames =
+      mp3splt_get_int_option(ui->mp3splt_state, SPLT_OPT_OUTPUT_FILENAMES, &err);
 
-    err = mp3splt_erase_all_splitpoints(ui->mp3splt_state);
-    print_status_bar_confirmation_in_idle(err, ui);
+    gchar *filename = g_ptr_array_index(files_to_split, 0);
+    err = split_jobs_split_file(ui_fs, ui->mp3splt_state, filename);
 
-    if (get_stop_split_safe(ui))
-    {
-      set_stop_split_safe(FALSE, ui);
-      break;
-    }
+    mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_OUTPUT_FILENAMES, output_filenames);
+  }
+  else
+  {
+    err = split_jobs_run(ui_fs, files_to_split);
   }
 
-  mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_OUTPUT_FILENAMES, output_filenames);
+  set_stop_split_safe(FALSE, ui);
 
   free_ui_for_split(ui_fs);
 
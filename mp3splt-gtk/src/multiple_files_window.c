@@ -41,13 +41,12 @@
 
 #define MY_GTK_RESPONSE 200
 
-static gboolean file_exists_in_multiple_files_table(const gchar *filename, ui_state *ui);
-
 //!Create the model for the batch processing file list
 static GtkTreeModel *create_multiple_files_model()
 {
   GtkListStore *model =
-    gtk_list_store_new(MULTIPLE_FILES_COLUMNS, G_TYPE_STRING, G_TYPE_STRING);
+    gtk_list_store_new(MULTIPLE_FILES_COLUMNS, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING,
+        G_TYPE_STRING, G_TYPE_STRING, G_TYPE_LONG, G_TYPE_INT64);
   return GTK_TREE_MODEL(model);
 }
 
@@ -56,18 +55,31 @@ static GtkTreeView *create_multiple_files_tree()
   return GTK_TREE_VIEW(gtk_tree_view_new_with_model(create_multiple_files_model()));
 }
 
-static void create_multiple_files_columns(GtkTreeView *multiple_files_tree)
+static void create_multiple_files_column(GtkTreeView *multiple_files_tree,
+    const gchar *title, gint text_column, gint sort_column)
 {
   GtkCellRendererText *renderer = GTK_CELL_RENDERER_TEXT(gtk_cell_renderer_text_new());
-  GtkTreeViewColumn *filename_column = gtk_tree_view_column_new_with_attributes 
-    (_("Complete filename"), GTK_CELL_RENDERER(renderer), "text", MULTIPLE_COL_FILENAME, NULL);
-  gtk_tree_view_insert_column(multiple_files_tree,
-      GTK_TREE_VIEW_COLUMN(filename_column), MULTIPLE_COL_FILENAME);
-
-  gtk_tree_view_column_set_alignment(GTK_TREE_VIEW_COLUMN(filename_column), 0.5);
-  gtk_tree_view_column_set_sizing(GTK_TREE_VIEW_COLUMN(filename_column),
-      GTK_TREE_VIEW_COLUMN_AUTOSIZE);
-  gtk_tree_view_column_set_sort_column_id(filename_column, MULTIPLE_COL_FILENAME);
+  GtkTreeViewColumn *column = gtk_tree_view_column_new_with_attributes 
+    (title, GTK_CELL_RENDERER(renderer), "text", text_column, NULL);
+  gtk_tree_view_insert_column(multiple_files_tree, GTK_TREE_VIEW_COLUMN(column), text_column);
+
+  gtk_tree_view_column_set_alignment(GTK_TREE_VIEW_COLUMN(column), 0.5);
+  gtk_tree_view_column_set_sizing(GTK_TREE_VIEW_COLUMN(column), GTK_TREE_VIEW_COLUMN_AUTOSIZE);
+  gtk_tree_view_column_set_sort_column_id(column, sort_column);
+}
+
+static void create_multiple_files_columns(GtkTreeView *multiple_files_tree)
+{
+  create_multiple_files_column(multiple_files_tree, _("Complete filename"),
+      MULTIPLE_COL_FILENAME, MULTIPLE_COL_FILENAME);
+  create_multiple_files_column(multiple_files_tree, _("Length"),
+      MULTIPLE_COL_LENGTH, MULTIPLE_COL_LENGTH_VALUE);
+  create_multiple_files_column(multiple_files_tree, _("Size"),
+      MULTIPLE_COL_SIZE, MULTIPLE_COL_SIZE_VALUE);
+  create_multiple_files_column(multiple_files_tree, _("Type"),
+      MULTIPLE_COL_TYPE, MULTIPLE_COL_TYPE);
+  create_multiple_files_column(multiple_files_tree, _("Tags"),
+      MULTIPLE_COL_TAGS, MULTIPLE_COL_TAGS);
 }
 
 static void multiple_files_open_button_event(GtkWidget *widget, gpointer data)
@@ -143,58 +155,106 @@ void multiple_files_add_button_event(GtkWidget *widget, ui_state *ui)
   gtk_widget_destroy(file_chooser);
 }
 
-void multiple_files_add_filename(const gchar *filename, ui_state *ui)
+/*! Adds the files not already in the batch list
+
+The tree view is detached from its model and the sorting is disabled while
+the rows are appended, so that adding many files does not sort and redraw
+the list for each file.
+
+\return The copies of the filenames added, to be probed in the background
+*/
+GPtrArray *multiple_files_add_filenames(char **filenames, gint number_of_filenames,
+    ui_state *ui)
 {
-  if (file_exists_in_multiple_files_table(filename, ui))
+  GPtrArray *added_filenames = g_ptr_array_new();
+
+  GtkTreeView *tree = ui->gui->multiple_files_tree;
+  GtkTreeModel *model = gtk_tree_view_get_model(tree);
+  g_object_ref(model);
+  gtk_tree_view_set_model(tree, NULL);
+
+  gint sort_column_id = 0;
+  GtkSortType sort_order = GTK_SORT_ASCENDING;
+  gboolean sorted =
+    gtk_tree_sortable_get_sort_column_id(GTK_TREE_SORTABLE(model), &sort_column_id, &sort_order);
+  if (sorted)
   {
-    return;
+    gtk_tree_sortable_set_sort_column_id(GTK_TREE_SORTABLE(model),
+        GTK_TREE_SORTABLE_UNSORTED_SORT_COLUMN_ID, sort_order);
   }
 
-  GtkTreeModel *model = gtk_tree_view_get_model(ui->gui->multiple_files_tree);
+  GHashTable *index = ui->infos->multiple_files_index;
 
-  GtkTreeIter iter;
-  gtk_list_store_append(GTK_LIST_STORE(model), &iter);
-  gtk_list_store_set(GTK_LIST_STORE(model), &iter, MULTIPLE_COL_FILENAME, filename, -1);
+  gint i = 0;
+  for (i = 0;i < number_of_filenames;i++)
+  {
+    const gchar *filename = filenames[i];
+    if (filename == NULL || g_hash_table_contains(index, filename))
+    {
+      continue;
+    }
 
-  ui->infos->multiple_files_tree_number++;
-}
+    GtkTreeIter iter;
+    gtk_list_store_insert_with_values(GTK_LIST_STORE(model), &iter, -1,
+        MULTIPLE_COL_FILENAME, filename,
+        MULTIPLE_COL_LENGTH_VALUE, (glong) -1,
+        MULTIPLE_COL_SIZE_VALUE, (gint64) -1,
+        -1);
+
+    //list store iterators persist while the row exists
+    GtkTreeIter *row = g_malloc(sizeof(GtkTreeIter));
+    *row = iter;
+    g_hash_table_insert(index, g_strdup(filename), row);
+
+    g_ptr_array_add(added_filenames, g_strdup(filename));
+    ui->infos->multiple_files_tree_number++;
+  }
 
-static gboolean file_exists_in_multiple_files_table(const gchar *filename, ui_state *ui)
-{
-  if (filename == NULL)
+  if (sorted)
   {
-    return FALSE;
+    gtk_tree_sortable_set_sort_column_id(GTK_TREE_SORTABLE(model), sort_column_id, sort_order);
   }
 
-  GtkTreeModel *model = gtk_tree_view_get_model(ui->gui->multiple_files_tree);
+  gtk_tree_view_set_model(tree, model);
+  g_object_unref(model);
+
+  return added_filenames;
+}
 
-  GtkTreeIter iter;
-  if (!gtk_tree_model_get_iter_first(model, &iter))
+//! Shows the informations read in the background in the row of the file
+void multiple_files_set_probe_result(batch_probe_result *result, ui_state *ui)
+{
+  GtkTreeIter *iter = g_hash_table_lookup(ui->infos->multiple_files_index, result->filename);
+  if (iter == NULL)
   {
-    return FALSE;
+    return;
   }
 
-  while (TRUE)
+  gchar *length = NULL;
+  if (result->total_time >= 0)
   {
-    gchar *fname = NULL;
-    gtk_tree_model_get(GTK_TREE_MODEL(model), &iter,
-        MULTIPLE_COL_FILENAME, &fname, -1); 
-
-    if (strcmp(filename, fname) == 0)
-    {
-      g_free(fname);
-      return TRUE;
-    }
-
-    g_free(fname);
+    glong seconds = result->total_time / 100;
+    length = g_strdup_printf("%ld:%02ld", seconds / 60, seconds % 60);
+  }
 
-    if (!gtk_tree_model_iter_next(model, &iter))
-    {
-      break;
-    }
+  gchar *size = NULL;
+  if (result->size >= 0)
+  {
+    size = g_format_size((guint64) result->size);
   }
 
-  return FALSE;
+  GtkTreeModel *model = gtk_tree_view_get_model(ui->gui->multiple_files_tree);
+  gtk_list_store_set(GTK_LIST_STORE(model), iter,
+      MULTIPLE_COL_LENGTH, length,
+      MULTIPLE_COL_SIZE, size,
+      MULTIPLE_COL_TYPE, result->type,
+      MULTIPLE_COL_TAGS, result->tags,
+      MULTIPLE_COL_LENGTH_VALUE, (glong) result->total_time,
+      MULTIPLE_COL_SIZE_VALUE, (gint64) result->size,
+      -1);
+
+  g_free(length);
+  g_free(size);
 }
 
 static void multiple_files_remove_button_event(GtkWidget *widget, ui_state *ui)
@@ -210,6 +270,11 @@ static void multiple_files_remove_button_event(GtkWidget *widget, ui_state *ui)
     GtkTreeIter iter;
     gtk_tree_model_get_iter(model, &iter, path);
 
+    gchar *filename = NULL;
+    gtk_tree_model_get(model, &iter, MULTIPLE_COL_FILENAME, &filename, -1);
+    g_hash_table_remove(ui->infos->multiple_files_index, filename);
+    g_free(filename);
+
     gtk_list_store_remove(GTK_LIST_STORE(model), &iter);
     selected_list = g_list_remove(selected_list, path);
     ui->infos->multiple_files_tree_number--;
@@ -231,14 +296,10 @@ static void multiple_files_remove_button_event(GtkWidget *widget, ui_state *ui)
 static void multiple_files_remove_all_button_event(GtkWidget *widget, ui_state *ui)
 {
   GtkTreeModel *model = gtk_tree_view_get_model(ui->gui->multiple_files_tree);
-  while (ui->infos->multiple_files_tree_number > 0)
-  {
-    GtkTreeIter iter;
-    gtk_tree_model_get_iter_first(model, &iter);
-    gtk_list_store_remove(GTK_LIST_STORE(model), &iter);
-    ui->infos->multiple_files_tree_number--;
-  }
-  
+  gtk_list_store_clear(GTK_LIST_STORE(model));
+  g_hash_table_remove_all(ui->infos->multiple_files_index);
+  ui->infos->multiple_files_tree_number = 0;
+
   gtk_widget_set_sensitive(ui->gui->multiple_files_remove_all_files_button, FALSE);
   gtk_widget_set_sensitive(ui->gui->multiple_files_remove_file_button, FALSE);
 }
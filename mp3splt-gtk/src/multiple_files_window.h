@@ -42,13 +42,23 @@
 
 enum {
   MULTIPLE_COL_FILENAME,
+  MULTIPLE_COL_LENGTH,
+  MULTIPLE_COL_SIZE,
+  MULTIPLE_COL_TYPE,
+  MULTIPLE_COL_TAGS,
+  //! Length in hundreths of seconds, used to sort the length column
+  MULTIPLE_COL_LENGTH_VALUE,
+  //! Size in bytes, used to sort the size column
+  MULTIPLE_COL_SIZE_VALUE,
   MULTIPLE_FILES_COLUMNS
 };
 
 GtkWidget *create_multiple_files_component(ui_state *ui);
 void batch_file_mode_split_button_event(GtkWidget *widget, ui_state *ui);
 void multiple_files_add_button_event(GtkWidget *widget, ui_state *ui);
-void multiple_files_add_filename(const gchar *filename, ui_state *ui);
+GPtrArray *multiple_files_add_filenames(char **filenames, gint number_of_filenames,
+    ui_state *ui);
+void multiple_files_set_probe_result(batch_probe_result *result, ui_state *ui);
 
 #endif
 
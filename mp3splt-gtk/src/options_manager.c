@@ -80,6 +80,7 @@ ui_for_split *build_ui_for_split(ui_state *ui)
   ui_fs->adjust_min = gtk_spin_button_get_value(GTK_SPIN_BUTTON(gui->spinner_adjust_min));
 
   ui_fs->split_file_mode = get_split_file_mode(ui);
+  ui_fs->split_jobs_concurrency = ui->infos->split_jobs_concurrency;
 
   ui_fs->selected_split_mode = get_selected_split_mode(ui);
 
@@ -171,6 +172,7 @@ void free_ui_for_split(ui_for_split *ui_fs)
   if (ui_fs->output_format) { g_free(ui_fs->output_format); }
   if (ui_fs->output_directory) { g_free(ui_fs->output_directory); }
   if (ui_fs->test_regex_filename) { g_free(ui_fs->test_regex_filename); }
+  if (ui_fs->preview) { splt_preview_buffer_unref(ui_fs->preview); }
 
   g_free(ui_fs);
 }
@@ -184,86 +186,90 @@ void free_ui_for_split(ui_for_split *ui_fs)
  */
 void put_options_from_preferences(ui_for_split *ui_fs)
 {
-  ui_state *ui = ui_fs->ui;
+  put_options_from_preferences_in_state(ui_fs, ui_fs->ui->mp3splt_state);
+}
 
+//! Same as put_options_from_preferences, for another state than ui->mp3splt_state
+void put_options_from_preferences_in_state(ui_for_split *ui_fs, splt_state *state)
+{
   if (ui_fs->frame_mode)
   {
-    mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_FRAME_MODE, SPLT_TRUE);
+    mp3splt_set_int_option(state, SPLT_OPT_FRAME_MODE, SPLT_TRUE);
   }
   else
   {
-    mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_FRAME_MODE, SPLT_FALSE);
+    mp3splt_set_int_option(state, SPLT_OPT_FRAME_MODE, SPLT_FALSE);
   }
 
-  mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_HANDLE_BIT_RESERVOIR,
+  mp3splt_set_int_option(state, SPLT_OPT_HANDLE_BIT_RESERVOIR,
       ui_fs->bit_reservoir_mode);
 
   if (ui_fs->adjust_mode)
   {
-    mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_AUTO_ADJUST, SPLT_TRUE);
-    mp3splt_set_float_option(ui->mp3splt_state, SPLT_OPT_PARAM_OFFSET, ui_fs->adjust_offset);
-    mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_PARAM_GAP, ui_fs->adjust_gap); 
-    mp3splt_set_float_option(ui->mp3splt_state, SPLT_OPT_PARAM_THRESHOLD, ui_fs->adjust_threshold);
-    mp3splt_set_float_option(ui->mp3splt_state, SPLT_OPT_PARAM_MIN_LENGTH, ui_fs->adjust_min);
+    mp3splt_set_int_option(state, SPLT_OPT_AUTO_ADJUST, SPLT_TRUE);
+    mp3splt_set_float_option(state, SPLT_OPT_PARAM_OFFSET, ui_fs->adjust_offset);
+    mp3splt_set_int_option(state, SPLT_OPT_PARAM_GAP, ui_fs->adjust_gap); 
+    mp3splt_set_float_option(state, SPLT_OPT_PARAM_THRESHOLD, ui_fs->adjust_threshold);
+    mp3splt_set_float_option(state, SPLT_OPT_PARAM_MIN_LENGTH, ui_fs->adjust_min);
   }
   else
   {
-    mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_AUTO_ADJUST, SPLT_FALSE);
+    mp3splt_set_int_option(state, SPLT_OPT_AUTO_ADJUST, SPLT_FALSE);
   }
 
-  mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_INPUT_NOT_SEEKABLE, SPLT_FALSE);
-  mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_SPLIT_MODE, SPLT_OPTION_NORMAL_MODE);
+  mp3splt_set_int_option(state, SPLT_OPT_INPUT_NOT_SEEKABLE, SPLT_FALSE);
+  mp3splt_set_int_option(state, SPLT_OPT_SPLIT_MODE, SPLT_OPTION_NORMAL_MODE);
 
   if (ui_fs->split_file_mode == FILE_MODE_SINGLE)
   {
-    mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_SPLIT_MODE, SPLT_OPTION_NORMAL_MODE);
+    mp3splt_set_int_option(state, SPLT_OPT_SPLIT_MODE, SPLT_OPTION_NORMAL_MODE);
   }
   else
   {
     switch (ui_fs->selected_split_mode)
     {
       case SELECTED_SPLIT_NORMAL:
-        mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_SPLIT_MODE, SPLT_OPTION_NORMAL_MODE);
+        mp3splt_set_int_option(state, SPLT_OPT_SPLIT_MODE, SPLT_OPTION_NORMAL_MODE);
         break;
       case SELECTED_SPLIT_WRAP:
-        mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_SPLIT_MODE, SPLT_OPTION_WRAP_MODE);
+        mp3splt_set_int_option(state, SPLT_OPT_SPLIT_MODE, SPLT_OPTION_WRAP_MODE);
         break;
       case SELECTED_SPLIT_TIME:
-        mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_SPLIT_MODE, SPLT_OPTION_TIME_MODE);
-        mp3splt_set_long_option(ui->mp3splt_state, SPLT_OPT_SPLIT_TIME,
+        mp3splt_set_int_option(state, SPLT_OPT_SPLIT_MODE, SPLT_OPTION_TIME_MODE);
+        mp3splt_set_long_option(state, SPLT_OPT_SPLIT_TIME,
             ui_fs->time_split_value * 100);
         break;
       case SELECTED_SPLIT_EQUAL_TIME_TRACKS:
-        mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_SPLIT_MODE, SPLT_OPTION_LENGTH_MODE);
-        mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_LENGTH_SPLIT_FILE_NUMBER,
+        mp3splt_set_int_option(state, SPLT_OPT_SPLIT_MODE, SPLT_OPTION_LENGTH_MODE);
+        mp3splt_set_int_option(state, SPLT_OPT_LENGTH_SPLIT_FILE_NUMBER,
             ui_fs->equal_tracks_value);
         break;
       case SELECTED_SPLIT_SILENCE:
-        mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_SPLIT_MODE, SPLT_OPTION_SILENCE_MODE);
-        mp3splt_set_float_option(ui->mp3splt_state, SPLT_OPT_PARAM_THRESHOLD,
+        mp3splt_set_int_option(state, SPLT_OPT_SPLIT_MODE, SPLT_OPTION_SILENCE_MODE);
+        mp3splt_set_float_option(state, SPLT_OPT_PARAM_THRESHOLD,
             ui_fs->silence_threshold);
-        mp3splt_set_float_option(ui->mp3splt_state, SPLT_OPT_PARAM_OFFSET, ui_fs->silence_offset);
-        mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_PARAM_NUMBER_TRACKS, 
+        mp3splt_set_float_option(state, SPLT_OPT_PARAM_OFFSET, ui_fs->silence_offset);
+        mp3splt_set_int_option(state, SPLT_OPT_PARAM_NUMBER_TRACKS, 
             ui_fs->silence_number);
-        mp3splt_set_float_option(ui->mp3splt_state, SPLT_OPT_PARAM_MIN_LENGTH,
+        mp3splt_set_float_option(state, SPLT_OPT_PARAM_MIN_LENGTH,
             ui_fs->silence_minimum_length);
-        mp3splt_set_float_option(ui->mp3splt_state, SPLT_OPT_PARAM_MIN_TRACK_LENGTH,
+        mp3splt_set_float_option(state, SPLT_OPT_PARAM_MIN_TRACK_LENGTH,
             ui_fs->silence_minimum_track_length);
         if (ui_fs->silence_remove)
         {
-          mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_PARAM_REMOVE_SILENCE, SPLT_TRUE);
+          mp3splt_set_int_option(state, SPLT_OPT_PARAM_REMOVE_SILENCE, SPLT_TRUE);
         }
         else
         {
-          mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_PARAM_REMOVE_SILENCE, SPLT_FALSE);
+          mp3splt_set_int_option(state, SPLT_OPT_PARAM_REMOVE_SILENCE, SPLT_FALSE);
         }
         break;
       case SELECTED_SPLIT_TRIM_SILENCE:
-        mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_SPLIT_MODE, SPLT_OPTION_TRIM_SILENCE_MODE);
-        mp3splt_set_float_option(ui->mp3splt_state, SPLT_OPT_PARAM_THRESHOLD, ui_fs->trim_silence_threshold);
+        mp3splt_set_int_option(state, SPLT_OPT_SPLIT_MODE, SPLT_OPTION_TRIM_SILENCE_MODE);
+        mp3splt_set_float_option(state, SPLT_OPT_PARAM_THRESHOLD, ui_fs->trim_silence_threshold);
         break;
       case SELECTED_SPLIT_ERROR:
-        mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_SPLIT_MODE, SPLT_OPTION_ERROR_MODE);
+        mp3splt_set_int_option(state, SPLT_OPT_SPLIT_MODE, SPLT_OPTION_ERROR_MODE);
         break;
       default:
         break;
@@ -273,70 +279,73 @@ void put_options_from_preferences(ui_for_split *ui_fs)
   int selected_tags_value = ui_fs->selected_tags_value;;
   if (selected_tags_value == NO_TAGS)
   {
-    mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_TAGS, SPLT_NO_TAGS);
+    mp3splt_set_int_option(state, SPLT_OPT_TAGS, SPLT_NO_TAGS);
   }
   else if (selected_tags_value == DEFAULT_TAGS)
   {
-    mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_TAGS, SPLT_CURRENT_TAGS);
+    mp3splt_set_int_option(state, SPLT_OPT_TAGS, SPLT_CURRENT_TAGS);
   }
   else if (selected_tags_value == ORIGINAL_FILE_TAGS)
   {
-    mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_TAGS, SPLT_TAGS_ORIGINAL_FILE);
+    mp3splt_set_int_option(state, SPLT_OPT_TAGS, SPLT_TAGS_ORIGINAL_FILE);
   }
   else if (selected_tags_value == TAGS_FROM_FILENAME)
   {
-    put_tags_from_filename_regex_options(ui_fs);
+    put_tags_from_filename_regex_options_in_state(ui_fs, state);
   }
 
   int tags_radio_choice = ui_fs->tags_version;
   if (tags_radio_choice == 0)
   {
-    mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_FORCE_TAGS_VERSION, 0);
+    mp3splt_set_int_option(state, SPLT_OPT_FORCE_TAGS_VERSION, 0);
   }
   else if (tags_radio_choice == 1)
   {
-    mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_FORCE_TAGS_VERSION, 1);
+    mp3splt_set_int_option(state, SPLT_OPT_FORCE_TAGS_VERSION, 1);
   }
   else if (tags_radio_choice == 2)
   {
-    mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_FORCE_TAGS_VERSION, 2);
+    mp3splt_set_int_option(state, SPLT_OPT_FORCE_TAGS_VERSION, 2);
   }
   else if (tags_radio_choice == 3)
   {
-    mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_FORCE_TAGS_VERSION, 12);
+    mp3splt_set_int_option(state, SPLT_OPT_FORCE_TAGS_VERSION, 12);
   }
 
-  mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_CREATE_DIRS_FROM_FILENAMES,
+  mp3splt_set_int_option(state, SPLT_OPT_CREATE_DIRS_FROM_FILENAMES,
       ui_fs->create_dirs_from_filenames);
 }
 
 void put_tags_from_filename_regex_options(ui_for_split *ui_fs)
 {
-  ui_state *ui = ui_fs->ui;
+  put_tags_from_filename_regex_options_in_state(ui_fs, ui_fs->ui->mp3splt_state);
+}
 
-  mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_TAGS, SPLT_TAGS_FROM_FILENAME_REGEX);
+void put_tags_from_filename_regex_options_in_state(ui_for_split *ui_fs, splt_state *state)
+{
+  mp3splt_set_int_option(state, SPLT_OPT_TAGS, SPLT_TAGS_FROM_FILENAME_REGEX);
 
   int underscores = ui_fs->regex_replace_underscores;
-  mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_REPLACE_UNDERSCORES_TAG_FORMAT, underscores);
+  mp3splt_set_int_option(state, SPLT_OPT_REPLACE_UNDERSCORES_TAG_FORMAT, underscores);
 
-  mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_ARTIST_TAG_FORMAT, 
+  mp3splt_set_int_option(state, SPLT_OPT_ARTIST_TAG_FORMAT, 
       ui_fs->regex_artist_tag_format);
-  mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_ALBUM_TAG_FORMAT, 
+  mp3splt_set_int_option(state, SPLT_OPT_ALBUM_TAG_FORMAT, 
       ui_fs->regex_album_tag_format);
-  mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_TITLE_TAG_FORMAT,
+  mp3splt_set_int_option(state, SPLT_OPT_TITLE_TAG_FORMAT,
       ui_fs->regex_title_tag_format);
-  mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_COMMENT_TAG_FORMAT, 
+  mp3splt_set_int_option(state, SPLT_OPT_COMMENT_TAG_FORMAT, 
       ui_fs->regex_comment_tag_format);
 
-  mp3splt_set_input_filename_regex(ui->mp3splt_state, ui_fs->regex);
+  mp3splt_set_input_filename_regex(state, ui_fs->regex);
 
   const gchar *default_comment = ui_fs->regex_default_comment;
   if (strlen(default_comment) == 0)
   {
     default_comment = NULL;
   }
-  mp3splt_set_default_comment_tag(ui->mp3splt_state, default_comment);
+  mp3splt_set_default_comment_tag(state, default_comment);
 
-  mp3splt_set_default_genre_tag(ui->mp3splt_state, ui_fs->regex_default_genre);
+  mp3splt_set_default_genre_tag(state, ui_fs->regex_default_genre);
 }
 
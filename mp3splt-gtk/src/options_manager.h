@@ -39,6 +39,8 @@
 void update_output_options(ui_state *ui, gboolean is_checked_output_radio_box, gchar *output_format);
 void put_options_from_preferences(ui_for_split *ui_fs);
 void put_tags_from_filename_regex_options(ui_for_split *ui_fs);
+void put_options_from_preferences_in_state(ui_for_split *ui_fs, splt_state *state);
+void put_tags_from_filename_regex_options_in_state(ui_for_split *ui_fs, splt_state *state);
 
 ui_for_split *build_ui_for_split(ui_state *ui);
 void free_ui_for_split(ui_for_split *ui_fs);
@@ -91,6 +91,45 @@ gint player_get_total_time(ui_state *ui)
   return 0;
 }
 
+//!returns TRUE if the player can play a split preview streamed from memory
+gint player_can_play_preview_from_memory(ui_state *ui)
+{
+#ifndef NO_GSTREAMER
+  if (ui->infos->selected_player == PLAYER_GSTREAMER)
+  {
+    return TRUE;
+  }
+#endif
+
+  return FALSE;
+}
+
+//!returns TRUE if the player notifies its changes of state, so that it does not need to be polled
+gint player_notifies_state_changes(ui_state *ui)
+{
+#ifndef NO_GSTREAMER
+  if (ui->infos->selected_player == PLAYER_GSTREAMER)
+  {
+    return TRUE;
+  }
+#endif
+
+  return FALSE;
+}
+
+//!plays a split preview streamed from memory, starting at start_time in the input file
+void player_play_preview(preview_buffer *buffer, gint start_time, ui_state *ui)
+{
+#ifndef NO_GSTREAMER
+  if (ui->infos->selected_player == PLAYER_GSTREAMER)
+  {
+    gstreamer_play_preview(buffer, start_time, ui);
+  }
+#endif
+
+  wake_up_player_timer(ui);
+}
+
 //!returns FALSE if the player is not running, else TRUE
 gint player_is_running(ui_state *ui)
 {
@@ -283,6 +322,8 @@ void player_play(ui_state *ui)
     gstreamer_play(ui);
 #endif
   }
+
+  wake_up_player_timer(ui);
 }
 
 //!stops the song
@@ -306,6 +347,8 @@ void player_stop(ui_state *ui)
     gstreamer_stop(ui);
 #endif
   }
+
+  wake_up_player_timer(ui);
 }
 
 //!pause the song
@@ -329,6 +372,8 @@ void player_pause(ui_state *ui)
     gstreamer_pause(ui);
 #endif
   }
+
+  wake_up_player_timer(ui);
 }
 
 //!pass to the next song
@@ -352,6 +397,8 @@ void player_next(ui_state *ui)
     gstreamer_next(ui);
 #endif
   }
+
+  wake_up_player_timer(ui);
 }
 
 //!pass to the previous song
@@ -375,6 +422,8 @@ void player_prev(ui_state *ui)
     gstreamer_prev(ui);
 #endif
   }
+
+  wake_up_player_timer(ui);
 }
 
 //!jumps to a position in the song
@@ -400,6 +449,8 @@ void player_seek(gint position, ui_state *ui)
     gstreamer_jump(position, ui);
 #endif
   }
+
+  wake_up_player_timer(ui);
 }
 
 /*!get infos about the song
@@ -52,6 +52,9 @@
 
 gint player_get_elapsed_time(ui_state *ui);
 gint player_get_total_time(ui_state *ui);
+gint player_can_play_preview_from_memory(ui_state *ui);
+gint player_notifies_state_changes(ui_state *ui);
+void player_play_preview(preview_buffer *buffer, gint start_time, ui_state *ui);
 gint player_is_running(ui_state *ui);
 void player_start(ui_state *ui);
 void player_start_add_files(GList *list, ui_state *ui);
@@ -54,12 +54,34 @@ enum {
 static void draw_small_rectangle(gint time_left, gint time_right, 
     GdkColor color, cairo_t *cairo_surface, ui_state *ui);
 static gint mytimer(ui_state *ui);
+static void schedule_player_timer(guint interval, ui_state *ui);
+static gfloat time_to_pixels_float(gint width, gfloat time, gfloat total_time, gfloat zoom_coeff);
 static gint remaining_time_to_stop_timer(ui_state *ui);
+static gint convert_time_to_pixels_without_diff(gint width, gfloat time, 
+    gfloat current_time, gfloat total_time, gfloat zoom_coeff);
+
+static void publish_silence_wave_chunk(ui_infos *infos)
+{
+  wave_chunk *chunk = infos->silence_wave_chunk;
+  if (!chunk || chunk->number_of_points == 0)
+  {
+    return;
+  }
+
+  //waits for the gui to catch up when it is late
+  while (!splt_wave_queue_push(infos->silence_wave_queue, chunk))
+  {
+    g_usleep(G_USEC_PER_SEC / 100);
+  }
+
+  infos->silence_wave_chunk = NULL;
+}
 
 //!function called from the library when scanning for the silence level
 static void get_silence_level(long time, float level, void *user_data)
 {
   ui_state *ui = (ui_state *)user_data;
+  ui_infos *infos = ui->infos;
 
   gint converted_level = (gint)floorf(abs(level));
   if (converted_level < 0)
@@ -67,22 +89,106 @@ static void get_silence_level(long time, float level, void *user_data)
     return;
   }
 
-  if (!ui->infos->silence_points)
+  if (!infos->silence_wave_chunk)
   {
-    ui->infos->silence_points = g_malloc(sizeof(silence_wave) * 3000);
-    ui->infos->malloced_num_of_silence_points = 3000;
+    infos->silence_wave_chunk = g_malloc(sizeof(wave_chunk));
+    infos->silence_wave_chunk->number_of_points = 0;
   }
-  else if (ui->infos->number_of_silence_points >= ui->infos->malloced_num_of_silence_points)
+
+  wave_chunk *chunk = infos->silence_wave_chunk;
+  chunk->points[chunk->number_of_points].time = time;
+  chunk->points[chunk->number_of_points].level = abs(level);
+  chunk->number_of_points++;
+
+  if (chunk->number_of_points == WAVE_CHUNK_NUMBER_OF_POINTS)
   {
-    ui->infos->silence_points = g_realloc(ui->infos->silence_points,
-        sizeof(silence_wave) * (ui->infos->number_of_silence_points + 3000));
-    ui->infos->malloced_num_of_silence_points = ui->infos->number_of_silence_points + 3000;
+    publish_silence_wave_chunk(infos);
   }
+}
+
+static void append_silence_wave_chunk(const wave_chunk *chunk, ui_infos *infos)
+{
+  gint number_of_points = infos->number_of_silence_points + chunk->number_of_points;
+
+  if (number_of_points > infos->malloced_num_of_silence_points)
+  {
+    gint malloced_num_of_silence_points = infos->malloced_num_of_silence_points * 2;
+    if (malloced_num_of_silence_points < number_of_points)
+    {
+      malloced_num_of_silence_points = number_of_points;
+    }
 
-  ui->infos->silence_points[ui->infos->number_of_silence_points].time = time;
-  ui->infos->silence_points[ui->infos->number_of_silence_points].level = abs(level);
+    infos->silence_points = g_realloc(infos->silence_points,
+        sizeof(silence_wave) * malloced_num_of_silence_points);
+    infos->malloced_num_of_silence_points = malloced_num_of_silence_points;
+  }
 
-  ui->infos->number_of_silence_points++;
+  memcpy(infos->silence_points + infos->number_of_silence_points, chunk->points,
+      sizeof(silence_wave) * chunk->number_of_points);
+  infos->number_of_silence_points = number_of_points;
+  infos->silence_wave_version++;
+}
+
+//!redraws the part of the wave between the two times
+static void refresh_silence_wave_area(long first_time, long last_time, ui_state *ui)
+{
+  ui_infos *infos = ui->infos;
+  gui_state *gui = ui->gui;
+
+  gint first_pixel = convert_time_to_pixels_without_diff(infos->width_drawing_area,
+      (gfloat) first_time, infos->current_time, infos->total_time, infos->zoom_coeff);
+  gint last_pixel = convert_time_to_pixels_without_diff(infos->width_drawing_area,
+      (gfloat) last_time, infos->current_time, infos->total_time, infos->zoom_coeff);
+
+  if (last_pixel < 0 || first_pixel > infos->width_drawing_area)
+  {
+    return;
+  }
+
+  //the line drawn to the first new point starts from the previous one
+  first_pixel -= 2;
+  if (first_pixel < 0) { first_pixel = 0; }
+  if (last_pixel > infos->width_drawing_area) { last_pixel = infos->width_drawing_area; }
+
+  gtk_widget_queue_draw_area(gui->drawing_area, first_pixel, gui->text_ypos,
+      last_pixel - first_pixel + 2, gui->wave_ypos - gui->text_ypos);
+}
+
+//!appends the published points to the silence wave and draws them
+static void read_silence_wave_chunks(ui_state *ui)
+{
+  ui_infos *infos = ui->infos;
+  if (!infos->silence_wave_queue)
+  {
+    return;
+  }
+
+  long first_time = -1;
+  long last_time = -1;
+
+  wave_chunk *chunk = NULL;
+  while ((chunk = splt_wave_queue_pop(infos->silence_wave_queue)) != NULL)
+  {
+    if (first_time < 0)
+    {
+      first_time = chunk->points[0].time;
+    }
+    last_time = chunk->points[chunk->number_of_points - 1].time;
+
+    append_silence_wave_chunk(chunk, infos);
+    g_free(chunk);
+  }
+
+  if (first_time >= 0 && ui->status->show_silence_wave)
+  {
+    refresh_silence_wave_area(first_time, last_time, ui);
+  }
+}
+
+static gboolean silence_wave_timeout(ui_state *ui)
+{
+  read_silence_wave_chunks(ui);
+  return TRUE;
 }
 
 static GArray *build_gdk_points_for_douglas_peucker(ui_infos *infos)
@@ -104,62 +210,114 @@ static GArray *build_gdk_points_for_douglas_peucker(ui_infos *infos)
   return points;
 }
 
-static void douglas_peucker_callback(ui_state *ui)
+static void save_silence_wave_in_cache(const gdouble *douglas_peucker_thresholds, ui_state *ui)
 {
-  ui->status->douglas_callback_counter++;
-
-  if (ui->status->douglas_callback_counter % 400 != 0)
+  ui_infos *infos = ui->infos;
+  if (!infos->silence_wave_filename)
   {
     return;
   }
 
-  gtk_progress_bar_pulse(ui->gui->percent_progress_bar);
-  gtk_progress_bar_set_text(ui->gui->percent_progress_bar, 
-      _("Processing Douglas-Peucker filters ..."));
-  gtk_widget_queue_draw(GTK_WIDGET(ui->gui->percent_progress_bar));
+  gchar *wave_cache_directory = get_wave_cache_directory();
+  splt_wave_cache_save(wave_cache_directory, infos->silence_wave_filename,
+      infos->silence_points, infos->number_of_silence_points,
+      infos->silence_wave_pyramid, infos->filtered_points_presence,
+      douglas_peucker_thresholds);
+  g_free(wave_cache_directory);
+}
+
+static gboolean compute_douglas_peucker_filters_end(ui_with_douglas_points *ui_dp)
+{
+  ui_state *ui = ui_dp->ui;
+  ui_infos *infos = ui->infos;
+  gui_status *status = ui->status;
 
-#ifndef __WIN32__
-  while (gtk_events_pending())
+  //the wave may have been scanned again or reloaded while computing
+  if (ui_dp->silence_wave_version == infos->silence_wave_version &&
+      !get_currently_scanning_for_silence_safe(ui))
   {
-    gtk_main_iteration();
+    infos->filtered_points_presence = ui_dp->presence;
+    infos->silence_wave_version++;
+    save_silence_wave_in_cache(ui_dp->thresholds, ui);
   }
-#endif
+  else
+  {
+    splt_douglas_peucker_free(ui_dp->presence);
+  }
+
+  g_free(ui_dp);
+
+  status->currently_compute_douglas_peucker_filters = FALSE;
+
+  clear_previous_distances(ui);
+  check_update_down_progress_bar(ui);
 
-  ui->status->douglas_callback_counter = 0;
+  refresh_drawing_area(ui->gui, infos);
+  refresh_preview_drawing_areas(ui->gui);
+
+  if (status->douglas_peucker_filters_to_recompute)
+  {
+    compute_douglas_peucker_filters(ui);
+  }
+
+  return FALSE;
+}
+
+static gpointer compute_douglas_peucker_filters_thread(ui_with_douglas_points *ui_dp)
+{
+  gdouble *thresholds = ui_dp->thresholds;
+
+  ui_dp->presence =
+    splt_douglas_peucker(ui_dp->gdk_points,
+        thresholds[0], thresholds[1], thresholds[2],
+        thresholds[3], thresholds[4], thresholds[5], -1.0);
+
+  g_array_free(ui_dp->gdk_points, TRUE);
+  ui_dp->gdk_points = NULL;
+
+  add_idle(G_PRIORITY_HIGH_IDLE, (GSourceFunc)compute_douglas_peucker_filters_end, ui_dp, NULL);
+
+  return NULL;
 }
 
+/*! Computes the Douglas-Peucker filters of the silence wave in the background
+
+The wave is drawn without interpolation until the filters are available.
+If the filters are asked again while computing, they are computed once more
+when the current computation ends.
+*/
 void compute_douglas_peucker_filters(ui_state *ui)
 {
-  if (!ui->status->show_silence_wave || ui->status->currently_compute_douglas_peucker_filters)
+  gui_status *status = ui->status;
+
+  if (!status->show_silence_wave || get_currently_scanning_for_silence_safe(ui))
   {
     return;
   }
 
+  if (status->currently_compute_douglas_peucker_filters)
+  {
+    status->douglas_peucker_filters_to_recompute = TRUE;
+    return;
+  }
+
   ui_infos *infos = ui->infos;
-  gui_status *status = ui->status;
 
   status->currently_compute_douglas_peucker_filters = TRUE;
-
-  status->douglas_callback_counter = 0;
-
-  GArray *gdk_points_for_douglas_peucker = build_gdk_points_for_douglas_peucker(infos);
+  status->douglas_peucker_filters_to_recompute = FALSE;
 
   splt_douglas_peucker_free(infos->filtered_points_presence);
+  infos->filtered_points_presence = NULL;
+  infos->silence_wave_version++;
 
-  infos->filtered_points_presence =
-    splt_douglas_peucker(gdk_points_for_douglas_peucker, douglas_peucker_callback, ui,
-        infos->douglas_peucker_thresholds[0], infos->douglas_peucker_thresholds[1],
-        infos->douglas_peucker_thresholds[2], infos->douglas_peucker_thresholds[3],
-        infos->douglas_peucker_thresholds[4], infos->douglas_peucker_thresholds[5],
-        -1.0);
-
-  g_array_free(gdk_points_for_douglas_peucker, TRUE);
-
-  clear_previous_distances(ui);
-
-  check_update_down_progress_bar(ui);
+  ui_with_douglas_points *ui_dp = g_malloc0(sizeof(ui_with_douglas_points));
+  ui_dp->ui = ui;
+  ui_dp->silence_wave_version = infos->silence_wave_version;
+  ui_dp->gdk_points = build_gdk_points_for_douglas_peucker(infos);
+  memcpy(ui_dp->thresholds, infos->douglas_peucker_thresholds, sizeof(ui_dp->thresholds));
 
-  status->currently_compute_douglas_peucker_filters = FALSE;
+  create_thread_and_unref((GThreadFunc)compute_douglas_peucker_filters_thread,
+      (gpointer) ui_dp, ui, "douglas_peucker");
 }
 
 void set_currently_scanning_for_silence_safe(gint value, ui_state *ui)
@@ -178,62 +336,182 @@ gint get_currently_scanning_for_silence_safe(ui_state *ui)
   return currently_scanning_for_silence;
 }
 
-static gboolean detect_silence_end(ui_with_err *ui_err)
+static void clear_silence_wave(ui_infos *infos)
+{
+  if (infos->silence_points)
+  {
+    g_free(infos->silence_points);
+    infos->silence_points = NULL;
+    infos->number_of_silence_points = 0;
+    infos->malloced_num_of_silence_points = 0;
+  }
+  splt_wave_pyramid_free(&infos->silence_wave_pyramid);
+  splt_douglas_peucker_free(infos->filtered_points_presence);
+  infos->filtered_points_presence = NULL;
+
+  g_free(infos->silence_wave_filename);
+  infos->silence_wave_filename = NULL;
+
+  infos->silence_wave_version++;
+}
+
+//!the cached Douglas-Peucker filters are used if they have the current thresholds
+static void set_cached_silence_wave(cached_wave *cached, ui_state *ui)
+{
+  ui_infos *infos = ui->infos;
+
+  clear_silence_wave(infos);
+
+  infos->silence_points = cached->silence_points;
+  infos->number_of_silence_points = cached->number_of_silence_points;
+  infos->malloced_num_of_silence_points = cached->number_of_silence_points;
+  cached->silence_points = NULL;
+
+  infos->silence_wave_pyramid = cached->pyramid;
+  cached->pyramid = NULL;
+
+  gboolean same_thresholds = TRUE;
+  gint i = 0;
+  for (i = 0;i < 6;i++)
+  {
+    if (!double_equals(cached->douglas_peucker_thresholds[i], infos->douglas_peucker_thresholds[i]))
+    {
+      same_thresholds = FALSE;
+    }
+  }
+
+  if (same_thresholds)
+  {
+    infos->filtered_points_presence = cached->filtered_points_presence;
+    cached->filtered_points_presence = NULL;
+  }
+
+  splt_cached_wave_free(&cached);
+
+  infos->silence_wave_version++;
+}
+
+static gboolean detect_silence_end(ui_with_wave *ui_wave)
 {
-  ui_state *ui = ui_err->ui;
+  ui_state *ui = ui_wave->ui;
+  ui_infos *infos = ui->infos;
 
   mp3splt_set_silence_level_function(ui->mp3splt_state, NULL, NULL);
 
+  if (ui->status->silence_wave_timeout_id != 0)
+  {
+    g_source_remove(ui->status->silence_wave_timeout_id);
+    ui->status->silence_wave_timeout_id = 0;
+  }
+
+  if (ui_wave->cached)
+  {
+    set_cached_silence_wave(ui_wave->cached, ui);
+    infos->silence_wave_filename = ui_wave->fname;
+  }
+  else
+  {
+    read_silence_wave_chunks(ui);
+    splt_wave_queue_free(&infos->silence_wave_queue);
+
+    infos->silence_wave_pyramid =
+      splt_wave_pyramid_new(infos->silence_points, infos->number_of_silence_points);
+    infos->silence_wave_version++;
+
+    //a cancelled scan is not cached
+    if (ui_wave->err >= 0)
+    {
+      infos->silence_wave_filename = ui_wave->fname;
+    }
+    else
+    {
+      g_free(ui_wave->fname);
+    }
+
+    print_status_bar_confirmation(ui_wave->err, ui);
+  }
+
   set_is_splitting_safe(FALSE, ui);
   set_currently_scanning_for_silence_safe(FALSE, ui);
 
-  compute_douglas_peucker_filters(ui);
+  if (!infos->filtered_points_presence)
+  {
+    compute_douglas_peucker_filters(ui);
+  }
 
-  print_status_bar_confirmation(ui_err->err, ui);
   gtk_widget_set_sensitive(ui->gui->cancel_button, FALSE);
 
-  refresh_drawing_area(ui->gui, ui->infos);
+  refresh_drawing_area(ui->gui, infos);
   refresh_preview_drawing_areas(ui->gui);
 
-  set_process_in_progress_and_wait_safe(FALSE, ui_err->ui);
+  set_process_in_progress_and_wait_safe(FALSE, ui);
+
+  g_free(ui_wave);
+
+  return FALSE;
+}
+
+//!clears the previous wave and starts drawing the points published by the scan
+static gboolean detect_silence_start(ui_state *ui)
+{
+  clear_silence_wave(ui->infos);
+
+  ui->status->silence_wave_timeout_id =
+    g_timeout_add(SILENCE_WAVE_REFRESH_TIMEOUT, (GSourceFunc)silence_wave_timeout, ui);
 
-  g_free(ui_err);
+  refresh_drawing_area(ui->gui, ui->infos);
 
   return FALSE;
 }
 
-static gpointer detect_silence(ui_state *ui)
+/*! Scans the silence wave or reads it from the wave cache
+
+The scanned points are published by chunks to the gui which draws them as
+they come, so that splitpoints can be placed before the end of the scan.
+*/
+static gpointer detect_silence(ui_with_wave *ui_wave)
 {
+  ui_state *ui = ui_wave->ui;
+
   set_process_in_progress_and_wait_safe(TRUE, ui);
 
   set_is_splitting_safe(TRUE, ui);
   set_currently_scanning_for_silence_safe(TRUE, ui);
 
-  if (ui->infos->silence_points)
+  gchar *wave_cache_directory = get_wave_cache_directory();
+  ui_wave->cached = splt_wave_cache_load(wave_cache_directory, ui_wave->fname);
+  g_free(wave_cache_directory);
+
+  if (ui_wave->cached)
   {
-    g_free(ui->infos->silence_points);
-    ui->infos->silence_points = NULL;
-    ui->infos->number_of_silence_points = 0;
+    add_idle(G_PRIORITY_HIGH_IDLE, (GSourceFunc)detect_silence_end, ui_wave, NULL);
+    return NULL;
   }
 
+  //the queue of the previous scan is freed by detect_silence_end
+  ui->infos->silence_wave_queue = splt_wave_queue_new();
+  add_idle(G_PRIORITY_HIGH_IDLE, (GSourceFunc)detect_silence_start, ui, NULL);
+
   mp3splt_set_silence_level_function(ui->mp3splt_state, get_silence_level, ui);
 
-  gint err = SPLT_OK;
-  mp3splt_set_silence_points(ui->mp3splt_state, &err);
+  ui_wave->err = SPLT_OK;
+  mp3splt_set_silence_points(ui->mp3splt_state, &ui_wave->err);
 
-  ui_with_err *ui_err = g_malloc0(sizeof(ui_with_err));
-  ui_err->err = err;
-  ui_err->ui = ui;
+  publish_silence_wave_chunk(ui->infos);
 
-  add_idle(G_PRIORITY_HIGH_IDLE, (GSourceFunc)detect_silence_end, ui_err, NULL);
+  add_idle(G_PRIORITY_HIGH_IDLE, (GSourceFunc)detect_silence_end, ui_wave, NULL);
 
   return NULL;
 }
 
 static void detect_silence_action(ui_state *ui)
 {
+  ui_with_wave *ui_wave = g_malloc0(sizeof(ui_with_wave));
+  ui_wave->ui = ui;
+  ui_wave->fname = g_strdup(get_input_filename(ui->gui));
+
   gtk_widget_set_sensitive(ui->gui->cancel_button, TRUE);
-  create_thread_and_unref((GThreadFunc)detect_silence, (gpointer) ui, ui, "scan_silence_wave");
+  create_thread_and_unref((GThreadFunc)detect_silence, (gpointer) ui_wave, ui, "scan_silence_wave");
 }
 
 /*! Initialize scanning for silence in the background.
@@ -504,8 +782,7 @@ static void connect_with_song(const gchar *fname, gint start_playing, ui_state *
 
   if (!status->timer_active)
   {
-    status->timeout_id = g_timeout_add(ui->infos->timeout_value, (GSourceFunc)mytimer, ui);
-    status->timer_active = TRUE;
+    schedule_player_timer(ui->infos->timeout_value, ui);
   }
 
   enable_player_buttons(ui);
@@ -548,8 +825,7 @@ void connect_button_event(GtkWidget *widget, ui_state *ui)
       connect_snackamp(8775, ui);
     }
 
-    status->timeout_id = g_timeout_add(ui->infos->timeout_value, (GSourceFunc)mytimer, ui);
-    status->timer_active = TRUE;
+    schedule_player_timer(ui->infos->timeout_value, ui);
   }
 
   //connect to player with song
@@ -681,9 +957,27 @@ void restart_player_timer(ui_state *ui)
 {
   if (ui->status->timer_active)
   {
-    g_source_remove(ui->status->timeout_id);
-    ui->status->timeout_id = g_timeout_add(ui->infos->timeout_value, (GSourceFunc)mytimer, ui);
+    ui->status->player_timer_interval = 0;
+    schedule_player_timer(ui->infos->timeout_value, ui);
+  }
+}
+
+/*! Runs the player timer as soon as possible
+
+Called when the player notifies a change of state, so that the timer can
+poll slowly while nothing is playing.
+*/
+void wake_up_player_timer(ui_state *ui)
+{
+  gui_status *status = ui->status;
+  if (!status->timer_active)
+  {
+    return;
   }
+
+  g_source_remove(status->timeout_id);
+  status->player_timer_interval = 0;
+  status->timeout_id = g_idle_add((GSourceFunc)mytimer, ui);
 }
 
 //! play button event
@@ -1196,11 +1490,45 @@ void check_update_down_progress_bar(ui_state *ui)
   g_free(progress_description);
 }
 
+/*! Redraws the drawing area after a change of the current time
+
+The drawing area is centered on the current time: the whole area moves only
+when the time changed by at least one pixel. Otherwise, only the row of the
+times is redrawn, when the printed seconds changed.
+*/
+static void refresh_drawing_area_for_current_time(ui_state *ui)
+{
+  ui_infos *infos = ui->infos;
+  gui_state *gui = ui->gui;
+  gui_status *status = ui->status;
+
+  gfloat drawn_time = status->drawn_current_time;
+  gfloat current_time = infos->current_time;
+
+  gfloat moved_pixels = 0;
+  if (infos->total_time > 0 && infos->width_drawing_area > 0)
+  {
+    moved_pixels = time_to_pixels_float(infos->width_drawing_area,
+        current_time - drawn_time, infos->total_time, infos->zoom_coeff);
+  }
+
+  if (drawn_time < 0 || fabs(moved_pixels) >= 1.0 || gui->times_text_ypos <= 0)
+  {
+    status->drawn_current_time = current_time;
+    refresh_drawing_area(gui, infos);
+    return;
+  }
+
+  if ((gint)current_time / 100 != (gint)drawn_time / 100)
+  {
+    gtk_widget_queue_draw_area(gui->drawing_area, 0, gui->times_text_ypos,
+        infos->width_drawing_area, DRAWING_AREA_TIMES_TEXT_HEIGHT);
+  }
+}
+
 //!event when the progress bar value changed
 static void progress_bar_value_changed_event(GtkRange *range, ui_state *ui)
 {
-  refresh_drawing_area(ui->gui, ui->infos);
-
   ui_infos *infos = ui->infos;
 
   infos->player_hundr_secs2 = (gint)infos->current_time % 100;
@@ -1214,6 +1542,8 @@ static void progress_bar_value_changed_event(GtkRange *range, ui_state *ui)
 
   infos->current_time = get_elapsed_time(ui);
 
+  refresh_drawing_area_for_current_time(ui);
+
   check_update_down_progress_bar(ui);
 }
 
@@ -1267,13 +1597,24 @@ static GtkWidget *create_song_bar_hbox(ui_state *ui)
   return song_bar_hbox;
 }
 
+//! The player timer sets the same texts most of the time: avoid relayouts of the labels
+static void set_label_text_if_changed(GtkWidget *label, const gchar *text)
+{
+  if (g_strcmp0(gtk_label_get_text(GTK_LABEL(label)), text) == 0)
+  {
+    return;
+  }
+
+  gtk_label_set_text(GTK_LABEL(label), text);
+}
+
 //!prints information about the song, frequency, kbps, stereo
 static void print_about_the_song(ui_state *ui)
 {
   gchar total_infos[512];
   player_get_song_infos(total_infos, ui);
 
-  gtk_label_set_text(GTK_LABEL(ui->gui->song_infos), total_infos);
+  set_label_text_if_changed(ui->gui->song_infos, total_infos);
 }
 
 //!prints the player filename
@@ -1292,7 +1633,7 @@ static void print_player_filename(ui_state *ui)
   gchar *title = player_get_title(ui);
   if (title != NULL)
   {
-    gtk_label_set_text(GTK_LABEL(ui->gui->song_name_label), title);
+    set_label_text_if_changed(ui->gui->song_name_label, title);
     if (title != NULL)
     {
       g_free(title);
@@ -1340,7 +1681,7 @@ static void print_song_time_elapsed(ui_state *ui)
   g_snprintf(seconds_minutes, 64, "%s  :  %s  /  %s  :  %s", 
       minutes, seconds, total_minutes, total_seconds);
 
-  gtk_label_set_text(GTK_LABEL(ui->gui->label_time), seconds_minutes);
+  set_label_text_if_changed(ui->gui->label_time, seconds_minutes);
 }
 
 //!change volume to match the players volume
@@ -1381,12 +1722,18 @@ static void change_progress_bar(ui_state *ui)
   gui_status *status = ui->status;
   ui_infos *infos = ui->infos;
 
-  if (!player_is_running(ui) || status->mouse_on_progress_bar)
+  if (!player_is_running(ui))
   {
     refresh_drawing_area(ui->gui, ui->infos);
     return;
   }
 
+  //the drawing area is refreshed when the user moves the progress bar
+  if (status->mouse_on_progress_bar)
+  {
+    return;
+  }
+
   infos->total_time = player_get_total_time(ui) / 10;
 
   infos->current_time = infos->player_seconds * 100 + 
@@ -1497,7 +1844,7 @@ static gint convert_time_to_pixels(gint width, gfloat time,
 {
   gint real_pixel =
     convert_time_to_pixels_without_diff(width, time, current_time, total_time, zoom_coeff);
-  if (infos->drawing_preferences_silence_wave)
+  if (infos->drawing_preferences_silence_wave || infos->drawing_silence_wave_layer)
   {
     return real_pixel;
   }
@@ -1902,12 +2249,12 @@ static gint point_is_filtered(gint index, gint filtered_index, ui_infos *infos)
     return TRUE;
   }
 
-  GArray *points_presence = g_ptr_array_index(infos->filtered_points_presence, filtered_index);
-  return !g_array_index(points_presence, gint, index);
+  return !splt_douglas_peucker_point_is_present(infos->filtered_points_presence,
+      index, filtered_index);
 }
 
 static gint adjust_filtered_index_according_to_number_of_points(gint filtered_index, 
-    gint left_mark, gint right_mark, ui_state *ui)
+    gint first_point, gint last_point, ui_state *ui)
 {
   ui_infos *infos = ui->infos;
 
@@ -1916,24 +2263,16 @@ static gint adjust_filtered_index_according_to_number_of_points(gint filtered_in
     return filtered_index;
   }
 
-  gint number_of_points = 0;
+  gint number_of_points = last_point - first_point + 1;
   gint number_of_filtered_points = 0;
 
   gint i = 0;
-  for (i = 0;i < infos->number_of_silence_points;i++)
+  for (i = first_point;i <= last_point && filtered_index >= 0;i++)
   {
-    long time = infos->silence_points[i].time;
-    if ((time > right_mark) || (time < left_mark)) 
-    {
-      continue;
-    }
-
-    if (filtered_index >= 0 && point_is_filtered(i, filtered_index, infos))
+    if (point_is_filtered(i, filtered_index, infos))
     {
       number_of_filtered_points++;
     }
-
-    number_of_points++;
   }
 
   if (number_of_points <= ui->infos->silence_wave_number_of_points_threshold)
@@ -1959,29 +2298,88 @@ static void line_and_move(gint x, gint y, gint stroke_counter, cairo_t *gc)
   cairo_move_to(gc, x, y);
 }
 
-//! Draws the silence wave
-gint draw_silence_wave(gint left_mark, gint right_mark, 
-    gint interpolation_text_x, gint interpolation_text_y,
-    gfloat draw_time, gint width_drawing_area, gint y_margin,
-    gfloat current_time, gfloat total_time, gfloat zoom_coeff, 
-    GtkWidget *da, cairo_t *gc, ui_state *ui)
+/*! Draws the min/max summary of the silence wave from the pyramid
+
+One bucket per pixel at most is drawn: the average levels are joined and
+a vertical line goes from the minimum to the maximum level of the bucket.
+*/
+static void draw_silence_wave_summary(gint left_mark, gint right_mark,
+    gint width_drawing_area, gint y_margin,
+    gfloat current_time, gfloat total_time, gfloat zoom_coeff, cairo_t *gc, ui_state *ui)
 {
-  if (ui->status->currently_compute_douglas_peucker_filters ||
-      get_currently_scanning_for_silence_safe(ui))
+  wave_pyramid *pyramid = ui->infos->silence_wave_pyramid;
+  gint level = splt_wave_pyramid_choose_level(pyramid, left_mark, right_mark, width_drawing_area);
+
+  glong first_bucket = 0;
+  glong number_of_buckets = 0;
+  const wave_bucket *buckets = splt_wave_pyramid_get_buckets(pyramid, level,
+      left_mark, right_mark, &first_bucket, &number_of_buckets);
+
+  gint stroke_counter = 0;
+
+  glong i = 0;
+  for (i = 0;i < number_of_buckets;i++)
   {
-    return -1;
+    const wave_bucket *bucket = &buckets[i];
+    if (bucket->number_of_points == 0)
+    {
+      continue;
+    }
+
+    long time = splt_wave_pyramid_get_bucket_time(pyramid, level, first_bucket + i);
+    gint x = convert_time_to_pixels(width_drawing_area, (gfloat)time, current_time,
+        total_time, zoom_coeff, ui->infos);
+    gint y = y_margin + (gint)floorf(bucket->avg);
+
+    stroke_counter++;
+    line_and_move(x, y, stroke_counter, gc);
+
+    gint min_y = y_margin + (gint)floorf(bucket->min);
+    gint max_y = y_margin + (gint)floorf(bucket->max);
+    if (min_y != max_y)
+    {
+      cairo_move_to(gc, x, min_y);
+      cairo_line_to(gc, x, max_y);
+      cairo_move_to(gc, x, y);
+    }
   }
 
+  cairo_stroke(gc);
+}
+
+//! Draws the text telling how the silence wave was drawn
+static void draw_silence_wave_level_text(gint interpolation_level,
+    gint interpolation_text_x, gint interpolation_text_y, cairo_t *gc)
+{
   GdkColor color;
+  color.red = 0;color.green = 0;color.blue = 0;
+  dh_set_color(gc, &color);
 
-  if (!ui->infos->silence_points)
+  if (interpolation_level == SILENCE_WAVE_SUMMARY_LEVEL)
   {
-    color.red = 0;color.green = 0;color.blue = 0;
-    dh_set_color(gc, &color);
-    dh_draw_text_with_size(gc,_("No available wave"), 
+    dh_draw_text_with_size(gc, _("Wave min/max summary"),
         interpolation_text_x, interpolation_text_y, 13);
-    return -1;
   }
+  else if (interpolation_level < 0)
+  {
+    dh_draw_text_with_size(gc,_("No wave interpolation"), 
+        interpolation_text_x, interpolation_text_y, 13);
+  }
+  else
+  {
+    gchar interpolation_text[128] = { '\0' };
+    g_snprintf(interpolation_text, 128, _("Wave interpolation level %d"), interpolation_level + 1);
+    dh_draw_text_with_size(gc, interpolation_text, interpolation_text_x, interpolation_text_y, 13);
+  }
+}
+
+//! Draws the points of the silence wave and returns the interpolation level used
+static gint draw_silence_wave_points(gint left_mark, gint right_mark, 
+    gfloat draw_time, gint width_drawing_area, gint y_margin,
+    gfloat current_time, gfloat total_time, gfloat zoom_coeff, 
+    cairo_t *gc, ui_state *ui)
+{
+  GdkColor color;
 
   double dashes[] = { 1.0, 3.0 };
   cairo_set_dash(gc, dashes, 0, 0.0);
@@ -1991,9 +2389,41 @@ gint draw_silence_wave(gint left_mark, gint right_mark,
   color.red = 0;color.green = 0;color.blue = 0;
   dh_set_color(gc, &color);
 
+  gint first_point =
+    splt_wave_find_first_point(ui->infos->silence_points, ui->infos->number_of_silence_points,
+        left_mark);
+  gint last_point =
+    splt_wave_find_first_point(ui->infos->silence_points, ui->infos->number_of_silence_points,
+        (long) right_mark + 1) - 1;
+  gint number_of_visible_points = last_point - first_point + 1;
+
+  gint maximum_number_of_points = width_drawing_area * SILENCE_WAVE_MAXIMUM_POINTS_PER_PIXEL;
+  if (maximum_number_of_points < ui->infos->silence_wave_number_of_points_threshold)
+  {
+    maximum_number_of_points = ui->infos->silence_wave_number_of_points_threshold;
+  }
+
+  if (ui->infos->silence_wave_pyramid && number_of_visible_points > maximum_number_of_points)
+  {
+    draw_silence_wave_summary(left_mark, right_mark, width_drawing_area, y_margin,
+        current_time, total_time, zoom_coeff, gc, ui);
+
+    if (ui->status->previous_interpolation_level != SILENCE_WAVE_SUMMARY_LEVEL)
+    {
+      clear_previous_distances(ui);
+    }
+    ui->status->previous_interpolation_level = SILENCE_WAVE_SUMMARY_LEVEL;
+
+    return SILENCE_WAVE_SUMMARY_LEVEL;
+  }
+
   gint filtered_index = get_silence_filtered_presence_index(draw_time, ui->infos);
   gint interpolation_level = 
-    adjust_filtered_index_according_to_number_of_points(filtered_index, left_mark, right_mark, ui);
+    adjust_filtered_index_according_to_number_of_points(filtered_index, first_point, last_point, ui);
+  if (!ui->infos->filtered_points_presence)
+  {
+    interpolation_level = -1;
+  }
 
   if (interpolation_level != ui->status->previous_interpolation_level)
   {
@@ -2010,7 +2440,7 @@ gint draw_silence_wave(gint left_mark, gint right_mark,
   gint max_y = 0;
   gint same_x_count = 1;
   gint previous_y = 0;
-  for (i = 0;i < ui->infos->number_of_silence_points;i++)
+  for (i = first_point;i <= last_point;i++)
   {
     if (interpolation_level >= 0 && point_is_filtered(i, interpolation_level, ui->infos))
     {
@@ -2018,18 +2448,13 @@ gint draw_silence_wave(gint left_mark, gint right_mark,
     }
 
     long time = ui->infos->silence_points[i].time;
-    if ((time > right_mark) || (time < left_mark)) 
-    {
-      continue;
-    }
-
     float level = ui->infos->silence_points[i].level;
 
     gint x = convert_time_to_pixels(width_drawing_area, (gfloat)time, current_time, 
         total_time, zoom_coeff, ui->infos);
     gint y = y_margin + (gint)floorf(level);
 
-    if (x != previous_x || i == ui->infos->number_of_silence_points - 1)
+    if (x != previous_x || i == last_point)
     {
       stroke_counter++;
 
@@ -2065,22 +2490,121 @@ gint draw_silence_wave(gint left_mark, gint right_mark,
 
   cairo_stroke(gc);
 
-  color.red = 0;color.green = 0;color.blue = 0;
-  dh_set_color(gc, &color);
+  return interpolation_level;
+}
 
-  if (interpolation_level < 0)
+//! Draws the silence wave
+gint draw_silence_wave(gint left_mark, gint right_mark, 
+    gint interpolation_text_x, gint interpolation_text_y,
+    gfloat draw_time, gint width_drawing_area, gint y_margin,
+    gfloat current_time, gfloat total_time, gfloat zoom_coeff, 
+    GtkWidget *da, cairo_t *gc, ui_state *ui)
+{
+  if (!ui->infos->silence_points)
   {
-    dh_draw_text_with_size(gc,_("No wave interpolation"), 
+    GdkColor color;
+    color.red = 0;color.green = 0;color.blue = 0;
+    dh_set_color(gc, &color);
+    dh_draw_text_with_size(gc,_("No available wave"), 
         interpolation_text_x, interpolation_text_y, 13);
+    return -1;
   }
-  else
+
+  gint interpolation_level = draw_silence_wave_points(left_mark, right_mark,
+      draw_time, width_drawing_area, y_margin, current_time, total_time, zoom_coeff, gc, ui);
+
+  draw_silence_wave_level_text(interpolation_level, interpolation_text_x, interpolation_text_y, gc);
+
+  return interpolation_level;
+}
+
+static gboolean silence_wave_layer_is_valid(drawing_layer *layer, gint width, gint height,
+    gfloat shift, ui_infos *infos)
+{
+  return layer->surface != NULL &&
+    layer->width == width &&
+    layer->height == height &&
+    double_equals(layer->zoom_coeff, infos->zoom_coeff) &&
+    double_equals(layer->total_time, infos->total_time) &&
+    layer->version == infos->silence_wave_version &&
+    layer->points_threshold == infos->silence_wave_number_of_points_threshold &&
+    fabs(shift) <= width;
+}
+
+/*! Draws the silence wave layer three widths wide, centered on the current time
+
+The points are drawn with the same number of pixels per hundreth of second as
+on the screen, so that the layer only needs to be drawn again when the wave
+changes or when the player moves more than one width away.
+*/
+static void render_silence_wave_layer(drawing_layer *layer, gint width, gint height,
+    gint y_top, gfloat draw_time, GtkWidget *da, ui_state *ui)
+{
+  ui_infos *infos = ui->infos;
+
+  if (layer->surface)
   {
-    gchar interpolation_text[128] = { '\0' };
-    g_snprintf(interpolation_text, 128, _("Wave interpolation level %d"), interpolation_level + 1);
-    dh_draw_text_with_size(gc, interpolation_text, interpolation_text_x, interpolation_text_y, 13);
+    cairo_surface_destroy(layer->surface);
   }
 
-  return interpolation_level;
+  layer->surface = gdk_window_create_similar_surface(gtk_widget_get_window(da),
+      CAIRO_CONTENT_COLOR_ALPHA, width * 3, height);
+  layer->width = width;
+  layer->height = height;
+  layer->zoom_coeff = infos->zoom_coeff;
+  layer->total_time = infos->total_time;
+  layer->version = infos->silence_wave_version;
+  layer->points_threshold = infos->silence_wave_number_of_points_threshold;
+  layer->drawn_time = infos->current_time;
+
+  gfloat layer_zoom_coeff = infos->zoom_coeff / 3.0;
+  gfloat left_time = get_left_drawing_time(layer->drawn_time, infos->total_time, layer_zoom_coeff);
+  gfloat right_time = get_right_drawing_time(layer->drawn_time, infos->total_time, layer_zoom_coeff);
+  gint left_mark = left_time < 0 ? 0 : (gint) left_time;
+  gint right_mark = right_time > infos->total_time ? (gint) infos->total_time : (gint) right_time;
+
+  cairo_t *cr = cairo_create(layer->surface);
+  cairo_translate(cr, 0, -y_top);
+
+  infos->drawing_silence_wave_layer = TRUE;
+  layer->drawn_value = draw_silence_wave_points(left_mark, right_mark, draw_time,
+      width * 3, y_top, layer->drawn_time, infos->total_time, layer_zoom_coeff, cr, ui);
+  infos->drawing_silence_wave_layer = FALSE;
+
+  cairo_destroy(cr);
+}
+
+//! Draws the silence wave from its layer, drawing the layer again if needed
+static void draw_cached_silence_wave(gfloat draw_time, GtkWidget *da, cairo_t *gc, ui_state *ui)
+{
+  gui_state *gui = ui->gui;
+  ui_infos *infos = ui->infos;
+  drawing_layer *layer = &gui->silence_wave_layer;
+
+  gint width = infos->width_drawing_area;
+  gint y_top = gui->text_ypos + gui->margin;
+  gint height = gui->wave_ypos - y_top;
+  if (width <= 0 || height <= 0)
+  {
+    return;
+  }
+
+  gfloat shift = time_to_pixels_float(width, layer->drawn_time - infos->current_time,
+      infos->total_time, infos->zoom_coeff);
+  if (!silence_wave_layer_is_valid(layer, width, height, shift, infos))
+  {
+    render_silence_wave_layer(layer, width, height, y_top, draw_time, da, ui);
+    shift = 0;
+  }
+
+  cairo_save(gc);
+  cairo_set_source_surface(gc, layer->surface, -width + roundf(shift), y_top);
+  cairo_rectangle(gc, 0, y_top, width, height);
+  cairo_fill(gc);
+  cairo_restore(gc);
+
+  draw_silence_wave_level_text(layer->drawn_value,
+      width / 2 + 3, gui->wave_ypos - gui->margin * 4, gc);
 }
 
 void clear_previous_distances(ui_state *ui)
@@ -2154,19 +2678,6 @@ static gboolean da_draw_event(GtkWidget *da, cairo_t *gc, ui_state *ui)
     return TRUE;
   }
 
-  //on a slow hardware, this improves a lot the computing performance
-  if (status->currently_compute_douglas_peucker_filters)
-  {
-    GdkColor mycolor;
-    mycolor.red = 255 * 0; mycolor.green = 255 * 0; mycolor.blue = 255 * 255;
-    dh_set_color(gc, &mycolor);
-    dh_draw_text_with_size(gc, _(" Please wait ... currently computing Douglas Peucker filters."),
-        30, gui->margin - 3, 13);
-
-    set_process_in_progress_safe(FALSE, ui);
-    return TRUE;
-  }
-
   gint old_width_drawing_area = infos->width_drawing_area;
 
   int width = 0, height = 0;
@@ -2209,6 +2720,7 @@ static gboolean da_draw_event(GtkWidget *da, cairo_t *gc, ui_state *ui)
   {
     bottom_left_middle_right_text_ypos = gui->wave_ypos;
   }
+  gui->times_text_ypos = bottom_left_middle_right_text_ypos;
 
   gint nbr_chars = 0;
 
@@ -2472,12 +2984,19 @@ static gboolean da_draw_event(GtkWidget *da, cairo_t *gc, ui_state *ui)
   //silence wave
   if (status->show_silence_wave)
   {
-    draw_silence_wave(left_mark, right_mark, 
-        infos->width_drawing_area/2 + 3, gui->wave_ypos - gui->margin * 4,
-        total_draw_time, 
-        infos->width_drawing_area, gui->text_ypos + gui->margin,
-        infos->current_time, infos->total_time, infos->zoom_coeff,
-        da, gc, ui);
+    if (infos->silence_points && !get_currently_scanning_for_silence_safe(ui))
+    {
+      draw_cached_silence_wave(total_draw_time, da, gc, ui);
+    }
+    else
+    {
+      draw_silence_wave(left_mark, right_mark, 
+          infos->width_drawing_area/2 + 3, gui->wave_ypos - gui->margin * 4,
+          total_draw_time, 
+          infos->width_drawing_area, gui->text_ypos + gui->margin,
+          infos->current_time, infos->total_time, infos->zoom_coeff,
+          da, gc, ui);
+    }
 
     //silence wave middle line
     color.red = 255 * 255;color.green = 0;color.blue = 0;
@@ -3355,6 +3874,47 @@ static gint get_preview_end_time(ui_state *ui)
   return stop_splitpoint_time;
 }
 
+/*! Interval of the player timer
+
+The position is polled at the refresh rate only while playing; otherwise the
+timer only checks if the player is still there, and players notifying their
+changes of state wake it up with wake_up_player_timer.
+*/
+static guint get_player_timer_interval(gboolean paused, ui_state *ui)
+{
+  if (ui->status->playing && !paused)
+  {
+    return ui->infos->timeout_value;
+  }
+
+  if (player_notifies_state_changes(ui))
+  {
+    return PLAYER_IDLE_TIMEOUT_VALUE_WITH_EVENTS;
+  }
+
+  return PLAYER_IDLE_TIMEOUT_VALUE;
+}
+
+//! Starts the player timer or changes its interval
+static void schedule_player_timer(guint interval, ui_state *ui)
+{
+  gui_status *status = ui->status;
+
+  if (status->timer_active)
+  {
+    if (status->player_timer_interval == interval)
+    {
+      return;
+    }
+
+    g_source_remove(status->timeout_id);
+  }
+
+  status->player_timer_interval = interval;
+  status->timeout_id = g_timeout_add(interval, (GSourceFunc)mytimer, ui);
+  status->timer_active = TRUE;
+}
+
 /*! timer used to print infos about the song
 
 Examples are the elapsed time and if it uses variable bitrate
@@ -3364,6 +3924,10 @@ static gint mytimer(ui_state *ui)
 #ifdef __WIN32__
   if (get_process_in_progress_safe(ui))
   {
+    if (ui->status->timer_active)
+    {
+      schedule_player_timer(ui->infos->timeout_value, ui);
+    }
     return TRUE;
   }
 #endif
@@ -3400,6 +3964,8 @@ static gint mytimer(ui_state *ui)
 
   gtk_widget_set_sensitive(gui->silence_wave_check_button, TRUE);
 
+  gboolean paused = FALSE;
+
   if (status->playing)
   {
     if (player_get_playlist_number(ui) > -1)
@@ -3463,7 +4029,8 @@ static gint mytimer(ui_state *ui)
       reset_label_time(gui);
     }
 
-    if (player_is_paused(ui))
+    paused = player_is_paused(ui);
+    if (paused)
     {
       status->only_press_pause = TRUE;
       gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(gui->pause_button), TRUE);
@@ -3520,6 +4087,11 @@ static gint mytimer(ui_state *ui)
     player_key_actions_set_sensitivity(FALSE, gui);
   }
 
+  if (status->timer_active)
+  {
+    schedule_player_timer(get_player_timer_interval(paused, ui), ui);
+  }
+
   set_process_in_progress_safe(FALSE, ui);
 
   return TRUE;
@@ -45,6 +45,14 @@
 
 #define DEFAULT_TIMEOUT_VALUE 200
 
+//! Milliseconds between two player timer events while nothing is playing
+#define PLAYER_IDLE_TIMEOUT_VALUE 1000
+//! Same, for players notifying their changes of state
+#define PLAYER_IDLE_TIMEOUT_VALUE_WITH_EVENTS 5000
+
+//! Height of the row of the times in the drawing area
+#define DRAWING_AREA_TIMES_TEXT_HEIGHT 18
+
 #define DEFAULT_GSTREAMER_STOP_BEFORE_END_VALUE 200
 
 #define DEFAULT_SMALL_SEEK_JUMP_VALUE 300
@@ -53,6 +61,13 @@
 
 #define DEFAULT_SILENCE_WAVE_NUMBER_OF_POINTS_THRESHOLD 4000
 
+//! Above this number of visible points per pixel, the wave min/max summary is drawn
+#define SILENCE_WAVE_MAXIMUM_POINTS_PER_PIXEL 32
+//! Returned by draw_silence_wave when drawing the min/max summary
+#define SILENCE_WAVE_SUMMARY_LEVEL -2
+//! Milliseconds between two readings of the points found by the silence scan
+#define SILENCE_WAVE_REFRESH_TIMEOUT 200
+
 //float comparison
 #define DELTA 5
 
@@ -88,6 +103,7 @@ void hide_connect_button(gui_state *gui);
 void show_connect_button(gui_state *gui);
 
 void restart_player_timer(ui_state *ui);
+void wake_up_player_timer(ui_state *ui);
 
 void compute_douglas_peucker_filters(ui_state *ui);
 
@@ -206,6 +206,24 @@ gchar *get_preferences_filename()
   return filename;
 }
 
+/*! Get the directory of the silence wave cache and creates it if needed
+
+\attention directory returned must be freed after
+*/
+gchar *get_wave_cache_directory()
+{
+  gchar *mp3splt_dir_with_path = get_configuration_directory();
+  gchar *wave_cache_dir = g_build_filename(mp3splt_dir_with_path, "wave_cache", NULL);
+  g_free(mp3splt_dir_with_path);
+
+  if (!directory_exists(wave_cache_dir))
+  {
+    g_mkdir_with_parents(wave_cache_dir, 0700);
+  }
+
+  return wave_cache_dir;
+}
+
 /*! \brief Read the preferences from the preferences file.
  */
 void load_preferences(ui_state *ui)
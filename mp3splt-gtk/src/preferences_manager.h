@@ -38,6 +38,7 @@
 
 gchar *get_preferences_filename();
 gchar *get_configuration_directory();
+gchar *get_wave_cache_directory();
 void load_preferences(ui_state *ui);
 void save_preferences(ui_state *ui);
 
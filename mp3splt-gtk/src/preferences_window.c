@@ -442,6 +442,12 @@ static void bit_reservoir_event(GtkToggleButton *bit_reservoir, ui_state *ui)
   ui_save_preferences(NULL, ui);
 }
 
+static void update_split_jobs_concurrency(GtkWidget *spinner, ui_state *ui)
+{
+  ui->infos->split_jobs_concurrency = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(spinner));
+  ui_save_preferences(NULL, ui);
+}
+
 //! Creates the box for split mode selection
 static GtkWidget *create_split_options_box(ui_state *ui)
 {
@@ -576,6 +582,15 @@ static GtkWidget *create_split_options_box(ui_state *ui)
 
   disable_adjust_parameters(ui->gui);
 
+  //number of files split at the same time in batch mode
+  GtkWidget *split_jobs_concurrency =
+    wh_create_int_spinner_in_box(_("Split "), _("files at the same time in batch mode."),
+        (gdouble)DEFAULT_SPLIT_JOBS_CONCURRENCY, 1.0, (gdouble)MAX_SPLIT_JOBS_CONCURRENCY,
+        1.0, 2.0, NULL, update_split_jobs_concurrency, ui, vbox);
+  ui_register_spinner_int_preference("split", "batch_split_jobs",
+      DEFAULT_SPLIT_JOBS_CONCURRENCY, split_jobs_concurrency,
+      (void (*)(GtkWidget *, gpointer)) update_split_jobs_concurrency, ui, ui);
+
   //set default preferences button
   horiz_fake = wh_hbox_new();
   gtk_box_pack_start(GTK_BOX(vbox), horiz_fake, FALSE, FALSE, 0);
@@ -917,6 +932,10 @@ static void update_wave_preview_label_markup(gint index, gint interpolation_leve
     g_snprintf(interpolation_text, 256, _("Wave interpolation level %d with threshold of %.1lf"),
         interpolation_level + 1, ui->infos->douglas_peucker_thresholds[interpolation_level]);
   }
+  else if (interpolation_level == SILENCE_WAVE_SUMMARY_LEVEL)
+  {
+    g_snprintf(interpolation_text, 256, _("Wave min/max summary"));
+  }
   else {
     g_snprintf(interpolation_text, 256, _("No wave interpolation"));
   }
@@ -0,0 +1,158 @@
+/**********************************************************
+ *
+ *                for mp3/ogg splitting without decoding
+ * mp3splt-gtk -- utility based on mp3splt,
+ *
+ * Copyright: (C) 2005-2014 Alexandru Munteanu
+ * Contact: m@ioalex.net
+ *
+ * http://mp3splt.sourceforge.net/
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ *********************************************************/
+/*!********************************************************
+ * \file 
+ * Ring buffer of the split preview bytes
+ *
+ * The split preview is split in pretend mode: the bytes that would have been
+ * written are pushed in this buffer by the splitting thread and read by the
+ * player, so that nothing is written on the disk.
+ **********************************************************/
+
+#include "preview_buffer.h"
+
+preview_buffer *splt_preview_buffer_new(gsize capacity)
+{
+  preview_buffer *buffer = g_malloc0(sizeof(preview_buffer));
+
+  buffer->bytes = g_malloc(capacity);
+  buffer->capacity = capacity;
+  buffer->ref_count = 1;
+  g_mutex_init(&buffer->mutex);
+  g_cond_init(&buffer->cond);
+
+  return buffer;
+}
+
+preview_buffer *splt_preview_buffer_ref(preview_buffer *buffer)
+{
+  g_atomic_int_inc(&buffer->ref_count);
+  return buffer;
+}
+
+void splt_preview_buffer_unref(preview_buffer *buffer)
+{
+  if (!buffer || !g_atomic_int_dec_and_test(&buffer->ref_count))
+  {
+    return;
+  }
+
+  g_mutex_clear(&buffer->mutex);
+  g_cond_clear(&buffer->cond);
+  g_free(buffer->bytes);
+  g_free(buffer);
+}
+
+/*! Appends bytes, waiting for the reader while the buffer is full
+
+\return FALSE if the buffer has been cancelled by the reader
+*/
+gboolean splt_preview_buffer_write(preview_buffer *buffer, const void *ptr, gsize size)
+{
+  const guchar *bytes = ptr;
+
+  g_mutex_lock(&buffer->mutex);
+
+  while (size > 0 && !buffer->cancelled)
+  {
+    gsize free_space = buffer->capacity - (gsize)(buffer->tail - buffer->head);
+    if (free_space == 0)
+    {
+      g_cond_wait(&buffer->cond, &buffer->mutex);
+      continue;
+    }
+
+    gsize offset = buffer->tail % buffer->capacity;
+    gsize length = MIN(size, MIN(free_space, buffer->capacity - offset));
+    memcpy(buffer->bytes + offset, bytes, length);
+
+    buffer->tail += length;
+    bytes += length;
+    size -= length;
+
+    g_cond_broadcast(&buffer->cond);
+  }
+
+  gboolean cancelled = buffer->cancelled;
+  g_mutex_unlock(&buffer->mutex);
+
+  return !cancelled;
+}
+
+/*! Reads at most size bytes, waiting for the writer while the buffer is empty
+
+\return The number of bytes read; 0 once the writer has finished and all
+the bytes have been read, or if the buffer has been cancelled
+*/
+gsize splt_preview_buffer_read(preview_buffer *buffer, guchar *destination, gsize size)
+{
+  g_mutex_lock(&buffer->mutex);
+
+  while (buffer->head == buffer->tail && !buffer->finished && !buffer->cancelled)
+  {
+    g_cond_wait(&buffer->cond, &buffer->mutex);
+  }
+
+  gsize length = 0;
+  if (!buffer->cancelled)
+  {
+    gsize offset = buffer->head % buffer->capacity;
+    gsize available = (gsize)(buffer->tail - buffer->head);
+    length = MIN(size, MIN(available, buffer->capacity - offset));
+    memcpy(destination, buffer->bytes + offset, length);
+
+    buffer->head += length;
+    g_cond_broadcast(&buffer->cond);
+  }
+
+  g_mutex_unlock(&buffer->mutex);
+
+  return length;
+}
+
+//! Called by the writer when all the bytes have been written
+void splt_preview_buffer_finish(preview_buffer *buffer)
+{
+  g_mutex_lock(&buffer->mutex);
+  buffer->finished = TRUE;
+  g_cond_broadcast(&buffer->cond);
+  g_mutex_unlock(&buffer->mutex);
+}
+
+//! Wakes up and stops both sides, when the preview is not played anymore
+void splt_preview_buffer_cancel(preview_buffer *buffer)
+{
+  g_mutex_lock(&buffer->mutex);
+  buffer->cancelled = TRUE;
+  g_cond_broadcast(&buffer->cond);
+  g_mutex_unlock(&buffer->mutex);
+}
+
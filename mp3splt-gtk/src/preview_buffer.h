@@ -0,0 +1,48 @@
+/**********************************************************
+ *
+ * mp3splt-gtk -- utility based on mp3splt,
+ *                for mp3/ogg splitting without decoding
+ *
+ * Copyright (c) 2005-2014 Alexandru Munteanu - m@ioalex.net
+ *
+ * http://mp3splt.sourceforge.net/
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ *********************************************************/
+
+#ifndef PREVIEW_BUFFER_H
+#define PREVIEW_BUFFER_H
+
+#include "external_includes.h"
+#include "ui_types.h"
+
+preview_buffer *splt_preview_buffer_new(gsize capacity);
+preview_buffer *splt_preview_buffer_ref(preview_buffer *buffer);
+void splt_preview_buffer_unref(preview_buffer *buffer);
+
+gboolean splt_preview_buffer_write(preview_buffer *buffer, const void *ptr, gsize size);
+gsize splt_preview_buffer_read(preview_buffer *buffer, guchar *destination, gsize size);
+
+void splt_preview_buffer_finish(preview_buffer *buffer);
+void splt_preview_buffer_cancel(preview_buffer *buffer);
+
+#endif
+
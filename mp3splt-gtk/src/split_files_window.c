@@ -47,6 +47,15 @@ enum
   SPLIT_COLUMNS
 };
 
+//!batch split jobs enumeration
+enum
+{
+  JOB_COL_NAME,
+  JOB_COL_PROGRESS,
+  JOB_COL_STATUS,
+  JOB_COLUMNS
+};
+
 //!creates the model for the split tree
 static GtkTreeModel *create_split_model()
 {
@@ -100,6 +109,158 @@ const gchar *get_real_name_from_filename(const gchar *filename)
   return fname;
 }
 
+//!creates the tree of the files being split in batch mode
+static GtkTreeView *create_split_jobs_tree()
+{
+  GtkListStore *model =
+    gtk_list_store_new(JOB_COLUMNS, G_TYPE_STRING, G_TYPE_INT, G_TYPE_STRING);
+  return GTK_TREE_VIEW(gtk_tree_view_new_with_model(GTK_TREE_MODEL(model)));
+}
+
+//!creates the columns of the batch split jobs tree
+static void create_split_jobs_columns(GtkTreeView *split_jobs_tree)
+{
+  GtkCellRenderer *renderer = gtk_cell_renderer_text_new();
+  GtkTreeViewColumn *name_column = gtk_tree_view_column_new_with_attributes
+    (_("Input file"), renderer, "text", JOB_COL_NAME, NULL);
+  gtk_tree_view_column_set_resizable(name_column, TRUE);
+  gtk_tree_view_column_set_expand(name_column, TRUE);
+  gtk_tree_view_append_column(split_jobs_tree, name_column);
+
+  renderer = gtk_cell_renderer_progress_new();
+  GtkTreeViewColumn *progress_column = gtk_tree_view_column_new_with_attributes
+    (_("Progress"), renderer, "value", JOB_COL_PROGRESS, NULL);
+  gtk_tree_view_column_set_min_width(progress_column, 120);
+  gtk_tree_view_append_column(split_jobs_tree, progress_column);
+
+  renderer = gtk_cell_renderer_text_new();
+  GtkTreeViewColumn *status_column = gtk_tree_view_column_new_with_attributes
+    (_("Status"), renderer, "text", JOB_COL_STATUS, NULL);
+  gtk_tree_view_column_set_resizable(status_column, TRUE);
+  gtk_tree_view_append_column(split_jobs_tree, status_column);
+}
+
+//!removes the rows of the previous batch split and hides the jobs box
+void remove_all_split_job_rows(ui_state *ui)
+{
+  GtkTreeModel *model = gtk_tree_view_get_model(ui->gui->split_jobs_tree);
+  gtk_list_store_clear(GTK_LIST_STORE(model));
+  ui->status->split_jobs_finished = 0;
+
+  gtk_widget_hide(ui->gui->split_jobs_box);
+}
+
+//!adds the row of an input file of the batch split
+void add_split_job_row(const gchar *filename, ui_state *ui)
+{
+  GtkTreeIter iter;
+  GtkTreeModel *model = gtk_tree_view_get_model(ui->gui->split_jobs_tree);
+  gtk_list_store_append(GTK_LIST_STORE(model), &iter);
+
+  gtk_list_store_set(GTK_LIST_STORE(model), &iter,
+      JOB_COL_NAME, get_real_name_from_filename(filename),
+      JOB_COL_PROGRESS, 0,
+      JOB_COL_STATUS, _("waiting"), -1);
+
+  gtk_widget_show(ui->gui->split_jobs_box);
+}
+
+/*! updates the row of an input file of the batch split
+
+\param status The new status text, or NULL to keep the current one
+*/
+void set_split_job_row_progress(gint index, gint percent, const gchar *status, ui_state *ui)
+{
+  GtkTreeModel *model = gtk_tree_view_get_model(ui->gui->split_jobs_tree);
+
+  GtkTreeIter iter;
+  if (!gtk_tree_model_iter_nth_child(model, &iter, NULL, index))
+  {
+    return;
+  }
+
+  gtk_list_store_set(GTK_LIST_STORE(model), &iter, JOB_COL_PROGRESS, percent, -1);
+  if (status != NULL)
+  {
+    gtk_list_store_set(GTK_LIST_STORE(model), &iter, JOB_COL_STATUS, status, -1);
+  }
+}
+
+gint get_number_of_split_job_rows(ui_state *ui)
+{
+  GtkTreeModel *model = gtk_tree_view_get_model(ui->gui->split_jobs_tree);
+  return gtk_tree_model_iter_n_children(model, NULL);
+}
+
+//!cancels the selected input files of the batch split
+static void cancel_split_job_button_event(GtkWidget *widget, ui_state *ui)
+{
+  GtkTreeModel *model = gtk_tree_view_get_model(ui->gui->split_jobs_tree);
+  GtkTreeSelection *selection = gtk_tree_view_get_selection(ui->gui->split_jobs_tree);
+  GList *selected_list = gtk_tree_selection_get_selected_rows(selection, &model);
+
+  GList *current_element = NULL;
+  for (current_element = selected_list; current_element != NULL;
+      current_element = g_list_next(current_element))
+  {
+    GtkTreePath *path = current_element->data;
+    gint *indices = gtk_tree_path_get_indices(path);
+    split_jobs_cancel(indices[0], ui);
+  }
+
+  g_list_foreach(selected_list, (GFunc)gtk_tree_path_free, NULL);
+  g_list_free(selected_list);
+}
+
+//!split jobs selection has changed
+static void split_jobs_selection_changed(GtkTreeSelection *selection, ui_state *ui)
+{
+  gtk_widget_set_sensitive(ui->gui->cancel_split_job_button,
+      gtk_tree_selection_count_selected_rows(selection) > 0);
+}
+
+//!creates the box with the progress of each input file of the batch split
+static GtkWidget *create_split_jobs_box(ui_state *ui)
+{
+  GtkWidget *vbox = wh_vbox_new();
+  ui->gui->split_jobs_box = vbox;
+
+  GtkTreeView *split_jobs_tree = create_split_jobs_tree();
+  ui->gui->split_jobs_tree = split_jobs_tree;
+  create_split_jobs_columns(split_jobs_tree);
+
+  GtkWidget *scrolled_window = gtk_scrolled_window_new(NULL, NULL);
+  gtk_scrolled_window_set_shadow_type(GTK_SCROLLED_WINDOW(scrolled_window), GTK_SHADOW_NONE);
+  gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scrolled_window),
+      GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+  gtk_widget_set_size_request(scrolled_window, -1, 120);
+  gtk_container_add(GTK_CONTAINER(scrolled_window), GTK_WIDGET(split_jobs_tree));
+  gtk_box_pack_start(GTK_BOX(vbox), scrolled_window, TRUE, TRUE, 0);
+
+  GtkTreeSelection *selection = gtk_tree_view_get_selection(split_jobs_tree);
+  gtk_tree_selection_set_mode(selection, GTK_SELECTION_MULTIPLE);
+  g_signal_connect(G_OBJECT(selection), "changed",
+      G_CALLBACK(split_jobs_selection_changed), ui);
+
+  GtkWidget *cancel_split_job_button =
+    wh_create_cool_button("process-stop", _("_Cancel selected"), FALSE);
+  ui->gui->cancel_split_job_button = cancel_split_job_button;
+  gtk_widget_set_sensitive(cancel_split_job_button, FALSE);
+  g_signal_connect(G_OBJECT(cancel_split_job_button), "clicked",
+      G_CALLBACK(cancel_split_job_button_event), ui);
+
+  GtkWidget *buttons_hbox = wh_hbox_new();
+  gtk_box_pack_end(GTK_BOX(buttons_hbox), cancel_split_job_button, FALSE, FALSE, 3);
+  gtk_box_pack_start(GTK_BOX(vbox), buttons_hbox, FALSE, FALSE, 3);
+
+  //only shown for batch splits
+  gtk_widget_show_all(scrolled_window);
+  gtk_widget_show_all(buttons_hbox);
+  gtk_widget_set_no_show_all(vbox, TRUE);
+
+  return vbox;
+}
+
 //!add a row to the table
 void add_split_row(const gchar *name, ui_state *ui)
 {
@@ -317,6 +478,8 @@ GtkWidget *create_split_files_frame(ui_state *ui)
   gtk_tree_selection_set_mode(GTK_TREE_SELECTION(split_tree_selection), GTK_SELECTION_MULTIPLE);
   
   create_queue_buttons(ui);
+
+  gtk_box_pack_start(GTK_BOX(vbox), create_split_jobs_box(ui), FALSE, FALSE, 0);
   
   return vbox;
 }
@@ -42,6 +42,10 @@
 
 void remove_all_split_rows(ui_state *ui);
 void add_split_row(const gchar *name, ui_state *ui);
+void remove_all_split_job_rows(ui_state *ui);
+void add_split_job_row(const gchar *filename, ui_state *ui);
+void set_split_job_row_progress(gint index, gint percent, const gchar *status, ui_state *ui);
+gint get_number_of_split_job_rows(ui_state *ui);
 void split_tree_row_activated(GtkTreeView *split_tree,
     GtkTreePath *arg1, GtkTreeViewColumn *arg2, ui_state *ui);
 GtkWidget *create_split_files_frame(ui_state *ui);
@@ -0,0 +1,467 @@
+/**********************************************************
+ *
+ * mp3splt-gtk -- utility based on mp3splt,
+ *                for mp3/ogg splitting without decoding
+ *
+ * Copyright: (C) 2005-2014 Alexandru Munteanu
+ * Contact: m@ioalex.net
+ *
+ * http://mp3splt.sourceforge.net/
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ *********************************************************/
+
+/*!********************************************************
+ * \file 
+ * Batch split of several files at the same time
+ *
+ * Each file of a batch split is a job pushed into a thread pool. The
+ * workers of the pool own their library state, so that several files are
+ * split in parallel; the progress of each file is shown in its own row of
+ * the split files tab.
+ **********************************************************/
+
+#include "split_jobs.h"
+
+static void free_worker_state(gpointer state)
+{
+  mp3splt_free_state((splt_state *) state);
+}
+
+//! Library state of the current worker thread, freed when the worker exits
+static GPrivate worker_state = G_PRIVATE_INIT(free_worker_state);
+
+static splt_state *get_worker_state(ui_state *ui)
+{
+  splt_state *state = g_private_get(&worker_state);
+  if (state != NULL)
+  {
+    return state;
+  }
+
+  gint err = SPLT_OK;
+  state = mp3splt_new_state(&err);
+  if (err < 0)
+  {
+    if (state) { mp3splt_free_state(state); }
+    return NULL;
+  }
+
+  //plugins errors are reported by the main state at startup
+  lmanager_init_state(state, ui);
+
+  g_private_set(&worker_state, state);
+
+  return state;
+}
+
+static void put_confirmation_in_idle(splt_state *state, gint error, ui_state *ui)
+{
+  char *error_from_library = mp3splt_get_strerror(state, error);
+  put_status_message_in_idle(error_from_library, ui);
+  if (error_from_library) { free(error_from_library); }
+}
+
+/*! Sets the options and the splitpoints of the split on a library state
+
+\param pat Splitpoints and tags to append in normal split mode; may be NULL
+*/
+void split_jobs_prepare_state(ui_for_split *ui_fs, splt_state *state, points_and_tags *pat)
+{
+  ui_state *ui = ui_fs->ui;
+
+  put_options_from_preferences_in_state(ui_fs, state);
+
+  mp3splt_set_int_option(state, SPLT_OPT_OUTPUT_FILENAMES, SPLT_OUTPUT_DEFAULT);
+  if (!ui_fs->is_checked_output_radio_box)
+  {
+    mp3splt_set_int_option(state, SPLT_OPT_OUTPUT_FILENAMES, SPLT_OUTPUT_FORMAT);
+  }
+
+  mp3splt_set_path_of_split(state, ui_fs->output_directory);
+
+  gint err = mp3splt_erase_all_splitpoints(state);
+  err = mp3splt_erase_all_tags(state);
+
+  gint split_mode = mp3splt_get_int_option(state, SPLT_OPT_SPLIT_MODE, &err);
+  put_confirmation_in_idle(state, err, ui);
+
+  err = mp3splt_set_oformat(state, ui_fs->output_format);
+
+  if (split_mode == SPLT_OPTION_NORMAL_MODE && ui_fs->split_file_mode == FILE_MODE_SINGLE)
+  {
+    mp3splt_set_int_option(state, SPLT_OPT_OUTPUT_FILENAMES, SPLT_OUTPUT_CUSTOM);
+  }
+
+  if (split_mode == SPLT_OPTION_NORMAL_MODE && pat != NULL)
+  {
+    gint i = 0;
+    for (i = 0;i < pat->splitpoints->len; i++)
+    {
+      splt_point *point = g_ptr_array_index(pat->splitpoints, i);
+      mp3splt_append_splitpoint(state, point);
+      splt_tags *tags = g_ptr_array_index(pat->tags, i);
+      mp3splt_append_tags(state, tags);
+    }
+
+    err = mp3splt_remove_tags_of_skippoints(state);
+    put_confirmation_in_idle(state, err, ui);
+  }
+}
+
+static gint import_splitpoints_of_file(ui_for_split *ui_fs, splt_state *state,
+    const gchar *filename)
+{
+  gint selected_split_mode = ui_fs->selected_split_mode;
+
+  gint err = SPLT_OK;
+  if (selected_split_mode == SELECTED_SPLIT_INTERNAL_SHEET)
+  {
+    err = mp3splt_import(state, PLUGIN_INTERNAL_IMPORT, filename);
+    put_confirmation_in_idle(state, err, ui_fs->ui);
+  }
+  else if ((selected_split_mode == SELECTED_SPLIT_CUE_FILE) ||
+      (selected_split_mode == SELECTED_SPLIT_CDDB_FILE))
+  {
+    gchar *cue_or_cddb = g_strdup(filename);
+    gchar *last_ext = g_strrstr(cue_or_cddb, ".");
+    if (last_ext) { *last_ext = '\0'; }
+
+    GString *cue_or_cddb_file = g_string_new(cue_or_cddb);
+    g_free(cue_or_cddb);
+
+    if (selected_split_mode == SELECTED_SPLIT_CUE_FILE)
+    {
+      g_string_append(cue_or_cddb_file, ".cue");
+      err = mp3splt_import(state, CUE_IMPORT, cue_or_cddb_file->str);
+    }
+    else
+    {
+      g_string_append(cue_or_cddb_file, ".cddb");
+      err = mp3splt_import(state, CDDB_IMPORT, cue_or_cddb_file->str);
+    }
+
+    put_confirmation_in_idle(state, err, ui_fs->ui);
+    g_string_free(cue_or_cddb_file, SPLT_TRUE);
+  }
+
+  return err;
+}
+
+/*! Splits one file with a library state prepared by split_jobs_prepare_state
+
+In batch mode, the splitpoints are first imported from the file itself or
+from the cue or cddb file next to it, depending on the split mode.
+
+\return The error code of the split or of the import
+*/
+gint split_jobs_split_file(ui_for_split *ui_fs, splt_state *state, gchar *filename)
+{
+  ui_state *ui = ui_fs->ui;
+
+  print_processing_file(filename, ui);
+
+  mp3splt_set_filename_to_split(state, filename);
+
+  gint err = SPLT_OK;
+  if (ui_fs->split_file_mode != FILE_MODE_SINGLE)
+  {
+    err = import_splitpoints_of_file(ui_fs, state, filename);
+    if (err < 0) { return err; }
+  }
+
+  err = mp3splt_split(state);
+  put_confirmation_in_idle(state, err, ui);
+
+  gint erase_err = mp3splt_erase_all_tags(state);
+  put_confirmation_in_idle(state, erase_err, ui);
+
+  erase_err = mp3splt_erase_all_splitpoints(state);
+  put_confirmation_in_idle(state, erase_err, ui);
+
+  return err;
+}
+
+static gboolean split_job_progress_idle(ui_with_job_progress *ui_jp)
+{
+  ui_state *ui = ui_jp->ui;
+
+  set_split_job_row_progress(ui_jp->index, ui_jp->percent, ui_jp->status, ui);
+
+  if (ui_jp->finished)
+  {
+    ui->status->split_jobs_finished++;
+
+    gint total = get_number_of_split_job_rows(ui);
+    if (total > 0)
+    {
+      gchar progress_text[1024] = " ";
+      g_snprintf(progress_text, 1023, _(" %d of %d files split"),
+          ui->status->split_jobs_finished, total);
+
+      gtk_progress_bar_set_fraction(ui->gui->percent_progress_bar,
+          (gdouble) ui->status->split_jobs_finished / total);
+      gtk_progress_bar_set_text(ui->gui->percent_progress_bar, progress_text);
+    }
+  }
+
+  if (ui_jp->status) { g_free(ui_jp->status); }
+  g_free(ui_jp);
+
+  return FALSE;
+}
+
+//! Takes ownership of \p status; a NULL status leaves the status column unchanged
+static void put_job_progress_in_idle(split_job *job, gint percent, gchar *status,
+    gboolean finished)
+{
+  ui_with_job_progress *ui_jp = g_malloc0(sizeof(ui_with_job_progress));
+  ui_jp->ui = job->ui;
+  ui_jp->index = job->index;
+  ui_jp->percent = percent;
+  ui_jp->status = status;
+  ui_jp->finished = finished;
+
+  add_idle(G_PRIORITY_HIGH_IDLE, (GSourceFunc)split_job_progress_idle, ui_jp, NULL);
+}
+
+//! The library clears the stop flag when the split starts: stop again if needed
+static void stop_split_if_cancelled(split_job *job)
+{
+  lock_mutex(&job->ui->variables_mutex);
+  if (job->cancelled && job->state)
+  {
+    mp3splt_stop_split(job->state);
+  }
+  unlock_mutex(&job->ui->variables_mutex);
+}
+
+//! Progress of the library for one job; only whole percents reach the gui
+static void split_job_progress(splt_progress *p_bar, void *data)
+{
+  split_job *job = (split_job *) data;
+
+  float percent_progress = mp3splt_progress_get_percent_progress(p_bar);
+  gint max_splits = mp3splt_progress_get_max_splits(p_bar);
+  gint current_split = mp3splt_progress_get_current_split(p_bar);
+
+  gint percent = (gint) (percent_progress * 100);
+  if (max_splits > 0 && current_split > 0)
+  {
+    percent = (gint) (((current_split - 1) + percent_progress) * 100 / max_splits);
+  }
+  percent = CLAMP(percent, 0, 100);
+
+  if (percent == job->last_percent)
+  {
+    return;
+  }
+  job->last_percent = percent;
+
+  stop_split_if_cancelled(job);
+
+  put_job_progress_in_idle(job, percent, NULL, FALSE);
+}
+
+static void split_job_run(split_job *job, gpointer data)
+{
+  ui_state *ui = job->ui;
+
+  splt_state *state = get_worker_state(ui);
+
+  lock_mutex(&ui->variables_mutex);
+  gboolean cancelled = job->cancelled;
+  if (!cancelled)
+  {
+    job->state = state;
+  }
+  unlock_mutex(&ui->variables_mutex);
+
+  if (cancelled)
+  {
+    put_job_progress_in_idle(job, 0, g_strdup(_("cancelled")), TRUE);
+    return;
+  }
+
+  if (state == NULL)
+  {
+    job->err = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+    put_job_progress_in_idle(job, 0, g_strdup(_("error: cannot allocate memory")), TRUE);
+    return;
+  }
+
+  mp3splt_set_progress_function(state, split_job_progress, job);
+  mp3splt_set_int_option(state, SPLT_OPT_DEBUG_MODE, ui->infos->debug_is_active);
+
+  put_job_progress_in_idle(job, 0, g_strdup(_("splitting")), FALSE);
+
+  split_jobs_prepare_state(job->ui_fs, state, job->pat);
+  gint err = split_jobs_split_file(job->ui_fs, state, job->filename);
+  job->err = err;
+
+  lock_mutex(&ui->variables_mutex);
+  job->state = NULL;
+  cancelled = job->cancelled;
+  unlock_mutex(&ui->variables_mutex);
+
+  gchar *status = NULL;
+  if (cancelled)
+  {
+    status = g_strdup(_("cancelled"));
+  }
+  else
+  {
+    char *error_from_library = mp3splt_get_strerror(state, err);
+    status = g_strdup(error_from_library ? error_from_library : "");
+    if (error_from_library) { free(error_from_library); }
+  }
+
+  gint percent = job->last_percent;
+  if (err >= 0 && !cancelled)
+  {
+    percent = 100;
+  }
+
+  put_job_progress_in_idle(job, percent, status, TRUE);
+}
+
+/*! Splits all the files of a batch split, ui_fs->split_jobs_concurrency at a time
+
+Must be called from the split thread; returns when all the files have been
+split or cancelled.
+
+\return The last error of the jobs, or SPLT_OK
+*/
+gint split_jobs_run(ui_for_split *ui_fs, GPtrArray *files_to_split)
+{
+  ui_state *ui = ui_fs->ui;
+
+  GPtrArray *jobs = g_ptr_array_new();
+
+  gint i = 0;
+  for (i = 0;i < files_to_split->len;i++)
+  {
+    split_job *job = g_malloc0(sizeof(split_job));
+    job->ui = ui;
+    job->ui_fs = ui_fs;
+    job->index = i;
+    job->filename = g_strdup(g_ptr_array_index(files_to_split, i));
+    //appended splitpoints are only used by the first file, as for the sequential split
+    job->pat = (i == 0) ? ui_fs->pat : NULL;
+    job->state = NULL;
+    job->cancelled = FALSE;
+    job->last_percent = -1;
+    job->err = SPLT_OK;
+
+    g_ptr_array_add(jobs, job);
+  }
+
+  lock_mutex(&ui->variables_mutex);
+  ui->split_jobs = jobs;
+  unlock_mutex(&ui->variables_mutex);
+
+  gint concurrency = MAX(ui_fs->split_jobs_concurrency, 1);
+
+  GError *error = NULL;
+  GThreadPool *pool =
+    g_thread_pool_new((GFunc)split_job_run, NULL, concurrency, TRUE, &error);
+  if (pool != NULL)
+  {
+    for (i = 0;i < jobs->len;i++)
+    {
+      g_thread_pool_push(pool, g_ptr_array_index(jobs, i), NULL);
+    }
+
+    g_thread_pool_free(pool, FALSE, TRUE);
+  }
+  else
+  {
+    if (error)
+    {
+      put_status_message_in_idle(error->message, ui);
+      g_error_free(error);
+    }
+
+    //no worker could be started: split the files one after the other
+    for (i = 0;i < jobs->len;i++)
+    {
+      split_job_run(g_ptr_array_index(jobs, i), NULL);
+    }
+  }
+
+  lock_mutex(&ui->variables_mutex);
+  ui->split_jobs = NULL;
+  unlock_mutex(&ui->variables_mutex);
+
+  gint err = SPLT_OK;
+  for (i = 0;i < jobs->len;i++)
+  {
+    split_job *job = g_ptr_array_index(jobs, i);
+    if (job->err < 0) { err = job->err; }
+
+    g_free(job->filename);
+    g_free(job);
+  }
+  g_ptr_array_free(jobs, TRUE);
+
+  return err;
+}
+
+//! Must be called with ui->variables_mutex locked
+static void cancel_job(split_job *job)
+{
+  job->cancelled = TRUE;
+  if (job->state)
+  {
+    mp3splt_stop_split(job->state);
+  }
+}
+
+//! Cancels one file of the batch split in progress
+void split_jobs_cancel(gint index, ui_state *ui)
+{
+  lock_mutex(&ui->variables_mutex);
+
+  if (ui->split_jobs && index >= 0 && index < ui->split_jobs->len)
+  {
+    cancel_job(g_ptr_array_index(ui->split_jobs, index));
+  }
+
+  unlock_mutex(&ui->variables_mutex);
+}
+
+//! Cancels the running files and the files not yet started of the batch split
+void split_jobs_cancel_all(ui_state *ui)
+{
+  lock_mutex(&ui->variables_mutex);
+
+  if (ui->split_jobs)
+  {
+    gint i = 0;
+    for (i = 0;i < ui->split_jobs->len;i++)
+    {
+      cancel_job(g_ptr_array_index(ui->split_jobs, i));
+    }
+  }
+
+  unlock_mutex(&ui->variables_mutex);
+}
+
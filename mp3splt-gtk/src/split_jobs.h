@@ -0,0 +1,50 @@
+/**********************************************************
+ *
+ * mp3splt-gtk -- utility based on mp3splt,
+ *                for mp3/ogg splitting without decoding
+ *
+ * Copyright: (C) 2005-2014 Alexandru Munteanu
+ * Contact: m@ioalex.net
+ *
+ * http://mp3splt.sourceforge.net/
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ *********************************************************/
+
+#ifndef SPLIT_JOBS_H
+
+#define SPLIT_JOBS_H
+
+#include "all_includes.h"
+
+#define DEFAULT_SPLIT_JOBS_CONCURRENCY 1
+#define MAX_SPLIT_JOBS_CONCURRENCY 16
+
+void split_jobs_prepare_state(ui_for_split *ui_fs, splt_state *state, points_and_tags *pat);
+gint split_jobs_split_file(ui_for_split *ui_fs, splt_state *state, gchar *filename);
+
+gint split_jobs_run(ui_for_split *ui_fs, GPtrArray *files_to_split);
+
+void split_jobs_cancel(gint index, ui_state *ui);
+void split_jobs_cancel_all(ui_state *ui);
+
+#endif
+
@@ -0,0 +1,131 @@
+/**********************************************************
+ *
+ *                for mp3/ogg splitting without decoding
+ * mp3splt-gtk -- utility based on mp3splt,
+ *
+ * Copyright: (C) 2005-2014 Alexandru Munteanu
+ * Contact: m@ioalex.net
+ *
+ * http://mp3splt.sourceforge.net/
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ *********************************************************/
+/*!********************************************************
+ * \file 
+ * Lookups in the splitpoints of the splitpoints table
+ *
+ * The splitpoints array is kept ordered by time, so that a splitpoint can be
+ * found or inserted with a binary search. The descriptions of the rows are
+ * counted in a hash table, to check the unicity of a description without
+ * scanning all the rows of the table.
+ **********************************************************/
+
+#include "splitpoints_model.h"
+
+//! Returns the time of a splitpoint in hundreths of seconds
+gint splt_splitpoint_get_time(const Split_point *point)
+{
+  return point->mins * 6000 + point->secs * 100 + point->hundr_secs;
+}
+
+/*! Returns the index of the first splitpoint not before time
+
+\param found Set to TRUE if the splitpoint at the returned index has exactly
+this time
+*/
+gint splt_splitpoints_find_index(GArray *splitpoints, gint time, gboolean *found)
+{
+  gint first = 0;
+  gint last = splitpoints->len;
+
+  while (first < last)
+  {
+    gint middle = first + (last - first) / 2;
+    if (splt_splitpoint_get_time(&g_array_index(splitpoints, Split_point, middle)) < time)
+    {
+      first = middle + 1;
+    }
+    else
+    {
+      last = middle;
+    }
+  }
+
+  if (found)
+  {
+    *found = (first < splitpoints->len) &&
+      (splt_splitpoint_get_time(&g_array_index(splitpoints, Split_point, first)) == time);
+  }
+
+  return first;
+}
+
+//! Returns a new table counting the rows having each description
+GHashTable *splt_descriptions_new()
+{
+  return g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+}
+
+void splt_descriptions_free(GHashTable **descriptions)
+{
+  if (!descriptions || !*descriptions)
+  {
+    return;
+  }
+
+  g_hash_table_destroy(*descriptions);
+  *descriptions = NULL;
+}
+
+void splt_descriptions_add(GHashTable *descriptions, const gchar *description)
+{
+  if (description == NULL)
+  {
+    return;
+  }
+
+  gint count = splt_descriptions_count(descriptions, description);
+  g_hash_table_replace(descriptions, g_strdup(description), GINT_TO_POINTER(count + 1));
+}
+
+void splt_descriptions_remove(GHashTable *descriptions, const gchar *description)
+{
+  if (description == NULL)
+  {
+    return;
+  }
+
+  gint count = splt_descriptions_count(descriptions, description);
+  if (count <= 1)
+  {
+    g_hash_table_remove(descriptions, description);
+    return;
+  }
+
+  g_hash_table_replace(descriptions, g_strdup(description), GINT_TO_POINTER(count - 1));
+}
+
+//! Returns the number of rows having this description
+gint splt_descriptions_count(GHashTable *descriptions, const gchar *description)
+{
+  return GPOINTER_TO_INT(g_hash_table_lookup(descriptions, description));
+}
+
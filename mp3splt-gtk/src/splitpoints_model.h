@@ -0,0 +1,47 @@
+/**********************************************************
+ *
+ * mp3splt-gtk -- utility based on mp3splt,
+ *                for mp3/ogg splitting without decoding
+ *
+ * Copyright (c) 2005-2014 Alexandru Munteanu - m@ioalex.net
+ *
+ * http://mp3splt.sourceforge.net/
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ *********************************************************/
+
+#ifndef SPLITPOINTS_MODEL_H
+#define SPLITPOINTS_MODEL_H
+
+#include "external_includes.h"
+#include "ui_types.h"
+
+gint splt_splitpoint_get_time(const Split_point *point);
+gint splt_splitpoints_find_index(GArray *splitpoints, gint time, gboolean *found);
+
+GHashTable *splt_descriptions_new();
+void splt_descriptions_free(GHashTable **descriptions);
+void splt_descriptions_add(GHashTable *descriptions, const gchar *description);
+void splt_descriptions_remove(GHashTable *descriptions, const gchar *description);
+gint splt_descriptions_count(GHashTable *descriptions, const gchar *description);
+
+#endif
+
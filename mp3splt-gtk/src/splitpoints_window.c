@@ -43,44 +43,13 @@
 static gboolean check_if_splitpoint_does_not_exists(gint minutes, gint seconds, gint hundr_secs, 
     gint current_split, ui_state *ui)
 {
-  GtkTreeModel *model = gtk_tree_view_get_model(ui->gui->tree_view);
-
-  GtkTreeIter iter;
-  if (!gtk_tree_model_get_iter_first(model, &iter))
-  {
-    return TRUE;
-  }
-
-  gint tree_minutes;
-  gint tree_seconds;
-  gint tree_hundr_secs;
+  gboolean found = FALSE;
+  gint i = splt_splitpoints_find_index(ui->splitpoints,
+      minutes * 6000 + seconds * 100 + hundr_secs, &found);
 
-  while (TRUE)
+  if (found && i != current_split)
   {
-    gtk_tree_model_get(GTK_TREE_MODEL(model), &iter,
-        COL_MINUTES, &tree_minutes,
-        COL_SECONDS, &tree_seconds,
-        COL_HUNDR_SECS, &tree_hundr_secs,
-        -1);
-
-    GtkTreePath *path = gtk_tree_model_get_path(model, &iter);
-    gint i = gtk_tree_path_get_indices (path)[0];
-
-    if ((minutes == tree_minutes) &&
-        (seconds == tree_seconds) && 
-        (hundr_secs == tree_hundr_secs) &&
-        (i != current_split))
-    {
-      gtk_tree_path_free(path);
-      return FALSE;
-    }
-
-    gtk_tree_path_free(path);
-
-    if (!gtk_tree_model_iter_next(model, &iter))
-    {
-      break;
-    }
+    return FALSE;
   }
 
   return TRUE;
@@ -152,68 +121,45 @@ static GtkTreeModel *create_model()
 //!order the number column
 static void recompute_length_column(ui_state *ui)
 {
-  gint line_mins, line_secs, line_hundr;
-  gint line1_mins, line1_secs, line1_hundr;
+  if (ui->status->splitpoints_batch_update)
+  {
+    return;
+  }
 
   gchar new_length_string[30];
 
   GtkTreeModel *model = gtk_tree_view_get_model(ui->gui->tree_view);
 
+  GtkTreeIter iter;
+  if (!gtk_tree_model_get_iter_first(model, &iter))
+  {
+    return;
+  }
+
   gint number = 0;
   for (number = 0;number < ui->infos->splitnumber; number++)
   {
-    GtkTreePath *path = gtk_tree_path_new_from_indices(number ,-1);
-    GtkTreeIter iter;
-    gtk_tree_model_get_iter(model, &iter, path);
-
     if (number != ui->infos->splitnumber-1)
     {
-      GtkTreePath *path2 = gtk_tree_path_new_from_indices (number+1 ,-1);
-      GtkTreeIter iter2;
-      gtk_tree_model_get_iter(model, &iter2, path2);
-
-      gtk_tree_model_get(GTK_TREE_MODEL(model), &iter,
-          COL_MINUTES, &line_mins,
-          COL_SECONDS, &line_secs,
-          COL_HUNDR_SECS, &line_hundr,
-          -1);
-      gtk_tree_model_get(GTK_TREE_MODEL(model), &iter2,
-          COL_MINUTES, &line1_mins,
-          COL_SECONDS, &line1_secs,
-          COL_HUNDR_SECS, &line1_hundr,
-          -1);
+      gint length = get_splitpoint_time(number + 1, ui) - get_splitpoint_time(number, ui);
 
-      gint result_secs = 0,result_hundr = 0;
-      gint result_mins = line1_mins - line_mins;
-      if ((result_secs = line1_secs - line_secs) < 0)
-      {
-        result_secs = 60 - line_secs + line1_secs;
-        result_mins--;
-      }
-
-      if ((result_hundr = line1_hundr - line_hundr) < 0)
-      {
-        result_hundr = 100 - line_hundr + line1_hundr;
-        result_secs--;
-        if (result_secs < 0)
-        {
-          result_mins--;
-          result_secs = 0;                    
-        }
-      }
+      gint result_hundr = length % 100;
+      gint result_secs = (length / 100) % 60;
+      gint result_mins = length / 6000;
 
       g_snprintf(new_length_string, 30, "%d:%02d:%02d", result_mins, result_secs, result_hundr);
-
-      gtk_tree_path_free(path2);
     }
     else
     {
       g_snprintf(new_length_string, 30, "%s","-");
     }
 
-    gtk_tree_path_free(path);
-
     gtk_list_store_set(GTK_LIST_STORE(model), &iter, COL_NUMBER, new_length_string, -1);
+
+    if (!gtk_tree_model_iter_next(model, &iter))
+    {
+      break;
+    }
   }
 }
 
@@ -226,37 +172,25 @@ track name with
 */
 static gboolean check_if_description_exists(gchar *descr, gint number, ui_state *ui)
 {
-  GtkTreeModel *model = gtk_tree_view_get_model(ui->gui->tree_view);
-
-  GtkTreeIter iter;
-  if (!gtk_tree_model_get_iter_first(model, &iter))
+  gint count = splt_descriptions_count(ui->splitpoints_descriptions, descr);
+  if (count == 0)
   {
     return TRUE;
   }
 
-  gint count = 0;
-  while (TRUE)
+  if (number < 0 || number >= ui->infos->splitnumber)
   {
-    gchar *description = NULL;
-    gtk_tree_model_get(GTK_TREE_MODEL(model), &iter,
-        COL_DESCRIPTION, &description,
-        -1);
-
-    if (description != NULL && strcmp(descr, description) == 0 && count != number)
-    {
-      g_free(description);
-      return FALSE;
-    }
-
-    g_free(description);
-
-    if (!gtk_tree_model_iter_next(model, &iter))
-      break;
+    return FALSE;
+  }
 
-    count++;
+  gchar *description = get_splitpoint_name(number, ui);
+  if (description != NULL && strcmp(descr, description) == 0)
+  {
+    count--;
   }
+  g_free(description);
 
-  return TRUE;
+  return count == 0;
 }
 
 //!Gets the number of the first splitpoint with selected "Keep" checkbox 
@@ -397,6 +331,9 @@ static void order_all_splitpoints_from_table(const char *current_description_bas
             i + 1);
         gchar *new_desc = g_string_free(new_description, FALSE);
 
+        splt_descriptions_remove(ui->splitpoints_descriptions, description);
+        splt_descriptions_add(ui->splitpoints_descriptions, new_desc);
+
         gtk_list_store_set(GTK_LIST_STORE(model), 
             &iter,
             COL_DESCRIPTION, new_desc,
@@ -443,6 +380,11 @@ void remove_splitpoint(gint index, gint stop_preview, ui_state *ui)
     set_quick_preview_end_splitpoint_safe(ui->status->preview_start_splitpoint + 1, ui);
   }
 
+  gchar *description = NULL;
+  gtk_tree_model_get(model, &iter, COL_DESCRIPTION, &description, -1);
+  splt_descriptions_remove(ui->splitpoints_descriptions, description);
+  g_free(description);
+
   gtk_list_store_remove(GTK_LIST_STORE(model), &iter);
   gtk_tree_path_free(path);
 
@@ -465,9 +407,13 @@ void remove_splitpoint(gint index, gint stop_preview, ui_state *ui)
 
   recompute_length_column(ui);
   remove_status_message(ui->gui);
-  update_add_button(ui);
-  check_update_down_progress_bar(ui);
-  refresh_drawing_area(ui->gui, ui->infos);
+
+  if (!ui->status->splitpoints_batch_update)
+  {
+    update_add_button(ui);
+    check_update_down_progress_bar(ui);
+    refresh_drawing_area(ui->gui, ui->infos);
+  }
 
   export_cue_file_in_configuration_directory(ui);
 }
@@ -488,55 +434,15 @@ static void add_splitpoint(Split_point my_split_point, gint old_index, ui_state
   if (check_if_splitpoint_does_not_exists(my_split_point.mins,
         my_split_point.secs, my_split_point.hundr_secs,-1, ui))
   {
-    gint k = 0;
-
     update_current_description(current_description_base, -1, ui);
 
-    GtkTreeIter iter;
-    if (gtk_tree_model_get_iter_first(model, &iter))
-    {
-      while (k < ui->infos->splitnumber)
-      {
-        gint tree_minutes;
-        gint tree_seconds;
-        gint tree_hundr_secs;
-        gtk_tree_model_get(GTK_TREE_MODEL(model), &iter,
-            COL_MINUTES, &tree_minutes,
-            COL_SECONDS, &tree_seconds,
-            COL_HUNDR_SECS, &tree_hundr_secs,
-            -1);
-
-        if (my_split_point.mins < tree_minutes)
-        {
-          break;
-        }
-        else if (my_split_point.mins == tree_minutes)
-        {
-          if (my_split_point.secs < tree_seconds)
-          {
-            break;
-          }
-          else if (my_split_point.secs == tree_seconds)
-          {
-            if (my_split_point.hundr_secs < tree_hundr_secs)
-            {
-              break;
-            }
-          }
-        }
-
-        gtk_tree_model_iter_next(model, &iter);
-        k++;
-      }
+    gint k = splt_splitpoints_find_index(ui->splitpoints,
+        splt_splitpoint_get_time(&my_split_point), NULL);
 
-      gtk_list_store_insert(GTK_LIST_STORE(model), &iter,k--);
-      g_array_insert_val(ui->splitpoints, k+1, my_split_point);     
-    }
-    else
-    {
-      gtk_list_store_append(GTK_LIST_STORE(model), &iter);
-      g_array_append_val(ui->splitpoints, my_split_point);
-    }
+    GtkTreeIter iter;
+    gtk_list_store_insert(GTK_LIST_STORE(model), &iter, k);
+    g_array_insert_val(ui->splitpoints, k, my_split_point);
+    k--;
 
     ui->infos->splitnumber++;
 
@@ -636,6 +542,7 @@ static void add_splitpoint(Split_point my_split_point, gint old_index, ui_state
         COL_SECONDS, my_split_point.secs,
         COL_HUNDR_SECS, my_split_point.hundr_secs,
         -1);
+    splt_descriptions_add(ui->splitpoints_descriptions, ui->status->current_description);
 
     gtk_widget_set_sensitive(ui->gui->remove_all_button, TRUE);
 
@@ -671,9 +578,12 @@ static void add_splitpoint(Split_point my_split_point, gint old_index, ui_state
     g_snprintf(ui->status->current_description, 255, "%s", _("description here"));
   }
 
-  update_add_button(ui);
-  refresh_drawing_area(ui->gui, ui->infos);
-  check_update_down_progress_bar(ui);
+  if (!ui->status->splitpoints_batch_update)
+  {
+    update_add_button(ui);
+    refresh_drawing_area(ui->gui, ui->infos);
+    check_update_down_progress_bar(ui);
+  }
 
   export_cue_file_in_configuration_directory(ui);
 }
@@ -828,6 +738,12 @@ static void cell_edited_event(GtkCellRendererText *cell, gchar *path_string, gch
     case COL_DESCRIPTION:
       update_current_description(new_text, i, ui);
 
+      gchar *old_description = NULL;
+      gtk_tree_model_get(model, &iter, COL_DESCRIPTION, &old_description, -1);
+      splt_descriptions_remove(ui->splitpoints_descriptions, old_description);
+      splt_descriptions_add(ui->splitpoints_descriptions, ui->status->current_description);
+      g_free(old_description);
+
       //put the new content in the list
       gtk_list_store_set(GTK_LIST_STORE(model), &iter,
           col, ui->status->current_description,
@@ -940,6 +856,27 @@ void add_row(gboolean checked, ui_state *ui)
   add_splitpoint(my_split_point, -1, ui, FALSE, NULL);
 }
 
+/*! Starts adding or removing many splitpoints at once
+
+The lengths column, the drawing area and the add button are only refreshed
+once, by end_splitpoints_batch_update().
+*/
+void begin_splitpoints_batch_update(ui_state *ui)
+{
+  ui->status->splitpoints_batch_update = TRUE;
+}
+
+//! Refreshes the splitpoints table after begin_splitpoints_batch_update()
+void end_splitpoints_batch_update(ui_state *ui)
+{
+  ui->status->splitpoints_batch_update = FALSE;
+
+  recompute_length_column(ui);
+  update_add_button(ui);
+  refresh_drawing_area(ui->gui, ui->infos);
+  check_update_down_progress_bar(ui);
+}
+
 static void add_row_clicked(GtkWidget *button, ui_state *ui)
 {
   gui_status *status = ui->status;
@@ -1313,6 +1250,9 @@ static void remove_row(GtkWidget *widget, ui_state *ui)
 
   GList *selected_list = gtk_tree_selection_get_selected_rows(selection, &model);
 
+  ui->status->lock_cue_export = SPLT_TRUE;
+  begin_splitpoints_batch_update(ui);
+
   while ((g_list_length(selected_list) > 0) && (ui->infos->splitnumber > 0))
   {
     GList *current_element = g_list_last(selected_list);
@@ -1328,21 +1268,22 @@ static void remove_row(GtkWidget *widget, ui_state *ui)
 
   g_list_foreach(selected_list, (GFunc)gtk_tree_path_free, NULL);
   g_list_free(selected_list);
+
+  end_splitpoints_batch_update(ui);
+  ui->status->lock_cue_export = SPLT_FALSE;
+
+  export_cue_file_in_configuration_directory(ui);
 }
 
 //!removes all rows from the table
 void remove_all_rows(GtkWidget *widget, ui_state *ui)
 {
   GtkTreeModel *model = gtk_tree_view_get_model(ui->gui->tree_view);
-  
-  while (ui->infos->splitnumber > 0)
-  {
-    GtkTreeIter iter;
-    gtk_tree_model_get_iter_first(model, &iter);
-    gtk_list_store_remove(GTK_LIST_STORE(model), &iter);
-    g_array_remove_index(ui->splitpoints, (ui->infos->splitnumber-1));
-    ui->infos->splitnumber--;
-  }
+
+  gtk_list_store_clear(GTK_LIST_STORE(model));
+  g_array_set_size(ui->splitpoints, 0);
+  g_hash_table_remove_all(ui->splitpoints_descriptions);
+  ui->infos->splitnumber = 0;
   
   gtk_widget_set_sensitive(ui->gui->remove_all_button, FALSE);
   gtk_widget_set_sensitive(ui->gui->remove_row_button, FALSE);
@@ -1503,8 +1444,7 @@ gint get_splitpoint_time(gint splitpoint_index, ui_state *ui)
     return -1;
   }
 
-  Split_point point = g_array_index(ui->splitpoints, Split_point, splitpoint_index);
-  return point.mins * 6000 + point.secs * 100 + point.hundr_secs;
+  return splt_splitpoint_get_time(&g_array_index(ui->splitpoints, Split_point, splitpoint_index));
 }
 
 static gboolean split_preview_end(ui_with_err *ui_err)
@@ -1539,6 +1479,18 @@ static gboolean split_preview_end(ui_with_err *ui_err)
   return FALSE;
 }
 
+//! Streams the bytes of the split preview to the player instead of a file
+static void write_preview_bytes(const void *ptr, size_t size, size_t nmemb, void *data)
+{
+  ui_for_split *ui_fs = (ui_for_split *) data;
+
+  if (!splt_preview_buffer_write(ui_fs->preview, ptr, size * nmemb))
+  {
+    //the player does not play the preview anymore
+    mp3splt_stop_split(ui_fs->ui->mp3splt_state);
+  }
+}
+
 static gpointer split_preview(ui_for_split *ui_fs)
 {
   ui_state *ui = ui_fs->ui;
@@ -1566,13 +1518,31 @@ static gpointer split_preview(ui_for_split *ui_fs)
 
   put_options_from_preferences(ui_fs);
 
-  gchar *fname_path = get_preferences_filename();
-  fname_path[strlen(fname_path) - 18] = '\0';
-  mp3splt_set_path_of_split(ui->mp3splt_state, fname_path);
-  if (fname_path) { g_free(fname_path); }
+  if (ui_fs->preview)
+  {
+    mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_PRETEND_TO_SPLIT, SPLT_TRUE);
+    mp3splt_set_split_filename_function(ui->mp3splt_state, NULL, ui);
+    mp3splt_set_pretend_to_split_write_function(ui->mp3splt_state, write_preview_bytes, ui_fs);
+  }
+  else
+  {
+    gchar *fname_path = get_preferences_filename();
+    fname_path[strlen(fname_path) - 18] = '\0';
+    mp3splt_set_path_of_split(ui->mp3splt_state, fname_path);
+    if (fname_path) { g_free(fname_path); }
+  }
 
   err = mp3splt_split(ui->mp3splt_state);
 
+  if (ui_fs->preview)
+  {
+    splt_preview_buffer_finish(ui_fs->preview);
+
+    mp3splt_set_pretend_to_split_write_function(ui->mp3splt_state, NULL, NULL);
+    mp3splt_set_int_option(ui->mp3splt_state, SPLT_OPT_PRETEND_TO_SPLIT, SPLT_FALSE);
+    mp3splt_set_split_filename_function(ui->mp3splt_state, lmanager_put_split_filename, ui);
+  }
+
   free_ui_for_split(ui_fs);
 
   ui_with_err *ui_err = g_malloc0(sizeof(ui_with_err));
@@ -1590,6 +1560,13 @@ static void split_preview_action(ui_state *ui)
 
   remove_all_split_rows(ui);
 
+  //the preview is split in memory and played while it is being split
+  if (player_can_play_preview_from_memory(ui))
+  {
+    ui_fs->preview = splt_preview_buffer_new(PREVIEW_BUFFER_SIZE);
+    player_play_preview(ui_fs->preview, get_preview_start_position_safe(ui), ui);
+  }
+
   create_thread_and_unref((GThreadFunc)split_preview, (gpointer) ui_fs, ui, "split_preview");
 }
 
@@ -74,6 +74,8 @@ void update_seconds_from_spinner(GtkWidget *widget, ui_state *ui);
 void update_hundr_secs_from_spinner(GtkWidget *widget, ui_state *ui);
 void add_splitpoint_from_player(GtkWidget *widget, ui_state *ui);
 void add_row(gint checked, ui_state *ui);
+void begin_splitpoints_batch_update(ui_state *ui);
+void end_splitpoints_batch_update(ui_state *ui);
 GtkWidget *create_splitpoints_frame(ui_state *ui);
 points_and_tags *get_splitpoints_and_tags_for_mp3splt_state(ui_state *ui);
 void clear_current_description(ui_state *ui);
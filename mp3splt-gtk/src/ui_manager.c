@@ -105,7 +105,13 @@ ui_state *ui_state_new()
   }
 
   ui->splitpoints = g_array_new(FALSE, FALSE, sizeof(Split_point));
+  ui->splitpoints_descriptions = splt_descriptions_new();
   ui->files_to_split = NULL;
+  ui->split_jobs = NULL;
+  ui->batch_probe_pool = NULL;
+  ui->batch_probe_results = NULL;
+  ui->batch_probe_idle_scheduled = FALSE;
+  ui->batch_probe_cancelled = FALSE;
 
   ui->status = ui_status_new();
   ui->gui = ui_gui_new();
@@ -124,6 +130,8 @@ void ui_state_free(ui_state *ui)
 {
   if (!ui) { return; }
 
+  batch_probe_stop(ui);
+
   ui_infos_free(&ui->infos);
   pm_free(&ui->preferences);
 
@@ -133,6 +141,7 @@ void ui_state_free(ui_state *ui)
   }
 
   g_array_free(ui->splitpoints, TRUE);
+  splt_descriptions_free(&ui->splitpoints_descriptions);
 
   ui_status_free(&ui->status);
   ui_gui_free(&ui->gui);
@@ -258,6 +267,12 @@ static void ui_infos_new(ui_state *ui)
   infos->preview_time_windows = preview_time_windows;
 
   infos->filtered_points_presence = NULL;
+  infos->silence_wave_pyramid = NULL;
+  infos->silence_wave_version = 0;
+  infos->drawing_silence_wave_layer = FALSE;
+  infos->silence_wave_queue = NULL;
+  infos->silence_wave_chunk = NULL;
+  infos->silence_wave_filename = NULL;
   infos->silence_wave_number_of_points_threshold = DEFAULT_SILENCE_WAVE_NUMBER_OF_POINTS_THRESHOLD;
 
   infos->selected_player = PLAYER_GSTREAMER;
@@ -290,6 +305,7 @@ static void ui_infos_new(ui_state *ui)
 
   infos->playlist_tree_number = 0;
   infos->multiple_files_tree_number = 0;
+  infos->multiple_files_index = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
 
   infos->freedb_search_results = NULL;
 
@@ -311,6 +327,7 @@ static void ui_infos_new(ui_state *ui)
   infos->small_seek_jump_value = DEFAULT_SMALL_SEEK_JUMP_VALUE;
   infos->seek_jump_value = DEFAULT_SEEK_JUMP_VALUE;
   infos->big_seek_jump_value = DEFAULT_BIG_SEEK_JUMP_VALUE;
+  infos->split_jobs_concurrency = DEFAULT_SPLIT_JOBS_CONCURRENCY;
 
   infos->previous_export_thread = NULL;
 
@@ -341,6 +358,8 @@ static gui_status *ui_status_new(ui_state *ui)
 
   status->playing = FALSE;
   status->timer_active = FALSE;
+  status->player_timer_interval = 0;
+  status->drawn_current_time = -1;
   status->quick_preview_end_splitpoint = -1;
   status->preview_start_splitpoint = -1;
   status->stop_preview_right_after_start = FALSE;
@@ -373,12 +392,13 @@ static gui_status *ui_status_new(ui_state *ui)
 
   status->preview_start_position = 0;
   status->timeout_id = 0;
+  status->silence_wave_timeout_id = 0;
 
   status->currently_scanning_for_silence = FALSE;
 
   status->filename_to_split = NULL;
 
-  status->douglas_callback_counter = 0;
+  status->douglas_peucker_filters_to_recompute = FALSE;
 
   status->stream = FALSE;
   status->only_press_pause = FALSE;
@@ -393,6 +413,7 @@ static gui_status *ui_status_new(ui_state *ui)
   status->file_selection_changed = FALSE;
 
   status->stop_split = FALSE;
+  status->split_jobs_finished = 0;
 
   status->previous_zoom_coeff = -2;
   status->previous_interpolation_level = -2;
@@ -481,6 +502,13 @@ static void ui_infos_free(ui_infos **infos)
     (*infos)->silence_points = NULL;
     (*infos)->number_of_silence_points = 0;
   }
+  splt_wave_pyramid_free(&(*infos)->silence_wave_pyramid);
+  splt_wave_queue_free(&(*infos)->silence_wave_queue);
+  g_free((*infos)->silence_wave_chunk);
+  (*infos)->silence_wave_chunk = NULL;
+  g_free((*infos)->silence_wave_filename);
+  (*infos)->silence_wave_filename = NULL;
+  splt_douglas_peucker_free((*infos)->filtered_points_presence);
 
   if ((*infos)->previous_pixel_by_time != NULL)
   {
@@ -496,6 +524,12 @@ static void ui_infos_free(ui_infos **infos)
 
   g_array_free((*infos)->preview_time_windows, TRUE);
 
+  if ((*infos)->multiple_files_index != NULL)
+  {
+    g_hash_table_destroy((*infos)->multiple_files_index);
+    (*infos)->multiple_files_index = NULL;
+  }
+
   g_free(*infos);
   *infos = NULL;
 }
@@ -529,6 +563,11 @@ static void ui_gui_free(gui_state **gui)
     return;
   }
 
+  if ((*gui)->silence_wave_layer.surface)
+  {
+    cairo_surface_destroy((*gui)->silence_wave_layer.surface);
+  }
+
   g_free(*gui);
   *gui = NULL;
 }
@@ -91,11 +91,100 @@ typedef struct {
   float level;
 } silence_wave;
 
+//! Levels of the silence wave points falling in a time interval
+typedef struct {
+  gfloat min;
+  gfloat max;
+  gfloat avg;
+  guint number_of_points;
+} wave_bucket;
+
+/*! Min/max/average summaries of the silence wave
+
+The buckets of the level \c n last 1 << (first_level_shift + n) hundreths of
+seconds, starting from start_time.
+*/
+typedef struct {
+  long start_time;
+  gint first_level_shift;
+  gint number_of_levels;
+  wave_bucket **levels;
+  glong *levels_length;
+} wave_pyramid;
+
+#define WAVE_CHUNK_NUMBER_OF_POINTS 1024
+#define WAVE_QUEUE_NUMBER_OF_CHUNKS 64
+
+//! Consecutive silence wave points published together while scanning
+typedef struct {
+  gint number_of_points;
+  silence_wave points[WAVE_CHUNK_NUMBER_OF_POINTS];
+} wave_chunk;
+
+/*! Lock-free queue of wave chunks between one producer and one consumer thread
+
+head is only written by the consumer and tail by the producer.
+*/
+typedef struct {
+  wave_chunk *chunks[WAVE_QUEUE_NUMBER_OF_CHUNKS];
+  volatile gint head;
+  volatile gint tail;
+} wave_queue;
+
+//! Silence wave of a file read from the wave cache
+typedef struct {
+  silence_wave *silence_points;
+  gint number_of_silence_points;
+  wave_pyramid *pyramid;
+  //!NULL if the Douglas-Peucker filters were not saved
+  GByteArray *filtered_points_presence;
+  gdouble douglas_peucker_thresholds[6];
+} cached_wave;
+
+#define PREVIEW_BUFFER_SIZE (1024 * 1024)
+
+/*! Bytes of a split preview streamed from the splitting thread to the player
+
+The ring is blocking: the writer waits while it is full and the reader waits
+while it is empty. It is shared by reference counting between the two sides.
+*/
+typedef struct {
+  guchar *bytes;
+  gsize capacity;
+  //! Total number of bytes read
+  guint64 head;
+  //! Total number of bytes written
+  guint64 tail;
+  gboolean finished;
+  gboolean cancelled;
+  gint ref_count;
+  GMutex mutex;
+  GCond cond;
+} preview_buffer;
+
 typedef struct {
   gint index;
   gpointer data;
 } preview_index_and_data;
 
+/*! Part of the drawing area drawn once in a surface and reused
+
+The surface is three widths wide and centered on drawn_time, so that it can
+be scrolled by one width on each side before being drawn again.
+*/
+typedef struct {
+  cairo_surface_t *surface;
+  gint width;
+  gint height;
+  gfloat zoom_coeff;
+  gfloat total_time;
+  gint version;
+  gint points_threshold;
+  gfloat drawn_time;
+  //! Value returned by the drawing of the layer
+  gint drawn_value;
+} drawing_layer;
+
 typedef struct points_and_tags {
   GPtrArray *splitpoints;
   GPtrArray *tags;
@@ -143,7 +232,17 @@ typedef struct {
 
   GArray *preview_time_windows;
 
-  GPtrArray *filtered_points_presence;
+  GByteArray *filtered_points_presence;
+  wave_pyramid *silence_wave_pyramid;
+  //! Incremented when the silence points or their filters change
+  gint silence_wave_version;
+  //! TRUE while drawing the silence wave layer: pixels are not smoothed
+  gint drawing_silence_wave_layer;
+  wave_queue *silence_wave_queue;
+  //!only used by the thread scanning for silence
+  wave_chunk *silence_wave_chunk;
+  //!file of the silence wave, if the wave is complete
+  gchar *silence_wave_filename;
   gint silence_wave_number_of_points_threshold;
 
   gint selected_player;
@@ -163,6 +262,8 @@ typedef struct {
   gint freedb_table_number;
   gint playlist_tree_number;
   gint multiple_files_tree_number;
+  //! Filename -> GtkTreeIter of the batch list, to add files without duplicates
+  GHashTable *multiple_files_index;
 
   gint freedb_selected_id;
 
@@ -182,6 +283,9 @@ typedef struct {
   gint seek_jump_value;
   gint big_seek_jump_value;
 
+  //! Number of files split at the same time in batch mode
+  gint split_jobs_concurrency;
+
   //make export threads to execute in order
   GThread *previous_export_thread;
 
@@ -204,6 +308,10 @@ typedef struct {
   GstElement *play;
   GstBus *bus;
   gint _gstreamer_is_running;
+  //! Split preview being played from memory; NULL when playing the input file
+  preview_buffer *preview;
+  gint preview_start_time;
+  gint total_time_before_preview;
 #endif
 
 #ifndef NO_AUDACIOUS
@@ -259,6 +367,10 @@ typedef struct {
   gint checkbox_ypos;
   gint text_ypos;
   gint wave_ypos;
+  //! y of the row of the left, current and right times of the drawing area
+  gint times_text_ypos;
+
+  drawing_layer silence_wave_layer;
 
   GPtrArray *wave_quality_das;
   GtkWidget *player_scrolled_window;
@@ -368,6 +480,10 @@ typedef struct {
 
   GtkTreeView *split_tree;
 
+  GtkWidget *split_jobs_box;
+  GtkTreeView *split_jobs_tree;
+  GtkWidget *cancel_split_job_button;
+
   GtkWidget *spinner_minutes;
   GtkWidget *spinner_seconds;
   GtkWidget *spinner_hundr_secs;
@@ -440,6 +556,9 @@ typedef struct {
   gint show_silence_wave;
   gboolean playing;
   gboolean timer_active;
+  guint player_timer_interval;
+  //! Current time of the last full redraw of the drawing area
+  gfloat drawn_current_time;
 
   gint quick_preview_end_splitpoint;
   gint preview_start_splitpoint;
@@ -473,12 +592,13 @@ typedef struct {
   gint preview_start_position;
 
   gint timeout_id;
+  guint silence_wave_timeout_id;
 
   gint currently_scanning_for_silence;
 
   gchar *filename_to_split;
 
-  gint douglas_callback_counter;
+  gint douglas_peucker_filters_to_recompute;
 
   gboolean stream;
 
@@ -498,6 +618,9 @@ typedef struct {
   gint previous_interpolation_level;
 
   gint lock_cue_export;
+  gint splitpoints_batch_update;
+
+  gint split_jobs_finished;
 } gui_status;
 
 #define SPLT_MUTEX GMutex
@@ -510,11 +633,21 @@ typedef struct {
   splt_state *mp3splt_state;
 
   GArray *splitpoints;
+  GHashTable *splitpoints_descriptions;
   gui_state *gui;
   gui_status *status;
   player_infos *pi;
 
   GPtrArray *files_to_split;
+  //! Files of the batch split in progress; guarded by variables_mutex
+  GPtrArray *split_jobs;
+
+  //! Reads the length, type and tags of the files added to the batch list
+  GThreadPool *batch_probe_pool;
+  //! Probed files waiting to be shown in the batch list
+  GAsyncQueue *batch_probe_results;
+  gint batch_probe_idle_scheduled;
+  gint batch_probe_cancelled;
 
   SPLT_MUTEX variables_mutex;
 
@@ -562,6 +695,22 @@ typedef struct {
   int num_of_filenames;
 } ui_with_fnames;
 
+typedef struct {
+  ui_state *ui;
+  gint err;
+  gchar *fname;
+  cached_wave *cached;
+} ui_with_wave;
+
+typedef struct {
+  ui_state *ui;
+  //! The silence wave version when the computation started
+  gint silence_wave_version;
+  GArray *gdk_points;
+  gdouble thresholds[6];
+  GByteArray *presence;
+} ui_with_douglas_points;
+
 typedef struct {
   ui_state *ui;
 
@@ -577,6 +726,8 @@ typedef struct {
 
   //single or batch
   int split_file_mode;
+  //number of files split at the same time in batch mode
+  int split_jobs_concurrency;
 
   //type of split
   int selected_split_mode;
@@ -627,7 +778,47 @@ typedef struct {
   gchar *test_regex_filename;
   gboolean should_trim;
   gint freedb_selected_id;
+
+  //! Split preview played from memory; NULL when the preview is written on disk
+  preview_buffer *preview;
 } ui_for_split;
 
+//! One file of a batch split, split on a worker thread with its own library state
+typedef struct {
+  ui_state *ui;
+  ui_for_split *ui_fs;
+  gint index;
+  gchar *filename;
+  //! Splitpoints given to this file only; NULL for all the files except the first
+  points_and_tags *pat;
+
+  //! Worker state while the file is being split; guarded by ui->variables_mutex
+  splt_state *state;
+  //! Guarded by ui->variables_mutex
+  gboolean cancelled;
+
+  gint last_percent;
+  gint err;
+} split_job;
+
+typedef struct {
+  ui_state *ui;
+  gint index;
+  gint percent;
+  gchar *status;
+  gboolean finished;
+} ui_with_job_progress;
+
+//! Informations read from a file of the batch list
+typedef struct {
+  gchar *filename;
+  //! Length in hundreths of seconds; -1 if the file could not be read
+  glong total_time;
+  //! Size in bytes; -1 if unknown
+  gint64 size;
+  gchar *type;
+  gchar *tags;
+} batch_probe_result;
+
 #endif
 
@@ -0,0 +1,469 @@
+/**********************************************************
+ *
+ *                for mp3/ogg splitting without decoding
+ * mp3splt-gtk -- utility based on mp3splt,
+ *
+ * Copyright: (C) 2005-2014 Alexandru Munteanu
+ * Contact: m@ioalex.net
+ *
+ * http://mp3splt.sourceforge.net/
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ *********************************************************/
+
+/*!********************************************************
+ * \file 
+ * On disk cache of the silence waves
+ *
+ * The silence wave points, the min/max pyramid and the Douglas-Peucker
+ * filters of a file are stored in one binary file named after the checksum
+ * of the file path. The cache file is only used if the size and modification
+ * time of the file did not change. The data is stored as in memory and is only
+ * meant to be read back on the same machine.
+ **********************************************************/
+
+#include "wave_cache.h"
+#include "wave_pyramid.h"
+
+#define WAVE_CACHE_MAGIC "SPLTWAVE"
+#define WAVE_CACHE_VERSION 1
+#define WAVE_CACHE_EXTENSION ".wave"
+
+typedef struct {
+  gchar magic[8];
+  guint32 version;
+  guint32 silence_wave_size;
+  guint32 wave_bucket_size;
+  gint32 path_length;
+  gint64 file_size;
+  gint64 file_mtime;
+  gint32 number_of_silence_points;
+  gint32 has_filtered_points_presence;
+  gdouble douglas_peucker_thresholds[6];
+  gint64 pyramid_start_time;
+  gint32 pyramid_first_level_shift;
+  gint32 pyramid_number_of_levels;
+} wave_cache_header;
+
+//! Sections of the cache file are aligned on 8 bytes
+static gsize align(gsize size)
+{
+  return (size + 7) & ~((gsize) 7);
+}
+
+static gchar *get_cache_filename(const gchar *cache_directory, const gchar *filename)
+{
+  gchar *checksum = g_compute_checksum_for_string(G_CHECKSUM_MD5, filename, -1);
+  gchar *cache_basename = g_strconcat(checksum, WAVE_CACHE_EXTENSION, NULL);
+  gchar *cache_filename = g_build_filename(cache_directory, cache_basename, NULL);
+
+  g_free(cache_basename);
+  g_free(checksum);
+
+  return cache_filename;
+}
+
+static gboolean get_file_size_and_mtime(const gchar *filename, gint64 *size, gint64 *mtime)
+{
+  struct stat buffer;
+  if (g_stat(filename, &buffer) != 0 || S_ISREG(buffer.st_mode) == 0)
+  {
+    return FALSE;
+  }
+
+  *size = (gint64) buffer.st_size;
+  *mtime = (gint64) buffer.st_mtime;
+
+  return TRUE;
+}
+
+//! Copies \p size bytes at \p offset of the mapped file; FALSE if out of bounds
+static gboolean read_section(const gchar *contents, gsize length, gsize *offset,
+    gpointer destination, gsize size)
+{
+  if (*offset > length || size > length - *offset)
+  {
+    return FALSE;
+  }
+
+  memcpy(destination, contents + *offset, size);
+  *offset += align(size);
+
+  return TRUE;
+}
+
+//! TRUE if \p number elements of \p element_size bytes fit after \p offset
+static gboolean section_fits(gsize length, gsize offset, gint64 number, gsize element_size)
+{
+  return offset <= length && number >= 0 &&
+    (guint64) number <= (length - offset) / element_size;
+}
+
+static gboolean header_matches(const wave_cache_header *header, const gchar *filename,
+    gint64 file_size, gint64 file_mtime)
+{
+  return memcmp(header->magic, WAVE_CACHE_MAGIC, sizeof(header->magic)) == 0 &&
+    header->version == WAVE_CACHE_VERSION &&
+    header->silence_wave_size == sizeof(silence_wave) &&
+    header->wave_bucket_size == sizeof(wave_bucket) &&
+    header->path_length == (gint32) strlen(filename) &&
+    header->file_size == file_size &&
+    header->file_mtime == file_mtime &&
+    header->number_of_silence_points > 0 &&
+    header->pyramid_number_of_levels > 0 &&
+    header->pyramid_first_level_shift >= 0 &&
+    //the buckets of the last level last 1 << (first_level_shift + level) hundreths
+    header->pyramid_first_level_shift + header->pyramid_number_of_levels < 64;
+}
+
+static cached_wave *read_cached_wave(const gchar *contents, gsize length,
+    const gchar *filename, gint64 file_size, gint64 file_mtime)
+{
+  wave_cache_header header;
+  gsize offset = 0;
+
+  if (!read_section(contents, length, &offset, &header, sizeof(header)) ||
+      !header_matches(&header, filename, file_size, file_mtime))
+  {
+    return NULL;
+  }
+
+  //the checksum of the path may collide
+  if (offset + header.path_length > length ||
+      memcmp(contents + offset, filename, header.path_length) != 0)
+  {
+    return NULL;
+  }
+  offset += align(header.path_length);
+
+  gint number_of_points = header.number_of_silence_points;
+  if (!section_fits(length, offset, number_of_points, sizeof(silence_wave)))
+  {
+    return NULL;
+  }
+
+  cached_wave *cached = g_malloc0(sizeof(cached_wave));
+  memcpy(cached->douglas_peucker_thresholds, header.douglas_peucker_thresholds,
+      sizeof(cached->douglas_peucker_thresholds));
+
+  cached->number_of_silence_points = number_of_points;
+  cached->silence_points = g_malloc(sizeof(silence_wave) * (gsize) number_of_points);
+  if (!read_section(contents, length, &offset, cached->silence_points,
+        sizeof(silence_wave) * (gsize) number_of_points))
+  {
+    goto error;
+  }
+
+  if (header.has_filtered_points_presence)
+  {
+    if (!section_fits(length, offset, number_of_points, 1))
+    {
+      goto error;
+    }
+
+    cached->filtered_points_presence = g_byte_array_sized_new(number_of_points);
+    g_byte_array_set_size(cached->filtered_points_presence, number_of_points);
+    if (!read_section(contents, length, &offset, cached->filtered_points_presence->data,
+          number_of_points))
+    {
+      goto error;
+    }
+  }
+
+  wave_pyramid *pyramid = g_malloc0(sizeof(wave_pyramid));
+  cached->pyramid = pyramid;
+  pyramid->start_time = (long) header.pyramid_start_time;
+  pyramid->first_level_shift = header.pyramid_first_level_shift;
+  pyramid->number_of_levels = header.pyramid_number_of_levels;
+  pyramid->levels = g_malloc0(sizeof(wave_bucket *) * pyramid->number_of_levels);
+  pyramid->levels_length = g_malloc0(sizeof(glong) * pyramid->number_of_levels);
+
+  gint level = 0;
+  for (level = 0;level < pyramid->number_of_levels;level++)
+  {
+    gint64 level_length = 0;
+    if (!read_section(contents, length, &offset, &level_length, sizeof(level_length)) ||
+        level_length <= 0 ||
+        !section_fits(length, offset, level_length, sizeof(wave_bucket)))
+    {
+      goto error;
+    }
+
+    pyramid->levels_length[level] = (glong) level_length;
+    pyramid->levels[level] = g_malloc(sizeof(wave_bucket) * (gsize) level_length);
+    if (!read_section(contents, length, &offset, pyramid->levels[level],
+          sizeof(wave_bucket) * (gsize) level_length))
+    {
+      goto error;
+    }
+  }
+
+  return cached;
+
+error:
+  splt_cached_wave_free(&cached);
+  return NULL;
+}
+
+/*! Returns the cached silence wave of \p filename
+
+\return NULL if the file is not cached, if the cache is corrupted or if the
+file changed since it was cached
+*/
+cached_wave *splt_wave_cache_load(const gchar *cache_directory, const gchar *filename)
+{
+  if (cache_directory == NULL || filename == NULL)
+  {
+    return NULL;
+  }
+
+  gint64 file_size = 0;
+  gint64 file_mtime = 0;
+  if (!get_file_size_and_mtime(filename, &file_size, &file_mtime))
+  {
+    return NULL;
+  }
+
+  gchar *cache_filename = get_cache_filename(cache_directory, filename);
+  GMappedFile *mapped_file = g_mapped_file_new(cache_filename, FALSE, NULL);
+  g_free(cache_filename);
+
+  if (mapped_file == NULL)
+  {
+    return NULL;
+  }
+
+  cached_wave *cached = read_cached_wave(g_mapped_file_get_contents(mapped_file),
+      g_mapped_file_get_length(mapped_file), filename, file_size, file_mtime);
+
+  g_mapped_file_unref(mapped_file);
+
+  return cached;
+}
+
+static gboolean write_section(FILE *file, gconstpointer data, gsize size)
+{
+  static const gchar padding[8] = { 0 };
+
+  if (size > 0 && fwrite(data, size, 1, file) != 1)
+  {
+    return FALSE;
+  }
+
+  gsize padding_size = align(size) - size;
+  return padding_size == 0 || fwrite(padding, padding_size, 1, file) == 1;
+}
+
+static gboolean write_cached_wave(FILE *file, const wave_cache_header *header,
+    const gchar *filename, const silence_wave *silence_points,
+    const wave_pyramid *pyramid, const GByteArray *filtered_points_presence)
+{
+  if (!write_section(file, header, sizeof(*header)) ||
+      !write_section(file, filename, header->path_length) ||
+      !write_section(file, silence_points,
+        sizeof(silence_wave) * header->number_of_silence_points))
+  {
+    return FALSE;
+  }
+
+  if (filtered_points_presence &&
+      !write_section(file, filtered_points_presence->data, filtered_points_presence->len))
+  {
+    return FALSE;
+  }
+
+  gint level = 0;
+  for (level = 0;level < pyramid->number_of_levels;level++)
+  {
+    gint64 level_length = pyramid->levels_length[level];
+    if (!write_section(file, &level_length, sizeof(level_length)) ||
+        !write_section(file, pyramid->levels[level], sizeof(wave_bucket) * level_length))
+    {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+static gint compare_mtimes(gconstpointer first, gconstpointer second, gpointer mtimes)
+{
+  gint64 first_mtime = *(gint64 *) g_hash_table_lookup(mtimes, first);
+  gint64 second_mtime = *(gint64 *) g_hash_table_lookup(mtimes, second);
+
+  if (first_mtime < second_mtime) { return -1; }
+  if (first_mtime > second_mtime) { return 1; }
+  return 0;
+}
+
+//! Removes the least recently written cache files above the maximum number of files
+static void remove_oldest_cache_files(const gchar *cache_directory)
+{
+  GDir *directory = g_dir_open(cache_directory, 0, NULL);
+  if (directory == NULL)
+  {
+    return;
+  }
+
+  GHashTable *mtimes = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+  GList *cache_filenames = NULL;
+
+  const gchar *basename = NULL;
+  while ((basename = g_dir_read_name(directory)) != NULL)
+  {
+    if (!g_str_has_suffix(basename, WAVE_CACHE_EXTENSION))
+    {
+      continue;
+    }
+
+    gchar *cache_filename = g_build_filename(cache_directory, basename, NULL);
+
+    gint64 size = 0;
+    gint64 *mtime = g_malloc(sizeof(gint64));
+    if (!get_file_size_and_mtime(cache_filename, &size, mtime))
+    {
+      g_free(mtime);
+      g_free(cache_filename);
+      continue;
+    }
+
+    g_hash_table_insert(mtimes, cache_filename, mtime);
+    cache_filenames = g_list_prepend(cache_filenames, cache_filename);
+  }
+  g_dir_close(directory);
+
+  gint number_of_files_to_remove =
+    (gint) g_list_length(cache_filenames) - WAVE_CACHE_MAXIMUM_NUMBER_OF_FILES;
+  if (number_of_files_to_remove > 0)
+  {
+    cache_filenames = g_list_sort_with_data(cache_filenames, compare_mtimes, mtimes);
+
+    GList *iterator = cache_filenames;
+    while (iterator != NULL && number_of_files_to_remove > 0)
+    {
+      g_unlink((const gchar *) iterator->data);
+      number_of_files_to_remove--;
+      iterator = g_list_next(iterator);
+    }
+  }
+
+  g_list_free(cache_filenames);
+  g_hash_table_destroy(mtimes);
+}
+
+/*! Saves the silence wave of \p filename in the cache
+
+The cache file is written to a temporary file first and then renamed, so that
+a partially written cache file is never read.
+*/
+gboolean splt_wave_cache_save(const gchar *cache_directory, const gchar *filename,
+    const silence_wave *silence_points, gint number_of_silence_points,
+    const wave_pyramid *pyramid, const GByteArray *filtered_points_presence,
+    const gdouble *douglas_peucker_thresholds)
+{
+  if (cache_directory == NULL || filename == NULL || silence_points == NULL ||
+      number_of_silence_points <= 0 || pyramid == NULL)
+  {
+    return FALSE;
+  }
+
+  if (filtered_points_presence &&
+      filtered_points_presence->len != (guint) number_of_silence_points)
+  {
+    filtered_points_presence = NULL;
+  }
+
+  wave_cache_header header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, WAVE_CACHE_MAGIC, sizeof(header.magic));
+  header.version = WAVE_CACHE_VERSION;
+  header.silence_wave_size = sizeof(silence_wave);
+  header.wave_bucket_size = sizeof(wave_bucket);
+  header.path_length = strlen(filename);
+  header.number_of_silence_points = number_of_silence_points;
+  header.has_filtered_points_presence = (filtered_points_presence != NULL);
+  memcpy(header.douglas_peucker_thresholds, douglas_peucker_thresholds,
+      sizeof(header.douglas_peucker_thresholds));
+  header.pyramid_start_time = pyramid->start_time;
+  header.pyramid_first_level_shift = pyramid->first_level_shift;
+  header.pyramid_number_of_levels = pyramid->number_of_levels;
+
+  if (!get_file_size_and_mtime(filename, &header.file_size, &header.file_mtime))
+  {
+    return FALSE;
+  }
+
+  gchar *cache_filename = get_cache_filename(cache_directory, filename);
+  gchar *temporary_filename = g_strconcat(cache_filename, ".tmp", NULL);
+
+  gboolean saved = FALSE;
+
+  FILE *file = g_fopen(temporary_filename, "wb");
+  if (file != NULL)
+  {
+    saved = write_cached_wave(file, &header, filename, silence_points,
+        pyramid, filtered_points_presence);
+    if (fclose(file) != 0)
+    {
+      saved = FALSE;
+    }
+
+    if (saved)
+    {
+      g_unlink(cache_filename);
+      saved = (g_rename(temporary_filename, cache_filename) == 0);
+    }
+
+    if (!saved)
+    {
+      g_unlink(temporary_filename);
+    }
+  }
+
+  g_free(temporary_filename);
+  g_free(cache_filename);
+
+  if (saved)
+  {
+    remove_oldest_cache_files(cache_directory);
+  }
+
+  return saved;
+}
+
+void splt_cached_wave_free(cached_wave **cached)
+{
+  if (!cached || !*cached)
+  {
+    return;
+  }
+
+  g_free((*cached)->silence_points);
+  splt_wave_pyramid_free(&(*cached)->pyramid);
+  if ((*cached)->filtered_points_presence)
+  {
+    g_byte_array_free((*cached)->filtered_points_presence, TRUE);
+  }
+
+  g_free(*cached);
+  *cached = NULL;
+}
+
@@ -0,0 +1,48 @@
+/**********************************************************
+ *
+ * mp3splt-gtk -- utility based on mp3splt,
+ *                for mp3/ogg splitting without decoding
+ *
+ * Copyright (c) 2005-2014 Alexandru Munteanu - m@ioalex.net
+ *
+ * http://mp3splt.sourceforge.net/
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ *********************************************************/
+
+#ifndef WAVE_CACHE_H
+#define WAVE_CACHE_H
+
+#include "external_includes.h"
+#include "ui_types.h"
+
+//! Oldest cached waves are removed above this number of files
+#define WAVE_CACHE_MAXIMUM_NUMBER_OF_FILES 100
+
+cached_wave *splt_wave_cache_load(const gchar *cache_directory, const gchar *filename);
+gboolean splt_wave_cache_save(const gchar *cache_directory, const gchar *filename,
+    const silence_wave *silence_points, gint number_of_silence_points,
+    const wave_pyramid *pyramid, const GByteArray *filtered_points_presence,
+    const gdouble *douglas_peucker_thresholds);
+void splt_cached_wave_free(cached_wave **cached);
+
+#endif
+
@@ -0,0 +1,279 @@
+/**********************************************************
+ *
+ *                for mp3/ogg splitting without decoding
+ * mp3splt-gtk -- utility based on mp3splt,
+ *
+ * Copyright: (C) 2005-2014 Alexandru Munteanu
+ * Contact: m@ioalex.net
+ *
+ * http://mp3splt.sourceforge.net/
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ *********************************************************/
+
+/*!********************************************************
+ * \file 
+ * Level of detail pyramid of the amplitude wave
+ *
+ * Each level summarises the silence wave points with the minimum, maximum
+ * and average level per time interval; the intervals double from one level
+ * to the next. Drawing a time window then only needs the buckets of the
+ * level having about one bucket per pixel.
+ **********************************************************/
+
+#include "wave_pyramid.h"
+
+static void splt_merge_bucket(wave_bucket *bucket, const wave_bucket *other)
+{
+  if (other->number_of_points == 0)
+  {
+    return;
+  }
+
+  if (bucket->number_of_points == 0)
+  {
+    *bucket = *other;
+    return;
+  }
+
+  guint number_of_points = bucket->number_of_points + other->number_of_points;
+
+  if (other->min < bucket->min) { bucket->min = other->min; }
+  if (other->max > bucket->max) { bucket->max = other->max; }
+  bucket->avg = (bucket->avg * bucket->number_of_points + other->avg * other->number_of_points) /
+    number_of_points;
+  bucket->number_of_points = number_of_points;
+}
+
+static gint splt_compute_first_level_shift(long duration, gint number_of_points)
+{
+  gint shift = 0;
+  while (shift < 62 && ((gint64) 1 << shift) * number_of_points <
+      (gint64) duration * WAVE_PYRAMID_POINTS_PER_FIRST_LEVEL_BUCKET)
+  {
+    shift++;
+  }
+
+  return shift;
+}
+
+static void splt_fill_first_level(wave_pyramid *pyramid, const silence_wave *points,
+    gint number_of_points)
+{
+  wave_bucket *buckets = pyramid->levels[0];
+
+  gint i = 0;
+  for (i = 0;i < number_of_points;i++)
+  {
+    glong index = (points[i].time - pyramid->start_time) >> pyramid->first_level_shift;
+    wave_bucket *bucket = &buckets[index];
+    float level = points[i].level;
+
+    if (bucket->number_of_points == 0)
+    {
+      bucket->min = level;
+      bucket->max = level;
+      bucket->avg = 0;
+    }
+    else
+    {
+      if (level < bucket->min) { bucket->min = level; }
+      if (level > bucket->max) { bucket->max = level; }
+    }
+
+    //sum of the levels until all the points are added
+    bucket->avg += level;
+    bucket->number_of_points++;
+  }
+
+  glong b = 0;
+  for (b = 0;b < pyramid->levels_length[0];b++)
+  {
+    if (buckets[b].number_of_points > 0)
+    {
+      buckets[b].avg /= buckets[b].number_of_points;
+    }
+  }
+}
+
+/*! Builds the pyramid of the silence wave points
+
+The points must be ordered by time. Returns NULL if there are no points.
+*/
+wave_pyramid *splt_wave_pyramid_new(const silence_wave *points, gint number_of_points)
+{
+  if (points == NULL || number_of_points <= 0)
+  {
+    return NULL;
+  }
+
+  wave_pyramid *pyramid = g_malloc0(sizeof(wave_pyramid));
+
+  pyramid->start_time = points[0].time;
+  long duration = points[number_of_points - 1].time - pyramid->start_time + 1;
+  pyramid->first_level_shift = splt_compute_first_level_shift(duration, number_of_points);
+
+  glong length = ((duration - 1) >> pyramid->first_level_shift) + 1;
+  pyramid->number_of_levels = 1;
+  while (length > 1)
+  {
+    length = (length + 1) / 2;
+    pyramid->number_of_levels++;
+  }
+
+  pyramid->levels = g_malloc0(sizeof(wave_bucket *) * pyramid->number_of_levels);
+  pyramid->levels_length = g_malloc0(sizeof(glong) * pyramid->number_of_levels);
+
+  length = ((duration - 1) >> pyramid->first_level_shift) + 1;
+  gint level = 0;
+  for (level = 0;level < pyramid->number_of_levels;level++)
+  {
+    pyramid->levels[level] = g_malloc0(sizeof(wave_bucket) * length);
+    pyramid->levels_length[level] = length;
+    length = (length + 1) / 2;
+  }
+
+  splt_fill_first_level(pyramid, points, number_of_points);
+
+  for (level = 1;level < pyramid->number_of_levels;level++)
+  {
+    const wave_bucket *previous = pyramid->levels[level - 1];
+    glong previous_length = pyramid->levels_length[level - 1];
+    wave_bucket *buckets = pyramid->levels[level];
+
+    glong b = 0;
+    for (b = 0;b < pyramid->levels_length[level];b++)
+    {
+      splt_merge_bucket(&buckets[b], &previous[b * 2]);
+      if (b * 2 + 1 < previous_length)
+      {
+        splt_merge_bucket(&buckets[b], &previous[b * 2 + 1]);
+      }
+    }
+  }
+
+  return pyramid;
+}
+
+void splt_wave_pyramid_free(wave_pyramid **pyramid)
+{
+  if (!pyramid || !*pyramid)
+  {
+    return;
+  }
+
+  gint level = 0;
+  for (level = 0;level < (*pyramid)->number_of_levels;level++)
+  {
+    g_free((*pyramid)->levels[level]);
+  }
+  g_free((*pyramid)->levels);
+  g_free((*pyramid)->levels_length);
+
+  g_free(*pyramid);
+  *pyramid = NULL;
+}
+
+//! Returns the first level having at most one bucket per pixel in [left_time, right_time]
+gint splt_wave_pyramid_choose_level(const wave_pyramid *pyramid,
+    long left_time, long right_time, gint width)
+{
+  gint64 duration = right_time - left_time;
+  if (width < 1) { width = 1; }
+
+  gint level = 0;
+  while (level < pyramid->number_of_levels - 1 &&
+      (duration >> (pyramid->first_level_shift + level)) > width)
+  {
+    level++;
+  }
+
+  return level;
+}
+
+/*! Returns the buckets of the level overlapping [left_time, right_time]
+
+\param first_bucket set to the index of the first returned bucket
+\param number_of_buckets set to the number of returned buckets; 0 if none
+*/
+const wave_bucket *splt_wave_pyramid_get_buckets(const wave_pyramid *pyramid, gint level,
+    long left_time, long right_time, glong *first_bucket, glong *number_of_buckets)
+{
+  gint shift = pyramid->first_level_shift + level;
+  glong length = pyramid->levels_length[level];
+
+  *first_bucket = 0;
+  *number_of_buckets = 0;
+
+  if (right_time < pyramid->start_time || right_time < left_time)
+  {
+    return NULL;
+  }
+
+  glong first = 0;
+  if (left_time > pyramid->start_time)
+  {
+    first = (left_time - pyramid->start_time) >> shift;
+  }
+
+  glong last = (right_time - pyramid->start_time) >> shift;
+  if (last >= length) { last = length - 1; }
+
+  if (first > last)
+  {
+    return NULL;
+  }
+
+  *first_bucket = first;
+  *number_of_buckets = last - first + 1;
+
+  return pyramid->levels[level] + first;
+}
+
+//! Returns the time in the middle of the bucket
+long splt_wave_pyramid_get_bucket_time(const wave_pyramid *pyramid, gint level, glong bucket)
+{
+  gint shift = pyramid->first_level_shift + level;
+  return pyramid->start_time + (bucket << shift) + (((long) 1 << shift) / 2);
+}
+
+//! Returns the index of the first point with a time >= \p time, or number_of_points
+gint splt_wave_find_first_point(const silence_wave *points, gint number_of_points, long time)
+{
+  gint begin = 0;
+  gint end = number_of_points;
+
+  while (begin < end)
+  {
+    gint middle = begin + (end - begin) / 2;
+    if (points[middle].time < time)
+    {
+      begin = middle + 1;
+    }
+    else
+    {
+      end = middle;
+    }
+  }
+
+  return begin;
+}
+
@@ -0,0 +1,52 @@
+/**********************************************************
+ *
+ * mp3splt-gtk -- utility based on mp3splt,
+ *                for mp3/ogg splitting without decoding
+ *
+ * Copyright (c) 2005-2014 Alexandru Munteanu - m@ioalex.net
+ *
+ * http://mp3splt.sourceforge.net/
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ *********************************************************/
+
+#ifndef WAVE_PYRAMID_H
+#define WAVE_PYRAMID_H
+
+#include "external_includes.h"
+#include "ui_types.h"
+
+//! Average number of silence wave points in a bucket of the first level
+#define WAVE_PYRAMID_POINTS_PER_FIRST_LEVEL_BUCKET 4
+
+wave_pyramid *splt_wave_pyramid_new(const silence_wave *points, gint number_of_points);
+void splt_wave_pyramid_free(wave_pyramid **pyramid);
+
+gint splt_wave_pyramid_choose_level(const wave_pyramid *pyramid,
+    long left_time, long right_time, gint width);
+const wave_bucket *splt_wave_pyramid_get_buckets(const wave_pyramid *pyramid, gint level,
+    long left_time, long right_time, glong *first_bucket, glong *number_of_buckets);
+long splt_wave_pyramid_get_bucket_time(const wave_pyramid *pyramid, gint level, glong bucket);
+
+gint splt_wave_find_first_point(const silence_wave *points, gint number_of_points, long time);
+
+#endif
+
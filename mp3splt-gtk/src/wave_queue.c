@@ -0,0 +1,103 @@
+/**********************************************************
+ *
+ *                for mp3/ogg splitting without decoding
+ * mp3splt-gtk -- utility based on mp3splt,
+ *
+ * Copyright: (C) 2005-2014 Alexandru Munteanu
+ * Contact: m@ioalex.net
+ *
+ * http://mp3splt.sourceforge.net/
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ *********************************************************/
+
+/*!********************************************************
+ * \file 
+ * Queue of silence wave chunks from the scanning thread to the gui
+ *
+ * The scanning thread pushes the chunks of points it has completed and the
+ * gui pops them to draw the wave while the scan goes on. There is exactly one
+ * producer and one consumer, so the queue only needs atomic loads and stores
+ * of its head and tail.
+ **********************************************************/
+
+#include "wave_queue.h"
+
+wave_queue *splt_wave_queue_new()
+{
+  return g_malloc0(sizeof(wave_queue));
+}
+
+//! Frees the queue and the chunks not yet popped
+void splt_wave_queue_free(wave_queue **queue)
+{
+  if (!queue || !*queue)
+  {
+    return;
+  }
+
+  wave_chunk *chunk = NULL;
+  while ((chunk = splt_wave_queue_pop(*queue)) != NULL)
+  {
+    g_free(chunk);
+  }
+
+  g_free(*queue);
+  *queue = NULL;
+}
+
+/*! Publishes a chunk to the consumer; only called by the producer thread
+
+\return FALSE if the queue is full; the chunk is then still owned by the caller
+*/
+gboolean splt_wave_queue_push(wave_queue *queue, wave_chunk *chunk)
+{
+  gint tail = queue->tail;
+  gint head = g_atomic_int_get(&queue->head);
+
+  if (tail - head >= WAVE_QUEUE_NUMBER_OF_CHUNKS)
+  {
+    return FALSE;
+  }
+
+  queue->chunks[tail % WAVE_QUEUE_NUMBER_OF_CHUNKS] = chunk;
+  g_atomic_int_set(&queue->tail, tail + 1);
+
+  return TRUE;
+}
+
+//! Returns the oldest published chunk or NULL; only called by the consumer thread
+wave_chunk *splt_wave_queue_pop(wave_queue *queue)
+{
+  gint head = queue->head;
+  gint tail = g_atomic_int_get(&queue->tail);
+
+  if (head == tail)
+  {
+    return NULL;
+  }
+
+  wave_chunk *chunk = queue->chunks[head % WAVE_QUEUE_NUMBER_OF_CHUNKS];
+  g_atomic_int_set(&queue->head, head + 1);
+
+  return chunk;
+}
+
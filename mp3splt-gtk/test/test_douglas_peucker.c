@@ -80,11 +80,16 @@ void test_find_point_with_maximum_distance()
 
   g_array_append_val(points, second_segment_point);
 
-  distance_and_index *max_distance_point = 
-    splt_find_point_with_maximum_distance(points, first_segment_point, second_segment_point);
+  distance_and_index max_distance_point = 
+    splt_find_point_with_maximum_distance(points, 0, points->len - 1);
 
-  cut_assert_equal_int(3, max_distance_point->index);
-  cut_assert_equal_double(27.51181564, DOUBLE_PRECISION, max_distance_point->distance);
+  cut_assert_equal_int(3, max_distance_point.index);
+  cut_assert_equal_double(6.32455532, DOUBLE_PRECISION, max_distance_point.distance);
+
+  max_distance_point = splt_find_point_with_maximum_distance(points, 0, 2);
+
+  cut_assert_equal_int(1, max_distance_point.index);
+  cut_assert_equal_double(7.0, DOUBLE_PRECISION, max_distance_point.distance);
 
   g_array_free(points, TRUE);
 }
@@ -128,8 +133,8 @@ void test_douglas_peucker()
   //0.4 - filter just one point
   //4.1 - filter three points
 
-  GPtrArray *points_presence_by_threshold = splt_douglas_peucker(points, NULL, NULL, 6.4, 0.4, 4.1, -1);
-  cut_assert_equal_int(3, points_presence_by_threshold->len);
+  GByteArray *points_presence = splt_douglas_peucker(points, 6.4, 0.4, 4.1, -1.0);
+  cut_assert_equal_int(6, points_presence->len);
 
   //filter all points except first segment and second segment
 
@@ -145,16 +150,12 @@ void test_douglas_peucker()
   distance = splt_find_perpendicular_distance(fourth_point, first_segment_point, second_segment_point);
   cut_assert_equal_double(5.37587202, DOUBLE_PRECISION, distance);
 
-  GArray *points_presence = g_ptr_array_index(points_presence_by_threshold, 0);
-
-  cut_assert_equal_int(6, points_presence->len);
-
-  cut_assert_equal_int(1, g_array_index(points_presence, gint, 0));
-  cut_assert_equal_int(0, g_array_index(points_presence, gint, 1));
-  cut_assert_equal_int(0, g_array_index(points_presence, gint, 2));
-  cut_assert_equal_int(0, g_array_index(points_presence, gint, 3));
-  cut_assert_equal_int(0, g_array_index(points_presence, gint, 4));
-  cut_assert_equal_int(1, g_array_index(points_presence, gint, 5));
+  cut_assert_equal_int(1, splt_douglas_peucker_point_is_present(points_presence, 0, 0));
+  cut_assert_equal_int(0, splt_douglas_peucker_point_is_present(points_presence, 1, 0));
+  cut_assert_equal_int(0, splt_douglas_peucker_point_is_present(points_presence, 2, 0));
+  cut_assert_equal_int(0, splt_douglas_peucker_point_is_present(points_presence, 3, 0));
+  cut_assert_equal_int(0, splt_douglas_peucker_point_is_present(points_presence, 4, 0));
+  cut_assert_equal_int(1, splt_douglas_peucker_point_is_present(points_presence, 5, 0));
 
   //filter just one point
 
@@ -173,31 +174,23 @@ void test_douglas_peucker()
   distance = splt_find_perpendicular_distance(fourth_point, third_point, second_segment_point);
   cut_assert_equal_double(0.316227766, DOUBLE_PRECISION, distance);
 
-  points_presence = g_ptr_array_index(points_presence_by_threshold, 1);
-
-  cut_assert_equal_int(6, points_presence->len);
-
-  cut_assert_equal_int(1, g_array_index(points_presence, gint, 0));
-  cut_assert_equal_int(1, g_array_index(points_presence, gint, 1));
-  cut_assert_equal_int(1, g_array_index(points_presence, gint, 2));
-  cut_assert_equal_int(1, g_array_index(points_presence, gint, 3));
-  cut_assert_equal_int(0, g_array_index(points_presence, gint, 4));
-  cut_assert_equal_int(1, g_array_index(points_presence, gint, 5));
+  cut_assert_equal_int(1, splt_douglas_peucker_point_is_present(points_presence, 0, 1));
+  cut_assert_equal_int(1, splt_douglas_peucker_point_is_present(points_presence, 1, 1));
+  cut_assert_equal_int(1, splt_douglas_peucker_point_is_present(points_presence, 2, 1));
+  cut_assert_equal_int(1, splt_douglas_peucker_point_is_present(points_presence, 3, 1));
+  cut_assert_equal_int(0, splt_douglas_peucker_point_is_present(points_presence, 4, 1));
+  cut_assert_equal_int(1, splt_douglas_peucker_point_is_present(points_presence, 5, 1));
 
   //filter 3 points
 
-  points_presence = g_ptr_array_index(points_presence_by_threshold, 2);
-
-  cut_assert_equal_int(6, points_presence->len);
-
-  cut_assert_equal_int(1, g_array_index(points_presence, gint, 0));
-  cut_assert_equal_int(0, g_array_index(points_presence, gint, 1));
-  cut_assert_equal_int(0, g_array_index(points_presence, gint, 2));
-  cut_assert_equal_int(1, g_array_index(points_presence, gint, 3));
-  cut_assert_equal_int(0, g_array_index(points_presence, gint, 4));
-  cut_assert_equal_int(1, g_array_index(points_presence, gint, 5));
+  cut_assert_equal_int(1, splt_douglas_peucker_point_is_present(points_presence, 0, 2));
+  cut_assert_equal_int(0, splt_douglas_peucker_point_is_present(points_presence, 1, 2));
+  cut_assert_equal_int(0, splt_douglas_peucker_point_is_present(points_presence, 2, 2));
+  cut_assert_equal_int(1, splt_douglas_peucker_point_is_present(points_presence, 3, 2));
+  cut_assert_equal_int(0, splt_douglas_peucker_point_is_present(points_presence, 4, 2));
+  cut_assert_equal_int(1, splt_douglas_peucker_point_is_present(points_presence, 5, 2));
 
-  splt_douglas_peucker_free(points_presence_by_threshold);
+  splt_douglas_peucker_free(points_presence);
   g_array_free(points, TRUE);
 }
 
@@ -211,17 +204,84 @@ void test_douglas_peucker_with_only_one_point()
 
   g_array_append_val(points, first_segment_point);
 
-  GPtrArray *points_presence_by_threshold = splt_douglas_peucker(points, NULL, NULL, 6.4, -1);
-  cut_assert_equal_int(1, points_presence_by_threshold->len);
+  GByteArray *points_presence = splt_douglas_peucker(points, 6.4, -1.0);
+  cut_assert_equal_int(1, points_presence->len);
+  cut_assert_true(splt_douglas_peucker_point_is_present(points_presence, 0, 0));
+
+  splt_douglas_peucker_free(points_presence);
+  g_array_free(points, TRUE);
+}
 
-  GArray *presence_points = g_ptr_array_index(points_presence_by_threshold, 0);
 
-  cut_assert_equal_int(1, presence_points->len);
+static void keep_points_over_threshold(GArray *points, gint first_index, gint last_index,
+    gdouble threshold, gint *kept)
+{
+  if (last_index - first_index < 2)
+  {
+    return;
+  }
+
+  distance_and_index max_distance_point =
+    splt_find_point_with_maximum_distance(points, first_index, last_index);
+
+  //points on a straight line are all kept
+  if (max_distance_point.distance < DOUBLE_PRECISION)
+  {
+    gint i = 0;
+    for (i = first_index + 1;i < last_index;i++)
+    {
+      kept[i] = 1;
+    }
+    return;
+  }
+
+  if (max_distance_point.distance < threshold)
+  {
+    return;
+  }
+
+  kept[max_distance_point.index] = 1;
+  keep_points_over_threshold(points, first_index, max_distance_point.index, threshold, kept);
+  keep_points_over_threshold(points, max_distance_point.index, last_index, threshold, kept);
+}
 
-  gint is_present = g_array_index(presence_points, gint, 0);
-  cut_assert_equal_int(1, is_present);
+void test_douglas_peucker_all_thresholds_like_one_by_one()
+{
+  GArray *points = g_array_new(TRUE, TRUE, sizeof(GdkPoint));
 
-  splt_douglas_peucker_free(points_presence_by_threshold);
+  gint i = 0;
+  for (i = 0;i < 2000;i++)
+  {
+    GdkPoint point;
+    point.x = i * 4;
+    point.y = (i * 7919) % 97 + (i % 13) * 3;
+    g_array_append_val(points, point);
+  }
+
+  gdouble thresholds[6] = { 2.0, 5.0, 8.0, 10.0, 12.0, 15.0 };
+  GByteArray *points_presence =
+    splt_douglas_peucker(points, thresholds[0], thresholds[1], thresholds[2],
+        thresholds[3], thresholds[4], thresholds[5], -1.0);
+  cut_assert_equal_int(points->len, points_presence->len);
+
+  gint *kept = g_malloc0(sizeof(gint) * points->len);
+
+  gint threshold_index = 0;
+  for (threshold_index = 0;threshold_index < 6;threshold_index++)
+  {
+    memset(kept, 0, sizeof(gint) * points->len);
+    kept[0] = 1;
+    kept[points->len - 1] = 1;
+    keep_points_over_threshold(points, 0, points->len - 1, thresholds[threshold_index], kept);
+
+    for (i = 0;i < points->len;i++)
+    {
+      cut_assert_equal_int(kept[i],
+          splt_douglas_peucker_point_is_present(points_presence, i, threshold_index));
+    }
+  }
+
+  g_free(kept);
+  splt_douglas_peucker_free(points_presence);
   g_array_free(points, TRUE);
 }
-
@@ -0,0 +1,100 @@
+#include <cutter.h>
+
+#include <gtk/gtk.h>
+
+#include "tests.h"
+#include "preview_buffer.h"
+
+#define NUMBER_OF_BYTES_TO_WRITE 1000000
+#define WRITE_SIZE 1000
+
+static preview_buffer *buffer = NULL;
+
+void cut_setup()
+{
+  buffer = splt_preview_buffer_new(4093);
+}
+
+void cut_teardown()
+{
+  splt_preview_buffer_unref(buffer);
+}
+
+static gpointer write_bytes(gpointer data)
+{
+  preview_buffer *buffer = (preview_buffer *) data;
+
+  guchar bytes[WRITE_SIZE];
+  gint written = 0;
+  while (written < NUMBER_OF_BYTES_TO_WRITE)
+  {
+    gint i = 0;
+    for (i = 0;i < WRITE_SIZE;i++)
+    {
+      bytes[i] = (guchar) (written + i);
+    }
+
+    if (!splt_preview_buffer_write(buffer, bytes, WRITE_SIZE))
+    {
+      break;
+    }
+
+    written += WRITE_SIZE;
+  }
+
+  splt_preview_buffer_finish(buffer);
+  splt_preview_buffer_unref(buffer);
+
+  return NULL;
+}
+
+void test_read_after_finish()
+{
+  guchar bytes[16];
+  cut_assert_true(splt_preview_buffer_write(buffer, "abcdef", 6));
+  splt_preview_buffer_finish(buffer);
+
+  cut_assert_equal_int(4, splt_preview_buffer_read(buffer, bytes, 4));
+  cut_assert_equal_memory("abcd", 4, bytes, 4);
+  cut_assert_equal_int(2, splt_preview_buffer_read(buffer, bytes, 16));
+  cut_assert_equal_memory("ef", 2, bytes, 2);
+  cut_assert_equal_int(0, splt_preview_buffer_read(buffer, bytes, 16));
+}
+
+void test_stream_more_bytes_than_capacity()
+{
+  GThread *writer = g_thread_new("writer", write_bytes, splt_preview_buffer_ref(buffer));
+
+  guchar bytes[777];
+  gint total = 0;
+  gboolean all_bytes_are_equal = TRUE;
+  gsize read = 0;
+  while ((read = splt_preview_buffer_read(buffer, bytes, 777)) > 0)
+  {
+    gsize i = 0;
+    for (i = 0;i < read;i++)
+    {
+      all_bytes_are_equal &= (bytes[i] == (guchar) (total + i));
+    }
+    total += read;
+  }
+
+  g_thread_join(writer);
+
+  cut_assert_equal_int(NUMBER_OF_BYTES_TO_WRITE, total);
+  cut_assert_true(all_bytes_are_equal);
+}
+
+void test_cancel_wakes_up_the_writer()
+{
+  GThread *writer = g_thread_new("writer", write_bytes, splt_preview_buffer_ref(buffer));
+  g_usleep(10000);
+
+  splt_preview_buffer_cancel(buffer);
+  g_thread_join(writer);
+
+  guchar bytes[16];
+  cut_assert_equal_int(0, splt_preview_buffer_read(buffer, bytes, 16));
+  cut_assert_false(splt_preview_buffer_write(buffer, "a", 1));
+}
+
@@ -0,0 +1,90 @@
+#include <cutter.h>
+
+#include <gtk/gtk.h>
+
+#include "tests.h"
+#include "splitpoints_model.h"
+
+static GArray *splitpoints = NULL;
+static GHashTable *descriptions = NULL;
+
+static void append_splitpoint(gint mins, gint secs, gint hundr_secs)
+{
+  Split_point point;
+  point.checked = TRUE;
+  point.mins = mins;
+  point.secs = secs;
+  point.hundr_secs = hundr_secs;
+  g_array_append_val(splitpoints, point);
+}
+
+void cut_setup()
+{
+  splitpoints = g_array_new(FALSE, FALSE, sizeof(Split_point));
+  descriptions = splt_descriptions_new();
+
+  append_splitpoint(0, 10, 0);
+  append_splitpoint(1, 0, 50);
+  append_splitpoint(1, 30, 0);
+  append_splitpoint(62, 0, 1);
+}
+
+void cut_teardown()
+{
+  g_array_free(splitpoints, TRUE);
+  splt_descriptions_free(&descriptions);
+}
+
+void test_splitpoint_time()
+{
+  cut_assert_equal_int(1000, splt_splitpoint_get_time(&g_array_index(splitpoints, Split_point, 0)));
+  cut_assert_equal_int(6050, splt_splitpoint_get_time(&g_array_index(splitpoints, Split_point, 1)));
+  cut_assert_equal_int(372001, splt_splitpoint_get_time(&g_array_index(splitpoints, Split_point, 3)));
+}
+
+void test_find_existing_splitpoints()
+{
+  gboolean found = FALSE;
+  cut_assert_equal_int(0, splt_splitpoints_find_index(splitpoints, 1000, &found));
+  cut_assert_true(found);
+  cut_assert_equal_int(2, splt_splitpoints_find_index(splitpoints, 9000, &found));
+  cut_assert_true(found);
+  cut_assert_equal_int(3, splt_splitpoints_find_index(splitpoints, 372001, &found));
+  cut_assert_true(found);
+}
+
+void test_find_insertion_index_of_new_splitpoints()
+{
+  gboolean found = TRUE;
+  cut_assert_equal_int(0, splt_splitpoints_find_index(splitpoints, 0, &found));
+  cut_assert_false(found);
+  cut_assert_equal_int(1, splt_splitpoints_find_index(splitpoints, 1001, &found));
+  cut_assert_false(found);
+  cut_assert_equal_int(4, splt_splitpoints_find_index(splitpoints, 400000, &found));
+  cut_assert_false(found);
+
+  g_array_set_size(splitpoints, 0);
+  cut_assert_equal_int(0, splt_splitpoints_find_index(splitpoints, 1000, NULL));
+}
+
+void test_count_descriptions()
+{
+  cut_assert_equal_int(0, splt_descriptions_count(descriptions, "track"));
+
+  splt_descriptions_add(descriptions, "track");
+  splt_descriptions_add(descriptions, "track");
+  splt_descriptions_add(descriptions, "other");
+  splt_descriptions_add(descriptions, NULL);
+  cut_assert_equal_int(2, splt_descriptions_count(descriptions, "track"));
+  cut_assert_equal_int(1, splt_descriptions_count(descriptions, "other"));
+
+  splt_descriptions_remove(descriptions, "track");
+  cut_assert_equal_int(1, splt_descriptions_count(descriptions, "track"));
+  splt_descriptions_remove(descriptions, "track");
+  cut_assert_equal_int(0, splt_descriptions_count(descriptions, "track"));
+  cut_assert_equal_int(1, g_hash_table_size(descriptions));
+
+  splt_descriptions_remove(descriptions, "missing");
+  cut_assert_equal_int(0, splt_descriptions_count(descriptions, "missing"));
+}
+
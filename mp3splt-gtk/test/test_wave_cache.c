@@ -0,0 +1,226 @@
+#include <cutter.h>
+
+#include <gtk/gtk.h>
+
+#include "tests.h"
+#include "wave_cache.h"
+#include "wave_pyramid.h"
+
+#define NUMBER_OF_POINTS 5000
+
+//offsets of the fields of the cache file header
+#define NUMBER_OF_SILENCE_POINTS_OFFSET 40
+#define PYRAMID_FIRST_LEVEL_SHIFT_OFFSET 104
+
+static gchar test_directory[512] = { '\0' };
+static gchar *cache_directory = NULL;
+static gchar *audio_filename = NULL;
+
+static silence_wave *points = NULL;
+static wave_pyramid *pyramid = NULL;
+static GByteArray *presence = NULL;
+static cached_wave *cached = NULL;
+
+static gdouble thresholds[6] = { 2.0, 5.0, 8.0, 10.0, 12.0, 15.0 };
+
+static void write_file(const gchar *filename, const gchar *contents, gsize length)
+{
+  FILE *file = fopen(filename, "wb");
+  cut_assert_not_null(file);
+  cut_assert_equal_int(1, fwrite(contents, length, 1, file));
+  fclose(file);
+}
+
+static gchar *get_only_cache_filename()
+{
+  GDir *directory = g_dir_open(cache_directory, 0, NULL);
+  const gchar *basename = g_dir_read_name(directory);
+  gchar *cache_filename = g_build_filename(cache_directory, basename, NULL);
+  g_dir_close(directory);
+  return cache_filename;
+}
+
+void cut_setup()
+{
+  const gchar *tmp = g_getenv("TMPDIR");
+  g_snprintf(test_directory, sizeof(test_directory), "%s/mp3splt_gtk_wave_cache_XXXXXX",
+      tmp ? tmp : "/tmp");
+  cut_assert_not_null(g_mkdtemp(test_directory));
+
+  cache_directory = g_build_filename(test_directory, "wave_cache", NULL);
+  cut_assert_equal_int(0, g_mkdir(cache_directory, 0700));
+
+  audio_filename = g_build_filename(test_directory, "song.mp3", NULL);
+  write_file(audio_filename, "not really an mp3", 17);
+
+  points = g_malloc0(sizeof(silence_wave) * NUMBER_OF_POINTS);
+  presence = g_byte_array_sized_new(NUMBER_OF_POINTS);
+  g_byte_array_set_size(presence, NUMBER_OF_POINTS);
+
+  gint i = 0;
+  for (i = 0;i < NUMBER_OF_POINTS;i++)
+  {
+    points[i].time = i * 2;
+    points[i].level = (i * 7) % 90;
+    presence->data[i] = i % 64;
+  }
+
+  pyramid = splt_wave_pyramid_new(points, NUMBER_OF_POINTS);
+  cached = NULL;
+}
+
+void cut_teardown()
+{
+  gchar command[1024];
+  g_snprintf(command, sizeof(command), "rm -rf '%s'", test_directory);
+  cut_assert_equal_int(0, system(command));
+
+  g_free(cache_directory);
+  g_free(audio_filename);
+  g_free(points);
+  splt_wave_pyramid_free(&pyramid);
+  g_byte_array_free(presence, TRUE);
+  splt_cached_wave_free(&cached);
+}
+
+void test_not_cached_file()
+{
+  cut_assert_null(splt_wave_cache_load(cache_directory, audio_filename));
+  cut_assert_null(splt_wave_cache_load(cache_directory, "/inexistent/file.mp3"));
+}
+
+void test_save_and_load()
+{
+  cut_assert_true(splt_wave_cache_save(cache_directory, audio_filename,
+        points, NUMBER_OF_POINTS, pyramid, presence, thresholds));
+
+  cached = splt_wave_cache_load(cache_directory, audio_filename);
+  cut_assert_not_null(cached);
+
+  cut_assert_equal_int(NUMBER_OF_POINTS, cached->number_of_silence_points);
+  cut_assert_equal_memory(points, sizeof(silence_wave) * NUMBER_OF_POINTS,
+      cached->silence_points, sizeof(silence_wave) * NUMBER_OF_POINTS);
+
+  cut_assert_not_null(cached->filtered_points_presence);
+  cut_assert_equal_memory(presence->data, NUMBER_OF_POINTS,
+      cached->filtered_points_presence->data, cached->filtered_points_presence->len);
+  cut_assert_equal_double(15.0, DOUBLE_PRECISION, cached->douglas_peucker_thresholds[5]);
+
+  cut_assert_equal_int(pyramid->start_time, cached->pyramid->start_time);
+  cut_assert_equal_int(pyramid->first_level_shift, cached->pyramid->first_level_shift);
+  cut_assert_equal_int(pyramid->number_of_levels, cached->pyramid->number_of_levels);
+
+  gint level = 0;
+  for (level = 0;level < pyramid->number_of_levels;level++)
+  {
+    cut_assert_equal_int(pyramid->levels_length[level], cached->pyramid->levels_length[level]);
+    cut_assert_equal_memory(pyramid->levels[level], sizeof(wave_bucket) * pyramid->levels_length[level],
+        cached->pyramid->levels[level], sizeof(wave_bucket) * cached->pyramid->levels_length[level]);
+  }
+}
+
+void test_save_without_douglas_peucker_filters()
+{
+  cut_assert_true(splt_wave_cache_save(cache_directory, audio_filename,
+        points, NUMBER_OF_POINTS, pyramid, NULL, thresholds));
+
+  cached = splt_wave_cache_load(cache_directory, audio_filename);
+  cut_assert_not_null(cached);
+  cut_assert_null(cached->filtered_points_presence);
+  cut_assert_equal_int(NUMBER_OF_POINTS, cached->number_of_silence_points);
+}
+
+void test_modified_file_is_not_loaded()
+{
+  cut_assert_true(splt_wave_cache_save(cache_directory, audio_filename,
+        points, NUMBER_OF_POINTS, pyramid, presence, thresholds));
+
+  write_file(audio_filename, "not really an mp3 either", 24);
+
+  cut_assert_null(splt_wave_cache_load(cache_directory, audio_filename));
+}
+
+void test_truncated_cache_file_is_not_loaded()
+{
+  cut_assert_true(splt_wave_cache_save(cache_directory, audio_filename,
+        points, NUMBER_OF_POINTS, pyramid, presence, thresholds));
+
+  gchar *cache_filename = get_only_cache_filename();
+
+  gchar *contents = NULL;
+  gsize length = 0;
+  cut_assert_true(g_file_get_contents(cache_filename, &contents, &length, NULL));
+  write_file(cache_filename, contents, length - 10);
+
+  cut_assert_null(splt_wave_cache_load(cache_directory, audio_filename));
+
+  g_free(contents);
+  g_free(cache_filename);
+}
+
+//! Saves the cache file and overwrites the 32 bits field of its header at \p offset
+static void save_with_corrupted_header_field(gsize offset, gint32 value)
+{
+  cut_assert_true(splt_wave_cache_save(cache_directory, audio_filename,
+        points, NUMBER_OF_POINTS, pyramid, presence, thresholds));
+
+  gchar *cache_filename = get_only_cache_filename();
+
+  gchar *contents = NULL;
+  gsize length = 0;
+  cut_assert_true(g_file_get_contents(cache_filename, &contents, &length, NULL));
+  memcpy(contents + offset, &value, sizeof(value));
+  write_file(cache_filename, contents, length);
+
+  g_free(contents);
+  g_free(cache_filename);
+}
+
+void test_cache_file_with_a_corrupted_number_of_points_is_not_loaded()
+{
+  save_with_corrupted_header_field(NUMBER_OF_SILENCE_POINTS_OFFSET, G_MAXINT32);
+  cut_assert_null(splt_wave_cache_load(cache_directory, audio_filename));
+
+  save_with_corrupted_header_field(NUMBER_OF_SILENCE_POINTS_OFFSET, NUMBER_OF_POINTS + 1);
+  cut_assert_null(splt_wave_cache_load(cache_directory, audio_filename));
+
+  save_with_corrupted_header_field(NUMBER_OF_SILENCE_POINTS_OFFSET, -1);
+  cut_assert_null(splt_wave_cache_load(cache_directory, audio_filename));
+}
+
+void test_cache_file_with_a_corrupted_pyramid_shift_is_not_loaded()
+{
+  save_with_corrupted_header_field(PYRAMID_FIRST_LEVEL_SHIFT_OFFSET, 70);
+  cut_assert_null(splt_wave_cache_load(cache_directory, audio_filename));
+
+  save_with_corrupted_header_field(PYRAMID_FIRST_LEVEL_SHIFT_OFFSET, -1);
+  cut_assert_null(splt_wave_cache_load(cache_directory, audio_filename));
+}
+
+void test_number_of_cached_files_is_limited()
+{
+  gint i = 0;
+  for (i = 0;i < WAVE_CACHE_MAXIMUM_NUMBER_OF_FILES + 5;i++)
+  {
+    gchar basename[64];
+    g_snprintf(basename, sizeof(basename), "song_%d.mp3", i);
+    gchar *filename = g_build_filename(test_directory, basename, NULL);
+    write_file(filename, "not really an mp3", 17);
+
+    cut_assert_true(splt_wave_cache_save(cache_directory, filename,
+          points, 100, pyramid, NULL, thresholds));
+
+    g_free(filename);
+  }
+
+  gint number_of_files = 0;
+  GDir *directory = g_dir_open(cache_directory, 0, NULL);
+  while (g_dir_read_name(directory) != NULL)
+  {
+    number_of_files++;
+  }
+  g_dir_close(directory);
+
+  cut_assert_equal_int(WAVE_CACHE_MAXIMUM_NUMBER_OF_FILES, number_of_files);
+}
+
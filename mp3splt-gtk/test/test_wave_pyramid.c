@@ -0,0 +1,113 @@
+#include <cutter.h>
+
+#include <gtk/gtk.h>
+
+#include "tests.h"
+#include "wave_pyramid.h"
+
+#define NUMBER_OF_POINTS 1000
+
+static silence_wave *points = NULL;
+static wave_pyramid *pyramid = NULL;
+
+void cut_setup()
+{
+  points = g_malloc0(sizeof(silence_wave) * NUMBER_OF_POINTS);
+
+  //one point each 3 hundreths of seconds, level going from 0 to 99
+  gint i = 0;
+  for (i = 0;i < NUMBER_OF_POINTS;i++)
+  {
+    points[i].time = 100 + i * 3;
+    points[i].level = i % 100;
+  }
+
+  pyramid = NULL;
+}
+
+void cut_teardown()
+{
+  g_free(points);
+  splt_wave_pyramid_free(&pyramid);
+}
+
+void test_no_pyramid_without_points()
+{
+  cut_assert_null(splt_wave_pyramid_new(NULL, 0));
+  cut_assert_null(splt_wave_pyramid_new(points, 0));
+}
+
+void test_first_level_has_a_few_points_per_bucket()
+{
+  pyramid = splt_wave_pyramid_new(points, NUMBER_OF_POINTS);
+  cut_assert_not_null(pyramid);
+
+  cut_assert_equal_int(100, pyramid->start_time);
+  //3 hundreths between points, 4 points per bucket : 16 hundreths per bucket
+  cut_assert_equal_int(4, pyramid->first_level_shift);
+  cut_assert_equal_int(1, pyramid->levels_length[pyramid->number_of_levels - 1]);
+
+  guint total = 0;
+  glong b = 0;
+  for (b = 0;b < pyramid->levels_length[0];b++)
+  {
+    total += pyramid->levels[0][b].number_of_points;
+  }
+  cut_assert_equal_int(NUMBER_OF_POINTS, total);
+}
+
+void test_last_level_summarizes_all_points()
+{
+  pyramid = splt_wave_pyramid_new(points, NUMBER_OF_POINTS);
+
+  const wave_bucket *all = &pyramid->levels[pyramid->number_of_levels - 1][0];
+  cut_assert_equal_int(NUMBER_OF_POINTS, all->number_of_points);
+  cut_assert_equal_double(0.0, DOUBLE_PRECISION, all->min);
+  cut_assert_equal_double(99.0, DOUBLE_PRECISION, all->max);
+  cut_assert_equal_double(49.5, 1E-4, all->avg);
+}
+
+void test_choose_level_with_at_most_one_bucket_per_pixel()
+{
+  pyramid = splt_wave_pyramid_new(points, NUMBER_OF_POINTS);
+
+  cut_assert_equal_int(0, splt_wave_pyramid_choose_level(pyramid, 100, 260, 100));
+  cut_assert_equal_int(2, splt_wave_pyramid_choose_level(pyramid, 100, 3100, 50));
+  cut_assert_equal_int(pyramid->number_of_levels - 1,
+      splt_wave_pyramid_choose_level(pyramid, 0, 100000, 1));
+}
+
+void test_get_buckets_of_a_time_window()
+{
+  pyramid = splt_wave_pyramid_new(points, NUMBER_OF_POINTS);
+
+  glong first_bucket = -1;
+  glong number_of_buckets = -1;
+  const wave_bucket *buckets =
+    splt_wave_pyramid_get_buckets(pyramid, 1, 164, 291, &first_bucket, &number_of_buckets);
+
+  //level 1 buckets last 32 hundreths
+  cut_assert_not_null(buckets);
+  cut_assert_equal_int(2, first_bucket);
+  cut_assert_equal_int(4, number_of_buckets);
+  cut_assert_equal_int(100 + 2 * 32 + 16, splt_wave_pyramid_get_bucket_time(pyramid, 1, first_bucket));
+
+  buckets = splt_wave_pyramid_get_buckets(pyramid, 0, 0, 50, &first_bucket, &number_of_buckets);
+  cut_assert_null(buckets);
+  cut_assert_equal_int(0, number_of_buckets);
+
+  buckets = splt_wave_pyramid_get_buckets(pyramid, 0, 3000, 90000, &first_bucket, &number_of_buckets);
+  cut_assert_not_null(buckets);
+  cut_assert_equal_int(pyramid->levels_length[0] - 1, first_bucket + number_of_buckets - 1);
+}
+
+void test_find_first_point()
+{
+  cut_assert_equal_int(0, splt_wave_find_first_point(points, NUMBER_OF_POINTS, 0));
+  cut_assert_equal_int(0, splt_wave_find_first_point(points, NUMBER_OF_POINTS, 100));
+  cut_assert_equal_int(1, splt_wave_find_first_point(points, NUMBER_OF_POINTS, 101));
+  cut_assert_equal_int(10, splt_wave_find_first_point(points, NUMBER_OF_POINTS, 130));
+  cut_assert_equal_int(NUMBER_OF_POINTS,
+      splt_wave_find_first_point(points, NUMBER_OF_POINTS, 100 + NUMBER_OF_POINTS * 3));
+}
+
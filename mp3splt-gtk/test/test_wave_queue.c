@@ -0,0 +1,104 @@
+#include <cutter.h>
+
+#include <gtk/gtk.h>
+
+#include "tests.h"
+#include "wave_queue.h"
+
+#define NUMBER_OF_CHUNKS_TO_PRODUCE 5000
+
+static wave_queue *queue = NULL;
+
+void cut_setup()
+{
+  queue = splt_wave_queue_new();
+}
+
+void cut_teardown()
+{
+  splt_wave_queue_free(&queue);
+}
+
+static wave_chunk *new_chunk(gint number)
+{
+  wave_chunk *chunk = g_malloc0(sizeof(wave_chunk));
+  chunk->number_of_points = 1;
+  chunk->points[0].time = number;
+  return chunk;
+}
+
+void test_pop_from_empty_queue()
+{
+  cut_assert_null(splt_wave_queue_pop(queue));
+}
+
+void test_chunks_are_popped_in_order_until_full()
+{
+  gint i = 0;
+  for (i = 0;i < WAVE_QUEUE_NUMBER_OF_CHUNKS;i++)
+  {
+    cut_assert_true(splt_wave_queue_push(queue, new_chunk(i)));
+  }
+
+  wave_chunk *one_too_many = new_chunk(-1);
+  cut_assert_false(splt_wave_queue_push(queue, one_too_many));
+  g_free(one_too_many);
+
+  for (i = 0;i < WAVE_QUEUE_NUMBER_OF_CHUNKS;i++)
+  {
+    wave_chunk *chunk = splt_wave_queue_pop(queue);
+    cut_assert_not_null(chunk);
+    cut_assert_equal_int(i, chunk->points[0].time);
+    g_free(chunk);
+  }
+
+  cut_assert_null(splt_wave_queue_pop(queue));
+}
+
+void test_free_queue_with_remaining_chunks()
+{
+  cut_assert_true(splt_wave_queue_push(queue, new_chunk(0)));
+  cut_assert_true(splt_wave_queue_push(queue, new_chunk(1)));
+
+  splt_wave_queue_free(&queue);
+  cut_assert_null(queue);
+}
+
+static gpointer produce_chunks(gpointer data)
+{
+  gint i = 0;
+  for (i = 0;i < NUMBER_OF_CHUNKS_TO_PRODUCE;i++)
+  {
+    wave_chunk *chunk = new_chunk(i);
+    while (!splt_wave_queue_push(queue, chunk))
+    {
+      g_usleep(10);
+    }
+  }
+
+  return NULL;
+}
+
+void test_chunks_from_another_thread_are_popped_in_order()
+{
+  GThread *producer = g_thread_new("producer", produce_chunks, NULL);
+
+  gint expected = 0;
+  while (expected < NUMBER_OF_CHUNKS_TO_PRODUCE)
+  {
+    wave_chunk *chunk = splt_wave_queue_pop(queue);
+    if (chunk == NULL)
+    {
+      g_usleep(10);
+      continue;
+    }
+
+    cut_assert_equal_int(expected, chunk->points[0].time);
+    g_free(chunk);
+    expected++;
+  }
+
+  g_thread_join(producer);
+  cut_assert_null(splt_wave_queue_pop(queue));
+}
+